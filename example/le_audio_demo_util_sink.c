@@ -516,14 +516,20 @@ static btstack_fsm_state_t audio_processing_decode( audio_processing_t * const m
                 BFI = 1;
                 printf("predict audio\n");
             }
+            btstack_lc3_decoder_frame_t decoder_frames[MAX_CHANNELS];
             uint8_t i;
             for (i = 0 ; i < le_audio_demo_sink_num_channels_per_stream ; i++){
-                uint8_t tmp_BEC_detect;
                 uint8_t effective_channel = (data_event->stream * le_audio_demo_sink_num_channels_per_stream) + i;
-                (void) lc3_decoder->decode_signed_16(decoder_contexts[effective_channel], &data_in[offset], BFI,
-                                                     &data_out[effective_channel], le_audio_demo_sink_num_channels,
-                                                     &tmp_BEC_detect);
+                decoder_frames[i].context = decoder_contexts[effective_channel];
+                decoder_frames[i].bytes = &data_in[offset];
+                decoder_frames[i].BFI = BFI;
+                decoder_frames[i].pcm_out = &data_out[effective_channel];
+                decoder_frames[i].stride = le_audio_demo_sink_num_channels;
                 offset += le_audio_demo_sink_octets_per_frame;
+            }
+            (void) btstack_lc3_decode_signed_16_batch(lc3_decoder, decoder_frames, le_audio_demo_sink_num_channels_per_stream);
+            for (i = 0 ; i < le_audio_demo_sink_num_channels_per_stream ; i++){
+                uint8_t effective_channel = (data_event->stream * le_audio_demo_sink_num_channels_per_stream) + i;
                 audio_fsm_debug("effective_channel: %d\n", effective_channel );
                 if( (me->have_pcm & (1<<effective_channel)) ) {
                     audio_fsm_debug("de-syncroniced, resync\n");
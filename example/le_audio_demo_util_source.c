@@ -245,10 +245,15 @@ void le_audio_demo_util_source_generate_iso_frame(le_audio_demo_source_generator
     }
 
     if (encode_pcm){
+        btstack_lc3_encoder_frame_t encoder_frames[MAX_CHANNELS];
         uint8_t i;
         for (i=0;i<le_audio_demo_source_num_channels;i++){
-            le_audio_demo_source_lc3_encoder->encode_signed_16(&le_audio_demo_source_encoder_contexts[i], &le_audio_demo_source_pcm[i], le_audio_demo_source_num_channels, &le_audio_demo_source_iso_payload[i * MAX_LC3_FRAME_BYTES]);
+            encoder_frames[i].context = &le_audio_demo_source_encoder_contexts[i];
+            encoder_frames[i].pcm_in = &le_audio_demo_source_pcm[i];
+            encoder_frames[i].stride = le_audio_demo_source_num_channels;
+            encoder_frames[i].bytes = &le_audio_demo_source_iso_payload[i * MAX_LC3_FRAME_BYTES];
         }
+        (void) btstack_lc3_encode_signed_16_batch(le_audio_demo_source_lc3_encoder, encoder_frames, le_audio_demo_source_num_channels);
     }
 };
 
@@ -59,6 +59,8 @@
 
 #define PSM_TEST 0xdead
 #define PACKET_SIZE 1000
+#define SHARED_MEMORY_RING_SIZE (128 * 1024)
+#define REPORT_INTERVAL_MS 3000
 
 int serverMode = 1;
 bd_addr_t addr = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00}; 
@@ -67,6 +69,10 @@ uint32_t counter = 0;
 
 btstack_timer_source_t timer;
 
+uint32_t data_rate_start_ms;
+uint32_t data_rate_bytes;
+uint32_t data_rate_packets;
+
 void update_packet(void){
     big_endian_store_32( packet, 0, counter++);
 }
@@ -78,6 +84,21 @@ void prepare_packet(void){
     for (i=4;i<PACKET_SIZE;i++)
         packet[i] = i-4;
 }
+void data_rate_update(uint16_t size){
+    uint32_t now = btstack_run_loop_get_time_ms();
+    if (data_rate_start_ms == 0){
+        data_rate_start_ms = now;
+    }
+    data_rate_bytes += size;
+    data_rate_packets++;
+    uint32_t delta_ms = now - data_rate_start_ms;
+    if (delta_ms < REPORT_INTERVAL_MS) return;
+    printf("%u packets, %u bytes in %u ms -> %u kB/s\n", data_rate_packets, data_rate_bytes, delta_ms, data_rate_bytes / delta_ms);
+    data_rate_start_ms = now;
+    data_rate_bytes = 0;
+    data_rate_packets = 0;
+}
+
 void  timer_handler(struct btstack_timer_source *ts){
 	bt_send_cmd(&hci_read_bd_addr);
 	btstack_run_loop_set_timer(&timer, 3000);
@@ -97,6 +118,7 @@ void packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint
 			
 		case L2CAP_DATA_PACKET:
 			// measure data rate
+			data_rate_update(size);
 			break;
 			
 		case HCI_EVENT_PACKET:
@@ -206,9 +228,13 @@ void packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint
 	}
 }
 int main (int argc, const char * argv[]){
-    // handle remote addr
-    if (argc > 1){
-        if (sscanf_bd_addr(argv[1], addr)){
+    // handle remote addr and -s for shared memory transport
+    int use_shared_memory = 0;
+    int arg;
+    for (arg = 1; arg < argc; arg++){
+        if (strcmp(argv[arg], "-s") == 0){
+            use_shared_memory = 1;
+        } else if (sscanf_bd_addr(argv[arg], addr)){
             serverMode = 0;
             prepare_packet();
         }
@@ -219,6 +245,9 @@ int main (int argc, const char * argv[]){
 #else
 	btstack_run_loop_init(btstack_run_loop_posix_get_instance());
 #endif
+	if (use_shared_memory){
+		bt_use_shared_memory(SHARED_MEMORY_RING_SIZE);
+	}
 	int err = bt_open();
 	if (err) {
 		printf("Failed to open connection to BTdaemon\n");
@@ -234,6 +263,7 @@ int main (int argc, const char * argv[]){
 	   printf(" * Running in Server mode. For client mode, specify remote addr 11:22:33:44:55:66\n");
     }
     printf(" * MTU: 1000 bytes\n");
+    printf(" * Transport: %s\n", use_shared_memory ? "shared memory (-s)" : "socket");
 	
 	btstack_run_loop_execute();
 	bt_close();
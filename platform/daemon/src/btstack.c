@@ -70,6 +70,7 @@ static void (*client_packet_handler)(uint8_t packet_type, uint16_t channel, uint
 
 static const char * daemon_tcp_address = NULL;
 static uint16_t     daemon_tcp_port    = BTSTACK_PORT;
+static uint32_t     daemon_shared_memory_ring_size;
 
 // optional: if called before bt_open, TCP socket is used instead of local unix socket
 //           note: address is not copied and must be valid during bt_open
@@ -78,6 +79,11 @@ void bt_use_tcp(const char * address, uint16_t port){
     daemon_tcp_port    = port;
 }
 
+// optional: if called before bt_open, shared memory is requested for local unix socket
+void bt_use_shared_memory(uint32_t ring_size){
+    daemon_shared_memory_ring_size = ring_size;
+}
+
 static int socket_packet_handler(connection_t *connection, uint16_t packet_type, uint16_t channel, uint8_t *data, uint16_t size){
     // log_info("BTstack client handler: packet type %u, data[0] %x", packet_type, data[0]);
     (*client_packet_handler)(packet_type, channel, data, size);
@@ -107,6 +113,10 @@ int bt_open(void){
     } else {
 #ifdef HAVE_UNIX_SOCKETS
         btstack_connection = socket_connection_open_unix();
+        if (btstack_connection && daemon_shared_memory_ring_size){
+            // socket is used if request fails or daemon rejects it
+            socket_connection_request_shared_memory(btstack_connection, daemon_shared_memory_ring_size);
+        }
 #endif
     }
     if (!btstack_connection) return -1;
@@ -77,6 +77,10 @@ extern "C" {
 //           note: address is not copied and must be valid during bt_open
 void bt_use_tcp(const char * address, uint16_t port); 
 
+// optional: if called before bt_open, shared memory rings of ring_size bytes (power of two) are requested
+//           for the local unix socket connection (Linux only). falls back to the socket if not available
+void bt_use_shared_memory(uint32_t ring_size);
+
 // init BTstack library
 int bt_open(void);
 
@@ -37,6 +37,11 @@
 
 #define BTSTACK_FILE__ "socket_connection.c"
 
+// memfd_create and file seals for shared memory transport
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 /*
  *  SocketServer.c
  *  
@@ -70,6 +75,7 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #endif
  
@@ -98,11 +104,35 @@ struct sockaddr_un {
 #include "../port/ios/3rdparty/launch.h"
 #endif
 
+// shared memory transport requires memfd, eventfd and fd passing over unix domain sockets
+#if defined(HAVE_UNIX_SOCKETS) && defined(__linux__)
+#define ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#endif
+
 #define MAX_PENDING_CONNECTIONS 10
 
+// default high-water mark for per-connection output buffer
+#ifndef SOCKET_CONNECTION_HIGH_WATER_MARK
+#define SOCKET_CONNECTION_HIGH_WATER_MARK (64 * 1024)
+#endif
+
 /** prototypes */
 static void socket_connection_hci_process(btstack_data_source_t *ds, btstack_data_source_callback_type_t callback_type);
 static int socket_connection_dummy_handler(connection_t *connection, uint16_t packet_type, uint16_t channel, uint8_t *data, uint16_t length);
+#ifndef _WIN32
+static void socket_connection_flush(connection_t *conn);
+#endif
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+static void socket_connection_shm_close(connection_t *conn);
+static void socket_connection_shm_handle_control(connection_t *conn, const uint8_t *data, uint16_t length);
+static void socket_connection_shm_park(connection_t *conn);
+static void socket_connection_shm_unpark(connection_t *conn);
+static void socket_connection_shm_tx_check(connection_t *conn);
+static int  socket_connection_shm_write(connection_t *conn, const struct iovec *iov, int iovcnt);
+static void socket_connection_shm_wait(connection_t *conn);
+#endif
 
 /** globals */
 
@@ -124,6 +154,55 @@ typedef struct linked_connection {
     connection_t * connection;
 } linked_connection_t;
 
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+
+// packet type for shared memory negotiation, handled by socket_connection
+#define SOCKET_CONNECTION_CONTROL_PACKET 0xfeu
+
+// control opcodes: client requests shared memory (fds: memfd, daemon doorbell, client doorbell),
+// daemon accepts or rejects, client commits after accept. Afterwards, packets are sent via rings
+#define SOCKET_CONNECTION_SHM_REQUEST 0x01u
+#define SOCKET_CONNECTION_SHM_ACCEPT  0x02u
+#define SOCKET_CONNECTION_SHM_REJECT  0x03u
+#define SOCKET_CONNECTION_SHM_COMMIT  0x04u
+
+#define SOCKET_CONNECTION_SHM_MIN_RING_SIZE 4096u
+#define SOCKET_CONNECTION_SHM_MAX_RING_SIZE (16u * 1024u * 1024u)
+#define SOCKET_CONNECTION_SHM_NUM_FDS       3
+
+typedef enum {
+    SOCKET_CONNECTION_SHM_IDLE,
+    SOCKET_CONNECTION_SHM_W4_ACCEPT,     // client
+    SOCKET_CONNECTION_SHM_W4_COMMIT,     // daemon
+    SOCKET_CONNECTION_SHM_ACTIVE,
+} socket_connection_shm_state_t;
+
+// single producer single consumer byte ring, head and tail are free running
+typedef struct {
+    uint32_t head;                 // written by producer
+    uint8_t  padding_head[60];
+    uint32_t tail;                 // written by consumer
+    uint32_t producer_waiting;     // set by producer if ring is full, cleared by consumer
+    uint8_t  padding_tail[56];
+} socket_connection_shm_ring_header_t;
+
+// shared memory: header client->daemon, header daemon->client, data client->daemon, data daemon->client
+#define SOCKET_CONNECTION_SHM_DATA_OFFSET (2 * sizeof(socket_connection_shm_ring_header_t))
+
+typedef struct {
+    socket_connection_shm_ring_header_t * header;
+    uint8_t * data;
+    uint32_t  size;
+    uint32_t  position;            // own head or tail, the shared copy is not trusted
+} socket_connection_shm_ring_t;
+
+typedef struct {
+    btstack_data_source_t ds;
+    connection_t * connection;
+} socket_connection_shm_doorbell_t;
+
+#endif
+
 struct connection {
     btstack_data_source_t ds;                // used for run loop
     linked_connection_t linked_connection;   // used for connection list
@@ -132,17 +211,56 @@ struct connection {
     uint16_t bytes_read;
     uint16_t bytes_to_read;
     uint8_t  buffer[6+HCI_ACL_BUFFER_SIZE]; // packet_header(6) + max packet: 3-DH5 = header(6) + payload (1021)
+
+    // output buffer, allocated when socket cannot take a packet. pending data in [output_start, output_end)
+    uint8_t * output_buffer;
+    uint32_t  output_size;
+    uint32_t  output_start;
+    uint32_t  output_end;
+    uint32_t  high_water_mark;
+    socket_connection_overflow_policy_t overflow_policy;
+    int       output_closed;
+    socket_connection_statistics_t statistics;
+
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+    socket_connection_shm_state_t shm_state;
+    int       shm_received_fds[SOCKET_CONNECTION_SHM_NUM_FDS];
+    uint8_t   shm_num_received_fds;
+    uint8_t * shm_base;
+    size_t    shm_len;
+    socket_connection_shm_ring_t shm_rx;
+    socket_connection_shm_ring_t shm_tx;
+    int       shm_rx_active;       // packets are received via shm_rx
+    int       shm_tx_ready;        // switch output to shm_tx after pending output was written to socket
+    int       shm_tx_active;       // packets are sent via shm_tx
+    int       shm_doorbell_fd;     // signalled by peer
+    int       shm_peer_doorbell_fd;
+    socket_connection_shm_doorbell_t shm_doorbell;
+#endif
 };
 
 /** list of socket connections */
 static btstack_linked_list_t connections = NULL;
 static btstack_linked_list_t parked = NULL;
 
+#ifndef _WIN32
+// frees parked connections after output was closed
+static btstack_timer_source_t socket_connection_close_parked_timer;
+#endif
+
 #ifdef _WIN32
 // workaround as btstack_data_source_t only stores windows event (instead of fd)
 static int tcp_socket_fd;
 #endif
 
+static uint32_t socket_connection_default_high_water_mark = SOCKET_CONNECTION_HIGH_WATER_MARK;
+static socket_connection_overflow_policy_t socket_connection_default_overflow_policy = SOCKET_CONNECTION_OVERFLOW_DISCONNECT;
+
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+// connection that is currently reading from its shared memory ring, cleared if connection gets freed
+static connection_t * socket_connection_shm_receiving;
+#endif
+
 /** client packet handler */
 
 static int (*socket_connection_packet_callback)(connection_t *connection, uint16_t packet_type, uint16_t channel, uint8_t *data, uint16_t length) = socket_connection_dummy_handler;
@@ -169,7 +287,16 @@ static void socket_connection_free_connection(connection_t *conn){
     }
 #endif
 
+    log_info("socket_connection %p closed: %u packets sent, %u queued, %u dropped, %u bytes in %u writes, max %u bytes pending",
+             conn, conn->statistics.packets_sent, conn->statistics.packets_queued, conn->statistics.packets_dropped,
+             conn->statistics.bytes_written, conn->statistics.write_calls, conn->statistics.output_max);
+
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+    socket_connection_shm_close(conn);
+#endif
+
     // destroy
+    free(conn->output_buffer);
     free(conn);
 }
 
@@ -191,6 +318,16 @@ static connection_t * socket_connection_register_new_connection(int fd){
     // keep fd around
     conn->socket_fd = fd;
 
+    // output buffer config, client sockets are blocking and only queue output after an interrupted write
+    conn->high_water_mark = socket_connection_default_high_water_mark;
+    conn->overflow_policy = SOCKET_CONNECTION_OVERFLOW_DROP;
+
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+    conn->shm_doorbell_fd      = -1;
+    conn->shm_peer_doorbell_fd = -1;
+    conn->shm_doorbell.connection = conn;
+#endif
+
 #ifdef _WIN32
     // wrap fd in windows event and configure for accept and close
     WSAEVENT event = WSACreateEvent();
@@ -238,12 +375,110 @@ void static socket_connection_emit_connection_closed(connection_t *connection){
     (*socket_connection_packet_callback)(connection, DAEMON_EVENT_PACKET, 0, (uint8_t *) &event, 1);
 }
 
+// process received bytes, @return 1 if connection was parked
+static int socket_connection_process_bytes_read(connection_t *conn, int bytes_read){
+    conn->bytes_read += bytes_read;
+    conn->bytes_to_read -= bytes_read;
+    if (conn->bytes_to_read > 0) return 0;
+    
+    int dispatch = 0;
+    switch (conn->state){
+        case SOCKET_W4_HEADER:
+            conn->state = SOCKET_W4_DATA;
+            conn->bytes_to_read = little_endian_read_16( conn->buffer, 4);
+            if (conn->bytes_to_read == 0){
+                dispatch = 1;
+            }
+            break;
+        case SOCKET_W4_DATA:
+            dispatch = 1;
+            break;
+        default:
+            break;
+    }
+    
+    if (!dispatch) return 0;
+
+    uint16_t packet_type = little_endian_read_16( conn->buffer, 0);
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+    if (packet_type == SOCKET_CONNECTION_CONTROL_PACKET){
+        socket_connection_init_statemachine(conn);
+        socket_connection_shm_handle_control(conn, &conn->buffer[sizeof(packet_header_t)], little_endian_read_16( conn->buffer, 4));
+        return 0;
+    }
+#endif
+
+    // dispatch packet !!! connection, type, channel, data, size
+    int dispatch_err = (*socket_connection_packet_callback)(conn, packet_type, little_endian_read_16( conn->buffer, 2),
+                                                        &conn->buffer[sizeof(packet_header_t)], little_endian_read_16( conn->buffer, 4));
+    
+    // reset state machine
+    socket_connection_init_statemachine(conn);
+    
+    // "park" if dispatch failed
+    if (dispatch_err) {
+        log_info("socket_connection_hci_process dispatch failed -> park connection");
+        btstack_run_loop_remove_data_source(&conn->ds);
+        btstack_linked_list_add_tail(&parked, (btstack_linked_item_t *) &conn->ds);
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+        socket_connection_shm_park(conn);
+#endif
+        return 1;
+    }
+    return 0;
+}
+
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+// read from socket, keep file descriptors received for shared memory request
+static int socket_connection_receive(connection_t *conn, int socket_fd){
+    struct iovec iov;
+    iov.iov_base = &conn->buffer[conn->bytes_read];
+    iov.iov_len  = conn->bytes_to_read;
+    union {
+        struct cmsghdr header;
+        uint8_t buffer[CMSG_SPACE(SOCKET_CONNECTION_SHM_NUM_FDS * sizeof(int))];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+    int bytes_read = (int) recvmsg(socket_fd, &msg, MSG_CMSG_CLOEXEC);
+    if (bytes_read <= 0) return bytes_read;
+    struct cmsghdr * cmsg;
+    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)){
+        if ((cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS)) continue;
+        int num_fds = (int) ((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        int i;
+        for (i = 0; i < num_fds; i++){
+            int fd;
+            memcpy(&fd, CMSG_DATA(cmsg) + (i * sizeof(int)), sizeof(int));
+            if (conn->shm_num_received_fds < SOCKET_CONNECTION_SHM_NUM_FDS){
+                conn->shm_received_fds[conn->shm_num_received_fds++] = fd;
+            } else {
+                close(fd);
+            }
+        }
+    }
+    return bytes_read;
+}
+#endif
+
 void socket_connection_hci_process(btstack_data_source_t *socket_ds, btstack_data_source_callback_type_t callback_type) {
     UNUSED(callback_type);
     connection_t *conn = (connection_t *) socket_ds;
 
     log_debug("socket_connection_hci_process, callback %x", callback_type);
 
+#ifndef _WIN32
+    // flush output buffer
+    if (callback_type == DATA_SOURCE_CALLBACK_WRITE){
+        socket_connection_flush(conn);
+        return;
+    }
+#endif
+
     // get socket_fd
     int socket_fd = conn->socket_fd;
 
@@ -262,9 +497,14 @@ void socket_connection_hci_process(btstack_data_source_t *socket_ds, btstack_dat
 #ifdef _WIN32
     int flags = 0;
     int bytes_read = recv(socket_fd, (char*) &conn->buffer[conn->bytes_read], conn->bytes_to_read, flags);
+#else
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+    int bytes_read = socket_connection_receive(conn, socket_fd);
 #else
     int bytes_read = read(socket_fd, &conn->buffer[conn->bytes_read], conn->bytes_to_read);
 #endif
+    if ((bytes_read < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))) return;
+#endif
 
     log_debug("socket_connection_hci_process fd %x, bytes read %d", socket_fd, bytes_read);
     if (bytes_read <= 0){
@@ -276,41 +516,7 @@ void socket_connection_hci_process(btstack_data_source_t *socket_ds, btstack_dat
         
         return;
     }
-    conn->bytes_read += bytes_read;
-    conn->bytes_to_read -= bytes_read;
-    if (conn->bytes_to_read > 0) return;
-    
-    int dispatch = 0;
-    switch (conn->state){
-        case SOCKET_W4_HEADER:
-            conn->state = SOCKET_W4_DATA;
-            conn->bytes_to_read = little_endian_read_16( conn->buffer, 4);
-            if (conn->bytes_to_read == 0){
-                dispatch = 1;
-            }
-            break;
-        case SOCKET_W4_DATA:
-            dispatch = 1;
-            break;
-        default:
-            break;
-    }
-    
-    if (dispatch){
-        // dispatch packet !!! connection, type, channel, data, size
-        int dispatch_err = (*socket_connection_packet_callback)(conn, little_endian_read_16( conn->buffer, 0), little_endian_read_16( conn->buffer, 2),
-                                                            &conn->buffer[sizeof(packet_header_t)], little_endian_read_16( conn->buffer, 4));
-        
-        // reset state machine
-        socket_connection_init_statemachine(conn);
-        
-        // "park" if dispatch failed
-        if (dispatch_err) {
-            log_info("socket_connection_hci_process dispatch failed -> park connection");
-            btstack_run_loop_remove_data_source(socket_ds);
-            btstack_linked_list_add_tail(&parked, (btstack_linked_item_t *) socket_ds);
-        }
-    }
+    socket_connection_process_bytes_read(conn, bytes_read);
 }
 
 /**
@@ -328,6 +534,13 @@ void socket_connection_retry_parked(void){
         uint16_t packet_type = little_endian_read_16( conn->buffer, 0);
         uint16_t channel     = little_endian_read_16( conn->buffer, 2);
         uint16_t length      = little_endian_read_16( conn->buffer, 4);
+#ifndef _WIN32
+        // closed, freed by close parked timer
+        if (conn->output_closed){
+            it = it->next;
+            continue;
+        }
+#endif
         log_info("socket_connection_hci_process retry parked %p (type %u, channel %04x, length %u", conn, packet_type, channel, length);
         int dispatch_err = (*socket_connection_packet_callback)(conn, packet_type, channel, &conn->buffer[sizeof(packet_header_t)], length);
         // "un-park" if successful
@@ -335,6 +548,9 @@ void socket_connection_retry_parked(void){
             log_info("socket_connection_hci_process dispatch succeeded -> un-park connection %p", conn);
             it->next = it->next->next;
             btstack_run_loop_add_data_source( (btstack_data_source_t *) conn);
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+            socket_connection_shm_unpark(conn);
+#endif
         } else {
             it = it->next;
         }
@@ -374,8 +590,18 @@ static void socket_connection_accept(btstack_data_source_t *socket_ds, btstack_d
 	}
         
     log_info("socket_connection_accept new connection %u", fd);
-    
+
+#ifndef _WIN32
+    // don't block on slow clients, output is buffered instead
+    int flags = fcntl(fd, F_GETFL, 0);
+    if ((flags < 0) || (fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)){
+        log_error("socket_connection: failed to set O_NONBLOCK, error: %s", strerror(errno));
+    }
+#endif
+
     connection_t * connection = socket_connection_register_new_connection(fd);
+    if (connection == NULL) return;
+    connection->overflow_policy = socket_connection_default_overflow_policy;
     socket_connection_emit_connection_opened(connection);
 }
 
@@ -555,6 +781,133 @@ void socket_connection_register_packet_callback( int (*packet_callback)(connecti
     socket_connection_packet_callback = packet_callback;
 }
 
+#ifndef _WIN32
+
+static uint32_t socket_connection_output_pending(connection_t *conn){
+    return conn->output_end - conn->output_start;
+}
+
+static int socket_connection_is_parked(connection_t *conn){
+    btstack_linked_item_t *it;
+    for (it = (btstack_linked_item_t *) parked; it != NULL ; it = it->next){
+        if (it == (btstack_linked_item_t *) &conn->ds) return 1;
+    }
+    return 0;
+}
+
+static void socket_connection_close_parked_handler(btstack_timer_source_t *ts){
+    UNUSED(ts);
+    btstack_linked_item_t *it = (btstack_linked_item_t *) &parked;
+    while (it->next) {
+        connection_t * conn = (connection_t *) it->next;
+        if (conn->output_closed == 0){
+            it = it->next;
+            continue;
+        }
+        it->next = it->next->next;
+        socket_connection_emit_connection_closed(conn);
+        socket_connection_free_connection(conn);
+    }
+}
+
+static void socket_connection_output_close(connection_t *conn){
+    // stop output and let read handler clean up connection
+    log_info("socket_connection %p: close connection, %u bytes pending", conn, socket_connection_output_pending(conn));
+    conn->output_closed = 1;
+    conn->output_start = 0;
+    conn->output_end   = 0;
+    btstack_run_loop_disable_data_source_callbacks(&conn->ds, DATA_SOURCE_CALLBACK_WRITE);
+    shutdown(conn->socket_fd, SHUT_RDWR);
+
+    // read handler is not called for parked connection, free it from timer as caller might still use it
+    if (socket_connection_is_parked(conn)){
+        btstack_run_loop_remove_timer(&socket_connection_close_parked_timer);
+        btstack_run_loop_set_timer_handler(&socket_connection_close_parked_timer, &socket_connection_close_parked_handler);
+        btstack_run_loop_set_timer(&socket_connection_close_parked_timer, 0);
+        btstack_run_loop_add_timer(&socket_connection_close_parked_timer);
+    }
+}
+
+// output buffer holds high-water mark plus one partially written packet
+static int socket_connection_output_reserve(connection_t *conn, uint32_t len){
+    uint32_t size = conn->high_water_mark + sizeof(conn->buffer);
+    if (conn->output_size < size){
+        uint8_t * output_buffer = realloc(conn->output_buffer, size);
+        if (output_buffer == NULL) return 0;
+        conn->output_buffer = output_buffer;
+        conn->output_size = size;
+    }
+    if ((conn->output_end + len) <= conn->output_size) return 1;
+    // move pending data to start
+    uint32_t pending = socket_connection_output_pending(conn);
+    memmove(conn->output_buffer, &conn->output_buffer[conn->output_start], pending);
+    conn->output_start = 0;
+    conn->output_end   = pending;
+    return (conn->output_end + len) <= conn->output_size;
+}
+
+static void socket_connection_output_append(connection_t *conn, const uint8_t *data, uint32_t len){
+    memcpy(&conn->output_buffer[conn->output_end], data, len);
+    conn->output_end += len;
+    conn->statistics.output_max = btstack_max(conn->statistics.output_max, socket_connection_output_pending(conn));
+}
+
+// write to socket or shared memory ring, @return bytes written, 0 if output is full, -1 on error
+static int socket_connection_output_write(connection_t *conn, const struct iovec *iov, int iovcnt){
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+    if (conn->shm_tx_active){
+        return socket_connection_shm_write(conn, iov, iovcnt);
+    }
+#endif
+    ssize_t res = writev(conn->socket_fd, iov, iovcnt);
+    conn->statistics.write_calls++;
+    if (res < 0){
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) return 0;
+        log_error("socket_connection %p: write failed, error: %s", conn, strerror(errno));
+        return -1;
+    }
+    return (int) res;
+}
+
+// get notified when output can be written
+static void socket_connection_output_wait(connection_t *conn){
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+    if (conn->shm_tx_active){
+        socket_connection_shm_wait(conn);
+        return;
+    }
+#endif
+    btstack_run_loop_enable_data_source_callbacks(&conn->ds, DATA_SOURCE_CALLBACK_WRITE);
+}
+
+static void socket_connection_flush(connection_t *conn){
+    while (socket_connection_output_pending(conn) > 0){
+        struct iovec iov;
+        iov.iov_base = &conn->output_buffer[conn->output_start];
+        iov.iov_len  = socket_connection_output_pending(conn);
+        int res = socket_connection_output_write(conn, &iov, 1);
+        if (res < 0){
+            socket_connection_output_close(conn);
+            return;
+        }
+        if (res == 0) break;
+        conn->output_start += (uint32_t) res;
+        conn->statistics.bytes_written += (uint32_t) res;
+    }
+    if (socket_connection_output_pending(conn) == 0){
+        conn->output_start = 0;
+        conn->output_end   = 0;
+        btstack_run_loop_disable_data_source_callbacks(&conn->ds, DATA_SOURCE_CALLBACK_WRITE);
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+        socket_connection_shm_tx_check(conn);
+#endif
+    } else {
+        socket_connection_output_wait(conn);
+    }
+}
+
+#endif
+
 /**
  * send HCI packet to single connection
  */
@@ -563,17 +916,76 @@ void socket_connection_send_packet(connection_t *conn, uint16_t type, uint16_t c
     little_endian_store_16(header, 0, type);
     little_endian_store_16(header, 2, channel);
     little_endian_store_16(header, 4, size);
+#ifdef _WIN32
     // avoid -Wunused-result
     int res;
-#ifdef _WIN32
     int flags = 0;
     res = send(conn->socket_fd, (const char *) header, 6, flags);
     res = send(conn->socket_fd, (const char *) packet, size, flags);
+    UNUSED(res);
+    conn->statistics.packets_sent++;
+    conn->statistics.write_calls += 2;
 #else
-    res = write(conn->socket_fd, header, 6);
-    res = write(conn->socket_fd, packet, size);
+    if (conn->output_closed){
+        conn->statistics.packets_dropped++;
+        return;
+    }
+
+    uint32_t packet_len = sizeof(header) + size;
+    uint32_t written = 0;
+
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+    socket_connection_shm_tx_check(conn);
+#endif
+
+    if (socket_connection_output_pending(conn) == 0){
+        // nothing queued, write header and payload with single system call
+        struct iovec iov[2];
+        iov[0].iov_base = header;
+        iov[0].iov_len  = sizeof(header);
+        iov[1].iov_base = packet;
+        iov[1].iov_len  = size;
+        int res = socket_connection_output_write(conn, iov, 2);
+        if (res < 0){
+            conn->statistics.packets_dropped++;
+            socket_connection_output_close(conn);
+            return;
+        }
+        written = (uint32_t) res;
+        conn->statistics.bytes_written += written;
+        if (written == packet_len){
+            conn->statistics.packets_sent++;
+            return;
+        }
+    } else if ((socket_connection_output_pending(conn) + packet_len) > conn->high_water_mark){
+        // client does not keep up
+        conn->statistics.packets_dropped++;
+        if (conn->overflow_policy == SOCKET_CONNECTION_OVERFLOW_DISCONNECT){
+            socket_connection_output_close(conn);
+        }
+        return;
+    }
+
+    // queue rest of packet, flushed when socket or ring becomes writable
+    int output_was_empty = socket_connection_output_pending(conn) == 0;
+    if (socket_connection_output_reserve(conn, packet_len - written) == 0){
+        log_error("socket_connection %p: cannot queue packet", conn);
+        conn->statistics.packets_dropped++;
+        socket_connection_output_close(conn);
+        return;
+    }
+    if (written < sizeof(header)){
+        socket_connection_output_append(conn, &header[written], sizeof(header) - written);
+        socket_connection_output_append(conn, packet, size);
+    } else {
+        socket_connection_output_append(conn, &packet[written - sizeof(header)], packet_len - written);
+    }
+    conn->statistics.packets_sent++;
+    conn->statistics.packets_queued++;
+    if (output_was_empty){
+        socket_connection_output_wait(conn);
+    }
 #endif
-    UNUSED(res);
 }
 
 /**
@@ -589,6 +1001,400 @@ void socket_connection_send_packet_all(uint16_t type, uint16_t channel, uint8_t
     }
 }
 
+void socket_connection_set_default_high_water_mark(uint32_t high_water_mark, socket_connection_overflow_policy_t policy){
+    socket_connection_default_high_water_mark = high_water_mark;
+    socket_connection_default_overflow_policy = policy;
+}
+
+void socket_connection_set_high_water_mark(connection_t *connection, uint32_t high_water_mark, socket_connection_overflow_policy_t policy){
+    connection->overflow_policy = policy;
+    if (connection->high_water_mark == high_water_mark) return;
+    connection->high_water_mark = high_water_mark;
+#ifndef _WIN32
+    // re-allocate output buffer if no data is pending
+    if ((connection->output_buffer != NULL) && (socket_connection_output_pending(connection) == 0)){
+        free(connection->output_buffer);
+        connection->output_buffer = NULL;
+        connection->output_size   = 0;
+    }
+#endif
+}
+
+void socket_connection_get_statistics(connection_t *connection, socket_connection_statistics_t *statistics){
+    *statistics = connection->statistics;
+}
+
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+
+static void socket_connection_shm_signal(connection_t *conn, int fd){
+    uint64_t value = 1;
+    ssize_t res = write(fd, &value, sizeof(value));
+    UNUSED(res);
+    conn->statistics.write_calls++;
+}
+
+static void socket_connection_shm_copy_to_ring(socket_connection_shm_ring_t *ring, uint32_t position, const uint8_t *data, uint32_t len){
+    uint32_t offset = position & (ring->size - 1);
+    uint32_t first  = btstack_min(len, ring->size - offset);
+    memcpy(&ring->data[offset], data, first);
+    memcpy(ring->data, &data[first], len - first);
+}
+
+static void socket_connection_shm_copy_from_ring(socket_connection_shm_ring_t *ring, uint32_t position, uint8_t *data, uint32_t len){
+    uint32_t offset = position & (ring->size - 1);
+    uint32_t first  = btstack_min(len, ring->size - offset);
+    memcpy(data, &ring->data[offset], first);
+    memcpy(&data[first], ring->data, len - first);
+}
+
+// @return bytes written, 0 if ring is full, -1 if ring is corrupted
+static int socket_connection_shm_write(connection_t *conn, const struct iovec *iov, int iovcnt){
+    socket_connection_shm_ring_t * ring = &conn->shm_tx;
+    uint32_t head = ring->position;
+    uint32_t used = head - __atomic_load_n(&ring->header->tail, __ATOMIC_ACQUIRE);
+    if (used > ring->size){
+        log_error("socket_connection %p: invalid shared memory ring", conn);
+        return -1;
+    }
+    uint32_t space   = ring->size - used;
+    uint32_t written = 0;
+    int i;
+    for (i = 0; (i < iovcnt) && (space > 0); i++){
+        uint32_t len = btstack_min((uint32_t) iov[i].iov_len, space);
+        socket_connection_shm_copy_to_ring(ring, head + written, (const uint8_t *) iov[i].iov_base, len);
+        written += len;
+        space   -= len;
+    }
+    if (written == 0) return 0;
+    ring->position = head + written;
+    __atomic_store_n(&ring->header->head, ring->position, __ATOMIC_SEQ_CST);
+    // wake up consumer if it has read everything before
+    if (__atomic_load_n(&ring->header->tail, __ATOMIC_SEQ_CST) == head){
+        socket_connection_shm_signal(conn, conn->shm_peer_doorbell_fd);
+    }
+    return (int) written;
+}
+
+// @return bytes read, 0 if ring is empty, -1 if ring is corrupted
+static int socket_connection_shm_read(connection_t *conn, uint8_t *data, uint32_t len){
+    socket_connection_shm_ring_t * ring = &conn->shm_rx;
+    uint32_t tail = ring->position;
+    uint32_t available = __atomic_load_n(&ring->header->head, __ATOMIC_SEQ_CST) - tail;
+    if (available > ring->size) return -1;
+    uint32_t bytes_read = btstack_min(len, available);
+    if (bytes_read == 0) return 0;
+    socket_connection_shm_copy_from_ring(ring, tail, data, bytes_read);
+    ring->position = tail + bytes_read;
+    __atomic_store_n(&ring->header->tail, ring->position, __ATOMIC_SEQ_CST);
+    // wake up producer waiting for space
+    if (__atomic_load_n(&ring->header->producer_waiting, __ATOMIC_SEQ_CST) != 0){
+        __atomic_store_n(&ring->header->producer_waiting, 0, __ATOMIC_SEQ_CST);
+        socket_connection_shm_signal(conn, conn->shm_peer_doorbell_fd);
+    }
+    return (int) bytes_read;
+}
+
+// ring is full, get notified by consumer. if it made space in the meantime, flush from own doorbell
+static void socket_connection_shm_wait(connection_t *conn){
+    socket_connection_shm_ring_t * ring = &conn->shm_tx;
+    __atomic_store_n(&ring->header->producer_waiting, 1, __ATOMIC_SEQ_CST);
+    if ((ring->position - __atomic_load_n(&ring->header->tail, __ATOMIC_SEQ_CST)) < ring->size){
+        socket_connection_shm_signal(conn, conn->shm_doorbell_fd);
+    }
+}
+
+static void socket_connection_shm_receive(connection_t *conn){
+    socket_connection_shm_receiving = conn;
+    while (conn->shm_rx_active){
+        int bytes_read = socket_connection_shm_read(conn, &conn->buffer[conn->bytes_read], conn->bytes_to_read);
+        if (bytes_read == 0) break;
+        if (bytes_read < 0){
+            log_error("socket_connection %p: invalid shared memory ring", conn);
+            conn->shm_rx_active = 0;
+            socket_connection_output_close(conn);
+            break;
+        }
+        if (socket_connection_process_bytes_read(conn, bytes_read)) break;
+        // connection closed by packet handler
+        if (socket_connection_shm_receiving != conn) return;
+    }
+    socket_connection_shm_receiving = NULL;
+}
+
+static void socket_connection_shm_doorbell_process(btstack_data_source_t *ds, btstack_data_source_callback_type_t callback_type){
+    UNUSED(callback_type);
+    connection_t * conn = ((socket_connection_shm_doorbell_t *) ds)->connection;
+    uint64_t value;
+    ssize_t res = read(conn->shm_doorbell_fd, &value, sizeof(value));
+    UNUSED(res);
+    if (conn->shm_tx_active && (socket_connection_output_pending(conn) > 0)){
+        socket_connection_flush(conn);
+    }
+    socket_connection_shm_receive(conn);
+}
+
+static int socket_connection_shm_doorbell_active(connection_t *conn){
+    return (conn->shm_state == SOCKET_CONNECTION_SHM_W4_COMMIT) || (conn->shm_state == SOCKET_CONNECTION_SHM_ACTIVE);
+}
+
+static void socket_connection_shm_start_doorbell(connection_t *conn){
+    btstack_data_source_t * ds = &conn->shm_doorbell.ds;
+    btstack_run_loop_set_data_source_handler(ds, &socket_connection_shm_doorbell_process);
+    btstack_run_loop_set_data_source_fd(ds, conn->shm_doorbell_fd);
+    btstack_run_loop_enable_data_source_callbacks(ds, DATA_SOURCE_CALLBACK_READ);
+    btstack_run_loop_add_data_source(ds);
+}
+
+// switch output to ring after pending output was written to socket
+static void socket_connection_shm_tx_check(connection_t *conn){
+    if (conn->shm_tx_active) return;
+    if (conn->shm_tx_ready == 0) return;
+    if (socket_connection_output_pending(conn) > 0) return;
+    log_info("socket_connection %p: send via shared memory", conn);
+    conn->shm_tx_active = 1;
+}
+
+static void socket_connection_shm_park(connection_t *conn){
+    if (socket_connection_shm_doorbell_active(conn)){
+        btstack_run_loop_remove_data_source(&conn->shm_doorbell.ds);
+    }
+}
+
+static void socket_connection_shm_unpark(connection_t *conn){
+    if (socket_connection_shm_doorbell_active(conn)){
+        btstack_run_loop_add_data_source(&conn->shm_doorbell.ds);
+        // continue reading from ring
+        socket_connection_shm_signal(conn, conn->shm_doorbell_fd);
+    }
+}
+
+static void socket_connection_shm_close(connection_t *conn){
+    if (socket_connection_shm_receiving == conn){
+        socket_connection_shm_receiving = NULL;
+    }
+    if (socket_connection_shm_doorbell_active(conn)){
+        btstack_run_loop_remove_data_source(&conn->shm_doorbell.ds);
+    }
+    if (conn->shm_base != NULL){
+        munmap(conn->shm_base, conn->shm_len);
+        conn->shm_base = NULL;
+    }
+    if (conn->shm_doorbell_fd >= 0){
+        close(conn->shm_doorbell_fd);
+        conn->shm_doorbell_fd = -1;
+    }
+    if (conn->shm_peer_doorbell_fd >= 0){
+        close(conn->shm_peer_doorbell_fd);
+        conn->shm_peer_doorbell_fd = -1;
+    }
+    uint8_t i;
+    for (i = 0; i < conn->shm_num_received_fds; i++){
+        close(conn->shm_received_fds[i]);
+    }
+    conn->shm_num_received_fds = 0;
+    conn->shm_state     = SOCKET_CONNECTION_SHM_IDLE;
+    conn->shm_rx_active = 0;
+    conn->shm_tx_ready  = 0;
+    conn->shm_tx_active = 0;
+}
+
+static int socket_connection_shm_valid_ring_size(uint32_t ring_size){
+    if (ring_size < SOCKET_CONNECTION_SHM_MIN_RING_SIZE) return 0;
+    if (ring_size > SOCKET_CONNECTION_SHM_MAX_RING_SIZE) return 0;
+    return (ring_size & (ring_size - 1)) == 0;
+}
+
+static size_t socket_connection_shm_len(uint32_t ring_size){
+    return SOCKET_CONNECTION_SHM_DATA_OFFSET + (2 * (size_t) ring_size);
+}
+
+// ring 0: client -> daemon, ring 1: daemon -> client
+static int socket_connection_shm_map(connection_t *conn, int memfd, uint32_t ring_size, int daemon){
+    size_t len = socket_connection_shm_len(ring_size);
+    void * base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    if (base == MAP_FAILED) return -1;
+    conn->shm_base = (uint8_t *) base;
+    conn->shm_len  = len;
+    socket_connection_shm_ring_header_t * headers = (socket_connection_shm_ring_header_t *) base;
+    uint8_t * data = &conn->shm_base[SOCKET_CONNECTION_SHM_DATA_OFFSET];
+    int rx = daemon ? 0 : 1;
+    int tx = 1 - rx;
+    conn->shm_rx.header   = &headers[rx];
+    conn->shm_rx.data     = &data[rx * ring_size];
+    conn->shm_rx.size     = ring_size;
+    conn->shm_rx.position = 0;
+    conn->shm_tx.header   = &headers[tx];
+    conn->shm_tx.data     = &data[tx * ring_size];
+    conn->shm_tx.size     = ring_size;
+    conn->shm_tx.position = 0;
+    return 0;
+}
+
+// daemon: map shared memory provided by client
+static void socket_connection_shm_handle_request(connection_t *conn, uint32_t ring_size){
+    int accepted = 0;
+    if ((conn->shm_state == SOCKET_CONNECTION_SHM_IDLE) && (conn->shm_num_received_fds == SOCKET_CONNECTION_SHM_NUM_FDS)
+    &&  socket_connection_shm_valid_ring_size(ring_size)){
+        int memfd = conn->shm_received_fds[0];
+        struct stat st;
+        // sealed against shrinking, mapping can't become invalid
+        int seals = fcntl(memfd, F_GET_SEALS);
+        if ((fstat(memfd, &st) == 0) && ((size_t) st.st_size >= socket_connection_shm_len(ring_size))
+        &&  (seals >= 0) && ((seals & F_SEAL_SHRINK) != 0)
+        &&  (socket_connection_shm_map(conn, memfd, ring_size, 1) == 0)){
+            accepted = 1;
+        }
+    }
+    if (accepted){
+        close(conn->shm_received_fds[0]);
+        conn->shm_doorbell_fd      = conn->shm_received_fds[1];
+        conn->shm_peer_doorbell_fd = conn->shm_received_fds[2];
+        conn->shm_num_received_fds = 0;
+        // never block on doorbell provided by client
+        fcntl(conn->shm_doorbell_fd,      F_SETFL, O_NONBLOCK);
+        fcntl(conn->shm_peer_doorbell_fd, F_SETFL, O_NONBLOCK);
+    } else {
+        uint8_t i;
+        for (i = 0; i < conn->shm_num_received_fds; i++){
+            close(conn->shm_received_fds[i]);
+        }
+        conn->shm_num_received_fds = 0;
+    }
+
+    log_info("socket_connection %p: shared memory with %u bytes rings %s", conn, ring_size, accepted ? "accepted" : "rejected");
+    uint8_t response = accepted ? SOCKET_CONNECTION_SHM_ACCEPT : SOCKET_CONNECTION_SHM_REJECT;
+    socket_connection_send_packet(conn, SOCKET_CONNECTION_CONTROL_PACKET, 0, &response, 1);
+    if (!accepted) return;
+
+    conn->shm_state = SOCKET_CONNECTION_SHM_W4_COMMIT;
+    socket_connection_shm_start_doorbell(conn);
+    conn->shm_tx_ready = 1;
+    socket_connection_shm_tx_check(conn);
+}
+
+static void socket_connection_shm_handle_control(connection_t *conn, const uint8_t *data, uint16_t length){
+    if (length < 1) return;
+    uint8_t commit;
+    switch (data[0]){
+        case SOCKET_CONNECTION_SHM_REQUEST:
+            if (length < 5) break;
+            socket_connection_shm_handle_request(conn, little_endian_read_32(data, 1));
+            break;
+        case SOCKET_CONNECTION_SHM_ACCEPT:
+            // client: receive from ring, send via ring after commit
+            if (conn->shm_state != SOCKET_CONNECTION_SHM_W4_ACCEPT) break;
+            conn->shm_state = SOCKET_CONNECTION_SHM_ACTIVE;
+            conn->shm_rx_active = 1;
+            socket_connection_shm_start_doorbell(conn);
+            commit = SOCKET_CONNECTION_SHM_COMMIT;
+            socket_connection_send_packet(conn, SOCKET_CONNECTION_CONTROL_PACKET, 0, &commit, 1);
+            conn->shm_tx_ready = 1;
+            socket_connection_shm_tx_check(conn);
+            socket_connection_shm_receive(conn);
+            break;
+        case SOCKET_CONNECTION_SHM_REJECT:
+            if (conn->shm_state != SOCKET_CONNECTION_SHM_W4_ACCEPT) break;
+            log_info("socket_connection %p: shared memory rejected", conn);
+            socket_connection_shm_close(conn);
+            break;
+        case SOCKET_CONNECTION_SHM_COMMIT:
+            // daemon: client sends via ring from now on
+            if (conn->shm_state != SOCKET_CONNECTION_SHM_W4_COMMIT) break;
+            conn->shm_state = SOCKET_CONNECTION_SHM_ACTIVE;
+            conn->shm_rx_active = 1;
+            socket_connection_shm_receive(conn);
+            break;
+        default:
+            break;
+    }
+}
+
+#endif
+
+int socket_connection_request_shared_memory(connection_t *connection, uint32_t ring_size){
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+    if (connection->shm_state != SOCKET_CONNECTION_SHM_IDLE) return -1;
+    if (socket_connection_shm_valid_ring_size(ring_size) == 0) return -1;
+    // request is sent directly
+    if (socket_connection_output_pending(connection) > 0) return -1;
+
+    size_t len = socket_connection_shm_len(ring_size);
+    int memfd = memfd_create("btstack", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd < 0) return -1;
+    if ((ftruncate(memfd, (off_t) len) < 0) || (fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+    ||  (socket_connection_shm_map(connection, memfd, ring_size, 0) < 0)){
+        close(memfd);
+        return -1;
+    }
+    connection->shm_doorbell_fd      = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    connection->shm_peer_doorbell_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((connection->shm_doorbell_fd < 0) || (connection->shm_peer_doorbell_fd < 0)){
+        close(memfd);
+        socket_connection_shm_close(connection);
+        return -1;
+    }
+
+    // request with opcode and ring size, file descriptors: memfd, daemon doorbell, client doorbell
+    uint8_t request[sizeof(packet_header_t) + 5];
+    little_endian_store_16(request, 0, SOCKET_CONNECTION_CONTROL_PACKET);
+    little_endian_store_16(request, 2, 0);
+    little_endian_store_16(request, 4, 5);
+    request[6] = SOCKET_CONNECTION_SHM_REQUEST;
+    little_endian_store_32(request, 7, ring_size);
+    int fds[SOCKET_CONNECTION_SHM_NUM_FDS];
+    fds[0] = memfd;
+    fds[1] = connection->shm_peer_doorbell_fd;
+    fds[2] = connection->shm_doorbell_fd;
+
+    struct iovec iov;
+    iov.iov_base = request;
+    iov.iov_len  = sizeof(request);
+    union {
+        struct cmsghdr header;
+        uint8_t buffer[CMSG_SPACE(sizeof(fds))];
+    } control;
+    memset(&control, 0, sizeof(control));
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+    struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+    ssize_t res = sendmsg(connection->socket_fd, &msg, 0);
+    connection->statistics.write_calls++;
+    close(memfd);
+    if (res != (ssize_t) sizeof(request)){
+        if (res > 0){
+            // partial packet sent, stream is broken
+            socket_connection_output_close(connection);
+        }
+        socket_connection_shm_close(connection);
+        return -1;
+    }
+    connection->statistics.bytes_written += sizeof(request);
+    connection->shm_state = SOCKET_CONNECTION_SHM_W4_ACCEPT;
+    return 0;
+#else
+    UNUSED(connection);
+    UNUSED(ring_size);
+    return -1;
+#endif
+}
+
+int socket_connection_shared_memory_active(connection_t *connection){
+#ifdef ENABLE_SOCKET_CONNECTION_SHARED_MEMORY
+    return connection->shm_rx_active && connection->shm_tx_active;
+#else
+    UNUSED(connection);
+    return 0;
+#endif
+}
+
 /**
  * create socket connection to BTdaemon 
  */
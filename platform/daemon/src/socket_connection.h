@@ -56,6 +56,22 @@ extern "C" {
 /** opaque connection type */
 typedef struct connection connection_t;
 
+/** handling of packets that would exceed the high-water mark of a connection's output buffer */
+typedef enum {
+    SOCKET_CONNECTION_OVERFLOW_DROP,        // drop packet
+    SOCKET_CONNECTION_OVERFLOW_DISCONNECT,  // close connection
+} socket_connection_overflow_policy_t;
+
+/** output counters of a connection */
+typedef struct {
+    uint32_t packets_sent;      // packets written or queued
+    uint32_t packets_queued;    // packets that could not be written right away
+    uint32_t packets_dropped;   // packets dropped due to high-water mark or closed connection
+    uint32_t bytes_written;
+    uint32_t write_calls;       // write/writev system calls
+    uint32_t output_max;        // max bytes pending in output buffer
+} socket_connection_statistics_t;
+
 /**
  * Init socket connection module
  */
@@ -117,6 +133,34 @@ void socket_connection_send_packet(connection_t *connection, uint16_t packet_typ
  */
 void socket_connection_send_packet_all(uint16_t type, uint16_t channel, uint8_t *packet, uint16_t size);
 
+/**
+ * set high-water mark for output buffer and overflow policy used for new connections
+ */
+void socket_connection_set_default_high_water_mark(uint32_t high_water_mark, socket_connection_overflow_policy_t policy);
+
+/**
+ * set high-water mark for output buffer and overflow policy of a single connection
+ */
+void socket_connection_set_high_water_mark(connection_t *connection, uint32_t high_water_mark, socket_connection_overflow_policy_t policy);
+
+/**
+ * get output counters of a connection
+ */
+void socket_connection_get_statistics(connection_t *connection, socket_connection_statistics_t *statistics);
+
+/**
+ * request shared memory transport for connection to BTdaemon (Linux only)
+ * two rings of ring_size bytes (power of two) and eventfd doorbells are passed to the daemon over the unix socket,
+ * connection switches to shared memory if daemon accepts, otherwise it continues to use the socket
+ * @return 0 if request was sent
+ */
+int socket_connection_request_shared_memory(connection_t *connection, uint32_t ring_size);
+
+/**
+ * query if connection sends and receives packets via shared memory
+ */
+int socket_connection_shared_memory_active(connection_t *connection);
+
 /**
  * try to dispatch packet for all "parked" connections.
  * if dispatch is successful, a connection is added again to run loop
@@ -43,16 +43,21 @@
 #include "btstack_debug.h"
 #include "btstack_audio.h"
 #include "btstack_run_loop.h"
+#include "btstack_util.h"
 
 #ifdef HAVE_PORTAUDIO
 
 #define PA_SAMPLE_TYPE               paInt16
 #define NUM_FRAMES_PER_PA_BUFFER       512
 #define NUM_OUTPUT_BUFFERS               5
-#define NUM_INPUT_BUFFERS                2
-#define DRIVER_POLL_INTERVAL_MS          5
+
+// ring buffers between PortAudio callbacks and run loop, power of two and multiple of stereo PA buffer
+// input ring buffer holds two stereo PA buffers
+#define OUTPUT_RING_BUFFER_SIZE      16384
+#define INPUT_RING_BUFFER_SIZE        4096
 
 #include <portaudio.h>
+#include "btstack_spsc_ring_buffer.h"
 
 // config
 static int                    num_channels_sink;
@@ -78,23 +83,24 @@ static PaStream * stream_sink;
 static void (*playback_callback)(int16_t * buffer, uint16_t num_samples);
 static void (*recording_callback)(const int16_t * buffer, uint16_t num_samples);
 
-// output buffer
-static int16_t               output_buffer_storage[NUM_OUTPUT_BUFFERS * NUM_FRAMES_PER_PA_BUFFER * 2];   // stereo
-static int16_t             * output_buffers[NUM_OUTPUT_BUFFERS];
-static int                   output_buffer_to_play;
-static int                   output_buffer_to_fill;
+// output buffer: filled by run loop, played by PortAudio callback
+static int16_t                    output_ring_buffer_storage[OUTPUT_RING_BUFFER_SIZE / 2];
+static btstack_spsc_ring_buffer_t output_ring_buffer;
+static uint32_t                   output_buffer_size;
 
-// input buffer
-static int16_t               input_buffer_a[NUM_FRAMES_PER_PA_BUFFER * 2];   // stereo
-static int16_t               input_buffer_b[NUM_FRAMES_PER_PA_BUFFER * 2];   // stereo
-static int16_t             * input_buffers[NUM_INPUT_BUFFERS] = { input_buffer_a, input_buffer_b};
-static int                   input_buffer_to_record;
-static int                   input_buffer_to_fill;
+// input buffer: filled by PortAudio callback, recorded by run loop
+static int16_t                    input_ring_buffer_storage[INPUT_RING_BUFFER_SIZE / 2];
+static btstack_spsc_ring_buffer_t input_ring_buffer;
+static uint32_t                   input_buffer_size;
 
+// data sources polled when PortAudio callbacks have played or recorded a buffer
+static btstack_data_source_t      driver_data_source_sink;
+static btstack_data_source_t      driver_data_source_source;
 
-// timer to fill output ring buffer
-static btstack_timer_source_t  driver_timer_sink;
-static btstack_timer_source_t  driver_timer_source;
+static void driver_ring_buffer_watermark_handler(btstack_spsc_ring_buffer_t * ring_buffer){
+    UNUSED(ring_buffer);
+    btstack_run_loop_poll_data_sources_from_irq();
+}
 
 static int portaudio_callback_sink( const void *                     inputBuffer, 
                                     void *                           outputBuffer,
@@ -111,29 +117,31 @@ static int portaudio_callback_sink( const void *                     inputBuffer
     (void) frames_per_buffer;
     (void) inputBuffer;
 
-    // simplified volume control
-    uint16_t index;
-    int16_t * from_buffer = output_buffers[output_buffer_to_play];
+    // simplified volume control: multiply with volume ^ 4
+    int16_t x2 = sink_volume * sink_volume;
+    int16_t x4 = (x2 * x2) >> 14;
     int16_t * to_buffer = (int16_t *) outputBuffer;
+    uint32_t num_samples = NUM_FRAMES_PER_PA_BUFFER * num_channels_sink;
     btstack_assert(frames_per_buffer == NUM_FRAMES_PER_PA_BUFFER);
 
-#if 0
-    // up to 8 right shifts
-    int right_shift = 8 - btstack_min(8, ((sink_volume + 15) / 16));
-    for (index = 0; index < (NUM_FRAMES_PER_PA_BUFFER * num_channels_sink); index++){
-        *to_buffer++ = (*from_buffer++) >> right_shift;
-    }
-#else
-    // multiply with volume ^ 4
-    int16_t x2 = sink_volume * sink_volume;
-    int16_t x4 = (x2 * x2) >> 14;
-    for (index = 0; index < (NUM_FRAMES_PER_PA_BUFFER * num_channels_sink); index++){
-        *to_buffer++ = ((*from_buffer++) * x4) >> 14;
+    // buffer is either contiguous or wraps around once
+    while (num_samples > 0){
+        const uint8_t * span;
+        uint32_t span_samples = btstack_spsc_ring_buffer_get_read_span(&output_ring_buffer, &span) / 2;
+        if (span_samples == 0) break;
+        span_samples = btstack_min(span_samples, num_samples);
+        const int16_t * from_buffer = (const int16_t *) span;
+        uint32_t index;
+        for (index = 0; index < span_samples; index++){
+            *to_buffer++ = ((*from_buffer++) * x4) >> 14;
+        }
+        num_samples -= span_samples;
+        // wakes run loop to fill buffer
+        btstack_spsc_ring_buffer_commit_read(&output_ring_buffer, span_samples * 2);
     }
-#endif
 
-    // next
-    output_buffer_to_play = (output_buffer_to_play + 1 ) % NUM_OUTPUT_BUFFERS;
+    // underrun
+    memset(to_buffer, 0, num_samples * 2);
 
     return 0;
 }
@@ -153,44 +161,46 @@ static int portaudio_callback_source( const void *                     inputBuff
     (void) samples_per_buffer;
     (void) outputBuffer;
 
-    // store in one of our buffers
-    memcpy(input_buffers[input_buffer_to_fill], inputBuffer, NUM_FRAMES_PER_PA_BUFFER * num_bytes_per_sample_source);
-
-    // next
-    input_buffer_to_fill = (input_buffer_to_fill + 1 ) % NUM_INPUT_BUFFERS;
+    // store if there's space, wakes run loop to process buffer
+    if (btstack_spsc_ring_buffer_bytes_free(&input_ring_buffer) >= input_buffer_size){
+        btstack_spsc_ring_buffer_write(&input_ring_buffer, (const uint8_t *) inputBuffer, input_buffer_size);
+    }
 
     return 0;
 }
 
-static void driver_timer_handler_sink(btstack_timer_source_t * ts){
-
-    // playback buffer ready to fill
-    while (output_buffer_to_play != output_buffer_to_fill){
-        (*playback_callback)(output_buffers[output_buffer_to_fill], NUM_FRAMES_PER_PA_BUFFER);
-
-        // next
-        output_buffer_to_fill = (output_buffer_to_fill + 1 ) % NUM_OUTPUT_BUFFERS;
+static void driver_fill_output_ring_buffer(void){
+    // keep NUM_OUTPUT_BUFFERS - 1 buffers queued, buffers never wrap as ring buffer size is a multiple of buffer size
+    uint32_t max_buffered = (NUM_OUTPUT_BUFFERS - 1) * output_buffer_size;
+    while ((btstack_spsc_ring_buffer_bytes_available(&output_ring_buffer) + output_buffer_size) <= max_buffered){
+        uint8_t * span;
+        uint32_t span_len = btstack_spsc_ring_buffer_get_write_span(&output_ring_buffer, &span);
+        btstack_assert(span_len >= output_buffer_size);
+        UNUSED(span_len);
+        (*playback_callback)((int16_t *) span, NUM_FRAMES_PER_PA_BUFFER);
+        btstack_spsc_ring_buffer_commit_write(&output_ring_buffer, output_buffer_size);
     }
-
-    // re-set timer
-    btstack_run_loop_set_timer(ts, DRIVER_POLL_INTERVAL_MS);
-    btstack_run_loop_add_timer(ts);
 }
 
-static void driver_timer_handler_source(btstack_timer_source_t * ts){
-
-    // recording buffer ready to process
-    if (input_buffer_to_record != input_buffer_to_fill){
-
-        (*recording_callback)(input_buffers[input_buffer_to_record], NUM_FRAMES_PER_PA_BUFFER);
-
-        // next
-        input_buffer_to_record = (input_buffer_to_record + 1 ) % NUM_INPUT_BUFFERS;
-    }    
+static void driver_data_source_handler_sink(btstack_data_source_t * ds, btstack_data_source_callback_type_t callback_type){
+    UNUSED(ds);
+    UNUSED(callback_type);
+    // playback buffer ready to fill
+    driver_fill_output_ring_buffer();
+}
 
-    // re-set timer
-    btstack_run_loop_set_timer(ts, DRIVER_POLL_INTERVAL_MS);
-    btstack_run_loop_add_timer(ts);
+static void driver_data_source_handler_source(btstack_data_source_t * ds, btstack_data_source_callback_type_t callback_type){
+    UNUSED(ds);
+    UNUSED(callback_type);
+    // recording buffers ready to process, buffers never wrap as ring buffer size is a multiple of buffer size
+    while (btstack_spsc_ring_buffer_bytes_available(&input_ring_buffer) >= input_buffer_size){
+        const uint8_t * span;
+        uint32_t span_len = btstack_spsc_ring_buffer_get_read_span(&input_ring_buffer, &span);
+        btstack_assert(span_len >= input_buffer_size);
+        UNUSED(span_len);
+        (*recording_callback)((const int16_t *) span, NUM_FRAMES_PER_PA_BUFFER);
+        btstack_spsc_ring_buffer_commit_read(&input_ring_buffer, input_buffer_size);
+    }
 }
 
 static int btstack_audio_portaudio_sink_init(
@@ -202,11 +212,12 @@ static int btstack_audio_portaudio_sink_init(
 
     num_channels_sink = channels;
     num_bytes_per_sample_sink = 2 * channels;
+    output_buffer_size = NUM_FRAMES_PER_PA_BUFFER * num_bytes_per_sample_sink;
 
-    uint8_t i;
-    for (i=0;i<NUM_OUTPUT_BUFFERS;i++){
-        output_buffers[i] = &output_buffer_storage[i * NUM_FRAMES_PER_PA_BUFFER * 2];
-    }
+    // PortAudio callback requests more data after each played buffer
+    btstack_spsc_ring_buffer_init(&output_ring_buffer, (uint8_t *) output_ring_buffer_storage, OUTPUT_RING_BUFFER_SIZE);
+    btstack_spsc_ring_buffer_set_write_watermark(&output_ring_buffer, OUTPUT_RING_BUFFER_SIZE - (NUM_OUTPUT_BUFFERS - 2) * output_buffer_size,
+                                                 &driver_ring_buffer_watermark_handler);
 
     if (!playback){
         log_error("No playback callback");
@@ -274,6 +285,11 @@ static int btstack_audio_portaudio_source_init(
 
     num_channels_source = channels;
     num_bytes_per_sample_source = 2 * channels;
+    input_buffer_size = NUM_FRAMES_PER_PA_BUFFER * num_bytes_per_sample_source;
+
+    // PortAudio callback reports each recorded buffer
+    btstack_spsc_ring_buffer_init(&input_ring_buffer, (uint8_t *) input_ring_buffer_storage, INPUT_RING_BUFFER_SIZE);
+    btstack_spsc_ring_buffer_set_read_watermark(&input_ring_buffer, input_buffer_size, &driver_ring_buffer_watermark_handler);
 
     if (!recording){
         log_error("No recording callback");
@@ -354,12 +370,8 @@ static void btstack_audio_portaudio_sink_start_stream(void){
     if (!playback_callback) return;
 
     // fill buffers once
-    uint8_t i;
-    for (i=0;i<NUM_OUTPUT_BUFFERS-1;i++){
-        (*playback_callback)(&output_buffer_storage[i*NUM_FRAMES_PER_PA_BUFFER*2], NUM_FRAMES_PER_PA_BUFFER);
-    }
-    output_buffer_to_play = 0;
-    output_buffer_to_fill = NUM_OUTPUT_BUFFERS-1;
+    btstack_spsc_ring_buffer_reset(&output_ring_buffer);
+    driver_fill_output_ring_buffer();
 
     /* -- start stream -- */
     PaError err = Pa_StartStream(stream_sink);
@@ -368,10 +380,10 @@ static void btstack_audio_portaudio_sink_start_stream(void){
         return;
     }
 
-    // start timer
-    btstack_run_loop_set_timer_handler(&driver_timer_sink, &driver_timer_handler_sink);
-    btstack_run_loop_set_timer(&driver_timer_sink, DRIVER_POLL_INTERVAL_MS);
-    btstack_run_loop_add_timer(&driver_timer_sink);
+    // get polled when buffer was played
+    btstack_run_loop_set_data_source_handler(&driver_data_source_sink, &driver_data_source_handler_sink);
+    btstack_run_loop_enable_data_source_callbacks(&driver_data_source_sink, DATA_SOURCE_CALLBACK_POLL);
+    btstack_run_loop_add_data_source(&driver_data_source_sink);
 
     sink_active = 1;
 }
@@ -380,6 +392,8 @@ static void btstack_audio_portaudio_source_start_stream(void){
 
     if (!recording_callback) return;
 
+    btstack_spsc_ring_buffer_reset(&input_ring_buffer);
+
     /* -- start stream -- */
     PaError err = Pa_StartStream(stream_source);
     if (err != paNoError){
@@ -387,10 +401,10 @@ static void btstack_audio_portaudio_source_start_stream(void){
         return;
     }
 
-    // start timer
-    btstack_run_loop_set_timer_handler(&driver_timer_source, &driver_timer_handler_source);
-    btstack_run_loop_set_timer(&driver_timer_source, DRIVER_POLL_INTERVAL_MS);
-    btstack_run_loop_add_timer(&driver_timer_source);
+    // get polled when buffer was recorded
+    btstack_run_loop_set_data_source_handler(&driver_data_source_source, &driver_data_source_handler_source);
+    btstack_run_loop_enable_data_source_callbacks(&driver_data_source_source, DATA_SOURCE_CALLBACK_POLL);
+    btstack_run_loop_add_data_source(&driver_data_source_source);
 
     source_active = 1;
 }
@@ -400,8 +414,8 @@ static void btstack_audio_portaudio_sink_stop_stream(void){
     if (!playback_callback) return;
     if (!sink_active)       return;
 
-    // stop timer
-    btstack_run_loop_remove_timer(&driver_timer_sink);
+    // stop polling
+    btstack_run_loop_remove_data_source(&driver_data_source_sink);
 
     PaError err = Pa_StopStream(stream_sink);
     if (err != paNoError){
@@ -417,8 +431,8 @@ static void btstack_audio_portaudio_source_stop_stream(void){
     if (!recording_callback) return;
     if (!source_active)      return;
 
-    // stop timer
-    btstack_run_loop_remove_timer(&driver_timer_source);
+    // stop polling
+    btstack_run_loop_remove_data_source(&driver_data_source_source);
 
     PaError err = Pa_StopStream(stream_source);
     if (err != paNoError){
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+#define BTSTACK_FILE__ "btstack_crypto_worker_posix.c"
+
+#include "btstack_crypto_worker_posix.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "btstack_debug.h"
+#include "btstack_run_loop.h"
+
+// btstack_crypto has at most one ECC operation in flight, allow for a few more
+#define BTSTACK_CRYPTO_WORKER_POSIX_NUM_JOBS 4
+
+typedef struct {
+    void (*job)(void * context);
+    void * context;
+    btstack_context_callback_registration_t done;
+} btstack_crypto_worker_posix_job_t;
+
+static pthread_mutex_t worker_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  worker_cond  = PTHREAD_COND_INITIALIZER;
+static pthread_t       worker_thread;
+static bool            worker_started;
+
+static btstack_crypto_worker_posix_job_t worker_jobs[BTSTACK_CRYPTO_WORKER_POSIX_NUM_JOBS];
+static uint8_t worker_jobs_head;
+static uint8_t worker_jobs_count;
+
+static void * btstack_crypto_worker_posix_thread(void * arg){
+    UNUSED(arg);
+    while (true){
+        pthread_mutex_lock(&worker_mutex);
+        while (worker_jobs_count == 0u){
+            pthread_cond_wait(&worker_cond, &worker_mutex);
+        }
+        btstack_crypto_worker_posix_job_t * job = &worker_jobs[worker_jobs_head];
+        pthread_mutex_unlock(&worker_mutex);
+
+        // job slot stays reserved until done callback was queued
+        (*job->job)(job->context);
+        btstack_run_loop_execute_on_main_thread(&job->done);
+
+        pthread_mutex_lock(&worker_mutex);
+        worker_jobs_head = (worker_jobs_head + 1u) % BTSTACK_CRYPTO_WORKER_POSIX_NUM_JOBS;
+        worker_jobs_count--;
+        pthread_mutex_unlock(&worker_mutex);
+    }
+    return NULL;
+}
+
+static void btstack_crypto_worker_posix_execute(void (*job)(void * context), void (*done)(void * context), void * context){
+    pthread_mutex_lock(&worker_mutex);
+    if (worker_started == false){
+        worker_started = pthread_create(&worker_thread, NULL, &btstack_crypto_worker_posix_thread, NULL) == 0;
+        if (worker_started){
+            pthread_detach(worker_thread);
+        }
+    }
+    if ((worker_started == false) || (worker_jobs_count == BTSTACK_CRYPTO_WORKER_POSIX_NUM_JOBS)){
+        pthread_mutex_unlock(&worker_mutex);
+        // no worker available, execute on main thread
+        log_error("crypto worker not available, execute job on main thread");
+        (*job)(context);
+        (*done)(context);
+        return;
+    }
+    uint8_t index = (worker_jobs_head + worker_jobs_count) % BTSTACK_CRYPTO_WORKER_POSIX_NUM_JOBS;
+    btstack_crypto_worker_posix_job_t * worker_job = &worker_jobs[index];
+    memset(worker_job, 0, sizeof(btstack_crypto_worker_posix_job_t));
+    worker_job->job = job;
+    worker_job->context = context;
+    worker_job->done.callback = done;
+    worker_job->done.context = context;
+    worker_jobs_count++;
+    pthread_cond_signal(&worker_cond);
+    pthread_mutex_unlock(&worker_mutex);
+}
+
+static const btstack_crypto_ecc_p256_executor_t btstack_crypto_worker_posix = {
+    &btstack_crypto_worker_posix_execute
+};
+
+const btstack_crypto_ecc_p256_executor_t * btstack_crypto_worker_posix_get_instance(void){
+    return &btstack_crypto_worker_posix;
+}
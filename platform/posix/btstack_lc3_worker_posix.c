@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+#define BTSTACK_FILE__ "btstack_lc3_worker_posix.c"
+
+#include "btstack_lc3_worker_posix.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#include "btstack_debug.h"
+
+// worker threads in addition to the calling thread
+#ifndef BTSTACK_LC3_WORKER_POSIX_NUM_THREADS
+#define BTSTACK_LC3_WORKER_POSIX_NUM_THREADS 3
+#endif
+
+static pthread_mutex_t worker_mutex     = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  worker_cond_jobs = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  worker_cond_done = PTHREAD_COND_INITIALIZER;
+static bool            workers_initialized;
+static uint8_t         workers_num_started;
+
+// current batch, job and context stay valid until all jobs have completed
+static void (*batch_job)(void * context, uint16_t index);
+static void *   batch_context;
+static uint16_t batch_num_jobs;
+static uint16_t batch_next_index;
+static uint16_t batch_num_completed;
+
+// take jobs of current batch until all have been started, called with mutex locked
+static void btstack_lc3_worker_posix_process_jobs(void){
+    while (batch_next_index < batch_num_jobs){
+        uint16_t index = batch_next_index++;
+        pthread_mutex_unlock(&worker_mutex);
+        (*batch_job)(batch_context, index);
+        pthread_mutex_lock(&worker_mutex);
+        batch_num_completed++;
+        if (batch_num_completed == batch_num_jobs){
+            pthread_cond_signal(&worker_cond_done);
+        }
+    }
+}
+
+static void * btstack_lc3_worker_posix_thread(void * arg){
+    UNUSED(arg);
+    pthread_mutex_lock(&worker_mutex);
+    while (true){
+        while (batch_next_index >= batch_num_jobs){
+            pthread_cond_wait(&worker_cond_jobs, &worker_mutex);
+        }
+        btstack_lc3_worker_posix_process_jobs();
+    }
+    return NULL;
+}
+
+static void btstack_lc3_worker_posix_start_threads(void){
+    workers_initialized = true;
+    uint8_t i;
+    for (i = 0; i < BTSTACK_LC3_WORKER_POSIX_NUM_THREADS; i++){
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, &btstack_lc3_worker_posix_thread, NULL) != 0){
+            log_error("LC3 worker thread %u could not be started", i);
+            break;
+        }
+        pthread_detach(thread);
+        workers_num_started++;
+    }
+}
+
+static void btstack_lc3_worker_posix_run(void (*job)(void * context, uint16_t index), void * context, uint16_t num_jobs){
+    pthread_mutex_lock(&worker_mutex);
+    if (workers_initialized == false){
+        btstack_lc3_worker_posix_start_threads();
+    }
+    batch_job = job;
+    batch_context = context;
+    batch_num_jobs = num_jobs;
+    batch_next_index = 0;
+    batch_num_completed = 0;
+    if (workers_num_started > 0u){
+        pthread_cond_broadcast(&worker_cond_jobs);
+    }
+    // calling thread processes jobs as well
+    btstack_lc3_worker_posix_process_jobs();
+    while (batch_num_completed < batch_num_jobs){
+        pthread_cond_wait(&worker_cond_done, &worker_mutex);
+    }
+    pthread_mutex_unlock(&worker_mutex);
+}
+
+static const btstack_lc3_executor_t btstack_lc3_worker_posix = {
+    &btstack_lc3_worker_posix_run
+};
+
+const btstack_lc3_executor_t * btstack_lc3_worker_posix_get_instance(void){
+    return &btstack_lc3_worker_posix;
+}
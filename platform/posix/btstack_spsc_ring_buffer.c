@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+#define BTSTACK_FILE__ "btstack_spsc_ring_buffer.c"
+
+/*
+ *  btstack_spsc_ring_buffer.c
+ *
+ *  Write and read positions are free running and only masked on access, full and empty are
+ *  distinguished by their difference. Producer publishes data with a release store of write_index,
+ *  consumer releases space with a release store of read_index.
+ */
+
+#include "btstack_spsc_ring_buffer.h"
+
+#include <string.h>
+
+#include "btstack_debug.h"
+#include "btstack_util.h"
+
+#ifdef __STDC_NO_ATOMICS__
+#error "btstack_spsc_ring_buffer requires C11 atomics"
+#endif
+
+void btstack_spsc_ring_buffer_init(btstack_spsc_ring_buffer_t * ring_buffer, uint8_t * storage, uint32_t storage_size){
+    btstack_assert((storage_size > 0u) && ((storage_size & (storage_size - 1u)) == 0u));
+    ring_buffer->storage = storage;
+    ring_buffer->size = storage_size;
+    ring_buffer->mask = storage_size - 1u;
+    ring_buffer->read_watermark = 0;
+    ring_buffer->read_watermark_handler = NULL;
+    ring_buffer->write_watermark = 0;
+    ring_buffer->write_watermark_handler = NULL;
+    btstack_spsc_ring_buffer_reset(ring_buffer);
+}
+
+void btstack_spsc_ring_buffer_reset(btstack_spsc_ring_buffer_t * ring_buffer){
+    atomic_store_explicit(&ring_buffer->write_index, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring_buffer->read_index,  0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+void btstack_spsc_ring_buffer_set_read_watermark(btstack_spsc_ring_buffer_t * ring_buffer, uint32_t num_bytes_available,
+                                                 void (*handler)(btstack_spsc_ring_buffer_t * ring_buffer)){
+    ring_buffer->read_watermark = num_bytes_available;
+    ring_buffer->read_watermark_handler = handler;
+}
+
+void btstack_spsc_ring_buffer_set_write_watermark(btstack_spsc_ring_buffer_t * ring_buffer, uint32_t num_bytes_free,
+                                                  void (*handler)(btstack_spsc_ring_buffer_t * ring_buffer)){
+    ring_buffer->write_watermark = num_bytes_free;
+    ring_buffer->write_watermark_handler = handler;
+}
+
+uint32_t btstack_spsc_ring_buffer_bytes_available(const btstack_spsc_ring_buffer_t * ring_buffer){
+    uint32_t read_index  = atomic_load_explicit(&ring_buffer->read_index,  memory_order_acquire);
+    uint32_t write_index = atomic_load_explicit(&ring_buffer->write_index, memory_order_acquire);
+    return write_index - read_index;
+}
+
+uint32_t btstack_spsc_ring_buffer_bytes_free(const btstack_spsc_ring_buffer_t * ring_buffer){
+    return ring_buffer->size - btstack_spsc_ring_buffer_bytes_available(ring_buffer);
+}
+
+uint32_t btstack_spsc_ring_buffer_get_write_span(btstack_spsc_ring_buffer_t * ring_buffer, uint8_t ** span){
+    uint32_t write_index = atomic_load_explicit(&ring_buffer->write_index, memory_order_relaxed);
+    uint32_t read_index  = atomic_load_explicit(&ring_buffer->read_index,  memory_order_acquire);
+    uint32_t offset = write_index & ring_buffer->mask;
+    *span = &ring_buffer->storage[offset];
+    return btstack_min(ring_buffer->size - (write_index - read_index), ring_buffer->size - offset);
+}
+
+void btstack_spsc_ring_buffer_commit_write(btstack_spsc_ring_buffer_t * ring_buffer, uint32_t num_bytes){
+    uint32_t write_index = atomic_load_explicit(&ring_buffer->write_index, memory_order_relaxed) + num_bytes;
+    atomic_store_explicit(&ring_buffer->write_index, write_index, memory_order_release);
+    if (ring_buffer->read_watermark_handler == NULL) return;
+    // level triggered: consumer that missed the update of write_index will be notified
+    uint32_t read_index = atomic_load_explicit(&ring_buffer->read_index, memory_order_acquire);
+    if ((write_index - read_index) >= ring_buffer->read_watermark){
+        (*ring_buffer->read_watermark_handler)(ring_buffer);
+    }
+}
+
+uint32_t btstack_spsc_ring_buffer_get_read_span(btstack_spsc_ring_buffer_t * ring_buffer, const uint8_t ** span){
+    uint32_t read_index  = atomic_load_explicit(&ring_buffer->read_index,  memory_order_relaxed);
+    uint32_t write_index = atomic_load_explicit(&ring_buffer->write_index, memory_order_acquire);
+    uint32_t offset = read_index & ring_buffer->mask;
+    *span = &ring_buffer->storage[offset];
+    return btstack_min(write_index - read_index, ring_buffer->size - offset);
+}
+
+void btstack_spsc_ring_buffer_commit_read(btstack_spsc_ring_buffer_t * ring_buffer, uint32_t num_bytes){
+    uint32_t read_index = atomic_load_explicit(&ring_buffer->read_index, memory_order_relaxed) + num_bytes;
+    atomic_store_explicit(&ring_buffer->read_index, read_index, memory_order_release);
+    if (ring_buffer->write_watermark_handler == NULL) return;
+    // level triggered: producer that missed the update of read_index will be notified
+    uint32_t write_index = atomic_load_explicit(&ring_buffer->write_index, memory_order_acquire);
+    if ((ring_buffer->size - (write_index - read_index)) >= ring_buffer->write_watermark){
+        (*ring_buffer->write_watermark_handler)(ring_buffer);
+    }
+}
+
+uint32_t btstack_spsc_ring_buffer_write(btstack_spsc_ring_buffer_t * ring_buffer, const uint8_t * data, uint32_t data_length){
+    uint32_t write_index = atomic_load_explicit(&ring_buffer->write_index, memory_order_relaxed);
+    uint32_t read_index  = atomic_load_explicit(&ring_buffer->read_index,  memory_order_acquire);
+    uint32_t bytes_to_write = btstack_min(data_length, ring_buffer->size - (write_index - read_index));
+    if (bytes_to_write == 0u) return 0;
+    // at most two copies: up to end of storage and from start of storage
+    uint32_t offset = write_index & ring_buffer->mask;
+    uint32_t bytes_till_end = btstack_min(bytes_to_write, ring_buffer->size - offset);
+    (void) memcpy(&ring_buffer->storage[offset], data, bytes_till_end);
+    (void) memcpy(ring_buffer->storage, &data[bytes_till_end], bytes_to_write - bytes_till_end);
+    btstack_spsc_ring_buffer_commit_write(ring_buffer, bytes_to_write);
+    return bytes_to_write;
+}
+
+uint32_t btstack_spsc_ring_buffer_read(btstack_spsc_ring_buffer_t * ring_buffer, uint8_t * buffer, uint32_t length){
+    uint32_t read_index  = atomic_load_explicit(&ring_buffer->read_index,  memory_order_relaxed);
+    uint32_t write_index = atomic_load_explicit(&ring_buffer->write_index, memory_order_acquire);
+    uint32_t bytes_to_read = btstack_min(length, write_index - read_index);
+    if (bytes_to_read == 0u) return 0;
+    uint32_t offset = read_index & ring_buffer->mask;
+    uint32_t bytes_till_end = btstack_min(bytes_to_read, ring_buffer->size - offset);
+    (void) memcpy(buffer, &ring_buffer->storage[offset], bytes_till_end);
+    (void) memcpy(&buffer[bytes_till_end], ring_buffer->storage, bytes_to_read - bytes_till_end);
+    btstack_spsc_ring_buffer_commit_read(ring_buffer, bytes_to_read);
+    return bytes_to_read;
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+/**
+ * @title Single Producer Single Consumer Ring Buffer
+ *
+ * Lock-free ring buffer to pass data between exactly one producer thread and one consumer thread,
+ * e.g. between an audio driver callback and the BTstack run loop. Storage size has to be a power of two.
+ * Read and write positions are free running C11 atomics; data is accessed via contiguous spans.
+ * Watermark handlers are called from the producing/consuming thread and can be used to wake up the
+ * other side, e.g. via btstack_run_loop_poll_data_sources_from_irq().
+ *
+ */
+
+#ifndef BTSTACK_SPSC_RING_BUFFER_H
+#define BTSTACK_SPSC_RING_BUFFER_H
+
+#include <stdint.h>
+
+#include "btstack_bool.h"
+
+#ifdef __cplusplus
+#include <atomic>
+typedef std::atomic<uint32_t> btstack_spsc_ring_buffer_index_t;
+#else
+#include <stdatomic.h>
+typedef _Atomic uint32_t btstack_spsc_ring_buffer_index_t;
+#endif
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+typedef struct btstack_spsc_ring_buffer {
+    uint8_t  * storage;
+    uint32_t   size;
+    uint32_t   mask;
+
+    // called by producer after commit if number of available bytes is at least read watermark
+    uint32_t   read_watermark;
+    void    (*read_watermark_handler)(struct btstack_spsc_ring_buffer * ring_buffer);
+
+    // called by consumer after commit if number of free bytes is at least write watermark
+    uint32_t   write_watermark;
+    void    (*write_watermark_handler)(struct btstack_spsc_ring_buffer * ring_buffer);
+
+    // free running positions, only modified by producer / consumer
+    btstack_spsc_ring_buffer_index_t write_index;
+    btstack_spsc_ring_buffer_index_t read_index;
+} btstack_spsc_ring_buffer_t;
+
+/* API_START */
+
+/**
+ * Init ring buffer
+ * @param ring_buffer object
+ * @param storage
+ * @param storage_size in bytes, power of two
+ */
+void btstack_spsc_ring_buffer_init(btstack_spsc_ring_buffer_t * ring_buffer, uint8_t * storage, uint32_t storage_size);
+
+/**
+ * Reset ring buffer to initial state (empty)
+ * @note must not be called while producer or consumer access the ring buffer
+ * @param ring_buffer object
+ */
+void btstack_spsc_ring_buffer_reset(btstack_spsc_ring_buffer_t * ring_buffer);
+
+/**
+ * Register handler called by the producer after each write if at least num_bytes_available bytes can be read
+ * @param ring_buffer object
+ * @param num_bytes_available watermark
+ * @param handler or NULL
+ */
+void btstack_spsc_ring_buffer_set_read_watermark(btstack_spsc_ring_buffer_t * ring_buffer, uint32_t num_bytes_available,
+                                                 void (*handler)(btstack_spsc_ring_buffer_t * ring_buffer));
+
+/**
+ * Register handler called by the consumer after each read if at least num_bytes_free bytes can be written
+ * @param ring_buffer object
+ * @param num_bytes_free watermark
+ * @param handler or NULL
+ */
+void btstack_spsc_ring_buffer_set_write_watermark(btstack_spsc_ring_buffer_t * ring_buffer, uint32_t num_bytes_free,
+                                                  void (*handler)(btstack_spsc_ring_buffer_t * ring_buffer));
+
+/**
+ * Get number of bytes available for read
+ * @param ring_buffer object
+ * @return number of bytes available for read
+ */
+uint32_t btstack_spsc_ring_buffer_bytes_available(const btstack_spsc_ring_buffer_t * ring_buffer);
+
+/**
+ * Get free space available for write
+ * @param ring_buffer object
+ * @return number of bytes available for write
+ */
+uint32_t btstack_spsc_ring_buffer_bytes_free(const btstack_spsc_ring_buffer_t * ring_buffer);
+
+/**
+ * Producer: get contiguous free space at write position
+ * @param ring_buffer object
+ * @param span points to free space on return
+ * @return number of contiguous bytes that can be written to span
+ */
+uint32_t btstack_spsc_ring_buffer_get_write_span(btstack_spsc_ring_buffer_t * ring_buffer, uint8_t ** span);
+
+/**
+ * Producer: mark bytes written to write span as available for read
+ * @param ring_buffer object
+ * @param num_bytes written, not more than returned by get_write_span
+ */
+void btstack_spsc_ring_buffer_commit_write(btstack_spsc_ring_buffer_t * ring_buffer, uint32_t num_bytes);
+
+/**
+ * Consumer: get contiguous data at read position
+ * @param ring_buffer object
+ * @param span points to data on return
+ * @return number of contiguous bytes that can be read from span
+ */
+uint32_t btstack_spsc_ring_buffer_get_read_span(btstack_spsc_ring_buffer_t * ring_buffer, const uint8_t ** span);
+
+/**
+ * Consumer: release bytes read from read span
+ * @param ring_buffer object
+ * @param num_bytes read, not more than returned by get_read_span
+ */
+void btstack_spsc_ring_buffer_commit_read(btstack_spsc_ring_buffer_t * ring_buffer, uint32_t num_bytes);
+
+/**
+ * Producer: write up to data_length bytes
+ * @param ring_buffer object
+ * @param data to store
+ * @param data_length
+ * @return number of bytes written
+ */
+uint32_t btstack_spsc_ring_buffer_write(btstack_spsc_ring_buffer_t * ring_buffer, const uint8_t * data, uint32_t data_length);
+
+/**
+ * Consumer: read up to length bytes
+ * @param ring_buffer object
+ * @param buffer to store read data
+ * @param length to read
+ * @return number of bytes read
+ */
+uint32_t btstack_spsc_ring_buffer_read(btstack_spsc_ring_buffer_t * ring_buffer, uint8_t * buffer, uint32_t length);
+
+/* API_END */
+
+#if defined __cplusplus
+}
+#endif
+
+#endif // BTSTACK_SPSC_RING_BUFFER_H
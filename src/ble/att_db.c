@@ -86,6 +86,7 @@ static uint16_t uuid16_from_uuid(uint16_t uuid_len, uint8_t * uuid){
 typedef struct att_iterator {
     // private
     uint8_t const * att_ptr;
+    btstack_linked_item_t * segment;
     // public
     uint16_t size;
     uint16_t flags;
@@ -98,6 +99,7 @@ typedef struct att_iterator {
 static void att_persistent_ccc_cache(att_iterator_t * it);
 
 static uint8_t const * att_database = NULL;
+static btstack_linked_list_t * att_database_segments = NULL;
 static att_read_callback_t  att_read_callback  = NULL;
 static att_write_callback_t att_write_callback = NULL;
 static int      att_prepare_write_error_code   = 0;
@@ -109,14 +111,35 @@ static uint16_t att_persistent_ccc_uuid16;
 
 static void att_iterator_init(att_iterator_t *it){
     it->att_ptr = att_database;
+    it->segment = NULL;
 }
 
 static bool att_iterator_has_next(att_iterator_t *it){
     return it->att_ptr != NULL;
 }
 
+static btstack_linked_item_t * att_iterator_next_segment(att_iterator_t *it){
+    if (it->segment != NULL){
+        return it->segment->next;
+    }
+    if (att_database_segments != NULL){
+        return *att_database_segments;
+    }
+    return NULL;
+}
+
 static void att_iterator_fetch_next(att_iterator_t *it){
     it->size   = little_endian_read_16(it->att_ptr, 0);
+    // continue with next segment at end of current one
+    while (it->size == 0u){
+        btstack_linked_item_t * segment = att_iterator_next_segment(it);
+        if (segment == NULL){
+            break;
+        }
+        it->segment = segment;
+        it->att_ptr = ((att_db_segment_t *) segment)->attributes;
+        it->size    = little_endian_read_16(it->att_ptr, 0);
+    }
     if (it->size == 0u){
         it->flags = 0;
         it->handle = 0;
@@ -234,7 +257,7 @@ static int att_copy_value(att_iterator_t *it, uint16_t offset, uint8_t * buffer,
     
     // STATIC
     uint16_t bytes_to_copy = btstack_min(it->value_len - offset, buffer_size);
-    (void)memcpy(buffer, it->value, bytes_to_copy);
+    (void)memcpy(buffer, &it->value[offset], bytes_to_copy);
     return bytes_to_copy;
 }
 
@@ -252,6 +275,10 @@ void att_set_db(uint8_t const * db){
     att_database = &db[1];
 }
 
+void att_set_db_segments(btstack_linked_list_t * segments){
+    att_database_segments = segments;
+}
+
 void att_set_read_callback(att_read_callback_t callback){
     att_read_callback = callback;
 }
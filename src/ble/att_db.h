@@ -174,6 +174,13 @@ typedef struct att_service_handler {
     uint8_t flags;
 } att_service_handler_t;
 
+// additional block of attributes that follows the ATT DB set with att_set_db
+typedef struct att_db_segment {
+    btstack_linked_item_t item;
+    // attributes in ATT DB format without version byte, terminated by size 0x0000
+    uint8_t const * attributes;
+} att_db_segment_t;
+
 // MARK: ATT Operations
 
 /**
@@ -182,6 +189,13 @@ typedef struct att_service_handler {
  */
 void att_set_db(uint8_t const * db);
 
+/**
+ * @brief set list of additional ATT DB segments (att_db_segment_t) that follow the ATT DB set with att_set_db
+ * @note segments have to be sorted by attribute handle and the list can be modified afterwards
+ * @param segments list of att_db_segment_t or NULL
+ */
+void att_set_db_segments(btstack_linked_list_t * segments);
+
 /*
  * @brief set callback for read of dynamic attributes
  * @param callback
@@ -65,6 +65,20 @@ static uint16_t  att_db_max_size;
 static uint16_t  att_db_next_handle;
 static uint16_t  att_db_hash_len;
 
+// services linked into ATT DB, sorted by handle
+static btstack_linked_list_t att_db_util_services;
+
+// service under construction, main ATT DB is stored meanwhile
+static att_db_util_service_t * att_db_util_service_active;
+static bool      att_db_util_service_overflow;
+static uint8_t * att_db_util_main_db;
+static uint16_t  att_db_util_main_size;
+static uint16_t  att_db_util_main_max_size;
+static uint16_t  att_db_util_main_next_handle;
+static uint16_t  att_db_util_main_hash_len;
+
+static void (*att_db_util_service_changed_callback)(uint16_t start_handle, uint16_t end_handle);
+
 static void att_db_util_set_end_tag(void){
 	// end tag
 	att_db[att_db_size] = 0u;
@@ -72,6 +86,12 @@ static void att_db_util_set_end_tag(void){
 }
 
 void att_db_util_init(void){
+    // drop service under construction
+    if (att_db_util_service_active != NULL){
+        att_db = att_db_util_main_db;
+        att_db_max_size = att_db_util_main_max_size;
+        att_db_util_service_active = NULL;
+    }
 #ifdef HAVE_MALLOC
     if (att_db == NULL){
         att_db = (uint8_t*) malloc((size_t)ATT_DB_BUFFER_INCREMENT);
@@ -87,6 +107,15 @@ void att_db_util_init(void){
 	att_db_next_handle = 1u;
 	att_db_hash_len = 0u;
 	att_db_util_set_end_tag();
+
+	// unlink all services
+	btstack_linked_list_iterator_t it;
+	btstack_linked_list_iterator_init(&it, &att_db_util_services);
+	while (btstack_linked_list_iterator_has_next(&it)){
+	    att_db_util_service_t * service = (att_db_util_service_t *) btstack_linked_list_iterator_next(&it);
+	    service->linked = false;
+	    btstack_linked_list_iterator_remove(&it);
+	}
 }
 
 static bool att_db_util_hash_include_with_value(uint16_t uuid16){
@@ -125,6 +154,11 @@ static bool att_db_util_hash_include_without_value(uint16_t uuid16){
 static int att_db_util_assert_space(uint16_t size){
 	uint16_t required_size = att_db_size + size + 2u;
 	if (required_size <= att_db_max_size) return 1;
+	if (att_db_util_service_active != NULL){
+	    log_error("att_db: service storage full");
+	    att_db_util_service_overflow = true;
+	    return 0;
+	}
 #ifdef HAVE_MALLOC
     uint16_t new_size = att_db_max_size;
 	while (new_size < required_size){
@@ -145,12 +179,37 @@ static int att_db_util_assert_space(uint16_t size){
 #endif
 }
 
+static void att_db_util_hash_invalidate(btstack_linked_item_t * item){
+    for (; item != NULL; item = item->next){
+        ((att_db_util_service_t *) item)->hash_state_valid = false;
+    }
+}
+
+/**
+ * asserts that the next attribute handle is not used by a linked service and invalidates cached hash states
+ * @return TRUE if attribute can be added
+ */
+static int att_db_util_assert_handle(void){
+    if (att_db_util_service_active != NULL){
+        return 1;
+    }
+    att_db_util_service_t * first_service = (att_db_util_service_t *) att_db_util_services;
+    if ((first_service != NULL) && (first_service->start_handle <= att_db_next_handle)){
+        log_error("att_db: handle 0x%04x used by service", att_db_next_handle);
+        return 0;
+    }
+    // attributes before all services change
+    att_db_util_hash_invalidate(att_db_util_services);
+    return 1;
+}
+
 // attribute size in bytes (16), flags(16), handle (16), uuid (16/128), value(...)
 
 // db endds with 0x00 0x00
 
 static void att_db_util_add_attribute_uuid16(uint16_t uuid16, uint16_t flags, uint8_t * data, uint16_t data_len){
 	int size = 2u + 2u + 2u + 2u + data_len;
+	if (!att_db_util_assert_handle()) return;
 	if (!att_db_util_assert_space(size)) return;
 	little_endian_store_16(att_db, att_db_size, size);
 	att_db_size += 2u;
@@ -174,6 +233,7 @@ static void att_db_util_add_attribute_uuid16(uint16_t uuid16, uint16_t flags, ui
 
 static void att_db_util_add_attribute_uuid128(const uint8_t * uuid128, uint16_t flags, uint8_t * data, uint16_t data_len){
 	int size = 2u + 2u + 2u + 16u + data_len;
+	if (!att_db_util_assert_handle()) return;
 	if (!att_db_util_assert_space(size)) return;
 	uint16_t flags_to_store = flags | (uint16_t)ATT_PROPERTY_UUID128;
 	little_endian_store_16(att_db, att_db_size, size);
@@ -330,15 +390,21 @@ uint16_t att_db_util_get_size(void){
 	return att_db_size + 2u;	// end tag 
 }
 
-static uint8_t * att_db_util_hash_att_ptr;
+static const uint8_t * att_db_util_hash_att_ptr;
+static btstack_linked_item_t * att_db_util_hash_segment;
 static uint16_t att_db_util_hash_offset;
 static uint16_t att_db_util_hash_bytes_available;
 
 static void att_db_util_hash_fetch_next_attribute(void){
     while (true){
         uint16_t size = little_endian_read_16(att_db_util_hash_att_ptr, 0);
-        btstack_assert(size != 0);
-        UNUSED(size);
+        if (size == 0u){
+            // continue with next service
+            att_db_util_hash_segment = (att_db_util_hash_segment == NULL) ? att_db_util_services : att_db_util_hash_segment->next;
+            btstack_assert(att_db_util_hash_segment != NULL);
+            att_db_util_hash_att_ptr = ((att_db_segment_t *) att_db_util_hash_segment)->attributes;
+            continue;
+        }
         uint16_t flags = little_endian_read_16(att_db_util_hash_att_ptr, 2);
         if ((flags & (uint16_t)ATT_PROPERTY_UUID128) == 0u) {
             uint16_t uuid16 = little_endian_read_16(att_db_util_hash_att_ptr, 6);
@@ -357,12 +423,18 @@ static void att_db_util_hash_fetch_next_attribute(void){
 }
 
 uint16_t att_db_util_hash_len(void){
-    return att_db_hash_len;
+    uint16_t hash_len = att_db_hash_len;
+    btstack_linked_item_t * item;
+    for (item = att_db_util_services; item != NULL; item = item->next){
+        hash_len += ((att_db_util_service_t *) item)->hash_len;
+    }
+    return hash_len;
 }
 
 void att_db_util_hash_init(void){
     // skip version info
     att_db_util_hash_att_ptr = &att_db[1];
+    att_db_util_hash_segment = NULL;
     att_db_util_hash_bytes_available = 0u;
 }
 
@@ -392,5 +464,220 @@ static uint8_t att_db_util_hash_get(uint16_t offset){
 void att_db_util_hash_calc(btstack_crypto_aes128_cmac_t * request, uint8_t * db_hash, void (* callback)(void * arg), void * callback_arg){
     static const uint8_t zero_key[16] = { 0 };
     att_db_util_hash_init();
-    btstack_crypto_aes128_cmac_generator(request, zero_key, att_db_hash_len, &att_db_util_hash_get, db_hash, callback, callback_arg);
+    btstack_crypto_aes128_cmac_generator(request, zero_key, att_db_util_hash_len(), &att_db_util_hash_get, db_hash, callback, callback_arg);
+}
+
+void att_db_util_service_begin(att_db_util_service_t * service, uint16_t start_handle, uint8_t * storage, uint16_t storage_size){
+    btstack_assert(att_db_util_service_active == NULL);
+    memset(service, 0, sizeof(att_db_util_service_t));
+    service->storage = storage;
+    service->storage_size = storage_size;
+    service->start_handle = start_handle;
+    service->segment.attributes = storage;
+
+    // store main ATT DB
+    att_db_util_main_db = att_db;
+    att_db_util_main_size = att_db_size;
+    att_db_util_main_max_size = att_db_max_size;
+    att_db_util_main_next_handle = att_db_next_handle;
+    att_db_util_main_hash_len = att_db_hash_len;
+
+    // add attributes to service storage
+    att_db_util_service_active = service;
+    att_db_util_service_overflow = false;
+    att_db = storage;
+    att_db_size = 0;
+    att_db_max_size = storage_size;
+    att_db_next_handle = start_handle;
+    att_db_hash_len = 0;
+    if (storage_size < 2u){
+        att_db_util_service_overflow = true;
+        att_db_max_size = 0;
+        return;
+    }
+    att_db_util_set_end_tag();
+}
+
+uint8_t att_db_util_service_end(void){
+    att_db_util_service_t * service = att_db_util_service_active;
+    btstack_assert(service != NULL);
+    service->size = att_db_size + 2u;
+    service->end_handle = att_db_next_handle - 1u;
+    service->hash_len = att_db_hash_len;
+
+    // restore main ATT DB
+    att_db = att_db_util_main_db;
+    att_db_size = att_db_util_main_size;
+    att_db_max_size = att_db_util_main_max_size;
+    att_db_next_handle = att_db_util_main_next_handle;
+    att_db_hash_len = att_db_util_main_hash_len;
+    att_db_util_service_active = NULL;
+
+    if (att_db_util_service_overflow){
+        // mark as incomplete
+        service->end_handle = service->start_handle - 1u;
+        return ERROR_CODE_MEMORY_CAPACITY_EXCEEDED;
+    }
+    return ERROR_CODE_SUCCESS;
+}
+
+static void att_db_util_emit_service_changed(att_db_util_service_t * service){
+    log_info("service changed 0x%04x-0x%04x", service->start_handle, service->end_handle);
+    if (att_db_util_service_changed_callback != NULL){
+        (*att_db_util_service_changed_callback)(service->start_handle, service->end_handle);
+    }
+}
+
+uint8_t att_db_util_service_add(att_db_util_service_t * service){
+    if ((service->linked) || (service == att_db_util_service_active) || (service->end_handle < service->start_handle)){
+        return ERROR_CODE_COMMAND_DISALLOWED;
+    }
+    if (service->start_handle < att_db_next_handle){
+        return ERROR_CODE_INVALID_HCI_COMMAND_PARAMETERS;
+    }
+    // find position in handle order, reject overlap
+    btstack_linked_item_t ** prev_next = &att_db_util_services;
+    while (*prev_next != NULL){
+        att_db_util_service_t * other = (att_db_util_service_t *) *prev_next;
+        if (other->start_handle > service->end_handle){
+            break;
+        }
+        if (other->end_handle >= service->start_handle){
+            return ERROR_CODE_INVALID_HCI_COMMAND_PARAMETERS;
+        }
+        prev_next = &(*prev_next)->next;
+    }
+    service->segment.item.next = *prev_next;
+    *prev_next = (btstack_linked_item_t *) service;
+    service->linked = true;
+
+    // hash state of this and all following services is outdated
+    att_db_util_hash_invalidate((btstack_linked_item_t *) service);
+
+    att_set_db_segments(&att_db_util_services);
+    att_db_util_emit_service_changed(service);
+    return ERROR_CODE_SUCCESS;
 }
+
+uint8_t att_db_util_service_remove(att_db_util_service_t * service){
+    if (service->linked == false){
+        return ERROR_CODE_COMMAND_DISALLOWED;
+    }
+    btstack_linked_item_t * next = service->segment.item.next;
+    btstack_linked_list_remove(&att_db_util_services, (btstack_linked_item_t *) service);
+    service->linked = false;
+
+    // hash state of all following services is outdated
+    att_db_util_hash_invalidate(next);
+
+    att_db_util_emit_service_changed(service);
+    return ERROR_CODE_SUCCESS;
+}
+
+void att_db_util_register_service_changed_callback(void (*callback)(uint16_t start_handle, uint16_t end_handle)){
+    att_db_util_service_changed_callback = callback;
+}
+
+#if defined(ENABLE_SOFTWARE_AES128) || defined (HAVE_AES128)
+
+static const uint8_t att_db_util_hash_zero_key[16] = { 0 };
+
+static void att_db_util_hash_state_update(att_db_util_hash_state_t * state, const uint8_t * data, uint16_t len){
+    uint16_t i;
+    for (i=0;i<len;i++){
+        // process full block only when more data follows, last block is handled in finalize
+        if (state->block_len == 16u){
+            uint8_t j;
+            for (j=0;j<16u;j++){
+                state->block[j] ^= state->x[j];
+            }
+            btstack_aes128_calc(att_db_util_hash_zero_key, state->block, state->x);
+            state->block_len = 0;
+        }
+        state->block[state->block_len++] = data[i];
+    }
+}
+
+static void att_db_util_hash_state_update_attributes(att_db_util_hash_state_t * state, const uint8_t * att_ptr){
+    while (true){
+        uint16_t size = little_endian_read_16(att_ptr, 0);
+        if (size == 0u){
+            return;
+        }
+        uint16_t flags = little_endian_read_16(att_ptr, 2);
+        if ((flags & (uint16_t)ATT_PROPERTY_UUID128) == 0u) {
+            uint16_t uuid16 = little_endian_read_16(att_ptr, 6);
+            if (att_db_util_hash_include_with_value(uuid16)){
+                att_db_util_hash_state_update(state, &att_ptr[4], size - 4u);
+            } else if (att_db_util_hash_include_without_value(uuid16)){
+                att_db_util_hash_state_update(state, &att_ptr[4], 4u);
+            }
+        }
+        att_ptr += size;
+    }
+}
+
+static void att_db_util_hash_state_finalize(const att_db_util_hash_state_t * state, uint8_t * db_hash){
+    uint8_t k0[16];
+    uint8_t subkey[16];
+    uint8_t y[16];
+    uint8_t i;
+    btstack_aes128_calc(att_db_util_hash_zero_key, att_db_util_hash_zero_key, k0);
+    // K1 = K0 << 1, K2 = K1 << 1, with conditional xor of Rb
+    uint8_t rounds = (state->block_len == 16u) ? 1u : 2u;
+    (void)memcpy(subkey, k0, 16);
+    while (rounds-- > 0u){
+        uint8_t msb = subkey[0] & 0x80u;
+        for (i=0;i<15u;i++){
+            subkey[i] = (uint8_t)((subkey[i] << 1) | (subkey[i+1u] >> 7));
+        }
+        subkey[15] = (uint8_t)(subkey[15] << 1);
+        if (msb != 0u){
+            subkey[15] ^= 0x87u;
+        }
+    }
+    for (i=0;i<16u;i++){
+        uint8_t m_last = 0;
+        if (i < state->block_len){
+            m_last = state->block[i];
+        } else if (i == state->block_len){
+            m_last = 0x80u;
+        }
+        y[i] = state->x[i] ^ m_last ^ subkey[i];
+    }
+    btstack_aes128_calc(att_db_util_hash_zero_key, y, db_hash);
+}
+
+void att_db_util_hash_calc_incremental(uint8_t * db_hash){
+    att_db_util_hash_state_t state;
+
+    // resume at last service with valid hash state, all services before are unchanged, too
+    btstack_linked_item_t * resume = NULL;
+    btstack_linked_item_t * item;
+    for (item = att_db_util_services; item != NULL; item = item->next){
+        if (((att_db_util_service_t *) item)->hash_state_valid == false){
+            break;
+        }
+        resume = item;
+    }
+
+    if (resume == NULL){
+        memset(&state, 0, sizeof(state));
+        // skip version info
+        att_db_util_hash_state_update_attributes(&state, &att_db[1]);
+        resume = att_db_util_services;
+    } else {
+        state = ((att_db_util_service_t *) resume)->hash_state;
+    }
+
+    // process remaining services and cache hash state before each
+    for (item = resume; item != NULL; item = item->next){
+        att_db_util_service_t * service = (att_db_util_service_t *) item;
+        service->hash_state = state;
+        service->hash_state_valid = true;
+        att_db_util_hash_state_update_attributes(&state, service->segment.attributes);
+    }
+
+    att_db_util_hash_state_finalize(&state, db_hash);
+}
+#endif
@@ -47,6 +47,8 @@
 
 #include "btstack_config.h"
 #include "btstack_crypto.h"
+#include "btstack_bool.h"
+#include "ble/att_db.h"
 
 #include <stdint.h>
 
@@ -54,6 +56,29 @@
 extern "C" {
 #endif
 
+// CMAC state for GATT Database Hash before a service: chaining value and pending block
+typedef struct {
+    uint8_t x[16];
+    uint8_t block[16];
+    uint8_t block_len;
+} att_db_util_hash_state_t;
+
+// GATT service stored in separate buffer and linked into the ATT DB on demand
+typedef struct {
+    // linked into ATT DB, has to be first
+    att_db_segment_t segment;
+    uint8_t * storage;
+    uint16_t  storage_size;
+    uint16_t  size;
+    uint16_t  start_handle;
+    uint16_t  end_handle;
+    uint16_t  hash_len;
+    bool      linked;
+    // cached GATT Database Hash state for all attributes before this service
+    bool      hash_state_valid;
+    att_db_util_hash_state_t hash_state;
+} att_db_util_service_t;
+
 /* API_START */
 
 /**
@@ -184,6 +209,56 @@ uint8_t att_db_util_hash_get_next(void);
  */
 void att_db_util_hash_calc(btstack_crypto_aes128_cmac_t * request, uint8_t * db_hash, void (* callback)(void * arg), void * callback_arg);
 
+/**
+ * @brief Start construction of a separate GATT service in provided storage
+ * @note Following att_db_util_add_* calls add attributes to this service until att_db_util_service_end is called
+ * @param service that is not added to the ATT DB
+ * @param start_handle of first attribute, has to be above all attributes of the main ATT DB
+ * @param storage for attributes, needs to stay valid while the service is added
+ * @param storage_size
+ */
+void att_db_util_service_begin(att_db_util_service_t * service, uint16_t start_handle, uint8_t * storage, uint16_t storage_size);
+
+/**
+ * @brief Complete construction of service started with att_db_util_service_begin
+ * @return ERROR_CODE_SUCCESS or ERROR_CODE_MEMORY_CAPACITY_EXCEEDED if not all attributes did fit into the storage
+ */
+uint8_t att_db_util_service_end(void);
+
+/**
+ * @brief Link service into ATT DB without modifying the main ATT DB or other services
+ * @note Service Changed callback is called with the handle range of this service
+ * @param service
+ * @return ERROR_CODE_SUCCESS, ERROR_CODE_COMMAND_DISALLOWED if already added or not complete,
+ *         or ERROR_CODE_INVALID_HCI_COMMAND_PARAMETERS if handle range overlaps with existing attributes
+ */
+uint8_t att_db_util_service_add(att_db_util_service_t * service);
+
+/**
+ * @brief Unlink service from ATT DB. Its storage can be reused afterwards
+ * @note Service Changed callback is called with the handle range of this service
+ * @param service
+ * @return ERROR_CODE_SUCCESS or ERROR_CODE_COMMAND_DISALLOWED if not added
+ */
+uint8_t att_db_util_service_remove(att_db_util_service_t * service);
+
+/**
+ * @brief Register callback for changes of the ATT DB by adding or removing services
+ * @note The application is expected to indicate the range via the Service Changed Characteristic
+ * @param callback with affected start and end handle
+ */
+void att_db_util_register_service_changed_callback(void (*callback)(uint16_t start_handle, uint16_t end_handle));
+
+#if defined(ENABLE_SOFTWARE_AES128) || defined (HAVE_AES128)
+/**
+ * @brief Calculate GATT Database Hash synchronously
+ * @note Only the services starting with the first one that was added or removed since the last call
+ *       are processed again, earlier attributes are covered by the cached CMAC state
+ * @param db_hash
+ */
+void att_db_util_hash_calc_incremental(uint8_t * db_hash);
+#endif
+
 /* API_END */
 
 #if defined __cplusplus
@@ -155,6 +155,9 @@ static void hids_client_descriptor_storage_init(hids_client_t * client, uint8_t
     client->services[service_index].hid_descriptor_len = 0;
     client->services[service_index].hid_descriptor_max_len = available_space;
     client->services[service_index].hid_descriptor_offset = hids_client_descriptor_storage_len - available_space;
+#ifdef ENABLE_HID_REPORT_LAYOUT
+    client->services[service_index].report_layout_compiled = false;
+#endif
 }
 
 static bool hids_client_descriptor_storage_store(hids_client_t * client, uint8_t service_index, uint8_t byte){
@@ -197,6 +200,9 @@ static void hids_client_descriptor_storage_delete(hids_client_t * client){
     for (service_index = 0; service_index < client->num_instances; service_index++){
         client->services[service_index].hid_descriptor_len = 0;
         client->services[service_index].hid_descriptor_offset = 0;
+#ifdef ENABLE_HID_REPORT_LAYOUT
+        client->services[service_index].report_layout_compiled = false;
+#endif
     }
 }
 
@@ -222,6 +228,39 @@ uint16_t hids_client_descriptor_storage_get_descriptor_len(uint16_t hids_cid, ui
     return client->services[service_index].hid_descriptor_len;
 }
 
+#ifdef ENABLE_HID_REPORT_LAYOUT
+const btstack_hid_layout_t * hids_client_get_report_layout(uint16_t hids_cid, uint8_t service_index){
+    hids_client_t * client = hids_get_client_for_cid(hids_cid);
+    if (client == NULL){
+        return NULL;
+    }
+    if (service_index >= client->num_instances){
+        return NULL;
+    }
+    // descriptor complete after connection established
+    if (client->state < HIDS_CLIENT_STATE_CONNECTED){
+        return NULL;
+    }
+    hid_service_t * service = &client->services[service_index];
+    if ((service->hid_descriptor_status != ERROR_CODE_SUCCESS) || (service->hid_descriptor_len == 0u)){
+        return NULL;
+    }
+    if (service->report_layout_compiled == false){
+        btstack_hid_layout_init(&service->report_layout,
+                                service->report_layout_reports, HID_REPORT_LAYOUT_MAX_REPORTS,
+                                service->report_layout_fields, HID_REPORT_LAYOUT_MAX_FIELDS);
+        (void) btstack_hid_layout_compile(&service->report_layout,
+                                          &hids_client_descriptor_storage[service->hid_descriptor_offset],
+                                          service->hid_descriptor_len, HID_REPORT_TYPE_INPUT);
+        service->report_layout_compiled = true;
+    }
+    if (service->report_layout.num_reports == 0u){
+        return NULL;
+    }
+    return &service->report_layout;
+}
+#endif
+
 // END Descriptor Storage Util
 
 static uint16_t hids_get_next_cid(void){
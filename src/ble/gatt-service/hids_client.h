@@ -46,6 +46,7 @@
 #include <stdint.h>
 #include "btstack_defines.h"
 #include "btstack_hid.h"
+#include "btstack_hid_parser.h"
 #include "bluetooth.h"
 #include "btstack_linked_list.h"
 #include "ble/gatt_client.h"
@@ -173,6 +174,14 @@ typedef struct {
     uint8_t  hid_descriptor_status;     // ERROR_CODE_SUCCESS if descriptor available, 
                                         // ERROR_CODE_UNSUPPORTED_FEATURE_OR_PARAMETER_VALUE if not, and 
                                         // ERROR_CODE_MEMORY_CAPACITY_EXCEEDED if descriptor is larger then the available space
+
+#ifdef ENABLE_HID_REPORT_LAYOUT
+    // input report layout, compiled on first use
+    bool                        report_layout_compiled;
+    btstack_hid_layout_t        report_layout;
+    btstack_hid_layout_report_t report_layout_reports[HID_REPORT_LAYOUT_MAX_REPORTS];
+    btstack_hid_layout_field_t  report_layout_fields[HID_REPORT_LAYOUT_MAX_FIELDS];
+#endif
 } hid_service_t;
 
 typedef struct {
@@ -361,6 +370,16 @@ const uint8_t * hids_client_descriptor_storage_get_descriptor_data(uint16_t hids
  */
 uint16_t hids_client_descriptor_storage_get_descriptor_len(uint16_t hids_cid, uint8_t service_index);
 
+#ifdef ENABLE_HID_REPORT_LAYOUT
+/**
+ * @brief Get HID Report Layout for input reports, compiled from HID Descriptor on first call. Requires ENABLE_HID_REPORT_LAYOUT
+ * @param hids_cid
+ * @param service_index
+ * @result layout or NULL if HID Descriptor not available or too large for HID_REPORT_LAYOUT_MAX_REPORTS / HID_REPORT_LAYOUT_MAX_FIELDS
+ */
+const btstack_hid_layout_t * hids_client_get_report_layout(uint16_t hids_cid, uint8_t service_index);
+#endif
+
 /**
  * @brief De-initialize HID Service Client. 
  *
@@ -52,6 +52,7 @@
 #include "btstack_event.h"
 #include "btstack_memory.h"
 #include "btstack_run_loop.h"
+#include "btstack_tlv.h"
 #include "btstack_util.h"
 #include "hci.h"
 #include "hci_dump.h"
@@ -89,6 +90,13 @@ static void gatt_client_classic_handle_disconnected(gatt_client_t * gatt_client)
 static void gatt_client_classic_retry(btstack_timer_source_t * ts);
 #endif
 
+#ifdef ENABLE_GATT_CLIENT_CACHE
+static void gatt_client_cache_add_record(gatt_client_t * gatt_client, gatt_client_cache_record_type_t type, uint16_t start_handle,
+                                         uint16_t value_handle, uint16_t end_handle, uint16_t properties, const uint8_t * uuid128);
+static void gatt_client_cache_query_complete(gatt_client_t * gatt_client, uint8_t att_status);
+static void gatt_client_emit_events(void * context);
+#endif
+
 #ifdef ENABLE_GATT_OVER_EATT
 static bool gatt_client_le_enhanced_handle_can_send_query(gatt_client_t * gatt_client);
 static void gatt_client_le_enhanced_retry(btstack_timer_source_t * ts);
@@ -223,6 +231,24 @@ static bool is_ready(gatt_client_t * gatt_client){
     return gatt_client->state == P_READY;
 }
 
+#ifdef ENABLE_GATT_OVER_EATT
+// @return idle bearer, prefers eatt clients over unenhanced bearer
+static gatt_client_t * gatt_client_le_enhanced_get_ready_client(gatt_client_t * gatt_client){
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &gatt_client->eatt_clients);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        gatt_client_t * client = (gatt_client_t *) btstack_linked_list_iterator_next(&it);
+        if (client->state == P_READY){
+            return client;
+        }
+    }
+    if (is_ready(gatt_client)){
+        return gatt_client;
+    }
+    return NULL;
+}
+#endif
+
 static uint8_t gatt_client_provide_context_for_request(hci_con_handle_t con_handle, gatt_client_t ** out_gatt_client){
     gatt_client_t * gatt_client = NULL;
     uint8_t status = gatt_client_provide_context_for_handle(con_handle, &gatt_client);
@@ -232,21 +258,11 @@ static uint8_t gatt_client_provide_context_for_request(hci_con_handle_t con_hand
 
 #ifdef ENABLE_GATT_OVER_EATT
     if (gatt_client->eatt_state == GATT_CLIENT_EATT_READY){
-        btstack_linked_list_iterator_t it;
-        gatt_client_t * eatt_client = NULL;
-        // find free eatt client
-        btstack_linked_list_iterator_init(&it, &gatt_client->eatt_clients);
-        while (btstack_linked_list_iterator_has_next(&it)){
-            gatt_client_t * client = (gatt_client_t *) btstack_linked_list_iterator_next(&it);
-            if (client->state == P_READY){
-                eatt_client = client;
-                break;
-            }
-        }
-        if (eatt_client == NULL){
+        gatt_client_t * ready_client = gatt_client_le_enhanced_get_ready_client(gatt_client);
+        if (ready_client == NULL){
             return ERROR_CODE_COMMAND_DISALLOWED;
         }
-        gatt_client = eatt_client;
+        gatt_client = ready_client;
     }
 #endif
 
@@ -256,6 +272,13 @@ static uint8_t gatt_client_provide_context_for_request(hci_con_handle_t con_hand
 
     gatt_client_timeout_start(gatt_client);
 
+    // track attribute handle for queued attribute query
+    gatt_client->query_attribute_handle = gatt_client->pending_query_attribute_handle;
+    gatt_client->pending_query_attribute_handle = 0;
+
+    gatt_client->long_write_source = NULL;
+    gatt_client->long_read = NULL;
+
     *out_gatt_client = gatt_client;
 
     return status;
@@ -492,6 +515,20 @@ static uint8_t att_prepare_write_request(gatt_client_t *gatt_client, uint8_t req
     return gatt_client_send(gatt_client,  5u + blob_length);
 }
 
+// precondition: can_send_packet_now == TRUE
+static uint8_t att_prepare_write_request_from_source(gatt_client_t *gatt_client, uint16_t attribute_handle,
+                                                     uint16_t value_offset, uint16_t blob_length) {
+    uint8_t *request = gatt_client_reserve_request_buffer(gatt_client);
+
+    request[0] = ATT_PREPARE_WRITE_REQUEST;
+    little_endian_store_16(request, 1, attribute_handle);
+    little_endian_store_16(request, 3, value_offset);
+    // fill request directly from source
+    (*gatt_client->long_write_source)(gatt_client->long_write_source_context, value_offset, &request[5], blob_length);
+
+    return gatt_client_send(gatt_client,  5u + blob_length);
+}
+
 static uint8_t att_exchange_mtu_request(gatt_client_t *gatt_client) {
     uint8_t *request = gatt_client_reserve_request_buffer(gatt_client);
 
@@ -605,6 +642,11 @@ static void send_gatt_write_client_characteristic_configuration_request(gatt_cli
 }
 
 static void send_gatt_prepare_write_request(gatt_client_t * gatt_client){
+    if (gatt_client->long_write_source != NULL){
+        att_prepare_write_request_from_source(gatt_client, gatt_client->attribute_handle,
+                                              gatt_client->attribute_offset, write_blob_length(gatt_client));
+        return;
+    }
     att_prepare_write_request(gatt_client, ATT_PREPARE_WRITE_REQUEST, gatt_client->attribute_handle,
                               gatt_client->attribute_offset, write_blob_length(gatt_client),
                               gatt_client->attribute_value);
@@ -659,22 +701,77 @@ static uint16_t get_last_result_handle_from_included_services_list(uint8_t * pac
     return little_endian_read_16(packet, size - attr_length);
 }
 
+static bool gatt_client_attribute_handle_active(gatt_client_t * gatt_client, uint16_t attribute_handle){
+    if ((gatt_client->state != P_READY) && (gatt_client->query_attribute_handle == attribute_handle)){
+        return true;
+    }
+#ifdef ENABLE_GATT_OVER_EATT
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &gatt_client->eatt_clients);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        gatt_client_t * client = (gatt_client_t *) btstack_linked_list_iterator_next(&it);
+        if ((client->state != P_READY) && (client->query_attribute_handle == attribute_handle)){
+            return true;
+        }
+    }
+#endif
+    return false;
+}
+
+// @return bearer for next query, see gatt_client_provide_context_for_request
+static gatt_client_t * gatt_client_get_query_bearer(gatt_client_t * gatt_client){
+#ifdef ENABLE_GATT_OVER_EATT
+    if (gatt_client->eatt_state == GATT_CLIENT_EATT_READY){
+        return gatt_client_le_enhanced_get_ready_client(gatt_client);
+    }
+#endif
+    return gatt_client;
+}
+
+// @return true if callback for query request was called
+static bool gatt_client_dispatch_query_request(gatt_client_t * gatt_client){
+    btstack_context_callback_registration_t * callback = (btstack_context_callback_registration_t *) btstack_linked_list_pop(&gatt_client->query_requests);
+    if (callback != NULL) {
+        (*callback->callback)(callback->context);
+        return true;
+    }
+
+    // first attribute query request for attribute handle without active query, keeps order for same attribute handle
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &gatt_client->attribute_query_requests);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        gatt_client_attribute_query_request_t * request = (gatt_client_attribute_query_request_t *) btstack_linked_list_iterator_next(&it);
+        if (gatt_client_attribute_handle_active(gatt_client, request->attribute_handle)){
+            continue;
+        }
+        btstack_linked_list_iterator_remove(&it);
+        gatt_client_t * bearer = gatt_client_get_query_bearer(gatt_client);
+        btstack_assert(bearer != NULL);
+        // used by first query started on the bearer from the callback
+        bearer->pending_query_attribute_handle = request->attribute_handle;
+        (*request->callback_registration.callback)(request->callback_registration.context);
+        bearer->pending_query_attribute_handle = 0;
+        return true;
+    }
+    return false;
+}
+
 static void gatt_client_notify_can_send_query(gatt_client_t * gatt_client){
 
 #ifdef ENABLE_GATT_OVER_EATT
-    // if eatt is ready, notify all clients that can send a query
+    // query requests are queued on the unenhanced bearer
+    if (gatt_client->bearer_type == ATT_BEARER_ENHANCED_LE){
+        gatt_client = gatt_client_get_context_for_handle(gatt_client->con_handle);
+        if (gatt_client == NULL){
+            return;
+        }
+    }
+
+    // if eatt is ready, dispatch query requests to all idle bearers
     if (gatt_client->eatt_state == GATT_CLIENT_EATT_READY){
-        btstack_linked_list_iterator_t it;
-        btstack_linked_list_iterator_init(&it, &gatt_client->eatt_clients);
-        while (btstack_linked_list_iterator_has_next(&it)){
-            gatt_client_t * client = (gatt_client_t *) btstack_linked_list_iterator_next(&it);
-            if (client->state == P_READY){
-                // call callback
-                btstack_context_callback_registration_t * callback = (btstack_context_callback_registration_t *) btstack_linked_list_pop(&gatt_client->query_requests);
-                if (callback == NULL) {
-                    return;
-                }
-                (*callback->callback)(callback->context);
+        while (gatt_client_le_enhanced_get_ready_client(gatt_client) != NULL){
+            if (gatt_client_dispatch_query_request(gatt_client) == false){
+                return;
             }
         }
         return;
@@ -688,11 +785,9 @@ static void gatt_client_notify_can_send_query(gatt_client_t * gatt_client){
             continue;
         }
 #endif
-        btstack_context_callback_registration_t * callback = (btstack_context_callback_registration_t *) btstack_linked_list_pop(&gatt_client->query_requests);
-        if (callback == NULL) {
+        if (gatt_client_dispatch_query_request(gatt_client) == false){
             return;
         }
-        (*callback->callback)(callback->context);
     }
 }
 
@@ -742,6 +837,9 @@ static void emit_gatt_service_query_result_event(gatt_client_t * gatt_client, ui
     little_endian_store_16(packet, 4, start_group_handle);
     little_endian_store_16(packet, 6, end_group_handle);
     reverse_128(uuid128, &packet[8]);
+#ifdef ENABLE_GATT_CLIENT_CACHE
+    gatt_client_cache_add_record(gatt_client, GATT_CLIENT_CACHE_RECORD_SERVICE, start_group_handle, 0, end_group_handle, 0, uuid128);
+#endif
     emit_event_new(gatt_client->callback, packet, sizeof(packet));
 }
 
@@ -773,6 +871,9 @@ static void emit_gatt_characteristic_query_result_event(gatt_client_t * gatt_cli
     little_endian_store_16(packet, 8,  end_handle);
     little_endian_store_16(packet, 10, properties);
     reverse_128(uuid128, &packet[12]);
+#ifdef ENABLE_GATT_CLIENT_CACHE
+    gatt_client_cache_add_record(gatt_client, GATT_CLIENT_CACHE_RECORD_CHARACTERISTIC, start_handle, value_handle, end_handle, properties, uuid128);
+#endif
     emit_event_new(gatt_client->callback, packet, sizeof(packet));
 }
 
@@ -786,6 +887,9 @@ static void emit_gatt_all_characteristic_descriptors_result_event(
     ///
     little_endian_store_16(packet, 4,  descriptor_handle);
     reverse_128(uuid128, &packet[6]);
+#ifdef ENABLE_GATT_CLIENT_CACHE
+    gatt_client_cache_add_record(gatt_client, GATT_CLIENT_CACHE_RECORD_DESCRIPTOR, descriptor_handle, 0, descriptor_handle, 0, uuid128);
+#endif
     emit_event_new(gatt_client->callback, packet, sizeof(packet));
 }
 
@@ -800,8 +904,92 @@ static void emit_gatt_mtu_exchanged_result_event(gatt_client_t * gatt_client, ui
     emit_event_new(gatt_client->callback, packet, sizeof(packet));
 }
 
+static bool gatt_client_long_read_start_next(gatt_client_long_read_t * long_read, gatt_client_t * gatt_client){
+    // stop on error or if end of value is known
+    if (long_read->att_status != ATT_ERROR_SUCCESS) return false;
+    if (long_read->value_length != GATT_CLIENT_LONG_READ_VALUE_LENGTH_UNKNOWN) return false;
+    // request at buffer_size detects truncation
+    if (long_read->next_offset > long_read->buffer_size) return false;
+
+    uint16_t blob_length = gatt_client->mtu - 1u;
+    gatt_client->callback = long_read->callback;
+    gatt_client->long_read = long_read;
+    gatt_client->attribute_handle = long_read->attribute_handle;
+    gatt_client->attribute_offset = long_read->next_offset;
+    gatt_client->attribute_length = blob_length;
+    gatt_client->state = P_W2_SEND_READ_BLOB_QUERY;
+    long_read->next_offset += blob_length;
+    long_read->num_active++;
+    return true;
+}
+
+static void gatt_client_long_read_handle_blob(gatt_client_t * gatt_client, const uint8_t * blob, uint16_t blob_length){
+    gatt_client_long_read_t * long_read = gatt_client->long_read;
+    uint16_t offset = gatt_client->attribute_offset;
+
+    // store blob directly in application buffer
+    if (offset < long_read->buffer_size){
+        uint16_t bytes_to_copy = btstack_min(blob_length, long_read->buffer_size - offset);
+        (void)memcpy(&long_read->buffer[offset], blob, bytes_to_copy);
+    }
+    if ((offset + blob_length) > long_read->buffer_size){
+        long_read->truncated = true;
+    }
+
+    // short blob marks end of value
+    if (blob_length < gatt_client->attribute_length){
+        long_read->value_length = btstack_min(long_read->value_length, offset + blob_length);
+    }
+}
+
+static void gatt_client_long_read_handle_complete(gatt_client_t * gatt_client, uint8_t att_status){
+    gatt_client_long_read_t * long_read = gatt_client->long_read;
+    uint16_t offset = gatt_client->attribute_offset;
+
+    gatt_client->long_read = NULL;
+    btstack_assert(long_read->num_active > 0u);
+    long_read->num_active--;
+
+    if (att_status != ATT_ERROR_SUCCESS){
+        bool beyond_end = (offset > 0u) &&
+                ((att_status == ATT_ERROR_INVALID_OFFSET) || (att_status == ATT_ERROR_ATTRIBUTE_NOT_LONG));
+        if (beyond_end){
+            // parallel request for offset after end of value
+            long_read->value_length = btstack_min(long_read->value_length, offset);
+        } else if (long_read->att_status == ATT_ERROR_SUCCESS){
+            long_read->att_status = att_status;
+        }
+    }
+
+    // continue with next offset on this bearer
+    if (gatt_client_long_read_start_next(long_read, gatt_client)){
+        return;
+    }
+
+    gatt_client->state = P_READY;
+    gatt_client_timeout_stop(gatt_client);
+
+    // last active bearer reports result
+    if (long_read->num_active == 0u){
+        uint8_t status = long_read->att_status;
+        if ((status == ATT_ERROR_SUCCESS) && long_read->truncated){
+            status = GATT_CLIENT_VALUE_TOO_LONG;
+        }
+        gatt_client->callback = long_read->callback;
+        emit_gatt_complete_event(gatt_client, status);
+    }
+    gatt_client_notify_can_send_query(gatt_client);
+}
+
 // helper
 static void gatt_client_handle_transaction_complete(gatt_client_t *gatt_client, uint8_t att_status) {
+    if (gatt_client->long_read != NULL){
+        gatt_client_long_read_handle_complete(gatt_client, att_status);
+        return;
+    }
+#ifdef ENABLE_GATT_CLIENT_CACHE
+    gatt_client_cache_query_complete(gatt_client, att_status);
+#endif
     gatt_client->state = P_READY;
     gatt_client_timeout_stop(gatt_client);
     emit_gatt_complete_event(gatt_client, att_status);
@@ -1102,6 +1290,492 @@ static void gatt_client_run_for_client_start_signed_write(gatt_client_t *gatt_cl
 }
 #endif
 
+#ifdef ENABLE_GATT_CLIENT_CACHE
+
+#define GATT_CLIENT_CACHE_RECORD_INDEX_NONE 0xffffu
+
+typedef enum {
+    GATT_CLIENT_CACHE_QUERY_SEND,
+    GATT_CLIENT_CACHE_QUERY_SENT,
+    GATT_CLIENT_CACHE_QUERY_WAIT,
+} gatt_client_cache_query_action_t;
+
+static uint32_t gatt_client_cache_tag_for_index(uint8_t index){
+    return ('G' << 24u) | ('C' << 16u) | ('C' << 8u) | index;
+}
+
+static uint16_t gatt_client_cache_data_size(uint16_t num_records){
+    return (uint16_t) (offsetof(gatt_client_cache_t, records) + (num_records * sizeof(gatt_client_cache_record_t)));
+}
+
+static void gatt_client_cache_reset(gatt_client_cache_context_t * cache){
+    memset(cache->data, 0, sizeof(gatt_client_cache_t));
+    cache->records_valid = true;
+    cache->database_hash_valid = false;
+    cache->query_recording = false;
+    cache->dirty = false;
+}
+
+static void gatt_client_cache_free(gatt_client_t * gatt_client){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    if (cache->data == NULL) return;
+    btstack_memory_gatt_client_cache_free(cache->data);
+    cache->data = NULL;
+    cache->query_recording = false;
+}
+
+static bool gatt_client_cache_load(gatt_client_t * gatt_client, int le_device_index){
+    // get btstack_tlv
+    const btstack_tlv_t * tlv_impl = NULL;
+    void * tlv_context;
+    btstack_tlv_get_instance(&tlv_impl, &tlv_context);
+    if (tlv_impl == NULL) return false;
+
+    gatt_client_cache_t * data = gatt_client->cache.data;
+    uint32_t tag = gatt_client_cache_tag_for_index((uint8_t) le_device_index);
+    int len = tlv_impl->get_tag(tlv_context, tag, (uint8_t *) data, sizeof(gatt_client_cache_t));
+    if (len < (int) gatt_client_cache_data_size(0)) return false;
+    if (data->num_records > GATT_CLIENT_CACHE_MAX_RECORDS) return false;
+    return len == (int) gatt_client_cache_data_size(data->num_records);
+}
+
+static void gatt_client_cache_store(gatt_client_t * gatt_client){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    if (cache->data == NULL) return;
+    if (cache->dirty == false) return;
+    // stored cache can only be validated with Database Hash
+    if (cache->database_hash_valid == false) return;
+    cache->dirty = false;
+    int le_device_index = sm_le_device_index(gatt_client->con_handle);
+    // check if bonded
+    if (le_device_index < 0) return;
+    // get btstack_tlv
+    const btstack_tlv_t * tlv_impl = NULL;
+    void * tlv_context;
+    btstack_tlv_get_instance(&tlv_impl, &tlv_context);
+    if (tlv_impl == NULL) return;
+
+    uint32_t tag = gatt_client_cache_tag_for_index((uint8_t) le_device_index);
+    log_info("Store GATT Client cache with %u records for le device id %d", cache->data->num_records, le_device_index);
+    int result = tlv_impl->store_tag(tlv_context, tag, (const uint8_t *) cache->data, gatt_client_cache_data_size(cache->data->num_records));
+    if (result != 0){
+        log_error("Store GATT Client cache failed");
+    }
+}
+
+static void gatt_client_cache_invalidate(gatt_client_t * gatt_client){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    if (cache->data == NULL) return;
+    log_info("Invalidate GATT Client cache, handle 0x%04x", gatt_client->con_handle);
+    // Service Changed indications stay enabled
+    uint8_t  service_changed_configured   = cache->data->service_changed_configured;
+    uint16_t service_changed_value_handle = cache->data->service_changed_value_handle;
+    gatt_client_cache_reset(cache);
+    cache->data->service_changed_configured   = service_changed_configured;
+    cache->data->service_changed_value_handle = service_changed_value_handle;
+
+    int le_device_index = sm_le_device_index(gatt_client->con_handle);
+    if (le_device_index < 0) return;
+    const btstack_tlv_t * tlv_impl = NULL;
+    void * tlv_context;
+    btstack_tlv_get_instance(&tlv_impl, &tlv_context);
+    if (tlv_impl == NULL) return;
+    tlv_impl->delete_tag(tlv_context, gatt_client_cache_tag_for_index((uint8_t) le_device_index));
+}
+
+// enable Service Changed indications once per bonded device
+static void gatt_client_cache_configure_service_changed(gatt_client_cache_context_t * cache){
+    if (cache->data->service_changed_configured != 0u){
+        cache->state = GATT_CLIENT_CACHE_ACTIVE;
+    } else {
+        cache->state = GATT_CLIENT_CACHE_W2_READ_SERVICE_CHANGED;
+    }
+}
+
+// allocate cache for bonded device and load stored cache
+static void gatt_client_cache_setup(gatt_client_t * gatt_client){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    int le_device_index = sm_le_device_index(gatt_client->con_handle);
+    // only bonded devices are cached, check again on next discovery
+    if (le_device_index < 0) return;
+    cache->data = btstack_memory_gatt_client_cache_get();
+    if (cache->data == NULL){
+        log_info("No memory for GATT Client cache");
+        cache->state = GATT_CLIENT_CACHE_UNSUPPORTED;
+        return;
+    }
+    if (gatt_client_cache_load(gatt_client, le_device_index)){
+        log_info("GATT Client cache with %u records loaded, validate", cache->data->num_records);
+        cache->records_valid = false;
+        cache->database_hash_valid = false;
+        cache->state = GATT_CLIENT_CACHE_W2_READ_DATABASE_HASH;
+        return;
+    }
+    // nothing to validate, Database Hash is read when results are recorded
+    gatt_client_cache_reset(cache);
+    gatt_client_cache_configure_service_changed(cache);
+}
+
+static void gatt_client_cache_handle_database_hash(gatt_client_t * gatt_client, const uint8_t * packet, uint16_t size){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+
+    // Read By Type Response with single 16 byte value
+    if ((packet[0] != ATT_READ_BY_TYPE_RESPONSE) || (size < 20u) || (packet[1] != 18u)){
+        log_info("Database Hash not available, GATT Client cache disabled");
+        cache->state = GATT_CLIENT_CACHE_UNSUPPORTED;
+        gatt_client_cache_free(gatt_client);
+        return;
+    }
+    const uint8_t * database_hash = &packet[4];
+
+    if (cache->records_valid == false){
+        if (memcmp(cache->data->database_hash, database_hash, 16) == 0){
+            log_info("GATT Client cache valid, %u records", cache->data->num_records);
+            cache->records_valid = true;
+        } else {
+            log_info("GATT Client cache outdated");
+            gatt_client_cache_reset(cache);
+        }
+    }
+    (void)memcpy(cache->data->database_hash, database_hash, 16);
+    cache->database_hash_valid = true;
+    gatt_client_cache_configure_service_changed(cache);
+}
+
+static void gatt_client_cache_handle_service_changed(gatt_client_t * gatt_client, const uint8_t * packet, uint16_t size){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    cache->state = GATT_CLIENT_CACHE_ACTIVE;
+
+    uint16_t value_handle = 0;
+    if ((packet[0] == ATT_READ_BY_TYPE_RESPONSE) && (size >= 4u) && (packet[1] >= 2u)){
+        value_handle = little_endian_read_16(packet, 2);
+    }
+    if ((packet[0] == ATT_ERROR_RESPONSE) && (size >= 5u)){
+        switch (packet[4]){
+            case ATT_ERROR_READ_NOT_PERMITTED:
+                // Service Changed value is usually not readable, Attribute Handle In Error is its value handle
+                value_handle = little_endian_read_16(packet, 2);
+                break;
+            case ATT_ERROR_ATTRIBUTE_NOT_FOUND:
+                // GATT Server without Service Changed does not change its database while bonded
+                log_info("Service Changed not available");
+                cache->data->service_changed_configured = 1;
+                cache->dirty = true;
+                return;
+            default:
+                break;
+        }
+    }
+    if (value_handle != 0u){
+        cache->data->service_changed_value_handle = value_handle;
+        cache->state = GATT_CLIENT_CACHE_W2_READ_SERVICE_CHANGED_CCCD;
+        return;
+    }
+
+    log_info("Service Changed discovery failed, retry on next connection");
+}
+
+static void gatt_client_cache_handle_service_changed_cccd(gatt_client_t * gatt_client, const uint8_t * packet, uint16_t size){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    cache->state = GATT_CLIENT_CACHE_ACTIVE;
+
+    // Read By Type Response, first Client Characteristic Configuration after the Service Changed value
+    if ((packet[0] == ATT_READ_BY_TYPE_RESPONSE) && (size >= 4u) && (packet[1] >= 2u)){
+        cache->service_changed_cccd_handle = little_endian_read_16(packet, 2);
+        cache->state = GATT_CLIENT_CACHE_W2_WRITE_SERVICE_CHANGED_CCCD;
+        return;
+    }
+
+    log_info("Service Changed CCCD not found, retry on next connection");
+}
+
+static void gatt_client_cache_handle_service_changed_cccd_written(gatt_client_t * gatt_client, const uint8_t * packet){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    cache->state = GATT_CLIENT_CACHE_ACTIVE;
+
+    if (packet[0] != ATT_WRITE_RESPONSE){
+        log_info("Enable Service Changed indications failed, retry on next connection");
+        return;
+    }
+
+    log_info("Service Changed indications enabled, value handle 0x%04x", cache->data->service_changed_value_handle);
+    cache->data->service_changed_configured = 1;
+    cache->dirty = true;
+}
+
+static int gatt_client_cache_find_record(const gatt_client_cache_context_t * cache, uint8_t type, uint16_t start_handle, uint16_t end_handle){
+    uint16_t i;
+    for (i = 0; i < cache->data->num_records; i++){
+        const gatt_client_cache_record_t * record = &cache->data->records[i];
+        if (record->type != type) continue;
+        if (record->end_handle != end_handle) continue;
+        switch (type){
+            case GATT_CLIENT_CACHE_RECORD_SERVICE:
+                if (record->start_handle == start_handle) return i;
+                break;
+            case GATT_CLIENT_CACHE_RECORD_CHARACTERISTIC:
+                // descriptors are discovered after the characteristic value
+                if ((record->value_handle + 1u) == start_handle) return i;
+                break;
+            default:
+                break;
+        }
+    }
+    return -1;
+}
+
+static void gatt_client_cache_add_record(gatt_client_t * gatt_client, gatt_client_cache_record_type_t type, uint16_t start_handle,
+                                         uint16_t value_handle, uint16_t end_handle, uint16_t properties, const uint8_t * uuid128){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    if (cache->query_recording == false) return;
+    if (cache->data->num_records >= GATT_CLIENT_CACHE_MAX_RECORDS){
+        log_info("GATT Client cache full, stop recording");
+        cache->query_recording = false;
+        cache->data->num_records = cache->query_num_records;
+        return;
+    }
+    gatt_client_cache_record_t * record = &cache->data->records[cache->data->num_records++];
+    record->type = (uint8_t) type;
+    record->complete = 0;
+    record->start_handle = start_handle;
+    record->value_handle = value_handle;
+    record->end_handle = end_handle;
+    record->properties = properties;
+    (void)memcpy(record->uuid128, uuid128, 16);
+}
+
+static bool gatt_client_cache_is_discovery_query(gatt_client_t * gatt_client){
+    if (gatt_client->bearer_type != ATT_BEARER_UNENHANCED_LE) return false;
+    switch (gatt_client->state){
+        case P_W2_SEND_SERVICE_QUERY:
+            return gatt_client->uuid16 == GATT_PRIMARY_SERVICE_UUID;
+        case P_W2_SEND_SERVICE_WITH_UUID_QUERY:
+        case P_W2_SEND_ALL_CHARACTERISTICS_OF_SERVICE_QUERY:
+        case P_W2_SEND_CHARACTERISTIC_WITH_UUID_QUERY:
+        case P_W2_SEND_ALL_CHARACTERISTIC_DESCRIPTORS_QUERY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// @return true if query can be answered from cache
+static bool gatt_client_cache_lookup(gatt_client_t * gatt_client){
+    const gatt_client_cache_context_t * cache = &gatt_client->cache;
+    int index;
+    switch (gatt_client->state){
+        case P_W2_SEND_SERVICE_QUERY:
+        case P_W2_SEND_SERVICE_WITH_UUID_QUERY:
+            return cache->data->services_complete != 0u;
+        case P_W2_SEND_ALL_CHARACTERISTICS_OF_SERVICE_QUERY:
+        case P_W2_SEND_CHARACTERISTIC_WITH_UUID_QUERY:
+            index = gatt_client_cache_find_record(cache, GATT_CLIENT_CACHE_RECORD_SERVICE, gatt_client->start_group_handle, gatt_client->end_group_handle);
+            return (index >= 0) && (cache->data->records[index].complete != 0u);
+        case P_W2_SEND_ALL_CHARACTERISTIC_DESCRIPTORS_QUERY:
+            index = gatt_client_cache_find_record(cache, GATT_CLIENT_CACHE_RECORD_CHARACTERISTIC, gatt_client->start_group_handle, gatt_client->end_group_handle);
+            return (index >= 0) && (cache->data->records[index].complete != 0u);
+        default:
+            return false;
+    }
+}
+
+// record results of complete primary service, characteristic, and descriptor discovery
+static void gatt_client_cache_query_start(gatt_client_t * gatt_client){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    int index = -1;
+    cache->query_active = true;
+    cache->query_recording = false;
+    cache->query_num_records = cache->data->num_records;
+    cache->query_record_index = GATT_CLIENT_CACHE_RECORD_INDEX_NONE;
+    switch (gatt_client->state){
+        case P_W2_SEND_SERVICE_QUERY:
+            cache->data->num_records = 0;
+            cache->query_num_records = 0;
+            cache->query_recording = true;
+            return;
+        case P_W2_SEND_ALL_CHARACTERISTICS_OF_SERVICE_QUERY:
+            if (cache->data->services_complete == 0u) return;
+            index = gatt_client_cache_find_record(cache, GATT_CLIENT_CACHE_RECORD_SERVICE, gatt_client->start_group_handle, gatt_client->end_group_handle);
+            break;
+        case P_W2_SEND_ALL_CHARACTERISTIC_DESCRIPTORS_QUERY:
+            index = gatt_client_cache_find_record(cache, GATT_CLIENT_CACHE_RECORD_CHARACTERISTIC, gatt_client->start_group_handle, gatt_client->end_group_handle);
+            break;
+        default:
+            return;
+    }
+    if (index < 0) return;
+    cache->query_recording = true;
+    cache->query_record_index = (uint16_t) index;
+}
+
+static void gatt_client_cache_query_complete(gatt_client_t * gatt_client, uint8_t att_status){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    cache->query_active = false;
+    if (cache->query_recording == false) return;
+    cache->query_recording = false;
+    if (att_status != ATT_ERROR_SUCCESS){
+        cache->data->num_records = cache->query_num_records;
+        return;
+    }
+    if (cache->query_record_index == GATT_CLIENT_CACHE_RECORD_INDEX_NONE){
+        cache->data->services_complete = 1;
+    } else {
+        cache->data->records[cache->query_record_index].complete = 1;
+    }
+    cache->dirty = true;
+    // results are stored with Database Hash
+    if (cache->database_hash_valid == false){
+        cache->state = GATT_CLIENT_CACHE_W2_READ_DATABASE_HASH;
+    }
+}
+
+static void gatt_client_cache_report_query(gatt_client_t * gatt_client){
+    const gatt_client_cache_context_t * cache = &gatt_client->cache;
+    uint16_t i;
+    for (i = 0; i < cache->data->num_records; i++){
+        const gatt_client_cache_record_t * record = &cache->data->records[i];
+        switch (gatt_client->state){
+            case P_W2_SEND_SERVICE_QUERY:
+                if (record->type != GATT_CLIENT_CACHE_RECORD_SERVICE) break;
+                emit_gatt_service_query_result_event(gatt_client, record->start_handle, record->end_handle, record->uuid128);
+                break;
+            case P_W2_SEND_SERVICE_WITH_UUID_QUERY:
+                if (record->type != GATT_CLIENT_CACHE_RECORD_SERVICE) break;
+                if (memcmp(record->uuid128, gatt_client->uuid128, 16) != 0) break;
+                emit_gatt_service_query_result_event(gatt_client, record->start_handle, record->end_handle, record->uuid128);
+                break;
+            case P_W2_SEND_ALL_CHARACTERISTICS_OF_SERVICE_QUERY:
+            case P_W2_SEND_CHARACTERISTIC_WITH_UUID_QUERY:
+                if (record->type != GATT_CLIENT_CACHE_RECORD_CHARACTERISTIC) break;
+                if ((record->start_handle < gatt_client->start_group_handle) || (record->end_handle > gatt_client->end_group_handle)) break;
+                if (gatt_client->filter_with_uuid && (memcmp(record->uuid128, gatt_client->uuid128, 16) != 0)) break;
+                emit_gatt_characteristic_query_result_event(gatt_client, record->start_handle, record->value_handle,
+                                                            record->end_handle, record->properties, record->uuid128);
+                break;
+            case P_W2_SEND_ALL_CHARACTERISTIC_DESCRIPTORS_QUERY:
+                if (record->type != GATT_CLIENT_CACHE_RECORD_DESCRIPTOR) break;
+                if ((record->start_handle < gatt_client->start_group_handle) || (record->start_handle > gatt_client->end_group_handle)) break;
+                emit_gatt_all_characteristic_descriptors_result_event(gatt_client, record->start_handle, record->uuid128);
+                break;
+            default:
+                btstack_unreachable();
+                break;
+        }
+    }
+}
+
+static gatt_client_t * gatt_client_cache_get_client_with_pending_report(void){
+    btstack_linked_item_t *it;
+    for (it = (btstack_linked_item_t *) gatt_client_connections; it != NULL; it = it->next) {
+        gatt_client_t *gatt_client = (gatt_client_t *) it;
+        if (gatt_client->cache.report_pending){
+            return gatt_client;
+        }
+    }
+    return NULL;
+}
+
+static gatt_client_cache_query_action_t gatt_client_cache_prepare_query(gatt_client_t * gatt_client){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    uint8_t value[2];
+
+    if ((cache->state == GATT_CLIENT_CACHE_IDLE) && gatt_client_cache_is_discovery_query(gatt_client)){
+        gatt_client_cache_setup(gatt_client);
+    }
+
+    // own requests have priority, queries wait for their response
+    switch (cache->state){
+        case GATT_CLIENT_CACHE_W2_READ_DATABASE_HASH:
+            cache->state = GATT_CLIENT_CACHE_W4_DATABASE_HASH;
+            att_read_by_type_or_group_request_for_uuid16(gatt_client, ATT_READ_BY_TYPE_REQUEST,
+                                                         ORG_BLUETOOTH_CHARACTERISTIC_DATABASE_HASH, 0x0001, 0xffff);
+            return GATT_CLIENT_CACHE_QUERY_SENT;
+        case GATT_CLIENT_CACHE_W2_READ_SERVICE_CHANGED:
+            cache->state = GATT_CLIENT_CACHE_W4_SERVICE_CHANGED;
+            att_read_by_type_or_group_request_for_uuid16(gatt_client, ATT_READ_BY_TYPE_REQUEST,
+                                                         ORG_BLUETOOTH_CHARACTERISTIC_GATT_SERVICE_CHANGED, 0x0001, 0xffff);
+            return GATT_CLIENT_CACHE_QUERY_SENT;
+        case GATT_CLIENT_CACHE_W2_READ_SERVICE_CHANGED_CCCD:
+            cache->state = GATT_CLIENT_CACHE_W4_SERVICE_CHANGED_CCCD;
+            att_read_by_type_or_group_request_for_uuid16(gatt_client, ATT_READ_BY_TYPE_REQUEST,
+                                                         ORG_BLUETOOTH_DESCRIPTOR_GATT_CLIENT_CHARACTERISTIC_CONFIGURATION,
+                                                         cache->data->service_changed_value_handle + 1u, 0xffff);
+            return GATT_CLIENT_CACHE_QUERY_SENT;
+        case GATT_CLIENT_CACHE_W2_WRITE_SERVICE_CHANGED_CCCD:
+            cache->state = GATT_CLIENT_CACHE_W4_SERVICE_CHANGED_CCCD_WRITTEN;
+            little_endian_store_16(value, 0, GATT_CLIENT_CHARACTERISTICS_CONFIGURATION_INDICATION);
+            att_write_request(gatt_client, ATT_WRITE_REQUEST, cache->service_changed_cccd_handle, sizeof(value), value);
+            return GATT_CLIENT_CACHE_QUERY_SENT;
+        case GATT_CLIENT_CACHE_W4_DATABASE_HASH:
+        case GATT_CLIENT_CACHE_W4_SERVICE_CHANGED:
+        case GATT_CLIENT_CACHE_W4_SERVICE_CHANGED_CCCD:
+        case GATT_CLIENT_CACHE_W4_SERVICE_CHANGED_CCCD_WRITTEN:
+            return GATT_CLIENT_CACHE_QUERY_WAIT;
+        case GATT_CLIENT_CACHE_ACTIVE:
+            break;
+        default:
+            return GATT_CLIENT_CACHE_QUERY_SEND;
+    }
+
+    if (gatt_client_cache_is_discovery_query(gatt_client) == false) return GATT_CLIENT_CACHE_QUERY_SEND;
+    if (cache->report_pending) return GATT_CLIENT_CACHE_QUERY_WAIT;
+    // next request of ongoing query
+    if (cache->query_active) return GATT_CLIENT_CACHE_QUERY_SEND;
+    if (gatt_client_cache_lookup(gatt_client)){
+        // report on next run loop iteration to avoid emitting events from API call
+        cache->report_pending = true;
+        gatt_client_deferred_event_emit.callback = gatt_client_emit_events;
+        btstack_run_loop_execute_on_main_thread(&gatt_client_deferred_event_emit);
+        return GATT_CLIENT_CACHE_QUERY_WAIT;
+    }
+    gatt_client_cache_query_start(gatt_client);
+    return GATT_CLIENT_CACHE_QUERY_SEND;
+}
+
+static bool gatt_client_cache_handle_att_response(gatt_client_t * gatt_client, const uint8_t * packet, uint16_t size){
+    gatt_client_cache_context_t * cache = &gatt_client->cache;
+    if (cache->data == NULL) return false;
+
+    switch (packet[0]){
+        case ATT_HANDLE_VALUE_NOTIFICATION:
+        case ATT_MULTIPLE_HANDLE_VALUE_NTF:
+            return false;
+        case ATT_HANDLE_VALUE_INDICATION:
+            if (size < 3u) return false;
+            if (cache->data->service_changed_value_handle == 0u) return false;
+            if (little_endian_read_16(packet, 1) != cache->data->service_changed_value_handle) return false;
+            log_info("Service Changed indication");
+            gatt_client_cache_invalidate(gatt_client);
+            return false;
+        case ATT_ERROR_RESPONSE:
+            if ((size >= 5u) && (packet[4] == ATT_ERROR_DATABASE_OUT_OF_SYNC)){
+                gatt_client_cache_invalidate(gatt_client);
+            }
+            break;
+        default:
+            break;
+    }
+
+    // response to own request
+    switch (cache->state){
+        case GATT_CLIENT_CACHE_W4_DATABASE_HASH:
+            gatt_client_cache_handle_database_hash(gatt_client, packet, size);
+            return true;
+        case GATT_CLIENT_CACHE_W4_SERVICE_CHANGED:
+            gatt_client_cache_handle_service_changed(gatt_client, packet, size);
+            return true;
+        case GATT_CLIENT_CACHE_W4_SERVICE_CHANGED_CCCD:
+            gatt_client_cache_handle_service_changed_cccd(gatt_client, packet, size);
+            return true;
+        case GATT_CLIENT_CACHE_W4_SERVICE_CHANGED_CCCD_WRITTEN:
+            gatt_client_cache_handle_service_changed_cccd_written(gatt_client, packet);
+            return true;
+        default:
+            return false;
+    }
+}
+#endif
+
 // returns true if packet was sent
 static bool gatt_client_run_for_gatt_client(gatt_client_t * gatt_client){
 
@@ -1161,6 +1835,18 @@ static bool gatt_client_run_for_gatt_client(gatt_client_t * gatt_client){
         return true;
     }
 
+#ifdef ENABLE_GATT_CLIENT_CACHE
+    // validate cache, enable Service Changed indications, or report cached results instead of sending discovery request
+    switch (gatt_client_cache_prepare_query(gatt_client)){
+        case GATT_CLIENT_CACHE_QUERY_SENT:
+            return true;
+        case GATT_CLIENT_CACHE_QUERY_WAIT:
+            return false;
+        default:
+            break;
+    }
+#endif
+
     // check MTU for writes
     switch (gatt_client->state){
         case P_W2_SEND_WRITE_CHARACTERISTIC_VALUE:
@@ -1466,6 +2152,16 @@ static void gatt_client_emit_events(void * context){
             emit_gatt_complete_event(gatt_client, ATT_ERROR_SUCCESS);
         }
     }
+#ifdef ENABLE_GATT_CLIENT_CACHE
+    // report cached query results, lookup again as callbacks may start new queries
+    gatt_client_t * gatt_client = gatt_client_cache_get_client_with_pending_report();
+    while (gatt_client != NULL){
+        gatt_client->cache.report_pending = false;
+        gatt_client_cache_report_query(gatt_client);
+        gatt_client_handle_transaction_complete(gatt_client, ATT_ERROR_SUCCESS);
+        gatt_client = gatt_client_cache_get_client_with_pending_report();
+    }
+#endif
 }
 
 static void gatt_client_report_error_if_pending(gatt_client_t *gatt_client, uint8_t att_error_code) {
@@ -1528,6 +2224,10 @@ static void gatt_client_handle_disconnection_complete(const uint8_t * packet){
 
     gatt_client_report_error_if_pending(gatt_client, ATT_ERROR_HCI_DISCONNECT_RECEIVED);
     gatt_client_timeout_stop(gatt_client);
+#ifdef ENABLE_GATT_CLIENT_CACHE
+    gatt_client_cache_store(gatt_client);
+    gatt_client_cache_free(gatt_client);
+#endif
     btstack_linked_list_remove(&gatt_client_connections, (btstack_linked_item_t *) gatt_client);
     btstack_memory_gatt_client_free(gatt_client);
 }
@@ -1618,6 +2318,11 @@ static void gatt_client_handle_att_read_response(gatt_client_t *gatt_client, uin
 
             // Use ATT_READ_REQUEST for first blob of Read Long Characteristic
         case P_W4_READ_BLOB_RESULT:
+            if (gatt_client->long_read != NULL){
+                gatt_client_long_read_handle_blob(gatt_client, &packet[1], size - 1u);
+                gatt_client_handle_transaction_complete(gatt_client, ATT_ERROR_SUCCESS);
+                break;
+            }
             report_gatt_long_characteristic_value_blob(gatt_client, gatt_client->attribute_handle, &packet[1],
                                                        size - 1u, gatt_client->attribute_offset);
             trigger_next_blob_query(gatt_client, P_W2_SEND_READ_BLOB_QUERY, size - 1u);
@@ -1730,6 +2435,9 @@ static void gatt_client_handle_att_write_response(gatt_client_t *gatt_client) {
 
 static void gatt_client_handle_att_response(gatt_client_t * gatt_client, uint8_t * packet, uint16_t size) {
     uint8_t att_status;
+#ifdef ENABLE_GATT_CLIENT_CACHE
+    if (gatt_client_cache_handle_att_response(gatt_client, packet, size)) return;
+#endif
     switch (packet[0]) {
         case ATT_EXCHANGE_MTU_RESPONSE: {
             if (size < 3u) break;
@@ -1874,6 +2582,11 @@ static void gatt_client_handle_att_response(gatt_client_t * gatt_client, uint8_t
             uint16_t received_blob_length = size - 1u;
             switch (gatt_client->state) {
                 case P_W4_READ_BLOB_RESULT:
+                    if (gatt_client->long_read != NULL){
+                        gatt_client_long_read_handle_blob(gatt_client, &packet[1], received_blob_length);
+                        gatt_client_handle_transaction_complete(gatt_client, ATT_ERROR_SUCCESS);
+                        break;
+                    }
                     report_gatt_long_characteristic_value_blob(gatt_client, gatt_client->attribute_handle, &packet[1],
                                                                received_blob_length, gatt_client->attribute_offset);
                     trigger_next_blob_query(gatt_client, P_W2_SEND_READ_BLOB_QUERY, received_blob_length);
@@ -2492,6 +3205,41 @@ uint8_t gatt_client_read_long_value_of_characteristic_using_value_handle_with_of
     return ERROR_CODE_SUCCESS;
 }
 
+uint8_t gatt_client_read_long_value_of_characteristic_into_buffer(gatt_client_long_read_t * long_read, btstack_packet_handler_t callback, hci_con_handle_t con_handle, uint16_t value_handle, uint8_t * buffer, uint16_t buffer_size){
+    gatt_client_t * gatt_client;
+    uint8_t status = gatt_client_provide_context_for_request(con_handle, &gatt_client);
+    if (status != ERROR_CODE_SUCCESS){
+        return status;
+    }
+
+    memset(long_read, 0, sizeof(gatt_client_long_read_t));
+    long_read->callback = callback;
+    long_read->con_handle = con_handle;
+    long_read->attribute_handle = value_handle;
+    long_read->buffer = buffer;
+    long_read->buffer_size = buffer_size;
+    long_read->value_length = GATT_CLIENT_LONG_READ_VALUE_LENGTH_UNKNOWN;
+    long_read->att_status = ATT_ERROR_SUCCESS;
+    (void) gatt_client_long_read_start_next(long_read, gatt_client);
+
+#ifdef ENABLE_GATT_OVER_EATT
+    // spread Read Blob requests for following offsets over all idle bearers
+    while (gatt_client_provide_context_for_request(con_handle, &gatt_client) == ERROR_CODE_SUCCESS){
+        if (gatt_client_long_read_start_next(long_read, gatt_client) == false){
+            gatt_client_timeout_stop(gatt_client);
+            break;
+        }
+    }
+#endif
+
+    gatt_client_run();
+    return ERROR_CODE_SUCCESS;
+}
+
+uint16_t gatt_client_long_read_get_value_length(const gatt_client_long_read_t * long_read){
+    return btstack_min(long_read->value_length, long_read->buffer_size);
+}
+
 uint8_t gatt_client_read_long_value_of_characteristic_using_value_handle(btstack_packet_handler_t callback, hci_con_handle_t con_handle, uint16_t value_handle){
     return gatt_client_read_long_value_of_characteristic_using_value_handle_with_offset(callback, con_handle, value_handle, 0);
 }
@@ -2579,6 +3327,26 @@ uint8_t gatt_client_write_long_value_of_characteristic_with_offset(btstack_packe
     return ERROR_CODE_SUCCESS;
 }
 
+uint8_t gatt_client_write_long_value_of_characteristic_from_source(btstack_packet_handler_t callback, hci_con_handle_t con_handle, uint16_t value_handle, uint16_t value_length, gatt_client_long_write_source_t source, void * source_context){
+    gatt_client_t * gatt_client;
+    uint8_t status = gatt_client_provide_context_for_request(con_handle, &gatt_client);
+    if (status != ERROR_CODE_SUCCESS){
+        return status;
+    }
+
+    // prepared writes are queued per bearer, all parts are sent over the same bearer
+    gatt_client->callback = callback;
+    gatt_client->attribute_handle = value_handle;
+    gatt_client->attribute_length = value_length;
+    gatt_client->attribute_offset = 0;
+    gatt_client->attribute_value = NULL;
+    gatt_client->long_write_source = source;
+    gatt_client->long_write_source_context = source_context;
+    gatt_client->state = P_W2_PREPARE_WRITE;
+    gatt_client_run();
+    return ERROR_CODE_SUCCESS;
+}
+
 uint8_t gatt_client_write_long_value_of_characteristic(btstack_packet_handler_t callback, hci_con_handle_t con_handle, uint16_t value_handle, uint16_t value_length, uint8_t * value){
     return gatt_client_write_long_value_of_characteristic_with_offset(callback, con_handle, value_handle, 0, value_length, value);    
 }
@@ -2852,6 +3620,22 @@ uint8_t gatt_client_request_to_send_gatt_query(btstack_context_callback_registra
     }
 }
 
+uint8_t gatt_client_request_to_send_gatt_query_for_attribute(gatt_client_attribute_query_request_t * request, hci_con_handle_t con_handle, uint16_t attribute_handle){
+    gatt_client_t * gatt_client;
+    uint8_t status = gatt_client_provide_context_for_handle(con_handle, &gatt_client);
+    if (status != ERROR_CODE_SUCCESS){
+        return status;
+    }
+    request->attribute_handle = attribute_handle;
+    bool added = btstack_linked_list_add_tail(&gatt_client->attribute_query_requests, (btstack_linked_item_t*) request);
+    if (added == false){
+        return ERROR_CODE_COMMAND_DISALLOWED;
+    } else {
+        gatt_client_notify_can_send_query(gatt_client);
+        return ERROR_CODE_SUCCESS;
+    }
+}
+
 uint8_t gatt_client_request_can_write_without_response_event(btstack_packet_handler_t callback, hci_con_handle_t con_handle){
     gatt_client_t * gatt_client;
     uint8_t status = gatt_client_provide_context_for_handle(con_handle, &gatt_client);
@@ -2869,6 +3653,7 @@ uint8_t gatt_client_request_can_write_without_response_event(btstack_packet_hand
 
 #if defined(ENABLE_GATT_OVER_CLASSIC) || defined(ENABLE_GATT_OVER_EATT)
 
+#include "bluetooth_psm.h"
 #include "hci_event.h"
 
 static const hci_event_t gatt_client_connected = {
@@ -2890,8 +3675,6 @@ static void gatt_client_emit_connected(btstack_packet_handler_t callback, uint8_
 
 #ifdef ENABLE_GATT_OVER_CLASSIC
 
-#include "bluetooth_psm.h"
-
 // single active SDP query
 static gatt_client_t * gatt_client_classic_active_sdp_query;
 
@@ -3172,7 +3955,12 @@ static void gatt_client_le_enhanced_handle_connected(gatt_client_t * gatt_client
         gatt_client->eatt_state = GATT_CLIENT_EATT_IDLE;
     }
 
-    gatt_client_emit_connected(gatt_client->callback, status,  gatt_client->addr, gatt_client->con_handle);
+    gatt_client_emit_connected(gatt_client->eatt_callback, status,  gatt_client->addr, gatt_client->con_handle);
+
+    // dispatch query requests to all bearers
+    if (gatt_client->eatt_state == GATT_CLIENT_EATT_READY){
+        gatt_client_notify_can_send_query(gatt_client);
+    }
 }
 
 // single channel disconnected
@@ -3194,7 +3982,7 @@ static void gatt_client_le_enhanced_handle_ecbm_disconnected(gatt_client_t * gat
             // report disconnected if last channel closed
             uint8_t buffer[20];
             uint16_t len = hci_event_create_from_template_and_arguments(buffer, sizeof(buffer), &gatt_client_disconnected, gatt_client->con_handle);
-            (*gatt_client->callback)(HCI_EVENT_PACKET, 0, buffer, len);
+            (*gatt_client->eatt_callback)(HCI_EVENT_PACKET, 0, buffer, len);
         }
     }
 }
@@ -3356,10 +4144,10 @@ static void gatt_client_le_enhanced_packet_handler(uint8_t packet_type, uint16_t
                     btstack_assert(eatt_client != NULL);
                     btstack_assert(eatt_client->state == P_W4_L2CAP_CONNECTION);
 
-                    status = l2cap_event_channel_opened_get_status(packet);
+                    status = l2cap_event_ecbm_channel_opened_get_status(packet);
                     if (status == ERROR_CODE_SUCCESS){
                         eatt_client->state = P_READY;
-                        eatt_client->mtu = l2cap_event_channel_opened_get_remote_mtu(packet);
+                        eatt_client->mtu = l2cap_event_ecbm_channel_opened_get_remote_mtu(packet);
                     } else {
                         eatt_client->state = P_L2CAP_CLOSED;
                     }
@@ -3481,7 +4269,7 @@ uint8_t gatt_client_le_enhanced_connect(btstack_packet_handler_t callback, hci_c
     hci_connection_t * hci_connection = hci_connection_for_handle(con_handle);
     hci_connection->att_server.eatt_outgoing_active = true;
 
-    gatt_client->callback = callback;
+    gatt_client->eatt_callback = callback;
     gatt_client->eatt_num_clients   = num_channels;
     gatt_client->eatt_storage_buffer = storage_buffer;
     gatt_client->eatt_storage_size   = storage_size;
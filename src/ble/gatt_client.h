@@ -169,6 +169,92 @@ typedef enum {
 } gatt_client_eatt_state_t;
 #endif
 
+#ifdef ENABLE_GATT_CLIENT_CACHE
+
+#ifndef GATT_CLIENT_CACHE_MAX_RECORDS
+#define GATT_CLIENT_CACHE_MAX_RECORDS 64
+#endif
+
+typedef enum {
+    GATT_CLIENT_CACHE_IDLE,
+    GATT_CLIENT_CACHE_W2_READ_DATABASE_HASH,
+    GATT_CLIENT_CACHE_W4_DATABASE_HASH,
+    GATT_CLIENT_CACHE_W2_READ_SERVICE_CHANGED,
+    GATT_CLIENT_CACHE_W4_SERVICE_CHANGED,
+    GATT_CLIENT_CACHE_W2_READ_SERVICE_CHANGED_CCCD,
+    GATT_CLIENT_CACHE_W4_SERVICE_CHANGED_CCCD,
+    GATT_CLIENT_CACHE_W2_WRITE_SERVICE_CHANGED_CCCD,
+    GATT_CLIENT_CACHE_W4_SERVICE_CHANGED_CCCD_WRITTEN,
+    GATT_CLIENT_CACHE_ACTIVE,
+    GATT_CLIENT_CACHE_UNSUPPORTED,
+} gatt_client_cache_state_t;
+
+typedef enum {
+    GATT_CLIENT_CACHE_RECORD_SERVICE,
+    GATT_CLIENT_CACHE_RECORD_CHARACTERISTIC,
+    GATT_CLIENT_CACHE_RECORD_DESCRIPTOR,
+} gatt_client_cache_record_type_t;
+
+// service, characteristic or descriptor, complete flag indicates that all characteristics/descriptors are cached
+typedef struct {
+    uint8_t  type;
+    uint8_t  complete;
+    uint16_t start_handle;
+    uint16_t value_handle;
+    uint16_t end_handle;
+    uint16_t properties;
+    uint8_t  uuid128[16];
+} gatt_client_cache_record_t;
+
+// allocated for bonded devices, stored in btstack_tlv, only valid records are stored
+typedef struct gatt_client_cache {
+    uint8_t  database_hash[16];
+    uint8_t  services_complete;
+    // indications for Service Changed enabled, or GATT Server without Service Changed
+    uint8_t  service_changed_configured;
+    uint16_t service_changed_value_handle;
+    uint16_t num_records;
+    gatt_client_cache_record_t records[GATT_CLIENT_CACHE_MAX_RECORDS];
+} gatt_client_cache_t;
+
+typedef struct {
+    gatt_client_cache_state_t state;
+    // records match GATT Server, database hash might not be known yet
+    bool     records_valid;
+    bool     database_hash_valid;
+    bool     dirty;
+    bool     report_pending;
+    bool     query_active;
+    bool     query_recording;
+    uint16_t query_record_index;
+    uint16_t query_num_records;
+    uint16_t service_changed_cccd_handle;
+    gatt_client_cache_t * data;
+} gatt_client_cache_context_t;
+#endif
+
+// provides value for long write from source: fill buffer with size bytes of the value starting at offset
+typedef void (*gatt_client_long_write_source_t)(void * context, uint16_t offset, uint8_t * buffer, uint16_t size);
+
+#define GATT_CLIENT_LONG_READ_VALUE_LENGTH_UNKNOWN 0xffffu
+
+// long read into application buffer, see gatt_client_read_long_value_of_characteristic_into_buffer
+typedef struct {
+    btstack_packet_handler_t callback;
+    hci_con_handle_t con_handle;
+    uint16_t attribute_handle;
+    uint8_t * buffer;
+    uint16_t  buffer_size;
+    // offset for next Read Blob request
+    uint16_t  next_offset;
+    // end of value, GATT_CLIENT_LONG_READ_VALUE_LENGTH_UNKNOWN until short blob has been received
+    uint16_t  value_length;
+    // number of bearers with outstanding request
+    uint8_t   num_active;
+    uint8_t   att_status;
+    bool      truncated;
+} gatt_client_long_read_t;
+
 typedef struct gatt_client{
     btstack_linked_item_t    item;
 
@@ -186,19 +272,27 @@ typedef struct gatt_client{
     // regular gatt query requests
     btstack_linked_list_t query_requests;
 
+    // gatt query requests for specific attribute handle
+    btstack_linked_list_t attribute_query_requests;
+
     hci_con_handle_t con_handle;
 
     att_bearer_type_t bearer_type;
 
-#ifdef ENABLE_GATT_OVER_CLASSIC
+#if defined(ENABLE_GATT_OVER_CLASSIC) || defined(ENABLE_GATT_OVER_EATT)
     bd_addr_t addr;
-    uint16_t  l2cap_psm;
     uint16_t  l2cap_cid;
+#endif
+
+#ifdef ENABLE_GATT_OVER_CLASSIC
+    uint16_t  l2cap_psm;
     btstack_context_callback_registration_t callback_request;
 #endif
 
 #ifdef ENABLE_GATT_OVER_EATT
     gatt_client_eatt_state_t eatt_state;
+    // callback for connected/disconnected events, callback is used by queries during EATT setup
+    btstack_packet_handler_t eatt_callback;
     btstack_linked_list_t eatt_clients;
     uint8_t * eatt_storage_buffer;
     uint16_t eatt_storage_size;
@@ -220,6 +314,11 @@ typedef struct gatt_client{
     
     uint16_t query_start_handle;
     uint16_t query_end_handle;
+
+    // attribute handle of active query started for gatt_client_attribute_query_request_t, or 0
+    uint16_t query_attribute_handle;
+    // attribute handle of gatt_client_attribute_query_request_t dispatched to this bearer, or 0
+    uint16_t pending_query_attribute_handle;
     
     uint8_t  characteristic_properties;
     uint16_t characteristic_start_handle;
@@ -228,6 +327,13 @@ typedef struct gatt_client{
     uint16_t attribute_offset;
     uint16_t attribute_length;
     uint8_t* attribute_value;
+
+    // long write with value provided by source
+    gatt_client_long_write_source_t long_write_source;
+    void * long_write_source_context;
+
+    // long read into application buffer, attribute_length is the requested blob length
+    gatt_client_long_read_t * long_read;
     
     // read multiple characteristic values
     uint16_t    read_multiple_handle_count;
@@ -253,6 +359,10 @@ typedef struct gatt_client{
 
     gap_security_level_t security_level;
 
+#ifdef ENABLE_GATT_CLIENT_CACHE
+    gatt_client_cache_context_t cache;
+#endif
+
 } gatt_client_t;
 
 typedef struct gatt_client_notification {
@@ -271,6 +381,12 @@ typedef struct {
     uint8_t  uuid128[16];
 } gatt_client_service_t;
 
+// request to send gatt query for a specific attribute handle
+typedef struct {
+    btstack_context_callback_registration_t callback_registration;
+    uint16_t attribute_handle;
+} gatt_client_attribute_query_request_t;
+
 typedef struct {
     uint16_t start_handle;
     uint16_t value_handle;
@@ -372,6 +488,11 @@ int gatt_client_is_ready(hci_con_handle_t con_handle);
  * @brief Discovers all primary services. 
  * For each found service a GATT_EVENT_SERVICE_QUERY_RESULT event will be emitted.
  * The GATT_EVENT_QUERY_COMPLETE event marks the end of discovery. 
+ * @note With ENABLE_GATT_CLIENT_CACHE, results of primary service, characteristic and characteristic descriptor
+ *       discovery of bonded devices are reported from the cache without ATT requests. A stored cache is validated
+ *       by reading the Database Hash of the GATT Server before the first discovery on an LE connection.
+ *       Indications for Service Changed are enabled once per bonded device. The cache is allocated via
+ *       btstack_memory, see MAX_NR_GATT_CLIENT_CACHES.
  * @param  callback   
  * @param  con_handle
  * @return status BTSTACK_MEMORY_ALLOC_FAILED, if no GATT client for con_handle is found 
@@ -624,6 +745,31 @@ uint8_t gatt_client_read_long_value_of_characteristic_using_value_handle(btstack
  */
 uint8_t gatt_client_read_long_value_of_characteristic_using_value_handle_with_offset(btstack_packet_handler_t callback, hci_con_handle_t con_handle, uint16_t value_handle, uint16_t offset);
 
+/**
+ * @brief Reads the long characteristic value using the characteristic's value handle directly into the provided buffer.
+ * No GATT_EVENT_LONG_CHARACTERISTIC_VALUE_QUERY_RESULT events are emitted. If EATT bearers are available, the
+ * Read Blob requests for consecutive offsets are sent in parallel over all idle bearers.
+ * The GATT_EVENT_QUERY_COMPLETE event marks the end of read, gatt_client_long_read_get_value_length provides the
+ * number of bytes stored in the buffer. If the value does not fit into the buffer, the att_status is set to GATT_CLIENT_VALUE_TOO_LONG.
+ * @param  long_read struct, make sure memory is accessible until read is done, i.e. GATT_EVENT_QUERY_COMPLETE is received
+ * @param  callback
+ * @param  con_handle
+ * @param  value_handle
+ * @param  buffer for value
+ * @param  buffer_size
+ * @return status BTSTACK_MEMORY_ALLOC_FAILED, if no GATT client for con_handle is found
+ *                GATT_CLIENT_IN_WRONG_STATE , if GATT client is not ready
+ *                ERROR_CODE_SUCCESS         , if query is successfully registered
+ */
+uint8_t gatt_client_read_long_value_of_characteristic_into_buffer(gatt_client_long_read_t * long_read, btstack_packet_handler_t callback, hci_con_handle_t con_handle, uint16_t value_handle, uint8_t * buffer, uint16_t buffer_size);
+
+/**
+ * @brief Get number of bytes stored by gatt_client_read_long_value_of_characteristic_into_buffer
+ * @param long_read
+ * @return value length, valid after GATT_EVENT_QUERY_COMPLETE
+ */
+uint16_t gatt_client_long_read_get_value_length(const gatt_client_long_read_t * long_read);
+
 /*
  * @brief Read multiple characteristic values.
  * The all results are emitted via single GATT_EVENT_CHARACTERISTIC_VALUE_QUERY_RESULT event, 
@@ -733,6 +879,25 @@ uint8_t gatt_client_write_long_value_of_characteristic(btstack_packet_handler_t
  */
 uint8_t gatt_client_write_long_value_of_characteristic_with_offset(btstack_packet_handler_t callback, hci_con_handle_t con_handle, uint16_t value_handle, uint16_t offset, uint16_t value_length, uint8_t * value);
 
+/**
+ * @brief Writes the long characteristic value using the characteristic's value handle. Instead of a value buffer,
+ * the source is called for each Prepare Write request to fill the request with the next part of the value.
+ * The same part may be requested more than once, e.g. if the request is repeated after pairing.
+ * The GATT_EVENT_QUERY_COMPLETE event marks the end of write.
+ * The write is successfully performed if the event's att_status field is set to ATT_ERROR_SUCCESS (see bluetooth.h for ATT_ERROR codes).
+ * @param  callback
+ * @param  con_handle
+ * @param  value_handle
+ * @param  value_length
+ * @param  source called to provide part of the value
+ * @param  source_context passed to source
+ * @return status ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER                  if no HCI connection for con_handle is found
+ *                BTSTACK_MEMORY_ALLOC_FAILED                               if no GATT client for con_handle could be allocated
+ *                GATT_CLIENT_IN_WRONG_STATE                                if GATT client is not ready
+ *                ERROR_CODE_SUCCESS                                        if query is successfully registered
+ */
+uint8_t gatt_client_write_long_value_of_characteristic_from_source(btstack_packet_handler_t callback, hci_con_handle_t con_handle, uint16_t value_handle, uint16_t value_length, gatt_client_long_write_source_t source, void * source_context);
+
 /** 
  * @brief Writes of the long characteristic value using the characteristic's value handle. 
  * It uses server response to validate that the write was correctly received. 
@@ -977,6 +1142,20 @@ uint8_t gatt_client_cancel_write(btstack_packet_handler_t callback, hci_con_hand
  */
 uint8_t gatt_client_request_to_send_gatt_query(btstack_context_callback_registration_t * callback_registration, hci_con_handle_t con_handle);
 
+/**
+ * @brief Request callback when a gatt query for the given attribute handle can be sent
+ * @note With EATT, queued requests are dispatched to all idle bearers, including the unenhanced ATT bearer.
+ *       Queries for the same attribute handle are not started before the previous one completed, while
+ *       queries for other attribute handles can be sent on other bearers. The callback has to start exactly one
+ *       query for the attribute handle. Requests registered with gatt_client_request_to_send_gatt_query are served first.
+ * @note callback might happen during call to this function
+ * @param request with callback function, context information, and attribute handle
+ * @param con_handle
+ * @param attribute_handle
+ * @return ERROR_CODE_SUCCESS if ok, ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER if handle unknown, and ERROR_CODE_COMMAND_DISALLOWED if request already registered
+ */
+uint8_t gatt_client_request_to_send_gatt_query_for_attribute(gatt_client_attribute_query_request_t * request, hci_con_handle_t con_handle, uint16_t attribute_handle);
+
 /**
  * @brief Request callback when writing characteristic value without response is possible
  * @note callback might happen during call to this function
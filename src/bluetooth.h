@@ -761,6 +761,7 @@ typedef enum {
 #define ATT_ERROR_INSUFFICIENT_ENCRYPTION          0x0f
 #define ATT_ERROR_UNSUPPORTED_GROUP_TYPE           0x10
 #define ATT_ERROR_INSUFFICIENT_RESOURCES           0x11
+#define ATT_ERROR_DATABASE_OUT_OF_SYNC             0x12
 #define ATT_ERROR_VALUE_NOT_ALLOWED                0x13
 
 // MARK: ATT Error Codes defined by BTstack
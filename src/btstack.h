@@ -137,6 +137,7 @@
 #include "classic/pan.h"
 #include "classic/pbap.h"
 #include "classic/pbap_client.h"
+#include "classic/pbap_vcard_parser.h"
 #include "classic/rfcomm.h"
 #include "classic/sdp_client.h"
 #include "classic/sdp_client_rfcomm.h"
@@ -147,6 +148,7 @@
 
 #include "le-audio/le_audio.h"
 #include "le-audio/le_audio_util.h"
+#include "le-audio/le_audio_jitter_buffer.h"
 #include "le-audio/gatt-service/broadcast_audio_scan_service_client.h"
 #include "le-audio/gatt-service/broadcast_audio_scan_service_server.h"
 
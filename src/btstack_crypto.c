@@ -162,6 +162,46 @@ static btstack_crypto_ecc_p256_key_generation_state_t btstack_crypto_ecc_p256_ke
 
 #ifdef USE_SOFTWARE_ECC_P256_IMPLEMENTATION
 static uint8_t btstack_crypto_ecc_p256_d[32];
+
+// random data for key generation on the thread executing ECC operations
+static const uint8_t * btstack_crypto_ecc_p256_rng_random;
+
+// number of key pairs precomputed in idle time if executor is set
+#ifndef BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE
+#define BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE 2
+#endif
+
+typedef enum {
+    ECC_P256_JOB_GENERATE_KEY,
+    ECC_P256_JOB_GENERATE_POOL_KEY,
+    ECC_P256_JOB_CALCULATE_DHKEY,
+} btstack_crypto_ecc_p256_job_type_t;
+
+// self-contained job, as executor might run it on a different thread
+typedef struct {
+    btstack_crypto_ecc_p256_job_type_t type;
+    uint8_t random[64];
+    uint8_t public_key[64];
+    uint8_t private_key[32];
+    uint8_t dhkey[32];
+} btstack_crypto_ecc_p256_job_t;
+
+typedef struct {
+    uint8_t public_key[64];
+    uint8_t private_key[32];
+} btstack_crypto_ecc_p256_key_pair_t;
+
+static const btstack_crypto_ecc_p256_executor_t * btstack_crypto_ecc_p256_executor;
+static btstack_crypto_ecc_p256_job_t btstack_crypto_ecc_p256_job;
+static bool btstack_crypto_ecc_p256_job_active;
+static bool btstack_crypto_ecc_p256_job_discard;
+
+#if BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE > 0
+static btstack_crypto_ecc_p256_key_pair_t btstack_crypto_ecc_p256_key_pool[BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE];
+static uint8_t btstack_crypto_ecc_p256_key_pool_count;
+static bool    btstack_crypto_ecc_p256_key_pool_random_active;
+static uint8_t btstack_crypto_ecc_p256_key_pool_random_len;
+#endif
 #endif
 
 // Software ECDH implementation provided by mbedtls
@@ -172,11 +212,61 @@ static mbedtls_ecp_group   mbedtls_ec_group;
 #endif /* ENABLE_ECC_P256 */
 
 #ifdef ENABLE_SOFTWARE_AES128
+
+// number of expanded AES128 keys kept, e.g. for Mesh NetKey/AppKey/DevKey and SM
+#ifndef BTSTACK_CRYPTO_AES128_KEY_SCHEDULE_CACHE_SIZE
+#define BTSTACK_CRYPTO_AES128_KEY_SCHEDULE_CACHE_SIZE 4
+#endif
+
+typedef struct {
+    uint8_t  key[16];
+    uint32_t rk[RKLENGTH(KEYBITS)];
+    int      nrounds;
+} btstack_crypto_aes128_key_schedule_t;
+
+static btstack_crypto_aes128_key_schedule_t btstack_crypto_aes128_key_schedules[BTSTACK_CRYPTO_AES128_KEY_SCHEDULE_CACHE_SIZE];
+static uint8_t btstack_crypto_aes128_key_schedules_count;
+static uint8_t btstack_crypto_aes128_key_schedule_last;
+static uint8_t btstack_crypto_aes128_key_schedule_next;
+
+static void btstack_crypto_aes128_key_schedules_clear(void){
+    memset(btstack_crypto_aes128_key_schedules, 0, sizeof(btstack_crypto_aes128_key_schedules));
+    btstack_crypto_aes128_key_schedules_count = 0;
+    btstack_crypto_aes128_key_schedule_last = 0;
+    btstack_crypto_aes128_key_schedule_next = 0;
+}
+
+// get expanded key, compute and store with round-robin replacement if not found
+static const btstack_crypto_aes128_key_schedule_t * btstack_crypto_aes128_get_key_schedule(const uint8_t * key){
+    // check last used key first, e.g. for all blocks of a CMAC/CCM operation
+    btstack_crypto_aes128_key_schedule_t * schedule = &btstack_crypto_aes128_key_schedules[btstack_crypto_aes128_key_schedule_last];
+    if ((btstack_crypto_aes128_key_schedules_count > 0u) && (memcmp(schedule->key, key, 16) == 0)){
+        return schedule;
+    }
+    uint8_t index;
+    for (index = 0; index < btstack_crypto_aes128_key_schedules_count; index++){
+        schedule = &btstack_crypto_aes128_key_schedules[index];
+        if (memcmp(schedule->key, key, 16) == 0){
+            btstack_crypto_aes128_key_schedule_last = index;
+            return schedule;
+        }
+    }
+    index = btstack_crypto_aes128_key_schedule_next;
+    btstack_crypto_aes128_key_schedule_next = (index + 1u) % BTSTACK_CRYPTO_AES128_KEY_SCHEDULE_CACHE_SIZE;
+    if (btstack_crypto_aes128_key_schedules_count < BTSTACK_CRYPTO_AES128_KEY_SCHEDULE_CACHE_SIZE){
+        btstack_crypto_aes128_key_schedules_count++;
+    }
+    schedule = &btstack_crypto_aes128_key_schedules[index];
+    (void)memcpy(schedule->key, key, 16);
+    schedule->nrounds = rijndaelSetupEncrypt(schedule->rk, &key[0], KEYBITS);
+    btstack_crypto_aes128_key_schedule_last = index;
+    return schedule;
+}
+
 // AES128 using public domain rijndael implementation
 void btstack_aes128_calc(const uint8_t * key, const uint8_t * plaintext, uint8_t * ciphertext){
-    uint32_t rk[RKLENGTH(KEYBITS)];
-    int nrounds = rijndaelSetupEncrypt(rk, &key[0], KEYBITS);
-    rijndaelEncrypt(rk, nrounds, plaintext, ciphertext);
+    const btstack_crypto_aes128_key_schedule_t * schedule = btstack_crypto_aes128_get_key_schedule(key);
+    rijndaelEncrypt(schedule->rk, schedule->nrounds, plaintext, ciphertext);
 }
 #endif
 
@@ -218,10 +308,50 @@ static void btstack_crypto_cmac_calc_subkeys(sm_key_t k0, sm_key_t k1, sm_key_t
     } 
 }
 
+static void btstack_crypto_cmac_calc_message(const uint8_t * key, uint16_t size, const uint8_t * message, uint8_t * hash){
+    sm_key_t k0, k1, k2;
+    sm_key_t cmac_x;
+    sm_key_t cmac_y;
+    uint16_t i;
+
+    btstack_aes128_calc(key, zero, k0);
+    btstack_crypto_cmac_calc_subkeys(k0, k1, k2);
+
+    // all but last block
+    memset(cmac_x, 0, 16);
+    uint16_t pos = 0;
+    while ((size - pos) > 16u){
+        for (i=0;i<16u;i++){
+            cmac_y[i] = cmac_x[i] ^ message[pos + i];
+        }
+        btstack_aes128_calc(key, cmac_y, cmac_x);
+        pos += 16u;
+    }
+
+    // last block, complete or padded
+    uint16_t valid_octets_in_last_block = size - pos;
+    const uint8_t * subkey = (valid_octets_in_last_block == 16u) ? k1 : k2;
+    for (i=0;i<16u;i++){
+        uint8_t m_last = 0;
+        if (i < valid_octets_in_last_block){
+            m_last = message[pos + i];
+        } else if (i == valid_octets_in_last_block){
+            m_last = 0x80;
+        }
+        cmac_y[i] = cmac_x[i] ^ m_last ^ subkey[i];
+    }
+    btstack_aes128_calc(key, cmac_y, hash);
+}
+
 static void btstack_crypto_cmac_calc(btstack_crypto_aes128_cmac_t * btstack_crypto_cmac) {
     sm_key_t k0, k1, k2;
     uint16_t i;
 
+    if (btstack_crypto_cmac->btstack_crypto.operation == BTSTACK_CRYPTO_CMAC_MESSAGE){
+        btstack_crypto_cmac_calc_message(btstack_crypto_cmac->key, btstack_crypto_cmac->size, btstack_crypto_cmac->data.message, btstack_crypto_cmac->hash);
+        return;
+    }
+
     btstack_aes128_calc(btstack_crypto_cmac->key, zero, k0);
     btstack_crypto_cmac_calc_subkeys(k0, k1, k2);
 
@@ -487,6 +617,88 @@ static void btstack_crypto_ccm_setup_b_0(btstack_crypto_ccm_t * btstack_crypto_c
 #endif
 }
 
+#ifdef USE_BTSTACK_AES128
+// complete CCM operation with synchronous AES128, same format as btstack_crypto_ccm (L=2)
+static void btstack_crypto_ccm_calc(const uint8_t * key, const uint8_t * nonce,
+                                    const uint8_t * additional_authenticated_data, uint16_t additional_authenticated_data_len,
+                                    const uint8_t * input, uint16_t len, uint8_t * output,
+                                    uint8_t * authentication_value, uint8_t auth_len, bool encrypt){
+    uint8_t x_i[16];
+    uint8_t a_i[16];
+    uint8_t s_i[16];
+    uint16_t i;
+
+    // X_1 := E(K, B_0)
+    uint8_t m_prime = (auth_len - 2u) / 2u;
+    uint8_t Adata   = (additional_authenticated_data_len > 0u) ? 1 : 0;
+    a_i[0] = (Adata << 6u) | (m_prime << 3u) | 1u;
+    (void)memcpy(&a_i[1], nonce, 13);
+    big_endian_store_16(a_i, 14, len);
+    btstack_aes128_calc(key, a_i, x_i);
+
+    // additional authenticated data with 2 byte length prefix
+    if (additional_authenticated_data_len > 0u){
+        x_i[0] ^= (uint8_t) (additional_authenticated_data_len >> 8);
+        x_i[1] ^= (uint8_t) (additional_authenticated_data_len & 0xffu);
+        uint16_t offset = 2;
+        for (i = 0; i < additional_authenticated_data_len; i++){
+            x_i[offset++] ^= additional_authenticated_data[i];
+            if (offset == 16u){
+                btstack_aes128_calc(key, x_i, x_i);
+                offset = 0;
+            }
+        }
+        if (offset > 0u){
+            btstack_aes128_calc(key, x_i, x_i);
+        }
+    }
+
+    // CBC-MAC over plaintext and CTR encryption with A_i, i >= 1
+    a_i[0] = 1u;  // L' = L - 1
+    uint16_t counter = 1;
+    uint16_t pos = 0;
+    while (pos < len){
+        uint16_t bytes_to_process = btstack_min(len - pos, 16);
+        big_endian_store_16(a_i, 14, counter++);
+        btstack_aes128_calc(key, a_i, s_i);
+        for (i = 0; i < bytes_to_process; i++){
+            uint8_t plaintext = encrypt ? input[pos + i] : (input[pos + i] ^ s_i[i]);
+            output[pos + i] = input[pos + i] ^ s_i[i];
+            x_i[i] ^= plaintext;
+        }
+        btstack_aes128_calc(key, x_i, x_i);
+        pos += bytes_to_process;
+    }
+
+    // T XOR S_0
+    big_endian_store_16(a_i, 14, 0);
+    btstack_aes128_calc(key, a_i, s_i);
+    for (i = 0; i < auth_len; i++){
+        authentication_value[i] = x_i[i] ^ s_i[i];
+    }
+}
+
+void btstack_aes128_cmac_calc(const uint8_t * key, uint16_t size, const uint8_t * message, uint8_t * hash){
+    btstack_crypto_cmac_calc_message(key, size, message, hash);
+}
+
+void btstack_aes128_ccm_encrypt(const uint8_t * key, const uint8_t * nonce,
+                                const uint8_t * additional_authenticated_data, uint16_t additional_authenticated_data_len,
+                                const uint8_t * plaintext, uint16_t len, uint8_t * ciphertext,
+                                uint8_t * authentication_value, uint8_t auth_len){
+    btstack_crypto_ccm_calc(key, nonce, additional_authenticated_data, additional_authenticated_data_len,
+                            plaintext, len, ciphertext, authentication_value, auth_len, true);
+}
+
+void btstack_aes128_ccm_decrypt(const uint8_t * key, const uint8_t * nonce,
+                                const uint8_t * additional_authenticated_data, uint16_t additional_authenticated_data_len,
+                                const uint8_t * ciphertext, uint16_t len, uint8_t * plaintext,
+                                uint8_t * authentication_value, uint8_t auth_len){
+    btstack_crypto_ccm_calc(key, nonce, additional_authenticated_data, additional_authenticated_data_len,
+                            ciphertext, len, plaintext, authentication_value, auth_len, false);
+}
+#endif
+
 #ifdef ENABLE_ECC_P256
 
 static void btstack_crypto_log_ec_publickey(const uint8_t * ec_q){
@@ -498,14 +710,14 @@ static void btstack_crypto_log_ec_publickey(const uint8_t * ec_q){
 
 #if (defined(USE_MICRO_ECC_P256) && !defined(WICED_VERSION)) || defined(USE_MBEDTLS_ECC_P256)
 // @return OK
+// @note might be called on worker thread, no logging
 static int sm_generate_f_rng(unsigned char * buffer, unsigned size){
-    if (btstack_crypto_ecc_p256_key_generation_state != ECC_P256_KEY_GENERATION_ACTIVE) return 0;
-    log_info("sm_generate_f_rng: size %u - offset %u", (int) size, btstack_crypto_ecc_p256_random_offset);
-    btstack_assert((btstack_crypto_ecc_p256_random_offset + size) <= btstack_crypto_ecc_p256_random_len);
+    if (btstack_crypto_ecc_p256_rng_random == NULL) return 0;
+    btstack_assert((btstack_crypto_ecc_p256_random_offset + size) <= 64u);
     uint16_t remaining_size = size;
     uint8_t * buffer_ptr = buffer;
     while (remaining_size) {
-        *buffer_ptr++ = btstack_crypto_ecc_p256_random[btstack_crypto_ecc_p256_random_offset++];
+        *buffer_ptr++ = btstack_crypto_ecc_p256_rng_random[btstack_crypto_ecc_p256_random_offset++];
         remaining_size--;
     }
     return 1;
@@ -519,29 +731,31 @@ static int sm_generate_f_rng_mbedtls(void * context, unsigned char * buffer, siz
 }
 #endif /* USE_MBEDTLS_ECC_P256 */
 
-static void btstack_crypto_ecc_p256_generate_key_software(void){
+#ifdef USE_SOFTWARE_ECC_P256_IMPLEMENTATION
+// @note might be called on worker thread, no logging
+static void btstack_crypto_ecc_p256_generate_key_software(const uint8_t * random, uint8_t * public_key, uint8_t * private_key){
 
+    btstack_crypto_ecc_p256_rng_random = random;
     btstack_crypto_ecc_p256_random_offset = 0;
     
     // generate EC key
 #ifdef USE_MICRO_ECC_P256
 
 #ifndef WICED_VERSION
-    log_info("set uECC RNG for initial key generation with 64 random bytes");
+    // set uECC RNG for initial key generation with 64 random bytes
     // micro-ecc from WICED SDK uses its wiced_crypto_get_random by default - no need to set it
     uECC_set_rng(&sm_generate_f_rng);
 #endif /* WICED_VERSION */
 
 #if uECC_SUPPORTS_secp256r1
     // standard version
-    uECC_make_key(btstack_crypto_ecc_p256_public_key, btstack_crypto_ecc_p256_d, uECC_secp256r1());
+    uECC_make_key(public_key, private_key, uECC_secp256r1());
 
     // disable RNG again, as returning no randmon data lets shared key generation fail
-    log_info("disable uECC RNG in standard version after key generation");
     uECC_set_rng(NULL);
 #else
     // static version
-    uECC_make_key(btstack_crypto_ecc_p256_public_key, btstack_crypto_ecc_p256_d);
+    uECC_make_key(public_key, private_key);
 #endif
 #endif /* USE_MICRO_ECC_P256 */
 
@@ -550,27 +764,28 @@ static void btstack_crypto_ecc_p256_generate_key_software(void){
     mbedtls_ecp_point P;
     mbedtls_mpi_init(&d);
     mbedtls_ecp_point_init(&P);
-    int res = mbedtls_ecp_gen_keypair(&mbedtls_ec_group, &d, &P, &sm_generate_f_rng_mbedtls, NULL);
-    log_info("gen keypair %x", res);
-    mbedtls_mpi_write_binary(&P.X, &btstack_crypto_ecc_p256_public_key[0],  32);
-    mbedtls_mpi_write_binary(&P.Y, &btstack_crypto_ecc_p256_public_key[32], 32);
-    mbedtls_mpi_write_binary(&d, btstack_crypto_ecc_p256_d, 32);
+    (void) mbedtls_ecp_gen_keypair(&mbedtls_ec_group, &d, &P, &sm_generate_f_rng_mbedtls, NULL);
+    mbedtls_mpi_write_binary(&P.X, &public_key[0],  32);
+    mbedtls_mpi_write_binary(&P.Y, &public_key[32], 32);
+    mbedtls_mpi_write_binary(&d, private_key, 32);
     mbedtls_ecp_point_free(&P);
     mbedtls_mpi_free(&d);
 #endif  /* USE_MBEDTLS_ECC_P256 */
+
+    btstack_crypto_ecc_p256_rng_random = NULL;
 }
 
-#ifdef USE_SOFTWARE_ECC_P256_IMPLEMENTATION
-static void btstack_crypto_ecc_p256_calculate_dhkey_software(btstack_crypto_ecc_p256_t * btstack_crypto_ec_p192){
-    memset(btstack_crypto_ec_p192->dhkey, 0, 32);
+// @note might be called on worker thread, no logging
+static void btstack_crypto_ecc_p256_calculate_dhkey_software(const uint8_t * public_key, const uint8_t * private_key, uint8_t * dhkey){
+    memset(dhkey, 0, 32);
 
 #ifdef USE_MICRO_ECC_P256
 #if uECC_SUPPORTS_secp256r1
     // standard version
-    uECC_shared_secret(btstack_crypto_ec_p192->public_key, btstack_crypto_ecc_p256_d, btstack_crypto_ec_p192->dhkey, uECC_secp256r1());
+    uECC_shared_secret(public_key, private_key, dhkey, uECC_secp256r1());
 #else
     // static version
-    uECC_shared_secret(btstack_crypto_ec_p192->public_key, btstack_crypto_ecc_p256_d, btstack_crypto_ec_p192->dhkey);
+    uECC_shared_secret(public_key, private_key, dhkey);
 #endif
 #endif
 
@@ -582,21 +797,167 @@ static void btstack_crypto_ecc_p256_calculate_dhkey_software(btstack_crypto_ecc_
     mbedtls_mpi_init(&d);
     mbedtls_ecp_point_init(&Q);
     mbedtls_ecp_point_init(&DH);
-    mbedtls_mpi_read_binary(&d, btstack_crypto_ecc_p256_d, 32);
-    mbedtls_mpi_read_binary(&Q.X, &btstack_crypto_ec_p192->public_key[0] , 32);
-    mbedtls_mpi_read_binary(&Q.Y, &btstack_crypto_ec_p192->public_key[32], 32);
+    mbedtls_mpi_read_binary(&d, private_key, 32);
+    mbedtls_mpi_read_binary(&Q.X, &public_key[0] , 32);
+    mbedtls_mpi_read_binary(&Q.Y, &public_key[32], 32);
     mbedtls_mpi_lset(&Q.Z, 1);
     mbedtls_ecp_mul(&mbedtls_ec_group, &DH, &d, &Q, NULL, NULL);
-    mbedtls_mpi_write_binary(&DH.X, btstack_crypto_ec_p192->dhkey, 32);
+    mbedtls_mpi_write_binary(&DH.X, dhkey, 32);
     mbedtls_ecp_point_free(&DH);
     mbedtls_mpi_free(&d);
     mbedtls_ecp_point_free(&Q);
 #endif
+}
+
+static void btstack_crypto_ecc_p256_job_execute(void * context){
+    btstack_crypto_ecc_p256_job_t * job = (btstack_crypto_ecc_p256_job_t *) context;
+    switch (job->type){
+        case ECC_P256_JOB_GENERATE_KEY:
+        case ECC_P256_JOB_GENERATE_POOL_KEY:
+            btstack_crypto_ecc_p256_generate_key_software(job->random, job->public_key, job->private_key);
+            break;
+        case ECC_P256_JOB_CALCULATE_DHKEY:
+            btstack_crypto_ecc_p256_calculate_dhkey_software(job->public_key, job->private_key, job->dhkey);
+            break;
+        default:
+            btstack_unreachable();
+            break;
+    }
+}
+
+static bool btstack_crypto_operation_is_ecc_p256(btstack_crypto_operation_t operation){
+    switch (operation){
+        case BTSTACK_CRYPTO_ECC_P256_GENERATE_KEY:
+        case BTSTACK_CRYPTO_ECC_P256_CALCULATE_DHKEY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static btstack_crypto_ecc_p256_t * btstack_crypto_ecc_p256_first_dhkey_operation(void){
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &btstack_crypto_operations);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        btstack_crypto_t * btstack_crypto = (btstack_crypto_t *) btstack_linked_list_iterator_next(&it);
+        if (btstack_crypto->operation == BTSTACK_CRYPTO_ECC_P256_CALCULATE_DHKEY) {
+            return (btstack_crypto_ecc_p256_t *) btstack_crypto;
+        }
+    }
+    return NULL;
+}
+
+// while ECC job is executed, move first non-ECC operation to front of queue
+static btstack_crypto_t * btstack_crypto_ecc_p256_job_bypass(void){
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &btstack_crypto_operations);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        btstack_crypto_t * btstack_crypto = (btstack_crypto_t *) btstack_linked_list_iterator_next(&it);
+        if (btstack_crypto_operation_is_ecc_p256(btstack_crypto->operation)) continue;
+        btstack_linked_list_iterator_remove(&it);
+        btstack_linked_list_add(&btstack_crypto_operations, (btstack_linked_item_t *) btstack_crypto);
+        return btstack_crypto;
+    }
+    return NULL;
+}
+
+static void btstack_crypto_ecc_p256_job_complete(btstack_crypto_ecc_p256_job_t * job){
+    btstack_crypto_ecc_p256_t * btstack_crypto_ec_p192;
+    btstack_crypto_ecc_p256_job_active = false;
+    if (btstack_crypto_ecc_p256_job_discard){
+        // reset while job was executed, drop result unless it's a fresh key pair for the pool
+        btstack_crypto_ecc_p256_job_discard = false;
+        if (job->type != ECC_P256_JOB_GENERATE_POOL_KEY) return;
+    }
+    switch (job->type){
+        case ECC_P256_JOB_GENERATE_KEY:
+            (void)memcpy(btstack_crypto_ecc_p256_public_key, job->public_key, 64);
+            (void)memcpy(btstack_crypto_ecc_p256_d, job->private_key, 32);
+            btstack_crypto_ecc_p256_key_generation_state = ECC_P256_KEY_GENERATION_DONE;
+            break;
+#if BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE > 0
+        case ECC_P256_JOB_GENERATE_POOL_KEY:
+            // executor might have been removed meanwhile
+            if (btstack_crypto_ecc_p256_executor == NULL) break;
+            if (btstack_crypto_ecc_p256_key_pool_count < BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE){
+                btstack_crypto_ecc_p256_key_pair_t * key_pair = &btstack_crypto_ecc_p256_key_pool[btstack_crypto_ecc_p256_key_pool_count++];
+                (void)memcpy(key_pair->public_key,  job->public_key, 64);
+                (void)memcpy(key_pair->private_key, job->private_key, 32);
+                log_info("ECC key pool: %u key pairs", btstack_crypto_ecc_p256_key_pool_count);
+            }
+            break;
+#endif
+        case ECC_P256_JOB_CALCULATE_DHKEY:
+            // other operations might have been processed meanwhile, job belongs to first DHKEY operation
+            btstack_crypto_ec_p192 = btstack_crypto_ecc_p256_first_dhkey_operation();
+            // operation might have been dropped by reset
+            if (btstack_crypto_ec_p192 == NULL) break;
+            (void)memcpy(btstack_crypto_ec_p192->dhkey, job->dhkey, 32);
+            log_info("dhkey");
+            log_info_hexdump(btstack_crypto_ec_p192->dhkey, 32);
+            btstack_linked_list_remove(&btstack_crypto_operations, (btstack_linked_item_t *) btstack_crypto_ec_p192);
+            (*btstack_crypto_ec_p192->btstack_crypto.context_callback.callback)(btstack_crypto_ec_p192->btstack_crypto.context_callback.context);
+            break;
+        default:
+            btstack_unreachable();
+            break;
+    }
+}
 
-    log_info("dhkey");
-    log_info_hexdump(btstack_crypto_ec_p192->dhkey, 32);
+// called by executor on main thread
+static void btstack_crypto_ecc_p256_job_done(void * context){
+    btstack_crypto_ecc_p256_job_complete((btstack_crypto_ecc_p256_job_t *) context);
+    btstack_crypto_run();
+}
+
+// run job via executor or inline
+static void btstack_crypto_ecc_p256_job_start(btstack_crypto_ecc_p256_job_type_t type){
+    btstack_crypto_ecc_p256_job.type = type;
+    btstack_crypto_ecc_p256_job_active = true;
+    if (btstack_crypto_ecc_p256_executor == NULL){
+        btstack_crypto_ecc_p256_job_execute(&btstack_crypto_ecc_p256_job);
+        btstack_crypto_ecc_p256_job_complete(&btstack_crypto_ecc_p256_job);
+    } else {
+        (*btstack_crypto_ecc_p256_executor->execute)(&btstack_crypto_ecc_p256_job_execute, &btstack_crypto_ecc_p256_job_done, &btstack_crypto_ecc_p256_job);
+    }
+}
+
+#if BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE > 0
+// precompute key pairs while idle, only with executor
+static void btstack_crypto_ecc_p256_key_pool_run(void){
+    if (btstack_crypto_ecc_p256_executor == NULL) return;
+    if (btstack_crypto_ecc_p256_job_active) return;
+    if (btstack_crypto_ecc_p256_key_pool_count >= BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE) return;
+    if (hci_get_state() != HCI_STATE_WORKING) return;
+    if (!hci_can_send_command_packet_now()) return;
+    if (!btstack_crypto_ecc_p256_key_pool_random_active){
+        btstack_crypto_ecc_p256_key_pool_random_active = true;
+        btstack_crypto_ecc_p256_key_pool_random_len = 0;
+    }
+    btstack_crypto_wait_for_hci_result = true;
+    hci_send_cmd(&hci_le_rand);
+}
+
+static void btstack_crypto_ecc_p256_key_pool_handle_random_data(const uint8_t * data, uint16_t len){
+    uint16_t bytes_to_copy = btstack_min(len, 64u - btstack_crypto_ecc_p256_key_pool_random_len);
+    (void)memcpy(&btstack_crypto_ecc_p256_job.random[btstack_crypto_ecc_p256_key_pool_random_len], data, bytes_to_copy);
+    btstack_crypto_ecc_p256_key_pool_random_len += bytes_to_copy;
+    if (btstack_crypto_ecc_p256_key_pool_random_len < 64u) return;
+    btstack_crypto_ecc_p256_key_pool_random_active = false;
+    btstack_crypto_ecc_p256_job_start(ECC_P256_JOB_GENERATE_POOL_KEY);
+}
+
+static bool btstack_crypto_ecc_p256_key_pool_get(uint8_t * public_key, uint8_t * private_key){
+    if (btstack_crypto_ecc_p256_key_pool_count == 0u) return false;
+    btstack_crypto_ecc_p256_key_pool_count--;
+    btstack_crypto_ecc_p256_key_pair_t * key_pair = &btstack_crypto_ecc_p256_key_pool[btstack_crypto_ecc_p256_key_pool_count];
+    (void)memcpy(public_key,  key_pair->public_key, 64);
+    (void)memcpy(private_key, key_pair->private_key, 32);
+    memset(key_pair, 0, sizeof(btstack_crypto_ecc_p256_key_pair_t));
+    return true;
 }
 #endif
+#endif /* USE_SOFTWARE_ECC_P256_IMPLEMENTATION */
 
 #endif
 
@@ -834,6 +1195,26 @@ static void btstack_crypto_ccm_calc_aad_xn(btstack_crypto_ccm_t * btstack_crypto
 #endif
 }
 
+// AES128 based operations complete synchronously with software or custom AES128 implementation
+static bool btstack_crypto_operation_requires_hci(btstack_crypto_operation_t operation){
+#ifdef USE_BTSTACK_AES128
+    switch (operation){
+        case BTSTACK_CRYPTO_AES128:
+        case BTSTACK_CRYPTO_CMAC_GENERATOR:
+        case BTSTACK_CRYPTO_CMAC_MESSAGE:
+        case BTSTACK_CRYPTO_CCM_DIGEST_BLOCK:
+        case BTSTACK_CRYPTO_CCM_ENCRYPT_BLOCK:
+        case BTSTACK_CRYPTO_CCM_DECRYPT_BLOCK:
+            return false;
+        default:
+            return true;
+    }
+#else
+    UNUSED(operation);
+    return true;
+#endif
+}
+
 static void btstack_crypto_run(void){
 
     btstack_crypto_aes128_t        * btstack_crypto_aes128;
@@ -843,23 +1224,44 @@ static void btstack_crypto_run(void){
     btstack_crypto_ecc_p256_t      * btstack_crypto_ec_p192;
 #endif
 
-    // stack up and running?
-    if (hci_get_state() != HCI_STATE_WORKING) return;
-
     // try to do as much as possible
     while (true){
 
-        // anything to do?
-        if (btstack_linked_list_empty(&btstack_crypto_operations)) return;
-
         // already active?
         if (btstack_crypto_wait_for_hci_result) return;
 
-        // can send a command?
-        if (!hci_can_send_command_packet_now()) return;
+        // anything to do?
+        if (btstack_linked_list_empty(&btstack_crypto_operations)) {
+#if defined(USE_SOFTWARE_ECC_P256_IMPLEMENTATION) && (BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE > 0)
+            btstack_crypto_ecc_p256_key_pool_run();
+#endif
+            return;
+        }
+
+#if defined(USE_SOFTWARE_ECC_P256_IMPLEMENTATION) && (BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE > 0)
+        // requested operations have priority over key pool
+        btstack_crypto_ecc_p256_key_pool_random_active = false;
+#endif
 
         // ok, find next task
     	btstack_crypto_t * btstack_crypto = (btstack_crypto_t*) btstack_linked_list_get_first_item(&btstack_crypto_operations);
+
+#ifdef USE_SOFTWARE_ECC_P256_IMPLEMENTATION
+        // ECC job in progress, continue with other operations
+        if (btstack_crypto_ecc_p256_job_active && btstack_crypto_operation_is_ecc_p256(btstack_crypto->operation)){
+            btstack_crypto = btstack_crypto_ecc_p256_job_bypass();
+            if (btstack_crypto == NULL) return;
+        }
+#endif
+
+        if (btstack_crypto_operation_requires_hci(btstack_crypto->operation)){
+            // stack up and running?
+            if (hci_get_state() != HCI_STATE_WORKING) return;
+
+            // can send a command?
+            if (!hci_can_send_command_packet_now()) return;
+        }
+
     	switch (btstack_crypto->operation){
     		case BTSTACK_CRYPTO_RANDOM:
     			btstack_crypto_wait_for_hci_result = true;
@@ -945,6 +1347,13 @@ static void btstack_crypto_run(void){
                         break;
                     case ECC_P256_KEY_GENERATION_IDLE:
 #ifdef USE_SOFTWARE_ECC_P256_IMPLEMENTATION
+#if BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE > 0
+                        if (btstack_crypto_ecc_p256_key_pool_get(btstack_crypto_ecc_p256_public_key, btstack_crypto_ecc_p256_d)){
+                            log_info("use ecc key pair from pool");
+                            btstack_crypto_ecc_p256_key_generation_state = ECC_P256_KEY_GENERATION_DONE;
+                            break;
+                        }
+#endif
                         log_info("start ecc random");
                         btstack_crypto_ecc_p256_key_generation_state = ECC_P256_KEY_GENERATION_GENERATING_RANDOM;
                         btstack_crypto_ecc_p256_random_len = 0;
@@ -970,10 +1379,9 @@ static void btstack_crypto_run(void){
             case BTSTACK_CRYPTO_ECC_P256_CALCULATE_DHKEY:
                 btstack_crypto_ec_p192 = (btstack_crypto_ecc_p256_t *) btstack_crypto;
 #ifdef USE_SOFTWARE_ECC_P256_IMPLEMENTATION
-                btstack_crypto_ecc_p256_calculate_dhkey_software(btstack_crypto_ec_p192);
-                // done
-                btstack_linked_list_pop(&btstack_crypto_operations);
-                (*btstack_crypto_ec_p192->btstack_crypto.context_callback.callback)(btstack_crypto_ec_p192->btstack_crypto.context_callback.context);
+                (void)memcpy(btstack_crypto_ecc_p256_job.public_key, btstack_crypto_ec_p192->public_key, 64);
+                (void)memcpy(btstack_crypto_ecc_p256_job.private_key, btstack_crypto_ecc_p256_d, 32);
+                btstack_crypto_ecc_p256_job_start(ECC_P256_JOB_CALCULATE_DHKEY);
 #else
                 btstack_crypto_wait_for_hci_result = 1;
                 hci_send_cmd(&hci_le_generate_dhkey, &btstack_crypto_ec_p192->public_key[0], &btstack_crypto_ec_p192->public_key[32]);
@@ -990,6 +1398,13 @@ static void btstack_crypto_run(void){
 
 static void btstack_crypto_handle_random_data(const uint8_t * data, uint16_t len){
     btstack_crypto_random_t * btstack_crypto_random;
+#if defined(USE_SOFTWARE_ECC_P256_IMPLEMENTATION) && (BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE > 0)
+    // random data requested for key pool, independent of queued operations
+    if (btstack_crypto_ecc_p256_key_pool_random_active){
+        btstack_crypto_ecc_p256_key_pool_handle_random_data(data, len);
+        return;
+    }
+#endif
     btstack_crypto_t * btstack_crypto = (btstack_crypto_t*) btstack_linked_list_get_first_item(&btstack_crypto_operations);
     uint16_t bytes_to_copy;
 	if (!btstack_crypto) return;
@@ -1012,11 +1427,13 @@ static void btstack_crypto_handle_random_data(const uint8_t * data, uint16_t len
             btstack_assert((btstack_crypto_ecc_p256_random_len + 8) <= 64);
             (void)memcpy(&btstack_crypto_ecc_p256_random[btstack_crypto_ecc_p256_random_len], data, 8);
             btstack_crypto_ecc_p256_random_len += 8u;
+#ifdef USE_SOFTWARE_ECC_P256_IMPLEMENTATION
             if (btstack_crypto_ecc_p256_random_len >= 64u) {
                 btstack_crypto_ecc_p256_key_generation_state = ECC_P256_KEY_GENERATION_ACTIVE;
-                btstack_crypto_ecc_p256_generate_key_software();
-                btstack_crypto_ecc_p256_key_generation_state = ECC_P256_KEY_GENERATION_DONE;
+                (void)memcpy(btstack_crypto_ecc_p256_job.random, btstack_crypto_ecc_p256_random, 64);
+                btstack_crypto_ecc_p256_job_start(ECC_P256_JOB_GENERATE_KEY);
             }
+#endif
             break;
 #endif
         default:
@@ -1363,6 +1780,16 @@ static void btstack_crypto_state_reset(void) {
 #endif
 #ifdef ENABLE_ECC_P256
     btstack_crypto_ecc_p256_key_generation_state = ECC_P256_KEY_GENERATION_IDLE;
+#endif
+#if defined(USE_SOFTWARE_ECC_P256_IMPLEMENTATION) && (BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE > 0)
+    btstack_crypto_ecc_p256_key_pool_random_active = false;
+#endif
+#ifdef USE_SOFTWARE_ECC_P256_IMPLEMENTATION
+    // result of job still executed by executor is not valid anymore
+    btstack_crypto_ecc_p256_job_discard = btstack_crypto_ecc_p256_job_active;
+#endif
+#ifdef ENABLE_SOFTWARE_AES128
+    btstack_crypto_aes128_key_schedules_clear();
 #endif
     btstack_crypto_wait_for_hci_result = false;
     btstack_crypto_operations = NULL;
@@ -1390,6 +1817,21 @@ void btstack_crypto_deinit(void) {
     btstack_crypto_initialized = false;
 }
 
+void btstack_crypto_ecc_p256_set_executor(const btstack_crypto_ecc_p256_executor_t * executor){
+#ifdef USE_SOFTWARE_ECC_P256_IMPLEMENTATION
+    btstack_crypto_ecc_p256_executor = executor;
+#if BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE > 0
+    // key pool is only used with executor
+    if (executor == NULL){
+        memset(btstack_crypto_ecc_p256_key_pool, 0, sizeof(btstack_crypto_ecc_p256_key_pool));
+        btstack_crypto_ecc_p256_key_pool_count = 0;
+    }
+#endif
+#else
+    UNUSED(executor);
+#endif
+}
+
 // PTS only
 void btstack_crypto_ecc_p256_set_key(const uint8_t * public_key, const uint8_t * private_key){
 #ifdef USE_SOFTWARE_ECC_P256_IMPLEMENTATION
@@ -1404,6 +1846,9 @@ void btstack_crypto_ecc_p256_set_key(const uint8_t * public_key, const uint8_t *
 
 // Unit testing
 int btstack_crypto_idle(void){
+#ifdef USE_SOFTWARE_ECC_P256_IMPLEMENTATION
+    if (btstack_crypto_ecc_p256_job_active) return 0;
+#endif
     return btstack_linked_list_empty(&btstack_crypto_operations);
 }
 void btstack_crypto_reset(void){
@@ -101,6 +101,14 @@ typedef struct {
     uint8_t * dhkey;
 } btstack_crypto_ecc_p256_t;
 
+/**
+ * Executor for software ECC P-256 operations
+ * execute runs job(context) e.g. on a worker thread and afterwards done(context) on the main thread
+ */
+typedef struct {
+    void (*execute)(void (*job)(void * context), void (*done)(void * context), void * context);
+} btstack_crypto_ecc_p256_executor_t;
+
 typedef enum {
     CCM_CALCULATE_X1,
     CCM_W4_X1,
@@ -224,6 +232,14 @@ void btstack_crypto_ecc_p256_calculate_dhkey(btstack_crypto_ecc_p256_t * request
  */
 int btstack_crypto_ecc_p256_validate_public_key(const uint8_t * public_key);
 
+/**
+ * Set executor for software ECC P-256 operations, e.g. to run them on a worker thread
+ * @note If set, BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE key pairs are precomputed while idle
+ * @note Ignored if LE Controller is used for ECC
+ * @param executor or NULL to run ECC operations on the main thread
+ */
+void btstack_crypto_ecc_p256_set_executor(const btstack_crypto_ecc_p256_executor_t * executor);
+
 /** 
  * Initialize Counter with CBC-MAC for Bluetooth Mesh (L=2)
  * @param request
@@ -283,6 +299,53 @@ void btstack_crypto_ccm_decrypt_block(btstack_crypto_ccm_t * request, uint16_t l
  * @param ciphertext (16 bytes)
  */
 void btstack_aes128_calc(const uint8_t * key, const uint8_t * plaintext, uint8_t * ciphertext);
+
+/**
+ * Calculate AES128-CMAC for complete message synchronously
+ * @note Only available with software or custom AES128 implementation
+ * @param key (16 bytes)
+ * @param size of message
+ * @param message
+ * @param hash (16 bytes)
+ */
+void btstack_aes128_cmac_calc(const uint8_t * key, uint16_t size, const uint8_t * message, uint8_t * hash);
+
+/**
+ * Encrypt complete message with Counter with CBC-MAC for Bluetooth Mesh (L=2) synchronously
+ * @note Only available with software or custom AES128 implementation
+ * @param key (16 bytes)
+ * @param nonce (13 bytes)
+ * @param additional_authenticated_data or NULL
+ * @param additional_authenticated_data_len must be smaller than 0xff00
+ * @param plaintext
+ * @param len of plaintext
+ * @param ciphertext (len bytes), can be identical to plaintext
+ * @param authentication_value (auth_len bytes)
+ * @param auth_len
+ */
+void btstack_aes128_ccm_encrypt(const uint8_t * key, const uint8_t * nonce,
+                                const uint8_t * additional_authenticated_data, uint16_t additional_authenticated_data_len,
+                                const uint8_t * plaintext, uint16_t len, uint8_t * ciphertext,
+                                uint8_t * authentication_value, uint8_t auth_len);
+
+/**
+ * Decrypt complete message with Counter with CBC-MAC for Bluetooth Mesh (L=2) synchronously
+ * @note Only available with software or custom AES128 implementation
+ * @note Caller has to compare authentication_value with received MIC
+ * @param key (16 bytes)
+ * @param nonce (13 bytes)
+ * @param additional_authenticated_data or NULL
+ * @param additional_authenticated_data_len must be smaller than 0xff00
+ * @param ciphertext
+ * @param len of ciphertext
+ * @param plaintext (len bytes), can be identical to ciphertext
+ * @param authentication_value (auth_len bytes)
+ * @param auth_len
+ */
+void btstack_aes128_ccm_decrypt(const uint8_t * key, const uint8_t * nonce,
+                                const uint8_t * additional_authenticated_data, uint16_t additional_authenticated_data_len,
+                                const uint8_t * ciphertext, uint16_t len, uint8_t * plaintext,
+                                uint8_t * authentication_value, uint8_t auth_len);
 #endif
 
 /**
@@ -3681,6 +3681,34 @@ typedef uint8_t sm_key_t[16];
  */
 #define PBAP_SUBEVENT_CARD_RESULT                                          0x06u
 
+/**
+ * @format 12
+ * @param subevent_code
+ * @param goep_cid
+ */
+#define PBAP_SUBEVENT_VCARD_BEGIN                                          0x07u
+
+/**
+ * @format 121JVJVJV
+ * @param subevent_code
+ * @param goep_cid
+ * @param value_complete - 0 if further fragments of the property value follow
+ * @param name_len
+ * @param name
+ * @param params_len
+ * @param params
+ * @param value_len
+ * @param value
+ */
+#define PBAP_SUBEVENT_VCARD_PROPERTY                                       0x08u
+
+/**
+ * @format 12
+ * @param subevent_code
+ * @param goep_cid
+ */
+#define PBAP_SUBEVENT_VCARD_END                                            0x09u
+
 /**
  * @format 121
  * @param subevent_code
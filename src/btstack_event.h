@@ -11878,6 +11878,99 @@ static inline const uint8_t * pbap_subevent_card_result_get_handle(const uint8_t
     return &event[6u + event[5] + 1u];
 }
 
+/**
+ * @brief Get field goep_cid from event PBAP_SUBEVENT_VCARD_BEGIN
+ * @param event packet
+ * @return goep_cid
+ * @note: btstack_type 2
+ */
+static inline uint16_t pbap_subevent_vcard_begin_get_goep_cid(const uint8_t * event){
+    return little_endian_read_16(event, 3);
+}
+
+/**
+ * @brief Get field goep_cid from event PBAP_SUBEVENT_VCARD_PROPERTY
+ * @param event packet
+ * @return goep_cid
+ * @note: btstack_type 2
+ */
+static inline uint16_t pbap_subevent_vcard_property_get_goep_cid(const uint8_t * event){
+    return little_endian_read_16(event, 3);
+}
+/**
+ * @brief Get field value_complete from event PBAP_SUBEVENT_VCARD_PROPERTY
+ * @param event packet
+ * @return value_complete
+ * @note: btstack_type 1
+ */
+static inline uint8_t pbap_subevent_vcard_property_get_value_complete(const uint8_t * event){
+    return event[5];
+}
+/**
+ * @brief Get field name_len from event PBAP_SUBEVENT_VCARD_PROPERTY
+ * @param event packet
+ * @return name_len
+ * @note: btstack_type J
+ */
+static inline uint8_t pbap_subevent_vcard_property_get_name_len(const uint8_t * event){
+    return event[6];
+}
+/**
+ * @brief Get field name from event PBAP_SUBEVENT_VCARD_PROPERTY
+ * @param event packet
+ * @return name
+ * @note: btstack_type V
+ */
+static inline const uint8_t * pbap_subevent_vcard_property_get_name(const uint8_t * event){
+    return &event[7];
+}
+/**
+ * @brief Get field params_len from event PBAP_SUBEVENT_VCARD_PROPERTY
+ * @param event packet
+ * @return params_len
+ * @note: btstack_type J
+ */
+static inline uint8_t pbap_subevent_vcard_property_get_params_len(const uint8_t * event){
+    return event[7u + event[6]];
+}
+/**
+ * @brief Get field params from event PBAP_SUBEVENT_VCARD_PROPERTY
+ * @param event packet
+ * @return params
+ * @note: btstack_type V
+ */
+static inline const uint8_t * pbap_subevent_vcard_property_get_params(const uint8_t * event){
+    return &event[7u + event[6] + 1u];
+}
+/**
+ * @brief Get field value_len from event PBAP_SUBEVENT_VCARD_PROPERTY
+ * @param event packet
+ * @return value_len
+ * @note: btstack_type J
+ */
+static inline uint8_t pbap_subevent_vcard_property_get_value_len(const uint8_t * event){
+    return event[7u + event[6] + 1u + event[7u + event[6]]];
+}
+/**
+ * @brief Get field value from event PBAP_SUBEVENT_VCARD_PROPERTY
+ * @param event packet
+ * @return value
+ * @note: btstack_type V
+ */
+static inline const uint8_t * pbap_subevent_vcard_property_get_value(const uint8_t * event){
+    return &event[7u + event[6] + 1u + event[7u + event[6]] + 1u];
+}
+
+/**
+ * @brief Get field goep_cid from event PBAP_SUBEVENT_VCARD_END
+ * @param event packet
+ * @return goep_cid
+ * @note: btstack_type 2
+ */
+static inline uint16_t pbap_subevent_vcard_end_get_goep_cid(const uint8_t * event){
+    return little_endian_read_16(event, 3);
+}
+
 /**
  * @brief Get field goep_cid from event PBAP_SUBEVENT_RESET_MISSED_CALLS
  * @param event packet
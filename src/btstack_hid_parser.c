@@ -555,3 +555,193 @@ bool btstack_hid_report_id_declared(uint16_t hid_descriptor_len, const uint8_t *
     }
     return false;
 }
+
+// HID Report Layout
+
+void btstack_hid_layout_init(btstack_hid_layout_t * layout, btstack_hid_layout_report_t * reports, uint8_t max_reports, btstack_hid_layout_field_t * fields, uint16_t max_fields){
+    memset(layout, 0, sizeof(btstack_hid_layout_t));
+    layout->reports     = reports;
+    layout->max_reports = max_reports;
+    layout->fields      = fields;
+    layout->max_fields  = max_fields;
+}
+
+// run parser over empty report with given report id and record position and properties of each field
+static bool btstack_hid_layout_compile_report(btstack_hid_layout_t * layout, const uint8_t * hid_descriptor, uint16_t hid_descriptor_len, uint8_t report_id){
+    // parser reads up to report[report_len]
+    uint8_t report[2] = { report_id, 0 };
+    btstack_hid_parser_t parser;
+    btstack_hid_parser_init(&parser, hid_descriptor, hid_descriptor_len, layout->report_type, report, 1);
+    uint16_t first_field = layout->num_fields;
+    while (btstack_hid_parser_has_more(&parser)){
+        if (layout->num_fields >= layout->max_fields){
+            return false;
+        }
+        btstack_hid_layout_field_t * field = &layout->fields[layout->num_fields++];
+        field->bit_offset      = parser.report_pos_in_bit;
+        field->bit_size        = parser.global_report_size;
+        field->flags           = 0;
+        if ((parser.descriptor_item.item_value & 2) != 0){
+            field->flags |= BTSTACK_HID_LAYOUT_FIELD_FLAG_VARIABLE;
+        }
+        if (parser.global_logical_minimum < 0){
+            field->flags |= BTSTACK_HID_LAYOUT_FIELD_FLAG_SIGNED;
+        }
+        field->usage_page      = (uint16_t) (parser.usage_minimum >> 16);
+        field->usage           = (uint16_t) (parser.usage_minimum & 0xffffu);
+        field->logical_minimum = parser.global_logical_minimum;
+        field->logical_maximum = parser.global_logical_maximum;
+        uint16_t usage_page;
+        uint16_t usage;
+        int32_t  value;
+        btstack_hid_parser_get_field(&parser, &usage_page, &usage, &value);
+    }
+    uint16_t report_bits = parser.report_pos_in_bit;
+    if (layout->report_id_declared && (report_bits >= 8u)){
+        report_bits -= 8u;
+    }
+    uint16_t num_fields = layout->num_fields - first_field;
+    // report id not used for this report type
+    if ((num_fields == 0u) && (report_bits == 0u)){
+        return true;
+    }
+    if (layout->num_reports >= layout->max_reports){
+        return false;
+    }
+    btstack_hid_layout_report_t * layout_report = &layout->reports[layout->num_reports++];
+    layout_report->report_id   = report_id;
+    layout_report->size        = (report_bits + 7u) / 8u;
+    layout_report->first_field = first_field;
+    layout_report->num_fields  = num_fields;
+    return true;
+}
+
+bool btstack_hid_layout_compile(btstack_hid_layout_t * layout, const uint8_t * hid_descriptor, uint16_t hid_descriptor_len, hid_report_type_t hid_report_type){
+    layout->report_type = hid_report_type;
+    layout->report_id_declared = btstack_hid_report_id_declared(hid_descriptor_len, hid_descriptor);
+    layout->num_reports = 0;
+    layout->num_fields  = 0;
+
+    bool ok = true;
+    if (layout->report_id_declared == false){
+        ok = btstack_hid_layout_compile_report(layout, hid_descriptor, hid_descriptor_len, 0);
+    } else {
+        // compile each report id once, report ids might be declared multiple times
+        const uint8_t * descriptor = hid_descriptor;
+        uint16_t descriptor_len = hid_descriptor_len;
+        uint8_t  report_ids_compiled[256 / 8];
+        memset(report_ids_compiled, 0, sizeof(report_ids_compiled));
+        while (ok && (descriptor_len > 0u)){
+            hid_descriptor_item_t item;
+            if (btstack_hid_parse_descriptor_item(&item, descriptor, descriptor_len) == false){
+                break;
+            }
+            if ((item.item_type == Global) && (item.item_tag == ReportID)){
+                uint8_t report_id = (uint8_t) item.item_value;
+                uint8_t report_id_mask = 1u << (report_id & 7u);
+                if ((report_ids_compiled[report_id >> 3] & report_id_mask) == 0u){
+                    report_ids_compiled[report_id >> 3] |= report_id_mask;
+                    ok = btstack_hid_layout_compile_report(layout, hid_descriptor, hid_descriptor_len, report_id);
+                }
+            }
+            descriptor_len -= item.item_size;
+            descriptor     += item.item_size;
+        }
+    }
+
+    if (ok == false){
+        log_error("HID Report Layout: more than %u reports or %u fields", layout->max_reports, layout->max_fields);
+        layout->num_reports = 0;
+        layout->num_fields  = 0;
+    }
+    return ok;
+}
+
+const btstack_hid_layout_report_t * btstack_hid_layout_get_report(const btstack_hid_layout_t * layout, uint8_t report_id){
+    uint8_t i;
+    for (i = 0; i < layout->num_reports; i++){
+        if (layout->reports[i].report_id == report_id){
+            return &layout->reports[i];
+        }
+    }
+    return NULL;
+}
+
+uint16_t btstack_hid_layout_get_report_size(const btstack_hid_layout_t * layout, uint8_t report_id){
+    const btstack_hid_layout_report_t * report = btstack_hid_layout_get_report(layout, report_id);
+    if (report == NULL){
+        return 0;
+    }
+    return report->size;
+}
+
+const btstack_hid_layout_field_t * btstack_hid_layout_find_field(const btstack_hid_layout_t * layout, uint8_t report_id, uint16_t usage_page, uint16_t usage){
+    const btstack_hid_layout_report_t * report = btstack_hid_layout_get_report(layout, report_id);
+    if (report == NULL){
+        return NULL;
+    }
+    uint16_t i;
+    for (i = report->first_field; i < (report->first_field + report->num_fields); i++){
+        const btstack_hid_layout_field_t * field = &layout->fields[i];
+        if ((field->usage_page == usage_page) && (field->usage == usage) && ((field->flags & BTSTACK_HID_LAYOUT_FIELD_FLAG_VARIABLE) != 0u)){
+            return field;
+        }
+    }
+    return NULL;
+}
+
+int32_t btstack_hid_layout_get_value(const btstack_hid_layout_field_t * field, const uint8_t * hid_report, uint16_t hid_report_len){
+    // read up to 5 bytes that contain the field
+    uint16_t pos_start = field->bit_offset >> 3;
+    uint16_t pos_end   = btstack_min((field->bit_offset + field->bit_size + 7u) >> 3, hid_report_len);
+    uint64_t multi_byte_value = 0;
+    uint16_t pos;
+    for (pos = pos_start; pos < pos_end; pos++){
+        multi_byte_value |= ((uint64_t) hid_report[pos]) << ((pos - pos_start) * 8u);
+    }
+    uint32_t mask = (field->bit_size < 32u) ? ((1u << field->bit_size) - 1u) : 0xffffffffu;
+    uint32_t unsigned_value = (uint32_t) (multi_byte_value >> (field->bit_offset & 0x07u)) & mask;
+    if ((field->flags & BTSTACK_HID_LAYOUT_FIELD_FLAG_VARIABLE) == 0u){
+        return (int32_t) unsigned_value;
+    }
+    if (((field->flags & BTSTACK_HID_LAYOUT_FIELD_FLAG_SIGNED) != 0u) && (field->bit_size > 0u) && (unsigned_value & (1u << (field->bit_size - 1u)))){
+        return (int32_t) (unsigned_value | ~mask);
+    }
+    return (int32_t) unsigned_value;
+}
+
+void btstack_hid_layout_iterator_init(btstack_hid_layout_iterator_t * iterator, const btstack_hid_layout_t * layout, const uint8_t * hid_report, uint16_t hid_report_len){
+    memset(iterator, 0, sizeof(btstack_hid_layout_iterator_t));
+    const btstack_hid_layout_report_t * report = NULL;
+    if (layout->report_id_declared){
+        if (hid_report_len > 0u){
+            report = btstack_hid_layout_get_report(layout, hid_report[0]);
+        }
+    } else if (layout->num_reports > 0u){
+        report = &layout->reports[0];
+    }
+    if (report == NULL){
+        return;
+    }
+    iterator->field      = &layout->fields[report->first_field];
+    iterator->fields_end = &layout->fields[report->first_field + report->num_fields];
+    iterator->report     = hid_report;
+    iterator->report_len = hid_report_len;
+}
+
+bool btstack_hid_layout_iterator_has_more(const btstack_hid_layout_iterator_t * iterator){
+    return iterator->field < iterator->fields_end;
+}
+
+void btstack_hid_layout_iterator_get_field(btstack_hid_layout_iterator_t * iterator, uint16_t * usage_page, uint16_t * usage, int32_t * value){
+    const btstack_hid_layout_field_t * field = iterator->field++;
+    int32_t field_value = btstack_hid_layout_get_value(field, iterator->report, iterator->report_len);
+    *usage_page = field->usage_page;
+    if ((field->flags & BTSTACK_HID_LAYOUT_FIELD_FLAG_VARIABLE) != 0u){
+        *usage = field->usage;
+        *value = field_value;
+    } else {
+        *usage = (uint16_t) field_value;
+        *value = 1;
+    }
+}
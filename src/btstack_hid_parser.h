@@ -40,6 +40,9 @@
  *
  * Single-pass HID Report Parser: HID Report is directly parsed without preprocessing HID Descriptor to minimize memory.
  *
+ * For high report rates, the HID Descriptor can be compiled once into a HID Report Layout, a table of fields per report ID,
+ * which allows to extract fields without parsing the HID Descriptor for each report.
+ *
  */
 
 #ifndef BTSTACK_HID_PARSER_H
@@ -151,6 +154,59 @@ typedef struct {
     uint8_t         global_report_id;
 } btstack_hid_parser_t;
 
+// Precompiled report layout
+
+#ifndef HID_REPORT_LAYOUT_MAX_REPORTS
+#define HID_REPORT_LAYOUT_MAX_REPORTS 8
+#endif
+
+#ifndef HID_REPORT_LAYOUT_MAX_FIELDS
+#define HID_REPORT_LAYOUT_MAX_FIELDS 64
+#endif
+
+#define BTSTACK_HID_LAYOUT_FIELD_FLAG_VARIABLE 0x01u
+#define BTSTACK_HID_LAYOUT_FIELD_FLAG_SIGNED   0x02u
+
+typedef struct {
+    // position in report, including report id
+    uint16_t bit_offset;
+    uint8_t  bit_size;
+    uint8_t  flags;
+    // for array fields, usage is provided by report value
+    uint16_t usage_page;
+    uint16_t usage;
+    int32_t  logical_minimum;
+    int32_t  logical_maximum;
+} btstack_hid_layout_field_t;
+
+typedef struct {
+    uint8_t  report_id;
+    // report size in bytes without report id
+    uint16_t size;
+    uint16_t first_field;
+    uint16_t num_fields;
+} btstack_hid_layout_report_t;
+
+typedef struct {
+    hid_report_type_t report_type;
+    bool              report_id_declared;
+
+    // provided by caller
+    btstack_hid_layout_report_t * reports;
+    uint8_t                       max_reports;
+    uint8_t                       num_reports;
+    btstack_hid_layout_field_t  * fields;
+    uint16_t                      max_fields;
+    uint16_t                      num_fields;
+} btstack_hid_layout_t;
+
+typedef struct {
+    const btstack_hid_layout_field_t * field;
+    const btstack_hid_layout_field_t * fields_end;
+    const uint8_t * report;
+    uint16_t        report_len;
+} btstack_hid_layout_iterator_t;
+
 /* API_START */
 
 /**
@@ -214,6 +270,87 @@ hid_report_id_status_t btstack_hid_id_valid(int report_id, uint16_t hid_descript
  * @return true if report ID declared in descriptor
  */
 bool btstack_hid_report_id_declared(uint16_t hid_descriptor_len, const uint8_t * hid_descriptor);
+
+/**
+ * @brief Initialize HID Report Layout with storage for compiled reports and fields
+ * @param layout
+ * @param reports storage
+ * @param max_reports
+ * @param fields storage
+ * @param max_fields
+ */
+void btstack_hid_layout_init(btstack_hid_layout_t * layout, btstack_hid_layout_report_t * reports, uint8_t max_reports, btstack_hid_layout_field_t * fields, uint16_t max_fields);
+
+/**
+ * @brief Compile HID Descriptor into table of fields for each report ID of the given report type.
+ *        Fields are listed in the order provided by btstack_hid_parser_get_field
+ * @param layout
+ * @param hid_descriptor
+ * @param hid_descriptor_len
+ * @param hid_report_type
+ * @return true if descriptor was compiled, false if there's not enough storage for all reports and fields
+ */
+bool btstack_hid_layout_compile(btstack_hid_layout_t * layout, const uint8_t * hid_descriptor, uint16_t hid_descriptor_len, hid_report_type_t hid_report_type);
+
+/**
+ * @brief Get compiled report for report ID
+ * @param layout
+ * @param report_id, 0 if report ID is not declared in descriptor
+ * @return report or NULL if not found
+ */
+const btstack_hid_layout_report_t * btstack_hid_layout_get_report(const btstack_hid_layout_t * layout, uint8_t report_id);
+
+/**
+ * @brief Get report size for report ID, same as btstack_hid_get_report_size_for_id
+ * @param layout
+ * @param report_id
+ * @return report size in bytes or 0 if not found
+ */
+uint16_t btstack_hid_layout_get_report_size(const btstack_hid_layout_t * layout, uint8_t report_id);
+
+/**
+ * @brief Find first field with given usage in report
+ * @param layout
+ * @param report_id
+ * @param usage_page
+ * @param usage
+ * @return field or NULL if not found
+ */
+const btstack_hid_layout_field_t * btstack_hid_layout_find_field(const btstack_hid_layout_t * layout, uint8_t report_id, uint16_t usage_page, uint16_t usage);
+
+/**
+ * @brief Extract value of field from report. For array fields, the usage is returned.
+ * @param field
+ * @param hid_report including report ID if declared
+ * @param hid_report_len
+ * @return value, bits beyond report length are read as 0
+ */
+int32_t btstack_hid_layout_get_value(const btstack_hid_layout_field_t * field, const uint8_t * hid_report, uint16_t hid_report_len);
+
+/**
+ * @brief Initialize iterator over all fields of a report
+ * @param iterator
+ * @param layout
+ * @param hid_report including report ID if declared
+ * @param hid_report_len
+ */
+void btstack_hid_layout_iterator_init(btstack_hid_layout_iterator_t * iterator, const btstack_hid_layout_t * layout, const uint8_t * hid_report, uint16_t hid_report_len);
+
+/**
+ * @brief Checks if more fields are available
+ * @param iterator
+ */
+bool btstack_hid_layout_iterator_has_more(const btstack_hid_layout_iterator_t * iterator);
+
+/**
+ * @brief Get next field, same as btstack_hid_parser_get_field
+ * @param iterator
+ * @param usage_page
+ * @param usage
+ * @param value provided in HID report
+ */
+void btstack_hid_layout_iterator_get_field(btstack_hid_layout_iterator_t * iterator, uint16_t * usage_page, uint16_t * usage, int32_t * value);
+
 /* API_END */
 
 #if defined __cplusplus
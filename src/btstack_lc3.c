@@ -43,8 +43,23 @@
 
 #define BTSTACK_FILE__ "btstack_lc3.c"
 
+#include <stddef.h>
+
 #include "btstack_lc3.h"
 #include "btstack_debug.h"
+#include "bluetooth.h"
+
+static const btstack_lc3_executor_t * btstack_lc3_executor;
+
+typedef struct {
+    const btstack_lc3_decoder_t * decoder;
+    btstack_lc3_decoder_frame_t * frames;
+} btstack_lc3_decoder_batch_t;
+
+typedef struct {
+    const btstack_lc3_encoder_t * encoder;
+    btstack_lc3_encoder_frame_t * frames;
+} btstack_lc3_encoder_batch_t;
 
 uint16_t btstack_lc3_frame_duration_in_us(btstack_lc3_frame_duration_t frame_duration){
     switch (frame_duration){
@@ -65,3 +80,54 @@ uint16_t btstack_lc3_samples_per_frame(uint32_t sample_rate, btstack_lc3_frame_d
     // assume sample rate is x 1000 hz
     return (sample_rate / 1000) * (btstack_lc3_frame_duration_in_us(frame_duration) / 100) / 10;
 }
+
+void btstack_lc3_set_executor(const btstack_lc3_executor_t * executor){
+    btstack_lc3_executor = executor;
+}
+
+static void btstack_lc3_run(void (*job)(void * context, uint16_t index), void * context, uint16_t num_jobs){
+    if ((btstack_lc3_executor == NULL) || (num_jobs < 2u)){
+        uint16_t i;
+        for (i = 0; i < num_jobs; i++){
+            (*job)(context, i);
+        }
+    } else {
+        (*btstack_lc3_executor->run)(job, context, num_jobs);
+    }
+}
+
+static void btstack_lc3_decode_job(void * context, uint16_t index){
+    btstack_lc3_decoder_batch_t * batch = (btstack_lc3_decoder_batch_t *) context;
+    btstack_lc3_decoder_frame_t * frame = &batch->frames[index];
+    frame->status = (*batch->decoder->decode_signed_16)(frame->context, frame->bytes, frame->BFI, frame->pcm_out, frame->stride, &frame->BEC_detect);
+}
+
+static void btstack_lc3_encode_job(void * context, uint16_t index){
+    btstack_lc3_encoder_batch_t * batch = (btstack_lc3_encoder_batch_t *) context;
+    btstack_lc3_encoder_frame_t * frame = &batch->frames[index];
+    frame->status = (*batch->encoder->encode_signed_16)(frame->context, frame->pcm_in, frame->stride, frame->bytes);
+}
+
+uint8_t btstack_lc3_decode_signed_16_batch(const btstack_lc3_decoder_t * decoder, btstack_lc3_decoder_frame_t * frames, uint16_t num_frames){
+    btstack_lc3_decoder_batch_t batch = { decoder, frames };
+    btstack_lc3_run(&btstack_lc3_decode_job, &batch, num_frames);
+    uint16_t i;
+    for (i = 0; i < num_frames; i++){
+        if (frames[i].status != ERROR_CODE_SUCCESS){
+            return frames[i].status;
+        }
+    }
+    return ERROR_CODE_SUCCESS;
+}
+
+uint8_t btstack_lc3_encode_signed_16_batch(const btstack_lc3_encoder_t * encoder, btstack_lc3_encoder_frame_t * frames, uint16_t num_frames){
+    btstack_lc3_encoder_batch_t batch = { encoder, frames };
+    btstack_lc3_run(&btstack_lc3_encode_job, &batch, num_frames);
+    uint16_t i;
+    for (i = 0; i < num_frames; i++){
+        if (frames[i].status != ERROR_CODE_SUCCESS){
+            return frames[i].status;
+        }
+    }
+    return ERROR_CODE_SUCCESS;
+}
@@ -125,6 +125,39 @@ typedef struct {
 
 } btstack_lc3_encoder_t;
 
+/**
+ * LC3 Frame for batch decoding, BEC_detect and status are set by btstack_lc3_decode_signed_16_batch
+ */
+typedef struct {
+    void *          context;
+    const uint8_t * bytes;
+    uint8_t         BFI;
+    int16_t *       pcm_out;
+    uint16_t        stride;
+    uint8_t         BEC_detect;
+    uint8_t         status;
+} btstack_lc3_decoder_frame_t;
+
+/**
+ * LC3 Frame for batch encoding, status is set by btstack_lc3_encode_signed_16_batch
+ */
+typedef struct {
+    void *          context;
+    const int16_t * pcm_in;
+    uint16_t        stride;
+    uint8_t *       bytes;
+    uint8_t         status;
+} btstack_lc3_encoder_frame_t;
+
+/**
+ * Executor for LC3 frame batches
+ * run calls job(context, index) for all index < num_jobs, e.g. on a pool of worker threads, and returns
+ * after all jobs have completed
+ */
+typedef struct {
+    void (*run)(void (*job)(void * context, uint16_t index), void * context, uint16_t num_jobs);
+} btstack_lc3_executor_t;
+
 /**
  * @brief Map enum to ISO Interval in us
  * @param frame_duration enum
@@ -140,6 +173,34 @@ uint16_t btstack_lc3_frame_duration_in_us(btstack_lc3_frame_duration_t frame_dur
  */
 uint16_t btstack_lc3_samples_per_frame(uint32_t sample_rate, btstack_lc3_frame_duration_t frame_duration);
 
+/**
+ * @brief Set executor for LC3 frame batches, e.g. to decode multiple channels in parallel
+ * @param executor or NULL to process frames on the calling thread
+ */
+void btstack_lc3_set_executor(const btstack_lc3_executor_t * executor);
+
+/**
+ * @brief Decode LC3 Frames of multiple channels, each with its own decoder context
+ * @note returns after all frames have been decoded, results are stored in the frames array
+ * @note with executor, frames are decoded in parallel. Decoder instances must not share state
+ * @param decoder
+ * @param frames
+ * @param num_frames
+ * @return status of first failed frame or ERROR_CODE_SUCCESS
+ */
+uint8_t btstack_lc3_decode_signed_16_batch(const btstack_lc3_decoder_t * decoder, btstack_lc3_decoder_frame_t * frames, uint16_t num_frames);
+
+/**
+ * @brief Encode LC3 Frames of multiple channels, each with its own encoder context
+ * @note returns after all frames have been encoded, results are stored in the frames array
+ * @note with executor, frames are encoded in parallel. Encoder instances must not share state
+ * @param encoder
+ * @param frames
+ * @param num_frames
+ * @return status of first failed frame or ERROR_CODE_SUCCESS
+ */
+uint8_t btstack_lc3_encode_signed_16_batch(const btstack_lc3_encoder_t * encoder, btstack_lc3_encoder_frame_t * frames, uint16_t num_frames);
+
 /* API_END */
 
 #if defined __cplusplus
@@ -46,8 +46,6 @@
 
 #define MAX_SAMPLES_PER_FRAME 480
 
-static uint8_t lc3plus_farunhofer_scratch[LC3PLUS_DEC_MAX_SCRATCH_SIZE];
-
 static uint16_t lc3_frame_duration_in_us(btstack_lc3_frame_duration_t frame_duration){
     switch (frame_duration) {
         case BTSTACK_LC3_FRAME_DURATION_7500US:
@@ -112,7 +110,7 @@ static uint8_t lc3plus_fraunhofer_decoder_decode_signed_16(void * context, const
         byte_count = 0;
     }
 
-    LC3PLUS_Error error = lc3plus_dec16(decoder, (void*) bytes, byte_count, output_samples, lc3plus_farunhofer_scratch, BFI);
+    LC3PLUS_Error error = lc3plus_dec16(decoder, (void*) bytes, byte_count, output_samples, instance->scratch, BFI);
 
     // store samples
     if (stride > 1){
@@ -151,7 +149,7 @@ static uint8_t lc3plus_fraunhofer_decoder_decode_signed_24(void * context, const
         byte_count = 0;
     }
 
-    LC3PLUS_Error error = lc3plus_dec24(decoder, (void *) bytes, byte_count, output_samples, lc3plus_farunhofer_scratch, BFI);
+    LC3PLUS_Error error = lc3plus_dec24(decoder, (void *) bytes, byte_count, output_samples, instance->scratch, BFI);
 
     // map error
     switch (error){
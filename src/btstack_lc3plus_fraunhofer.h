@@ -57,6 +57,8 @@ typedef struct {
     uint32_t                        sample_rate;
     // decoder must be 4-byte aligned
     uint8_t                         decoder[LC3PLUS_DEC_MAX_SIZE];
+    // per instance scratch buffer allows to decode multiple channels in parallel
+    uint8_t                         scratch[LC3PLUS_DEC_MAX_SCRATCH_SIZE];
 } btstack_lc3plus_fraunhofer_decoder_t;
 
 typedef struct {
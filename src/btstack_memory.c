@@ -103,6 +103,67 @@ static void btstack_memory_tracking_remove(btstack_memory_buffer_t * buffer){
 }
 #endif
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static uint32_t (*btstack_memory_statistics_get_time_us)(void);
+static void btstack_memory_statistics_clear(void);
+
+static void btstack_memory_statistics_track_get(btstack_memory_statistics_t * statistics, const void * buffer){
+    if (buffer == NULL){
+        statistics->failed++;
+        log_error("%s: no buffer available, %u of %u in use", statistics->name, statistics->current, statistics->pool_size);
+        return;
+    }
+    statistics->allocations++;
+    statistics->current++;
+    if (statistics->current > statistics->peak){
+        statistics->peak = statistics->current;
+    }
+}
+
+static void btstack_memory_statistics_track_free(btstack_memory_statistics_t * statistics){
+    if (statistics->current > 0u){
+        statistics->current--;
+    }
+}
+
+#ifdef HAVE_MALLOC
+static uint32_t btstack_memory_statistics_time_us(void){
+    if (btstack_memory_statistics_get_time_us == NULL){
+        return 0;
+    }
+    return (*btstack_memory_statistics_get_time_us)();
+}
+
+static void btstack_memory_statistics_track_time(btstack_memory_statistics_t * statistics, uint32_t start_us){
+    if (btstack_memory_statistics_get_time_us == NULL){
+        return;
+    }
+    uint32_t duration_us = btstack_memory_statistics_time_us() - start_us;
+    statistics->alloc_time_us_total += duration_us;
+    if (duration_us > statistics->alloc_time_us_max){
+        statistics->alloc_time_us_max = duration_us;
+    }
+}
+#endif
+
+#define BTSTACK_MEMORY_STATISTICS_GET(name, buffer)   btstack_memory_statistics_track_get(&name##_statistics, buffer)
+#define BTSTACK_MEMORY_STATISTICS_FREE(name)          btstack_memory_statistics_track_free(&name##_statistics)
+#define BTSTACK_MEMORY_STATISTICS_TIME_START()        btstack_memory_statistics_time_us()
+#define BTSTACK_MEMORY_STATISTICS_TIME_STOP(name, start_us) btstack_memory_statistics_track_time(&name##_statistics, start_us)
+#else
+#define BTSTACK_MEMORY_STATISTICS_GET(name, buffer)   (void)(buffer)
+#define BTSTACK_MEMORY_STATISTICS_FREE(name)
+#define BTSTACK_MEMORY_STATISTICS_TIME_START()        0
+#define BTSTACK_MEMORY_STATISTICS_TIME_STOP(name, start_us) (void)(start_us)
+#endif
+
+#ifdef ENABLE_BTSTACK_MEMORY_SLAB
+// storage for all pools is provided by a single contiguous arena, see below
+#define BTSTACK_MEMORY_STORAGE(name) btstack_memory_arena.name
+#else
+#define BTSTACK_MEMORY_STORAGE(name) name##_storage
+#endif
+
 void btstack_memory_deinit(void){
 #ifdef HAVE_MALLOC
     while (btstack_memory_malloc_buffers != NULL){
@@ -113,6 +174,9 @@ void btstack_memory_deinit(void){
     }
     btstack_assert(btstack_memory_malloc_counter == 0);
 #endif
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+    btstack_memory_statistics_clear();
+#endif
 }
 
 
@@ -127,20 +191,31 @@ void btstack_memory_deinit(void){
 
 #ifdef MAX_NR_HCI_CONNECTIONS
 #if MAX_NR_HCI_CONNECTIONS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static hci_connection_t hci_connection_storage[MAX_NR_HCI_CONNECTIONS];
+#endif
 static btstack_memory_pool_t hci_connection_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hci_connection_statistics = { "hci_connection", MAX_NR_HCI_CONNECTIONS, 0, 0, 0, 0, 0, 0 };
+#endif
 hci_connection_t * btstack_memory_hci_connection_get(void){
     void * buffer = btstack_memory_pool_get(&hci_connection_pool);
     if (buffer){
         memset(buffer, 0, sizeof(hci_connection_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(hci_connection, buffer);
     return (hci_connection_t *) buffer;
 }
 void btstack_memory_hci_connection_free(hci_connection_t *hci_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(hci_connection);
     btstack_memory_pool_free(&hci_connection_pool, hci_connection);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hci_connection_statistics = { "hci_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 hci_connection_t * btstack_memory_hci_connection_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(hci_connection, NULL);
     return NULL;
 }
 void btstack_memory_hci_connection_free(hci_connection_t *hci_connection){
@@ -154,8 +229,15 @@ typedef struct {
     hci_connection_t data;
 } btstack_memory_hci_connection_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hci_connection_statistics = { "hci_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 hci_connection_t * btstack_memory_hci_connection_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_hci_connection_t * buffer = (btstack_memory_hci_connection_t *) malloc(sizeof(btstack_memory_hci_connection_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(hci_connection, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(hci_connection, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_hci_connection_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -165,6 +247,7 @@ hci_connection_t * btstack_memory_hci_connection_get(void){
     }
 }
 void btstack_memory_hci_connection_free(hci_connection_t *hci_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(hci_connection);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) hci_connection)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -185,20 +268,31 @@ void btstack_memory_hci_connection_free(hci_connection_t *hci_connection){
 
 #ifdef MAX_NR_L2CAP_SERVICES
 #if MAX_NR_L2CAP_SERVICES > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static l2cap_service_t l2cap_service_storage[MAX_NR_L2CAP_SERVICES];
+#endif
 static btstack_memory_pool_t l2cap_service_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t l2cap_service_statistics = { "l2cap_service", MAX_NR_L2CAP_SERVICES, 0, 0, 0, 0, 0, 0 };
+#endif
 l2cap_service_t * btstack_memory_l2cap_service_get(void){
     void * buffer = btstack_memory_pool_get(&l2cap_service_pool);
     if (buffer){
         memset(buffer, 0, sizeof(l2cap_service_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(l2cap_service, buffer);
     return (l2cap_service_t *) buffer;
 }
 void btstack_memory_l2cap_service_free(l2cap_service_t *l2cap_service){
+    BTSTACK_MEMORY_STATISTICS_FREE(l2cap_service);
     btstack_memory_pool_free(&l2cap_service_pool, l2cap_service);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t l2cap_service_statistics = { "l2cap_service", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 l2cap_service_t * btstack_memory_l2cap_service_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(l2cap_service, NULL);
     return NULL;
 }
 void btstack_memory_l2cap_service_free(l2cap_service_t *l2cap_service){
@@ -212,8 +306,15 @@ typedef struct {
     l2cap_service_t data;
 } btstack_memory_l2cap_service_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t l2cap_service_statistics = { "l2cap_service", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 l2cap_service_t * btstack_memory_l2cap_service_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_l2cap_service_t * buffer = (btstack_memory_l2cap_service_t *) malloc(sizeof(btstack_memory_l2cap_service_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(l2cap_service, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(l2cap_service, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_l2cap_service_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -223,6 +324,7 @@ l2cap_service_t * btstack_memory_l2cap_service_get(void){
     }
 }
 void btstack_memory_l2cap_service_free(l2cap_service_t *l2cap_service){
+    BTSTACK_MEMORY_STATISTICS_FREE(l2cap_service);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) l2cap_service)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -242,20 +344,31 @@ void btstack_memory_l2cap_service_free(l2cap_service_t *l2cap_service){
 
 #ifdef MAX_NR_L2CAP_CHANNELS
 #if MAX_NR_L2CAP_CHANNELS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static l2cap_channel_t l2cap_channel_storage[MAX_NR_L2CAP_CHANNELS];
+#endif
 static btstack_memory_pool_t l2cap_channel_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t l2cap_channel_statistics = { "l2cap_channel", MAX_NR_L2CAP_CHANNELS, 0, 0, 0, 0, 0, 0 };
+#endif
 l2cap_channel_t * btstack_memory_l2cap_channel_get(void){
     void * buffer = btstack_memory_pool_get(&l2cap_channel_pool);
     if (buffer){
         memset(buffer, 0, sizeof(l2cap_channel_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(l2cap_channel, buffer);
     return (l2cap_channel_t *) buffer;
 }
 void btstack_memory_l2cap_channel_free(l2cap_channel_t *l2cap_channel){
+    BTSTACK_MEMORY_STATISTICS_FREE(l2cap_channel);
     btstack_memory_pool_free(&l2cap_channel_pool, l2cap_channel);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t l2cap_channel_statistics = { "l2cap_channel", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 l2cap_channel_t * btstack_memory_l2cap_channel_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(l2cap_channel, NULL);
     return NULL;
 }
 void btstack_memory_l2cap_channel_free(l2cap_channel_t *l2cap_channel){
@@ -269,8 +382,15 @@ typedef struct {
     l2cap_channel_t data;
 } btstack_memory_l2cap_channel_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t l2cap_channel_statistics = { "l2cap_channel", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 l2cap_channel_t * btstack_memory_l2cap_channel_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_l2cap_channel_t * buffer = (btstack_memory_l2cap_channel_t *) malloc(sizeof(btstack_memory_l2cap_channel_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(l2cap_channel, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(l2cap_channel, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_l2cap_channel_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -280,6 +400,7 @@ l2cap_channel_t * btstack_memory_l2cap_channel_get(void){
     }
 }
 void btstack_memory_l2cap_channel_free(l2cap_channel_t *l2cap_channel){
+    BTSTACK_MEMORY_STATISTICS_FREE(l2cap_channel);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) l2cap_channel)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -301,20 +422,31 @@ void btstack_memory_l2cap_channel_free(l2cap_channel_t *l2cap_channel){
 
 #ifdef MAX_NR_RFCOMM_MULTIPLEXERS
 #if MAX_NR_RFCOMM_MULTIPLEXERS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static rfcomm_multiplexer_t rfcomm_multiplexer_storage[MAX_NR_RFCOMM_MULTIPLEXERS];
+#endif
 static btstack_memory_pool_t rfcomm_multiplexer_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t rfcomm_multiplexer_statistics = { "rfcomm_multiplexer", MAX_NR_RFCOMM_MULTIPLEXERS, 0, 0, 0, 0, 0, 0 };
+#endif
 rfcomm_multiplexer_t * btstack_memory_rfcomm_multiplexer_get(void){
     void * buffer = btstack_memory_pool_get(&rfcomm_multiplexer_pool);
     if (buffer){
         memset(buffer, 0, sizeof(rfcomm_multiplexer_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(rfcomm_multiplexer, buffer);
     return (rfcomm_multiplexer_t *) buffer;
 }
 void btstack_memory_rfcomm_multiplexer_free(rfcomm_multiplexer_t *rfcomm_multiplexer){
+    BTSTACK_MEMORY_STATISTICS_FREE(rfcomm_multiplexer);
     btstack_memory_pool_free(&rfcomm_multiplexer_pool, rfcomm_multiplexer);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t rfcomm_multiplexer_statistics = { "rfcomm_multiplexer", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 rfcomm_multiplexer_t * btstack_memory_rfcomm_multiplexer_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(rfcomm_multiplexer, NULL);
     return NULL;
 }
 void btstack_memory_rfcomm_multiplexer_free(rfcomm_multiplexer_t *rfcomm_multiplexer){
@@ -328,8 +460,15 @@ typedef struct {
     rfcomm_multiplexer_t data;
 } btstack_memory_rfcomm_multiplexer_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t rfcomm_multiplexer_statistics = { "rfcomm_multiplexer", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 rfcomm_multiplexer_t * btstack_memory_rfcomm_multiplexer_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_rfcomm_multiplexer_t * buffer = (btstack_memory_rfcomm_multiplexer_t *) malloc(sizeof(btstack_memory_rfcomm_multiplexer_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(rfcomm_multiplexer, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(rfcomm_multiplexer, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_rfcomm_multiplexer_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -339,6 +478,7 @@ rfcomm_multiplexer_t * btstack_memory_rfcomm_multiplexer_get(void){
     }
 }
 void btstack_memory_rfcomm_multiplexer_free(rfcomm_multiplexer_t *rfcomm_multiplexer){
+    BTSTACK_MEMORY_STATISTICS_FREE(rfcomm_multiplexer);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) rfcomm_multiplexer)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -358,20 +498,31 @@ void btstack_memory_rfcomm_multiplexer_free(rfcomm_multiplexer_t *rfcomm_multipl
 
 #ifdef MAX_NR_RFCOMM_SERVICES
 #if MAX_NR_RFCOMM_SERVICES > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static rfcomm_service_t rfcomm_service_storage[MAX_NR_RFCOMM_SERVICES];
+#endif
 static btstack_memory_pool_t rfcomm_service_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t rfcomm_service_statistics = { "rfcomm_service", MAX_NR_RFCOMM_SERVICES, 0, 0, 0, 0, 0, 0 };
+#endif
 rfcomm_service_t * btstack_memory_rfcomm_service_get(void){
     void * buffer = btstack_memory_pool_get(&rfcomm_service_pool);
     if (buffer){
         memset(buffer, 0, sizeof(rfcomm_service_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(rfcomm_service, buffer);
     return (rfcomm_service_t *) buffer;
 }
 void btstack_memory_rfcomm_service_free(rfcomm_service_t *rfcomm_service){
+    BTSTACK_MEMORY_STATISTICS_FREE(rfcomm_service);
     btstack_memory_pool_free(&rfcomm_service_pool, rfcomm_service);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t rfcomm_service_statistics = { "rfcomm_service", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 rfcomm_service_t * btstack_memory_rfcomm_service_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(rfcomm_service, NULL);
     return NULL;
 }
 void btstack_memory_rfcomm_service_free(rfcomm_service_t *rfcomm_service){
@@ -385,8 +536,15 @@ typedef struct {
     rfcomm_service_t data;
 } btstack_memory_rfcomm_service_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t rfcomm_service_statistics = { "rfcomm_service", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 rfcomm_service_t * btstack_memory_rfcomm_service_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_rfcomm_service_t * buffer = (btstack_memory_rfcomm_service_t *) malloc(sizeof(btstack_memory_rfcomm_service_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(rfcomm_service, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(rfcomm_service, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_rfcomm_service_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -396,6 +554,7 @@ rfcomm_service_t * btstack_memory_rfcomm_service_get(void){
     }
 }
 void btstack_memory_rfcomm_service_free(rfcomm_service_t *rfcomm_service){
+    BTSTACK_MEMORY_STATISTICS_FREE(rfcomm_service);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) rfcomm_service)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -415,20 +574,31 @@ void btstack_memory_rfcomm_service_free(rfcomm_service_t *rfcomm_service){
 
 #ifdef MAX_NR_RFCOMM_CHANNELS
 #if MAX_NR_RFCOMM_CHANNELS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static rfcomm_channel_t rfcomm_channel_storage[MAX_NR_RFCOMM_CHANNELS];
+#endif
 static btstack_memory_pool_t rfcomm_channel_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t rfcomm_channel_statistics = { "rfcomm_channel", MAX_NR_RFCOMM_CHANNELS, 0, 0, 0, 0, 0, 0 };
+#endif
 rfcomm_channel_t * btstack_memory_rfcomm_channel_get(void){
     void * buffer = btstack_memory_pool_get(&rfcomm_channel_pool);
     if (buffer){
         memset(buffer, 0, sizeof(rfcomm_channel_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(rfcomm_channel, buffer);
     return (rfcomm_channel_t *) buffer;
 }
 void btstack_memory_rfcomm_channel_free(rfcomm_channel_t *rfcomm_channel){
+    BTSTACK_MEMORY_STATISTICS_FREE(rfcomm_channel);
     btstack_memory_pool_free(&rfcomm_channel_pool, rfcomm_channel);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t rfcomm_channel_statistics = { "rfcomm_channel", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 rfcomm_channel_t * btstack_memory_rfcomm_channel_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(rfcomm_channel, NULL);
     return NULL;
 }
 void btstack_memory_rfcomm_channel_free(rfcomm_channel_t *rfcomm_channel){
@@ -442,8 +612,15 @@ typedef struct {
     rfcomm_channel_t data;
 } btstack_memory_rfcomm_channel_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t rfcomm_channel_statistics = { "rfcomm_channel", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 rfcomm_channel_t * btstack_memory_rfcomm_channel_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_rfcomm_channel_t * buffer = (btstack_memory_rfcomm_channel_t *) malloc(sizeof(btstack_memory_rfcomm_channel_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(rfcomm_channel, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(rfcomm_channel, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_rfcomm_channel_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -453,6 +630,7 @@ rfcomm_channel_t * btstack_memory_rfcomm_channel_get(void){
     }
 }
 void btstack_memory_rfcomm_channel_free(rfcomm_channel_t *rfcomm_channel){
+    BTSTACK_MEMORY_STATISTICS_FREE(rfcomm_channel);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) rfcomm_channel)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -473,20 +651,31 @@ void btstack_memory_rfcomm_channel_free(rfcomm_channel_t *rfcomm_channel){
 
 #ifdef MAX_NR_BTSTACK_LINK_KEY_DB_MEMORY_ENTRIES
 #if MAX_NR_BTSTACK_LINK_KEY_DB_MEMORY_ENTRIES > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static btstack_link_key_db_memory_entry_t btstack_link_key_db_memory_entry_storage[MAX_NR_BTSTACK_LINK_KEY_DB_MEMORY_ENTRIES];
+#endif
 static btstack_memory_pool_t btstack_link_key_db_memory_entry_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t btstack_link_key_db_memory_entry_statistics = { "btstack_link_key_db_memory_entry", MAX_NR_BTSTACK_LINK_KEY_DB_MEMORY_ENTRIES, 0, 0, 0, 0, 0, 0 };
+#endif
 btstack_link_key_db_memory_entry_t * btstack_memory_btstack_link_key_db_memory_entry_get(void){
     void * buffer = btstack_memory_pool_get(&btstack_link_key_db_memory_entry_pool);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_link_key_db_memory_entry_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(btstack_link_key_db_memory_entry, buffer);
     return (btstack_link_key_db_memory_entry_t *) buffer;
 }
 void btstack_memory_btstack_link_key_db_memory_entry_free(btstack_link_key_db_memory_entry_t *btstack_link_key_db_memory_entry){
+    BTSTACK_MEMORY_STATISTICS_FREE(btstack_link_key_db_memory_entry);
     btstack_memory_pool_free(&btstack_link_key_db_memory_entry_pool, btstack_link_key_db_memory_entry);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t btstack_link_key_db_memory_entry_statistics = { "btstack_link_key_db_memory_entry", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 btstack_link_key_db_memory_entry_t * btstack_memory_btstack_link_key_db_memory_entry_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(btstack_link_key_db_memory_entry, NULL);
     return NULL;
 }
 void btstack_memory_btstack_link_key_db_memory_entry_free(btstack_link_key_db_memory_entry_t *btstack_link_key_db_memory_entry){
@@ -500,8 +689,15 @@ typedef struct {
     btstack_link_key_db_memory_entry_t data;
 } btstack_memory_btstack_link_key_db_memory_entry_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t btstack_link_key_db_memory_entry_statistics = { "btstack_link_key_db_memory_entry", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 btstack_link_key_db_memory_entry_t * btstack_memory_btstack_link_key_db_memory_entry_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_btstack_link_key_db_memory_entry_t * buffer = (btstack_memory_btstack_link_key_db_memory_entry_t *) malloc(sizeof(btstack_memory_btstack_link_key_db_memory_entry_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(btstack_link_key_db_memory_entry, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(btstack_link_key_db_memory_entry, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_btstack_link_key_db_memory_entry_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -511,6 +707,7 @@ btstack_link_key_db_memory_entry_t * btstack_memory_btstack_link_key_db_memory_e
     }
 }
 void btstack_memory_btstack_link_key_db_memory_entry_free(btstack_link_key_db_memory_entry_t *btstack_link_key_db_memory_entry){
+    BTSTACK_MEMORY_STATISTICS_FREE(btstack_link_key_db_memory_entry);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) btstack_link_key_db_memory_entry)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -531,20 +728,31 @@ void btstack_memory_btstack_link_key_db_memory_entry_free(btstack_link_key_db_me
 
 #ifdef MAX_NR_BNEP_SERVICES
 #if MAX_NR_BNEP_SERVICES > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static bnep_service_t bnep_service_storage[MAX_NR_BNEP_SERVICES];
+#endif
 static btstack_memory_pool_t bnep_service_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t bnep_service_statistics = { "bnep_service", MAX_NR_BNEP_SERVICES, 0, 0, 0, 0, 0, 0 };
+#endif
 bnep_service_t * btstack_memory_bnep_service_get(void){
     void * buffer = btstack_memory_pool_get(&bnep_service_pool);
     if (buffer){
         memset(buffer, 0, sizeof(bnep_service_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(bnep_service, buffer);
     return (bnep_service_t *) buffer;
 }
 void btstack_memory_bnep_service_free(bnep_service_t *bnep_service){
+    BTSTACK_MEMORY_STATISTICS_FREE(bnep_service);
     btstack_memory_pool_free(&bnep_service_pool, bnep_service);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t bnep_service_statistics = { "bnep_service", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 bnep_service_t * btstack_memory_bnep_service_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(bnep_service, NULL);
     return NULL;
 }
 void btstack_memory_bnep_service_free(bnep_service_t *bnep_service){
@@ -558,8 +766,15 @@ typedef struct {
     bnep_service_t data;
 } btstack_memory_bnep_service_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t bnep_service_statistics = { "bnep_service", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 bnep_service_t * btstack_memory_bnep_service_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_bnep_service_t * buffer = (btstack_memory_bnep_service_t *) malloc(sizeof(btstack_memory_bnep_service_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(bnep_service, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(bnep_service, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_bnep_service_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -569,6 +784,7 @@ bnep_service_t * btstack_memory_bnep_service_get(void){
     }
 }
 void btstack_memory_bnep_service_free(bnep_service_t *bnep_service){
+    BTSTACK_MEMORY_STATISTICS_FREE(bnep_service);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) bnep_service)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -588,20 +804,31 @@ void btstack_memory_bnep_service_free(bnep_service_t *bnep_service){
 
 #ifdef MAX_NR_BNEP_CHANNELS
 #if MAX_NR_BNEP_CHANNELS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static bnep_channel_t bnep_channel_storage[MAX_NR_BNEP_CHANNELS];
+#endif
 static btstack_memory_pool_t bnep_channel_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t bnep_channel_statistics = { "bnep_channel", MAX_NR_BNEP_CHANNELS, 0, 0, 0, 0, 0, 0 };
+#endif
 bnep_channel_t * btstack_memory_bnep_channel_get(void){
     void * buffer = btstack_memory_pool_get(&bnep_channel_pool);
     if (buffer){
         memset(buffer, 0, sizeof(bnep_channel_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(bnep_channel, buffer);
     return (bnep_channel_t *) buffer;
 }
 void btstack_memory_bnep_channel_free(bnep_channel_t *bnep_channel){
+    BTSTACK_MEMORY_STATISTICS_FREE(bnep_channel);
     btstack_memory_pool_free(&bnep_channel_pool, bnep_channel);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t bnep_channel_statistics = { "bnep_channel", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 bnep_channel_t * btstack_memory_bnep_channel_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(bnep_channel, NULL);
     return NULL;
 }
 void btstack_memory_bnep_channel_free(bnep_channel_t *bnep_channel){
@@ -615,8 +842,15 @@ typedef struct {
     bnep_channel_t data;
 } btstack_memory_bnep_channel_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t bnep_channel_statistics = { "bnep_channel", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 bnep_channel_t * btstack_memory_bnep_channel_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_bnep_channel_t * buffer = (btstack_memory_bnep_channel_t *) malloc(sizeof(btstack_memory_bnep_channel_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(bnep_channel, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(bnep_channel, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_bnep_channel_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -626,6 +860,7 @@ bnep_channel_t * btstack_memory_bnep_channel_get(void){
     }
 }
 void btstack_memory_bnep_channel_free(bnep_channel_t *bnep_channel){
+    BTSTACK_MEMORY_STATISTICS_FREE(bnep_channel);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) bnep_channel)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -646,20 +881,31 @@ void btstack_memory_bnep_channel_free(bnep_channel_t *bnep_channel){
 
 #ifdef MAX_NR_GOEP_SERVER_SERVICES
 #if MAX_NR_GOEP_SERVER_SERVICES > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static goep_server_service_t goep_server_service_storage[MAX_NR_GOEP_SERVER_SERVICES];
+#endif
 static btstack_memory_pool_t goep_server_service_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t goep_server_service_statistics = { "goep_server_service", MAX_NR_GOEP_SERVER_SERVICES, 0, 0, 0, 0, 0, 0 };
+#endif
 goep_server_service_t * btstack_memory_goep_server_service_get(void){
     void * buffer = btstack_memory_pool_get(&goep_server_service_pool);
     if (buffer){
         memset(buffer, 0, sizeof(goep_server_service_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(goep_server_service, buffer);
     return (goep_server_service_t *) buffer;
 }
 void btstack_memory_goep_server_service_free(goep_server_service_t *goep_server_service){
+    BTSTACK_MEMORY_STATISTICS_FREE(goep_server_service);
     btstack_memory_pool_free(&goep_server_service_pool, goep_server_service);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t goep_server_service_statistics = { "goep_server_service", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 goep_server_service_t * btstack_memory_goep_server_service_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(goep_server_service, NULL);
     return NULL;
 }
 void btstack_memory_goep_server_service_free(goep_server_service_t *goep_server_service){
@@ -673,8 +919,15 @@ typedef struct {
     goep_server_service_t data;
 } btstack_memory_goep_server_service_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t goep_server_service_statistics = { "goep_server_service", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 goep_server_service_t * btstack_memory_goep_server_service_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_goep_server_service_t * buffer = (btstack_memory_goep_server_service_t *) malloc(sizeof(btstack_memory_goep_server_service_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(goep_server_service, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(goep_server_service, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_goep_server_service_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -684,6 +937,7 @@ goep_server_service_t * btstack_memory_goep_server_service_get(void){
     }
 }
 void btstack_memory_goep_server_service_free(goep_server_service_t *goep_server_service){
+    BTSTACK_MEMORY_STATISTICS_FREE(goep_server_service);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) goep_server_service)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -703,20 +957,31 @@ void btstack_memory_goep_server_service_free(goep_server_service_t *goep_server_
 
 #ifdef MAX_NR_GOEP_SERVER_CONNECTIONS
 #if MAX_NR_GOEP_SERVER_CONNECTIONS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static goep_server_connection_t goep_server_connection_storage[MAX_NR_GOEP_SERVER_CONNECTIONS];
+#endif
 static btstack_memory_pool_t goep_server_connection_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t goep_server_connection_statistics = { "goep_server_connection", MAX_NR_GOEP_SERVER_CONNECTIONS, 0, 0, 0, 0, 0, 0 };
+#endif
 goep_server_connection_t * btstack_memory_goep_server_connection_get(void){
     void * buffer = btstack_memory_pool_get(&goep_server_connection_pool);
     if (buffer){
         memset(buffer, 0, sizeof(goep_server_connection_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(goep_server_connection, buffer);
     return (goep_server_connection_t *) buffer;
 }
 void btstack_memory_goep_server_connection_free(goep_server_connection_t *goep_server_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(goep_server_connection);
     btstack_memory_pool_free(&goep_server_connection_pool, goep_server_connection);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t goep_server_connection_statistics = { "goep_server_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 goep_server_connection_t * btstack_memory_goep_server_connection_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(goep_server_connection, NULL);
     return NULL;
 }
 void btstack_memory_goep_server_connection_free(goep_server_connection_t *goep_server_connection){
@@ -730,8 +995,15 @@ typedef struct {
     goep_server_connection_t data;
 } btstack_memory_goep_server_connection_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t goep_server_connection_statistics = { "goep_server_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 goep_server_connection_t * btstack_memory_goep_server_connection_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_goep_server_connection_t * buffer = (btstack_memory_goep_server_connection_t *) malloc(sizeof(btstack_memory_goep_server_connection_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(goep_server_connection, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(goep_server_connection, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_goep_server_connection_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -741,6 +1013,7 @@ goep_server_connection_t * btstack_memory_goep_server_connection_get(void){
     }
 }
 void btstack_memory_goep_server_connection_free(goep_server_connection_t *goep_server_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(goep_server_connection);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) goep_server_connection)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -761,20 +1034,31 @@ void btstack_memory_goep_server_connection_free(goep_server_connection_t *goep_s
 
 #ifdef MAX_NR_HFP_CONNECTIONS
 #if MAX_NR_HFP_CONNECTIONS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static hfp_connection_t hfp_connection_storage[MAX_NR_HFP_CONNECTIONS];
+#endif
 static btstack_memory_pool_t hfp_connection_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hfp_connection_statistics = { "hfp_connection", MAX_NR_HFP_CONNECTIONS, 0, 0, 0, 0, 0, 0 };
+#endif
 hfp_connection_t * btstack_memory_hfp_connection_get(void){
     void * buffer = btstack_memory_pool_get(&hfp_connection_pool);
     if (buffer){
         memset(buffer, 0, sizeof(hfp_connection_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(hfp_connection, buffer);
     return (hfp_connection_t *) buffer;
 }
 void btstack_memory_hfp_connection_free(hfp_connection_t *hfp_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(hfp_connection);
     btstack_memory_pool_free(&hfp_connection_pool, hfp_connection);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hfp_connection_statistics = { "hfp_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 hfp_connection_t * btstack_memory_hfp_connection_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(hfp_connection, NULL);
     return NULL;
 }
 void btstack_memory_hfp_connection_free(hfp_connection_t *hfp_connection){
@@ -788,8 +1072,15 @@ typedef struct {
     hfp_connection_t data;
 } btstack_memory_hfp_connection_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hfp_connection_statistics = { "hfp_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 hfp_connection_t * btstack_memory_hfp_connection_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_hfp_connection_t * buffer = (btstack_memory_hfp_connection_t *) malloc(sizeof(btstack_memory_hfp_connection_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(hfp_connection, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(hfp_connection, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_hfp_connection_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -799,6 +1090,7 @@ hfp_connection_t * btstack_memory_hfp_connection_get(void){
     }
 }
 void btstack_memory_hfp_connection_free(hfp_connection_t *hfp_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(hfp_connection);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) hfp_connection)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -819,20 +1111,31 @@ void btstack_memory_hfp_connection_free(hfp_connection_t *hfp_connection){
 
 #ifdef MAX_NR_HID_HOST_CONNECTIONS
 #if MAX_NR_HID_HOST_CONNECTIONS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static hid_host_connection_t hid_host_connection_storage[MAX_NR_HID_HOST_CONNECTIONS];
+#endif
 static btstack_memory_pool_t hid_host_connection_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hid_host_connection_statistics = { "hid_host_connection", MAX_NR_HID_HOST_CONNECTIONS, 0, 0, 0, 0, 0, 0 };
+#endif
 hid_host_connection_t * btstack_memory_hid_host_connection_get(void){
     void * buffer = btstack_memory_pool_get(&hid_host_connection_pool);
     if (buffer){
         memset(buffer, 0, sizeof(hid_host_connection_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(hid_host_connection, buffer);
     return (hid_host_connection_t *) buffer;
 }
 void btstack_memory_hid_host_connection_free(hid_host_connection_t *hid_host_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(hid_host_connection);
     btstack_memory_pool_free(&hid_host_connection_pool, hid_host_connection);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hid_host_connection_statistics = { "hid_host_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 hid_host_connection_t * btstack_memory_hid_host_connection_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(hid_host_connection, NULL);
     return NULL;
 }
 void btstack_memory_hid_host_connection_free(hid_host_connection_t *hid_host_connection){
@@ -846,8 +1149,15 @@ typedef struct {
     hid_host_connection_t data;
 } btstack_memory_hid_host_connection_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hid_host_connection_statistics = { "hid_host_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 hid_host_connection_t * btstack_memory_hid_host_connection_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_hid_host_connection_t * buffer = (btstack_memory_hid_host_connection_t *) malloc(sizeof(btstack_memory_hid_host_connection_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(hid_host_connection, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(hid_host_connection, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_hid_host_connection_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -857,6 +1167,7 @@ hid_host_connection_t * btstack_memory_hid_host_connection_get(void){
     }
 }
 void btstack_memory_hid_host_connection_free(hid_host_connection_t *hid_host_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(hid_host_connection);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) hid_host_connection)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -877,20 +1188,31 @@ void btstack_memory_hid_host_connection_free(hid_host_connection_t *hid_host_con
 
 #ifdef MAX_NR_SERVICE_RECORD_ITEMS
 #if MAX_NR_SERVICE_RECORD_ITEMS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static service_record_item_t service_record_item_storage[MAX_NR_SERVICE_RECORD_ITEMS];
+#endif
 static btstack_memory_pool_t service_record_item_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t service_record_item_statistics = { "service_record_item", MAX_NR_SERVICE_RECORD_ITEMS, 0, 0, 0, 0, 0, 0 };
+#endif
 service_record_item_t * btstack_memory_service_record_item_get(void){
     void * buffer = btstack_memory_pool_get(&service_record_item_pool);
     if (buffer){
         memset(buffer, 0, sizeof(service_record_item_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(service_record_item, buffer);
     return (service_record_item_t *) buffer;
 }
 void btstack_memory_service_record_item_free(service_record_item_t *service_record_item){
+    BTSTACK_MEMORY_STATISTICS_FREE(service_record_item);
     btstack_memory_pool_free(&service_record_item_pool, service_record_item);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t service_record_item_statistics = { "service_record_item", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 service_record_item_t * btstack_memory_service_record_item_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(service_record_item, NULL);
     return NULL;
 }
 void btstack_memory_service_record_item_free(service_record_item_t *service_record_item){
@@ -904,8 +1226,15 @@ typedef struct {
     service_record_item_t data;
 } btstack_memory_service_record_item_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t service_record_item_statistics = { "service_record_item", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 service_record_item_t * btstack_memory_service_record_item_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_service_record_item_t * buffer = (btstack_memory_service_record_item_t *) malloc(sizeof(btstack_memory_service_record_item_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(service_record_item, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(service_record_item, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_service_record_item_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -915,6 +1244,7 @@ service_record_item_t * btstack_memory_service_record_item_get(void){
     }
 }
 void btstack_memory_service_record_item_free(service_record_item_t *service_record_item){
+    BTSTACK_MEMORY_STATISTICS_FREE(service_record_item);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) service_record_item)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -935,20 +1265,31 @@ void btstack_memory_service_record_item_free(service_record_item_t *service_reco
 
 #ifdef MAX_NR_AVDTP_STREAM_ENDPOINTS
 #if MAX_NR_AVDTP_STREAM_ENDPOINTS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static avdtp_stream_endpoint_t avdtp_stream_endpoint_storage[MAX_NR_AVDTP_STREAM_ENDPOINTS];
+#endif
 static btstack_memory_pool_t avdtp_stream_endpoint_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avdtp_stream_endpoint_statistics = { "avdtp_stream_endpoint", MAX_NR_AVDTP_STREAM_ENDPOINTS, 0, 0, 0, 0, 0, 0 };
+#endif
 avdtp_stream_endpoint_t * btstack_memory_avdtp_stream_endpoint_get(void){
     void * buffer = btstack_memory_pool_get(&avdtp_stream_endpoint_pool);
     if (buffer){
         memset(buffer, 0, sizeof(avdtp_stream_endpoint_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(avdtp_stream_endpoint, buffer);
     return (avdtp_stream_endpoint_t *) buffer;
 }
 void btstack_memory_avdtp_stream_endpoint_free(avdtp_stream_endpoint_t *avdtp_stream_endpoint){
+    BTSTACK_MEMORY_STATISTICS_FREE(avdtp_stream_endpoint);
     btstack_memory_pool_free(&avdtp_stream_endpoint_pool, avdtp_stream_endpoint);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avdtp_stream_endpoint_statistics = { "avdtp_stream_endpoint", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 avdtp_stream_endpoint_t * btstack_memory_avdtp_stream_endpoint_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(avdtp_stream_endpoint, NULL);
     return NULL;
 }
 void btstack_memory_avdtp_stream_endpoint_free(avdtp_stream_endpoint_t *avdtp_stream_endpoint){
@@ -962,8 +1303,15 @@ typedef struct {
     avdtp_stream_endpoint_t data;
 } btstack_memory_avdtp_stream_endpoint_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avdtp_stream_endpoint_statistics = { "avdtp_stream_endpoint", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 avdtp_stream_endpoint_t * btstack_memory_avdtp_stream_endpoint_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_avdtp_stream_endpoint_t * buffer = (btstack_memory_avdtp_stream_endpoint_t *) malloc(sizeof(btstack_memory_avdtp_stream_endpoint_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(avdtp_stream_endpoint, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(avdtp_stream_endpoint, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_avdtp_stream_endpoint_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -973,6 +1321,7 @@ avdtp_stream_endpoint_t * btstack_memory_avdtp_stream_endpoint_get(void){
     }
 }
 void btstack_memory_avdtp_stream_endpoint_free(avdtp_stream_endpoint_t *avdtp_stream_endpoint){
+    BTSTACK_MEMORY_STATISTICS_FREE(avdtp_stream_endpoint);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) avdtp_stream_endpoint)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -993,20 +1342,31 @@ void btstack_memory_avdtp_stream_endpoint_free(avdtp_stream_endpoint_t *avdtp_st
 
 #ifdef MAX_NR_AVDTP_CONNECTIONS
 #if MAX_NR_AVDTP_CONNECTIONS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static avdtp_connection_t avdtp_connection_storage[MAX_NR_AVDTP_CONNECTIONS];
+#endif
 static btstack_memory_pool_t avdtp_connection_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avdtp_connection_statistics = { "avdtp_connection", MAX_NR_AVDTP_CONNECTIONS, 0, 0, 0, 0, 0, 0 };
+#endif
 avdtp_connection_t * btstack_memory_avdtp_connection_get(void){
     void * buffer = btstack_memory_pool_get(&avdtp_connection_pool);
     if (buffer){
         memset(buffer, 0, sizeof(avdtp_connection_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(avdtp_connection, buffer);
     return (avdtp_connection_t *) buffer;
 }
 void btstack_memory_avdtp_connection_free(avdtp_connection_t *avdtp_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(avdtp_connection);
     btstack_memory_pool_free(&avdtp_connection_pool, avdtp_connection);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avdtp_connection_statistics = { "avdtp_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 avdtp_connection_t * btstack_memory_avdtp_connection_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(avdtp_connection, NULL);
     return NULL;
 }
 void btstack_memory_avdtp_connection_free(avdtp_connection_t *avdtp_connection){
@@ -1020,8 +1380,15 @@ typedef struct {
     avdtp_connection_t data;
 } btstack_memory_avdtp_connection_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avdtp_connection_statistics = { "avdtp_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 avdtp_connection_t * btstack_memory_avdtp_connection_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_avdtp_connection_t * buffer = (btstack_memory_avdtp_connection_t *) malloc(sizeof(btstack_memory_avdtp_connection_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(avdtp_connection, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(avdtp_connection, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_avdtp_connection_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1031,6 +1398,7 @@ avdtp_connection_t * btstack_memory_avdtp_connection_get(void){
     }
 }
 void btstack_memory_avdtp_connection_free(avdtp_connection_t *avdtp_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(avdtp_connection);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) avdtp_connection)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1051,20 +1419,31 @@ void btstack_memory_avdtp_connection_free(avdtp_connection_t *avdtp_connection){
 
 #ifdef MAX_NR_AVRCP_CONNECTIONS
 #if MAX_NR_AVRCP_CONNECTIONS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static avrcp_connection_t avrcp_connection_storage[MAX_NR_AVRCP_CONNECTIONS];
+#endif
 static btstack_memory_pool_t avrcp_connection_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avrcp_connection_statistics = { "avrcp_connection", MAX_NR_AVRCP_CONNECTIONS, 0, 0, 0, 0, 0, 0 };
+#endif
 avrcp_connection_t * btstack_memory_avrcp_connection_get(void){
     void * buffer = btstack_memory_pool_get(&avrcp_connection_pool);
     if (buffer){
         memset(buffer, 0, sizeof(avrcp_connection_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(avrcp_connection, buffer);
     return (avrcp_connection_t *) buffer;
 }
 void btstack_memory_avrcp_connection_free(avrcp_connection_t *avrcp_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(avrcp_connection);
     btstack_memory_pool_free(&avrcp_connection_pool, avrcp_connection);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avrcp_connection_statistics = { "avrcp_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 avrcp_connection_t * btstack_memory_avrcp_connection_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(avrcp_connection, NULL);
     return NULL;
 }
 void btstack_memory_avrcp_connection_free(avrcp_connection_t *avrcp_connection){
@@ -1078,8 +1457,15 @@ typedef struct {
     avrcp_connection_t data;
 } btstack_memory_avrcp_connection_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avrcp_connection_statistics = { "avrcp_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 avrcp_connection_t * btstack_memory_avrcp_connection_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_avrcp_connection_t * buffer = (btstack_memory_avrcp_connection_t *) malloc(sizeof(btstack_memory_avrcp_connection_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(avrcp_connection, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(avrcp_connection, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_avrcp_connection_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1089,6 +1475,7 @@ avrcp_connection_t * btstack_memory_avrcp_connection_get(void){
     }
 }
 void btstack_memory_avrcp_connection_free(avrcp_connection_t *avrcp_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(avrcp_connection);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) avrcp_connection)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1109,20 +1496,31 @@ void btstack_memory_avrcp_connection_free(avrcp_connection_t *avrcp_connection){
 
 #ifdef MAX_NR_AVRCP_BROWSING_CONNECTIONS
 #if MAX_NR_AVRCP_BROWSING_CONNECTIONS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static avrcp_browsing_connection_t avrcp_browsing_connection_storage[MAX_NR_AVRCP_BROWSING_CONNECTIONS];
+#endif
 static btstack_memory_pool_t avrcp_browsing_connection_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avrcp_browsing_connection_statistics = { "avrcp_browsing_connection", MAX_NR_AVRCP_BROWSING_CONNECTIONS, 0, 0, 0, 0, 0, 0 };
+#endif
 avrcp_browsing_connection_t * btstack_memory_avrcp_browsing_connection_get(void){
     void * buffer = btstack_memory_pool_get(&avrcp_browsing_connection_pool);
     if (buffer){
         memset(buffer, 0, sizeof(avrcp_browsing_connection_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(avrcp_browsing_connection, buffer);
     return (avrcp_browsing_connection_t *) buffer;
 }
 void btstack_memory_avrcp_browsing_connection_free(avrcp_browsing_connection_t *avrcp_browsing_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(avrcp_browsing_connection);
     btstack_memory_pool_free(&avrcp_browsing_connection_pool, avrcp_browsing_connection);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avrcp_browsing_connection_statistics = { "avrcp_browsing_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 avrcp_browsing_connection_t * btstack_memory_avrcp_browsing_connection_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(avrcp_browsing_connection, NULL);
     return NULL;
 }
 void btstack_memory_avrcp_browsing_connection_free(avrcp_browsing_connection_t *avrcp_browsing_connection){
@@ -1136,8 +1534,15 @@ typedef struct {
     avrcp_browsing_connection_t data;
 } btstack_memory_avrcp_browsing_connection_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t avrcp_browsing_connection_statistics = { "avrcp_browsing_connection", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 avrcp_browsing_connection_t * btstack_memory_avrcp_browsing_connection_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_avrcp_browsing_connection_t * buffer = (btstack_memory_avrcp_browsing_connection_t *) malloc(sizeof(btstack_memory_avrcp_browsing_connection_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(avrcp_browsing_connection, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(avrcp_browsing_connection, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_avrcp_browsing_connection_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1147,6 +1552,7 @@ avrcp_browsing_connection_t * btstack_memory_avrcp_browsing_connection_get(void)
     }
 }
 void btstack_memory_avrcp_browsing_connection_free(avrcp_browsing_connection_t *avrcp_browsing_connection){
+    BTSTACK_MEMORY_STATISTICS_FREE(avrcp_browsing_connection);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) avrcp_browsing_connection)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1169,20 +1575,31 @@ void btstack_memory_avrcp_browsing_connection_free(avrcp_browsing_connection_t *
 
 #ifdef MAX_NR_BATTERY_SERVICE_CLIENTS
 #if MAX_NR_BATTERY_SERVICE_CLIENTS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static battery_service_client_t battery_service_client_storage[MAX_NR_BATTERY_SERVICE_CLIENTS];
+#endif
 static btstack_memory_pool_t battery_service_client_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t battery_service_client_statistics = { "battery_service_client", MAX_NR_BATTERY_SERVICE_CLIENTS, 0, 0, 0, 0, 0, 0 };
+#endif
 battery_service_client_t * btstack_memory_battery_service_client_get(void){
     void * buffer = btstack_memory_pool_get(&battery_service_client_pool);
     if (buffer){
         memset(buffer, 0, sizeof(battery_service_client_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(battery_service_client, buffer);
     return (battery_service_client_t *) buffer;
 }
 void btstack_memory_battery_service_client_free(battery_service_client_t *battery_service_client){
+    BTSTACK_MEMORY_STATISTICS_FREE(battery_service_client);
     btstack_memory_pool_free(&battery_service_client_pool, battery_service_client);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t battery_service_client_statistics = { "battery_service_client", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 battery_service_client_t * btstack_memory_battery_service_client_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(battery_service_client, NULL);
     return NULL;
 }
 void btstack_memory_battery_service_client_free(battery_service_client_t *battery_service_client){
@@ -1196,8 +1613,15 @@ typedef struct {
     battery_service_client_t data;
 } btstack_memory_battery_service_client_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t battery_service_client_statistics = { "battery_service_client", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 battery_service_client_t * btstack_memory_battery_service_client_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_battery_service_client_t * buffer = (btstack_memory_battery_service_client_t *) malloc(sizeof(btstack_memory_battery_service_client_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(battery_service_client, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(battery_service_client, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_battery_service_client_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1207,6 +1631,7 @@ battery_service_client_t * btstack_memory_battery_service_client_get(void){
     }
 }
 void btstack_memory_battery_service_client_free(battery_service_client_t *battery_service_client){
+    BTSTACK_MEMORY_STATISTICS_FREE(battery_service_client);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) battery_service_client)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1226,20 +1651,31 @@ void btstack_memory_battery_service_client_free(battery_service_client_t *batter
 
 #ifdef MAX_NR_GATT_CLIENTS
 #if MAX_NR_GATT_CLIENTS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static gatt_client_t gatt_client_storage[MAX_NR_GATT_CLIENTS];
+#endif
 static btstack_memory_pool_t gatt_client_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t gatt_client_statistics = { "gatt_client", MAX_NR_GATT_CLIENTS, 0, 0, 0, 0, 0, 0 };
+#endif
 gatt_client_t * btstack_memory_gatt_client_get(void){
     void * buffer = btstack_memory_pool_get(&gatt_client_pool);
     if (buffer){
         memset(buffer, 0, sizeof(gatt_client_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(gatt_client, buffer);
     return (gatt_client_t *) buffer;
 }
 void btstack_memory_gatt_client_free(gatt_client_t *gatt_client){
+    BTSTACK_MEMORY_STATISTICS_FREE(gatt_client);
     btstack_memory_pool_free(&gatt_client_pool, gatt_client);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t gatt_client_statistics = { "gatt_client", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 gatt_client_t * btstack_memory_gatt_client_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(gatt_client, NULL);
     return NULL;
 }
 void btstack_memory_gatt_client_free(gatt_client_t *gatt_client){
@@ -1253,8 +1689,15 @@ typedef struct {
     gatt_client_t data;
 } btstack_memory_gatt_client_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t gatt_client_statistics = { "gatt_client", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 gatt_client_t * btstack_memory_gatt_client_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_gatt_client_t * buffer = (btstack_memory_gatt_client_t *) malloc(sizeof(btstack_memory_gatt_client_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(gatt_client, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(gatt_client, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_gatt_client_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1264,6 +1707,7 @@ gatt_client_t * btstack_memory_gatt_client_get(void){
     }
 }
 void btstack_memory_gatt_client_free(gatt_client_t *gatt_client){
+    BTSTACK_MEMORY_STATISTICS_FREE(gatt_client);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) gatt_client)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1283,20 +1727,31 @@ void btstack_memory_gatt_client_free(gatt_client_t *gatt_client){
 
 #ifdef MAX_NR_HIDS_CLIENTS
 #if MAX_NR_HIDS_CLIENTS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static hids_client_t hids_client_storage[MAX_NR_HIDS_CLIENTS];
+#endif
 static btstack_memory_pool_t hids_client_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hids_client_statistics = { "hids_client", MAX_NR_HIDS_CLIENTS, 0, 0, 0, 0, 0, 0 };
+#endif
 hids_client_t * btstack_memory_hids_client_get(void){
     void * buffer = btstack_memory_pool_get(&hids_client_pool);
     if (buffer){
         memset(buffer, 0, sizeof(hids_client_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(hids_client, buffer);
     return (hids_client_t *) buffer;
 }
 void btstack_memory_hids_client_free(hids_client_t *hids_client){
+    BTSTACK_MEMORY_STATISTICS_FREE(hids_client);
     btstack_memory_pool_free(&hids_client_pool, hids_client);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hids_client_statistics = { "hids_client", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 hids_client_t * btstack_memory_hids_client_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(hids_client, NULL);
     return NULL;
 }
 void btstack_memory_hids_client_free(hids_client_t *hids_client){
@@ -1310,8 +1765,15 @@ typedef struct {
     hids_client_t data;
 } btstack_memory_hids_client_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hids_client_statistics = { "hids_client", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 hids_client_t * btstack_memory_hids_client_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_hids_client_t * buffer = (btstack_memory_hids_client_t *) malloc(sizeof(btstack_memory_hids_client_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(hids_client, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(hids_client, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_hids_client_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1321,6 +1783,7 @@ hids_client_t * btstack_memory_hids_client_get(void){
     }
 }
 void btstack_memory_hids_client_free(hids_client_t *hids_client){
+    BTSTACK_MEMORY_STATISTICS_FREE(hids_client);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) hids_client)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1340,20 +1803,31 @@ void btstack_memory_hids_client_free(hids_client_t *hids_client){
 
 #ifdef MAX_NR_SCAN_PARAMETERS_SERVICE_CLIENTS
 #if MAX_NR_SCAN_PARAMETERS_SERVICE_CLIENTS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static scan_parameters_service_client_t scan_parameters_service_client_storage[MAX_NR_SCAN_PARAMETERS_SERVICE_CLIENTS];
+#endif
 static btstack_memory_pool_t scan_parameters_service_client_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t scan_parameters_service_client_statistics = { "scan_parameters_service_client", MAX_NR_SCAN_PARAMETERS_SERVICE_CLIENTS, 0, 0, 0, 0, 0, 0 };
+#endif
 scan_parameters_service_client_t * btstack_memory_scan_parameters_service_client_get(void){
     void * buffer = btstack_memory_pool_get(&scan_parameters_service_client_pool);
     if (buffer){
         memset(buffer, 0, sizeof(scan_parameters_service_client_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(scan_parameters_service_client, buffer);
     return (scan_parameters_service_client_t *) buffer;
 }
 void btstack_memory_scan_parameters_service_client_free(scan_parameters_service_client_t *scan_parameters_service_client){
+    BTSTACK_MEMORY_STATISTICS_FREE(scan_parameters_service_client);
     btstack_memory_pool_free(&scan_parameters_service_client_pool, scan_parameters_service_client);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t scan_parameters_service_client_statistics = { "scan_parameters_service_client", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 scan_parameters_service_client_t * btstack_memory_scan_parameters_service_client_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(scan_parameters_service_client, NULL);
     return NULL;
 }
 void btstack_memory_scan_parameters_service_client_free(scan_parameters_service_client_t *scan_parameters_service_client){
@@ -1367,8 +1841,15 @@ typedef struct {
     scan_parameters_service_client_t data;
 } btstack_memory_scan_parameters_service_client_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t scan_parameters_service_client_statistics = { "scan_parameters_service_client", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 scan_parameters_service_client_t * btstack_memory_scan_parameters_service_client_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_scan_parameters_service_client_t * buffer = (btstack_memory_scan_parameters_service_client_t *) malloc(sizeof(btstack_memory_scan_parameters_service_client_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(scan_parameters_service_client, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(scan_parameters_service_client, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_scan_parameters_service_client_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1378,6 +1859,7 @@ scan_parameters_service_client_t * btstack_memory_scan_parameters_service_client
     }
 }
 void btstack_memory_scan_parameters_service_client_free(scan_parameters_service_client_t *scan_parameters_service_client){
+    BTSTACK_MEMORY_STATISTICS_FREE(scan_parameters_service_client);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) scan_parameters_service_client)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1397,20 +1879,31 @@ void btstack_memory_scan_parameters_service_client_free(scan_parameters_service_
 
 #ifdef MAX_NR_SM_LOOKUP_ENTRIES
 #if MAX_NR_SM_LOOKUP_ENTRIES > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static sm_lookup_entry_t sm_lookup_entry_storage[MAX_NR_SM_LOOKUP_ENTRIES];
+#endif
 static btstack_memory_pool_t sm_lookup_entry_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t sm_lookup_entry_statistics = { "sm_lookup_entry", MAX_NR_SM_LOOKUP_ENTRIES, 0, 0, 0, 0, 0, 0 };
+#endif
 sm_lookup_entry_t * btstack_memory_sm_lookup_entry_get(void){
     void * buffer = btstack_memory_pool_get(&sm_lookup_entry_pool);
     if (buffer){
         memset(buffer, 0, sizeof(sm_lookup_entry_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(sm_lookup_entry, buffer);
     return (sm_lookup_entry_t *) buffer;
 }
 void btstack_memory_sm_lookup_entry_free(sm_lookup_entry_t *sm_lookup_entry){
+    BTSTACK_MEMORY_STATISTICS_FREE(sm_lookup_entry);
     btstack_memory_pool_free(&sm_lookup_entry_pool, sm_lookup_entry);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t sm_lookup_entry_statistics = { "sm_lookup_entry", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 sm_lookup_entry_t * btstack_memory_sm_lookup_entry_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(sm_lookup_entry, NULL);
     return NULL;
 }
 void btstack_memory_sm_lookup_entry_free(sm_lookup_entry_t *sm_lookup_entry){
@@ -1424,8 +1917,15 @@ typedef struct {
     sm_lookup_entry_t data;
 } btstack_memory_sm_lookup_entry_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t sm_lookup_entry_statistics = { "sm_lookup_entry", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 sm_lookup_entry_t * btstack_memory_sm_lookup_entry_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_sm_lookup_entry_t * buffer = (btstack_memory_sm_lookup_entry_t *) malloc(sizeof(btstack_memory_sm_lookup_entry_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(sm_lookup_entry, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(sm_lookup_entry, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_sm_lookup_entry_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1435,6 +1935,7 @@ sm_lookup_entry_t * btstack_memory_sm_lookup_entry_get(void){
     }
 }
 void btstack_memory_sm_lookup_entry_free(sm_lookup_entry_t *sm_lookup_entry){
+    BTSTACK_MEMORY_STATISTICS_FREE(sm_lookup_entry);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) sm_lookup_entry)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1454,20 +1955,31 @@ void btstack_memory_sm_lookup_entry_free(sm_lookup_entry_t *sm_lookup_entry){
 
 #ifdef MAX_NR_WHITELIST_ENTRIES
 #if MAX_NR_WHITELIST_ENTRIES > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static whitelist_entry_t whitelist_entry_storage[MAX_NR_WHITELIST_ENTRIES];
+#endif
 static btstack_memory_pool_t whitelist_entry_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t whitelist_entry_statistics = { "whitelist_entry", MAX_NR_WHITELIST_ENTRIES, 0, 0, 0, 0, 0, 0 };
+#endif
 whitelist_entry_t * btstack_memory_whitelist_entry_get(void){
     void * buffer = btstack_memory_pool_get(&whitelist_entry_pool);
     if (buffer){
         memset(buffer, 0, sizeof(whitelist_entry_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(whitelist_entry, buffer);
     return (whitelist_entry_t *) buffer;
 }
 void btstack_memory_whitelist_entry_free(whitelist_entry_t *whitelist_entry){
+    BTSTACK_MEMORY_STATISTICS_FREE(whitelist_entry);
     btstack_memory_pool_free(&whitelist_entry_pool, whitelist_entry);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t whitelist_entry_statistics = { "whitelist_entry", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 whitelist_entry_t * btstack_memory_whitelist_entry_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(whitelist_entry, NULL);
     return NULL;
 }
 void btstack_memory_whitelist_entry_free(whitelist_entry_t *whitelist_entry){
@@ -1481,8 +1993,15 @@ typedef struct {
     whitelist_entry_t data;
 } btstack_memory_whitelist_entry_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t whitelist_entry_statistics = { "whitelist_entry", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 whitelist_entry_t * btstack_memory_whitelist_entry_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_whitelist_entry_t * buffer = (btstack_memory_whitelist_entry_t *) malloc(sizeof(btstack_memory_whitelist_entry_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(whitelist_entry, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(whitelist_entry, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_whitelist_entry_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1492,6 +2011,7 @@ whitelist_entry_t * btstack_memory_whitelist_entry_get(void){
     }
 }
 void btstack_memory_whitelist_entry_free(whitelist_entry_t *whitelist_entry){
+    BTSTACK_MEMORY_STATISTICS_FREE(whitelist_entry);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) whitelist_entry)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1511,20 +2031,31 @@ void btstack_memory_whitelist_entry_free(whitelist_entry_t *whitelist_entry){
 
 #ifdef MAX_NR_PERIODIC_ADVERTISER_LIST_ENTRIES
 #if MAX_NR_PERIODIC_ADVERTISER_LIST_ENTRIES > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static periodic_advertiser_list_entry_t periodic_advertiser_list_entry_storage[MAX_NR_PERIODIC_ADVERTISER_LIST_ENTRIES];
+#endif
 static btstack_memory_pool_t periodic_advertiser_list_entry_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t periodic_advertiser_list_entry_statistics = { "periodic_advertiser_list_entry", MAX_NR_PERIODIC_ADVERTISER_LIST_ENTRIES, 0, 0, 0, 0, 0, 0 };
+#endif
 periodic_advertiser_list_entry_t * btstack_memory_periodic_advertiser_list_entry_get(void){
     void * buffer = btstack_memory_pool_get(&periodic_advertiser_list_entry_pool);
     if (buffer){
         memset(buffer, 0, sizeof(periodic_advertiser_list_entry_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(periodic_advertiser_list_entry, buffer);
     return (periodic_advertiser_list_entry_t *) buffer;
 }
 void btstack_memory_periodic_advertiser_list_entry_free(periodic_advertiser_list_entry_t *periodic_advertiser_list_entry){
+    BTSTACK_MEMORY_STATISTICS_FREE(periodic_advertiser_list_entry);
     btstack_memory_pool_free(&periodic_advertiser_list_entry_pool, periodic_advertiser_list_entry);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t periodic_advertiser_list_entry_statistics = { "periodic_advertiser_list_entry", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 periodic_advertiser_list_entry_t * btstack_memory_periodic_advertiser_list_entry_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(periodic_advertiser_list_entry, NULL);
     return NULL;
 }
 void btstack_memory_periodic_advertiser_list_entry_free(periodic_advertiser_list_entry_t *periodic_advertiser_list_entry){
@@ -1538,8 +2069,15 @@ typedef struct {
     periodic_advertiser_list_entry_t data;
 } btstack_memory_periodic_advertiser_list_entry_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t periodic_advertiser_list_entry_statistics = { "periodic_advertiser_list_entry", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 periodic_advertiser_list_entry_t * btstack_memory_periodic_advertiser_list_entry_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_periodic_advertiser_list_entry_t * buffer = (btstack_memory_periodic_advertiser_list_entry_t *) malloc(sizeof(btstack_memory_periodic_advertiser_list_entry_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(periodic_advertiser_list_entry, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(periodic_advertiser_list_entry, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_periodic_advertiser_list_entry_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1549,6 +2087,7 @@ periodic_advertiser_list_entry_t * btstack_memory_periodic_advertiser_list_entry
     }
 }
 void btstack_memory_periodic_advertiser_list_entry_free(periodic_advertiser_list_entry_t *periodic_advertiser_list_entry){
+    BTSTACK_MEMORY_STATISTICS_FREE(periodic_advertiser_list_entry);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) periodic_advertiser_list_entry)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1557,6 +2096,85 @@ void btstack_memory_periodic_advertiser_list_entry_free(periodic_advertiser_list
 #endif
 
 
+#endif
+#ifdef ENABLE_GATT_CLIENT_CACHE
+
+// MARK: gatt_client_cache_t
+#if !defined(HAVE_MALLOC) && !defined(MAX_NR_GATT_CLIENT_CACHES)
+    #if defined(MAX_NO_GATT_CLIENT_CACHES)
+        #error "Deprecated MAX_NO_GATT_CLIENT_CACHES defined instead of MAX_NR_GATT_CLIENT_CACHES. Please update your btstack_config.h to use MAX_NR_GATT_CLIENT_CACHES."
+    #else
+        #define MAX_NR_GATT_CLIENT_CACHES 0
+    #endif
+#endif
+
+#ifdef MAX_NR_GATT_CLIENT_CACHES
+#if MAX_NR_GATT_CLIENT_CACHES > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
+static gatt_client_cache_t gatt_client_cache_storage[MAX_NR_GATT_CLIENT_CACHES];
+#endif
+static btstack_memory_pool_t gatt_client_cache_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t gatt_client_cache_statistics = { "gatt_client_cache", MAX_NR_GATT_CLIENT_CACHES, 0, 0, 0, 0, 0, 0 };
+#endif
+gatt_client_cache_t * btstack_memory_gatt_client_cache_get(void){
+    void * buffer = btstack_memory_pool_get(&gatt_client_cache_pool);
+    if (buffer){
+        memset(buffer, 0, sizeof(gatt_client_cache_t));
+    }
+    BTSTACK_MEMORY_STATISTICS_GET(gatt_client_cache, buffer);
+    return (gatt_client_cache_t *) buffer;
+}
+void btstack_memory_gatt_client_cache_free(gatt_client_cache_t *gatt_client_cache){
+    BTSTACK_MEMORY_STATISTICS_FREE(gatt_client_cache);
+    btstack_memory_pool_free(&gatt_client_cache_pool, gatt_client_cache);
+}
+#else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t gatt_client_cache_statistics = { "gatt_client_cache", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+gatt_client_cache_t * btstack_memory_gatt_client_cache_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(gatt_client_cache, NULL);
+    return NULL;
+}
+void btstack_memory_gatt_client_cache_free(gatt_client_cache_t *gatt_client_cache){
+    UNUSED(gatt_client_cache);
+};
+#endif
+#elif defined(HAVE_MALLOC)
+
+typedef struct {
+    btstack_memory_buffer_t tracking;
+    gatt_client_cache_t data;
+} btstack_memory_gatt_client_cache_t;
+
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t gatt_client_cache_statistics = { "gatt_client_cache", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
+gatt_client_cache_t * btstack_memory_gatt_client_cache_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
+    btstack_memory_gatt_client_cache_t * buffer = (btstack_memory_gatt_client_cache_t *) malloc(sizeof(btstack_memory_gatt_client_cache_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(gatt_client_cache, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(gatt_client_cache, buffer);
+    if (buffer){
+        memset(buffer, 0, sizeof(btstack_memory_gatt_client_cache_t));
+        btstack_memory_tracking_add(&buffer->tracking);
+        return &buffer->data;
+    } else {
+        return NULL;
+    }
+}
+void btstack_memory_gatt_client_cache_free(gatt_client_cache_t *gatt_client_cache){
+    BTSTACK_MEMORY_STATISTICS_FREE(gatt_client_cache);
+    // reconstruct buffer start
+    btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) gatt_client_cache)[-1];
+    btstack_memory_tracking_remove(buffer);
+    free(buffer);
+}
+#endif
+
+
 #endif
 #ifdef ENABLE_MESH
 
@@ -1571,20 +2189,31 @@ void btstack_memory_periodic_advertiser_list_entry_free(periodic_advertiser_list
 
 #ifdef MAX_NR_MESH_NETWORK_PDUS
 #if MAX_NR_MESH_NETWORK_PDUS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static mesh_network_pdu_t mesh_network_pdu_storage[MAX_NR_MESH_NETWORK_PDUS];
+#endif
 static btstack_memory_pool_t mesh_network_pdu_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_network_pdu_statistics = { "mesh_network_pdu", MAX_NR_MESH_NETWORK_PDUS, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_network_pdu_t * btstack_memory_mesh_network_pdu_get(void){
     void * buffer = btstack_memory_pool_get(&mesh_network_pdu_pool);
     if (buffer){
         memset(buffer, 0, sizeof(mesh_network_pdu_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_network_pdu, buffer);
     return (mesh_network_pdu_t *) buffer;
 }
 void btstack_memory_mesh_network_pdu_free(mesh_network_pdu_t *mesh_network_pdu){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_network_pdu);
     btstack_memory_pool_free(&mesh_network_pdu_pool, mesh_network_pdu);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_network_pdu_statistics = { "mesh_network_pdu", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_network_pdu_t * btstack_memory_mesh_network_pdu_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_network_pdu, NULL);
     return NULL;
 }
 void btstack_memory_mesh_network_pdu_free(mesh_network_pdu_t *mesh_network_pdu){
@@ -1598,8 +2227,15 @@ typedef struct {
     mesh_network_pdu_t data;
 } btstack_memory_mesh_network_pdu_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_network_pdu_statistics = { "mesh_network_pdu", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 mesh_network_pdu_t * btstack_memory_mesh_network_pdu_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_mesh_network_pdu_t * buffer = (btstack_memory_mesh_network_pdu_t *) malloc(sizeof(btstack_memory_mesh_network_pdu_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(mesh_network_pdu, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_network_pdu, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_mesh_network_pdu_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1609,6 +2245,7 @@ mesh_network_pdu_t * btstack_memory_mesh_network_pdu_get(void){
     }
 }
 void btstack_memory_mesh_network_pdu_free(mesh_network_pdu_t *mesh_network_pdu){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_network_pdu);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) mesh_network_pdu)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1628,20 +2265,31 @@ void btstack_memory_mesh_network_pdu_free(mesh_network_pdu_t *mesh_network_pdu){
 
 #ifdef MAX_NR_MESH_SEGMENTED_PDUS
 #if MAX_NR_MESH_SEGMENTED_PDUS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static mesh_segmented_pdu_t mesh_segmented_pdu_storage[MAX_NR_MESH_SEGMENTED_PDUS];
+#endif
 static btstack_memory_pool_t mesh_segmented_pdu_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_segmented_pdu_statistics = { "mesh_segmented_pdu", MAX_NR_MESH_SEGMENTED_PDUS, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_segmented_pdu_t * btstack_memory_mesh_segmented_pdu_get(void){
     void * buffer = btstack_memory_pool_get(&mesh_segmented_pdu_pool);
     if (buffer){
         memset(buffer, 0, sizeof(mesh_segmented_pdu_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_segmented_pdu, buffer);
     return (mesh_segmented_pdu_t *) buffer;
 }
 void btstack_memory_mesh_segmented_pdu_free(mesh_segmented_pdu_t *mesh_segmented_pdu){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_segmented_pdu);
     btstack_memory_pool_free(&mesh_segmented_pdu_pool, mesh_segmented_pdu);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_segmented_pdu_statistics = { "mesh_segmented_pdu", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_segmented_pdu_t * btstack_memory_mesh_segmented_pdu_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_segmented_pdu, NULL);
     return NULL;
 }
 void btstack_memory_mesh_segmented_pdu_free(mesh_segmented_pdu_t *mesh_segmented_pdu){
@@ -1655,8 +2303,15 @@ typedef struct {
     mesh_segmented_pdu_t data;
 } btstack_memory_mesh_segmented_pdu_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_segmented_pdu_statistics = { "mesh_segmented_pdu", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 mesh_segmented_pdu_t * btstack_memory_mesh_segmented_pdu_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_mesh_segmented_pdu_t * buffer = (btstack_memory_mesh_segmented_pdu_t *) malloc(sizeof(btstack_memory_mesh_segmented_pdu_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(mesh_segmented_pdu, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_segmented_pdu, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_mesh_segmented_pdu_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1666,6 +2321,7 @@ mesh_segmented_pdu_t * btstack_memory_mesh_segmented_pdu_get(void){
     }
 }
 void btstack_memory_mesh_segmented_pdu_free(mesh_segmented_pdu_t *mesh_segmented_pdu){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_segmented_pdu);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) mesh_segmented_pdu)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1685,20 +2341,31 @@ void btstack_memory_mesh_segmented_pdu_free(mesh_segmented_pdu_t *mesh_segmented
 
 #ifdef MAX_NR_MESH_UPPER_TRANSPORT_PDUS
 #if MAX_NR_MESH_UPPER_TRANSPORT_PDUS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static mesh_upper_transport_pdu_t mesh_upper_transport_pdu_storage[MAX_NR_MESH_UPPER_TRANSPORT_PDUS];
+#endif
 static btstack_memory_pool_t mesh_upper_transport_pdu_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_upper_transport_pdu_statistics = { "mesh_upper_transport_pdu", MAX_NR_MESH_UPPER_TRANSPORT_PDUS, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_upper_transport_pdu_t * btstack_memory_mesh_upper_transport_pdu_get(void){
     void * buffer = btstack_memory_pool_get(&mesh_upper_transport_pdu_pool);
     if (buffer){
         memset(buffer, 0, sizeof(mesh_upper_transport_pdu_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_upper_transport_pdu, buffer);
     return (mesh_upper_transport_pdu_t *) buffer;
 }
 void btstack_memory_mesh_upper_transport_pdu_free(mesh_upper_transport_pdu_t *mesh_upper_transport_pdu){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_upper_transport_pdu);
     btstack_memory_pool_free(&mesh_upper_transport_pdu_pool, mesh_upper_transport_pdu);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_upper_transport_pdu_statistics = { "mesh_upper_transport_pdu", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_upper_transport_pdu_t * btstack_memory_mesh_upper_transport_pdu_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_upper_transport_pdu, NULL);
     return NULL;
 }
 void btstack_memory_mesh_upper_transport_pdu_free(mesh_upper_transport_pdu_t *mesh_upper_transport_pdu){
@@ -1712,8 +2379,15 @@ typedef struct {
     mesh_upper_transport_pdu_t data;
 } btstack_memory_mesh_upper_transport_pdu_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_upper_transport_pdu_statistics = { "mesh_upper_transport_pdu", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 mesh_upper_transport_pdu_t * btstack_memory_mesh_upper_transport_pdu_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_mesh_upper_transport_pdu_t * buffer = (btstack_memory_mesh_upper_transport_pdu_t *) malloc(sizeof(btstack_memory_mesh_upper_transport_pdu_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(mesh_upper_transport_pdu, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_upper_transport_pdu, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_mesh_upper_transport_pdu_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1723,6 +2397,7 @@ mesh_upper_transport_pdu_t * btstack_memory_mesh_upper_transport_pdu_get(void){
     }
 }
 void btstack_memory_mesh_upper_transport_pdu_free(mesh_upper_transport_pdu_t *mesh_upper_transport_pdu){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_upper_transport_pdu);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) mesh_upper_transport_pdu)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1742,20 +2417,31 @@ void btstack_memory_mesh_upper_transport_pdu_free(mesh_upper_transport_pdu_t *me
 
 #ifdef MAX_NR_MESH_NETWORK_KEYS
 #if MAX_NR_MESH_NETWORK_KEYS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static mesh_network_key_t mesh_network_key_storage[MAX_NR_MESH_NETWORK_KEYS];
+#endif
 static btstack_memory_pool_t mesh_network_key_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_network_key_statistics = { "mesh_network_key", MAX_NR_MESH_NETWORK_KEYS, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_network_key_t * btstack_memory_mesh_network_key_get(void){
     void * buffer = btstack_memory_pool_get(&mesh_network_key_pool);
     if (buffer){
         memset(buffer, 0, sizeof(mesh_network_key_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_network_key, buffer);
     return (mesh_network_key_t *) buffer;
 }
 void btstack_memory_mesh_network_key_free(mesh_network_key_t *mesh_network_key){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_network_key);
     btstack_memory_pool_free(&mesh_network_key_pool, mesh_network_key);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_network_key_statistics = { "mesh_network_key", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_network_key_t * btstack_memory_mesh_network_key_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_network_key, NULL);
     return NULL;
 }
 void btstack_memory_mesh_network_key_free(mesh_network_key_t *mesh_network_key){
@@ -1769,8 +2455,15 @@ typedef struct {
     mesh_network_key_t data;
 } btstack_memory_mesh_network_key_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_network_key_statistics = { "mesh_network_key", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 mesh_network_key_t * btstack_memory_mesh_network_key_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_mesh_network_key_t * buffer = (btstack_memory_mesh_network_key_t *) malloc(sizeof(btstack_memory_mesh_network_key_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(mesh_network_key, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_network_key, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_mesh_network_key_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1780,6 +2473,7 @@ mesh_network_key_t * btstack_memory_mesh_network_key_get(void){
     }
 }
 void btstack_memory_mesh_network_key_free(mesh_network_key_t *mesh_network_key){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_network_key);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) mesh_network_key)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1799,20 +2493,31 @@ void btstack_memory_mesh_network_key_free(mesh_network_key_t *mesh_network_key){
 
 #ifdef MAX_NR_MESH_TRANSPORT_KEYS
 #if MAX_NR_MESH_TRANSPORT_KEYS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static mesh_transport_key_t mesh_transport_key_storage[MAX_NR_MESH_TRANSPORT_KEYS];
+#endif
 static btstack_memory_pool_t mesh_transport_key_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_transport_key_statistics = { "mesh_transport_key", MAX_NR_MESH_TRANSPORT_KEYS, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_transport_key_t * btstack_memory_mesh_transport_key_get(void){
     void * buffer = btstack_memory_pool_get(&mesh_transport_key_pool);
     if (buffer){
         memset(buffer, 0, sizeof(mesh_transport_key_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_transport_key, buffer);
     return (mesh_transport_key_t *) buffer;
 }
 void btstack_memory_mesh_transport_key_free(mesh_transport_key_t *mesh_transport_key){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_transport_key);
     btstack_memory_pool_free(&mesh_transport_key_pool, mesh_transport_key);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_transport_key_statistics = { "mesh_transport_key", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_transport_key_t * btstack_memory_mesh_transport_key_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_transport_key, NULL);
     return NULL;
 }
 void btstack_memory_mesh_transport_key_free(mesh_transport_key_t *mesh_transport_key){
@@ -1826,8 +2531,15 @@ typedef struct {
     mesh_transport_key_t data;
 } btstack_memory_mesh_transport_key_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_transport_key_statistics = { "mesh_transport_key", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 mesh_transport_key_t * btstack_memory_mesh_transport_key_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_mesh_transport_key_t * buffer = (btstack_memory_mesh_transport_key_t *) malloc(sizeof(btstack_memory_mesh_transport_key_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(mesh_transport_key, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_transport_key, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_mesh_transport_key_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1837,6 +2549,7 @@ mesh_transport_key_t * btstack_memory_mesh_transport_key_get(void){
     }
 }
 void btstack_memory_mesh_transport_key_free(mesh_transport_key_t *mesh_transport_key){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_transport_key);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) mesh_transport_key)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1856,20 +2569,31 @@ void btstack_memory_mesh_transport_key_free(mesh_transport_key_t *mesh_transport
 
 #ifdef MAX_NR_MESH_VIRTUAL_ADDRESSS
 #if MAX_NR_MESH_VIRTUAL_ADDRESSS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static mesh_virtual_address_t mesh_virtual_address_storage[MAX_NR_MESH_VIRTUAL_ADDRESSS];
+#endif
 static btstack_memory_pool_t mesh_virtual_address_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_virtual_address_statistics = { "mesh_virtual_address", MAX_NR_MESH_VIRTUAL_ADDRESSS, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_virtual_address_t * btstack_memory_mesh_virtual_address_get(void){
     void * buffer = btstack_memory_pool_get(&mesh_virtual_address_pool);
     if (buffer){
         memset(buffer, 0, sizeof(mesh_virtual_address_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_virtual_address, buffer);
     return (mesh_virtual_address_t *) buffer;
 }
 void btstack_memory_mesh_virtual_address_free(mesh_virtual_address_t *mesh_virtual_address){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_virtual_address);
     btstack_memory_pool_free(&mesh_virtual_address_pool, mesh_virtual_address);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_virtual_address_statistics = { "mesh_virtual_address", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_virtual_address_t * btstack_memory_mesh_virtual_address_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_virtual_address, NULL);
     return NULL;
 }
 void btstack_memory_mesh_virtual_address_free(mesh_virtual_address_t *mesh_virtual_address){
@@ -1883,8 +2607,15 @@ typedef struct {
     mesh_virtual_address_t data;
 } btstack_memory_mesh_virtual_address_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_virtual_address_statistics = { "mesh_virtual_address", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 mesh_virtual_address_t * btstack_memory_mesh_virtual_address_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_mesh_virtual_address_t * buffer = (btstack_memory_mesh_virtual_address_t *) malloc(sizeof(btstack_memory_mesh_virtual_address_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(mesh_virtual_address, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_virtual_address, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_mesh_virtual_address_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1894,6 +2625,7 @@ mesh_virtual_address_t * btstack_memory_mesh_virtual_address_get(void){
     }
 }
 void btstack_memory_mesh_virtual_address_free(mesh_virtual_address_t *mesh_virtual_address){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_virtual_address);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) mesh_virtual_address)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1913,20 +2645,31 @@ void btstack_memory_mesh_virtual_address_free(mesh_virtual_address_t *mesh_virtu
 
 #ifdef MAX_NR_MESH_SUBNETS
 #if MAX_NR_MESH_SUBNETS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static mesh_subnet_t mesh_subnet_storage[MAX_NR_MESH_SUBNETS];
+#endif
 static btstack_memory_pool_t mesh_subnet_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_subnet_statistics = { "mesh_subnet", MAX_NR_MESH_SUBNETS, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_subnet_t * btstack_memory_mesh_subnet_get(void){
     void * buffer = btstack_memory_pool_get(&mesh_subnet_pool);
     if (buffer){
         memset(buffer, 0, sizeof(mesh_subnet_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_subnet, buffer);
     return (mesh_subnet_t *) buffer;
 }
 void btstack_memory_mesh_subnet_free(mesh_subnet_t *mesh_subnet){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_subnet);
     btstack_memory_pool_free(&mesh_subnet_pool, mesh_subnet);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_subnet_statistics = { "mesh_subnet", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 mesh_subnet_t * btstack_memory_mesh_subnet_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_subnet, NULL);
     return NULL;
 }
 void btstack_memory_mesh_subnet_free(mesh_subnet_t *mesh_subnet){
@@ -1940,8 +2683,15 @@ typedef struct {
     mesh_subnet_t data;
 } btstack_memory_mesh_subnet_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t mesh_subnet_statistics = { "mesh_subnet", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 mesh_subnet_t * btstack_memory_mesh_subnet_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_mesh_subnet_t * buffer = (btstack_memory_mesh_subnet_t *) malloc(sizeof(btstack_memory_mesh_subnet_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(mesh_subnet, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(mesh_subnet, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_mesh_subnet_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -1951,6 +2701,7 @@ mesh_subnet_t * btstack_memory_mesh_subnet_get(void){
     }
 }
 void btstack_memory_mesh_subnet_free(mesh_subnet_t *mesh_subnet){
+    BTSTACK_MEMORY_STATISTICS_FREE(mesh_subnet);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) mesh_subnet)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -1973,20 +2724,31 @@ void btstack_memory_mesh_subnet_free(mesh_subnet_t *mesh_subnet){
 
 #ifdef MAX_NR_HCI_ISO_STREAMS
 #if MAX_NR_HCI_ISO_STREAMS > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static hci_iso_stream_t hci_iso_stream_storage[MAX_NR_HCI_ISO_STREAMS];
+#endif
 static btstack_memory_pool_t hci_iso_stream_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hci_iso_stream_statistics = { "hci_iso_stream", MAX_NR_HCI_ISO_STREAMS, 0, 0, 0, 0, 0, 0 };
+#endif
 hci_iso_stream_t * btstack_memory_hci_iso_stream_get(void){
     void * buffer = btstack_memory_pool_get(&hci_iso_stream_pool);
     if (buffer){
         memset(buffer, 0, sizeof(hci_iso_stream_t));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(hci_iso_stream, buffer);
     return (hci_iso_stream_t *) buffer;
 }
 void btstack_memory_hci_iso_stream_free(hci_iso_stream_t *hci_iso_stream){
+    BTSTACK_MEMORY_STATISTICS_FREE(hci_iso_stream);
     btstack_memory_pool_free(&hci_iso_stream_pool, hci_iso_stream);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hci_iso_stream_statistics = { "hci_iso_stream", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 hci_iso_stream_t * btstack_memory_hci_iso_stream_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(hci_iso_stream, NULL);
     return NULL;
 }
 void btstack_memory_hci_iso_stream_free(hci_iso_stream_t *hci_iso_stream){
@@ -2000,8 +2762,15 @@ typedef struct {
     hci_iso_stream_t data;
 } btstack_memory_hci_iso_stream_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t hci_iso_stream_statistics = { "hci_iso_stream", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 hci_iso_stream_t * btstack_memory_hci_iso_stream_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_hci_iso_stream_t * buffer = (btstack_memory_hci_iso_stream_t *) malloc(sizeof(btstack_memory_hci_iso_stream_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(hci_iso_stream, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(hci_iso_stream, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_hci_iso_stream_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -2011,6 +2780,7 @@ hci_iso_stream_t * btstack_memory_hci_iso_stream_get(void){
     }
 }
 void btstack_memory_hci_iso_stream_free(hci_iso_stream_t *hci_iso_stream){
+    BTSTACK_MEMORY_STATISTICS_FREE(hci_iso_stream);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) hci_iso_stream)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -2021,133 +2791,470 @@ void btstack_memory_hci_iso_stream_free(hci_iso_stream_t *hci_iso_stream){
 
 #endif
 
+#ifdef ENABLE_BTSTACK_MEMORY_SLAB
+// single arena for all pools, keeps buffers close to each other instead of scattering them over individual arrays
+static struct {
+#ifdef MAX_NR_HCI_CONNECTIONS
+#if MAX_NR_HCI_CONNECTIONS > 0
+    hci_connection_t hci_connection[MAX_NR_HCI_CONNECTIONS];
+#endif
+#endif
+
+#ifdef MAX_NR_L2CAP_SERVICES
+#if MAX_NR_L2CAP_SERVICES > 0
+    l2cap_service_t l2cap_service[MAX_NR_L2CAP_SERVICES];
+#endif
+#endif
+#ifdef MAX_NR_L2CAP_CHANNELS
+#if MAX_NR_L2CAP_CHANNELS > 0
+    l2cap_channel_t l2cap_channel[MAX_NR_L2CAP_CHANNELS];
+#endif
+#endif
+
+#ifdef ENABLE_CLASSIC
+#ifdef MAX_NR_RFCOMM_MULTIPLEXERS
+#if MAX_NR_RFCOMM_MULTIPLEXERS > 0
+    rfcomm_multiplexer_t rfcomm_multiplexer[MAX_NR_RFCOMM_MULTIPLEXERS];
+#endif
+#endif
+#ifdef MAX_NR_RFCOMM_SERVICES
+#if MAX_NR_RFCOMM_SERVICES > 0
+    rfcomm_service_t rfcomm_service[MAX_NR_RFCOMM_SERVICES];
+#endif
+#endif
+#ifdef MAX_NR_RFCOMM_CHANNELS
+#if MAX_NR_RFCOMM_CHANNELS > 0
+    rfcomm_channel_t rfcomm_channel[MAX_NR_RFCOMM_CHANNELS];
+#endif
+#endif
+
+#ifdef MAX_NR_BTSTACK_LINK_KEY_DB_MEMORY_ENTRIES
+#if MAX_NR_BTSTACK_LINK_KEY_DB_MEMORY_ENTRIES > 0
+    btstack_link_key_db_memory_entry_t btstack_link_key_db_memory_entry[MAX_NR_BTSTACK_LINK_KEY_DB_MEMORY_ENTRIES];
+#endif
+#endif
+
+#ifdef MAX_NR_BNEP_SERVICES
+#if MAX_NR_BNEP_SERVICES > 0
+    bnep_service_t bnep_service[MAX_NR_BNEP_SERVICES];
+#endif
+#endif
+#ifdef MAX_NR_BNEP_CHANNELS
+#if MAX_NR_BNEP_CHANNELS > 0
+    bnep_channel_t bnep_channel[MAX_NR_BNEP_CHANNELS];
+#endif
+#endif
+
+#ifdef MAX_NR_GOEP_SERVER_SERVICES
+#if MAX_NR_GOEP_SERVER_SERVICES > 0
+    goep_server_service_t goep_server_service[MAX_NR_GOEP_SERVER_SERVICES];
+#endif
+#endif
+#ifdef MAX_NR_GOEP_SERVER_CONNECTIONS
+#if MAX_NR_GOEP_SERVER_CONNECTIONS > 0
+    goep_server_connection_t goep_server_connection[MAX_NR_GOEP_SERVER_CONNECTIONS];
+#endif
+#endif
+
+#ifdef MAX_NR_HFP_CONNECTIONS
+#if MAX_NR_HFP_CONNECTIONS > 0
+    hfp_connection_t hfp_connection[MAX_NR_HFP_CONNECTIONS];
+#endif
+#endif
+
+#ifdef MAX_NR_HID_HOST_CONNECTIONS
+#if MAX_NR_HID_HOST_CONNECTIONS > 0
+    hid_host_connection_t hid_host_connection[MAX_NR_HID_HOST_CONNECTIONS];
+#endif
+#endif
+
+#ifdef MAX_NR_SERVICE_RECORD_ITEMS
+#if MAX_NR_SERVICE_RECORD_ITEMS > 0
+    service_record_item_t service_record_item[MAX_NR_SERVICE_RECORD_ITEMS];
+#endif
+#endif
+
+#ifdef MAX_NR_AVDTP_STREAM_ENDPOINTS
+#if MAX_NR_AVDTP_STREAM_ENDPOINTS > 0
+    avdtp_stream_endpoint_t avdtp_stream_endpoint[MAX_NR_AVDTP_STREAM_ENDPOINTS];
+#endif
+#endif
+
+#ifdef MAX_NR_AVDTP_CONNECTIONS
+#if MAX_NR_AVDTP_CONNECTIONS > 0
+    avdtp_connection_t avdtp_connection[MAX_NR_AVDTP_CONNECTIONS];
+#endif
+#endif
+
+#ifdef MAX_NR_AVRCP_CONNECTIONS
+#if MAX_NR_AVRCP_CONNECTIONS > 0
+    avrcp_connection_t avrcp_connection[MAX_NR_AVRCP_CONNECTIONS];
+#endif
+#endif
+
+#ifdef MAX_NR_AVRCP_BROWSING_CONNECTIONS
+#if MAX_NR_AVRCP_BROWSING_CONNECTIONS > 0
+    avrcp_browsing_connection_t avrcp_browsing_connection[MAX_NR_AVRCP_BROWSING_CONNECTIONS];
+#endif
+#endif
+
+#endif
+#ifdef ENABLE_BLE
+#ifdef MAX_NR_BATTERY_SERVICE_CLIENTS
+#if MAX_NR_BATTERY_SERVICE_CLIENTS > 0
+    battery_service_client_t battery_service_client[MAX_NR_BATTERY_SERVICE_CLIENTS];
+#endif
+#endif
+#ifdef MAX_NR_GATT_CLIENTS
+#if MAX_NR_GATT_CLIENTS > 0
+    gatt_client_t gatt_client[MAX_NR_GATT_CLIENTS];
+#endif
+#endif
+#ifdef MAX_NR_HIDS_CLIENTS
+#if MAX_NR_HIDS_CLIENTS > 0
+    hids_client_t hids_client[MAX_NR_HIDS_CLIENTS];
+#endif
+#endif
+#ifdef MAX_NR_SCAN_PARAMETERS_SERVICE_CLIENTS
+#if MAX_NR_SCAN_PARAMETERS_SERVICE_CLIENTS > 0
+    scan_parameters_service_client_t scan_parameters_service_client[MAX_NR_SCAN_PARAMETERS_SERVICE_CLIENTS];
+#endif
+#endif
+#ifdef MAX_NR_SM_LOOKUP_ENTRIES
+#if MAX_NR_SM_LOOKUP_ENTRIES > 0
+    sm_lookup_entry_t sm_lookup_entry[MAX_NR_SM_LOOKUP_ENTRIES];
+#endif
+#endif
+#ifdef MAX_NR_WHITELIST_ENTRIES
+#if MAX_NR_WHITELIST_ENTRIES > 0
+    whitelist_entry_t whitelist_entry[MAX_NR_WHITELIST_ENTRIES];
+#endif
+#endif
+#ifdef MAX_NR_PERIODIC_ADVERTISER_LIST_ENTRIES
+#if MAX_NR_PERIODIC_ADVERTISER_LIST_ENTRIES > 0
+    periodic_advertiser_list_entry_t periodic_advertiser_list_entry[MAX_NR_PERIODIC_ADVERTISER_LIST_ENTRIES];
+#endif
+#endif
+
+#endif
+#ifdef ENABLE_GATT_CLIENT_CACHE
+#ifdef MAX_NR_GATT_CLIENT_CACHES
+#if MAX_NR_GATT_CLIENT_CACHES > 0
+    gatt_client_cache_t gatt_client_cache[MAX_NR_GATT_CLIENT_CACHES];
+#endif
+#endif
+
+#endif
+#ifdef ENABLE_MESH
+#ifdef MAX_NR_MESH_NETWORK_PDUS
+#if MAX_NR_MESH_NETWORK_PDUS > 0
+    mesh_network_pdu_t mesh_network_pdu[MAX_NR_MESH_NETWORK_PDUS];
+#endif
+#endif
+#ifdef MAX_NR_MESH_SEGMENTED_PDUS
+#if MAX_NR_MESH_SEGMENTED_PDUS > 0
+    mesh_segmented_pdu_t mesh_segmented_pdu[MAX_NR_MESH_SEGMENTED_PDUS];
+#endif
+#endif
+#ifdef MAX_NR_MESH_UPPER_TRANSPORT_PDUS
+#if MAX_NR_MESH_UPPER_TRANSPORT_PDUS > 0
+    mesh_upper_transport_pdu_t mesh_upper_transport_pdu[MAX_NR_MESH_UPPER_TRANSPORT_PDUS];
+#endif
+#endif
+#ifdef MAX_NR_MESH_NETWORK_KEYS
+#if MAX_NR_MESH_NETWORK_KEYS > 0
+    mesh_network_key_t mesh_network_key[MAX_NR_MESH_NETWORK_KEYS];
+#endif
+#endif
+#ifdef MAX_NR_MESH_TRANSPORT_KEYS
+#if MAX_NR_MESH_TRANSPORT_KEYS > 0
+    mesh_transport_key_t mesh_transport_key[MAX_NR_MESH_TRANSPORT_KEYS];
+#endif
+#endif
+#ifdef MAX_NR_MESH_VIRTUAL_ADDRESSS
+#if MAX_NR_MESH_VIRTUAL_ADDRESSS > 0
+    mesh_virtual_address_t mesh_virtual_address[MAX_NR_MESH_VIRTUAL_ADDRESSS];
+#endif
+#endif
+#ifdef MAX_NR_MESH_SUBNETS
+#if MAX_NR_MESH_SUBNETS > 0
+    mesh_subnet_t mesh_subnet[MAX_NR_MESH_SUBNETS];
+#endif
+#endif
+
+#endif
+#ifdef ENABLE_LE_ISOCHRONOUS_STREAMS
+#ifdef MAX_NR_HCI_ISO_STREAMS
+#if MAX_NR_HCI_ISO_STREAMS > 0
+    hci_iso_stream_t hci_iso_stream[MAX_NR_HCI_ISO_STREAMS];
+#endif
+#endif
+
+#endif
+    // ensure arena is not empty
+    uint8_t end;
+} btstack_memory_arena;
+#endif
+
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t * const btstack_memory_statistics_table[] = {
+    &hci_connection_statistics,
+
+    &l2cap_service_statistics,
+    &l2cap_channel_statistics,
+
+#ifdef ENABLE_CLASSIC
+    &rfcomm_multiplexer_statistics,
+    &rfcomm_service_statistics,
+    &rfcomm_channel_statistics,
+
+    &btstack_link_key_db_memory_entry_statistics,
+
+    &bnep_service_statistics,
+    &bnep_channel_statistics,
+
+    &goep_server_service_statistics,
+    &goep_server_connection_statistics,
+
+    &hfp_connection_statistics,
+
+    &hid_host_connection_statistics,
+
+    &service_record_item_statistics,
+
+    &avdtp_stream_endpoint_statistics,
+
+    &avdtp_connection_statistics,
+
+    &avrcp_connection_statistics,
+
+    &avrcp_browsing_connection_statistics,
+
+#endif
+#ifdef ENABLE_BLE
+    &battery_service_client_statistics,
+    &gatt_client_statistics,
+    &hids_client_statistics,
+    &scan_parameters_service_client_statistics,
+    &sm_lookup_entry_statistics,
+    &whitelist_entry_statistics,
+    &periodic_advertiser_list_entry_statistics,
+
+#endif
+#ifdef ENABLE_GATT_CLIENT_CACHE
+    &gatt_client_cache_statistics,
+
+#endif
+#ifdef ENABLE_MESH
+    &mesh_network_pdu_statistics,
+    &mesh_segmented_pdu_statistics,
+    &mesh_upper_transport_pdu_statistics,
+    &mesh_network_key_statistics,
+    &mesh_transport_key_statistics,
+    &mesh_virtual_address_statistics,
+    &mesh_subnet_statistics,
+
+#endif
+#ifdef ENABLE_LE_ISOCHRONOUS_STREAMS
+    &hci_iso_stream_statistics,
+
+#endif
+};
+
+static void btstack_memory_statistics_clear(void){
+    uint16_t i;
+    for (i = 0; i < btstack_memory_statistics_num_types(); i++){
+        btstack_memory_statistics_t * statistics = btstack_memory_statistics_table[i];
+        statistics->current = 0;
+        statistics->peak = 0;
+        statistics->allocations = 0;
+        statistics->failed = 0;
+        statistics->alloc_time_us_total = 0;
+        statistics->alloc_time_us_max = 0;
+    }
+}
+
+uint16_t btstack_memory_statistics_num_types(void){
+    return (uint16_t) (sizeof(btstack_memory_statistics_table) / sizeof(btstack_memory_statistics_t *));
+}
+
+const btstack_memory_statistics_t * btstack_memory_statistics_get(uint16_t index){
+    if (index >= btstack_memory_statistics_num_types()){
+        return NULL;
+    }
+    return btstack_memory_statistics_table[index];
+}
+
+void btstack_memory_statistics_reset(void){
+    uint16_t i;
+    for (i = 0; i < btstack_memory_statistics_num_types(); i++){
+        btstack_memory_statistics_t * statistics = btstack_memory_statistics_table[i];
+        statistics->peak = statistics->current;
+        statistics->allocations = 0;
+        statistics->failed = 0;
+        statistics->alloc_time_us_total = 0;
+        statistics->alloc_time_us_max = 0;
+    }
+}
+
+void btstack_memory_statistics_dump(void){
+#ifdef ENABLE_BTSTACK_MEMORY_SLAB
+    log_info("btstack_memory: arena %u bytes", (unsigned int) sizeof(btstack_memory_arena));
+#endif
+    uint16_t i;
+    for (i = 0; i < btstack_memory_statistics_num_types(); i++){
+        const btstack_memory_statistics_t * statistics = btstack_memory_statistics_table[i];
+        if ((statistics->pool_size == 0u) && (statistics->allocations == 0u) && (statistics->failed == 0u)){
+            continue;
+        }
+        log_info("%s: %u of %u in use, peak %u, %u allocations, %u failed, malloc max %u us, total %u us",
+                 statistics->name, statistics->current, statistics->pool_size, statistics->peak,
+                 (unsigned int) statistics->allocations, (unsigned int) statistics->failed,
+                 (unsigned int) statistics->alloc_time_us_max, (unsigned int) statistics->alloc_time_us_total);
+    }
+}
+
+void btstack_memory_statistics_set_time_source(uint32_t (*get_time_us)(void)){
+    btstack_memory_statistics_get_time_us = get_time_us;
+}
+#endif
+
 // init
 void btstack_memory_init(void){
 #ifdef HAVE_MALLOC
     // assert that there is no unexpected padding for combined buffer
     btstack_assert(sizeof(test_buffer_t) == sizeof(btstack_memory_buffer_t) + sizeof(void *));
 #endif
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+    btstack_memory_statistics_clear();
+#endif
   
 #if MAX_NR_HCI_CONNECTIONS > 0
-    btstack_memory_pool_create(&hci_connection_pool, hci_connection_storage, MAX_NR_HCI_CONNECTIONS, sizeof(hci_connection_t));
+    btstack_memory_pool_create(&hci_connection_pool, BTSTACK_MEMORY_STORAGE(hci_connection), MAX_NR_HCI_CONNECTIONS, sizeof(hci_connection_t));
 #endif
 
 #if MAX_NR_L2CAP_SERVICES > 0
-    btstack_memory_pool_create(&l2cap_service_pool, l2cap_service_storage, MAX_NR_L2CAP_SERVICES, sizeof(l2cap_service_t));
+    btstack_memory_pool_create(&l2cap_service_pool, BTSTACK_MEMORY_STORAGE(l2cap_service), MAX_NR_L2CAP_SERVICES, sizeof(l2cap_service_t));
 #endif
 #if MAX_NR_L2CAP_CHANNELS > 0
-    btstack_memory_pool_create(&l2cap_channel_pool, l2cap_channel_storage, MAX_NR_L2CAP_CHANNELS, sizeof(l2cap_channel_t));
+    btstack_memory_pool_create(&l2cap_channel_pool, BTSTACK_MEMORY_STORAGE(l2cap_channel), MAX_NR_L2CAP_CHANNELS, sizeof(l2cap_channel_t));
 #endif
 
 #ifdef ENABLE_CLASSIC
 #if MAX_NR_RFCOMM_MULTIPLEXERS > 0
-    btstack_memory_pool_create(&rfcomm_multiplexer_pool, rfcomm_multiplexer_storage, MAX_NR_RFCOMM_MULTIPLEXERS, sizeof(rfcomm_multiplexer_t));
+    btstack_memory_pool_create(&rfcomm_multiplexer_pool, BTSTACK_MEMORY_STORAGE(rfcomm_multiplexer), MAX_NR_RFCOMM_MULTIPLEXERS, sizeof(rfcomm_multiplexer_t));
 #endif
 #if MAX_NR_RFCOMM_SERVICES > 0
-    btstack_memory_pool_create(&rfcomm_service_pool, rfcomm_service_storage, MAX_NR_RFCOMM_SERVICES, sizeof(rfcomm_service_t));
+    btstack_memory_pool_create(&rfcomm_service_pool, BTSTACK_MEMORY_STORAGE(rfcomm_service), MAX_NR_RFCOMM_SERVICES, sizeof(rfcomm_service_t));
 #endif
 #if MAX_NR_RFCOMM_CHANNELS > 0
-    btstack_memory_pool_create(&rfcomm_channel_pool, rfcomm_channel_storage, MAX_NR_RFCOMM_CHANNELS, sizeof(rfcomm_channel_t));
+    btstack_memory_pool_create(&rfcomm_channel_pool, BTSTACK_MEMORY_STORAGE(rfcomm_channel), MAX_NR_RFCOMM_CHANNELS, sizeof(rfcomm_channel_t));
 #endif
 
 #if MAX_NR_BTSTACK_LINK_KEY_DB_MEMORY_ENTRIES > 0
-    btstack_memory_pool_create(&btstack_link_key_db_memory_entry_pool, btstack_link_key_db_memory_entry_storage, MAX_NR_BTSTACK_LINK_KEY_DB_MEMORY_ENTRIES, sizeof(btstack_link_key_db_memory_entry_t));
+    btstack_memory_pool_create(&btstack_link_key_db_memory_entry_pool, BTSTACK_MEMORY_STORAGE(btstack_link_key_db_memory_entry), MAX_NR_BTSTACK_LINK_KEY_DB_MEMORY_ENTRIES, sizeof(btstack_link_key_db_memory_entry_t));
 #endif
 
 #if MAX_NR_BNEP_SERVICES > 0
-    btstack_memory_pool_create(&bnep_service_pool, bnep_service_storage, MAX_NR_BNEP_SERVICES, sizeof(bnep_service_t));
+    btstack_memory_pool_create(&bnep_service_pool, BTSTACK_MEMORY_STORAGE(bnep_service), MAX_NR_BNEP_SERVICES, sizeof(bnep_service_t));
 #endif
 #if MAX_NR_BNEP_CHANNELS > 0
-    btstack_memory_pool_create(&bnep_channel_pool, bnep_channel_storage, MAX_NR_BNEP_CHANNELS, sizeof(bnep_channel_t));
+    btstack_memory_pool_create(&bnep_channel_pool, BTSTACK_MEMORY_STORAGE(bnep_channel), MAX_NR_BNEP_CHANNELS, sizeof(bnep_channel_t));
 #endif
 
 #if MAX_NR_GOEP_SERVER_SERVICES > 0
-    btstack_memory_pool_create(&goep_server_service_pool, goep_server_service_storage, MAX_NR_GOEP_SERVER_SERVICES, sizeof(goep_server_service_t));
+    btstack_memory_pool_create(&goep_server_service_pool, BTSTACK_MEMORY_STORAGE(goep_server_service), MAX_NR_GOEP_SERVER_SERVICES, sizeof(goep_server_service_t));
 #endif
 #if MAX_NR_GOEP_SERVER_CONNECTIONS > 0
-    btstack_memory_pool_create(&goep_server_connection_pool, goep_server_connection_storage, MAX_NR_GOEP_SERVER_CONNECTIONS, sizeof(goep_server_connection_t));
+    btstack_memory_pool_create(&goep_server_connection_pool, BTSTACK_MEMORY_STORAGE(goep_server_connection), MAX_NR_GOEP_SERVER_CONNECTIONS, sizeof(goep_server_connection_t));
 #endif
 
 #if MAX_NR_HFP_CONNECTIONS > 0
-    btstack_memory_pool_create(&hfp_connection_pool, hfp_connection_storage, MAX_NR_HFP_CONNECTIONS, sizeof(hfp_connection_t));
+    btstack_memory_pool_create(&hfp_connection_pool, BTSTACK_MEMORY_STORAGE(hfp_connection), MAX_NR_HFP_CONNECTIONS, sizeof(hfp_connection_t));
 #endif
 
 #if MAX_NR_HID_HOST_CONNECTIONS > 0
-    btstack_memory_pool_create(&hid_host_connection_pool, hid_host_connection_storage, MAX_NR_HID_HOST_CONNECTIONS, sizeof(hid_host_connection_t));
+    btstack_memory_pool_create(&hid_host_connection_pool, BTSTACK_MEMORY_STORAGE(hid_host_connection), MAX_NR_HID_HOST_CONNECTIONS, sizeof(hid_host_connection_t));
 #endif
 
 #if MAX_NR_SERVICE_RECORD_ITEMS > 0
-    btstack_memory_pool_create(&service_record_item_pool, service_record_item_storage, MAX_NR_SERVICE_RECORD_ITEMS, sizeof(service_record_item_t));
+    btstack_memory_pool_create(&service_record_item_pool, BTSTACK_MEMORY_STORAGE(service_record_item), MAX_NR_SERVICE_RECORD_ITEMS, sizeof(service_record_item_t));
 #endif
 
 #if MAX_NR_AVDTP_STREAM_ENDPOINTS > 0
-    btstack_memory_pool_create(&avdtp_stream_endpoint_pool, avdtp_stream_endpoint_storage, MAX_NR_AVDTP_STREAM_ENDPOINTS, sizeof(avdtp_stream_endpoint_t));
+    btstack_memory_pool_create(&avdtp_stream_endpoint_pool, BTSTACK_MEMORY_STORAGE(avdtp_stream_endpoint), MAX_NR_AVDTP_STREAM_ENDPOINTS, sizeof(avdtp_stream_endpoint_t));
 #endif
 
 #if MAX_NR_AVDTP_CONNECTIONS > 0
-    btstack_memory_pool_create(&avdtp_connection_pool, avdtp_connection_storage, MAX_NR_AVDTP_CONNECTIONS, sizeof(avdtp_connection_t));
+    btstack_memory_pool_create(&avdtp_connection_pool, BTSTACK_MEMORY_STORAGE(avdtp_connection), MAX_NR_AVDTP_CONNECTIONS, sizeof(avdtp_connection_t));
 #endif
 
 #if MAX_NR_AVRCP_CONNECTIONS > 0
-    btstack_memory_pool_create(&avrcp_connection_pool, avrcp_connection_storage, MAX_NR_AVRCP_CONNECTIONS, sizeof(avrcp_connection_t));
+    btstack_memory_pool_create(&avrcp_connection_pool, BTSTACK_MEMORY_STORAGE(avrcp_connection), MAX_NR_AVRCP_CONNECTIONS, sizeof(avrcp_connection_t));
 #endif
 
 #if MAX_NR_AVRCP_BROWSING_CONNECTIONS > 0
-    btstack_memory_pool_create(&avrcp_browsing_connection_pool, avrcp_browsing_connection_storage, MAX_NR_AVRCP_BROWSING_CONNECTIONS, sizeof(avrcp_browsing_connection_t));
+    btstack_memory_pool_create(&avrcp_browsing_connection_pool, BTSTACK_MEMORY_STORAGE(avrcp_browsing_connection), MAX_NR_AVRCP_BROWSING_CONNECTIONS, sizeof(avrcp_browsing_connection_t));
 #endif
 
 #endif
 #ifdef ENABLE_BLE
 #if MAX_NR_BATTERY_SERVICE_CLIENTS > 0
-    btstack_memory_pool_create(&battery_service_client_pool, battery_service_client_storage, MAX_NR_BATTERY_SERVICE_CLIENTS, sizeof(battery_service_client_t));
+    btstack_memory_pool_create(&battery_service_client_pool, BTSTACK_MEMORY_STORAGE(battery_service_client), MAX_NR_BATTERY_SERVICE_CLIENTS, sizeof(battery_service_client_t));
 #endif
 #if MAX_NR_GATT_CLIENTS > 0
-    btstack_memory_pool_create(&gatt_client_pool, gatt_client_storage, MAX_NR_GATT_CLIENTS, sizeof(gatt_client_t));
+    btstack_memory_pool_create(&gatt_client_pool, BTSTACK_MEMORY_STORAGE(gatt_client), MAX_NR_GATT_CLIENTS, sizeof(gatt_client_t));
 #endif
 #if MAX_NR_HIDS_CLIENTS > 0
-    btstack_memory_pool_create(&hids_client_pool, hids_client_storage, MAX_NR_HIDS_CLIENTS, sizeof(hids_client_t));
+    btstack_memory_pool_create(&hids_client_pool, BTSTACK_MEMORY_STORAGE(hids_client), MAX_NR_HIDS_CLIENTS, sizeof(hids_client_t));
 #endif
 #if MAX_NR_SCAN_PARAMETERS_SERVICE_CLIENTS > 0
-    btstack_memory_pool_create(&scan_parameters_service_client_pool, scan_parameters_service_client_storage, MAX_NR_SCAN_PARAMETERS_SERVICE_CLIENTS, sizeof(scan_parameters_service_client_t));
+    btstack_memory_pool_create(&scan_parameters_service_client_pool, BTSTACK_MEMORY_STORAGE(scan_parameters_service_client), MAX_NR_SCAN_PARAMETERS_SERVICE_CLIENTS, sizeof(scan_parameters_service_client_t));
 #endif
 #if MAX_NR_SM_LOOKUP_ENTRIES > 0
-    btstack_memory_pool_create(&sm_lookup_entry_pool, sm_lookup_entry_storage, MAX_NR_SM_LOOKUP_ENTRIES, sizeof(sm_lookup_entry_t));
+    btstack_memory_pool_create(&sm_lookup_entry_pool, BTSTACK_MEMORY_STORAGE(sm_lookup_entry), MAX_NR_SM_LOOKUP_ENTRIES, sizeof(sm_lookup_entry_t));
 #endif
 #if MAX_NR_WHITELIST_ENTRIES > 0
-    btstack_memory_pool_create(&whitelist_entry_pool, whitelist_entry_storage, MAX_NR_WHITELIST_ENTRIES, sizeof(whitelist_entry_t));
+    btstack_memory_pool_create(&whitelist_entry_pool, BTSTACK_MEMORY_STORAGE(whitelist_entry), MAX_NR_WHITELIST_ENTRIES, sizeof(whitelist_entry_t));
 #endif
 #if MAX_NR_PERIODIC_ADVERTISER_LIST_ENTRIES > 0
-    btstack_memory_pool_create(&periodic_advertiser_list_entry_pool, periodic_advertiser_list_entry_storage, MAX_NR_PERIODIC_ADVERTISER_LIST_ENTRIES, sizeof(periodic_advertiser_list_entry_t));
+    btstack_memory_pool_create(&periodic_advertiser_list_entry_pool, BTSTACK_MEMORY_STORAGE(periodic_advertiser_list_entry), MAX_NR_PERIODIC_ADVERTISER_LIST_ENTRIES, sizeof(periodic_advertiser_list_entry_t));
+#endif
+
+#endif
+#ifdef ENABLE_GATT_CLIENT_CACHE
+#if MAX_NR_GATT_CLIENT_CACHES > 0
+    btstack_memory_pool_create(&gatt_client_cache_pool, BTSTACK_MEMORY_STORAGE(gatt_client_cache), MAX_NR_GATT_CLIENT_CACHES, sizeof(gatt_client_cache_t));
 #endif
 
 #endif
 #ifdef ENABLE_MESH
 #if MAX_NR_MESH_NETWORK_PDUS > 0
-    btstack_memory_pool_create(&mesh_network_pdu_pool, mesh_network_pdu_storage, MAX_NR_MESH_NETWORK_PDUS, sizeof(mesh_network_pdu_t));
+    btstack_memory_pool_create(&mesh_network_pdu_pool, BTSTACK_MEMORY_STORAGE(mesh_network_pdu), MAX_NR_MESH_NETWORK_PDUS, sizeof(mesh_network_pdu_t));
 #endif
 #if MAX_NR_MESH_SEGMENTED_PDUS > 0
-    btstack_memory_pool_create(&mesh_segmented_pdu_pool, mesh_segmented_pdu_storage, MAX_NR_MESH_SEGMENTED_PDUS, sizeof(mesh_segmented_pdu_t));
+    btstack_memory_pool_create(&mesh_segmented_pdu_pool, BTSTACK_MEMORY_STORAGE(mesh_segmented_pdu), MAX_NR_MESH_SEGMENTED_PDUS, sizeof(mesh_segmented_pdu_t));
 #endif
 #if MAX_NR_MESH_UPPER_TRANSPORT_PDUS > 0
-    btstack_memory_pool_create(&mesh_upper_transport_pdu_pool, mesh_upper_transport_pdu_storage, MAX_NR_MESH_UPPER_TRANSPORT_PDUS, sizeof(mesh_upper_transport_pdu_t));
+    btstack_memory_pool_create(&mesh_upper_transport_pdu_pool, BTSTACK_MEMORY_STORAGE(mesh_upper_transport_pdu), MAX_NR_MESH_UPPER_TRANSPORT_PDUS, sizeof(mesh_upper_transport_pdu_t));
 #endif
 #if MAX_NR_MESH_NETWORK_KEYS > 0
-    btstack_memory_pool_create(&mesh_network_key_pool, mesh_network_key_storage, MAX_NR_MESH_NETWORK_KEYS, sizeof(mesh_network_key_t));
+    btstack_memory_pool_create(&mesh_network_key_pool, BTSTACK_MEMORY_STORAGE(mesh_network_key), MAX_NR_MESH_NETWORK_KEYS, sizeof(mesh_network_key_t));
 #endif
 #if MAX_NR_MESH_TRANSPORT_KEYS > 0
-    btstack_memory_pool_create(&mesh_transport_key_pool, mesh_transport_key_storage, MAX_NR_MESH_TRANSPORT_KEYS, sizeof(mesh_transport_key_t));
+    btstack_memory_pool_create(&mesh_transport_key_pool, BTSTACK_MEMORY_STORAGE(mesh_transport_key), MAX_NR_MESH_TRANSPORT_KEYS, sizeof(mesh_transport_key_t));
 #endif
 #if MAX_NR_MESH_VIRTUAL_ADDRESSS > 0
-    btstack_memory_pool_create(&mesh_virtual_address_pool, mesh_virtual_address_storage, MAX_NR_MESH_VIRTUAL_ADDRESSS, sizeof(mesh_virtual_address_t));
+    btstack_memory_pool_create(&mesh_virtual_address_pool, BTSTACK_MEMORY_STORAGE(mesh_virtual_address), MAX_NR_MESH_VIRTUAL_ADDRESSS, sizeof(mesh_virtual_address_t));
 #endif
 #if MAX_NR_MESH_SUBNETS > 0
-    btstack_memory_pool_create(&mesh_subnet_pool, mesh_subnet_storage, MAX_NR_MESH_SUBNETS, sizeof(mesh_subnet_t));
+    btstack_memory_pool_create(&mesh_subnet_pool, BTSTACK_MEMORY_STORAGE(mesh_subnet), MAX_NR_MESH_SUBNETS, sizeof(mesh_subnet_t));
 #endif
 
 #endif
 #ifdef ENABLE_LE_ISOCHRONOUS_STREAMS
 #if MAX_NR_HCI_ISO_STREAMS > 0
-    btstack_memory_pool_create(&hci_iso_stream_pool, hci_iso_stream_storage, MAX_NR_HCI_ISO_STREAMS, sizeof(hci_iso_stream_t));
+    btstack_memory_pool_create(&hci_iso_stream_pool, BTSTACK_MEMORY_STORAGE(hci_iso_stream), MAX_NR_HCI_ISO_STREAMS, sizeof(hci_iso_stream_t));
 #endif
 
 #endif
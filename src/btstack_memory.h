@@ -87,6 +87,22 @@ extern "C" {
 #include "mesh/mesh_virtual_addresses.h"
 #endif
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+typedef struct {
+    const char * name;
+    // number of buffers in static pool, 0 for malloc
+    uint16_t pool_size;
+    // buffers in use and max buffers in use since init or last reset
+    uint16_t current;
+    uint16_t peak;
+    uint32_t allocations;
+    uint32_t failed;
+    // time spent in malloc, only if time source is set
+    uint32_t alloc_time_us_total;
+    uint32_t alloc_time_us_max;
+} btstack_memory_statistics_t;
+#endif
+
 /* API_START */
 
 /**
@@ -100,6 +116,38 @@ void btstack_memory_init(void);
  */
 void btstack_memory_deinit(void);
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+/**
+ * @brief Get number of buffer types with statistics
+ * @return num types
+ */
+uint16_t btstack_memory_statistics_num_types(void);
+
+/**
+ * @brief Get usage statistics for buffer type
+ * @param index < btstack_memory_statistics_num_types()
+ * @return statistics or NULL if index invalid
+ */
+const btstack_memory_statistics_t * btstack_memory_statistics_get(uint16_t index);
+
+/**
+ * @brief Reset peak usage to current usage and clear allocation counters
+ */
+void btstack_memory_statistics_reset(void);
+
+/**
+ * @brief Log statistics for all buffer types that have been used or are configured via log_info, which ends up
+ *        in the HCI dump / packet log
+ */
+void btstack_memory_statistics_dump(void);
+
+/**
+ * @brief Set microsecond time source to measure time spent in malloc
+ * @param get_time_us or NULL to disable measurement
+ */
+void btstack_memory_statistics_set_time_source(uint32_t (*get_time_us)(void));
+#endif
+
 /* API_END */
 
 hci_connection_t * btstack_memory_hci_connection_get(void);
@@ -169,6 +217,11 @@ void   btstack_memory_whitelist_entry_free(whitelist_entry_t *whitelist_entry);
 periodic_advertiser_list_entry_t * btstack_memory_periodic_advertiser_list_entry_get(void);
 void   btstack_memory_periodic_advertiser_list_entry_free(periodic_advertiser_list_entry_t *periodic_advertiser_list_entry);
 
+#endif
+#ifdef ENABLE_GATT_CLIENT_CACHE
+gatt_client_cache_t * btstack_memory_gatt_client_cache_get(void);
+void   btstack_memory_gatt_client_cache_free(gatt_client_cache_t *gatt_client_cache);
+
 #endif
 #ifdef ENABLE_MESH
 mesh_network_pdu_t * btstack_memory_mesh_network_pdu_get(void);
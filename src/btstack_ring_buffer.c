@@ -45,10 +45,14 @@
 #include <string.h>
 
 #include "btstack_ring_buffer.h"
+#include "btstack_debug.h"
 #include "btstack_util.h"
 
 #define ERROR_CODE_MEMORY_CAPACITY_EXCEEDED 0x07
 
+// transfers up to this size are copied bytewise instead of calling memcpy
+#define BTSTACK_RING_BUFFER_SMALL_TRANSFER 8
+
 
 // init ring buffer
 void btstack_ring_buffer_init(btstack_ring_buffer_t * ring_buffer, uint8_t * storage, uint32_t storage_size){
@@ -153,3 +157,130 @@ void btstack_ring_buffer_read(btstack_ring_buffer_t * ring_buffer, uint8_t * dat
     ring_buffer->full = 0;
 } 
 
+uint32_t btstack_ring_buffer_get_write_span(btstack_ring_buffer_t * ring_buffer, uint8_t ** span){
+    *span = &ring_buffer->storage[ring_buffer->last_written_index];
+    if (ring_buffer->full) return 0;
+    if (ring_buffer->last_written_index < ring_buffer->last_read_index){
+        return ring_buffer->last_read_index - ring_buffer->last_written_index;
+    }
+    return ring_buffer->size - ring_buffer->last_written_index;
+}
+
+void btstack_ring_buffer_commit_write(btstack_ring_buffer_t * ring_buffer, uint32_t num_bytes){
+    if (num_bytes == 0u) return;
+    ring_buffer->last_written_index += num_bytes;
+    if (ring_buffer->last_written_index == ring_buffer->size){
+        ring_buffer->last_written_index = 0;
+    }
+    if (ring_buffer->last_written_index == ring_buffer->last_read_index){
+        ring_buffer->full = 1;
+    }
+}
+
+uint32_t btstack_ring_buffer_get_read_span(btstack_ring_buffer_t * ring_buffer, const uint8_t ** span){
+    *span = &ring_buffer->storage[ring_buffer->last_read_index];
+    if (ring_buffer->last_read_index < ring_buffer->last_written_index){
+        return ring_buffer->last_written_index - ring_buffer->last_read_index;
+    }
+    if ((ring_buffer->last_read_index == ring_buffer->last_written_index) && (ring_buffer->full == 0u)){
+        return 0;
+    }
+    return ring_buffer->size - ring_buffer->last_read_index;
+}
+
+void btstack_ring_buffer_commit_read(btstack_ring_buffer_t * ring_buffer, uint32_t num_bytes){
+    if (num_bytes == 0u) return;
+    ring_buffer->last_read_index += num_bytes;
+    if (ring_buffer->last_read_index == ring_buffer->size){
+        ring_buffer->last_read_index = 0;
+    }
+    ring_buffer->full = 0;
+}
+
+// power-of-two capacity
+
+void btstack_ring_buffer_pow2_init(btstack_ring_buffer_pow2_t * ring_buffer, uint8_t * storage, uint32_t storage_size){
+    btstack_assert((storage_size > 0u) && ((storage_size & (storage_size - 1u)) == 0u));
+    ring_buffer->storage = storage;
+    ring_buffer->size = storage_size;
+    ring_buffer->mask = storage_size - 1u;
+    btstack_ring_buffer_pow2_reset(ring_buffer);
+}
+
+void btstack_ring_buffer_pow2_reset(btstack_ring_buffer_pow2_t * ring_buffer){
+    ring_buffer->read_index = 0;
+    ring_buffer->write_index = 0;
+}
+
+int btstack_ring_buffer_pow2_empty(btstack_ring_buffer_pow2_t * ring_buffer){
+    return ring_buffer->read_index == ring_buffer->write_index;
+}
+
+uint32_t btstack_ring_buffer_pow2_bytes_available(btstack_ring_buffer_pow2_t * ring_buffer){
+    return ring_buffer->write_index - ring_buffer->read_index;
+}
+
+uint32_t btstack_ring_buffer_pow2_bytes_free(btstack_ring_buffer_pow2_t * ring_buffer){
+    return ring_buffer->size - (ring_buffer->write_index - ring_buffer->read_index);
+}
+
+int btstack_ring_buffer_pow2_write(btstack_ring_buffer_pow2_t * ring_buffer, const uint8_t * data, uint32_t data_length){
+    if (btstack_ring_buffer_pow2_bytes_free(ring_buffer) < data_length){
+        return ERROR_CODE_MEMORY_CAPACITY_EXCEEDED;
+    }
+    uint32_t offset = ring_buffer->write_index & ring_buffer->mask;
+    uint32_t bytes_until_end = ring_buffer->size - offset;
+    if (data_length <= BTSTACK_RING_BUFFER_SMALL_TRANSFER){
+        // small transfers, e.g. queued pointers or HID reports: copy bytewise with masked index
+        uint32_t i;
+        for (i = 0; i < data_length; i++){
+            ring_buffer->storage[(ring_buffer->write_index + i) & ring_buffer->mask] = data[i];
+        }
+    } else if (data_length <= bytes_until_end){
+        (void)memcpy(&ring_buffer->storage[offset], data, data_length);
+    } else {
+        (void)memcpy(&ring_buffer->storage[offset], data, bytes_until_end);
+        (void)memcpy(&ring_buffer->storage[0], &data[bytes_until_end], data_length - bytes_until_end);
+    }
+    ring_buffer->write_index += data_length;
+    return ERROR_CODE_SUCCESS;
+}
+
+void btstack_ring_buffer_pow2_read(btstack_ring_buffer_pow2_t * ring_buffer, uint8_t * buffer, uint32_t length, uint32_t * number_of_bytes_read){
+    uint32_t bytes_to_read = btstack_min(length, ring_buffer->write_index - ring_buffer->read_index);
+    *number_of_bytes_read = bytes_to_read;
+    uint32_t offset = ring_buffer->read_index & ring_buffer->mask;
+    uint32_t bytes_until_end = ring_buffer->size - offset;
+    if (bytes_to_read <= BTSTACK_RING_BUFFER_SMALL_TRANSFER){
+        uint32_t i;
+        for (i = 0; i < bytes_to_read; i++){
+            buffer[i] = ring_buffer->storage[(ring_buffer->read_index + i) & ring_buffer->mask];
+        }
+    } else if (bytes_to_read <= bytes_until_end){
+        (void)memcpy(buffer, &ring_buffer->storage[offset], bytes_to_read);
+    } else {
+        (void)memcpy(buffer, &ring_buffer->storage[offset], bytes_until_end);
+        (void)memcpy(&buffer[bytes_until_end], &ring_buffer->storage[0], bytes_to_read - bytes_until_end);
+    }
+    ring_buffer->read_index += bytes_to_read;
+}
+
+uint32_t btstack_ring_buffer_pow2_get_write_span(btstack_ring_buffer_pow2_t * ring_buffer, uint8_t ** span){
+    uint32_t offset = ring_buffer->write_index & ring_buffer->mask;
+    *span = &ring_buffer->storage[offset];
+    return btstack_min(btstack_ring_buffer_pow2_bytes_free(ring_buffer), ring_buffer->size - offset);
+}
+
+void btstack_ring_buffer_pow2_commit_write(btstack_ring_buffer_pow2_t * ring_buffer, uint32_t num_bytes){
+    ring_buffer->write_index += num_bytes;
+}
+
+uint32_t btstack_ring_buffer_pow2_get_read_span(btstack_ring_buffer_pow2_t * ring_buffer, const uint8_t ** span){
+    uint32_t offset = ring_buffer->read_index & ring_buffer->mask;
+    *span = &ring_buffer->storage[offset];
+    return btstack_min(btstack_ring_buffer_pow2_bytes_available(ring_buffer), ring_buffer->size - offset);
+}
+
+void btstack_ring_buffer_pow2_commit_read(btstack_ring_buffer_pow2_t * ring_buffer, uint32_t num_bytes){
+    ring_buffer->read_index += num_bytes;
+}
@@ -57,6 +57,15 @@ typedef struct btstack_ring_buffer {
     uint8_t  full;
 } btstack_ring_buffer_t;
 
+// power-of-two capacity, indices are free running and masked on access
+typedef struct btstack_ring_buffer_pow2 {
+    uint8_t  * storage;
+    uint32_t size;
+    uint32_t mask;
+    uint32_t read_index;
+    uint32_t write_index;
+} btstack_ring_buffer_pow2_t;
+
 /* API_START */
 
 /**
@@ -112,6 +121,119 @@ int btstack_ring_buffer_write(btstack_ring_buffer_t * ring_buffer, uint8_t * dat
  */
 void btstack_ring_buffer_read(btstack_ring_buffer_t * ring_buffer, uint8_t * buffer, uint32_t length, uint32_t * number_of_bytes_read); 
 
+/**
+ * Get contiguous free space at write position, e.g. to decode directly into the ring buffer
+ * @param ring_buffer object
+ * @param span points to free space on return
+ * @return number of bytes that can be written to span
+ */
+uint32_t btstack_ring_buffer_get_write_span(btstack_ring_buffer_t * ring_buffer, uint8_t ** span);
+
+/**
+ * Mark bytes written to write span as available for read
+ * @param ring_buffer object
+ * @param num_bytes written, not more than returned by get_write_span
+ */
+void btstack_ring_buffer_commit_write(btstack_ring_buffer_t * ring_buffer, uint32_t num_bytes);
+
+/**
+ * Get contiguous data at read position, e.g. to process data without copying it
+ * @param ring_buffer object
+ * @param span points to data on return
+ * @return number of bytes that can be read from span
+ */
+uint32_t btstack_ring_buffer_get_read_span(btstack_ring_buffer_t * ring_buffer, const uint8_t ** span);
+
+/**
+ * Release bytes read from read span
+ * @param ring_buffer object
+ * @param num_bytes read, not more than returned by get_read_span
+ */
+void btstack_ring_buffer_commit_read(btstack_ring_buffer_t * ring_buffer, uint32_t num_bytes);
+
+/**
+ * Init ring buffer with power-of-two capacity
+ * @param ring_buffer object
+ * @param storage
+ * @param storage_size in bytes, power of two
+ */
+void btstack_ring_buffer_pow2_init(btstack_ring_buffer_pow2_t * ring_buffer, uint8_t * storage, uint32_t storage_size);
+
+/**
+ * Reset ring buffer to initial state (empty)
+ * @param ring_buffer object
+ */
+void btstack_ring_buffer_pow2_reset(btstack_ring_buffer_pow2_t * ring_buffer);
+
+/**
+ * Check if ring buffer is empty
+ * @param ring_buffer object
+ * @return TRUE if empty
+ */
+int btstack_ring_buffer_pow2_empty(btstack_ring_buffer_pow2_t * ring_buffer);
+
+/**
+ * Get number of bytes available for read
+ * @param ring_buffer object
+ * @return number of bytes available for read
+ */
+uint32_t btstack_ring_buffer_pow2_bytes_available(btstack_ring_buffer_pow2_t * ring_buffer);
+
+/**
+ * Get free space available for write
+ * @param ring_buffer object
+ * @return number of bytes available for write
+ */
+uint32_t btstack_ring_buffer_pow2_bytes_free(btstack_ring_buffer_pow2_t * ring_buffer);
+
+/**
+ * Write bytes into ring buffer
+ * @param ring_buffer object
+ * @param data to store
+ * @param data_length
+ * @return 0 if ok, ERROR_CODE_MEMORY_CAPACITY_EXCEEDED if not enough space in buffer
+ */
+int btstack_ring_buffer_pow2_write(btstack_ring_buffer_pow2_t * ring_buffer, const uint8_t * data, uint32_t data_length);
+
+/**
+ * Read from ring buffer
+ * @param ring_buffer object
+ * @param buffer to store read data
+ * @param length to read
+ * @param number_of_bytes_read
+ */
+void btstack_ring_buffer_pow2_read(btstack_ring_buffer_pow2_t * ring_buffer, uint8_t * buffer, uint32_t length, uint32_t * number_of_bytes_read);
+
+/**
+ * Get contiguous free space at write position
+ * @param ring_buffer object
+ * @param span points to free space on return
+ * @return number of bytes that can be written to span
+ */
+uint32_t btstack_ring_buffer_pow2_get_write_span(btstack_ring_buffer_pow2_t * ring_buffer, uint8_t ** span);
+
+/**
+ * Mark bytes written to write span as available for read
+ * @param ring_buffer object
+ * @param num_bytes written, not more than returned by get_write_span
+ */
+void btstack_ring_buffer_pow2_commit_write(btstack_ring_buffer_pow2_t * ring_buffer, uint32_t num_bytes);
+
+/**
+ * Get contiguous data at read position
+ * @param ring_buffer object
+ * @param span points to data on return
+ * @return number of bytes that can be read from span
+ */
+uint32_t btstack_ring_buffer_pow2_get_read_span(btstack_ring_buffer_pow2_t * ring_buffer, const uint8_t ** span);
+
+/**
+ * Release bytes read from read span
+ * @param ring_buffer object
+ * @param num_bytes read, not more than returned by get_read_span
+ */
+void btstack_ring_buffer_pow2_commit_read(btstack_ring_buffer_pow2_t * ring_buffer, uint32_t num_bytes);
+
 /* API_END */
 
 #if defined __cplusplus
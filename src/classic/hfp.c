@@ -1153,7 +1153,7 @@ typedef struct {
     hfp_command_t command_id;
 } hfp_command_entry_t;
 
-static hfp_command_entry_t hfp_ag_command_table[] = {
+static const hfp_command_entry_t hfp_ag_command_table[] = {
     { "AT+BAC=",   HFP_CMD_AVAILABLE_CODECS },
     { "AT+BCC",    HFP_CMD_TRIGGER_CODEC_CONNECTION_SETUP },
     { "AT+BCS=",   HFP_CMD_HF_CONFIRMED_CODEC },
@@ -1188,7 +1188,7 @@ static hfp_command_entry_t hfp_ag_command_table[] = {
     { "ATA",       HFP_CMD_CALL_ANSWERED },
 };
 
-static hfp_command_entry_t hfp_hf_command_table[] = {
+static const hfp_command_entry_t hfp_hf_command_table[] = {
     { "+BCS:",  HFP_CMD_AG_SUGGESTED_CODEC },
     { "+BIND:", HFP_CMD_SET_GENERIC_STATUS_INDICATOR_STATUS },
     { "+BINP:", HFP_CMD_AG_SENT_PHONE_NUMBER },
@@ -1215,6 +1215,117 @@ static hfp_command_entry_t hfp_hf_command_table[] = {
     { "RING",   HFP_CMD_RING },
 };
 
+// AT command index: open addressing hash table over built-in and registered custom commands
+// - built lazily on first use and rebuilt after custom commands have been registered
+// - HFP_AT_COMMAND_INDEX_SIZE has to be a power of two
+
+#ifndef HFP_AT_COMMAND_INDEX_SIZE
+#define HFP_AT_COMMAND_INDEX_SIZE 64
+#endif
+
+#if (HFP_AT_COMMAND_INDEX_SIZE & (HFP_AT_COMMAND_INDEX_SIZE - 1)) != 0
+#error "HFP_AT_COMMAND_INDEX_SIZE must be a power of two"
+#endif
+
+typedef struct {
+    const char * command;
+    const hfp_custom_at_command_t * custom_at_command;
+    hfp_command_t command_id;
+} hfp_command_index_entry_t;
+
+typedef struct {
+    hfp_command_index_entry_t entries[HFP_AT_COMMAND_INDEX_SIZE];
+    uint16_t num_entries;
+    // set if not all custom commands fit into the index
+    bool overflow;
+    bool valid;
+} hfp_command_index_t;
+
+static hfp_command_index_t hfp_command_index_ag;
+static hfp_command_index_t hfp_command_index_hf;
+
+static uint32_t hfp_command_hash(const char * text){
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*text != 0){
+        hash ^= (uint8_t) *text++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static hfp_command_index_entry_t * hfp_command_index_find_slot(hfp_command_index_t * index, const char * text){
+    uint16_t slot = (uint16_t) (hfp_command_hash(text) & (HFP_AT_COMMAND_INDEX_SIZE - 1));
+    while (true){
+        hfp_command_index_entry_t * entry = &index->entries[slot];
+        if (entry->command == NULL) {
+            return entry;
+        }
+        if (strcmp(entry->command, text) == 0){
+            return entry;
+        }
+        slot = (slot + 1) & (HFP_AT_COMMAND_INDEX_SIZE - 1);
+    }
+}
+
+static bool hfp_command_index_add(hfp_command_index_t * index, const char * command, const hfp_custom_at_command_t * custom_at_command, hfp_command_t command_id){
+    // keep at least a quarter of the slots empty to bound probe sequences
+    if (index->num_entries >= ((HFP_AT_COMMAND_INDEX_SIZE * 3) / 4)){
+        return false;
+    }
+    hfp_command_index_entry_t * entry = hfp_command_index_find_slot(index, command);
+    if (entry->command == NULL){
+        index->num_entries++;
+    } else if (entry->custom_at_command != NULL){
+        // first custom command in list wins
+        return true;
+    }
+    entry->command = command;
+    entry->custom_at_command = custom_at_command;
+    entry->command_id = command_id;
+    return true;
+}
+
+static hfp_command_index_t * hfp_command_index_for_role(int isHandsFree){
+    hfp_command_index_t * index;
+    const hfp_command_entry_t * table;
+    uint16_t num_entries;
+    btstack_linked_list_t * custom_commands;
+    if (isHandsFree == 0){
+        index = &hfp_command_index_ag;
+        table = hfp_ag_command_table;
+        num_entries = sizeof(hfp_ag_command_table) / sizeof(hfp_command_entry_t);
+        custom_commands = &hfp_custom_commands_ag;
+    } else {
+        index = &hfp_command_index_hf;
+        table = hfp_hf_command_table;
+        num_entries = sizeof(hfp_hf_command_table) / sizeof(hfp_command_entry_t);
+        custom_commands = &hfp_custom_commands_hf;
+    }
+    if (index->valid){
+        return index;
+    }
+
+    (void) memset(index, 0, sizeof(hfp_command_index_t));
+    uint16_t i;
+    for (i = 0; i < num_entries; i++){
+        bool added = hfp_command_index_add(index, table[i].command, NULL, table[i].command_id);
+        btstack_assert(added);
+        UNUSED(added);
+    }
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, custom_commands);
+    while (btstack_linked_list_iterator_has_next(&it)) {
+        hfp_custom_at_command_t *at_command = (hfp_custom_at_command_t *) btstack_linked_list_iterator_next(&it);
+        if (hfp_command_index_add(index, at_command->command, at_command, HFP_CMD_CUSTOM_MESSAGE) == false){
+            log_info("AT command index full, custom command '%s' not indexed", at_command->command);
+            index->overflow = true;
+        }
+    }
+    index->valid = true;
+    return index;
+}
+
 static const hfp_custom_at_command_t *
 hfp_custom_command_lookup(bool isHandsFree, const char *text) {
     btstack_linked_list_t * custom_commands = isHandsFree ? &hfp_custom_commands_hf : &hfp_custom_commands_ag;
@@ -1230,43 +1341,24 @@ hfp_custom_command_lookup(bool isHandsFree, const char *text) {
     return NULL;
 }
 
-static hfp_command_t parse_command(const char * line_buffer, int isHandsFree){
+static hfp_command_t parse_command(const char * line_buffer, int isHandsFree, const hfp_custom_at_command_t ** custom_at_command){
 
-    // check for custom commands, AG only
-    const hfp_custom_at_command_t * custom_at_command = hfp_custom_command_lookup(isHandsFree, line_buffer);
-    if (custom_at_command != NULL){
-        return HFP_CMD_CUSTOM_MESSAGE;
-    }
+    hfp_command_index_t * index = hfp_command_index_for_role(isHandsFree);
 
-    // table lookup based on role
-    uint16_t num_entries;
-    hfp_command_entry_t * table;
-    if (isHandsFree == 0){
-        table = hfp_ag_command_table;
-        num_entries = sizeof(hfp_ag_command_table) / sizeof(hfp_command_entry_t);
-    } else {
-        table = hfp_hf_command_table;
-        num_entries = sizeof(hfp_hf_command_table) / sizeof(hfp_command_entry_t);
-    }
-    // binary search
-    uint16_t left = 0;
-    uint16_t right = num_entries - 1;
-    while (left <= right){
-        uint16_t middle = left + (right - left) / 2;
-        hfp_command_entry_t *entry = &table[middle];
-        int match = strcmp(line_buffer, entry->command);
-        if (match < 0){
-            // search term is lower than middle element
-            if (right == 0) break;
-            right = middle - 1;
-        } else if (match == 0){
-            return entry->command_id;
-        } else {
-            // search term is higher than middle element
-            left = middle + 1;
+    // custom commands that did not fit into the index have precedence
+    if (index->overflow){
+        *custom_at_command = hfp_custom_command_lookup(isHandsFree != 0, line_buffer);
+        if (*custom_at_command != NULL){
+            return HFP_CMD_CUSTOM_MESSAGE;
         }
     }
 
+    const hfp_command_index_entry_t * entry = hfp_command_index_find_slot(index, line_buffer);
+    if (entry->command != NULL){
+        *custom_at_command = entry->custom_at_command;
+        return entry->command_id;
+    }
+
     // note: if parser in CMD_HEADER state would treats digits and maybe '+' as separator, match on "ATD" would work.
     // note: phone number is currently expected in line_buffer[3..]
     // prefix match on 'ATD', AG only
@@ -1359,6 +1451,7 @@ static bool hfp_parse_byte(hfp_connection_t * hfp_connection, uint8_t byte, int
     if ((byte == ' ') && (hfp_connection->parser_state != HFP_PARSER_CMD_HEADER)) return true;
 
     bool processed = true;
+    const hfp_custom_at_command_t * custom_at_command = NULL;
 
     switch (hfp_connection->parser_state) {
         case HFP_PARSER_CMD_HEADER:
@@ -1393,7 +1486,7 @@ static bool hfp_parse_byte(hfp_connection_t * hfp_connection, uint8_t byte, int
             if (hfp_parser_is_buffer_empty(hfp_connection)) return true;
 
             // parse
-            hfp_connection->command = parse_command((char *)hfp_connection->line_buffer, isHandsFree);
+            hfp_connection->command = parse_command((char *)hfp_connection->line_buffer, isHandsFree, &custom_at_command);
 
             // pick +CIND version based on connection state: descriptions during SLC vs. states later
             if (hfp_connection->command == HFP_CMD_RETRIEVE_AG_INDICATORS_GENERIC){
@@ -1414,8 +1507,7 @@ static bool hfp_parse_byte(hfp_connection_t * hfp_connection, uint8_t byte, int
 
             // store command id for custom command and just store rest of line
             if (hfp_connection->command == HFP_CMD_CUSTOM_MESSAGE){
-                const hfp_custom_at_command_t * at_command = hfp_custom_command_lookup(isHandsFree, (const char *) hfp_connection->line_buffer);
-                hfp_connection->custom_at_command_id = at_command->command_id;
+                hfp_connection->custom_at_command_id = custom_at_command->command_id;
                 hfp_connection->parser_state = HFP_PARSER_CUSTOM_COMMAND;
                 return processed;
             }
@@ -1559,7 +1651,51 @@ static bool hfp_parse_byte(hfp_connection_t * hfp_connection, uint8_t byte, int
     }
 }
 
-void hfp_parse(hfp_connection_t * hfp_connection, uint8_t byte, int isHandsFree){
+// returns true if byte would be stored into line buffer by hfp_parse_byte without any further processing
+static bool hfp_parser_is_plain_byte(hfp_connection_t * hfp_connection, uint8_t byte){
+    if (hfp_connection->parser_quoted) return false;
+    switch (byte){
+        case '"':
+        case '\n':
+        case '\r':
+            return false;
+        default:
+            break;
+    }
+    switch (hfp_connection->parser_state){
+        case HFP_PARSER_CMD_HEADER:
+            if (hfp_connection->found_equal_sign) return false;
+            switch (byte){
+                case ';':
+                case ':':
+                case '?':
+                case '=':
+                    return false;
+                default:
+                    return true;
+            }
+        case HFP_PARSER_CMD_SEQUENCE:
+        case HFP_PARSER_SECOND_ITEM:
+        case HFP_PARSER_THIRD_ITEM:
+            switch (byte){
+                case ' ':
+                case ',':
+                case '-':
+                case ';':
+                case '(':
+                case ')':
+                    return false;
+                default:
+                    return true;
+            }
+        case HFP_PARSER_CUSTOM_COMMAND:
+            return byte != ' ';
+        default:
+            return false;
+    }
+}
+
+static void hfp_parse_internal(hfp_connection_t * hfp_connection, uint8_t byte, int isHandsFree){
     bool processed = false;
     while (!processed){
         processed = hfp_parse_byte(hfp_connection, byte, isHandsFree);
@@ -1572,6 +1708,28 @@ void hfp_parse(hfp_connection_t * hfp_connection, uint8_t byte, int isHandsFree)
     }
 }
 
+void hfp_parse(hfp_connection_t * hfp_connection, uint8_t byte, int isHandsFree){
+    hfp_parse_internal(hfp_connection, byte, isHandsFree);
+}
+
+uint16_t hfp_parse_buffer(hfp_connection_t * hfp_connection, const uint8_t * data, uint16_t size, int isHandsFree){
+    uint16_t pos = 0;
+    while (pos < size){
+        uint8_t byte = data[pos++];
+        // fast path: store command and argument characters directly
+        if (hfp_parser_is_plain_byte(hfp_connection, byte)){
+            hfp_parser_store_byte(hfp_connection, byte);
+            continue;
+        }
+        hfp_parse_internal(hfp_connection, byte, isHandsFree);
+        // stop after end of line to allow caller to process complete command
+        if (hfp_parser_is_end_of_line(byte)){
+            break;
+        }
+    }
+    return pos;
+}
+
 static void parse_sequence(hfp_connection_t * hfp_connection){
     int value;
     switch (hfp_connection->command){
@@ -2286,6 +2444,8 @@ void hfp_deinit(void){
     hfp_sco_establishment_active = NULL;
     hfp_custom_commands_ag = NULL;
     hfp_custom_commands_hf = NULL;
+    hfp_command_index_ag.valid = false;
+    hfp_command_index_hf.valid = false;
     (void) memset(&hfp_sdp_query_context, 0, sizeof(hfp_sdp_query_context_t));
     (void) memset(&hfp_sdp_query_request, 0, sizeof(btstack_context_callback_registration_t));
 }
@@ -2363,10 +2523,12 @@ void hfp_log_rfcomm_message(const char * tag, uint8_t * packet, uint16_t size){
 
 void hfp_register_custom_ag_command(hfp_custom_at_command_t * custom_at_command){
     btstack_linked_list_add(&hfp_custom_commands_ag, (btstack_linked_item_t *) custom_at_command);
+    hfp_command_index_ag.valid = false;
 }
 
 void hfp_register_custom_hf_command(hfp_custom_at_command_t * custom_at_command){
     btstack_linked_list_add(&hfp_custom_commands_hf, (btstack_linked_item_t *) custom_at_command);
+    hfp_command_index_hf.valid = false;
 }
 
 // HFP H2 Synchronization - might get moved into a hfp_h2.c
@@ -1447,12 +1447,12 @@ static void hfp_hf_handle_rfcomm_data(hfp_connection_t * hfp_connection, uint8_t
     hfp_emit_string_event(hfp_connection, HFP_SUBEVENT_AT_MESSAGE_RECEIVED, (char *) packet);
 #endif
 
-    // process messages byte-wise
-    uint8_t pos;
-    for (pos = 0; pos < size; pos++){
-        hfp_parse(hfp_connection, packet[pos], 1);
+    // process messages line by line
+    uint16_t pos = 0;
+    while (pos < size){
+        pos += hfp_parse_buffer(hfp_connection, &packet[pos], size - pos, 1);
         // parse until end of line "\r" or "\n"
-        if (!hfp_parser_is_end_of_line(packet[pos])) continue;
+        if (!hfp_parser_is_end_of_line(packet[pos - 1])) continue;
         hfp_hf_handle_rfcomm_command(hfp_connection);   
     }
 }
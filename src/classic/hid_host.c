@@ -123,6 +123,9 @@ static hid_host_connection_t * hid_host_get_connection_for_l2cap_cid(uint16_t l2
 }
 
 static void hid_descriptor_storage_init(hid_host_connection_t * connection){
+#ifdef ENABLE_HID_REPORT_LAYOUT
+    connection->report_layout_compiled = false;
+#endif
     // reserve remaining space for this connection
     uint16_t available_space = hid_descriptor_storage_get_available_space();
     connection->hid_descriptor_len = 0;
@@ -165,6 +168,9 @@ static void hid_descriptor_storage_delete(hid_host_connection_t * connection){
     // clear descriptor
     connection->hid_descriptor_len = 0;
     connection->hid_descriptor_offset = 0;
+#ifdef ENABLE_HID_REPORT_LAYOUT
+    connection->report_layout_compiled = false;
+#endif
 }
 
 const uint8_t * hid_descriptor_storage_get_descriptor_data(uint16_t hid_cid){
@@ -183,6 +189,31 @@ uint16_t hid_descriptor_storage_get_descriptor_len(uint16_t hid_cid){
     return connection->hid_descriptor_len;
 }
 
+#ifdef ENABLE_HID_REPORT_LAYOUT
+const btstack_hid_layout_t * hid_host_get_report_layout(uint16_t hid_cid){
+    hid_host_connection_t * connection = hid_host_get_connection_for_hid_cid(hid_cid);
+    if (!connection){
+        return NULL;
+    }
+    if (connection->hid_descriptor_status != ERROR_CODE_SUCCESS){
+        return NULL;
+    }
+    if (connection->report_layout_compiled == false){
+        btstack_hid_layout_init(&connection->report_layout,
+                                connection->report_layout_reports, HID_REPORT_LAYOUT_MAX_REPORTS,
+                                connection->report_layout_fields, HID_REPORT_LAYOUT_MAX_FIELDS);
+        (void) btstack_hid_layout_compile(&connection->report_layout,
+                                          &hid_host_descriptor_storage[connection->hid_descriptor_offset],
+                                          connection->hid_descriptor_len, HID_REPORT_TYPE_INPUT);
+        connection->report_layout_compiled = true;
+    }
+    if (connection->report_layout.num_reports == 0u){
+        return NULL;
+    }
+    return &connection->report_layout;
+}
+#endif
+
 
 // HID Util
 static void hid_emit_connected_event(hid_host_connection_t * connection, uint8_t status){
@@ -127,6 +127,14 @@ typedef struct {
     // set report
     const uint8_t * report;
     uint16_t  report_len;
+
+#ifdef ENABLE_HID_REPORT_LAYOUT
+    // input report layout, compiled on first use
+    bool                        report_layout_compiled;
+    btstack_hid_layout_t        report_layout;
+    btstack_hid_layout_report_t report_layout_reports[HID_REPORT_LAYOUT_MAX_REPORTS];
+    btstack_hid_layout_field_t  report_layout_fields[HID_REPORT_LAYOUT_MAX_FIELDS];
+#endif
 } hid_host_connection_t;
 
 /* API_START */
@@ -276,6 +284,15 @@ const uint8_t * hid_descriptor_storage_get_descriptor_data(uint16_t hid_cid);
  */
 uint16_t hid_descriptor_storage_get_descriptor_len(uint16_t hid_cid);
 
+#ifdef ENABLE_HID_REPORT_LAYOUT
+/**
+ * @brief Get HID Report Layout for input reports, compiled from HID Descriptor on first call. Requires ENABLE_HID_REPORT_LAYOUT
+ * @param hid_cid
+ * @result layout or NULL if HID Descriptor not available or too large for HID_REPORT_LAYOUT_MAX_REPORTS / HID_REPORT_LAYOUT_MAX_FIELDS
+ */
+const btstack_hid_layout_t * hid_host_get_report_layout(uint16_t hid_cid);
+#endif
+
 /**
  * @brief De-Init HID Device
  */
@@ -60,6 +60,7 @@
 #include "classic/goep_client.h"
 #include "classic/pbap.h"
 #include "classic/pbap_client.h"
+#include "classic/pbap_vcard_parser.h"
 
 // 796135f0-f0c5-11d8-0966- 0800200c9a66
 static const uint8_t pbap_uuid[] = { 0x79, 0x61, 0x35, 0xf0, 0xf0, 0xc5, 0x11, 0xd8, 0x09, 0x66, 0x08, 0x00, 0x20, 0x0c, 0x9a, 0x66};
@@ -190,10 +191,15 @@ typedef struct pbap_client {
     char parser_handle[PBAP_MAX_HANDLE_LEN];
     /* phonebook size */
     pbap_client_phonebook_size_parser_t phonebook_size_parser;
+    /* vcard parser mode */
+    bool vcard_parser_enabled;
+    pbap_vcard_parser_t vcard_parser;
     /* flow control mode */
     uint8_t flow_control_enabled;
     uint8_t flow_next_triggered;
     bool flow_wait_for_user;
+    uint32_t flow_window_size;
+    uint32_t flow_outstanding;
     /* srm */
     obex_srm_t obex_srm;
     srm_state_t srm_state;
@@ -304,6 +310,90 @@ static void pbap_client_emit_card_result_event(pbap_client_t * context, const ch
     context->client_handler(HCI_EVENT_PACKET, context->cid, &event[0], pos);
 }
 
+// name, params, and value length are reported as 8 bit in PBAP_SUBEVENT_VCARD_PROPERTY, which must fit into a single HCI event
+#if (PBAP_VCARD_PARSER_MAX_NAME_LEN > 255) || (PBAP_VCARD_PARSER_MAX_PARAMS_LEN > 255) || (PBAP_VCARD_PARSER_MAX_VALUE_LEN > 255)
+#error "PBAP_VCARD_PARSER_MAX_NAME_LEN, PBAP_VCARD_PARSER_MAX_PARAMS_LEN, and PBAP_VCARD_PARSER_MAX_VALUE_LEN must not be larger than 255"
+#endif
+#if (7 + PBAP_VCARD_PARSER_MAX_NAME_LEN + PBAP_VCARD_PARSER_MAX_PARAMS_LEN + PBAP_VCARD_PARSER_MAX_VALUE_LEN) > 255
+#error "PBAP_SUBEVENT_VCARD_PROPERTY exceeds HCI event size, please reduce PBAP_VCARD_PARSER_MAX_NAME_LEN, PBAP_VCARD_PARSER_MAX_PARAMS_LEN, or PBAP_VCARD_PARSER_MAX_VALUE_LEN"
+#endif
+
+static void pbap_client_emit_vcard_event(pbap_client_t * context, uint8_t subevent_code){
+    uint8_t event[5];
+    int pos = 0;
+    event[pos++] = HCI_EVENT_PBAP_META;
+    pos++;  // skip len
+    event[pos++] = subevent_code;
+    little_endian_store_16(event,pos,context->cid);
+    pos+=2;
+    event[1] = pos - 2;
+    context->client_handler(HCI_EVENT_PACKET, context->cid, &event[0], pos);
+}
+
+static void pbap_client_emit_vcard_property_event(pbap_client_t * context, const char * name, const char * params,
+                                                  const uint8_t * value, uint16_t value_len, bool value_complete){
+    uint8_t event[9 + PBAP_VCARD_PARSER_MAX_NAME_LEN + PBAP_VCARD_PARSER_MAX_PARAMS_LEN + PBAP_VCARD_PARSER_MAX_VALUE_LEN];
+    int pos = 0;
+    event[pos++] = HCI_EVENT_PBAP_META;
+    pos++;  // skip len
+    event[pos++] = PBAP_SUBEVENT_VCARD_PROPERTY;
+    little_endian_store_16(event,pos,context->cid);
+    pos+=2;
+    event[pos++] = value_complete ? 1 : 0;
+    uint16_t name_len = (uint16_t) strlen(name);
+    event[pos++] = (uint8_t) name_len;
+    (void)memcpy(&event[pos], name, name_len);
+    pos += name_len;
+    uint16_t params_len = (uint16_t) strlen(params);
+    event[pos++] = (uint8_t) params_len;
+    (void)memcpy(&event[pos], params, params_len);
+    pos += params_len;
+    event[pos++] = (uint8_t) value_len;
+    (void)memcpy(&event[pos], value, value_len);
+    pos += value_len;
+    event[1] = pos - 2;
+    context->client_handler(HCI_EVENT_PACKET, context->cid, &event[0], pos);
+}
+
+static void pbap_client_vcard_parser_callback(void * user_data, pbap_vcard_parser_event_t event,
+                                              const char * name, const char * params,
+                                              const uint8_t * value, uint16_t value_len, bool value_complete){
+    pbap_client_t * client = (pbap_client_t *) user_data;
+    switch (event){
+        case PBAP_VCARD_PARSER_EVENT_CARD_BEGIN:
+            pbap_client_emit_vcard_event(client, PBAP_SUBEVENT_VCARD_BEGIN);
+            break;
+        case PBAP_VCARD_PARSER_EVENT_PROPERTY:
+            pbap_client_emit_vcard_property_event(client, name, params, value, value_len, value_complete);
+            break;
+        case PBAP_VCARD_PARSER_EVENT_CARD_END:
+            pbap_client_emit_vcard_event(client, PBAP_SUBEVENT_VCARD_END);
+            break;
+        default:
+            btstack_unreachable();
+            break;
+    }
+}
+
+static void pbap_client_vcard_parser_init(pbap_client_t * client){
+    if (client->vcard_parser_enabled){
+        pbap_vcard_parser_init(&client->vcard_parser, &pbap_client_vcard_parser_callback, client);
+    }
+}
+
+static void pbap_client_vcard_parser_finalize(pbap_client_t * client){
+    if (client->vcard_parser_enabled){
+        pbap_vcard_parser_finalize(&client->vcard_parser);
+    }
+}
+
+// discard partial vCard if operation was aborted or failed
+static void pbap_client_vcard_parser_reset(pbap_client_t * client){
+    if (client->vcard_parser_enabled){
+        pbap_vcard_parser_reset(&client->vcard_parser);
+    }
+}
+
 static const uint8_t collon = (uint8_t) ':';
 
 static void pbap_client_vcard_listing_init_parser(pbap_client_t * client){
@@ -545,8 +635,14 @@ static void pbap_client_parser_callback_get_operation(void * user_data, uint8_t
             switch(pbap_client->state){
                 case PBAP_W4_PHONEBOOK:
                 case PBAP_W4_GET_CARD_ENTRY_COMPLETE:
-                    client->client_handler(PBAP_DATA_PACKET, client->cid, (uint8_t *) data_buffer, data_len);
-                    if (data_offset + data_len == total_len){
+                    if (client->vcard_parser_enabled){
+                        pbap_vcard_parser_process_data(&client->vcard_parser, data_buffer, data_len);
+                    } else {
+                        client->client_handler(PBAP_DATA_PACKET, client->cid, (uint8_t *) data_buffer, data_len);
+                    }
+                    client->flow_outstanding += data_len;
+                    // wait for pbap_next_packet if window of outstanding data is used up
+                    if ((data_offset + data_len == total_len) && (client->flow_outstanding >= client->flow_window_size)){
                         client->flow_wait_for_user = true;
                     }
                     break;
@@ -681,6 +777,7 @@ static void pbap_handle_can_send_now(void){
 
     if (pbap_client->abort_operation){
         pbap_client->abort_operation = 0;
+        pbap_client_vcard_parser_reset(pbap_client);
         // prepare request
         goep_client_request_create_abort(pbap_client->goep_cid);
         // state
@@ -782,6 +879,8 @@ static void pbap_handle_can_send_now(void){
                 pbap_client_prepare_srm_header(pbap_client);
                 goep_client_header_add_name(pbap_client->goep_cid, pbap_client->phonebook_path);
                 goep_client_header_add_type(pbap_client->goep_cid, pbap_phonebook_type);
+                pbap_client_vcard_parser_init(pbap_client);
+                pbap_client->flow_outstanding = 0;
 
                 pos = 0;
                 pos += pbap_client_application_params_add_property_selector(pbap_client, &application_parameters[pos]);
@@ -826,6 +925,8 @@ static void pbap_handle_can_send_now(void){
                 pbap_client_prepare_srm_header(pbap_client);
                 goep_client_header_add_name(pbap_client->goep_cid, pbap_client->vcard_name);
                 goep_client_header_add_type(pbap_client->goep_cid, pbap_vcard_entry_type);
+                pbap_client_vcard_parser_init(pbap_client);
+                pbap_client->flow_outstanding = 0;
 
                 pos = 0;
                 pos += pbap_client_application_params_add_property_selector(pbap_client, &application_parameters[pos]);
@@ -944,6 +1045,7 @@ static void pbap_packet_handler_hci(uint8_t *packet, uint16_t size){
                     }
                     break;
                 case GOEP_SUBEVENT_CONNECTION_CLOSED:
+                    pbap_client_vcard_parser_reset(pbap_client);
                     if (pbap_client->state > PBAP_CONNECTED){
                         pbap_client_emit_operation_complete_event(pbap_client, OBEX_DISCONNECTED);
                     }
@@ -1033,11 +1135,13 @@ static void pbap_packet_handler_goep(uint8_t *packet, uint16_t size){
                         }
                         break;
                     case OBEX_RESP_SUCCESS:
+                        pbap_client_vcard_parser_finalize(pbap_client);
                         pbap_client->state = PBAP_CONNECTED;
                         pbap_client_emit_operation_complete_event(pbap_client, ERROR_CODE_SUCCESS);
                         break;
                     default:
                         log_info("unexpected response 0x%02x", packet[0]);
+                        pbap_client_vcard_parser_reset(pbap_client);
                         pbap_client->state = PBAP_CONNECTED;
                         pbap_client_emit_operation_complete_event(pbap_client, OBEX_UNKNOWN_ERROR);
                         break;
@@ -1101,15 +1205,18 @@ static void pbap_packet_handler_goep(uint8_t *packet, uint16_t size){
                         goep_client_request_can_send_now(pbap_client->goep_cid);
                         break;
                     case OBEX_RESP_SUCCESS:
+                        pbap_client_vcard_parser_finalize(pbap_client);
                         pbap_client->state = PBAP_CONNECTED;
                         pbap_client_emit_operation_complete_event(pbap_client, ERROR_CODE_SUCCESS);
                         break;
                     case OBEX_RESP_NOT_ACCEPTABLE:
+                        pbap_client_vcard_parser_reset(pbap_client);
                         pbap_client->state = PBAP_CONNECTED;
                         pbap_client_emit_operation_complete_event(pbap_client, OBEX_NOT_ACCEPTABLE);
                         break;
                     default:
                         log_info("unexpected response 0x%02x", packet[0]);
+                        pbap_client_vcard_parser_reset(pbap_client);
                         pbap_client->state = PBAP_CONNECTED;
                         pbap_client_emit_operation_complete_event(pbap_client, OBEX_UNKNOWN_ERROR);
                         break;
@@ -1299,6 +1406,8 @@ uint8_t pbap_next_packet(uint16_t pbap_cid){
     if (!pbap_client->flow_control_enabled){
         return ERROR_CODE_SUCCESS;
     }
+    // data received so far has been processed
+    pbap_client->flow_outstanding = 0;
     switch (pbap_client->state){
         case PBAP_W2_PULL_PHONEBOOK:
             goep_client_request_can_send_now(pbap_client->goep_cid);
@@ -1321,6 +1430,24 @@ uint8_t pbap_set_flow_control_mode(uint16_t pbap_cid, int enable){
     return ERROR_CODE_SUCCESS;
 }
 
+uint8_t pbap_set_flow_control_window(uint16_t pbap_cid, uint32_t window_size){
+    UNUSED(pbap_cid);
+    if (pbap_client->state != PBAP_CONNECTED){
+        return BTSTACK_BUSY;
+    }
+    pbap_client->flow_window_size = window_size;
+    return ERROR_CODE_SUCCESS;
+}
+
+uint8_t pbap_set_vcard_parser_mode(uint16_t pbap_cid, int enable){
+    UNUSED(pbap_cid);
+    if (pbap_client->state != PBAP_CONNECTED){
+        return BTSTACK_BUSY;
+    }
+    pbap_client->vcard_parser_enabled = enable != 0;
+    return ERROR_CODE_SUCCESS;
+}
+
 uint8_t pbap_set_vcard_selector(uint16_t pbap_cid, uint32_t vcard_selector){
     UNUSED(pbap_cid);
     if (pbap_client->state != PBAP_CONNECTED){
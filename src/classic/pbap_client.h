@@ -201,6 +201,32 @@ uint8_t pbap_abort(uint16_t pbap_cid);
  * @return status ERROR_CODE_SUCCESS on success, otherwise BTSTACK_BUSY if in a wrong state.
  */
 uint8_t pbap_set_flow_control_mode(uint16_t pbap_cid, int enable);
+
+/**
+ * @brief Set window of outstanding data in flow control mode - default is 0. No event is emitted.
+ * @note In flow control mode, the next packet of a phone book is requested without a call to pbap_next_packet
+ *       as long as less than window_size bytes have been received since the last call to pbap_next_packet.
+ *       With a window size of 0, pbap_next_packet needs to be called for each packet.
+ *
+ * @param pbap_cid
+ * @param window_size in bytes
+ * @return status ERROR_CODE_SUCCESS on success, otherwise BTSTACK_BUSY if in a wrong state.
+ */
+uint8_t pbap_set_flow_control_window(uint16_t pbap_cid, uint32_t window_size);
+
+/**
+ * @brief Set vCard parser mode - default is off. No event is emitted.
+ * @note When enabled, phone book and vCard entry are not reported as PBAP_DATA_PACKET but parsed incrementally
+ *       and reported via PBAP_SUBEVENT_VCARD_BEGIN, PBAP_SUBEVENT_VCARD_PROPERTY, and PBAP_SUBEVENT_VCARD_END.
+ *       Property values longer than PBAP_VCARD_PARSER_MAX_VALUE_LEN are reported in multiple fragments.
+ *       Without flow control mode, Single Response Mode is used if supported by the PSE.
+ *       With flow control mode, pbap_set_flow_control_window limits the amount of data parsed ahead of the application.
+ *
+ * @param pbap_cid
+ * @param enable
+ * @return status ERROR_CODE_SUCCESS on success, otherwise BTSTACK_BUSY if in a wrong state.
+ */
+uint8_t pbap_set_vcard_parser_mode(uint16_t pbap_cid, int enable);
     
 /**
  * @brief Trigger next packet from PSE when Flow Control Mode is enabled.
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+#define BTSTACK_FILE__ "pbap_vcard_parser.c"
+
+#include "btstack_config.h"
+
+#include "classic/pbap_vcard_parser.h"
+
+#include <string.h>
+
+#include "btstack_debug.h"
+#include "btstack_util.h"
+
+static char pbap_vcard_parser_to_upper(char c){
+    if ((c >= 'a') && (c <= 'z')){
+        return (char) (c - 'a' + 'A');
+    }
+    return c;
+}
+
+// case-insensitive compare of buffer with upper case string
+static bool pbap_vcard_parser_matches(const char * buffer, uint16_t buffer_len, const char * upper_case_string){
+    uint16_t len = (uint16_t) strlen(upper_case_string);
+    if (buffer_len != len) return false;
+    uint16_t i;
+    for (i = 0; i < len; i++){
+        if (pbap_vcard_parser_to_upper(buffer[i]) != upper_case_string[i]) return false;
+    }
+    return true;
+}
+
+// case-insensitive search of upper case string in buffer
+static bool pbap_vcard_parser_contains(const char * buffer, uint16_t buffer_len, const char * upper_case_string){
+    uint16_t len = (uint16_t) strlen(upper_case_string);
+    uint16_t offset;
+    for (offset = 0; (offset + len) <= buffer_len; offset++){
+        if (pbap_vcard_parser_matches(&buffer[offset], len, upper_case_string)) return true;
+    }
+    return false;
+}
+
+static void pbap_vcard_parser_reset_line(pbap_vcard_parser_t * parser){
+    parser->name_len = 0;
+    parser->name[0] = 0;
+    parser->params_len = 0;
+    parser->params[0] = 0;
+    parser->value_len = 0;
+    parser->params_quoted = false;
+    parser->quoted_printable = false;
+    parser->state = PBAP_VCARD_PARSER_STATE_W4_NAME;
+}
+
+static void pbap_vcard_parser_emit(pbap_vcard_parser_t * parser, pbap_vcard_parser_event_t event, bool value_complete){
+    (*parser->callback)(parser->user_data, event, parser->name, parser->params, parser->value, parser->value_len, value_complete);
+}
+
+static bool pbap_vcard_parser_is_card_delimiter(const pbap_vcard_parser_t * parser){
+    return pbap_vcard_parser_matches(parser->name, parser->name_len, "BEGIN") ||
+           pbap_vcard_parser_matches(parser->name, parser->name_len, "END");
+}
+
+static void pbap_vcard_parser_finish_line(pbap_vcard_parser_t * parser){
+    if (parser->name_len > 0){
+        bool is_vcard = pbap_vcard_parser_matches((const char *) parser->value, parser->value_len, "VCARD");
+        if (is_vcard && pbap_vcard_parser_matches(parser->name, parser->name_len, "BEGIN")){
+            // nested vCards, e.g. AGENT in vCard 2.1, are reported as part of the outer vCard
+            parser->card_depth++;
+            if (parser->card_depth == 1){
+                pbap_vcard_parser_emit(parser, PBAP_VCARD_PARSER_EVENT_CARD_BEGIN, true);
+            }
+        } else if (is_vcard && pbap_vcard_parser_matches(parser->name, parser->name_len, "END")){
+            if (parser->card_depth > 0){
+                parser->card_depth--;
+                if (parser->card_depth == 0){
+                    pbap_vcard_parser_emit(parser, PBAP_VCARD_PARSER_EVENT_CARD_END, true);
+                }
+            }
+        } else if (parser->card_depth > 0){
+            pbap_vcard_parser_emit(parser, PBAP_VCARD_PARSER_EVENT_PROPERTY, true);
+        }
+    }
+    pbap_vcard_parser_reset_line(parser);
+}
+
+static void pbap_vcard_parser_store_name(pbap_vcard_parser_t * parser, uint8_t byte){
+    if (parser->name_len >= PBAP_VCARD_PARSER_MAX_NAME_LEN) return;
+    parser->name[parser->name_len++] = (char) byte;
+    parser->name[parser->name_len] = 0;
+}
+
+static void pbap_vcard_parser_store_params(pbap_vcard_parser_t * parser, uint8_t byte){
+    if (parser->params_len >= PBAP_VCARD_PARSER_MAX_PARAMS_LEN) return;
+    parser->params[parser->params_len++] = (char) byte;
+    parser->params[parser->params_len] = 0;
+}
+
+static void pbap_vcard_parser_store_value(pbap_vcard_parser_t * parser, uint8_t byte){
+    if (parser->value_len >= PBAP_VCARD_PARSER_MAX_VALUE_LEN){
+        // report fragment, keeps memory bounded for large values, e.g. PHOTO
+        if (parser->card_depth > 0){
+            pbap_vcard_parser_emit(parser, PBAP_VCARD_PARSER_EVENT_PROPERTY, false);
+        }
+        parser->value_len = 0;
+    }
+    parser->value[parser->value_len++] = byte;
+}
+
+static void pbap_vcard_parser_start_value(pbap_vcard_parser_t * parser){
+    // vCard 2.1 uses soft line breaks for quoted-printable values
+    parser->quoted_printable = pbap_vcard_parser_contains(parser->params, parser->params_len, "QUOTED-PRINTABLE");
+    parser->state = PBAP_VCARD_PARSER_STATE_VALUE;
+}
+
+static void pbap_vcard_parser_line_end(pbap_vcard_parser_t * parser){
+    // delimiters are never folded, report immediately
+    if ((parser->state == PBAP_VCARD_PARSER_STATE_VALUE) && pbap_vcard_parser_is_card_delimiter(parser)){
+        pbap_vcard_parser_finish_line(parser);
+        return;
+    }
+    // wait for next byte to check for folded line
+    parser->folded_state = parser->state;
+    parser->state = PBAP_VCARD_PARSER_STATE_LINE_END;
+}
+
+void pbap_vcard_parser_init(pbap_vcard_parser_t * parser, pbap_vcard_parser_callback_t callback, void * user_data){
+    memset(parser, 0, sizeof(pbap_vcard_parser_t));
+    parser->callback = callback;
+    parser->user_data = user_data;
+    pbap_vcard_parser_reset_line(parser);
+}
+
+void pbap_vcard_parser_reset(pbap_vcard_parser_t * parser){
+    parser->card_depth = 0;
+    parser->folded_state = PBAP_VCARD_PARSER_STATE_W4_NAME;
+    pbap_vcard_parser_reset_line(parser);
+}
+
+void pbap_vcard_parser_process_data(pbap_vcard_parser_t * parser, const uint8_t * data, uint16_t data_len){
+    uint16_t pos = 0;
+    while (pos < data_len){
+        uint8_t byte = data[pos];
+        switch (parser->state){
+            case PBAP_VCARD_PARSER_STATE_LINE_END:
+                if ((byte == ' ') || (byte == '\t')){
+                    // folded line: drop whitespace and continue
+                    parser->state = parser->folded_state;
+                    pos++;
+                    break;
+                }
+                // process byte again as start of next line
+                pbap_vcard_parser_finish_line(parser);
+                break;
+            case PBAP_VCARD_PARSER_STATE_W4_NAME:
+                pos++;
+                if ((byte == '\r') || (byte == '\n')) break;
+                parser->state = PBAP_VCARD_PARSER_STATE_NAME;
+                pbap_vcard_parser_store_name(parser, byte);
+                break;
+            case PBAP_VCARD_PARSER_STATE_NAME:
+                pos++;
+                switch (byte){
+                    case '\r':
+                        break;
+                    case '\n':
+                        pbap_vcard_parser_line_end(parser);
+                        break;
+                    case ':':
+                        pbap_vcard_parser_start_value(parser);
+                        break;
+                    case ';':
+                        parser->state = PBAP_VCARD_PARSER_STATE_PARAMS;
+                        break;
+                    default:
+                        pbap_vcard_parser_store_name(parser, byte);
+                        break;
+                }
+                break;
+            case PBAP_VCARD_PARSER_STATE_PARAMS:
+                pos++;
+                switch (byte){
+                    case '\r':
+                        break;
+                    case '\n':
+                        pbap_vcard_parser_line_end(parser);
+                        break;
+                    case ':':
+                        if (parser->params_quoted){
+                            pbap_vcard_parser_store_params(parser, byte);
+                        } else {
+                            pbap_vcard_parser_start_value(parser);
+                        }
+                        break;
+                    case '"':
+                        parser->params_quoted = !parser->params_quoted;
+                        pbap_vcard_parser_store_params(parser, byte);
+                        break;
+                    default:
+                        pbap_vcard_parser_store_params(parser, byte);
+                        break;
+                }
+                break;
+            case PBAP_VCARD_PARSER_STATE_VALUE:
+                pos++;
+                switch (byte){
+                    case '\r':
+                        break;
+                    case '\n':
+                        if (parser->quoted_printable && (parser->value_len > 0) && (parser->value[parser->value_len - 1] == '=')){
+                            // soft line break: drop '=' and continue with value
+                            parser->value_len--;
+                            break;
+                        }
+                        pbap_vcard_parser_line_end(parser);
+                        break;
+                    default:
+                        pbap_vcard_parser_store_value(parser, byte);
+                        break;
+                }
+                break;
+            default:
+                btstack_unreachable();
+                pos++;
+                break;
+        }
+    }
+}
+
+void pbap_vcard_parser_finalize(pbap_vcard_parser_t * parser){
+    pbap_vcard_parser_finish_line(parser);
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+/**
+ * PBAP vCard Parser
+ * Incremental tokenizer for vCard 2.1/3.0 streams with fixed memory footprint.
+ * Reports start and end of each vCard as well as each property. Long property
+ * values are reported in multiple fragments.
+ */
+
+#ifndef PBAP_VCARD_PARSER_H
+#define PBAP_VCARD_PARSER_H
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "btstack_bool.h"
+
+// max len of property name incl. group, e.g. 'item1.TEL'
+#ifndef PBAP_VCARD_PARSER_MAX_NAME_LEN
+#define PBAP_VCARD_PARSER_MAX_NAME_LEN   32
+#endif
+
+// max len of property parameters, e.g. 'TYPE=CELL;CHARSET=UTF-8'
+#ifndef PBAP_VCARD_PARSER_MAX_PARAMS_LEN
+#define PBAP_VCARD_PARSER_MAX_PARAMS_LEN 64
+#endif
+
+// max len of property value fragment
+#ifndef PBAP_VCARD_PARSER_MAX_VALUE_LEN
+#define PBAP_VCARD_PARSER_MAX_VALUE_LEN  128
+#endif
+
+// name and params length are tracked as 16 bit, value length is reported as 16 bit
+#if (PBAP_VCARD_PARSER_MAX_NAME_LEN > 0xfffe) || (PBAP_VCARD_PARSER_MAX_PARAMS_LEN > 0xfffe) || (PBAP_VCARD_PARSER_MAX_VALUE_LEN > 0xffff)
+#error "PBAP_VCARD_PARSER_MAX_NAME_LEN, PBAP_VCARD_PARSER_MAX_PARAMS_LEN, or PBAP_VCARD_PARSER_MAX_VALUE_LEN too large"
+#endif
+
+typedef enum {
+    PBAP_VCARD_PARSER_EVENT_CARD_BEGIN,
+    PBAP_VCARD_PARSER_EVENT_PROPERTY,
+    PBAP_VCARD_PARSER_EVENT_CARD_END,
+} pbap_vcard_parser_event_t;
+
+typedef enum {
+    PBAP_VCARD_PARSER_STATE_W4_NAME,
+    PBAP_VCARD_PARSER_STATE_NAME,
+    PBAP_VCARD_PARSER_STATE_PARAMS,
+    PBAP_VCARD_PARSER_STATE_VALUE,
+    PBAP_VCARD_PARSER_STATE_LINE_END,
+} pbap_vcard_parser_state_t;
+
+/* API_START */
+
+/**
+ * Callback to process vCard events
+ * @param user_data provided in pbap_vcard_parser_init
+ * @param event
+ * @param name of property, '\0' terminated, for PBAP_VCARD_PARSER_EVENT_PROPERTY
+ * @param params of property, '\0' terminated, for PBAP_VCARD_PARSER_EVENT_PROPERTY
+ * @param value fragment for PBAP_VCARD_PARSER_EVENT_PROPERTY
+ * @param value_len
+ * @param value_complete is false if further fragments of the same property value follow
+ */
+typedef void (*pbap_vcard_parser_callback_t)(void * user_data, pbap_vcard_parser_event_t event,
+                                             const char * name, const char * params,
+                                             const uint8_t * value, uint16_t value_len, bool value_complete);
+
+typedef struct {
+    pbap_vcard_parser_callback_t callback;
+    void * user_data;
+    pbap_vcard_parser_state_t state;
+    // state to continue with for folded lines
+    pbap_vcard_parser_state_t folded_state;
+    bool     params_quoted;
+    bool     quoted_printable;
+    uint16_t card_depth;
+    uint16_t name_len;
+    uint16_t params_len;
+    uint16_t value_len;
+    char     name[PBAP_VCARD_PARSER_MAX_NAME_LEN + 1];
+    char     params[PBAP_VCARD_PARSER_MAX_PARAMS_LEN + 1];
+    uint8_t  value[PBAP_VCARD_PARSER_MAX_VALUE_LEN];
+} pbap_vcard_parser_t;
+
+/**
+ * Initialize vCard Parser
+ * @param parser
+ * @param callback
+ * @param user_data provided to callback function
+ */
+void pbap_vcard_parser_init(pbap_vcard_parser_t * parser, pbap_vcard_parser_callback_t callback, void * user_data);
+
+/**
+ * Reset vCard Parser, e.g. after an aborted transfer. Partial property and vCard are discarded without events.
+ * @param parser
+ */
+void pbap_vcard_parser_reset(pbap_vcard_parser_t * parser);
+
+/**
+ * Process chunk of vCard stream
+ * @param parser
+ * @param data
+ * @param data_len
+ */
+void pbap_vcard_parser_process_data(pbap_vcard_parser_t * parser, const uint8_t * data, uint16_t data_len);
+
+/**
+ * Finalize vCard stream, reports pending property
+ * @param parser
+ */
+void pbap_vcard_parser_finalize(pbap_vcard_parser_t * parser);
+
+/* API_END */
+
+#if defined __cplusplus
+}
+#endif
+#endif
@@ -64,11 +64,51 @@
 // max reserved ServiceRecordHandle
 #define MAX_RESERVED_SERVICE_RECORD_HANDLE 0xffff
 
+// max number of UUIDs in ServiceSearchPattern
+#define SDP_SERVICE_SEARCH_PATTERN_MAX_UUIDS 12
+
+// max number of attribute IDs and ranges in AttributeIDList handled with index
+#ifndef SDP_SERVER_ATTRIBUTE_ID_LIST_MAX_RANGES
+#define SDP_SERVER_ATTRIBUTE_ID_LIST_MAX_RANGES 16
+#endif
+
 // max SDP response matches L2CAP PDU -- allow to use smaller buffer
 #ifndef SDP_RESPONSE_BUFFER_SIZE
 #define SDP_RESPONSE_BUFFER_SIZE (HCI_ACL_PAYLOAD_SIZE-L2CAP_HEADER_SIZE)
 #endif
 
+// max number of l2cap connections that are served concurrently, each with its own response buffer
+#ifndef SDP_RESPONSE_BUFFER_COUNT
+#define SDP_RESPONSE_BUFFER_COUNT 1
+#endif
+
+typedef struct {
+    uint16_t l2cap_cid;
+    uint16_t response_size;
+    uint8_t  response_buffer[SDP_RESPONSE_BUFFER_SIZE];
+} sdp_server_channel_t;
+
+// ServiceSearchPattern prepared for index lookup
+typedef struct {
+    uint8_t * pattern;
+    // all elements are valid UUIDs
+    bool      valid;
+    // all UUIDs are Bluetooth Base UUIDs
+    bool      indexed;
+    uint8_t   num_uuids;
+    uint32_t  uuid_filter;
+    uint32_t  uuids[SDP_SERVICE_SEARCH_PATTERN_MAX_UUIDS];
+} sdp_server_search_pattern_t;
+
+// AttributeIDList prepared for index lookup
+typedef struct {
+    uint8_t * attribute_id_list;
+    bool      indexed;
+    uint8_t   num_ranges;
+    uint16_t  range_start[SDP_SERVER_ATTRIBUTE_ID_LIST_MAX_RANGES];
+    uint16_t  range_end[SDP_SERVER_ATTRIBUTE_ID_LIST_MAX_RANGES];
+} sdp_server_attribute_id_list_t;
+
 static void sdp_packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size);
 
 // registered service records
@@ -77,10 +117,11 @@ static btstack_linked_list_t sdp_server_service_records;
 // our handles start after the reserved range
 static uint32_t sdp_server_next_service_record_handle;
 
-static uint8_t sdp_response_buffer[SDP_RESPONSE_BUFFER_SIZE];
+static sdp_server_channel_t sdp_server_channels[SDP_RESPONSE_BUFFER_COUNT];
+
+// response buffer of channel for current request, first channel buffer for direct calls of sdp_handle_xxx_request
+static uint8_t * sdp_response_buffer = sdp_server_channels[0].response_buffer;
 
-static uint16_t sdp_server_l2cap_cid;
-static uint16_t sdp_server_response_size;
 static uint16_t sdp_server_l2cap_waiting_list_cids[SDP_WAITING_LIST_MAX_COUNT];
 static int      sdp_server_l2cap_waiting_list_count;
 
@@ -92,8 +133,8 @@ void sdp_init(void){
 
 void sdp_deinit(void){
     sdp_server_service_records = NULL;
-    sdp_server_l2cap_cid = 0;
-    sdp_server_response_size = 0;
+    memset(sdp_server_channels, 0, sizeof(sdp_server_channels));
+    sdp_response_buffer = sdp_server_channels[0].response_buffer;
     sdp_server_l2cap_waiting_list_count = 0;
 }
 
@@ -133,6 +174,217 @@ uint32_t sdp_create_service_record_handle(void){
     return handle;
 }
 
+// MARK: Service Record Index
+
+// 32-bit bloom filter with two bits per UUID
+static uint32_t sdp_server_uuid_filter_bits(const uint8_t * uuid128){
+    uint32_t hash = big_endian_read_32(uuid128, 0) ^ big_endian_read_32(uuid128, 4) ^
+                    big_endian_read_32(uuid128, 8) ^ big_endian_read_32(uuid128, 12);
+    hash *= 0x9E3779B1u;
+    return (1u << (hash >> 27)) | (1u << ((hash >> 22) & 0x1fu));
+}
+
+static bool sdp_server_uuids_contain(const uint32_t * uuids, uint8_t num_uuids, uint32_t uuid){
+    uint8_t i;
+    for (i = 0; i < num_uuids; i++){
+        if (uuids[i] == uuid) return true;
+    }
+    return false;
+}
+
+// collect UUIDs in (nested) data element sequences, see sdp_record_contains_UUID128
+static void sdp_server_index_uuids(service_record_item_t * item, uint8_t * element){
+    des_iterator_t des_iterator;
+    if (!des_iterator_init(&des_iterator, element)) return;
+    while (des_iterator_has_more(&des_iterator)){
+        uint8_t * child = des_iterator_get_element(&des_iterator);
+        uint8_t uuid128[16];
+        uint32_t uuid32;
+        switch (des_iterator_get_type(&des_iterator)){
+            case DE_UUID:
+                if (!de_get_normalized_uuid(uuid128, child)) break;
+                item->uuid_filter |= sdp_server_uuid_filter_bits(uuid128);
+                if (uuid_has_bluetooth_prefix(uuid128) == false){
+                    item->uuids_indexed = false;
+                    break;
+                }
+                uuid32 = big_endian_read_32(uuid128, 0);
+                if (sdp_server_uuids_contain(item->uuids, item->num_uuids, uuid32)) break;
+                if (item->num_uuids == SDP_SERVER_RECORD_MAX_UUIDS){
+                    item->uuids_indexed = false;
+                    break;
+                }
+                item->uuids[item->num_uuids++] = uuid32;
+                break;
+            case DE_DES:
+                sdp_server_index_uuids(item, child);
+                break;
+            default:
+                break;
+        }
+        des_iterator_next(&des_iterator);
+    }
+}
+
+// store offsets of attributes, see sdp_attribute_list_traverse_sequence
+static void sdp_server_index_attributes(service_record_item_t * item){
+    uint8_t * record = item->service_record;
+    item->attributes_indexed = false;
+    if (de_get_element_type(record) != DE_DES) return;
+    uint32_t end_pos = de_get_len(record);
+    if (end_pos > 0xffffu) return;
+    uint32_t pos = de_get_header_size(record);
+    uint8_t num_attributes = 0;
+    while (pos < end_pos){
+        if ((de_get_element_type(&record[pos]) != DE_UINT) || (de_get_size_type(&record[pos]) != DE_SIZE_16)) return;
+        if ((pos + 3) >= end_pos) return;
+        if (num_attributes == SDP_SERVER_RECORD_MAX_ATTRIBUTES) return;
+        item->attribute_offsets[num_attributes++] = (uint16_t) pos;
+        pos += 3 + de_get_len(&record[pos + 3]);
+    }
+    if (pos != end_pos) return;
+    item->attribute_offsets[num_attributes] = (uint16_t) pos;
+    item->num_attributes = num_attributes;
+    item->attributes_indexed = true;
+}
+
+static void sdp_server_index_record(service_record_item_t * item){
+    item->uuid_filter = 0;
+    item->num_uuids = 0;
+    item->uuids_indexed = true;
+    sdp_server_index_uuids(item, item->service_record);
+    sdp_server_index_attributes(item);
+}
+
+static void sdp_server_search_pattern_init(sdp_server_search_pattern_t * search_pattern, uint8_t * pattern){
+    search_pattern->pattern = pattern;
+    search_pattern->valid = false;
+    search_pattern->indexed = true;
+    search_pattern->num_uuids = 0;
+    search_pattern->uuid_filter = 0;
+    des_iterator_t des_iterator;
+    if (!des_iterator_init(&des_iterator, pattern)) return;
+    while (des_iterator_has_more(&des_iterator)){
+        uint8_t uuid128[16];
+        if (!de_get_normalized_uuid(uuid128, des_iterator_get_element(&des_iterator))) return;
+        search_pattern->uuid_filter |= sdp_server_uuid_filter_bits(uuid128);
+        if (uuid_has_bluetooth_prefix(uuid128) && (search_pattern->num_uuids < SDP_SERVICE_SEARCH_PATTERN_MAX_UUIDS)){
+            search_pattern->uuids[search_pattern->num_uuids++] = big_endian_read_32(uuid128, 0);
+        } else {
+            search_pattern->indexed = false;
+        }
+        des_iterator_next(&des_iterator);
+    }
+    search_pattern->valid = true;
+}
+
+static bool sdp_server_record_matches_search_pattern(const service_record_item_t * item, const sdp_server_search_pattern_t * search_pattern){
+    if (search_pattern->valid){
+        // all UUIDs of pattern need to be in record
+        if ((search_pattern->uuid_filter & item->uuid_filter) != search_pattern->uuid_filter) return false;
+        if (search_pattern->indexed && item->uuids_indexed){
+            uint8_t i;
+            for (i = 0; i < search_pattern->num_uuids; i++){
+                if (!sdp_server_uuids_contain(item->uuids, item->num_uuids, search_pattern->uuids[i])) return false;
+            }
+            return true;
+        }
+    }
+    return sdp_record_matches_service_search_pattern(item->service_record, search_pattern->pattern);
+}
+
+// collect attribute IDs and ranges, see sdp_attribute_list_contains_id
+static void sdp_server_attribute_id_list_init(sdp_server_attribute_id_list_t * list, uint8_t * attribute_id_list){
+    list->attribute_id_list = attribute_id_list;
+    list->indexed = false;
+    list->num_ranges = 0;
+    des_iterator_t des_iterator;
+    if (des_iterator_init(&des_iterator, attribute_id_list)){
+        while (des_iterator_has_more(&des_iterator)){
+            uint8_t * element = des_iterator_get_element(&des_iterator);
+            if (des_iterator_get_type(&des_iterator) == DE_UINT){
+                uint16_t range_start;
+                uint16_t range_end;
+                switch (de_get_size_type(element)){
+                    case DE_SIZE_16:
+                        range_start = big_endian_read_16(element, 1);
+                        range_end = range_start;
+                        break;
+                    case DE_SIZE_32:
+                        range_start = big_endian_read_16(element, 1);
+                        range_end = big_endian_read_16(element, 3);
+                        break;
+                    default:
+                        des_iterator_next(&des_iterator);
+                        continue;
+                }
+                if (list->num_ranges == SDP_SERVER_ATTRIBUTE_ID_LIST_MAX_RANGES) return;
+                list->range_start[list->num_ranges] = range_start;
+                list->range_end[list->num_ranges] = range_end;
+                list->num_ranges++;
+            }
+            des_iterator_next(&des_iterator);
+        }
+    }
+    list->indexed = true;
+}
+
+static bool sdp_server_attribute_id_list_contains(const sdp_server_attribute_id_list_t * list, uint16_t attribute_id){
+    uint8_t i;
+    for (i = 0; i < list->num_ranges; i++){
+        if ((list->range_start[i] <= attribute_id) && (attribute_id <= list->range_end[i])) return true;
+    }
+    return false;
+}
+
+static uint16_t sdp_server_get_filtered_size(const service_record_item_t * item, const sdp_server_attribute_id_list_t * list){
+    if (!item->attributes_indexed || !list->indexed){
+        return sdp_get_filtered_size(item->service_record, list->attribute_id_list);
+    }
+    uint16_t size = 0;
+    uint8_t i;
+    for (i = 0; i < item->num_attributes; i++){
+        uint16_t offset = item->attribute_offsets[i];
+        if (!sdp_server_attribute_id_list_contains(list, big_endian_read_16(item->service_record, offset + 1))) continue;
+        size += item->attribute_offsets[i + 1] - offset;
+    }
+    return size;
+}
+
+// attributes in record are stored as {Attribute ID (UINT16), Attribute Value}, which is copied as is
+static bool sdp_server_filter_attributes(const service_record_item_t * item, const sdp_server_attribute_id_list_t * list,
+                                         uint16_t start_offset, uint16_t max_bytes, uint16_t * used_bytes, uint8_t * buffer){
+    if (!item->attributes_indexed || !list->indexed){
+        return sdp_filter_attributes_in_attributeIDList(item->service_record, list->attribute_id_list, start_offset, max_bytes, used_bytes, buffer);
+    }
+    uint16_t used = 0;
+    bool complete = true;
+    uint8_t i;
+    for (i = 0; i < item->num_attributes; i++){
+        uint16_t offset = item->attribute_offsets[i];
+        if (!sdp_server_attribute_id_list_contains(list, big_endian_read_16(item->service_record, offset + 1))) continue;
+        uint16_t len = item->attribute_offsets[i + 1] - offset;
+        // skip attributes already sent
+        if (start_offset >= len){
+            start_offset -= len;
+            continue;
+        }
+        offset += start_offset;
+        len -= start_offset;
+        start_offset = 0;
+        if (len > max_bytes){
+            len = max_bytes;
+            complete = false;
+        }
+        (void)memcpy(&buffer[used], &item->service_record[offset], len);
+        used += len;
+        max_bytes -= len;
+        if (!complete) break;
+    }
+    *used_bytes = used;
+    return complete;
+}
+
 /**
  * @brief Register Service Record with database using ServiceRecordHandle stored in record
  * @pre AttributeIDs are in ascending order
@@ -155,6 +407,7 @@ uint8_t sdp_register_service(const uint8_t * record){
     // set handle and record
     newRecordItem->service_record_handle = record_handle;
     newRecordItem->service_record = (uint8_t*) record;
+    sdp_server_index_record(newRecordItem);
     
     // add to linked list
     btstack_linked_list_add(&sdp_server_service_records, (btstack_linked_item_t *) newRecordItem);
@@ -213,12 +466,15 @@ int sdp_handle_service_search_request(uint8_t * packet, uint16_t remote_mtu){
         continuation_index = big_endian_read_16(continuationState, 1);
     }
     
+    sdp_server_search_pattern_t search_pattern;
+    sdp_server_search_pattern_init(&search_pattern, serviceSearchPattern);
+
     // get and limit total count
     btstack_linked_item_t *it;
     uint16_t total_service_count   = 0;
     for (it = (btstack_linked_item_t *) sdp_server_service_records; it ; it = it->next){
         service_record_item_t * item = (service_record_item_t *) it;
-        if (!sdp_record_matches_service_search_pattern(item->service_record, serviceSearchPattern)) continue;
+        if (!sdp_server_record_matches_search_pattern(item, &search_pattern)) continue;
         total_service_count++;
     }
     if (total_service_count > maximumServiceRecordCount){
@@ -233,7 +489,7 @@ int sdp_handle_service_search_request(uint8_t * packet, uint16_t remote_mtu){
     for (it = (btstack_linked_item_t *) sdp_server_service_records; it ; it = it->next, ++current_service_index){
         service_record_item_t * item = (service_record_item_t *) it;
 
-        if (!sdp_record_matches_service_search_pattern(item->service_record, serviceSearchPattern)) continue;
+        if (!sdp_server_record_matches_search_pattern(item, &search_pattern)) continue;
         matching_service_count++;
         
         if (current_service_index < continuation_index) continue;
@@ -311,13 +567,16 @@ int sdp_handle_service_attribute_request(uint8_t * packet, uint16_t remote_mtu){
     }
     
     
+    sdp_server_attribute_id_list_t attribute_id_list;
+    sdp_server_attribute_id_list_init(&attribute_id_list, attributeIDList);
+
     // AttributeList - starts at offset 7
     uint16_t pos = 7;
     
     if (continuation_offset == 0){
         
         // get size of this record
-        uint16_t filtered_attributes_size = sdp_get_filtered_size(item->service_record, attributeIDList);
+        uint16_t filtered_attributes_size = sdp_server_get_filtered_size(item, &attribute_id_list);
         
         // store DES
         de_store_descriptor_with_len(&sdp_response_buffer[pos], DE_DES, DE_SIZE_VAR_16, filtered_attributes_size);
@@ -327,7 +586,7 @@ int sdp_handle_service_attribute_request(uint8_t * packet, uint16_t remote_mtu){
 
     // copy maximumAttributeByteCount from record
     uint16_t bytes_used;
-    int complete = sdp_filter_attributes_in_attributeIDList(item->service_record, attributeIDList, continuation_offset, maximumAttributeByteCount, &bytes_used, &sdp_response_buffer[pos]);
+    int complete = sdp_server_filter_attributes(item, &attribute_id_list, continuation_offset, maximumAttributeByteCount, &bytes_used, &sdp_response_buffer[pos]);
     pos += bytes_used;
     
     uint16_t attributeListByteCount = pos - 7;
@@ -350,16 +609,16 @@ int sdp_handle_service_attribute_request(uint8_t * packet, uint16_t remote_mtu){
     return pos;
 }
 
-static uint16_t sdp_get_size_for_service_search_attribute_response(uint8_t * serviceSearchPattern, uint8_t * attributeIDList){
+static uint16_t sdp_get_size_for_service_search_attribute_response(const sdp_server_search_pattern_t * search_pattern, const sdp_server_attribute_id_list_t * attribute_id_list){
     uint16_t total_response_size = 0;
     btstack_linked_item_t *it;
     for (it = (btstack_linked_item_t *) sdp_server_service_records; it ; it = it->next){
         service_record_item_t * item = (service_record_item_t *) it;
         
-        if (!sdp_record_matches_service_search_pattern(item->service_record, serviceSearchPattern)) continue;
+        if (!sdp_server_record_matches_search_pattern(item, search_pattern)) continue;
         
         // for all service records that match
-        total_response_size += 3 + sdp_get_filtered_size(item->service_record, attributeIDList);
+        total_response_size += 3 + sdp_server_get_filtered_size(item, attribute_id_list);
     }
     return total_response_size;
 }
@@ -407,13 +666,18 @@ int sdp_handle_service_search_attribute_request(uint8_t * packet, uint16_t remot
     }
 
     // log_info("--> sdp_handle_service_search_attribute_request, cont %u/%u, max %u", continuation_service_index, continuation_offset, maximumAttributeByteCount);
+
+    sdp_server_search_pattern_t search_pattern;
+    sdp_server_search_pattern_init(&search_pattern, serviceSearchPattern);
+    sdp_server_attribute_id_list_t attribute_id_list;
+    sdp_server_attribute_id_list_init(&attribute_id_list, attributeIDList);
     
     // AttributeLists - starts at offset 7
     uint16_t pos = 7;
     
     // add DES with total size for first request
     if ((continuation_service_index == 0) && (continuation_offset == 0)){
-        uint16_t total_response_size = sdp_get_size_for_service_search_attribute_response(serviceSearchPattern, attributeIDList);
+        uint16_t total_response_size = sdp_get_size_for_service_search_attribute_response(&search_pattern, &attribute_id_list);
         de_store_descriptor_with_len(&sdp_response_buffer[pos], DE_DES, DE_SIZE_VAR_16, total_response_size);
         // log_info("total response size %u", total_response_size);
         pos += 3;
@@ -429,12 +693,12 @@ int sdp_handle_service_search_attribute_request(uint8_t * packet, uint16_t remot
         service_record_item_t * item = (service_record_item_t *) it;
         
         if (current_service_index < continuation_service_index ) continue;
-        if (!sdp_record_matches_service_search_pattern(item->service_record, serviceSearchPattern)) continue;
+        if (!sdp_server_record_matches_search_pattern(item, &search_pattern)) continue;
 
         if (continuation_offset == 0){
             
             // get size of this record
-            uint16_t filtered_attributes_size = sdp_get_filtered_size(item->service_record, attributeIDList);
+            uint16_t filtered_attributes_size = sdp_server_get_filtered_size(item, &attribute_id_list);
             
             // stop if complete record doesn't fits into response but we already have a partial response
             if (((filtered_attributes_size + 3) > maximumAttributeByteCount) && !first_answer) {
@@ -452,7 +716,7 @@ int sdp_handle_service_search_attribute_request(uint8_t * packet, uint16_t remot
     
         // copy maximumAttributeByteCount from record
         uint16_t bytes_used;
-        int complete = sdp_filter_attributes_in_attributeIDList(item->service_record, attributeIDList, continuation_offset, maximumAttributeByteCount, &bytes_used, &sdp_response_buffer[pos]);
+        int complete = sdp_server_filter_attributes(item, &attribute_id_list, continuation_offset, maximumAttributeByteCount, &bytes_used, &sdp_response_buffer[pos]);
         pos += bytes_used;
         maximumAttributeByteCount -= bytes_used;
         
@@ -489,14 +753,29 @@ int sdp_handle_service_search_attribute_request(uint8_t * packet, uint16_t remot
     return pos;
 }
 
-static void sdp_respond(void){
-    if (!sdp_server_response_size ) return;
-    if (!sdp_server_l2cap_cid) return;
+static sdp_server_channel_t * sdp_server_channel_for_cid(uint16_t l2cap_cid){
+    uint8_t i;
+    for (i = 0; i < SDP_RESPONSE_BUFFER_COUNT; i++){
+        if (sdp_server_channels[i].l2cap_cid == l2cap_cid){
+            return &sdp_server_channels[i];
+        }
+    }
+    return NULL;
+}
+
+static void sdp_server_channel_accept(sdp_server_channel_t * sdp_channel, uint16_t l2cap_cid){
+    sdp_channel->l2cap_cid = l2cap_cid;
+    sdp_channel->response_size = 0;
+    l2cap_accept_connection(l2cap_cid);
+}
+
+static void sdp_respond(sdp_server_channel_t * sdp_channel){
+    if (!sdp_channel->response_size ) return;
     
     // update state before sending packet (avoid getting called when new l2cap credit gets emitted)
-    uint16_t size = sdp_server_response_size;
-    sdp_server_response_size = 0;
-    l2cap_send(sdp_server_l2cap_cid, sdp_response_buffer, size);
+    uint16_t size = sdp_channel->response_size;
+    sdp_channel->response_size = 0;
+    l2cap_send(sdp_channel->l2cap_cid, sdp_channel->response_buffer, size);
 }
 
 // @pre space in list
@@ -514,16 +793,21 @@ static uint16_t sdp_waiting_list_get(void){
     return cid;
 }
 
-// we assume that we don't get two requests in a row
+// we assume that we don't get two requests in a row on the same channel
 static void sdp_packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
 	uint16_t transaction_id;
     sdp_pdu_id_t pdu_id;
     uint16_t remote_mtu;
     uint16_t param_len;
+    uint16_t response_size;
+    sdp_server_channel_t * sdp_channel;
     
 	switch (packet_type) {
 			
 		case L2CAP_DATA_PACKET:
+            sdp_channel = sdp_server_channel_for_cid(channel);
+            if (sdp_channel == NULL) break;
+            sdp_response_buffer = sdp_channel->response_buffer;
             pdu_id = (sdp_pdu_id_t) packet[0];
             transaction_id = big_endian_read_16(packet, 1);
             param_len = big_endian_read_16(packet, 3);
@@ -542,23 +826,24 @@ static void sdp_packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *p
             switch (pdu_id){
                     
                 case SDP_ServiceSearchRequest:
-                    sdp_server_response_size = sdp_handle_service_search_request(packet, remote_mtu);
+                    response_size = sdp_handle_service_search_request(packet, remote_mtu);
                     break;
                                         
                 case SDP_ServiceAttributeRequest:
-                    sdp_server_response_size = sdp_handle_service_attribute_request(packet, remote_mtu);
+                    response_size = sdp_handle_service_attribute_request(packet, remote_mtu);
                     break;
                     
                 case SDP_ServiceSearchAttributeRequest:
-                    sdp_server_response_size = sdp_handle_service_search_attribute_request(packet, remote_mtu);
+                    response_size = sdp_handle_service_search_attribute_request(packet, remote_mtu);
                     break;
                     
                 default:
-                    sdp_server_response_size = sdp_create_error_response(transaction_id, 0x0003); // invalid syntax
+                    response_size = sdp_create_error_response(transaction_id, 0x0003); // invalid syntax
                     break;
             }
-            if (!sdp_server_response_size) break;
-            l2cap_request_can_send_now_event(sdp_server_l2cap_cid);
+            sdp_channel->response_size = response_size;
+            if (!response_size) break;
+            l2cap_request_can_send_now_event(sdp_channel->l2cap_cid);
 			break;
 			
 		case HCI_EVENT_PACKET:
@@ -566,7 +851,9 @@ static void sdp_packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *p
 			switch (hci_event_packet_get_type(packet)) {
 
 				case L2CAP_EVENT_INCOMING_CONNECTION:
-                    if (sdp_server_l2cap_cid) {
+                    // get free channel
+                    sdp_channel = sdp_server_channel_for_cid(0);
+                    if (sdp_channel == NULL) {
                         // try to queue up
                         if (sdp_server_l2cap_waiting_list_count < SDP_WAITING_LIST_MAX_COUNT){
                             sdp_waiting_list_add(channel);
@@ -579,39 +866,42 @@ static void sdp_packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *p
                         break;
                     }
                     // accept
-                    sdp_server_l2cap_cid = channel;
-                    sdp_server_response_size = 0;
-                    l2cap_accept_connection(sdp_server_l2cap_cid);
+                    sdp_server_channel_accept(sdp_channel, channel);
 					break;
                     
                 case L2CAP_EVENT_CHANNEL_OPENED:
                     if (packet[2]) {
                         // open failed -> reset
-                        sdp_server_l2cap_cid = 0;
+                        sdp_channel = sdp_server_channel_for_cid(channel);
+                        if (sdp_channel == NULL) break;
+                        sdp_channel->l2cap_cid = 0;
                     }
                     break;
 
                 case L2CAP_EVENT_CAN_SEND_NOW:
-                    sdp_respond();
+                    sdp_channel = sdp_server_channel_for_cid(l2cap_event_can_send_now_get_local_cid(packet));
+                    if (sdp_channel == NULL) break;
+                    sdp_respond(sdp_channel);
                     break;
                 
                 case L2CAP_EVENT_CHANNEL_CLOSED:
-                    if (channel == sdp_server_l2cap_cid){
-                        // reset
-                        sdp_server_l2cap_cid = 0;
+                    sdp_channel = sdp_server_channel_for_cid(channel);
+                    if (sdp_channel == NULL) break;
 
-                        // other request queued?
-                        if (!sdp_server_l2cap_waiting_list_count) break;
+                    // reset
+                    sdp_channel->l2cap_cid = 0;
+                    sdp_channel->response_size = 0;
 
-                        // get first item 
-                        sdp_server_l2cap_cid = sdp_waiting_list_get();
+                    // other request queued?
+                    if (!sdp_server_l2cap_waiting_list_count) break;
 
-                        log_info("disconnect, accept queued cid 0x%04x, now %u waiting", sdp_server_l2cap_cid, sdp_server_l2cap_waiting_list_count);
+                    // get first item 
+                    channel = sdp_waiting_list_get();
 
-                        // accept connection
-                        sdp_server_response_size = 0;
-                        l2cap_accept_connection(sdp_server_l2cap_cid);
-                    }
+                    log_info("disconnect, accept queued cid 0x%04x, now %u waiting", channel, sdp_server_l2cap_waiting_list_count);
+
+                    // accept connection
+                    sdp_server_channel_accept(sdp_channel, channel);
                     break;
 					                    
 				default:
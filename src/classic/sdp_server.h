@@ -44,6 +44,7 @@
 #define SDP_H
 
 #include <stdint.h>
+#include "btstack_bool.h"
 #include "btstack_linked_list.h"
 
 #include "btstack_config.h"
@@ -52,12 +53,33 @@
 extern "C" {
 #endif
     
+// max number of Bluetooth Base UUIDs stored in the index of a service record
+#ifndef SDP_SERVER_RECORD_MAX_UUIDS
+#define SDP_SERVER_RECORD_MAX_UUIDS 8
+#endif
+
+// max number of attributes stored in the index of a service record
+#ifndef SDP_SERVER_RECORD_MAX_ATTRIBUTES
+#define SDP_SERVER_RECORD_MAX_ATTRIBUTES 24
+#endif
+
 typedef struct {
     // linked list - assert: first field
     btstack_linked_item_t   item;
 
     uint32_t        service_record_handle;
     uint8_t *       service_record;
+
+    // index created on registration, records with more UUIDs or attributes are processed without index
+    uint32_t        uuid_filter;
+    bool            uuids_indexed;
+    bool            attributes_indexed;
+    uint8_t         num_uuids;
+    uint8_t         num_attributes;
+    // Bluetooth Base UUIDs as 32-bit values
+    uint32_t        uuids[SDP_SERVER_RECORD_MAX_UUIDS];
+    // offset of attribute ID element in record, last entry marks end of attribute list
+    uint16_t        attribute_offsets[SDP_SERVER_RECORD_MAX_ATTRIBUTES + 1];
 } service_record_item_t;
 
 int sdp_handle_service_search_request(uint8_t * packet, uint16_t remote_mtu);
@@ -324,6 +324,51 @@ typedef struct {
     bool can_send_now_requested;
 } le_audio_cig_t;
 
+// LE Advertising Report Filter rules
+#define GAP_LE_ADVERTISING_FILTER_RULE_ADDRESS_TYPE    0x01u
+#define GAP_LE_ADVERTISING_FILTER_RULE_ADDRESS         0x02u
+#define GAP_LE_ADVERTISING_FILTER_RULE_RSSI            0x04u
+#define GAP_LE_ADVERTISING_FILTER_RULE_AD_TYPE         0x08u
+#define GAP_LE_ADVERTISING_FILTER_RULE_UUID16          0x10u
+#define GAP_LE_ADVERTISING_FILTER_RULE_UUID128         0x20u
+#define GAP_LE_ADVERTISING_FILTER_RULE_MANUFACTURER_ID 0x40u
+
+typedef struct {
+    bd_addr_t address;
+    uint8_t   address_type;
+    uint32_t  data_hash;
+    uint32_t  time_ms;
+} gap_le_advertising_filter_entry_t;
+
+typedef struct {
+    uint32_t reports_received;
+    uint32_t reports_delivered;
+    uint32_t reports_rejected;
+    uint32_t reports_duplicate;
+} gap_le_advertising_filter_statistics_t;
+
+typedef struct {
+    btstack_linked_item_t    item;
+    btstack_packet_handler_t callback;
+
+    // rules, all configured rules need to match
+    uint8_t   rules;
+    uint8_t   address_type;
+    bd_addr_t address;
+    int8_t    rssi_threshold;
+    uint8_t   ad_type;
+    uint16_t  uuid16;
+    uint16_t  manufacturer_id;
+    uint8_t   uuid128[16];
+
+    // duplicate suppression keyed on address and data hash, storage provided by caller
+    uint32_t  duplicate_window_ms;
+    gap_le_advertising_filter_entry_t * duplicate_entries;
+    uint16_t  duplicate_num_entries;
+
+    gap_le_advertising_filter_statistics_t statistics;
+} gap_le_advertising_filter_t;
+
 /* API_START */
 
 // Classic + LE
@@ -610,6 +655,86 @@ void gap_start_scan(void);
  */
 void gap_stop_scan(void);
 
+/**
+ * @brief Init LE Advertising Report Filter. Without rules, all reports are delivered
+ * @param filter
+ * @param callback for GAP_EVENT_ADVERTISING_REPORT and GAP_EVENT_EXTENDED_ADVERTISING_REPORT that pass the filter
+ */
+void gap_le_advertising_filter_init(gap_le_advertising_filter_t * filter, btstack_packet_handler_t callback);
+
+/**
+ * @brief Only deliver reports with given address type
+ * @param filter
+ * @param address_type as reported in advertising report
+ */
+void gap_le_advertising_filter_set_address_type(gap_le_advertising_filter_t * filter, bd_addr_type_t address_type);
+
+/**
+ * @brief Only deliver reports from given address
+ * @param filter
+ * @param address_type as reported in advertising report
+ * @param address
+ */
+void gap_le_advertising_filter_set_address(gap_le_advertising_filter_t * filter, bd_addr_type_t address_type, const bd_addr_t address);
+
+/**
+ * @brief Only deliver reports with RSSI equal or above threshold
+ * @param filter
+ * @param rssi_threshold in dBm
+ */
+void gap_le_advertising_filter_set_rssi_threshold(gap_le_advertising_filter_t * filter, int8_t rssi_threshold);
+
+/**
+ * @brief Only deliver reports that contain AD Structure of given type
+ * @param filter
+ * @param ad_type see bluetooth_data_types.h
+ */
+void gap_le_advertising_filter_set_ad_type(gap_le_advertising_filter_t * filter, uint8_t ad_type);
+
+/**
+ * @brief Only deliver reports that list 16-bit Service UUID
+ * @param filter
+ * @param uuid16
+ */
+void gap_le_advertising_filter_set_uuid16(gap_le_advertising_filter_t * filter, uint16_t uuid16);
+
+/**
+ * @brief Only deliver reports that list 128-bit Service UUID
+ * @param filter
+ * @param uuid128 in big endian
+ */
+void gap_le_advertising_filter_set_uuid128(gap_le_advertising_filter_t * filter, const uint8_t * uuid128);
+
+/**
+ * @brief Only deliver reports with Manufacturer Specific Data of given Company ID
+ * @param filter
+ * @param manufacturer_id see bluetooth_company_id.h
+ */
+void gap_le_advertising_filter_set_manufacturer_id(gap_le_advertising_filter_t * filter, uint16_t manufacturer_id);
+
+/**
+ * @brief Suppress reports with same address and advertising data within time window. Entries are replaced
+ *        least recently delivered first, a few entries per expected device within window are sufficient.
+ * @param filter
+ * @param window_ms
+ * @param entries storage
+ * @param num_entries
+ */
+void gap_le_advertising_filter_set_duplicate_suppression(gap_le_advertising_filter_t * filter, uint32_t window_ms, gap_le_advertising_filter_entry_t * entries, uint16_t num_entries);
+
+/**
+ * @brief Add LE Advertising Report Filter. Matching reports are delivered to the filter callback in addition
+ *        to the regular HCI event handlers.
+ * @param filter
+ */
+void gap_le_add_advertising_filter(gap_le_advertising_filter_t * filter);
+
+/**
+ * @brief Remove LE Advertising Report Filter
+ * @param filter
+ */
+void gap_le_remove_advertising_filter(gap_le_advertising_filter_t * filter);
+
 /**
  * @brief Enable privacy by using random addresses
  * @param random_address_type to use (incl. OFF)
@@ -246,6 +246,7 @@ static void le_handle_extended_advertisement_report(uint8_t *packet, uint16_t si
 #ifdef ENABLE_LE_ISOCHRONOUS_STREAMS
 static hci_iso_stream_t * hci_iso_stream_create(hci_iso_type_t iso_type, hci_iso_stream_state_t state, uint8_t group_id, uint8_t stream_id);
 static void hci_iso_stream_finalize(hci_iso_stream_t * iso_stream);
+static void hci_iso_stream_release_tx_queue(hci_iso_stream_t * iso_stream);
 static void hci_iso_stream_finalize_by_type_and_group_id(hci_iso_type_t iso_type, uint8_t group_id);
 static hci_iso_stream_t * hci_iso_stream_for_con_handle(hci_con_handle_t con_handle);
 static void hci_iso_stream_requested_finalize(uint8_t big_handle);
@@ -254,6 +255,7 @@ static void hci_iso_packet_handler(hci_iso_stream_t *iso_stream, uint8_t *packet
 static le_audio_big_t * hci_big_for_handle(uint8_t big_handle);
 static le_audio_cig_t * hci_cig_for_id(uint8_t cig_id);
 static void hci_iso_notify_can_send_now(void);
+static void hci_iso_tx_queue_run(void);
 static void hci_emit_big_created(const le_audio_big_t * big, uint8_t status);
 static void hci_emit_big_terminated(const le_audio_big_t * big);
 static void hci_emit_big_sync_created(const le_audio_big_sync_t * big_sync, uint8_t status);
@@ -1173,6 +1175,139 @@ uint8_t hci_send_iso_packet_buffer(uint16_t size){
 
     return hci_send_iso_packet_fragments();
 }
+
+void hci_iso_tx_queue_init(hci_iso_tx_queue_t * queue, hci_iso_tx_queue_sdu_t * sdus, uint8_t * storage, uint8_t num_sdus, uint16_t max_sdu_len){
+    memset(queue, 0, sizeof(hci_iso_tx_queue_t));
+    queue->con_handle = HCI_CON_HANDLE_INVALID;
+    queue->sdus = sdus;
+    queue->storage = storage;
+    queue->num_sdus = num_sdus;
+    queue->max_sdu_len = max_sdu_len;
+}
+
+uint8_t hci_iso_tx_queue_attach(hci_con_handle_t con_handle, hci_iso_tx_queue_t * queue){
+    hci_iso_stream_t * iso_stream = hci_iso_stream_for_con_handle(con_handle);
+    if (iso_stream == NULL){
+        return ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER;
+    }
+    if (iso_stream->tx_queue != NULL){
+        return ERROR_CODE_COMMAND_DISALLOWED;
+    }
+    queue->con_handle = con_handle;
+    iso_stream->tx_queue = queue;
+    hci_iso_tx_queue_run();
+    return ERROR_CODE_SUCCESS;
+}
+
+uint8_t hci_iso_tx_queue_detach(hci_con_handle_t con_handle){
+    hci_iso_stream_t * iso_stream = hci_iso_stream_for_con_handle(con_handle);
+    if ((iso_stream == NULL) || (iso_stream->tx_queue == NULL)){
+        return ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER;
+    }
+    hci_iso_tx_queue_t * queue = iso_stream->tx_queue;
+    queue->statistics.sdus_dropped += queue->statistics.queue_depth;
+    queue->statistics.queue_depth = 0;
+    queue->con_handle = HCI_CON_HANDLE_INVALID;
+    iso_stream->tx_queue = NULL;
+    return ERROR_CODE_SUCCESS;
+}
+
+static uint8_t hci_iso_tx_queue_add(hci_iso_tx_queue_t * queue, uint16_t packet_sequence_number, bool time_stamp_valid,
+                                    uint32_t time_stamp, const uint8_t * sdu, uint16_t sdu_len){
+    // ISO header + Time_Stamp + Packet_Sequence_Number + ISO_SDU_Length
+    if ((sdu_len > queue->max_sdu_len) || ((sdu_len + 12u) > HCI_OUTGOING_PACKET_BUFFER_SIZE)){
+        return ERROR_CODE_INVALID_HCI_COMMAND_PARAMETERS;
+    }
+    if (queue->statistics.queue_depth == queue->num_sdus){
+        queue->statistics.sdus_dropped++;
+        return ERROR_CODE_MEMORY_CAPACITY_EXCEEDED;
+    }
+    uint8_t index = (uint8_t) ((queue->head + queue->statistics.queue_depth) % queue->num_sdus);
+    hci_iso_tx_queue_sdu_t * entry = &queue->sdus[index];
+    entry->packet_sequence_number = packet_sequence_number;
+    entry->len = sdu_len;
+    entry->time_stamp = time_stamp;
+    entry->time_stamp_valid = time_stamp_valid;
+    (void) memcpy(&queue->storage[index * queue->max_sdu_len], sdu, sdu_len);
+    queue->statistics.queue_depth++;
+    queue->statistics.max_queue_depth = (uint8_t) btstack_max(queue->statistics.max_queue_depth, queue->statistics.queue_depth);
+    queue->statistics.sdus_queued++;
+    if (queue->con_handle != HCI_CON_HANDLE_INVALID){
+        hci_iso_tx_queue_run();
+    }
+    return ERROR_CODE_SUCCESS;
+}
+
+uint8_t hci_iso_tx_queue_add_sdu(hci_iso_tx_queue_t * queue, uint16_t packet_sequence_number, const uint8_t * sdu, uint16_t sdu_len){
+    return hci_iso_tx_queue_add(queue, packet_sequence_number, false, 0, sdu, sdu_len);
+}
+
+uint8_t hci_iso_tx_queue_add_sdu_with_time_stamp(hci_iso_tx_queue_t * queue, uint16_t packet_sequence_number, uint32_t time_stamp,
+                                                 const uint8_t * sdu, uint16_t sdu_len){
+    return hci_iso_tx_queue_add(queue, packet_sequence_number, true, time_stamp, sdu, sdu_len);
+}
+
+const hci_iso_tx_queue_statistics_t * hci_iso_tx_queue_get_statistics(const hci_iso_tx_queue_t * queue){
+    return &queue->statistics;
+}
+
+static void hci_iso_tx_queue_drop_sdu(hci_iso_tx_queue_t * queue){
+    queue->head = (uint8_t) ((queue->head + 1u) % queue->num_sdus);
+    queue->statistics.queue_depth--;
+}
+
+static void hci_iso_tx_queue_send_sdu(hci_iso_tx_queue_t * queue){
+    const hci_iso_tx_queue_sdu_t * entry = &queue->sdus[queue->head];
+    hci_reserve_packet_buffer();
+    uint8_t * packet = hci_stack->hci_packet_buffer;
+    // Handle, PB = complete SDU, TS
+    uint16_t handle_and_flags = queue->con_handle | (0x02u << 12);
+    uint16_t pos = 4;
+    if (entry->time_stamp_valid){
+        handle_and_flags |= 1u << 14;
+        little_endian_store_32(packet, pos, entry->time_stamp);
+        pos += 4u;
+    }
+    little_endian_store_16(packet, 0, handle_and_flags);
+    little_endian_store_16(packet, pos, entry->packet_sequence_number);
+    pos += 2u;
+    little_endian_store_16(packet, pos, entry->len);
+    pos += 2u;
+    (void) memcpy(&packet[pos], &queue->storage[queue->head * queue->max_sdu_len], entry->len);
+    pos += entry->len;
+    little_endian_store_16(packet, 2, pos - 4u);
+    hci_iso_tx_queue_drop_sdu(queue);
+    queue->statistics.sdus_sent++;
+    (void) hci_send_iso_packet_buffer(pos);
+}
+
+// send queued SDUs while controller has buffers for stream and HCI packet buffer is free
+static void hci_iso_tx_queue_run(void){
+    bool sent = true;
+    while (sent){
+        sent = false;
+        if (hci_stack->hci_packet_buffer_reserved) return;
+        if (!hci_transport_can_send_prepared_packet_now(HCI_ISO_DATA_PACKET)) return;
+        btstack_linked_list_iterator_t it;
+        btstack_linked_list_iterator_init(&it, &hci_stack->iso_streams);
+        while (btstack_linked_list_iterator_has_next(&it)) {
+            hci_iso_stream_t *iso_stream = (hci_iso_stream_t *) btstack_linked_list_iterator_next(&it);
+            hci_iso_tx_queue_t * queue = iso_stream->tx_queue;
+            if (queue == NULL) continue;
+            // catch up after missed ISO interval
+            while ((iso_stream->num_packets_to_skip > 0u) && (queue->statistics.queue_depth > 0u)){
+                iso_stream->num_packets_to_skip--;
+                queue->statistics.sdus_late++;
+                hci_iso_tx_queue_drop_sdu(queue);
+            }
+            if (queue->statistics.queue_depth == 0u) continue;
+            if (iso_stream->num_packets_sent >= hci_stack->iso_packets_to_queue) continue;
+            hci_iso_tx_queue_send_sdu(queue);
+            sent = true;
+            break;
+        }
+    }
+}
 #endif
 
 static void acl_handler(uint8_t *packet, uint16_t size){
@@ -1554,6 +1689,206 @@ void gap_le_get_own_connection_address(uint8_t * addr_type, bd_addr_t addr){
     hci_get_own_address_for_addr_type(hci_stack->le_connection_own_addr_type, addr);
 }
 
+// LE Advertising Report Filters
+
+#ifndef GAP_LE_ADVERTISING_FILTER_DUPLICATE_PROBES
+#define GAP_LE_ADVERTISING_FILTER_DUPLICATE_PROBES 4
+#endif
+
+#define GAP_LE_ADVERTISING_FILTER_ENTRY_UNUSED 0xffu
+
+void gap_le_advertising_filter_init(gap_le_advertising_filter_t * filter, btstack_packet_handler_t callback){
+    memset(filter, 0, sizeof(gap_le_advertising_filter_t));
+    filter->callback = callback;
+}
+
+void gap_le_advertising_filter_set_address_type(gap_le_advertising_filter_t * filter, bd_addr_type_t address_type){
+    filter->rules |= GAP_LE_ADVERTISING_FILTER_RULE_ADDRESS_TYPE;
+    filter->address_type = (uint8_t) address_type;
+}
+
+void gap_le_advertising_filter_set_address(gap_le_advertising_filter_t * filter, bd_addr_type_t address_type, const bd_addr_t address){
+    gap_le_advertising_filter_set_address_type(filter, address_type);
+    filter->rules |= GAP_LE_ADVERTISING_FILTER_RULE_ADDRESS;
+    bd_addr_copy(filter->address, address);
+}
+
+void gap_le_advertising_filter_set_rssi_threshold(gap_le_advertising_filter_t * filter, int8_t rssi_threshold){
+    filter->rules |= GAP_LE_ADVERTISING_FILTER_RULE_RSSI;
+    filter->rssi_threshold = rssi_threshold;
+}
+
+void gap_le_advertising_filter_set_ad_type(gap_le_advertising_filter_t * filter, uint8_t ad_type){
+    filter->rules |= GAP_LE_ADVERTISING_FILTER_RULE_AD_TYPE;
+    filter->ad_type = ad_type;
+}
+
+void gap_le_advertising_filter_set_uuid16(gap_le_advertising_filter_t * filter, uint16_t uuid16){
+    filter->rules |= GAP_LE_ADVERTISING_FILTER_RULE_UUID16;
+    filter->uuid16 = uuid16;
+}
+
+void gap_le_advertising_filter_set_uuid128(gap_le_advertising_filter_t * filter, const uint8_t * uuid128){
+    filter->rules |= GAP_LE_ADVERTISING_FILTER_RULE_UUID128;
+    (void) memcpy(filter->uuid128, uuid128, 16);
+}
+
+void gap_le_advertising_filter_set_manufacturer_id(gap_le_advertising_filter_t * filter, uint16_t manufacturer_id){
+    filter->rules |= GAP_LE_ADVERTISING_FILTER_RULE_MANUFACTURER_ID;
+    filter->manufacturer_id = manufacturer_id;
+}
+
+void gap_le_advertising_filter_set_duplicate_suppression(gap_le_advertising_filter_t * filter, uint32_t window_ms, gap_le_advertising_filter_entry_t * entries, uint16_t num_entries){
+    filter->duplicate_window_ms   = window_ms;
+    filter->duplicate_entries     = entries;
+    filter->duplicate_num_entries = num_entries;
+    uint16_t i;
+    for (i = 0; i < num_entries; i++){
+        entries[i].address_type = GAP_LE_ADVERTISING_FILTER_ENTRY_UNUSED;
+    }
+}
+
+void gap_le_add_advertising_filter(gap_le_advertising_filter_t * filter){
+    btstack_linked_list_add_tail(&hci_stack->le_advertising_filters, (btstack_linked_item_t *) filter);
+}
+
+void gap_le_remove_advertising_filter(gap_le_advertising_filter_t * filter){
+    btstack_linked_list_remove(&hci_stack->le_advertising_filters, (btstack_linked_item_t *) filter);
+}
+
+// FNV-1a
+static uint32_t hci_le_advertising_filter_hash(const uint8_t * data, uint16_t len){
+    uint32_t hash = 0x811c9dc5u;
+    uint16_t i;
+    for (i = 0; i < len; i++){
+        hash = (hash ^ data[i]) * 0x01000193u;
+    }
+    return hash;
+}
+
+static bool hci_le_advertising_filter_match_data(const gap_le_advertising_filter_t * filter, const uint8_t * data, uint8_t data_len){
+    if ((filter->rules & (GAP_LE_ADVERTISING_FILTER_RULE_AD_TYPE | GAP_LE_ADVERTISING_FILTER_RULE_MANUFACTURER_ID)) != 0u){
+        bool ad_type_found         = (filter->rules & GAP_LE_ADVERTISING_FILTER_RULE_AD_TYPE) == 0u;
+        bool manufacturer_id_found = (filter->rules & GAP_LE_ADVERTISING_FILTER_RULE_MANUFACTURER_ID) == 0u;
+        ad_context_t context;
+        for (ad_iterator_init(&context, data_len, data) ; ad_iterator_has_more(&context) ; ad_iterator_next(&context)){
+            uint8_t ad_type = ad_iterator_get_data_type(&context);
+            if (ad_type == filter->ad_type){
+                ad_type_found = true;
+            }
+            if ((ad_type == BLUETOOTH_DATA_TYPE_MANUFACTURER_SPECIFIC_DATA) && (ad_iterator_get_data_len(&context) >= 2u)){
+                if (little_endian_read_16(ad_iterator_get_data(&context), 0) == filter->manufacturer_id){
+                    manufacturer_id_found = true;
+                }
+            }
+        }
+        if ((ad_type_found == false) || (manufacturer_id_found == false)){
+            return false;
+        }
+    }
+    if ((filter->rules & GAP_LE_ADVERTISING_FILTER_RULE_UUID16) != 0u){
+        if (ad_data_contains_uuid16(data_len, data, filter->uuid16) == false){
+            return false;
+        }
+    }
+    if ((filter->rules & GAP_LE_ADVERTISING_FILTER_RULE_UUID128) != 0u){
+        if (ad_data_contains_uuid128(data_len, data, filter->uuid128) == false){
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool hci_le_advertising_filter_match(const gap_le_advertising_filter_t * filter, uint8_t address_type, const uint8_t * address, int8_t rssi, const uint8_t * data, uint8_t data_len){
+    if (filter->rules == 0u){
+        return true;
+    }
+    if (((filter->rules & GAP_LE_ADVERTISING_FILTER_RULE_ADDRESS_TYPE) != 0u) && (address_type != filter->address_type)){
+        return false;
+    }
+    if (((filter->rules & GAP_LE_ADVERTISING_FILTER_RULE_ADDRESS) != 0u) && (memcmp(address, filter->address, 6) != 0)){
+        return false;
+    }
+    if (((filter->rules & GAP_LE_ADVERTISING_FILTER_RULE_RSSI) != 0u) && (rssi < filter->rssi_threshold)){
+        return false;
+    }
+    return hci_le_advertising_filter_match_data(filter, data, data_len);
+}
+
+// returns true if same data from same address has been delivered within time window
+static bool hci_le_advertising_filter_duplicate(gap_le_advertising_filter_t * filter, uint8_t address_type, const uint8_t * address, uint32_t data_hash, uint32_t now_ms){
+    if (filter->duplicate_num_entries == 0u){
+        return false;
+    }
+    // probe a few entries starting at slot given by address, replace least recently delivered one
+    uint32_t address_hash = hci_le_advertising_filter_hash(address, 6);
+    uint16_t index = (uint16_t) (address_hash % filter->duplicate_num_entries);
+    gap_le_advertising_filter_entry_t * oldest_entry = NULL;
+    uint16_t probe;
+    for (probe = 0; (probe < GAP_LE_ADVERTISING_FILTER_DUPLICATE_PROBES) && (probe < filter->duplicate_num_entries); probe++){
+        gap_le_advertising_filter_entry_t * entry = &filter->duplicate_entries[index];
+        if (entry->address_type == GAP_LE_ADVERTISING_FILTER_ENTRY_UNUSED){
+            oldest_entry = entry;
+            break;
+        }
+        if ((entry->address_type == address_type) && (memcmp(entry->address, address, 6) == 0)){
+            if ((entry->data_hash == data_hash) && ((now_ms - entry->time_ms) < filter->duplicate_window_ms)){
+                return true;
+            }
+            entry->data_hash = data_hash;
+            entry->time_ms   = now_ms;
+            return false;
+        }
+        if ((oldest_entry == NULL) || ((int32_t)(entry->time_ms - oldest_entry->time_ms) < 0)){
+            oldest_entry = entry;
+        }
+        index++;
+        if (index == filter->duplicate_num_entries){
+            index = 0;
+        }
+    }
+    oldest_entry->address_type = address_type;
+    (void) memcpy(oldest_entry->address, address, 6);
+    oldest_entry->data_hash = data_hash;
+    oldest_entry->time_ms   = now_ms;
+    return false;
+}
+
+static void hci_le_advertising_filter_dispatch(uint8_t * event, uint16_t size, uint8_t address_type, const uint8_t * report_address, int8_t rssi, const uint8_t * data, uint8_t data_len){
+    if (btstack_linked_list_empty(&hci_stack->le_advertising_filters)){
+        return;
+    }
+    bd_addr_t address;
+    reverse_bd_addr(report_address, address);
+    bool data_hash_valid = false;
+    uint32_t data_hash = 0;
+    uint32_t now_ms = 0;
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &hci_stack->le_advertising_filters);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        gap_le_advertising_filter_t * filter = (gap_le_advertising_filter_t *) btstack_linked_list_iterator_next(&it);
+        filter->statistics.reports_received++;
+        if (hci_le_advertising_filter_match(filter, address_type, address, rssi, data, data_len) == false){
+            filter->statistics.reports_rejected++;
+            continue;
+        }
+        if (filter->duplicate_num_entries > 0u){
+            // hash data and get time once for all filters
+            if (data_hash_valid == false){
+                data_hash = hci_le_advertising_filter_hash(data, data_len);
+                now_ms = btstack_run_loop_get_time_ms();
+                data_hash_valid = true;
+            }
+            if (hci_le_advertising_filter_duplicate(filter, address_type, address, data_hash, now_ms)){
+                filter->statistics.reports_duplicate++;
+                continue;
+            }
+        }
+        filter->statistics.reports_delivered++;
+        (*filter->callback)(HCI_EVENT_PACKET, 0, event, size);
+    }
+}
+
 void le_handle_advertisement_report(uint8_t *packet, uint16_t size){
 
     uint16_t offset = 3;
@@ -1582,6 +1917,7 @@ void le_handle_advertisement_report(uint8_t *packet, uint16_t size){
         pos +=    data_length;
         offset += data_length + 1u; // rssi
         hci_emit_btstack_event(event, pos, 1);
+        hci_le_advertising_filter_dispatch(event, pos, event[3], &event[4], (int8_t) event[10], &event[12], data_length);
     }
 }
 
@@ -1646,6 +1982,7 @@ static void le_handle_extended_advertisement_report(uint8_t *packet, uint16_t si
             pos    += 1 +data_length;
             offset += 1+ data_length;
             hci_emit_btstack_event(event, pos, 1);
+            hci_le_advertising_filter_dispatch(event, pos, event[3], &event[4], (int8_t) event[10], &event[12], (uint8_t) data_length);
         } else {
             event[0] = GAP_EVENT_EXTENDED_ADVERTISING_REPORT;
             uint8_t report_len = 24 + data_length;
@@ -1654,6 +1991,7 @@ static void le_handle_extended_advertisement_report(uint8_t *packet, uint16_t si
             memcpy(&event[4], &packet[offset], report_len);
             offset += report_len;
             hci_emit_btstack_event(event, 2 + report_len, 1);
+            hci_le_advertising_filter_dispatch(event, 2 + report_len, event[4], &event[5], (int8_t) event[15], &event[26], (uint8_t) data_length);
         }
     }
 }
@@ -2808,8 +3146,6 @@ static void handle_command_complete_event(uint8_t * packet, uint16_t size){
     uint16_t manufacturer;
 #ifdef ENABLE_CLASSIC
     hci_connection_t * conn;
-#endif
-#if defined(ENABLE_CLASSIC) || (defined(ENABLE_BLE) && defined(ENABLE_LE_ISOCHRONOUS_STREAMS))
     hci_con_handle_t handle;
 #endif
 #ifdef ENABLE_LE_ISOCHRONOUS_STREAMS
@@ -3136,7 +3472,6 @@ static void handle_command_complete_event(uint8_t * packet, uint16_t size){
                     btstack_linked_list_iterator_init(&it, &hci_stack->iso_streams);
                     while (btstack_linked_list_iterator_has_next(&it)){
                         hci_iso_stream_t * iso_stream = (hci_iso_stream_t *) btstack_linked_list_iterator_next(&it);
-                        handle = iso_stream->cis_handle;
                         bool emit_cis_created = false;
                         switch (iso_stream->state){
                             case HCI_ISO_STREAM_STATE_W4_ISO_SETUP_INPUT:
@@ -4574,6 +4909,7 @@ static void event_handler(uint8_t *packet, uint16_t size){
                             iso_stream = (hci_iso_stream_t *) btstack_linked_list_iterator_next(&it);
                             if (iso_stream->group_id == big->big_handle){
                                 log_info("BIG Terminated, big_handle 0x%02x, con handle 0x%04x", iso_stream->group_id, iso_stream->cis_handle);
+                                hci_iso_stream_release_tx_queue(iso_stream);
                                 btstack_linked_list_iterator_remove(&it);
                                 btstack_memory_hci_iso_stream_free(iso_stream);
                             }
@@ -4790,6 +5126,9 @@ static void packet_handler(uint8_t packet_type, uint8_t *packet, uint16_t size){
  */
 void hci_add_event_handler(btstack_packet_callback_registration_t * callback_handler){
     btstack_linked_list_add_tail(&hci_stack->event_handlers, (btstack_linked_item_t*) callback_handler);
+#ifdef ENABLE_HCI_EVENT_SUBSCRIPTIONS
+    hci_stack->event_dispatch_table_outdated = true;
+#endif
 }
 
 /**
@@ -4797,8 +5136,135 @@ void hci_add_event_handler(btstack_packet_callback_registration_t * callback_han
  */
 void hci_remove_event_handler(btstack_packet_callback_registration_t * callback_handler){
     btstack_linked_list_remove(&hci_stack->event_handlers, (btstack_linked_item_t*) callback_handler);
+#ifdef ENABLE_HCI_EVENT_SUBSCRIPTIONS
+    hci_stack->event_dispatch_table_outdated = true;
+#endif
+}
+
+#ifdef ENABLE_HCI_EVENT_SUBSCRIPTIONS
+void hci_event_subscription_init(hci_event_subscription_t * subscription, btstack_packet_handler_t callback){
+    memset(subscription, 0, sizeof(hci_event_subscription_t));
+    subscription->registration.callback = callback;
+}
+
+void hci_event_subscription_add_event(hci_event_subscription_t * subscription, uint8_t event_code){
+    subscription->event_codes[event_code >> 3] |= 1u << (event_code & 7);
+}
+
+void hci_event_subscription_add_le_meta_subevent(hci_event_subscription_t * subscription, uint8_t subevent_code){
+    btstack_assert(subevent_code < HCI_EVENT_DISPATCH_NUM_LE_META_SUBEVENTS);
+    subscription->le_meta_subevent_codes[subevent_code >> 3] |= 1u << (subevent_code & 7);
+}
+
+void hci_add_event_subscription(hci_event_subscription_t * subscription){
+    btstack_linked_list_add_tail(&hci_stack->event_subscriptions, &subscription->item);
+    hci_add_event_handler(&subscription->registration);
+}
+
+void hci_remove_event_subscription(hci_event_subscription_t * subscription){
+    hci_remove_event_handler(&subscription->registration);
+    btstack_linked_list_remove(&hci_stack->event_subscriptions, &subscription->item);
+}
+
+static bool hci_event_subscription_bit_set(const uint8_t * bitmap, uint8_t code){
+    return (bitmap[code >> 3] & (1u << (code & 7))) != 0u;
+}
+
+static hci_event_subscription_t * hci_event_subscription_for_registration(const btstack_packet_callback_registration_t * registration){
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &hci_stack->event_subscriptions);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        hci_event_subscription_t * subscription = (hci_event_subscription_t *) btstack_linked_list_iterator_next(&it);
+        if (&subscription->registration == registration){
+            return subscription;
+        }
+    }
+    return NULL;
 }
 
+static bool hci_event_subscription_matches(const hci_event_subscription_t * subscription, const uint8_t * event, uint16_t size){
+    uint8_t event_code = event[0];
+    if (hci_event_subscription_bit_set(subscription->event_codes, event_code)){
+        return true;
+    }
+    if ((event_code != HCI_EVENT_LE_META) || (size < 3) || (event[2] >= HCI_EVENT_DISPATCH_NUM_LE_META_SUBEVENTS)){
+        return false;
+    }
+    return hci_event_subscription_bit_set(subscription->le_meta_subevent_codes, event[2]);
+}
+
+static bool hci_event_handler_registered(const btstack_packet_callback_registration_t * registration){
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &hci_stack->event_handlers);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        if (btstack_linked_list_iterator_next(&it) == &registration->item){
+            return true;
+        }
+    }
+    return false;
+}
+
+// assign bit to each handler in registration order and collect handlers for each (sub)event code
+static void hci_event_dispatch_table_build(void){
+    memset(hci_stack->event_dispatch_masks, 0, sizeof(hci_stack->event_dispatch_masks));
+    memset(hci_stack->event_dispatch_le_meta_masks, 0, sizeof(hci_stack->event_dispatch_le_meta_masks));
+    hci_stack->event_dispatch_table_outdated = false;
+    hci_stack->event_dispatch_table_ready = false;
+    uint8_t num_handlers = 0;
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &hci_stack->event_handlers);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        btstack_packet_callback_registration_t * registration = (btstack_packet_callback_registration_t*) btstack_linked_list_iterator_next(&it);
+        if (num_handlers == HCI_EVENT_DISPATCH_MAX_HANDLERS){
+            log_info("More than %u event handlers, dispatch without tables", HCI_EVENT_DISPATCH_MAX_HANDLERS);
+            return;
+        }
+        hci_stack->event_dispatch_handlers[num_handlers] = registration;
+        uint32_t handler_bit = 1UL << num_handlers;
+        num_handlers++;
+        const hci_event_subscription_t * subscription = hci_event_subscription_for_registration(registration);
+        uint16_t code;
+        for (code = 0; code < 256u; code++){
+            if ((subscription == NULL) || hci_event_subscription_bit_set(subscription->event_codes, (uint8_t) code)){
+                hci_stack->event_dispatch_masks[code] |= handler_bit;
+            }
+        }
+        for (code = 0; code < HCI_EVENT_DISPATCH_NUM_LE_META_SUBEVENTS; code++){
+            if ((subscription == NULL)
+            || hci_event_subscription_bit_set(subscription->event_codes, HCI_EVENT_LE_META)
+            || hci_event_subscription_bit_set(subscription->le_meta_subevent_codes, (uint8_t) code)){
+                hci_stack->event_dispatch_le_meta_masks[code] |= handler_bit;
+            }
+        }
+    }
+    hci_stack->event_dispatch_table_ready = true;
+}
+
+static void hci_event_dispatch_with_table(uint8_t * event, uint16_t size){
+    uint32_t handler_mask;
+    if ((event[0] == HCI_EVENT_LE_META) && (size >= 3u) && (event[2] < HCI_EVENT_DISPATCH_NUM_LE_META_SUBEVENTS)){
+        handler_mask = hci_stack->event_dispatch_le_meta_masks[event[2]];
+    } else {
+        handler_mask = hci_stack->event_dispatch_masks[event[0]];
+    }
+    hci_stack->event_dispatch_depth++;
+    uint8_t index = 0;
+    while (handler_mask != 0u){
+        if ((handler_mask & 1u) != 0u){
+            btstack_packet_callback_registration_t * registration = hci_stack->event_dispatch_handlers[index];
+            // skip handlers removed by an earlier handler, table gets rebuilt after dispatch
+            if ((hci_stack->event_dispatch_table_outdated == false)
+            || hci_event_handler_registered(registration)){
+                registration->callback(HCI_EVENT_PACKET, 0, event, size);
+            }
+        }
+        handler_mask >>= 1;
+        index++;
+    }
+    hci_stack->event_dispatch_depth--;
+}
+#endif
+
 /** Register HCI packet handlers */
 void hci_register_acl_packet_handler(btstack_packet_handler_t handler){
     hci_stack->acl_packet_handler = handler;
@@ -7964,13 +8430,30 @@ static void hci_emit_event(uint8_t * event, uint16_t size, int dump){
     // dump packet
     if (dump) {
         hci_dump_packet( HCI_EVENT_PACKET, 1, event, size);
-    } 
+    }
+
+#ifdef ENABLE_HCI_EVENT_SUBSCRIPTIONS
+    // tables are only updated outside of event handlers
+    if (hci_stack->event_dispatch_table_outdated && (hci_stack->event_dispatch_depth == 0u)){
+        hci_event_dispatch_table_build();
+    }
+    if (hci_stack->event_dispatch_table_ready && (hci_stack->event_dispatch_table_outdated == false)){
+        hci_event_dispatch_with_table(event, size);
+        return;
+    }
+#endif
 
     // dispatch to all event handlers
     btstack_linked_list_iterator_t it;
     btstack_linked_list_iterator_init(&it, &hci_stack->event_handlers);
     while (btstack_linked_list_iterator_has_next(&it)){
         btstack_packet_callback_registration_t * entry = (btstack_packet_callback_registration_t*) btstack_linked_list_iterator_next(&it);
+#ifdef ENABLE_HCI_EVENT_SUBSCRIPTIONS
+        const hci_event_subscription_t * subscription = hci_event_subscription_for_registration(entry);
+        if ((subscription != NULL) && (hci_event_subscription_matches(subscription, event, size) == false)){
+            continue;
+        }
+#endif
         entry->callback(HCI_EVENT_PACKET, 0, event, size);
     }
 }
@@ -10088,8 +10571,16 @@ static hci_iso_stream_t * hci_iso_stream_for_con_handle(hci_con_handle_t con_han
     return NULL;
 }
 
+static void hci_iso_stream_release_tx_queue(hci_iso_stream_t * iso_stream){
+    if (iso_stream->tx_queue != NULL){
+        iso_stream->tx_queue->con_handle = HCI_CON_HANDLE_INVALID;
+        iso_stream->tx_queue = NULL;
+    }
+}
+
 static void hci_iso_stream_finalize(hci_iso_stream_t * iso_stream){
     log_info("hci_iso_stream_finalize con_handle 0x%04x, group_id 0x%02x", iso_stream->cis_handle, iso_stream->group_id);
+    hci_iso_stream_release_tx_queue(iso_stream);
     btstack_linked_list_remove(&hci_stack->iso_streams, (btstack_linked_item_t*) iso_stream);
     btstack_memory_hci_iso_stream_free(iso_stream);
 }
@@ -10101,6 +10592,7 @@ static void hci_iso_stream_finalize_by_type_and_group_id(hci_iso_type_t iso_type
         hci_iso_stream_t * iso_stream = (hci_iso_stream_t *) btstack_linked_list_iterator_next(&it);
         if ((iso_stream->group_id == group_id) &&
             (iso_stream->iso_type == iso_type)){
+            hci_iso_stream_release_tx_queue(iso_stream);
             btstack_linked_list_iterator_remove(&it);
             btstack_memory_hci_iso_stream_free(iso_stream);
         }
@@ -10435,6 +10927,9 @@ static void hci_iso_notify_can_send_now(void){
         }
     }
 
+    // send queued SDUs first
+    hci_iso_tx_queue_run();
+
     if (hci_stack->hci_packet_buffer_reserved) return;
 
     btstack_linked_list_iterator_init(&it, &hci_stack->le_audio_bigs);
@@ -10511,6 +11006,9 @@ uint8_t gap_big_create(le_audio_big_t * storage, le_audio_big_params_t * big_par
     big->params = big_params;
     big->state = LE_AUDIO_BIG_STATE_CREATE;
     big->num_bis = big_params->num_bis;
+    big->can_send_now_requested = false;
+    big->num_completed_timestamp_previous_valid = false;
+    big->num_completed_timestamp_current_valid = false;
     btstack_linked_list_add(&hci_stack->le_audio_bigs, (btstack_linked_item_t *) big);
 
     hci_run();
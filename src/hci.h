@@ -725,6 +725,42 @@ typedef enum{
     HCI_ISO_STREAM_STATE_W4_DISCONNECTED,
 } hci_iso_stream_state_t;
 
+typedef struct {
+    uint16_t packet_sequence_number;
+    uint16_t len;
+    uint32_t time_stamp;
+    bool     time_stamp_valid;
+} hci_iso_tx_queue_sdu_t;
+
+typedef struct {
+    // SDUs added to queue
+    uint32_t sdus_queued;
+    // SDUs sent to controller
+    uint32_t sdus_sent;
+    // SDUs skipped to catch up after missed ISO interval, detected by delayed Number of Completed Packets
+    uint32_t sdus_late;
+    // SDUs dropped as queue was full or on detach
+    uint32_t sdus_dropped;
+    // current and max number of SDUs in queue
+    uint8_t  queue_depth;
+    uint8_t  max_queue_depth;
+} hci_iso_tx_queue_statistics_t;
+
+typedef struct {
+    hci_con_handle_t con_handle;
+
+    // SDU storage provided by application
+    hci_iso_tx_queue_sdu_t * sdus;
+    uint8_t  * storage;
+    uint16_t   max_sdu_len;
+    uint8_t    num_sdus;
+
+    // oldest SDU
+    uint8_t    head;
+
+    hci_iso_tx_queue_statistics_t statistics;
+} hci_iso_tx_queue_t;
+
 typedef struct {
     // linked list - assert: first field
     btstack_linked_item_t    item;
@@ -771,6 +807,9 @@ typedef struct {
     // ready to send
     bool emit_ready_to_send;
 
+    // outgoing SDUs queued by application
+    hci_iso_tx_queue_t * tx_queue;
+
 } hci_iso_stream_t;
 #endif
 
@@ -990,6 +1029,24 @@ typedef enum {
     LE_RESOLVING_LIST_DONE
 } le_resolving_list_state_t;
 
+#ifdef ENABLE_HCI_EVENT_SUBSCRIPTIONS
+// max number of event handlers and subscriptions dispatched via per event code tables
+#define HCI_EVENT_DISPATCH_MAX_HANDLERS 32
+// LE Meta subevents are tracked individually up to this code
+#define HCI_EVENT_DISPATCH_NUM_LE_META_SUBEVENTS 64
+
+typedef struct {
+    // item in list of subscriptions
+    btstack_linked_item_t item;
+    // registration in list of event handlers
+    btstack_packet_callback_registration_t registration;
+    // bitmap of HCI and BTstack event codes
+    uint8_t event_codes[32];
+    // bitmap of LE Meta subevent codes
+    uint8_t le_meta_subevent_codes[HCI_EVENT_DISPATCH_NUM_LE_META_SUBEVENTS / 8];
+} hci_event_subscription_t;
+#endif
+
 /**
  * main data structure
  */
@@ -1024,6 +1081,17 @@ typedef struct {
     /* callbacks for events */
     btstack_linked_list_t event_handlers;
 
+#ifdef ENABLE_HCI_EVENT_SUBSCRIPTIONS
+    btstack_linked_list_t event_subscriptions;
+    // per event code bitmap of event handlers, bit n refers to event_dispatch_handlers[n]
+    btstack_packet_callback_registration_t * event_dispatch_handlers[HCI_EVENT_DISPATCH_MAX_HANDLERS];
+    uint32_t event_dispatch_masks[256];
+    uint32_t event_dispatch_le_meta_masks[HCI_EVENT_DISPATCH_NUM_LE_META_SUBEVENTS];
+    bool     event_dispatch_table_outdated;
+    bool     event_dispatch_table_ready;
+    uint8_t  event_dispatch_depth;
+#endif
+
 #ifdef ENABLE_CLASSIC
     /* callback for reject classic connection */
     int (*gap_classic_accept_callback)(bd_addr_t addr, hci_link_type_t link_type);
@@ -1226,6 +1294,9 @@ typedef struct {
     bool   le_scanning_enabled;
     bool   le_scanning_active;
 
+    // LE Advertising Report Filters
+    btstack_linked_list_t le_advertising_filters;
+
     le_connecting_state_t le_connecting_state;
     le_connecting_state_t le_connecting_request;
 
@@ -1441,6 +1512,44 @@ void hci_add_event_handler(btstack_packet_callback_registration_t * callback_han
  */
 void hci_remove_event_handler(btstack_packet_callback_registration_t * callback_handler);
 
+#ifdef ENABLE_HCI_EVENT_SUBSCRIPTIONS
+/**
+ * @brief Init event subscription without any event codes
+ * @param subscription
+ * @param callback
+ */
+void hci_event_subscription_init(hci_event_subscription_t * subscription, btstack_packet_handler_t callback);
+
+/**
+ * @brief Subscribe to HCI or BTstack event code. Subscribing to HCI_EVENT_LE_META includes all LE Meta subevents
+ * @note must be called before hci_add_event_subscription
+ * @param subscription
+ * @param event_code
+ */
+void hci_event_subscription_add_event(hci_event_subscription_t * subscription, uint8_t event_code);
+
+/**
+ * @brief Subscribe to LE Meta subevent code
+ * @note must be called before hci_add_event_subscription
+ * @param subscription
+ * @param subevent_code < HCI_EVENT_DISPATCH_NUM_LE_META_SUBEVENTS
+ */
+void hci_event_subscription_add_le_meta_subevent(hci_event_subscription_t * subscription, uint8_t subevent_code);
+
+/**
+ * @brief Add event packet handler that only receives subscribed events.
+ * @note Event handlers and subscriptions are called in the order they have been added
+ * @param subscription
+ */
+void hci_add_event_subscription(hci_event_subscription_t * subscription);
+
+/**
+ * @brief Remove event subscription
+ * @param subscription
+ */
+void hci_remove_event_subscription(hci_event_subscription_t * subscription);
+#endif
+
 /**
  * @brief Registers a packet handler for ACL data. Used by L2CAP
  */
@@ -1532,6 +1641,65 @@ uint8_t hci_request_cis_can_send_now_events(hci_con_handle_t cis_con_handle);
  */
 uint8_t hci_send_iso_packet_buffer(uint16_t size);
 
+#ifdef ENABLE_LE_ISOCHRONOUS_STREAMS
+/**
+ * @brief Init ISO TX queue that allows to queue several outgoing SDUs for a BIS or CIS
+ * @param queue
+ * @param sdus array for SDU info with num_sdus entries
+ * @param storage for num_sdus * max_sdu_len bytes
+ * @param num_sdus
+ * @param max_sdu_len
+ */
+void hci_iso_tx_queue_init(hci_iso_tx_queue_t * queue, hci_iso_tx_queue_sdu_t * sdus, uint8_t * storage, uint8_t num_sdus, uint16_t max_sdu_len);
+
+/**
+ * @brief Attach ISO TX queue to BIS or CIS. Queued SDUs are sent whenever the controller can accept them
+ *        (see hci_set_num_iso_packets_to_queue), without HCI_EVENT_BIS_CAN_SEND_NOW / HCI_EVENT_CIS_CAN_SEND_NOW.
+ *        SDUs larger than the controller ISO data packet length are fragmented.
+ * @note Queue is detached when the ISO stream is closed
+ * @param con_handle of BIS or CIS
+ * @param queue
+ * @return status
+ */
+uint8_t hci_iso_tx_queue_attach(hci_con_handle_t con_handle, hci_iso_tx_queue_t * queue);
+
+/**
+ * @brief Detach ISO TX queue from BIS or CIS, queued SDUs are dropped
+ * @param con_handle of BIS or CIS
+ * @return status
+ */
+uint8_t hci_iso_tx_queue_detach(hci_con_handle_t con_handle);
+
+/**
+ * @brief Add SDU to ISO TX queue
+ * @param queue
+ * @param packet_sequence_number
+ * @param sdu
+ * @param sdu_len
+ * @return status, ERROR_CODE_MEMORY_CAPACITY_EXCEEDED if queue is full
+ */
+uint8_t hci_iso_tx_queue_add_sdu(hci_iso_tx_queue_t * queue, uint16_t packet_sequence_number, const uint8_t * sdu, uint16_t sdu_len);
+
+/**
+ * @brief Add SDU with Time_Stamp to ISO TX queue
+ * @param queue
+ * @param packet_sequence_number
+ * @param time_stamp in us, controller clock
+ * @param sdu
+ * @param sdu_len
+ * @return status, ERROR_CODE_MEMORY_CAPACITY_EXCEEDED if queue is full
+ */
+uint8_t hci_iso_tx_queue_add_sdu_with_time_stamp(hci_iso_tx_queue_t * queue, uint16_t packet_sequence_number, uint32_t time_stamp,
+                                                 const uint8_t * sdu, uint16_t sdu_len);
+
+/**
+ * @brief Get ISO TX queue statistics
+ * @param queue
+ * @return statistics
+ */
+const hci_iso_tx_queue_statistics_t * hci_iso_tx_queue_get_statistics(const hci_iso_tx_queue_t * queue);
+#endif
+
 /**
  * Reserves outgoing packet buffer.
  * @note Must only be called after a 'can send now' check or event
@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+#define BTSTACK_FILE__ "le_audio_jitter_buffer.c"
+
+#include <string.h>
+
+#include "btstack_debug.h"
+#include "btstack_util.h"
+#include "le-audio/le_audio_jitter_buffer.h"
+
+// ISO Data packet: header, optional time stamp, packet sequence number and ISO SDU length
+#define ISO_DATA_HEADER_LEN      4
+#define ISO_DATA_TIME_STAMP_LEN  4
+#define ISO_DATA_LOAD_HEADER_LEN 4
+
+// distance from sequence number a to b, negative if b is older
+static int16_t le_audio_jitter_buffer_distance(uint16_t a, uint16_t b){
+    return (int16_t) (uint16_t) (b - a);
+}
+
+// index relative to next SDU to play, continuous across sequence number wrap for any number of slots
+static uint16_t le_audio_jitter_buffer_slot_index(const le_audio_jitter_buffer_t * jitter_buffer, uint16_t sequence_number){
+    uint16_t offset = (uint16_t) (sequence_number - jitter_buffer->next_sequence_number);
+    return (uint16_t) (((uint32_t) jitter_buffer->next_slot_index + offset) % jitter_buffer->num_slots);
+}
+
+static void le_audio_jitter_buffer_advance(le_audio_jitter_buffer_t * jitter_buffer, uint16_t num_sdus){
+    jitter_buffer->next_sequence_number = (uint16_t) (jitter_buffer->next_sequence_number + num_sdus);
+    jitter_buffer->next_slot_index = (uint16_t) (((uint32_t) jitter_buffer->next_slot_index + num_sdus) % jitter_buffer->num_slots);
+}
+
+// SDU in slot n would overwrite the SDU returned by last call to get_sdu
+static uint16_t le_audio_jitter_buffer_window(const le_audio_jitter_buffer_t * jitter_buffer){
+    return (uint16_t) (jitter_buffer->num_slots - 1u);
+}
+
+void le_audio_jitter_buffer_init(le_audio_jitter_buffer_t * jitter_buffer, le_audio_jitter_buffer_slot_t * slots, uint8_t * storage,
+                                 uint16_t num_slots, uint16_t max_sdu_len, uint16_t latency_sdus){
+    btstack_assert(latency_sdus > 0u);
+    btstack_assert(num_slots >= (latency_sdus + 2u));
+    memset(jitter_buffer, 0, sizeof(le_audio_jitter_buffer_t));
+    jitter_buffer->slots = slots;
+    jitter_buffer->storage = storage;
+    jitter_buffer->num_slots = num_slots;
+    jitter_buffer->max_sdu_len = max_sdu_len;
+    jitter_buffer->latency_sdus = latency_sdus;
+    le_audio_jitter_buffer_reset(jitter_buffer);
+}
+
+void le_audio_jitter_buffer_reset(le_audio_jitter_buffer_t * jitter_buffer){
+    uint16_t i;
+    for (i = 0; i < jitter_buffer->num_slots; i++){
+        jitter_buffer->slots[i].valid = false;
+    }
+    jitter_buffer->receiving = false;
+    jitter_buffer->playing = false;
+    jitter_buffer->next_slot_index = 0;
+    jitter_buffer->num_missing_in_a_row = 0;
+}
+
+// drop oldest SDUs so that sequence number fits into window, keep num_keep SDU intervals
+static void le_audio_jitter_buffer_make_room(le_audio_jitter_buffer_t * jitter_buffer, uint16_t sequence_number, uint16_t num_keep){
+    uint16_t num_drop = (uint16_t) ((uint16_t) le_audio_jitter_buffer_distance(jitter_buffer->next_sequence_number, sequence_number) + 1u - num_keep);
+    if (num_drop > le_audio_jitter_buffer_window(jitter_buffer)){
+        num_drop = le_audio_jitter_buffer_window(jitter_buffer);
+    }
+    uint16_t i;
+    for (i = 0; i < num_drop; i++){
+        le_audio_jitter_buffer_slot_t * slot = &jitter_buffer->slots[le_audio_jitter_buffer_slot_index(jitter_buffer, jitter_buffer->next_sequence_number + i)];
+        if (slot->valid){
+            slot->valid = false;
+            jitter_buffer->statistics.sdus_overrun++;
+        }
+    }
+    le_audio_jitter_buffer_advance(jitter_buffer, (uint16_t) (sequence_number + 1u - num_keep - jitter_buffer->next_sequence_number));
+    if (le_audio_jitter_buffer_distance(jitter_buffer->next_sequence_number, jitter_buffer->newest_sequence_number) < 0){
+        jitter_buffer->newest_sequence_number = jitter_buffer->next_sequence_number;
+    }
+}
+
+void le_audio_jitter_buffer_store_sdu(le_audio_jitter_buffer_t * jitter_buffer, uint16_t sequence_number, uint32_t time_stamp,
+                                      uint8_t packet_status_flag, const uint8_t * sdu, uint16_t sdu_len){
+    jitter_buffer->statistics.sdus_received++;
+
+    if (jitter_buffer->receiving == false){
+        jitter_buffer->receiving = true;
+        jitter_buffer->next_sequence_number = sequence_number;
+        jitter_buffer->newest_sequence_number = sequence_number;
+    }
+
+    int16_t distance = le_audio_jitter_buffer_distance(jitter_buffer->next_sequence_number, sequence_number);
+    if (distance < 0){
+        jitter_buffer->statistics.sdus_late++;
+        return;
+    }
+    // while buffering, keep latency. During playback, playback is too slow or there was a gap in the stream
+    uint16_t num_keep = jitter_buffer->playing ? le_audio_jitter_buffer_window(jitter_buffer) : jitter_buffer->latency_sdus;
+    if ((uint16_t) distance >= num_keep){
+        le_audio_jitter_buffer_make_room(jitter_buffer, sequence_number, num_keep);
+    }
+
+    uint16_t index = le_audio_jitter_buffer_slot_index(jitter_buffer, sequence_number);
+    le_audio_jitter_buffer_slot_t * slot = &jitter_buffer->slots[index];
+    if (slot->valid){
+        if (slot->sequence_number == sequence_number){
+            jitter_buffer->statistics.sdus_duplicate++;
+            return;
+        }
+        // stale SDU, not expected as slots are released when passed
+        jitter_buffer->statistics.sdus_overrun++;
+    }
+    if (sdu_len > jitter_buffer->max_sdu_len){
+        log_error("SDU len %u > max %u", sdu_len, jitter_buffer->max_sdu_len);
+        sdu_len = 0;
+    }
+    (void) memcpy(&jitter_buffer->storage[index * jitter_buffer->max_sdu_len], sdu, sdu_len);
+    slot->sequence_number = sequence_number;
+    slot->time_stamp = time_stamp;
+    slot->packet_status_flag = packet_status_flag;
+    slot->len = sdu_len;
+    slot->valid = true;
+
+    if (le_audio_jitter_buffer_distance(jitter_buffer->newest_sequence_number, sequence_number) > 0){
+        jitter_buffer->newest_sequence_number = sequence_number;
+    }
+    if ((jitter_buffer->playing == false) && (le_audio_jitter_buffer_get_num_buffered_sdus(jitter_buffer) >= jitter_buffer->latency_sdus)){
+        log_info("Start playback, SDU %u", jitter_buffer->next_sequence_number);
+        jitter_buffer->playing = true;
+    }
+}
+
+void le_audio_jitter_buffer_store_iso_packet(le_audio_jitter_buffer_t * jitter_buffer, const uint8_t * packet, uint16_t size){
+    if (size < (ISO_DATA_HEADER_LEN + ISO_DATA_LOAD_HEADER_LEN)) return;
+    uint16_t header = little_endian_read_16(packet, 0);
+    bool ts_flag = ((header >> 14) & 1u) != 0u;
+    uint16_t offset = ISO_DATA_HEADER_LEN;
+    uint32_t time_stamp = 0;
+    if (ts_flag){
+        if (size < (ISO_DATA_HEADER_LEN + ISO_DATA_TIME_STAMP_LEN + ISO_DATA_LOAD_HEADER_LEN)) return;
+        time_stamp = little_endian_read_32(packet, offset);
+        offset += ISO_DATA_TIME_STAMP_LEN;
+    }
+    uint16_t sequence_number = little_endian_read_16(packet, offset);
+    uint16_t sdu_header = little_endian_read_16(packet, offset + 2u);
+    offset += ISO_DATA_LOAD_HEADER_LEN;
+    uint16_t sdu_len = sdu_header & 0x0fffu;
+    uint8_t packet_status_flag = (uint8_t) (sdu_header >> 14);
+    if (sdu_len > (size - offset)){
+        log_error("ISO SDU len %u > packet payload %u", sdu_len, size - offset);
+        return;
+    }
+    le_audio_jitter_buffer_store_sdu(jitter_buffer, sequence_number, time_stamp, packet_status_flag, &packet[offset], sdu_len);
+}
+
+bool le_audio_jitter_buffer_get_sdu(le_audio_jitter_buffer_t * jitter_buffer, le_audio_jitter_buffer_sdu_t * sdu){
+    if (jitter_buffer->playing == false){
+        return false;
+    }
+    uint16_t index = le_audio_jitter_buffer_slot_index(jitter_buffer, jitter_buffer->next_sequence_number);
+    le_audio_jitter_buffer_slot_t * slot = &jitter_buffer->slots[index];
+    sdu->sequence_number = jitter_buffer->next_sequence_number;
+    if (slot->valid && (slot->sequence_number != jitter_buffer->next_sequence_number)){
+        // stale SDU
+        slot->valid = false;
+        jitter_buffer->statistics.sdus_overrun++;
+    }
+    if (slot->valid){
+        // slot will not be re-used before next call, see le_audio_jitter_buffer_window
+        slot->valid = false;
+        sdu->data = &jitter_buffer->storage[index * jitter_buffer->max_sdu_len];
+        sdu->len = slot->len;
+        sdu->time_stamp = slot->time_stamp;
+        sdu->bfi = ((slot->packet_status_flag != 0u) || (slot->len == 0u)) ? 1 : 0;
+        jitter_buffer->num_missing_in_a_row = 0;
+    } else {
+        sdu->data = NULL;
+        sdu->len = 0;
+        sdu->time_stamp = 0;
+        sdu->bfi = 1;
+        jitter_buffer->num_missing_in_a_row++;
+    }
+    if (sdu->bfi != 0u){
+        jitter_buffer->statistics.sdus_missing++;
+    }
+    jitter_buffer->statistics.sdus_played++;
+
+    le_audio_jitter_buffer_advance(jitter_buffer, 1);
+    if (le_audio_jitter_buffer_distance(jitter_buffer->next_sequence_number, jitter_buffer->newest_sequence_number) < 0){
+        jitter_buffer->newest_sequence_number = (uint16_t) (jitter_buffer->next_sequence_number - 1u);
+    }
+
+    // stream stopped, wait for new SDUs
+    if (jitter_buffer->num_missing_in_a_row >= jitter_buffer->num_slots){
+        log_info("No SDUs for %u intervals, stop playback", jitter_buffer->num_missing_in_a_row);
+        le_audio_jitter_buffer_reset(jitter_buffer);
+    }
+    return true;
+}
+
+uint16_t le_audio_jitter_buffer_get_num_buffered_sdus(const le_audio_jitter_buffer_t * jitter_buffer){
+    if (jitter_buffer->receiving == false){
+        return 0;
+    }
+    int16_t distance = le_audio_jitter_buffer_distance(jitter_buffer->next_sequence_number, jitter_buffer->newest_sequence_number);
+    if (distance < 0){
+        return 0;
+    }
+    return (uint16_t) (distance + 1);
+}
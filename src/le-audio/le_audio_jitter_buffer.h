@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+/**
+ * @title LE Audio Jitter Buffer
+ *
+ * Receive pipeline for ISO streams of LE Audio sinks. SDUs are stored in preallocated slots indexed
+ * by their packet sequence number. Playback starts with a fixed latency once the configured number of
+ * SDUs has been received. For each SDU interval, the audio callback fetches the next SDU, which is
+ * either the received SDU or a Bad Frame Indication (BFI) if the SDU was not received in time or
+ * was reported as invalid by the Controller.
+ *
+ * Storing and fetching SDUs must happen in the same execution context.
+ */
+
+#ifndef LE_AUDIO_JITTER_BUFFER_H
+#define LE_AUDIO_JITTER_BUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t time_stamp;
+    uint16_t sequence_number;
+    uint16_t len;
+    uint8_t  packet_status_flag;
+    bool     valid;
+} le_audio_jitter_buffer_slot_t;
+
+typedef struct {
+    // SDU data, NULL if not received
+    const uint8_t * data;
+    uint16_t len;
+    uint16_t sequence_number;
+    uint32_t time_stamp;
+    // Bad Frame Indication for LC3 decoder
+    uint8_t  bfi;
+} le_audio_jitter_buffer_sdu_t;
+
+typedef struct {
+    uint32_t sdus_received;
+    uint32_t sdus_played;
+    // played with BFI as not received or not valid
+    uint32_t sdus_missing;
+    // received after playback
+    uint32_t sdus_late;
+    uint32_t sdus_duplicate;
+    // dropped as all slots were in use
+    uint32_t sdus_overrun;
+} le_audio_jitter_buffer_statistics_t;
+
+typedef struct {
+    le_audio_jitter_buffer_slot_t * slots;
+    uint8_t  * storage;
+    uint16_t num_slots;
+    uint16_t max_sdu_len;
+    uint16_t latency_sdus;
+
+    bool     receiving;
+    bool     playing;
+    // sequence number of next SDU to play and of newest received SDU
+    uint16_t next_sequence_number;
+    uint16_t newest_sequence_number;
+    // slot of next SDU to play, slots are indexed relative to it
+    uint16_t next_slot_index;
+    uint16_t num_missing_in_a_row;
+
+    le_audio_jitter_buffer_statistics_t statistics;
+} le_audio_jitter_buffer_t;
+
+/* API_START */
+
+/**
+ * @brief Init jitter buffer
+ * @param jitter_buffer
+ * @param slots array with num_slots entries
+ * @param storage for SDUs, num_slots * max_sdu_len bytes
+ * @param num_slots at least latency_sdus + 2
+ * @param max_sdu_len
+ * @param latency_sdus number of SDU intervals between reception of first SDU and its playback
+ */
+void le_audio_jitter_buffer_init(le_audio_jitter_buffer_t * jitter_buffer, le_audio_jitter_buffer_slot_t * slots, uint8_t * storage,
+                                 uint16_t num_slots, uint16_t max_sdu_len, uint16_t latency_sdus);
+
+/**
+ * @brief Drop all SDUs and wait for new SDUs before playback restarts
+ * @param jitter_buffer
+ */
+void le_audio_jitter_buffer_reset(le_audio_jitter_buffer_t * jitter_buffer);
+
+/**
+ * @brief Store SDU
+ * @param jitter_buffer
+ * @param sequence_number
+ * @param time_stamp
+ * @param packet_status_flag from ISO Data packet, SDUs with packet status flag != 0 are played with BFI
+ * @param sdu
+ * @param sdu_len
+ */
+void le_audio_jitter_buffer_store_sdu(le_audio_jitter_buffer_t * jitter_buffer, uint16_t sequence_number, uint32_t time_stamp,
+                                      uint8_t packet_status_flag, const uint8_t * sdu, uint16_t sdu_len);
+
+/**
+ * @brief Store SDU from complete ISO Data packet as received by HCI_ISO_DATA_PACKET handler
+ * @param jitter_buffer
+ * @param packet
+ * @param size
+ */
+void le_audio_jitter_buffer_store_iso_packet(le_audio_jitter_buffer_t * jitter_buffer, const uint8_t * packet, uint16_t size);
+
+/**
+ * @brief Get next SDU for playback, to be called once per SDU interval after playback has started
+ * @note SDU data stays valid until the next call
+ * @param jitter_buffer
+ * @param sdu
+ * @return false if playback has not started yet
+ */
+bool le_audio_jitter_buffer_get_sdu(le_audio_jitter_buffer_t * jitter_buffer, le_audio_jitter_buffer_sdu_t * sdu);
+
+/**
+ * @brief Get number of SDU intervals buffered, including missing SDUs
+ * @param jitter_buffer
+ * @return num SDU intervals
+ */
+uint16_t le_audio_jitter_buffer_get_num_buffered_sdus(const le_audio_jitter_buffer_t * jitter_buffer);
+
+/* API_END */
+
+#if defined __cplusplus
+}
+#endif
+
+#endif // LE_AUDIO_JITTER_BUFFER_H
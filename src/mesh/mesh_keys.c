@@ -46,12 +46,20 @@
 #include "btstack_memory.h"
 #include "btstack_config.h"
 
+// number of buckets for NID and AID lookup, power of two
+#define MESH_KEYS_NID_BUCKETS  8
+#define MESH_KEYS_AID_BUCKETS 16
+
 // network key list
 static btstack_linked_list_t network_keys;
 static uint8_t mesh_network_key_used[MAX_NR_MESH_NETWORK_KEYS];
 
+// network keys by NID
+static mesh_network_key_t * network_keys_by_nid[MESH_KEYS_NID_BUCKETS];
+
 void mesh_network_key_init(void){
     network_keys = NULL;
+    memset(network_keys_by_nid, 0, sizeof(network_keys_by_nid));
 }
 
 uint16_t mesh_network_key_get_free_index(void){
@@ -66,12 +74,32 @@ uint16_t mesh_network_key_get_free_index(void){
 
 void mesh_network_key_add(mesh_network_key_t * network_key){
     mesh_network_key_used[network_key->internal_index] = 1;
-    btstack_linked_list_add_tail(&network_keys, (btstack_linked_item_t *) network_key);
+    bool added = btstack_linked_list_add_tail(&network_keys, (btstack_linked_item_t *) network_key);
+    if (added == false) return;
+
+    // append to NID bucket to keep order of network key list
+    mesh_network_key_t ** it = &network_keys_by_nid[network_key->nid & (MESH_KEYS_NID_BUCKETS - 1)];
+    while (*it != NULL){
+        it = &(*it)->nid_next;
+    }
+    network_key->nid_next = NULL;
+    *it = network_key;
 }
 
 bool mesh_network_key_remove(mesh_network_key_t * network_key){
     mesh_network_key_used[network_key->internal_index] = 0;
-    return btstack_linked_list_remove(&network_keys, (btstack_linked_item_t *) network_key);
+    bool removed = btstack_linked_list_remove(&network_keys, (btstack_linked_item_t *) network_key);
+    if (removed == false) return false;
+
+    mesh_network_key_t ** it = &network_keys_by_nid[network_key->nid & (MESH_KEYS_NID_BUCKETS - 1)];
+    while (*it != NULL){
+        if (*it == network_key){
+            *it = network_key->nid_next;
+            break;
+        }
+        it = &(*it)->nid_next;
+    }
+    return true;
 }
 
 mesh_network_key_t * mesh_network_key_list_get(uint16_t netkey_index){
@@ -101,10 +129,10 @@ mesh_network_key_t * mesh_network_key_iterator_get_next(mesh_network_key_iterato
     return (mesh_network_key_t *) btstack_linked_list_iterator_next(&it->it);
 }
 
-// mesh network key iterator for a given nid
+// mesh network key iterator for a given nid, only visits keys in NID bucket
 void mesh_network_key_nid_iterator_init(mesh_network_key_iterator_t *it, uint8_t nid){
-    btstack_linked_list_iterator_init(&it->it, &network_keys);
     it->key = NULL;
+    it->next = network_keys_by_nid[nid & (MESH_KEYS_NID_BUCKETS - 1)];
     it->nid = nid;
 }
 
@@ -112,8 +140,9 @@ int mesh_network_key_nid_iterator_has_more(mesh_network_key_iterator_t *it){
     // find next matching key
     while (true){
         if (it->key && it->key->nid == it->nid) return 1;
-        if (!btstack_linked_list_iterator_has_next(&it->it)) break;
-        it->key = (mesh_network_key_t *) btstack_linked_list_iterator_next(&it->it);
+        if (it->next == NULL) break;
+        it->key  = it->next;
+        it->next = it->key->nid_next;
     }
     return 0;
 }
@@ -133,6 +162,9 @@ static btstack_linked_list_t  application_keys;
 
 static uint8_t mesh_transport_key_used[MAX_NR_MESH_TRANSPORT_KEYS];
 
+// application keys by AID
+static mesh_transport_key_t * application_keys_by_aid[MESH_KEYS_AID_BUCKETS];
+
 void mesh_transport_set_device_key(const uint8_t * device_key){
     mesh_transport_device_key.appkey_index = MESH_DEVICE_KEY_INDEX;
     mesh_transport_device_key.aid   = 0;
@@ -158,12 +190,32 @@ uint16_t mesh_transport_key_get_free_index(void){
 
 void mesh_transport_key_add(mesh_transport_key_t * transport_key){
     mesh_transport_key_used[transport_key->internal_index] = 1;
-    btstack_linked_list_add_tail(&application_keys, (btstack_linked_item_t *) transport_key);
+    bool added = btstack_linked_list_add_tail(&application_keys, (btstack_linked_item_t *) transport_key);
+    if (added == false) return;
+
+    // append to AID bucket to keep order of application key list
+    mesh_transport_key_t ** it = &application_keys_by_aid[transport_key->aid & (MESH_KEYS_AID_BUCKETS - 1)];
+    while (*it != NULL){
+        it = &(*it)->aid_next;
+    }
+    transport_key->aid_next = NULL;
+    *it = transport_key;
 }
 
 bool mesh_transport_key_remove(mesh_transport_key_t * transport_key){
     mesh_transport_key_used[transport_key->internal_index] = 0;
-    return btstack_linked_list_remove(&application_keys, (btstack_linked_item_t *) transport_key);
+    bool removed = btstack_linked_list_remove(&application_keys, (btstack_linked_item_t *) transport_key);
+    if (removed == false) return false;
+
+    mesh_transport_key_t ** it = &application_keys_by_aid[transport_key->aid & (MESH_KEYS_AID_BUCKETS - 1)];
+    while (*it != NULL){
+        if (*it == transport_key){
+            *it = transport_key->aid_next;
+            break;
+        }
+        it = &(*it)->aid_next;
+    }
+    return true;
 }
 
 mesh_transport_key_t * mesh_transport_key_get(uint16_t appkey_index){
@@ -202,16 +254,18 @@ mesh_transport_key_t * mesh_transport_key_iterator_get_next(mesh_transport_key_i
     return key;
 }
 
+// transport key iterator for a given aid, only visits keys in AID bucket
 void
 mesh_transport_key_aid_iterator_init(mesh_transport_key_iterator_t *it, uint16_t netkey_index, uint8_t akf, uint8_t aid) {
-    btstack_linked_list_iterator_init(&it->it, &application_keys);
     it->netkey_index = netkey_index;
     it->aid      = aid;
     it->akf      = akf;
     if (it->akf){
-        it->key = NULL;
+        it->key  = NULL;
+        it->next = application_keys_by_aid[aid & (MESH_KEYS_AID_BUCKETS - 1)];
     } else {
-        it->key = &mesh_transport_device_key;
+        it->key  = &mesh_transport_device_key;
+        it->next = NULL;
     }
 }
 
@@ -222,8 +276,9 @@ int mesh_transport_key_aid_iterator_has_more(mesh_transport_key_iterator_t *it){
     // find next matching key
     while (true){
         if (it->key && it->key->aid == it->aid && it->key->netkey_index == it->netkey_index) return 1;
-        if (!btstack_linked_list_iterator_has_next(&it->it)) break;
-        it->key = (mesh_transport_key_t *) btstack_linked_list_iterator_next(&it->it);
+        if (it->next == NULL) break;
+        it->key  = it->next;
+        it->next = it->key->aid_next;
     }
     return 0;
 }
@@ -51,9 +51,12 @@ extern "C"
 
 #define MESH_KEYS_INVALID_INDEX 0xffff
 
-typedef struct {
+typedef struct mesh_network_key {
     btstack_linked_item_t item;
 
+    // next network key with same NID bucket
+    struct mesh_network_key * nid_next;
+
     // internal index [0..MAX_NR_MESH_NETWORK_KEYS-1]
     uint16_t internal_index;
 
@@ -85,12 +88,16 @@ typedef struct {
 typedef struct {
     btstack_linked_list_iterator_t it;
     mesh_network_key_t * key;
+    mesh_network_key_t * next;
     uint8_t nid;
 } mesh_network_key_iterator_t;
 
-typedef struct {
+typedef struct mesh_transport_key {
     btstack_linked_item_t item;
 
+    // next transport key with same AID bucket
+    struct mesh_transport_key * aid_next;
+
     // internal index [0..MAX_NR_MESH_TRANSPORT_KEYS-1]
     uint16_t internal_index;
 
@@ -123,6 +130,7 @@ typedef struct {
 typedef struct {
     btstack_linked_list_iterator_t it;
     mesh_transport_key_t * key;
+    mesh_transport_key_t * next;
     uint16_t netkey_index;
     uint8_t  akf;
     uint8_t  aid;
@@ -392,27 +392,10 @@ static void mesh_lower_transport_incoming_process_segment(mesh_segmented_pdu_t *
     // mark as received
     message_pdu->block_ack |= (1<<seg_o);
 
-    // store segment
+    // store segment in reassembly buffer and release network pdu right away
     uint8_t max_segment_len = mesh_network_control(network_pdu) ? 8 : 12;
-    mesh_network_pdu_t * latest_segment = (mesh_network_pdu_t *) btstack_linked_list_get_first_item(&message_pdu->segments);
-    if ((latest_segment != NULL) && ((MESH_NETWORK_PAYLOAD_MAX - latest_segment->len) > (max_segment_len  + 1))){
-        // store in last added segment if there is enough space available
-        latest_segment->data[latest_segment->len++] = seg_o;
-        (void) memcpy(&latest_segment->data[latest_segment->len], &lower_transport_pdu[4], segment_len);
-        latest_segment->len += segment_len;
-        // free buffer
-        mesh_network_message_processed_by_higher_layer(network_pdu);
-    } else {
-        // move to beginning
-        network_pdu->data[0] = seg_o;
-        uint8_t i;
-        for (i=0;i<segment_len;i++){
-            network_pdu->data[1+i] = network_pdu->data[13+i];
-        }
-        network_pdu->len = 1 + segment_len;
-        // add this buffer
-        btstack_linked_list_add(&message_pdu->segments, (btstack_linked_item_t *) network_pdu);
-    }
+    (void) memcpy(&message_pdu->data[seg_o * max_segment_len], segment_data, segment_len);
+    mesh_network_message_processed_by_higher_layer(network_pdu);
 
     // last segment -> store len
     if (seg_o == seg_n){
@@ -872,22 +855,32 @@ static void mesh_lower_transport_process_network_pdu(mesh_network_pdu_t *network
     }
 }
 
+static uint32_t mesh_lower_transport_iv_index_for_ivi_nid(uint8_t ivi_nid){
+    // get IV Index and IVI
+    uint32_t iv_index = mesh_get_iv_index();
+    int ivi = ivi_nid >> 7;
+
+    // if least significant bit differs, use previous IV Index
+    if ((iv_index & 1 ) ^ ivi){
+        iv_index--;
+    }
+    return iv_index;
+}
+
 void mesh_lower_transport_received_message(mesh_network_callback_type_t callback_type, mesh_network_pdu_t *network_pdu){
     mesh_peer_t * peer;
     uint16_t src;
-    uint16_t seq;
+    uint32_t seq;
     switch (callback_type){
         case MESH_NETWORK_PDU_RECEIVED:
             src = mesh_network_src(network_pdu);
             seq = mesh_network_seq(network_pdu);
             peer = mesh_peer_for_addr(src);
 #ifdef LOG_LOWER_TRANSPORT
-            printf("Transport: received message. SRC %x, SEQ %x\n", src, seq);
+            printf("Transport: received message. SRC %x, SEQ %x\n", src, (int) seq);
 #endif
-            // validate seq
-            if (peer && seq > peer->seq){
-                // track seq
-                peer->seq = seq;
+            // validate seq against replay protection list
+            if (peer && mesh_peer_replay_protection_check(peer, mesh_lower_transport_iv_index_for_ivi_nid(network_pdu->data[0]), seq)){
                 // process
                 mesh_lower_transport_process_network_pdu(network_pdu);
                 mesh_lower_transport_run();
@@ -1027,6 +1020,8 @@ void mesh_lower_transport_reset(void){
 }
 
 void mesh_lower_transport_init(){
+    // clear peer info
+    mesh_seq_auth_reset();
     // register with network layer
     mesh_network_set_higher_layer_handler(&mesh_lower_transport_received_message);
     // allocate network_pdu for segmentation
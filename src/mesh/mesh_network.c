@@ -66,6 +66,11 @@
 // configuration
 #define MESH_NETWORK_CACHE_SIZE 2
 
+// max number of incoming and outgoing network pdus in validation/encryption each
+#ifndef MESH_NETWORK_PDUS_IN_FLIGHT
+#define MESH_NETWORK_PDUS_IN_FLIGHT 4
+#endif
+
 // debug config
 #define LOG_NETWORK
 
@@ -82,44 +87,56 @@ static void (*mesh_network_proxy_message_handler)(mesh_network_callback_type_t c
 static hci_con_handle_t gatt_bearer_con_handle;
 #endif
 
-// shared send/receive crypto
-static int mesh_crypto_active;
+// crypto context for a network pdu in validation or encryption
+typedef struct {
+    btstack_linked_item_t item;
+
+    // crypto requests
+    union {
+        btstack_crypto_ccm_t         ccm;
+        btstack_crypto_aes128_t      aes128;
+    } crypto_request;
+
+    const mesh_network_key_t * network_key;
 
-// crypto requests
-static union {
-    btstack_crypto_ccm_t         ccm;
-    btstack_crypto_aes128_t      aes128;
-} mesh_network_crypto_request;
+    // PECB calculation
+    uint8_t encryption_block[16];
+    uint8_t obfuscation_block[16];
 
-static const mesh_network_key_t *  current_network_key;
+    // Network Nonce
+    uint8_t network_nonce[13];
 
-// PECB calculation 
-static uint8_t encryption_block[16];
-static uint8_t obfuscation_block[16];
+    // incoming: raw pdu and decoded pdu, NULL if dropped
+    // outgoing: pdu to encrypt
+    mesh_network_pdu_t * pdu;
+    mesh_network_pdu_t * pdu_decoded;
+    mesh_network_key_iterator_t network_key_it;
+
+    // crypto operations complete, result can be forwarded in order
+    bool done;
+} mesh_network_crypto_context_t;
+
+static mesh_network_crypto_context_t mesh_network_incoming_contexts[MESH_NETWORK_PDUS_IN_FLIGHT];
+static mesh_network_crypto_context_t mesh_network_outgoing_contexts[MESH_NETWORK_PDUS_IN_FLIGHT];
 
 // Subnets
 static btstack_linked_list_t subnets;
 
-// Network Nonce
-static uint8_t network_nonce[13];
-
 // INCOMING //
 
 // unprocessed network pdu - added by mesh_network_pdus_received_message
 static btstack_linked_list_t        network_pdus_received;
 
-// in validation
-static mesh_network_pdu_t *         incoming_pdu_raw;
-static mesh_network_pdu_t *         incoming_pdu_decoded;
-static mesh_network_key_iterator_t  validation_network_key_it;
+// crypto contexts in validation, in order of reception
+static btstack_linked_list_t        network_pdus_in_validation;
 
 // OUTGOING //
 
 // Network PDUs queued by mesh_network_send
 static btstack_linked_list_t network_pdus_queued;
 
-// Network PDU about to get send via all bearers when encrypted
-static mesh_network_pdu_t * outgoing_pdu;
+// crypto contexts in encryption, in order of mesh_network_send
+static btstack_linked_list_t network_pdus_in_encryption;
 
 // Network PDUs ready to send via GATT Bearer
 static btstack_linked_list_t network_pdus_outgoing_gatt;
@@ -136,6 +153,9 @@ static mesh_network_pdu_t * adv_bearer_network_pdu;
 #endif
 
 
+// network keys tried for received network pdus
+static uint32_t mesh_network_trial_decryptions;
+
 // mesh network cache - we use 32-bit 'hashes'
 static uint32_t mesh_network_cache[MESH_NETWORK_CACHE_SIZE];
 static int      mesh_network_cache_index;
@@ -146,7 +166,6 @@ void (*mesh_network_free_pdu_callback)(void);
 // prototypes
 
 static void mesh_network_run(void);
-static void process_network_pdu_validate(void);
 
 // network caching
 static uint32_t mesh_network_cache_hash(mesh_network_pdu_t * network_pdu){
@@ -276,27 +295,28 @@ static void mesh_network_send_complete(mesh_network_pdu_t * network_pdu){
     }
 }
 
-// new
-static void mesh_network_send_c(void *arg){
-    UNUSED(arg);
-
-    // obfuscate
+static mesh_network_crypto_context_t * mesh_network_crypto_context_get(mesh_network_crypto_context_t * contexts, btstack_linked_list_t * in_flight){
     unsigned int i;
-    for (i=0;i<6;i++){
-        outgoing_pdu->data[1+i] ^= obfuscation_block[i];
+    for (i=0;i<MESH_NETWORK_PDUS_IN_FLIGHT;i++){
+        mesh_network_crypto_context_t * context = &contexts[i];
+        if (context->pdu == NULL){
+            memset(context, 0, sizeof(mesh_network_crypto_context_t));
+            btstack_linked_list_add_tail(in_flight, (btstack_linked_item_t *) context);
+            return context;
+        }
     }
+    return NULL;
+}
 
-#ifdef LOG_NETWORK
-    printf("TX-C-NetworkPDU (%p): ", outgoing_pdu);
-    printf_hexdump(outgoing_pdu->data, outgoing_pdu->len);
-#endif
-
-    // crypto done
-    mesh_crypto_active = 0;
+static void mesh_network_send_d(mesh_network_crypto_context_t * context){
+    mesh_network_pdu_t * network_pdu = context->pdu;
+    context->pdu = NULL;
 
-    // done
-    mesh_network_pdu_t * network_pdu = outgoing_pdu;
-    outgoing_pdu = NULL;
+    if (context->network_key == NULL){
+        // no subnet, notify upper layer
+        mesh_network_send_complete(network_pdu);
+        return;
+    }
 
     if ((network_pdu->flags & MESH_NETWORK_PDU_FLAGS_PROXY_CONFIGURATION) != 0){
         // encryption requested by mesh_network_encrypt_proxy_configuration_message
@@ -311,19 +331,39 @@ static void mesh_network_send_c(void *arg){
 
     // add to queue
     btstack_linked_list_add_tail(&network_pdus_outgoing_gatt, (btstack_linked_item_t *) network_pdu);
+}
+
+static void mesh_network_send_c(void *arg){
+    mesh_network_crypto_context_t * context = (mesh_network_crypto_context_t *) arg;
+    mesh_network_pdu_t * outgoing_pdu = context->pdu;
+
+    // obfuscate
+    unsigned int i;
+    for (i=0;i<6;i++){
+        outgoing_pdu->data[1+i] ^= context->obfuscation_block[i];
+    }
+
+#ifdef LOG_NETWORK
+    printf("TX-C-NetworkPDU (%p): ", outgoing_pdu);
+    printf_hexdump(outgoing_pdu->data, outgoing_pdu->len);
+#endif
+
+    // crypto done, forwarded in order by mesh_network_run
+    context->done = true;
 
     // go
     mesh_network_run();
 }
 
 static void mesh_network_send_b(void *arg){
-    UNUSED(arg);
+    mesh_network_crypto_context_t * context = (mesh_network_crypto_context_t *) arg;
+    mesh_network_pdu_t * outgoing_pdu = context->pdu;
 
     uint32_t iv_index = mesh_get_iv_index_for_tx();
 
     // store NetMIC
     uint8_t net_mic[8];
-    btstack_crypto_ccm_get_authentication_value(&mesh_network_crypto_request.ccm, net_mic);
+    btstack_crypto_ccm_get_authentication_value(&context->crypto_request.ccm, net_mic);
 
     // store MIC
     uint8_t net_mic_len = outgoing_pdu->data[1] & 0x80 ? 8 : 4;
@@ -338,33 +378,27 @@ static void mesh_network_send_b(void *arg){
 #endif
 
     // calc PECB
-    memset(encryption_block, 0, 5);
-    big_endian_store_32(encryption_block, 5, iv_index);
-    (void)memcpy(&encryption_block[9], &outgoing_pdu->data[7], 7);
-    btstack_crypto_aes128_encrypt(&mesh_network_crypto_request.aes128, current_network_key->privacy_key, encryption_block, obfuscation_block, &mesh_network_send_c, NULL);
+    memset(context->encryption_block, 0, 5);
+    big_endian_store_32(context->encryption_block, 5, iv_index);
+    (void)memcpy(&context->encryption_block[9], &outgoing_pdu->data[7], 7);
+    btstack_crypto_aes128_encrypt(&context->crypto_request.aes128, context->network_key->privacy_key, context->encryption_block, context->obfuscation_block, &mesh_network_send_c, context);
 }
 
-static void mesh_network_send_a(void){
-
-    mesh_crypto_active = 1;
+static void mesh_network_send_a(mesh_network_crypto_context_t * context){
+    mesh_network_pdu_t * outgoing_pdu = context->pdu;
 
     uint32_t iv_index = mesh_get_iv_index_for_tx();
 
     // lookup subnet by netkey_index
     mesh_subnet_t * subnet = mesh_subnet_get_by_netkey_index(outgoing_pdu->netkey_index);
     if (!subnet) {
-        mesh_crypto_active = 0;
-        mesh_network_pdu_t * network_pdu = outgoing_pdu;
-        outgoing_pdu = NULL;
-        // notify upper layer
-        mesh_network_send_complete(network_pdu);
-        // run again
-        mesh_network_run();
+        // forward in order without network key
+        context->done = true;
         return;
     }
 
     // get network key to use for sending
-    current_network_key = mesh_subnet_get_outgoing_network_key(subnet);
+    context->network_key = mesh_subnet_get_outgoing_network_key(subnet);
 
 #ifdef LOG_NETWORK
     printf("TX-A-NetworkPDU (%p): ", outgoing_pdu);
@@ -373,29 +407,29 @@ static void mesh_network_send_a(void){
 
     // get network nonce
     if (outgoing_pdu->flags & MESH_NETWORK_PDU_FLAGS_PROXY_CONFIGURATION){
-        mesh_proxy_create_nonce(network_nonce, outgoing_pdu, iv_index); 
+        mesh_proxy_create_nonce(context->network_nonce, outgoing_pdu, iv_index);
 #ifdef LOG_NETWORK
         printf("TX-ProxyNonce:  ");
-        printf_hexdump(network_nonce, 13);
+        printf_hexdump(context->network_nonce, 13);
 #endif
     } else {
-        mesh_network_create_nonce(network_nonce, outgoing_pdu, iv_index); 
+        mesh_network_create_nonce(context->network_nonce, outgoing_pdu, iv_index);
 #ifdef LOG_NETWORK
         printf("TX-NetworkNonce:  ");
-        printf_hexdump(network_nonce, 13);
+        printf_hexdump(context->network_nonce, 13);
 #endif
     }
 
 #ifdef LOG_NETWORK
    printf("TX-EncryptionKey: ");
-    printf_hexdump(current_network_key->encryption_key, 16);
+    printf_hexdump(context->network_key->encryption_key, 16);
 #endif
 
     // start ccm
     uint8_t cypher_len  = outgoing_pdu->len - 7;
     uint8_t net_mic_len = outgoing_pdu->data[1] & 0x80 ? 8 : 4;
-    btstack_crypto_ccm_init(&mesh_network_crypto_request.ccm, current_network_key->encryption_key, network_nonce, cypher_len, 0, net_mic_len);
-    btstack_crypto_ccm_encrypt_block(&mesh_network_crypto_request.ccm, cypher_len, &outgoing_pdu->data[7], &outgoing_pdu->data[7], &mesh_network_send_b, NULL);
+    btstack_crypto_ccm_init(&context->crypto_request.ccm, context->network_key->encryption_key, context->network_nonce, cypher_len, 0, net_mic_len);
+    btstack_crypto_ccm_encrypt_block(&context->crypto_request.ccm, cypher_len, &outgoing_pdu->data[7], &outgoing_pdu->data[7], &mesh_network_send_b, context);
 }
 
 #if defined(ENABLE_MESH_RELAY) || defined (ENABLE_MESH_PROXY_SERVER)
@@ -479,17 +513,64 @@ void mesh_network_message_processed_by_higher_layer(mesh_network_pdu_t * network
     btstack_memory_mesh_network_pdu_free(network_pdu);
 }
 
-static void process_network_pdu_done(void){
-    btstack_memory_mesh_network_pdu_free(incoming_pdu_raw);
-    incoming_pdu_raw = NULL;
-    mesh_crypto_active = 0;
+static void process_network_pdu_done(mesh_network_crypto_context_t * context){
+    // crypto done, forwarded in order by mesh_network_run
+    context->done = true;
 
     mesh_network_run();
 }
 
+static void process_network_pdu_drop(mesh_network_crypto_context_t * context){
+    btstack_memory_mesh_network_pdu_free(context->pdu_decoded);
+    context->pdu_decoded = NULL;
+    process_network_pdu_done(context);
+}
+
+static void process_network_pdu_forward(mesh_network_crypto_context_t * context){
+    btstack_memory_mesh_network_pdu_free(context->pdu);
+    context->pdu = NULL;
+
+    mesh_network_pdu_t * decoded_pdu = context->pdu_decoded;
+    context->pdu_decoded = NULL;
+    if (decoded_pdu == NULL) return;
+
+    if (decoded_pdu->flags & MESH_NETWORK_PDU_FLAGS_PROXY_CONFIGURATION){
+        // no additional checks for proxy messages
+        (*mesh_network_proxy_message_handler)(MESH_NETWORK_PDU_RECEIVED, decoded_pdu);
+        return;
+    }
+
+    // check cache
+    uint32_t hash = mesh_network_cache_hash(decoded_pdu);
+#ifdef LOG_NETWORK
+    printf("RX-Hash (%p): %08" PRIx32 "\n", decoded_pdu, hash);
+#endif
+    if (mesh_network_cache_find(hash)){
+        // found in cache, drop
+#ifdef LOG_NETWORK
+        printf("Found in cache -> drop packet (%p)\n", decoded_pdu);
+#endif
+        btstack_memory_mesh_network_pdu_free(decoded_pdu);
+        return;
+    }
+
+    // store in network cache
+    mesh_network_cache_add(hash);
+
+#ifdef LOG_NETWORK
+    printf("RX-Validated (%p) - forward to lower transport\n", decoded_pdu);
+#endif
+
+    // forward to lower transport layer. message is freed by call to mesh_network_message_processed_by_upper_layer
+    (*mesh_network_higher_layer_handler)(MESH_NETWORK_PDU_RECEIVED, decoded_pdu);
+}
+
+static void process_network_pdu_validate(mesh_network_crypto_context_t * context);
+
 static void process_network_pdu_validate_d(void * arg){
-    UNUSED(arg);
-    // mesh_network_pdu_t * network_pdu = (mesh_network_pdu_t *) arg;
+    mesh_network_crypto_context_t * context = (mesh_network_crypto_context_t *) arg;
+    mesh_network_pdu_t * incoming_pdu_raw     = context->pdu;
+    mesh_network_pdu_t * incoming_pdu_decoded = context->pdu_decoded;
 
     uint8_t ctl_ttl     = incoming_pdu_decoded->data[1];
     uint8_t ctl         = ctl_ttl >> 7;
@@ -497,7 +578,7 @@ static void process_network_pdu_validate_d(void * arg){
 
     // store NetMIC
     uint8_t net_mic[8];
-    btstack_crypto_ccm_get_authentication_value(&mesh_network_crypto_request.ccm, net_mic);
+    btstack_crypto_ccm_get_authentication_value(&context->crypto_request.ccm, net_mic);
 #ifdef LOG_NETWORK
     printf("RX-NetMIC (%p): ", incoming_pdu_decoded); 
     printf_hexdump(net_mic, net_mic_len);
@@ -519,7 +600,7 @@ static void process_network_pdu_validate_d(void * arg){
     if (memcmp(net_mic, &incoming_pdu_raw->data[incoming_pdu_decoded->len-net_mic_len], net_mic_len) != 0){
         // fail
         printf("RX-NetMIC mismatch, try next key (%p)\n", incoming_pdu_decoded);
-        process_network_pdu_validate();
+        process_network_pdu_validate(context);
         return;
     }    
 
@@ -533,17 +614,9 @@ static void process_network_pdu_validate_d(void * arg){
 #endif
 
     // set netkey_index
-    incoming_pdu_decoded->netkey_index = current_network_key->netkey_index;
-
-    if (incoming_pdu_decoded->flags & MESH_NETWORK_PDU_FLAGS_PROXY_CONFIGURATION){
+    incoming_pdu_decoded->netkey_index = context->network_key->netkey_index;
 
-        mesh_network_pdu_t * decoded_pdu = incoming_pdu_decoded;
-        incoming_pdu_decoded = NULL;
-
-        // no additional checks for proxy messages
-        (*mesh_network_proxy_message_handler)(MESH_NETWORK_PDU_RECEIVED, decoded_pdu);
- 
-    } else {
+    if ((incoming_pdu_decoded->flags & MESH_NETWORK_PDU_FLAGS_PROXY_CONFIGURATION) == 0){
 
         // validate src/dest addresses
         uint16_t src = big_endian_read_16(incoming_pdu_decoded->data, 5);
@@ -553,43 +626,13 @@ static void process_network_pdu_validate_d(void * arg){
 #ifdef LOG_NETWORK
             printf("RX Address invalid (%p)\n", incoming_pdu_decoded);
 #endif
-            btstack_memory_mesh_network_pdu_free(incoming_pdu_decoded);
-            incoming_pdu_decoded = NULL;
-            process_network_pdu_done();
+            process_network_pdu_drop(context);
             return;
         }
-
-        // check cache
-        uint32_t hash = mesh_network_cache_hash(incoming_pdu_decoded);
-#ifdef LOG_NETWORK
-        printf("RX-Hash (%p): %08" PRIx32 "\n", incoming_pdu_decoded, hash);
-#endif
-        if (mesh_network_cache_find(hash)){
-            // found in cache, drop
-#ifdef LOG_NETWORK
-            printf("Found in cache -> drop packet (%p)\n", incoming_pdu_decoded);
-#endif
-            btstack_memory_mesh_network_pdu_free(incoming_pdu_decoded);
-            incoming_pdu_decoded = NULL;
-            process_network_pdu_done();
-            return;
-        }
-
-        // store in network cache
-        mesh_network_cache_add(hash);
-
-#ifdef LOG_NETWORK
-            printf("RX-Validated (%p) - forward to lower transport\n", incoming_pdu_decoded);
-#endif
-
-        // forward to lower transport layer. message is freed by call to mesh_network_message_processed_by_upper_layer
-        mesh_network_pdu_t * decoded_pdu = incoming_pdu_decoded;
-        incoming_pdu_decoded = NULL;
-        (*mesh_network_higher_layer_handler)(MESH_NETWORK_PDU_RECEIVED, decoded_pdu);
     }
 
     // done
-    process_network_pdu_done();
+    process_network_pdu_done(context);
 }
 
 static uint32_t iv_index_for_pdu(const mesh_network_pdu_t * network_pdu){
@@ -608,34 +651,36 @@ static uint32_t iv_index_for_pdu(const mesh_network_pdu_t * network_pdu){
 }
 
 static void process_network_pdu_validate_b(void * arg){
-    UNUSED(arg);
+    mesh_network_crypto_context_t * context = (mesh_network_crypto_context_t *) arg;
+    mesh_network_pdu_t * incoming_pdu_raw     = context->pdu;
+    mesh_network_pdu_t * incoming_pdu_decoded = context->pdu_decoded;
 
 #ifdef LOG_NETWORK
     printf("RX-PECB: ");
-    printf_hexdump(obfuscation_block, 6);
+    printf_hexdump(context->obfuscation_block, 6);
 #endif
 
     // de-obfuscate
     unsigned int i;
     for (i=0;i<6;i++){
-        incoming_pdu_decoded->data[1+i] = incoming_pdu_raw->data[1+i] ^ obfuscation_block[i];
+        incoming_pdu_decoded->data[1+i] = incoming_pdu_raw->data[1+i] ^ context->obfuscation_block[i];
     }
 
     uint32_t iv_index = iv_index_for_pdu(incoming_pdu_raw);
 
     if (incoming_pdu_decoded->flags & MESH_NETWORK_PDU_FLAGS_PROXY_CONFIGURATION){
         // create network nonce
-        mesh_proxy_create_nonce(network_nonce, incoming_pdu_decoded, iv_index);
+        mesh_proxy_create_nonce(context->network_nonce, incoming_pdu_decoded, iv_index);
 #ifdef LOG_NETWORK
         printf("RX-Proxy Nonce: ");
-        printf_hexdump(network_nonce, 13);
+        printf_hexdump(context->network_nonce, 13);
 #endif
     } else {
         // create network nonce
-        mesh_network_create_nonce(network_nonce, incoming_pdu_decoded, iv_index);
+        mesh_network_create_nonce(context->network_nonce, incoming_pdu_decoded, iv_index);
 #ifdef LOG_NETWORK
         printf("RX-Network Nonce: ");
-        printf_hexdump(network_nonce, 13);
+        printf_hexdump(context->network_nonce, 13);
 #endif
     }
 
@@ -648,35 +693,38 @@ static void process_network_pdu_validate_b(void * arg){
     printf("RX-Cyper len %u, mic len %u\n", cypher_len, net_mic_len);
 
     printf("RX-Encryption Key: ");
-    printf_hexdump(current_network_key->encryption_key, 16);
+    printf_hexdump(context->network_key->encryption_key, 16);
 
 #endif
 
-    btstack_crypto_ccm_init(&mesh_network_crypto_request.ccm, current_network_key->encryption_key, network_nonce, cypher_len, 0, net_mic_len);
-    btstack_crypto_ccm_decrypt_block(&mesh_network_crypto_request.ccm, cypher_len, &incoming_pdu_raw->data[7], &incoming_pdu_decoded->data[7], &process_network_pdu_validate_d, incoming_pdu_decoded);
+    btstack_crypto_ccm_init(&context->crypto_request.ccm, context->network_key->encryption_key, context->network_nonce, cypher_len, 0, net_mic_len);
+    btstack_crypto_ccm_decrypt_block(&context->crypto_request.ccm, cypher_len, &incoming_pdu_raw->data[7], &incoming_pdu_decoded->data[7], &process_network_pdu_validate_d, context);
 }
 
-static void process_network_pdu_validate(void){
-    if (!mesh_network_key_nid_iterator_has_more(&validation_network_key_it)){
+static void process_network_pdu_validate(mesh_network_crypto_context_t * context){
+    if (!mesh_network_key_nid_iterator_has_more(&context->network_key_it)){
         printf("No valid network key found\n");
-        btstack_memory_mesh_network_pdu_free(incoming_pdu_decoded);
-        incoming_pdu_decoded = NULL;
-        process_network_pdu_done();
+        process_network_pdu_drop(context);
         return;
     }
 
-    current_network_key = mesh_network_key_nid_iterator_get_next(&validation_network_key_it);
+    context->network_key = mesh_network_key_nid_iterator_get_next(&context->network_key_it);
+    mesh_network_trial_decryptions++;
 
     // calc PECB
+    mesh_network_pdu_t * incoming_pdu_raw = context->pdu;
     uint32_t iv_index = iv_index_for_pdu(incoming_pdu_raw);
-    memset(encryption_block, 0, 5);
-    big_endian_store_32(encryption_block, 5, iv_index);
-    (void)memcpy(&encryption_block[9], &incoming_pdu_raw->data[7], 7);
-    btstack_crypto_aes128_encrypt(&mesh_network_crypto_request.aes128, current_network_key->privacy_key, encryption_block, obfuscation_block, &process_network_pdu_validate_b, NULL);
+    memset(context->encryption_block, 0, 5);
+    big_endian_store_32(context->encryption_block, 5, iv_index);
+    (void)memcpy(&context->encryption_block[9], &incoming_pdu_raw->data[7], 7);
+    btstack_crypto_aes128_encrypt(&context->crypto_request.aes128, context->network_key->privacy_key, context->encryption_block, context->obfuscation_block, &process_network_pdu_validate_b, context);
 }
 
 
-static void process_network_pdu(void){
+static void process_network_pdu(mesh_network_crypto_context_t * context){
+    mesh_network_pdu_t * incoming_pdu_raw     = context->pdu;
+    mesh_network_pdu_t * incoming_pdu_decoded = context->pdu_decoded;
+
     //
     uint8_t nid_ivi = incoming_pdu_raw->data[0];
 
@@ -688,9 +736,9 @@ static void process_network_pdu(void){
     // init provisioning data iterator
     uint8_t nid = nid_ivi & 0x7f;
     // uint8_t iv_index = network_pdu_data[0] >> 7;
-    mesh_network_key_nid_iterator_init(&validation_network_key_it, nid);
+    mesh_network_key_nid_iterator_init(&context->network_key_it, nid);
 
-    process_network_pdu_validate();
+    process_network_pdu_validate(context);
 }
 
 // returns true if done
@@ -796,43 +844,62 @@ static bool mesh_network_run_adv(void){
 
 // returns true if done
 static bool mesh_network_run_received(void){
-    if (mesh_crypto_active) {
-        return true;
+    // forward validated pdus in order of reception
+    mesh_network_crypto_context_t * context = (mesh_network_crypto_context_t *) btstack_linked_list_get_first_item(&network_pdus_in_validation);
+    if ((context != NULL) && context->done){
+        btstack_linked_list_pop(&network_pdus_in_validation);
+        process_network_pdu_forward(context);
+        return false;
     }
 
     if (btstack_linked_list_empty(&network_pdus_received)) {
         return true;
     }
 
-    incoming_pdu_decoded = mesh_network_pdu_get();
+    mesh_network_pdu_t * incoming_pdu_decoded = mesh_network_pdu_get();
     if (incoming_pdu_decoded == NULL) return true;
 
+    context = mesh_network_crypto_context_get(mesh_network_incoming_contexts, &network_pdus_in_validation);
+    if (context == NULL){
+        btstack_memory_mesh_network_pdu_free(incoming_pdu_decoded);
+        return true;
+    }
+
     // get encoded network pdu and start processing
-    mesh_crypto_active = 1;
-    incoming_pdu_raw = (mesh_network_pdu_t *) btstack_linked_list_pop(&network_pdus_received);
-    process_network_pdu();
-    return true;
+    context->pdu = (mesh_network_pdu_t *) btstack_linked_list_pop(&network_pdus_received);
+    context->pdu_decoded = incoming_pdu_decoded;
+    process_network_pdu(context);
+    return false;
 }
 
 // returns true if done
 static bool mesh_network_run_queued(void){
-    if (mesh_crypto_active) {
-        return true;
+    // forward encrypted pdus in order of mesh_network_send
+    mesh_network_crypto_context_t * context = (mesh_network_crypto_context_t *) btstack_linked_list_get_first_item(&network_pdus_in_encryption);
+    if ((context != NULL) && context->done){
+        btstack_linked_list_pop(&network_pdus_in_encryption);
+        mesh_network_send_d(context);
+        return false;
     }
 
     if (btstack_linked_list_empty(&network_pdus_queued)){
         return true;
     }
-    
+
+    context = mesh_network_crypto_context_get(mesh_network_outgoing_contexts, &network_pdus_in_encryption);
+    if (context == NULL){
+        return true;
+    }
+
     // get queued network pdu and start processing
-    outgoing_pdu = (mesh_network_pdu_t *) btstack_linked_list_pop(&network_pdus_queued);
+    context->pdu = (mesh_network_pdu_t *) btstack_linked_list_pop(&network_pdus_queued);
 
 #ifdef LOG_NETWORK
-    printf("network run 5: pop %p from network_pdus_queued\n", outgoing_pdu);
+    printf("network run 5: pop %p from network_pdus_queued\n", context->pdu);
     mesh_network_dump_network_pdus("network_pdus_queued (2)", &network_pdus_queued);
 #endif
-    mesh_network_send_a();
-    return true;
+    mesh_network_send_a(context);
+    return false;
 }
 
 static void mesh_network_run(void){
@@ -997,6 +1064,10 @@ static void mesh_netework_gatt_bearer_handle_proxy_configuration(uint8_t packet_
 }
 #endif
 
+uint32_t mesh_network_get_trial_decryptions(void){
+    return mesh_network_trial_decryptions;
+}
+
 void mesh_network_init(void){
 #ifdef ENABLE_MESH_ADV_BEARER
     adv_bearer_register_for_network_pdu(&mesh_adv_bearer_handle_network_event);
@@ -1201,10 +1272,19 @@ void mesh_network_dump(void){
     mesh_network_dump_network_pdus("network_pdus_queued", &network_pdus_queued);
     mesh_network_dump_network_pdus("network_pdus_outgoing_gatt", &network_pdus_outgoing_gatt);
     mesh_network_dump_network_pdus("network_pdus_outgoing_adv", &network_pdus_outgoing_adv);
-    printf("outgoing_pdu: \n");
-    mesh_network_dump_network_pdu(outgoing_pdu);
-    printf("incoming_pdu_raw: \n");
-    mesh_network_dump_network_pdu(incoming_pdu_raw);
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &network_pdus_in_encryption);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        mesh_network_crypto_context_t * context = (mesh_network_crypto_context_t *) btstack_linked_list_iterator_next(&it);
+        printf("outgoing_pdu (done %u): \n", context->done);
+        mesh_network_dump_network_pdu(context->pdu);
+    }
+    btstack_linked_list_iterator_init(&it, &network_pdus_in_validation);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        mesh_network_crypto_context_t * context = (mesh_network_crypto_context_t *) btstack_linked_list_iterator_next(&it);
+        printf("incoming_pdu_raw (done %u): \n", context->done);
+        mesh_network_dump_network_pdu(context->pdu);
+    }
 #ifdef ENABLE_MESH_GATT_BEARER
     printf("gatt_bearer_network_pdu: \n");
     mesh_network_dump_network_pdu(gatt_bearer_network_pdu);
@@ -1216,6 +1296,7 @@ void mesh_network_dump(void){
 
 }
 void mesh_network_reset(void){
+    mesh_network_trial_decryptions = 0;
     mesh_network_reset_network_pdus(&network_pdus_received);
     mesh_network_reset_network_pdus(&network_pdus_queued);
     mesh_network_reset_network_pdus(&network_pdus_outgoing_gatt);
@@ -1224,7 +1305,7 @@ void mesh_network_reset(void){
     // outgoing network pdus are owned by higher layer, so we don't free:
     // - adv_bearer_network_pdu
     // - gatt_bearer_network_pdu
-    // - outoing_pdu
+    // - outgoing pdus in encryption
     // unless they are SEG ACK messages
 #ifdef ENABLE_MESH_ADV_BEARER
     if ((adv_bearer_network_pdu != NULL) && (adv_bearer_network_pdu->pdu_header.pdu_type == MESH_PDU_TYPE_SEGMENT_ACKNOWLEDGMENT)){
@@ -1238,20 +1319,24 @@ void mesh_network_reset(void){
     }
     gatt_bearer_network_pdu = NULL;
 #endif
-    if ((outgoing_pdu != NULL) && (outgoing_pdu->pdu_header.pdu_type == MESH_PDU_TYPE_SEGMENT_ACKNOWLEDGMENT)){
-        btstack_memory_mesh_network_pdu_free(outgoing_pdu);
-    }
-    outgoing_pdu = NULL;
-    
-    if (incoming_pdu_raw){
-        mesh_network_pdu_free(incoming_pdu_raw);
-        incoming_pdu_raw = NULL;
+    while (!btstack_linked_list_empty(&network_pdus_in_encryption)){
+        mesh_network_crypto_context_t * context = (mesh_network_crypto_context_t *) btstack_linked_list_pop(&network_pdus_in_encryption);
+        mesh_network_pdu_t * outgoing_pdu = context->pdu;
+        if (outgoing_pdu->pdu_header.pdu_type == MESH_PDU_TYPE_SEGMENT_ACKNOWLEDGMENT){
+            btstack_memory_mesh_network_pdu_free(outgoing_pdu);
+        }
+        context->pdu = NULL;
     }
-    if (incoming_pdu_decoded){
-        mesh_network_pdu_free(incoming_pdu_decoded);
-        incoming_pdu_decoded = NULL;
+
+    while (!btstack_linked_list_empty(&network_pdus_in_validation)){
+        mesh_network_crypto_context_t * context = (mesh_network_crypto_context_t *) btstack_linked_list_pop(&network_pdus_in_validation);
+        mesh_network_pdu_free(context->pdu);
+        context->pdu = NULL;
+        if (context->pdu_decoded){
+            mesh_network_pdu_free(context->pdu_decoded);
+            context->pdu_decoded = NULL;
+        }
     }
-    mesh_crypto_active = 0;
 }
 
 // buffer pool
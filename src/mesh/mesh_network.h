@@ -136,9 +136,12 @@ typedef struct {
     uint16_t              flags;
     // retry count
     uint8_t               retry_count;
-    // pdu segments
+    // payload len
     uint16_t              len;
+    // incoming: not used / outgoing: pdu segments
     btstack_linked_list_t segments;
+    // incoming: reassembled payload, segment SegO stored at SegO * segment size / outgoing: not used
+    uint8_t               data[MESH_ACCESS_PAYLOAD_MAX];
 } mesh_segmented_pdu_t;
 
 typedef struct {
@@ -440,6 +443,12 @@ void mesh_subnet_setup_for_netkey_index(uint16_t netkey_index);
  */
 mesh_network_key_t * mesh_subnet_get_outgoing_network_key(mesh_subnet_t * subnet);
 
+/**
+ * @brief Get number of network key candidates with matching NID tried to validate received Network PDUs
+ * @return trial decryptions since init/reset
+ */
+uint32_t mesh_network_get_trial_decryptions(void);
+
 // buffer pool
 mesh_network_pdu_t * mesh_network_pdu_get(void);
 void mesh_network_pdu_free(mesh_network_pdu_t * network_pdu);
@@ -41,36 +41,274 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "btstack_debug.h"
 #include "btstack_memory.h"
+#include "btstack_run_loop.h"
+#include "btstack_tlv.h"
 #include "btstack_util.h"
 
 #include "mesh/beacon.h"
 #include "mesh/mesh_upper_transport.h"
 
-#define MESH_NUM_PEERS 5
+// number of peers tracked for SeqAuth validation and replay protection
+#ifndef MESH_PEER_TABLE_SIZE
+#define MESH_PEER_TABLE_SIZE 16
+#endif
 
-static mesh_peer_t mesh_peers[MESH_NUM_PEERS];
+// updated peers are collected and stored together after this interval
+#ifndef MESH_PEER_STORAGE_INTERVAL_MS
+#define MESH_PEER_STORAGE_INTERVAL_MS 5000
+#endif
+
+#if MESH_PEER_TABLE_SIZE >= 0xffff
+#error "MESH_PEER_TABLE_SIZE must be smaller than 0xffff"
+#endif
+
+#define MESH_PEER_INDEX_NONE 0xffff
+
+#define MESH_PEER_FLAG_SEQ_VALID 0x01
+#define MESH_PEER_FLAG_DIRTY     0x02
+
+typedef struct {
+    uint16_t address;
+    uint32_t iv_index;
+    uint32_t seq;
+} mesh_persistent_peer_t;
+
+static mesh_peer_t mesh_peers[MESH_PEER_TABLE_SIZE];
+
+// hash buckets indexed by address, LRU list with most recently used peer at head, unused peers
+static uint16_t mesh_peers_hash_buckets[MESH_PEER_TABLE_SIZE];
+static uint16_t mesh_peers_lru_head;
+static uint16_t mesh_peers_lru_tail;
+static uint16_t mesh_peers_free;
+static uint16_t mesh_peers_count;
+
+static btstack_timer_source_t mesh_peers_storage_timer;
+static bool                   mesh_peers_storage_timer_active;
+
+static uint32_t mesh_peer_tag_for_index(uint16_t index){
+    return ((uint32_t) 'M' << 24) | ((uint32_t) 'R' << 16) | ((uint32_t) index);
+}
+
+static uint16_t mesh_peer_bucket_for_address(uint16_t address){
+    return address % MESH_PEER_TABLE_SIZE;
+}
+
+static void mesh_peer_lru_unlink(uint16_t index){
+    mesh_peer_t * peer = &mesh_peers[index];
+    if (peer->lru_prev == MESH_PEER_INDEX_NONE){
+        mesh_peers_lru_head = peer->lru_next;
+    } else {
+        mesh_peers[peer->lru_prev].lru_next = peer->lru_next;
+    }
+    if (peer->lru_next == MESH_PEER_INDEX_NONE){
+        mesh_peers_lru_tail = peer->lru_prev;
+    } else {
+        mesh_peers[peer->lru_next].lru_prev = peer->lru_prev;
+    }
+}
+
+static void mesh_peer_lru_add_head(uint16_t index){
+    mesh_peer_t * peer = &mesh_peers[index];
+    peer->lru_prev = MESH_PEER_INDEX_NONE;
+    peer->lru_next = mesh_peers_lru_head;
+    if (mesh_peers_lru_head == MESH_PEER_INDEX_NONE){
+        mesh_peers_lru_tail = index;
+    } else {
+        mesh_peers[mesh_peers_lru_head].lru_prev = index;
+    }
+    mesh_peers_lru_head = index;
+}
+
+static void mesh_peer_hash_add(uint16_t index){
+    uint16_t bucket = mesh_peer_bucket_for_address(mesh_peers[index].address);
+    mesh_peers[index].hash_next = mesh_peers_hash_buckets[bucket];
+    mesh_peers_hash_buckets[bucket] = index;
+}
+
+static void mesh_peer_hash_remove(uint16_t index){
+    uint16_t * it = &mesh_peers_hash_buckets[mesh_peer_bucket_for_address(mesh_peers[index].address)];
+    while (*it != MESH_PEER_INDEX_NONE){
+        if (*it == index){
+            *it = mesh_peers[index].hash_next;
+            return;
+        }
+        it = &mesh_peers[*it].hash_next;
+    }
+}
+
+// rebuild hash buckets, LRU and free list from table, free list is linked via hash_next
+static void mesh_peer_link_all(void){
+    uint16_t i;
+    for (i = 0; i < MESH_PEER_TABLE_SIZE; i++){
+        mesh_peers_hash_buckets[i] = MESH_PEER_INDEX_NONE;
+    }
+    mesh_peers_lru_head = MESH_PEER_INDEX_NONE;
+    mesh_peers_lru_tail = MESH_PEER_INDEX_NONE;
+    mesh_peers_free     = MESH_PEER_INDEX_NONE;
+    mesh_peers_count    = 0;
+    i = MESH_PEER_TABLE_SIZE;
+    while (i > 0){
+        i--;
+        if (mesh_peers[i].address == MESH_ADDRESS_UNSASSIGNED){
+            mesh_peers[i].hash_next = mesh_peers_free;
+            mesh_peers_free = i;
+        } else {
+            mesh_peer_hash_add(i);
+            mesh_peer_lru_add_head(i);
+            mesh_peers_count++;
+        }
+    }
+}
+
+static void mesh_peer_store_entry(const btstack_tlv_t * tlv_impl, void * tlv_context, uint16_t index){
+    mesh_peer_t * peer = &mesh_peers[index];
+    mesh_persistent_peer_t data;
+    data.address  = peer->address;
+    data.iv_index = peer->iv_index;
+    data.seq      = peer->seq;
+    int result = tlv_impl->store_tag(tlv_context, mesh_peer_tag_for_index(index), (uint8_t *) &data, sizeof(data));
+    if (result != 0){
+        log_error("Store replay protection list entry %u failed", index);
+    }
+}
+
+void mesh_peer_store(void){
+    if (mesh_peers_storage_timer_active){
+        btstack_run_loop_remove_timer(&mesh_peers_storage_timer);
+        mesh_peers_storage_timer_active = false;
+    }
+    const btstack_tlv_t * tlv_impl = NULL;
+    void * tlv_context = NULL;
+    btstack_tlv_get_instance(&tlv_impl, &tlv_context);
+    uint16_t i;
+    for (i = 0; i < MESH_PEER_TABLE_SIZE; i++){
+        mesh_peer_t * peer = &mesh_peers[i];
+        if ((peer->flags & MESH_PEER_FLAG_DIRTY) == 0) continue;
+        peer->flags &= ~MESH_PEER_FLAG_DIRTY;
+        if (tlv_impl == NULL) continue;
+        mesh_peer_store_entry(tlv_impl, tlv_context, i);
+    }
+}
+
+static void mesh_peer_storage_timeout(btstack_timer_source_t * ts){
+    UNUSED(ts);
+    mesh_peers_storage_timer_active = false;
+    mesh_peer_store();
+}
+
+static void mesh_peer_mark_dirty(mesh_peer_t * peer){
+    peer->flags |= MESH_PEER_FLAG_DIRTY;
+    if (mesh_peers_storage_timer_active) return;
+    mesh_peers_storage_timer_active = true;
+    btstack_run_loop_set_timer_handler(&mesh_peers_storage_timer, &mesh_peer_storage_timeout);
+    btstack_run_loop_set_timer(&mesh_peers_storage_timer, MESH_PEER_STORAGE_INTERVAL_MS);
+    btstack_run_loop_add_timer(&mesh_peers_storage_timer);
+}
+
+static void mesh_peer_clear_all(void){
+    if (mesh_peers_storage_timer_active){
+        btstack_run_loop_remove_timer(&mesh_peers_storage_timer);
+        mesh_peers_storage_timer_active = false;
+    }
+    memset(mesh_peers, 0, sizeof(mesh_peers));
+    mesh_peer_link_all();
+}
 
 void mesh_seq_auth_reset(void){
-    int i;
-    for(i=0;i<MESH_NUM_PEERS;i++){
-        memset(&mesh_peers[i], 0, sizeof(mesh_peer_t));
+    mesh_peer_clear_all();
+}
+
+void mesh_peer_load(void){
+    mesh_peer_clear_all();
+    const btstack_tlv_t * tlv_impl = NULL;
+    void * tlv_context = NULL;
+    btstack_tlv_get_instance(&tlv_impl, &tlv_context);
+    if (tlv_impl == NULL) return;
+    uint16_t i;
+    for (i = 0; i < MESH_PEER_TABLE_SIZE; i++){
+        mesh_persistent_peer_t data;
+        uint32_t len = tlv_impl->get_tag(tlv_context, mesh_peer_tag_for_index(i), (uint8_t *) &data, sizeof(data));
+        if (len != sizeof(data)) continue;
+        mesh_peer_t * peer = &mesh_peers[i];
+        peer->address  = data.address;
+        peer->iv_index = data.iv_index;
+        peer->seq      = data.seq;
+        peer->flags    = MESH_PEER_FLAG_SEQ_VALID;
     }
+    mesh_peer_link_all();
+    log_info("Replay protection list: loaded %u peers", mesh_peers_count);
+}
+
+void mesh_peer_delete_all(void){
+    mesh_peer_clear_all();
+    const btstack_tlv_t * tlv_impl = NULL;
+    void * tlv_context = NULL;
+    btstack_tlv_get_instance(&tlv_impl, &tlv_context);
+    if (tlv_impl == NULL) return;
+    uint16_t i;
+    for (i = 0; i < MESH_PEER_TABLE_SIZE; i++){
+        tlv_impl->delete_tag(tlv_context, mesh_peer_tag_for_index(i));
+    }
+}
+
+uint16_t mesh_peer_count(void){
+    return mesh_peers_count;
 }
 
 mesh_peer_t * mesh_peer_for_addr(uint16_t address){
-    int i;
-    for (i=0;i<MESH_NUM_PEERS;i++){
-        if (mesh_peers[i].address == address){
-            return &mesh_peers[i];
+    // lookup
+    uint16_t index = mesh_peers_hash_buckets[mesh_peer_bucket_for_address(address)];
+    while (index != MESH_PEER_INDEX_NONE){
+        if (mesh_peers[index].address == address){
+            if (index != mesh_peers_lru_head){
+                mesh_peer_lru_unlink(index);
+                mesh_peer_lru_add_head(index);
+            }
+            return &mesh_peers[index];
         }
+        index = mesh_peers[index].hash_next;
     }
-    for (i=0;i<MESH_NUM_PEERS;i++){
-        if (mesh_peers[i].address== MESH_ADDRESS_UNSASSIGNED){
-            memset(&mesh_peers[i], 0, sizeof(mesh_peer_t));
-            mesh_peers[i].address = address;
-            return &mesh_peers[i];
+
+    // get unused peer or replace least recently used one without ongoing reassembly
+    if (mesh_peers_free != MESH_PEER_INDEX_NONE){
+        index = mesh_peers_free;
+        mesh_peers_free = mesh_peers[index].hash_next;
+        mesh_peers_count++;
+    } else {
+        index = mesh_peers_lru_tail;
+        while ((index != MESH_PEER_INDEX_NONE) && (mesh_peers[index].message_pdu != NULL)){
+            index = mesh_peers[index].lru_prev;
+        }
+        if (index == MESH_PEER_INDEX_NONE) {
+            return NULL;
         }
+        log_info("Replay protection list full, replace %04x", mesh_peers[index].address);
+        mesh_peer_hash_remove(index);
+        mesh_peer_lru_unlink(index);
+    }
+
+    mesh_peer_t * peer = &mesh_peers[index];
+    bool dirty = (peer->flags & MESH_PEER_FLAG_DIRTY) != 0;
+    memset(peer, 0, sizeof(mesh_peer_t));
+    peer->address = address;
+    if (dirty){
+        peer->flags = MESH_PEER_FLAG_DIRTY;
+    }
+    mesh_peer_hash_add(index);
+    mesh_peer_lru_add_head(index);
+    return peer;
+}
+
+bool mesh_peer_replay_protection_check(mesh_peer_t * peer, uint32_t iv_index, uint32_t seq){
+    if ((peer->flags & MESH_PEER_FLAG_SEQ_VALID) != 0){
+        if (iv_index < peer->iv_index) return false;
+        if ((iv_index == peer->iv_index) && (seq <= peer->seq)) return false;
     }
-    return NULL;
+    peer->iv_index = iv_index;
+    peer->seq      = seq;
+    peer->flags   |= MESH_PEER_FLAG_SEQ_VALID;
+    mesh_peer_mark_dirty(peer);
+    return true;
 }
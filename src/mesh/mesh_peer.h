@@ -44,11 +44,12 @@
 extern "C" {
 #endif
 
-// mesh seq auth validation
+// mesh seq auth validation and replay protection list entry
 typedef struct {
     // primary element address
     uint16_t address;
-    // next expected seq number
+    // IV Index and SEQ of last accepted Network PDU
+    uint32_t iv_index;
     uint32_t seq;
 
     // segmented transport message
@@ -59,11 +60,54 @@ typedef struct {
     uint32_t seq_auth;
     // block ack
     uint32_t block_ack;
+
+    // internal: hash chain, LRU list and flags
+    uint16_t hash_next;
+    uint16_t lru_prev;
+    uint16_t lru_next;
+    uint8_t  flags;
 } mesh_peer_t;
 
-// get peer info for address
+/**
+ * @brief Get peer info for address. If address is not known yet, the least recently used peer without
+ *        ongoing reassembly of a segmented message is replaced
+ * @param address
+ * @return peer or NULL if all peers are busy
+ */
 mesh_peer_t * mesh_peer_for_addr(uint16_t address);
 
+/**
+ * @brief Replay protection: accept Network PDU if IV Index is newer or SEQ is higher for same IV Index
+ * @note Accepted IV Index and SEQ are persisted with a delay of MESH_PEER_STORAGE_INTERVAL_MS together with other
+ *       updated peers
+ * @param peer
+ * @param iv_index of Network PDU
+ * @param seq of Network PDU
+ * @return true if Network PDU should be processed, peer has been updated
+ */
+bool mesh_peer_replay_protection_check(mesh_peer_t * peer, uint32_t iv_index, uint32_t seq);
+
+/**
+ * @brief Load replay protection list from TLV
+ */
+void mesh_peer_load(void);
+
+/**
+ * @brief Store updated replay protection list entries in TLV right away, e.g. before power down
+ */
+void mesh_peer_store(void);
+
+/**
+ * @brief Reset replay protection list and delete it from TLV
+ */
+void mesh_peer_delete_all(void);
+
+/**
+ * @brief Get number of known peers
+ * @return count
+ */
+uint16_t mesh_peer_count(void);
+
 // reset seq auth == replay protection
 void mesh_seq_auth_reset(void);
 
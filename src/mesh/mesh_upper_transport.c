@@ -62,12 +62,24 @@
 // MESH_ACCESS_MESH_NETWORK_PAYLOAD_MAX (384) / MESH_NETWORK_PAYLOAD_MAX (29) = 13.24.. < 14
 #define MESSAGE_BUILDER_MAX_NUM_NETWORK_PDUS (14)
 
+// number of sources for which the last matching transport key and virtual address is cached
+#ifndef MESH_UPPER_TRANSPORT_KEY_CACHE_SIZE
+#define MESH_UPPER_TRANSPORT_KEY_CACHE_SIZE 4
+#endif
+
 // combined key x address iterator for upper transport decryption
 
 typedef struct {
     // state
     mesh_transport_key_iterator_t  key_it;
     mesh_virtual_address_iterator_t address_it;
+    const mesh_transport_key_t *   address_it_key;
+    // candidate from key cache, tried first
+    const mesh_transport_key_t *   cached_key;
+    const mesh_virtual_address_t * cached_address;
+    bool cached_pending;
+    // key and address set by has_more
+    bool next_ready;
     // elements
     const mesh_transport_key_t *   key;
     const mesh_virtual_address_t * address;
@@ -76,6 +88,14 @@ typedef struct {
     // key info
 } mesh_transport_key_and_virtual_address_iterator_t;
 
+// last transport key (AppKey) and virtual address that decrypted an access message from src
+typedef struct {
+    uint16_t src;
+    uint16_t netkey_index;
+    uint16_t appkey_index;
+    uint16_t pseudo_dst;
+} mesh_upper_transport_key_cache_entry_t;
+
 static void mesh_upper_transport_run(void);
 static void mesh_upper_transport_schedule_send_requests(void);
 static void mesh_upper_transport_validate_access_message(void);
@@ -89,6 +109,11 @@ static int crypto_active;
 static uint8_t application_nonce[13];
 static btstack_crypto_ccm_t ccm;
 static mesh_transport_key_and_virtual_address_iterator_t mesh_transport_key_it;
+static uint32_t mesh_upper_transport_trial_decryptions;
+
+// key cache
+static mesh_upper_transport_key_cache_entry_t mesh_upper_transport_key_cache[MESH_UPPER_TRANSPORT_KEY_CACHE_SIZE];
+static uint8_t mesh_upper_transport_key_cache_index;
 
 // incoming segmented (mesh_segmented_pdu_t) or unsegmented (network_pdu_t)
 static mesh_pdu_t *          incoming_access_encrypted;
@@ -150,60 +175,123 @@ static void mesh_transport_key_and_virtual_address_iterator_init(mesh_transport_
     // init elements
     it->key     = NULL;
     it->address = NULL;
-    // init element iterators
+    it->address_it_key = NULL;
+    it->cached_key     = NULL;
+    it->cached_address = NULL;
+    it->cached_pending = false;
+    it->next_ready     = false;
+    // init element iterators, address iterator is initialized for each key
     mesh_transport_key_aid_iterator_init(&it->key_it, netkey_index, akf, aid);
-    // init address iterator
-    if (mesh_network_address_virtual(it->dst)){
-        mesh_virtual_address_iterator_init(&it->address_it, dst);
-        // get first key
-        if (mesh_transport_key_aid_iterator_has_more(&it->key_it)) {
-            it->key = mesh_transport_key_aid_iterator_get_next(&it->key_it);
-        }
-    }
+}
+
+// try given key and address first, skip them during regular iteration
+static void mesh_transport_key_and_virtual_address_iterator_set_cached(mesh_transport_key_and_virtual_address_iterator_t * it,
+                                                                       const mesh_transport_key_t * key, const mesh_virtual_address_t * address){
+    it->cached_key     = key;
+    it->cached_address = address;
+    it->cached_pending = true;
 }
 
 // cartesian product: keys x addressses
-static int mesh_transport_key_and_virtual_address_iterator_has_more(mesh_transport_key_and_virtual_address_iterator_t * it){
+static bool mesh_transport_key_and_virtual_address_iterator_advance(mesh_transport_key_and_virtual_address_iterator_t * it){
     if (mesh_network_address_virtual(it->dst)) {
         // find next valid entry
         while (true){
-            if (mesh_virtual_address_iterator_has_more(&it->address_it)) return 1;
-            if (!mesh_transport_key_aid_iterator_has_more(&it->key_it)) return 0;
+            if ((it->address_it_key != NULL) && mesh_virtual_address_iterator_has_more(&it->address_it)){
+                it->key     = it->address_it_key;
+                it->address = mesh_virtual_address_iterator_get_next(&it->address_it);
+                return true;
+            }
+            if (!mesh_transport_key_aid_iterator_has_more(&it->key_it)) return false;
             // get next key
-            it->key = mesh_transport_key_aid_iterator_get_next(&it->key_it);
+            it->address_it_key = mesh_transport_key_aid_iterator_get_next(&it->key_it);
             mesh_virtual_address_iterator_init(&it->address_it, it->dst);
         }
     } else {
-        return mesh_transport_key_aid_iterator_has_more(&it->key_it);
+        if (!mesh_transport_key_aid_iterator_has_more(&it->key_it)) return false;
+        it->key = mesh_transport_key_aid_iterator_get_next(&it->key_it);
+        return true;
     }
 }
 
+static int mesh_transport_key_and_virtual_address_iterator_has_more(mesh_transport_key_and_virtual_address_iterator_t * it){
+    if (it->next_ready) return 1;
+    if (it->cached_pending){
+        it->cached_pending = false;
+        it->key     = it->cached_key;
+        it->address = it->cached_address;
+        it->next_ready = true;
+        return 1;
+    }
+    while (mesh_transport_key_and_virtual_address_iterator_advance(it)){
+        // cached candidate has already been tried
+        if ((it->cached_key != NULL) && (it->key == it->cached_key) && (it->address == it->cached_address)) continue;
+        it->next_ready = true;
+        return 1;
+    }
+    return 0;
+}
+
 static void mesh_transport_key_and_virtual_address_iterator_next(mesh_transport_key_and_virtual_address_iterator_t * it){
-    if (mesh_network_address_virtual(it->dst)) {
-        it->address = mesh_virtual_address_iterator_get_next(&it->address_it);
-    } else {
-        it->key = mesh_transport_key_aid_iterator_get_next(&it->key_it);
+    // key and address have been set by has_more
+    it->next_ready = false;
+}
+
+// key cache for AppKeys, device key does not need lookup
+static mesh_upper_transport_key_cache_entry_t * mesh_upper_transport_key_cache_for_src(uint16_t src){
+    uint8_t i;
+    for (i = 0; i < MESH_UPPER_TRANSPORT_KEY_CACHE_SIZE; i++){
+        if (mesh_upper_transport_key_cache[i].src == src) return &mesh_upper_transport_key_cache[i];
     }
+    return NULL;
 }
 
-// UPPER TRANSPORT
+static void mesh_upper_transport_key_cache_lookup(mesh_transport_key_and_virtual_address_iterator_t * it, uint16_t src,
+                                                  uint16_t netkey_index, uint8_t akf, uint8_t aid){
+    if (akf == 0) return;
+    mesh_upper_transport_key_cache_entry_t * entry = mesh_upper_transport_key_cache_for_src(src);
+    if (entry == NULL) return;
+    if (entry->netkey_index != netkey_index) return;
 
-static void mesh_segmented_pdu_flatten(btstack_linked_list_t * segments, uint8_t segment_len, uint8_t * buffer) {
-    // assemble payload
-    btstack_linked_list_iterator_t it;
-    btstack_linked_list_iterator_init(&it, segments);
-    while (btstack_linked_list_iterator_has_next(&it)) {
-        mesh_network_pdu_t *segment = (mesh_network_pdu_t *) btstack_linked_list_iterator_next(&it);
-        btstack_assert(segment->pdu_header.pdu_type == MESH_PDU_TYPE_NETWORK);
-        uint8_t offset = 0;
-        while (offset < segment->len){
-            uint8_t seg_o = segment->data[offset++];
-            (void) memcpy(&buffer[seg_o * segment_len], &segment->data[offset], segment_len);
-            offset += segment_len;
+    // key might have been removed or updated since
+    const mesh_transport_key_t * key = mesh_transport_key_get(entry->appkey_index);
+    if (key == NULL) return;
+    if ((key->akf == 0) || (key->aid != aid) || (key->netkey_index != netkey_index)) return;
+
+    const mesh_virtual_address_t * address = NULL;
+    if (mesh_network_address_virtual(it->dst)){
+        address = mesh_virtual_address_for_pseudo_dst(entry->pseudo_dst);
+        if (address == NULL) return;
+        if (address->hash != it->dst) return;
+    }
+
+    mesh_transport_key_and_virtual_address_iterator_set_cached(it, key, address);
+}
+
+static void mesh_upper_transport_key_cache_store(uint16_t src, uint16_t netkey_index, const mesh_transport_key_t * key,
+                                                 const mesh_virtual_address_t * address){
+    if (key->akf == 0) return;
+    if (src == MESH_ADDRESS_UNSASSIGNED) return;
+    mesh_upper_transport_key_cache_entry_t * entry = mesh_upper_transport_key_cache_for_src(src);
+    if (entry == NULL){
+        entry = &mesh_upper_transport_key_cache[mesh_upper_transport_key_cache_index];
+        mesh_upper_transport_key_cache_index++;
+        if (mesh_upper_transport_key_cache_index >= MESH_UPPER_TRANSPORT_KEY_CACHE_SIZE){
+            mesh_upper_transport_key_cache_index = 0;
         }
     }
+    entry->src          = src;
+    entry->netkey_index = netkey_index;
+    entry->appkey_index = key->appkey_index;
+    entry->pseudo_dst   = (address != NULL) ? address->pseudo_dst : MESH_ADDRESS_UNSASSIGNED;
 }
 
+uint32_t mesh_upper_transport_get_trial_decryptions(void){
+    return mesh_upper_transport_trial_decryptions;
+}
+
+// UPPER TRANSPORT
+
 static uint16_t mesh_upper_pdu_flatten(mesh_upper_transport_pdu_t * upper_pdu, uint8_t * buffer, uint16_t buffer_len) {
     // assemble payload
     btstack_linked_list_iterator_t it;
@@ -279,6 +367,9 @@ void mesh_upper_transport_dump(void){
 
 void mesh_upper_transport_reset(void){
     crypto_active = 0;
+    mesh_upper_transport_trial_decryptions = 0;
+    memset(mesh_upper_transport_key_cache, 0, sizeof(mesh_upper_transport_key_cache));
+    mesh_upper_transport_key_cache_index = 0;
     mesh_upper_transport_reset_pdus(&upper_transport_incoming);
     mesh_upper_transport_reset_pdus(&upper_transport_outgoing);
     message_builder_num_network_pdus_reserved = 0;
@@ -491,6 +582,10 @@ static void mesh_upper_transport_validate_access_message_ccm(void * arg){
         // remove TransMIC from payload
         incoming_access_decrypted->len -= transmic_len;
 
+        // try same key first for next message from this source
+        mesh_upper_transport_key_cache_store(incoming_access_decrypted->src, incoming_access_decrypted->netkey_index,
+                                             mesh_transport_key_it.key, mesh_transport_key_it.address);
+
         // if virtual address, update dst to pseudo_dst
         if (mesh_network_address_virtual(incoming_access_decrypted->dst)){
             incoming_access_decrypted->dst = mesh_transport_key_it.address->pseudo_dst;
@@ -524,7 +619,7 @@ static void mesh_upper_transport_validate_access_message_digest(void * arg){
     switch (incoming_access_encrypted->pdu_type){
         case MESH_PDU_TYPE_SEGMENTED:
             segmented_pdu = (mesh_segmented_pdu_t *) incoming_access_encrypted;
-            mesh_segmented_pdu_flatten(&segmented_pdu->segments, 12, upper_transport_pdu_data_out);
+            (void)memcpy(upper_transport_pdu_data_out, segmented_pdu->data, incoming_access_decrypted->len);
             mesh_print_hex("Encrypted Payload:", upper_transport_pdu_data_out, upper_transport_pdu_len);
             btstack_crypto_ccm_decrypt_block(&ccm, upper_transport_pdu_len, upper_transport_pdu_data_out, upper_transport_pdu_data_out,
                                              &mesh_upper_transport_validate_access_message_ccm, NULL);
@@ -569,6 +664,7 @@ static void mesh_upper_transport_validate_access_message(void){
 
     // decrypt ccm
     crypto_active = 1;
+    mesh_upper_transport_trial_decryptions++;
     uint16_t aad_len  = 0;
     if (mesh_network_address_virtual(incoming_access_decrypted->dst)){
         aad_len  = 16;
@@ -597,6 +693,8 @@ static void mesh_upper_transport_process_access_message(void){
 
     mesh_transport_key_and_virtual_address_iterator_init(&mesh_transport_key_it, incoming_access_decrypted->dst,
                                                          incoming_access_decrypted->netkey_index, akf, aid);
+    mesh_upper_transport_key_cache_lookup(&mesh_transport_key_it, incoming_access_decrypted->src,
+                                          incoming_access_decrypted->netkey_index, akf, aid);
     mesh_upper_transport_validate_access_message();
 }
 
@@ -889,8 +987,8 @@ static void mesh_upper_transport_run(void){
                     incoming_control_pdu=  &incoming_pdu_singleton.control;
                     incoming_control_pdu->pdu_header.pdu_type = MESH_PDU_TYPE_CONTROL;
 
-                    // flatten
-                    mesh_segmented_pdu_flatten(&segmented_pdu->segments, 8, incoming_control_pdu->data);
+                    // copy reassembled payload
+                    (void)memcpy(incoming_control_pdu->data, segmented_pdu->data, segmented_pdu->len);
 
                     // copy meta data into encrypted pdu buffer
                     incoming_control_pdu->flags = 0;
@@ -197,6 +197,12 @@ uint8_t mesh_upper_transport_setup_access_pdu_header(mesh_pdu_t * pdu, uint16_t
  */
 void mesh_upper_transport_send_access_pdu(mesh_pdu_t * pdu);
 
+/**
+ * @brief Get number of CCM decryptions started to find the AppKey/DevKey and virtual address of received access messages
+ * @return trial decryptions since init/reset
+ */
+uint32_t mesh_upper_transport_get_trial_decryptions(void);
+
 
 // test
 void mesh_upper_transport_dump(void);
@@ -46,11 +46,17 @@
 #include "btstack_util.h"
 #include "btstack_memory.h"
 
+// number of buckets for hash lookup, power of two
+#define MESH_VIRTUAL_ADDRESSES_HASH_BUCKETS 8
+
 // virtual address management
 
 static btstack_linked_list_t mesh_virtual_addresses;
 static uint8_t mesh_virtual_addresses_used[MAX_NR_MESH_VIRTUAL_ADDRESSES];
 
+// virtual addresses by hash
+static mesh_virtual_address_t * mesh_virtual_addresses_by_hash[MESH_VIRTUAL_ADDRESSES_HASH_BUCKETS];
+
 uint16_t mesh_virtual_addresses_get_free_pseudo_dst(void){
     uint16_t i;
     for (i=0;i < MAX_NR_MESH_VIRTUAL_ADDRESSES ; i++){
@@ -64,12 +70,28 @@ uint16_t mesh_virtual_addresses_get_free_pseudo_dst(void){
 void mesh_virtual_address_add(mesh_virtual_address_t * virtual_address){
     mesh_virtual_addresses_used[virtual_address->pseudo_dst-0x8000] = 1;
     virtual_address->ref_count = 0;
-    btstack_linked_list_add(&mesh_virtual_addresses, (void *) virtual_address);
+    bool added = btstack_linked_list_add(&mesh_virtual_addresses, (void *) virtual_address);
+    if (added == false) return;
+
+    // prepend to hash bucket to keep order of virtual address list
+    mesh_virtual_address_t ** bucket = &mesh_virtual_addresses_by_hash[virtual_address->hash & (MESH_VIRTUAL_ADDRESSES_HASH_BUCKETS - 1)];
+    virtual_address->hash_next = *bucket;
+    *bucket = virtual_address;
 }
 
 void mesh_virtual_address_remove(mesh_virtual_address_t * virtual_address){
-    btstack_linked_list_remove(&mesh_virtual_addresses, (void *) virtual_address);
+    bool removed = btstack_linked_list_remove(&mesh_virtual_addresses, (void *) virtual_address);
     mesh_virtual_addresses_used[virtual_address->pseudo_dst-0x8000] = 0;
+    if (removed == false) return;
+
+    mesh_virtual_address_t ** it = &mesh_virtual_addresses_by_hash[virtual_address->hash & (MESH_VIRTUAL_ADDRESSES_HASH_BUCKETS - 1)];
+    while (*it != NULL){
+        if (*it == virtual_address){
+            *it = virtual_address->hash_next;
+            break;
+        }
+        it = &(*it)->hash_next;
+    }
 }
 
 // helper
@@ -108,19 +130,20 @@ mesh_virtual_address_t * mesh_virtual_address_for_label_uuid(uint8_t * label_uui
 }
 // virtual address iterator
 
+// only visits virtual addresses in hash bucket
 void mesh_virtual_address_iterator_init(mesh_virtual_address_iterator_t * it, uint16_t hash){
-    btstack_linked_list_iterator_init(&it->it, &mesh_virtual_addresses);
     it->hash = hash;
     it->address = NULL;
+    it->next = mesh_virtual_addresses_by_hash[hash & (MESH_VIRTUAL_ADDRESSES_HASH_BUCKETS - 1)];
 }
 
 int mesh_virtual_address_iterator_has_more(mesh_virtual_address_iterator_t * it){
-    // find next matching key
+    // find next matching address
     while (true){
-        printf("check %p\n", it->address);
         if (it->address && it->address->hash == it->hash) return 1;
-        if (!btstack_linked_list_iterator_has_next(&it->it)) break;
-        it->address = (mesh_virtual_address_t *) btstack_linked_list_iterator_next(&it->it);
+        if (it->next == NULL) break;
+        it->address = it->next;
+        it->next    = it->address->hash_next;
     }
     return 0;
 }
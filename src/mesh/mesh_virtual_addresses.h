@@ -47,8 +47,10 @@ extern "C"
 {
 #endif
 
-typedef struct {
+typedef struct mesh_virtual_address {
 	btstack_linked_item_t item;
+    // next virtual address with same hash bucket
+    struct mesh_virtual_address * hash_next;
     uint16_t pseudo_dst;
     uint16_t hash;
     uint16_t ref_count;
@@ -59,6 +61,7 @@ typedef struct {
 	btstack_linked_list_iterator_t it;
 	uint16_t hash;
 	mesh_virtual_address_t * address;
+	mesh_virtual_address_t * next;
 } mesh_virtual_address_iterator_t;
 
 // virtual address management
@@ -126,6 +126,8 @@ static uint16_t att_prepare_write_request(uint16_t request_type, uint16_t attrib
 // ignore for now
 extern "C" void btstack_crypto_aes128_cmac_generator(btstack_crypto_aes128_cmac_t * request, const uint8_t * key, uint16_t size, uint8_t (*get_byte_callback)(uint16_t pos), uint8_t * hash, void (* callback)(void * arg), void * callback_arg){
 }
+extern "C" void btstack_aes128_calc(const uint8_t * key, const uint8_t * plaintext, uint8_t * ciphertext){
+}
 
 TEST_GROUP(AttDb){
 	att_connection_t att_connection;
@@ -908,6 +910,44 @@ TEST(AttDb, att_read_callback_handle_little_endian_32){
 	}
 }
 
+TEST(AttDb, service_segment){
+	static att_db_util_service_t service;
+	static uint8_t service_storage[50];
+	static uint8_t manufacturer[] = { 'B', 'K' };
+	att_db_util_service_begin(&service, 0x80, service_storage, sizeof(service_storage));
+	att_db_util_add_service_uuid16(ORG_BLUETOOTH_SERVICE_DEVICE_INFORMATION);
+	uint16_t value_handle = att_db_util_add_characteristic_uuid16(ORG_BLUETOOTH_CHARACTERISTIC_MANUFACTURER_NAME_STRING, ATT_PROPERTY_READ, ATT_SECURITY_NONE, ATT_SECURITY_NONE, manufacturer, sizeof(manufacturer));
+	CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_end());
+	CHECK_EQUAL(0x82, value_handle);
+
+	att_request[0] = ATT_READ_REQUEST;
+	little_endian_store_16(att_request, 1, value_handle);
+	att_request_len = 3;
+
+	// not linked yet
+	att_response_len = att_handle_request(&att_connection, (uint8_t *) att_request, att_request_len, att_response);
+	CHECK_EQUAL(ATT_ERROR_RESPONSE, att_response[0]);
+	CHECK_EQUAL(ATT_ERROR_INVALID_HANDLE, att_response[4]);
+
+	CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_add(&service));
+	att_response_len = att_handle_request(&att_connection, (uint8_t *) att_request, att_request_len, att_response);
+	const uint8_t expected_response[] = { ATT_READ_RESPONSE, 'B', 'K'};
+	CHECK_EQUAL(sizeof(expected_response), att_response_len);
+	MEMCMP_EQUAL(expected_response, att_response, att_response_len);
+
+	// handle range of service follows main ATT DB
+	uint16_t start_handle = 0x0001;
+	uint16_t end_handle = 0xffff;
+	CHECK_TRUE(gatt_server_get_handle_range_for_service_with_uuid16(ORG_BLUETOOTH_SERVICE_DEVICE_INFORMATION, &start_handle, &end_handle));
+	CHECK_EQUAL(0x80, start_handle);
+	CHECK_EQUAL(0x82, end_handle);
+
+	CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_remove(&service));
+	att_request[0] = ATT_READ_REQUEST;
+	little_endian_store_16(att_request, 1, 0x82);
+	att_response_len = att_handle_request(&att_connection, (uint8_t *) att_request, 3, att_response);
+	CHECK_EQUAL(ATT_ERROR_RESPONSE, att_response[0]);
+}
 
 int main (int argc, const char * argv[]){
     return CommandLineTestRunner::RunAllTests(argc, argv);
@@ -93,6 +93,8 @@ extern "C" {
 
     void att_set_db(uint8_t const * db){
     }
+    void att_set_db_segments(btstack_linked_list_t * segments){
+    }
     void hci_add_event_handler(btstack_packet_callback_registration_t * callback_handler){
     }
     bool hci_can_send_command_packet_now(void){
@@ -171,6 +173,204 @@ TEST(AttDbUtil, GattHash){
     CHECK_EQUAL_ARRAY(gatt_database_hash_expected, cmac_calculated, 16);
 }
 
+static uint16_t service_changed_start_handle;
+static uint16_t service_changed_end_handle;
+
+static void service_changed_callback(uint16_t start_handle, uint16_t end_handle){
+    service_changed_start_handle = start_handle;
+    service_changed_end_handle = end_handle;
+}
+
+static uint8_t hash_message[200];
+
+static void hash_calc_full(uint8_t * db_hash){
+    static const uint8_t zero_key[16] = { 0 };
+    uint16_t hash_len = att_db_util_hash_len();
+    CHECK(hash_len <= sizeof(hash_message));
+    att_db_util_hash_init();
+    uint16_t i;
+    for (i=0;i<hash_len;i++){
+        hash_message[i] = att_db_util_hash_get_next();
+    }
+    btstack_aes128_cmac_calc(zero_key, hash_len, hash_message, db_hash);
+}
+
+TEST_GROUP(AttDbUtilService){
+    att_db_util_service_t hrs_service;
+    att_db_util_service_t bas_service;
+    uint8_t hrs_storage[100];
+    uint8_t bas_storage[100];
+    const uint8_t * extended_properties;
+    const uint8_t * battery_level;
+
+    void setup(void){
+        static const uint8_t appearance[] = {0};
+        static const uint8_t service_changed[] = {0} ;
+        static const uint8_t supported_features[] = {0} ;
+        static const uint8_t extended_properties_value[] = {0,0} ;
+        static const uint8_t battery_level_value[] = { 100 } ;
+        extended_properties = extended_properties_value;
+        battery_level = battery_level_value;
+        service_changed_start_handle = 0;
+        service_changed_end_handle = 0;
+        memset(&hrs_service, 0, sizeof(hrs_service));
+        memset(&bas_service, 0, sizeof(bas_service));
+        att_db_util_init();
+        att_db_util_register_service_changed_callback(&service_changed_callback);
+        // same content as in GattHash test, last two services are stored separately
+        att_db_util_add_service_uuid16(GAP_SERVICE_UUID);
+        att_db_util_add_characteristic_uuid16(GAP_DEVICE_NAME_UUID, ATT_PROPERTY_READ | ATT_PROPERTY_WRITE, ATT_SECURITY_NONE, ATT_SECURITY_NONE, (uint8_t*)"HASH", 4);
+        att_db_util_add_characteristic_uuid16(GAP_APPEARANCE_UUID, ATT_PROPERTY_READ, ATT_SECURITY_NONE, ATT_SECURITY_NONE, (uint8_t*)appearance, sizeof(appearance));
+        att_db_util_add_service_uuid16(0x1801);
+        att_db_util_add_characteristic_uuid16(GAP_SERVICE_CHANGED, ATT_PROPERTY_INDICATE, ATT_SECURITY_NONE, ATT_SECURITY_NONE, (uint8_t*)service_changed, sizeof(service_changed));
+        att_db_util_add_characteristic_uuid16(0x2b29, ATT_PROPERTY_READ | ATT_PROPERTY_WRITE, ATT_SECURITY_NONE, ATT_SECURITY_NONE, (uint8_t*)supported_features, sizeof(supported_features));
+        att_db_util_add_characteristic_uuid16(0x2b2a, ATT_PROPERTY_READ | ATT_PROPERTY_DYNAMIC, ATT_SECURITY_NONE, ATT_SECURITY_NONE, NULL, 0);
+    }
+
+    void teardown(void){
+        att_db_util_service_remove(&hrs_service);
+        att_db_util_service_remove(&bas_service);
+    }
+
+    void build_hrs_service(void){
+        att_db_util_service_begin(&hrs_service, 0x000e, hrs_storage, sizeof(hrs_storage));
+        att_db_util_add_service_uuid16(0x1808);
+        att_db_util_add_included_service_uuid16(0x0014, 0x0016, 0x180f);
+        att_db_util_add_characteristic_uuid16(0x2a18, ATT_PROPERTY_READ | ATT_PROPERTY_EXTENDED_PROPERTIES | ATT_PROPERTY_INDICATE, ATT_SECURITY_NONE, ATT_SECURITY_NONE, NULL, 0);
+        att_db_util_add_descriptor_uuid16(0x2900, 0, ATT_SECURITY_NONE, ATT_SECURITY_NONE, (uint8_t*)extended_properties, 2);
+        CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_end());
+    }
+
+    void build_bas_service(void){
+        att_db_util_service_begin(&bas_service, 0x0014, bas_storage, sizeof(bas_storage));
+        att_db_util_add_secondary_service_uuid16(0x180f);
+        att_db_util_add_characteristic_uuid16(0x2a19, ATT_PROPERTY_READ, ATT_SECURITY_NONE, ATT_SECURITY_NONE, (uint8_t*)battery_level, 1);
+        CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_end());
+    }
+};
+
+TEST(AttDbUtilService, Build){
+    build_hrs_service();
+    CHECK_EQUAL(0x000e, hrs_service.start_handle);
+    CHECK_EQUAL(0x0013, hrs_service.end_handle);
+    // main ATT DB continues after service
+    CHECK_EQUAL(0x000e, att_db_util_add_service_uuid16(0x180a));
+}
+
+TEST(AttDbUtilService, GattHash){
+    build_hrs_service();
+    build_bas_service();
+    // add in reverse order
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_add(&bas_service));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_add(&hrs_service));
+    CHECK_EQUAL((uint16_t)sizeof(gatt_database_hash_test_message), att_db_util_hash_len());
+
+    uint16_t i;
+    att_db_util_hash_init();
+    for (i=0;i<sizeof(gatt_database_hash_test_message);i++){
+        CHECK_EQUAL(gatt_database_hash_test_message[i], att_db_util_hash_get_next());
+    }
+
+    uint8_t db_hash[16];
+    att_db_util_hash_calc_incremental(db_hash);
+    CHECK_EQUAL_ARRAY(gatt_database_hash_expected, db_hash, 16);
+    att_db_util_hash_calc(&cmac_context, cmac_calculated, &gatt_hash_calculated, NULL);
+    CHECK_EQUAL_ARRAY(gatt_database_hash_expected, cmac_calculated, 16);
+}
+
+TEST(AttDbUtilService, IncrementalHash){
+    uint8_t db_hash[16];
+    uint8_t db_hash_expected[16];
+    build_hrs_service();
+    build_bas_service();
+
+    att_db_util_hash_calc_incremental(db_hash);
+    hash_calc_full(db_hash_expected);
+    CHECK_EQUAL_ARRAY(db_hash_expected, db_hash, 16);
+
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_add(&hrs_service));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_add(&bas_service));
+    att_db_util_hash_calc_incremental(db_hash);
+    CHECK_EQUAL_ARRAY(gatt_database_hash_expected, db_hash, 16);
+    CHECK_TRUE(hrs_service.hash_state_valid);
+    CHECK_TRUE(bas_service.hash_state_valid);
+
+    // remove last service, hash state of first service stays valid
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_remove(&bas_service));
+    CHECK_TRUE(hrs_service.hash_state_valid);
+    att_db_util_hash_calc_incremental(db_hash);
+    hash_calc_full(db_hash_expected);
+    CHECK_EQUAL_ARRAY(db_hash_expected, db_hash, 16);
+
+    // remove first service, following service gets recalculated
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_add(&bas_service));
+    att_db_util_hash_calc_incremental(db_hash);
+    CHECK_EQUAL_ARRAY(gatt_database_hash_expected, db_hash, 16);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_remove(&hrs_service));
+    CHECK_FALSE(bas_service.hash_state_valid);
+    att_db_util_hash_calc_incremental(db_hash);
+    hash_calc_full(db_hash_expected);
+    CHECK_EQUAL_ARRAY(db_hash_expected, db_hash, 16);
+
+    // insert before existing service
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_add(&hrs_service));
+    CHECK_FALSE(bas_service.hash_state_valid);
+    att_db_util_hash_calc_incremental(db_hash);
+    CHECK_EQUAL_ARRAY(gatt_database_hash_expected, db_hash, 16);
+}
+
+TEST(AttDbUtilService, ServiceChanged){
+    build_hrs_service();
+    build_bas_service();
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_add(&bas_service));
+    CHECK_EQUAL(0x0014, service_changed_start_handle);
+    CHECK_EQUAL(0x0016, service_changed_end_handle);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_add(&hrs_service));
+    CHECK_EQUAL(0x000e, service_changed_start_handle);
+    CHECK_EQUAL(0x0013, service_changed_end_handle);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_remove(&bas_service));
+    CHECK_EQUAL(0x0014, service_changed_start_handle);
+    CHECK_EQUAL(0x0016, service_changed_end_handle);
+}
+
+TEST(AttDbUtilService, InvalidOperations){
+    att_db_util_service_t service;
+    uint8_t storage[20];
+    build_hrs_service();
+    CHECK_EQUAL(ERROR_CODE_COMMAND_DISALLOWED, att_db_util_service_remove(&hrs_service));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_add(&hrs_service));
+    CHECK_EQUAL(ERROR_CODE_COMMAND_DISALLOWED, att_db_util_service_add(&hrs_service));
+
+    // overlaps with hrs service
+    att_db_util_service_begin(&service, 0x0010, storage, sizeof(storage));
+    att_db_util_add_service_uuid16(0x180a);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_end());
+    CHECK_EQUAL(ERROR_CODE_INVALID_HCI_COMMAND_PARAMETERS, att_db_util_service_add(&service));
+
+    // overlaps with main ATT DB
+    att_db_util_service_begin(&service, 0x0005, storage, sizeof(storage));
+    att_db_util_add_service_uuid16(0x180a);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_end());
+    CHECK_EQUAL(ERROR_CODE_INVALID_HCI_COMMAND_PARAMETERS, att_db_util_service_add(&service));
+
+    // empty
+    att_db_util_service_begin(&service, 0x0020, storage, sizeof(storage));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, att_db_util_service_end());
+    CHECK_EQUAL(ERROR_CODE_COMMAND_DISALLOWED, att_db_util_service_add(&service));
+
+    // storage too small
+    att_db_util_service_begin(&service, 0x0020, storage, sizeof(storage));
+    att_db_util_add_service_uuid16(0x180a);
+    att_db_util_add_characteristic_uuid16(0x2a29, ATT_PROPERTY_READ, ATT_SECURITY_NONE, ATT_SECURITY_NONE, (uint8_t*)"BlueKitchen", 11);
+    CHECK_EQUAL(ERROR_CODE_MEMORY_CAPACITY_EXCEEDED, att_db_util_service_end());
+    CHECK_EQUAL(ERROR_CODE_COMMAND_DISALLOWED, att_db_util_service_add(&service));
+
+    // main ATT DB cannot grow into linked service
+    uint16_t main_size = att_db_util_get_size();
+    att_db_util_add_service_uuid16(0x180a);
+    CHECK_EQUAL(main_size, att_db_util_get_size());
+}
+
 int main (int argc, const char * argv[]){
     return CommandLineTestRunner::RunAllTests(argc, argv);
 }
@@ -82,6 +82,73 @@ TEST(btstack_memory, deinit){
 }
 #endif
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static const btstack_memory_statistics_t * statistics_for_name(const char * name){
+    uint16_t i;
+    for (i = 0; i < btstack_memory_statistics_num_types(); i++){
+        const btstack_memory_statistics_t * statistics = btstack_memory_statistics_get(i);
+        if (strcmp(statistics->name, name) == 0){
+            return statistics;
+        }
+    }
+    return NULL;
+}
+
+static uint32_t time_us;
+static uint32_t get_time_us(void){
+    time_us += 5;
+    return time_us;
+}
+
+TEST(btstack_memory, statistics){
+    const btstack_memory_statistics_t * statistics = statistics_for_name("hci_connection");
+    CHECK(statistics != NULL);
+    POINTERS_EQUAL(NULL, btstack_memory_statistics_get(btstack_memory_statistics_num_types()));
+    btstack_memory_statistics_set_time_source(&get_time_us);
+
+    hci_connection_t * buffer = btstack_memory_hci_connection_get();
+    CHECK(buffer != NULL);
+    CHECK_EQUAL(1, statistics->current);
+    CHECK_EQUAL(1, statistics->peak);
+    CHECK_EQUAL(1, statistics->allocations);
+#ifdef HAVE_MALLOC
+    CHECK_EQUAL(0, statistics->pool_size);
+    CHECK_EQUAL(5, statistics->alloc_time_us_max);
+    simulate_no_memory = 1;
+#else
+    CHECK_EQUAL(MAX_NR_HCI_CONNECTIONS, statistics->pool_size);
+    CHECK_EQUAL(0, statistics->alloc_time_us_max);
+#endif
+    // pool exhausted
+    CHECK(btstack_memory_hci_connection_get() == NULL);
+    CHECK_EQUAL(1, statistics->failed);
+    btstack_memory_hci_connection_free(buffer);
+    CHECK_EQUAL(0, statistics->current);
+    CHECK_EQUAL(1, statistics->peak);
+    btstack_memory_statistics_dump();
+
+    // reset keeps current usage
+    btstack_memory_statistics_reset();
+    CHECK_EQUAL(0, statistics->peak);
+    CHECK_EQUAL(0, statistics->allocations);
+    CHECK_EQUAL(0, statistics->failed);
+    btstack_memory_statistics_set_time_source(NULL);
+}
+#endif
+
+#ifdef ENABLE_BTSTACK_MEMORY_SLAB
+TEST(btstack_memory, slab){
+    // pools are placed next to each other in a single arena
+    hci_connection_t * connection = btstack_memory_hci_connection_get();
+    l2cap_channel_t * channel = btstack_memory_l2cap_channel_get();
+    CHECK(connection != NULL);
+    CHECK(channel != NULL);
+    uintptr_t distance = (uintptr_t) channel - (uintptr_t) connection;
+    CHECK(distance >= sizeof(hci_connection_t));
+    CHECK(distance < (sizeof(hci_connection_t) + sizeof(l2cap_service_t) + 16));
+}
+#endif
+
 
 
 
@@ -1150,6 +1217,51 @@ TEST(btstack_memory, periodic_advertiser_list_entry_NotEnoughBuffers){
 }
 
 
+#endif
+#ifdef ENABLE_GATT_CLIENT_CACHE
+
+
+TEST(btstack_memory, gatt_client_cache_GetAndFree){
+    gatt_client_cache_t * context;
+#ifdef HAVE_MALLOC
+    context = btstack_memory_gatt_client_cache_get();
+    CHECK(context != NULL);
+    btstack_memory_gatt_client_cache_free(context);
+#else
+#ifdef MAX_NR_GATT_CLIENT_CACHES
+    // single
+    context = btstack_memory_gatt_client_cache_get();
+    CHECK(context != NULL);
+    btstack_memory_gatt_client_cache_free(context);
+#else
+    // none
+    context = btstack_memory_gatt_client_cache_get();
+    CHECK(context == NULL);
+    btstack_memory_gatt_client_cache_free(context);
+#endif
+#endif
+}
+
+TEST(btstack_memory, gatt_client_cache_NotEnoughBuffers){
+    gatt_client_cache_t * context;
+#ifdef HAVE_MALLOC
+    simulate_no_memory = 1;
+#else
+#ifdef MAX_NR_GATT_CLIENT_CACHES
+    int i;
+    // alloc all static buffers
+    for (i = 0; i < MAX_NR_GATT_CLIENT_CACHES; i++){
+        context = btstack_memory_gatt_client_cache_get();
+        CHECK(context != NULL);
+    }
+#endif
+#endif
+    // get one more
+    context = btstack_memory_gatt_client_cache_get();
+    CHECK(context == NULL);
+}
+
+
 #endif
 #ifdef ENABLE_MESH
 
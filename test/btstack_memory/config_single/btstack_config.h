@@ -12,6 +12,7 @@
 
 // BTstack features that can be enabled
 #define ENABLE_BLE
+#define ENABLE_BTSTACK_MEMORY_STATISTICS
 #define ENABLE_CLASSIC
 #define ENABLE_LOG_ERROR
 #define ENABLE_LOG_INFO
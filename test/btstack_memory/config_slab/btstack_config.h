@@ -0,0 +1,52 @@
+//
+// btstack_config.h for most tests
+//
+
+#ifndef BTSTACK_CONFIG_H
+#define BTSTACK_CONFIG_H
+
+// Port related features
+#define HAVE_BTSTACK_STDIN
+#define HAVE_POSIX_FILE_IO
+#define HAVE_POSIX_TIME
+
+// BTstack features that can be enabled
+#define ENABLE_BLE
+#define ENABLE_BTSTACK_MEMORY_SLAB
+#define ENABLE_BTSTACK_MEMORY_STATISTICS
+#define ENABLE_CLASSIC
+#define ENABLE_LOG_ERROR
+#define ENABLE_LOG_INFO
+#define ENABLE_PRINTF_HEXDUMP
+
+// BTstack configuration. buffers, sizes, ...
+#define HCI_ACL_PAYLOAD_SIZE 1024
+#define HCI_INCOMING_PRE_BUFFER_SIZE 6
+
+#define MAX_NR_AVDTP_CONNECTIONS 1
+#define MAX_NR_AVDTP_STREAM_ENDPOINTS 1
+#define MAX_NR_AVRCP_BROWSING_CONNECTIONS 1
+#define MAX_NR_AVRCP_CONNECTIONS 1
+#define MAX_NR_BNEP_CHANNELS 1
+#define MAX_NR_BNEP_SERVICES 1
+#define MAX_NR_BTSTACK_LINK_KEY_DB_MEMORY_ENTRIES 1
+#define MAX_NR_GATT_CLIENTS 1
+#define MAX_NR_HCI_CONNECTIONS 1
+#define MAX_NR_HFP_CONNECTIONS 1
+#define MAX_NR_L2CAP_CHANNELS 1
+#define MAX_NR_L2CAP_SERVICES 1
+#define MAX_NR_MESH_NETWORK_KEYS 1
+#define MAX_NR_MESH_NETWORK_PDUS 1
+#define MAX_NR_MESH_SEGMENTED_PDUS 1
+#define MAX_NR_MESH_SUBNETS 1
+#define MAX_NR_MESH_TRANSPORT_KEYS 1
+#define MAX_NR_MESH_UPPER_TRANSPORT_PDUS 1
+#define MAX_NR_MESH_VIRTUAL_ADDRESSS 1
+#define MAX_NR_RFCOMM_CHANNELS 1
+#define MAX_NR_RFCOMM_MULTIPLEXERS 1
+#define MAX_NR_RFCOMM_SERVICES 1
+#define MAX_NR_SERVICE_RECORD_ITEMS 1
+#define MAX_NR_SM_LOOKUP_ENTRIES 1
+#define MAX_NR_WHITELIST_ENTRIES 1
+
+#endif
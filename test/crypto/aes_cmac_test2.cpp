@@ -58,6 +58,13 @@ static const char example_40_string[] = "6bc1bee2 2e409f96 e93d7e11 7393172a ae2
 static const char cmac_0_string[]     = "bb1d6929 e9593728 7fa37d12 9b756746";
 static const char cmac_16_string[]    = "070a16b4 6b4d4144 f79bdd9d d04a287c";
 static const char cmac_40_string[]    = "dfa66747 de9ae630 30ca3261 1497c827";
+static const char example_64_string[] = "6bc1bee2 2e409f96 e93d7e11 7393172a ae2d8a57 1e03ac9c 9eb76fac 45af8e51 30c81c46 a35ce411 e5fbc119 1a0a52ef f69f2445 df4f9b17 ad2b417b e66c3710";
+static const char cmac_64_string[]    = "51f0bebf 7e3b9d92 fc497417 79363cfe";
+
+static uint8_t generator_message[100];
+static uint8_t get_byte(uint16_t pos){
+    return generator_message[pos];
+}
 
 static int parse_hex(uint8_t * buffer, const char * hex_string){
     int len = 0;
@@ -138,6 +145,50 @@ TEST(AES_CMAC,CMAC_40){
     CHECK_EQUAL_ARRAY(cmac, cmac_calculated, 16);
 }
 
+TEST(AES_CMAC,CMAC_64){
+    uint8_t k[16];
+    uint8_t cmac[16];
+    uint8_t m[64];
+    parse_hex(k, key_string);
+    parse_hex(m, example_64_string);
+    parse_hex(cmac, cmac_64_string);
+    btstack_crypto_aes128_cmac_message(&cmac_context, k, 64, m, cmac_calculated, gatt_hash_calculated, NULL);
+    CHECK_EQUAL_ARRAY(cmac, cmac_calculated, 16);
+    memset(cmac_calculated, 0, 16);
+    btstack_aes128_cmac_calc(k, 64, m, cmac_calculated);
+    CHECK_EQUAL_ARRAY(cmac, cmac_calculated, 16);
+}
+
+TEST(AES_CMAC,CMAC_Sync){
+    uint8_t k[16];
+    uint8_t cmac[16];
+    uint8_t m[40];
+    parse_hex(k, key_string);
+    parse_hex(m, example_40_string);
+    parse_hex(cmac, cmac_40_string);
+    btstack_aes128_cmac_calc(k, 40, m, cmac_calculated);
+    CHECK_EQUAL_ARRAY(cmac, cmac_calculated, 16);
+    parse_hex(cmac, cmac_0_string);
+    btstack_aes128_cmac_calc(k, 0, NULL, cmac_calculated);
+    CHECK_EQUAL_ARRAY(cmac, cmac_calculated, 16);
+}
+
+TEST(AES_CMAC,CMAC_Generator_Matches_Message){
+    uint8_t cmac_generator[16];
+    uint8_t k[16];
+    uint16_t i;
+    for (i = 0; i < sizeof(generator_message); i++){
+        generator_message[i] = (uint8_t) (i * 31);
+    }
+    for (i = 0; i < sizeof(generator_message); i++){
+        // different keys to exceed key schedule cache
+        memset(k, i, sizeof(k));
+        btstack_crypto_aes128_cmac_generator(&cmac_context, k, i, &get_byte, cmac_generator, gatt_hash_calculated, NULL);
+        btstack_crypto_aes128_cmac_message(&cmac_context, k, i, generator_message, cmac_calculated, gatt_hash_calculated, NULL);
+        CHECK_EQUAL_ARRAY(cmac_generator, cmac_calculated, 16);
+    }
+}
+
 int main (int argc, const char * argv[]){
     return CommandLineTestRunner::RunAllTests(argc, argv);
 }
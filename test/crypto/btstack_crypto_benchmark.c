@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+// *****************************************************************************
+//
+// btstack_crypto Benchmark
+//
+// Measures Mesh Network and Upper Transport PDU encryption/decryption with
+// software AES128. Reference is CCM from the Zephyr Project, which expands the
+// key for each AES128 block. The async btstack_crypto_ccm API and the synchronous
+// btstack_aes128_ccm_* functions are verified against the reference
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "aes_ccm.h"
+#include "aes_cmac.h"
+#include "btstack_crypto.h"
+#include "btstack_util.h"
+
+#define NUM_ITERATIONS  100000
+
+// Network PDU: DST + Transport PDU, NetMIC 4 bytes
+#define NETWORK_PDU_LEN     18
+#define NET_MIC_LEN          4
+// Upper Transport Access PDU for Label UUID, TransMIC 8 bytes
+#define ACCESS_PDU_LEN      11
+#define TRANS_MIC_LEN        8
+// CMAC message, e.g. for Mesh k2 and SM
+#define CMAC_MESSAGE_LEN    65
+
+static const uint8_t encryption_key[] = { 0x09, 0x53, 0xfa, 0x93, 0xe7, 0xca, 0xac, 0x96, 0x38, 0xf5, 0x88, 0x20, 0x22, 0x0a, 0x39, 0x8e };
+static const uint8_t app_key[]        = { 0x63, 0x96, 0x47, 0x71, 0x73, 0x4f, 0xbd, 0x76, 0xe3, 0xb4, 0x05, 0x19, 0xd1, 0xd9, 0x4a, 0x48 };
+static const uint8_t label_uuid[]     = { 0xf4, 0xa0, 0x02, 0xc7, 0xfb, 0x1e, 0x4c, 0xa0, 0xa4, 0x69, 0xa0, 0x21, 0xde, 0x0d, 0xb8, 0x75 };
+static uint8_t network_nonce[]        = { 0x00, 0x03, 0x07, 0x08, 0x0d, 0x12, 0x34, 0x00, 0x00, 0x12, 0x34, 0x56, 0x77 };
+static uint8_t app_nonce[]            = { 0x01, 0x80, 0x07, 0x08, 0x0d, 0x12, 0x34, 0x97, 0x36, 0x12, 0x34, 0x56, 0x77 };
+
+static uint8_t plaintext[32];
+static uint8_t ciphertext[32 + 8];
+static uint8_t output[32 + 8];
+static uint8_t mic[8];
+static uint8_t cmac_message[CMAC_MESSAGE_LEN];
+
+static btstack_crypto_ccm_t       crypto_ccm;
+static btstack_crypto_aes128_cmac_t crypto_cmac;
+static int crypto_done;
+
+static void crypto_done_callback(void * arg){
+    UNUSED(arg);
+    crypto_done = 1;
+}
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+static void ccm_async(int encrypt, const uint8_t * key, uint8_t * nonce, const uint8_t * aad, uint16_t aad_len,
+                      const uint8_t * input, uint16_t len, uint8_t * out, uint8_t * auth_value, uint8_t auth_len){
+    btstack_crypto_ccm_init(&crypto_ccm, key, nonce, len, aad_len, auth_len);
+    if (aad_len > 0){
+        crypto_done = 0;
+        btstack_crypto_ccm_digest(&crypto_ccm, (uint8_t *) aad, aad_len, &crypto_done_callback, NULL);
+        if (!crypto_done) {
+            printf("CCM digest did not complete synchronously\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    crypto_done = 0;
+    if (encrypt){
+        btstack_crypto_ccm_encrypt_block(&crypto_ccm, len, input, out, &crypto_done_callback, NULL);
+    } else {
+        btstack_crypto_ccm_decrypt_block(&crypto_ccm, len, input, out, &crypto_done_callback, NULL);
+    }
+    if (!crypto_done) {
+        printf("CCM did not complete synchronously\n");
+        exit(EXIT_FAILURE);
+    }
+    btstack_crypto_ccm_get_authentication_value(&crypto_ccm, auth_value);
+}
+
+static void verify(const char * name, const uint8_t * expected, const uint8_t * actual, uint16_t len){
+    if (memcmp(expected, actual, len) == 0) return;
+    printf("%s: result does not match reference\n", name);
+    exit(EXIT_FAILURE);
+}
+
+static void benchmark_ccm(const char * name, const uint8_t * key, uint8_t * nonce, const uint8_t * aad, uint16_t aad_len,
+                          uint16_t len, uint8_t auth_len){
+    int i;
+    double start;
+
+    // reference, also used for verification
+    bt_mesh_ccm_encrypt(key, nonce, plaintext, len, aad, aad_len, ciphertext, auth_len);
+    start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        bt_mesh_ccm_encrypt(key, nonce, plaintext, len, aad, aad_len, output, auth_len);
+    }
+    double reference_encrypt_duration = time_now() - start;
+    start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        bt_mesh_ccm_decrypt(key, nonce, ciphertext, len, aad, aad_len, output, auth_len);
+    }
+    double reference_decrypt_duration = time_now() - start;
+
+    // async API
+    ccm_async(1, key, nonce, aad, aad_len, plaintext, len, output, mic, auth_len);
+    verify(name, ciphertext, output, len);
+    verify(name, &ciphertext[len], mic, auth_len);
+    start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        ccm_async(1, key, nonce, aad, aad_len, plaintext, len, output, mic, auth_len);
+    }
+    double async_encrypt_duration = time_now() - start;
+    ccm_async(0, key, nonce, aad, aad_len, ciphertext, len, output, mic, auth_len);
+    verify(name, plaintext, output, len);
+    verify(name, &ciphertext[len], mic, auth_len);
+    start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        ccm_async(0, key, nonce, aad, aad_len, ciphertext, len, output, mic, auth_len);
+    }
+    double async_decrypt_duration = time_now() - start;
+
+    // synchronous API
+    btstack_aes128_ccm_encrypt(key, nonce, aad, aad_len, plaintext, len, output, mic, auth_len);
+    verify(name, ciphertext, output, len);
+    verify(name, &ciphertext[len], mic, auth_len);
+    start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        btstack_aes128_ccm_encrypt(key, nonce, aad, aad_len, plaintext, len, output, mic, auth_len);
+    }
+    double sync_encrypt_duration = time_now() - start;
+    btstack_aes128_ccm_decrypt(key, nonce, aad, aad_len, ciphertext, len, output, mic, auth_len);
+    verify(name, plaintext, output, len);
+    verify(name, &ciphertext[len], mic, auth_len);
+    start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        btstack_aes128_ccm_decrypt(key, nonce, aad, aad_len, ciphertext, len, output, mic, auth_len);
+    }
+    double sync_decrypt_duration = time_now() - start;
+
+    printf("%s: %u bytes, %u bytes MIC\n", name, len, auth_len);
+    printf("- Reference (key expansion per block): %10.0f encrypt/s %10.0f decrypt/s\n", NUM_ITERATIONS / reference_encrypt_duration, NUM_ITERATIONS / reference_decrypt_duration);
+    printf("- btstack_crypto_ccm:                  %10.0f encrypt/s %10.0f decrypt/s\n", NUM_ITERATIONS / async_encrypt_duration,     NUM_ITERATIONS / async_decrypt_duration);
+    printf("- btstack_aes128_ccm:                  %10.0f encrypt/s %10.0f decrypt/s\n", NUM_ITERATIONS / sync_encrypt_duration,      NUM_ITERATIONS / sync_decrypt_duration);
+}
+
+static void benchmark_cmac(void){
+    uint8_t reference[16];
+    uint8_t hash[16];
+    int i;
+    double start;
+
+    aes_cmac(reference, app_key, cmac_message, CMAC_MESSAGE_LEN);
+    start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        aes_cmac(hash, app_key, cmac_message, CMAC_MESSAGE_LEN);
+    }
+    double reference_duration = time_now() - start;
+
+    start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        crypto_done = 0;
+        btstack_crypto_aes128_cmac_message(&crypto_cmac, app_key, CMAC_MESSAGE_LEN, cmac_message, hash, &crypto_done_callback, NULL);
+    }
+    double async_duration = time_now() - start;
+    verify("CMAC", reference, hash, 16);
+
+    start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        btstack_aes128_cmac_calc(app_key, CMAC_MESSAGE_LEN, cmac_message, hash);
+    }
+    double sync_duration = time_now() - start;
+    verify("CMAC", reference, hash, 16);
+
+    printf("CMAC: %u bytes\n", CMAC_MESSAGE_LEN);
+    printf("- Reference (key expansion per block): %10.0f messages/s\n", NUM_ITERATIONS / reference_duration);
+    printf("- btstack_crypto_aes128_cmac_message:  %10.0f messages/s\n", NUM_ITERATIONS / async_duration);
+    printf("- btstack_aes128_cmac_calc:            %10.0f messages/s\n", NUM_ITERATIONS / sync_duration);
+}
+
+int main(int argc, const char * argv[]){
+    (void) argc;
+    (void) argv;
+    unsigned int i;
+    for (i = 0; i < sizeof(plaintext); i++){
+        plaintext[i] = (uint8_t) (i * 7);
+    }
+    for (i = 0; i < sizeof(cmac_message); i++){
+        cmac_message[i] = (uint8_t) (i * 13);
+    }
+    btstack_crypto_init();
+    benchmark_ccm("Network PDU",          encryption_key, network_nonce, NULL,       0,                  NETWORK_PDU_LEN, NET_MIC_LEN);
+    benchmark_ccm("Upper Transport PDU",  app_key,        app_nonce,     label_uuid, sizeof(label_uuid), ACCESS_PDU_LEN,  TRANS_MIC_LEN);
+    benchmark_cmac();
+    return EXIT_SUCCESS;
+}
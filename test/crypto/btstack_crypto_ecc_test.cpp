@@ -0,0 +1,285 @@
+//
+// btstack_crypto ECC P-256 test with executor
+//
+// Simulates several concurrent LE Secure Connections pairings on a main loop that also services a periodic
+// ACL tick. Without executor, uECC runs on the main thread and delays the tick, with the POSIX worker
+// executor, the main thread stays responsive. The max tick gap is reported as ACL jitter.
+//
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "btstack_crypto.h"
+#include "btstack_crypto_worker_posix.h"
+#include "btstack_linked_list.h"
+#include "btstack_run_loop.h"
+#include "btstack_util.h"
+#include "hci.h"
+#include "hci_cmd.h"
+#include "uECC.h"
+
+#define NUM_PAIRINGS   4
+#define ACL_TICK_US 1000
+
+// default from btstack_crypto.c
+#ifndef BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE
+#define BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE 2
+#endif
+
+typedef struct {
+    btstack_crypto_ecc_p256_t request;
+    uint8_t peer_private_key[32];
+    uint8_t peer_public_key[64];
+    uint8_t dhkey[32];
+    bool    done;
+} pairing_t;
+
+static pairing_t pairings[NUM_PAIRINGS];
+static uint16_t  pairings_done;
+static uint16_t  le_rand_sent_at_key_generated;
+
+// single local key pair for all pairings, as in sm.c
+static btstack_crypto_ecc_p256_t key_request;
+static uint8_t local_public_key[64];
+
+static btstack_packet_callback_registration_t * crypto_event_handler;
+static uint16_t le_rand_pending;
+static uint16_t le_rand_sent;
+static uint32_t random_state = 0x12345678;
+
+static pthread_mutex_t main_thread_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  main_thread_cond  = PTHREAD_COND_INITIALIZER;
+static btstack_linked_list_t main_thread_callbacks;
+
+static uint32_t time_us(void){
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t) ((tv.tv_sec * 1000000) + tv.tv_usec);
+}
+
+// mock hci.c
+extern "C" void hci_add_event_handler(btstack_packet_callback_registration_t * callback_handler){
+    crypto_event_handler = callback_handler;
+}
+extern "C" bool hci_can_send_command_packet_now(void){
+    return le_rand_pending == 0;
+}
+extern "C" HCI_STATE hci_get_state(void){
+    return HCI_STATE_WORKING;
+}
+extern "C" uint8_t hci_send_cmd(const hci_cmd_t * cmd, ...){
+    CHECK_EQUAL(hci_le_rand.opcode, cmd->opcode);
+    le_rand_pending++;
+    le_rand_sent++;
+    return ERROR_CODE_SUCCESS;
+}
+extern "C" void hci_halting_defer(void){
+}
+
+// mock btstack_run_loop.c
+extern "C" void btstack_run_loop_execute_on_main_thread(btstack_context_callback_registration_t * callback_registration){
+    pthread_mutex_lock(&main_thread_mutex);
+    btstack_linked_list_add_tail(&main_thread_callbacks, (btstack_linked_item_t *) callback_registration);
+    pthread_cond_signal(&main_thread_cond);
+    pthread_mutex_unlock(&main_thread_mutex);
+}
+
+static void simulate_le_rand_complete(void){
+    uint8_t event[14] = { HCI_EVENT_COMMAND_COMPLETE, 12, 1, 0, 0, 0 };
+    little_endian_store_16(event, 3, hci_le_rand.opcode);
+    uint16_t i;
+    for (i = 6; i < sizeof(event); i++){
+        random_state = (random_state * 1103515245u) + 12345u;
+        event[i] = (uint8_t) (random_state >> 16);
+    }
+    le_rand_pending--;
+    (*crypto_event_handler->callback)(HCI_EVENT_PACKET, 0, event, sizeof(event));
+}
+
+// @return max time between ACL ticks in us
+static uint32_t main_loop_run(bool (*done)(void)){
+    uint32_t last_tick = time_us();
+    uint32_t max_gap = 0;
+    while (true){
+        uint32_t now = time_us();
+        max_gap = btstack_max(max_gap, now - last_tick);
+        last_tick = now;
+
+        if (le_rand_pending > 0){
+            simulate_le_rand_complete();
+            continue;
+        }
+
+        // wait for callbacks from worker or next ACL tick
+        pthread_mutex_lock(&main_thread_mutex);
+        if (btstack_linked_list_empty(&main_thread_callbacks)){
+            struct timeval tv;
+            gettimeofday(&tv, NULL);
+            uint32_t usec = (uint32_t) tv.tv_usec + ACL_TICK_US;
+            struct timespec timeout;
+            timeout.tv_sec  = tv.tv_sec + (usec / 1000000);
+            timeout.tv_nsec = (long) (usec % 1000000) * 1000;
+            pthread_cond_timedwait(&main_thread_cond, &main_thread_mutex, &timeout);
+        }
+        btstack_context_callback_registration_t * callback_registration =
+                (btstack_context_callback_registration_t *) btstack_linked_list_pop(&main_thread_callbacks);
+        pthread_mutex_unlock(&main_thread_mutex);
+        if (callback_registration != NULL){
+            (*callback_registration->callback)(callback_registration->context);
+        }
+
+        if ((*done)()) break;
+    }
+    return max_gap;
+}
+
+static bool pairings_complete(void){
+    return pairings_done == NUM_PAIRINGS;
+}
+
+static bool crypto_idle(void){
+    return btstack_crypto_idle() != 0;
+}
+
+static bool key_pool_filled(void){
+    // random request + 64 random bytes for each key pair
+    return btstack_crypto_idle() && (le_rand_sent >= (1 + (BTSTACK_CRYPTO_ECC_P256_KEY_POOL_SIZE * 8)));
+}
+
+static void random_generated(void * arg){
+    UNUSED(arg);
+}
+
+static void dhkey_calculated(void * arg){
+    pairing_t * pairing = (pairing_t *) arg;
+    pairing->done = true;
+    pairings_done++;
+}
+
+static void key_generated(void * arg){
+    UNUSED(arg);
+    le_rand_sent_at_key_generated = le_rand_sent;
+    // start concurrent pairings
+    uint16_t i;
+    for (i = 0; i < NUM_PAIRINGS; i++){
+        pairing_t * pairing = &pairings[i];
+        btstack_crypto_ecc_p256_calculate_dhkey(&pairing->request, pairing->peer_public_key, pairing->dhkey, &dhkey_calculated, pairing);
+    }
+}
+
+// AES128 request queued after DH key calculations
+static btstack_crypto_aes128_t aes128_request;
+static const uint8_t aes128_key[16] = { 0 };
+static const uint8_t aes128_plaintext[16] = { 0 };
+static uint8_t  aes128_ciphertext[16];
+static bool     aes128_done;
+static uint16_t pairings_done_at_aes128_done;
+
+static void aes128_calculated(void * arg){
+    UNUSED(arg);
+    aes128_done = true;
+    pairings_done_at_aes128_done = pairings_done;
+}
+
+static void key_generated_with_aes128(void * arg){
+    key_generated(arg);
+    btstack_crypto_aes128_encrypt(&aes128_request, aes128_key, aes128_plaintext, aes128_ciphertext, &aes128_calculated, NULL);
+}
+
+static uint32_t run_pairings(void){
+    btstack_crypto_ecc_p256_generate_key(&key_request, local_public_key, &key_generated, NULL);
+    return main_loop_run(&pairings_complete);
+}
+
+static void verify_pairings(void){
+    // uECC RNG is shared with worker, wait for pending key pool job
+    main_loop_run(&crypto_idle);
+    uint16_t i;
+    for (i = 0; i < NUM_PAIRINGS; i++){
+        CHECK(pairings[i].done);
+        uint8_t expected_dhkey[32];
+        CHECK(uECC_shared_secret(local_public_key, pairings[i].peer_private_key, expected_dhkey));
+        MEMCMP_EQUAL(expected_dhkey, pairings[i].dhkey, 32);
+    }
+}
+
+TEST_GROUP(ECC_EXECUTOR){
+    void setup(void){
+        memset(pairings, 0, sizeof(pairings));
+        pairings_done = 0;
+        le_rand_pending = 0;
+        le_rand_sent = 0;
+        uint16_t i;
+        for (i = 0; i < NUM_PAIRINGS; i++){
+            memset(pairings[i].peer_private_key, 0x11 * (i + 1), 32);
+            CHECK(uECC_compute_public_key(pairings[i].peer_private_key, pairings[i].peer_public_key));
+        }
+        btstack_crypto_ecc_p256_set_executor(NULL);
+        btstack_crypto_init();
+    }
+    void teardown(void){
+        btstack_crypto_ecc_p256_set_executor(NULL);
+        btstack_crypto_reset();
+    }
+};
+
+TEST(ECC_EXECUTOR, MainThread){
+    run_pairings();
+    verify_pairings();
+    // 64 random bytes for key generation, no key pool
+    CHECK_EQUAL(8, le_rand_sent);
+}
+
+TEST(ECC_EXECUTOR, Worker){
+    btstack_crypto_ecc_p256_set_executor(btstack_crypto_worker_posix_get_instance());
+    run_pairings();
+    verify_pairings();
+}
+
+TEST(ECC_EXECUTOR, KeyPool){
+    btstack_crypto_ecc_p256_set_executor(btstack_crypto_worker_posix_get_instance());
+    // key pool is filled when idle
+    btstack_crypto_random_t random_request;
+    uint8_t random[8];
+    btstack_crypto_random_generate(&random_request, random, sizeof(random), &random_generated, NULL);
+    main_loop_run(&key_pool_filled);
+    uint16_t le_rand_sent_before_pairing = le_rand_sent;
+    // key generation uses key pair from pool without random data from controller
+    run_pairings();
+    verify_pairings();
+    CHECK_EQUAL(le_rand_sent_before_pairing, le_rand_sent_at_key_generated);
+}
+
+TEST(ECC_EXECUTOR, OperationsDuringJob){
+    btstack_crypto_ecc_p256_set_executor(btstack_crypto_worker_posix_get_instance());
+    aes128_done = false;
+    btstack_crypto_ecc_p256_generate_key(&key_request, local_public_key, &key_generated_with_aes128, NULL);
+    main_loop_run(&pairings_complete);
+    verify_pairings();
+    // AES128 does not wait for queued DH key calculations
+    CHECK(aes128_done);
+    CHECK_EQUAL(0, pairings_done_at_aes128_done);
+}
+
+TEST(ECC_EXECUTOR, AclJitter){
+    uint32_t main_thread_max_gap_us = run_pairings();
+    verify_pairings();
+    teardown();
+    setup();
+    btstack_crypto_ecc_p256_set_executor(btstack_crypto_worker_posix_get_instance());
+    uint32_t worker_max_gap_us = run_pairings();
+    verify_pairings();
+    printf("ECC P-256, %u concurrent pairings: max ACL tick gap %u us on main thread, %u us with worker\n",
+           NUM_PAIRINGS, main_thread_max_gap_us, worker_max_gap_us);
+    CHECK(worker_max_gap_us < main_thread_max_gap_us);
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
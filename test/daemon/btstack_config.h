@@ -0,0 +1,26 @@
+//
+// btstack_config.h for socket connection benchmark
+//
+
+#ifndef BTSTACK_CONFIG_H
+#define BTSTACK_CONFIG_H
+
+// Port related features
+#define HAVE_MALLOC
+#define HAVE_POSIX_FILE_IO
+#define HAVE_POSIX_TIME
+#define HAVE_UNIX_SOCKETS
+
+// BTstack features that can be enabled
+#define ENABLE_BLE
+#define ENABLE_CLASSIC
+#define ENABLE_LE_CENTRAL
+#define ENABLE_LOG_ERROR
+
+// BTstack configuration. buffers, sizes, ..
+#define HCI_ACL_PAYLOAD_SIZE 1021
+
+// Daemon configuration
+#define BTSTACK_UNIX "/tmp/btstack_socket_connection_benchmark"
+
+#endif
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+
+// *****************************************************************************
+//
+// Socket Connection Benchmark
+//
+// 16 clients connect to a unix domain socket and subscribe to a stream of LE Advertising
+// Reports, which is sent to all clients from the posix run loop. One client stops reading.
+// Overflow policy is selected on the command line (drop or disconnect). Reports delivered
+// reports/s, write system calls per packet and the stalled client's counters.
+//
+// *****************************************************************************
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "btstack_defines.h"
+#include "btstack_run_loop.h"
+#include "btstack_run_loop_posix.h"
+#include "btstack_util.h"
+#include "daemon_cmds.h"
+#include "socket_connection.h"
+
+#define NUM_CLIENTS        16
+#define STALLED_CLIENT      0
+#define NUM_REPORTS     20000
+#define BURST_SIZE         32
+#define HIGH_WATER_MARK  (64 * 1024)
+#define REPORT_SIZE        45
+#define PACKET_SIZE        (6 + REPORT_SIZE)
+
+typedef struct {
+    pthread_t      thread;
+    int            fd;
+    uint32_t       bytes_received;
+    connection_t * connection;
+    int            closed;
+    socket_connection_statistics_t statistics;
+} client_t;
+
+static client_t clients[NUM_CLIENTS];
+static uint16_t clients_connected;
+static pthread_mutex_t clients_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int      stop_clients;
+
+static char     socket_path[64];
+static uint32_t reports_sent;
+static uint8_t  report[REPORT_SIZE];
+static btstack_timer_source_t stream_timer;
+static double   time_start;
+static double   time_stop;
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+static void * client_thread(void * context){
+    client_t * client = (client_t *) context;
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    if (connect(client->fd, (struct sockaddr *) &addr, sizeof(addr))){
+        fprintf(stderr, "Failed to connect to %s\n", socket_path);
+        exit(EXIT_FAILURE);
+    }
+    if (client == &clients[STALLED_CLIENT]){
+        // don't read
+        while (stop_clients == 0){
+            usleep(1000);
+        }
+        return NULL;
+    }
+    uint8_t buffer[16 * 1024];
+    while (1){
+        ssize_t res = read(client->fd, buffer, sizeof(buffer));
+        if (res <= 0) break;
+        pthread_mutex_lock(&clients_mutex);
+        client->bytes_received += (uint32_t) res;
+        pthread_mutex_unlock(&clients_mutex);
+    }
+    return NULL;
+}
+
+// connect from client thread, run loop is not running yet
+static void start_client(client_t * client){
+    memset(client, 0, sizeof(client_t));
+    client->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (client->fd < 0){
+        fprintf(stderr, "Failed to create socket\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_create(&client->thread, NULL, &client_thread, client);
+}
+
+static client_t * client_for_connection(connection_t * connection){
+    uint16_t i;
+    for (i = 0; i < NUM_CLIENTS; i++){
+        if (clients[i].connection == connection) return &clients[i];
+    }
+    return NULL;
+}
+
+// all packets written to non-stalled clients have been received
+static int stream_delivered(void){
+    int delivered = 1;
+    uint16_t i;
+    pthread_mutex_lock(&clients_mutex);
+    for (i = 0; i < NUM_CLIENTS; i++){
+        if (i == STALLED_CLIENT) continue;
+        socket_connection_statistics_t statistics;
+        socket_connection_get_statistics(clients[i].connection, &statistics);
+        if (clients[i].bytes_received < (statistics.packets_sent * PACKET_SIZE)){
+            delivered = 0;
+        }
+    }
+    pthread_mutex_unlock(&clients_mutex);
+    return delivered;
+}
+
+static void stream_handler(btstack_timer_source_t * ts){
+    if (clients_connected < NUM_CLIENTS){
+        btstack_run_loop_set_timer(ts, 1);
+        btstack_run_loop_add_timer(ts);
+        return;
+    }
+    if (reports_sent == 0){
+        time_start = time_now();
+    }
+    if (reports_sent < NUM_REPORTS){
+        uint16_t i;
+        for (i = 0; i < BURST_SIZE; i++){
+            report[14] = (uint8_t) reports_sent;
+            socket_connection_send_packet_all(HCI_EVENT_PACKET, 0, report, sizeof(report));
+            reports_sent++;
+        }
+        btstack_run_loop_set_timer(ts, 0);
+        btstack_run_loop_add_timer(ts);
+        return;
+    }
+    if (stream_delivered() == 0){
+        btstack_run_loop_set_timer(ts, 1);
+        btstack_run_loop_add_timer(ts);
+        return;
+    }
+    time_stop = time_now();
+    btstack_run_loop_trigger_exit();
+}
+
+static int packet_handler(connection_t * connection, uint16_t packet_type, uint16_t channel, uint8_t * data, uint16_t length){
+    UNUSED(channel);
+    UNUSED(length);
+    if (packet_type != DAEMON_EVENT_PACKET) return 0;
+    switch (data[0]){
+        case DAEMON_EVENT_CONNECTION_OPENED:
+            clients[clients_connected++].connection = connection;
+            break;
+        case DAEMON_EVENT_CONNECTION_CLOSED: {
+            client_t * client = client_for_connection(connection);
+            if (client == NULL) break;
+            socket_connection_get_statistics(connection, &client->statistics);
+            client->closed = 1;
+            client->connection = NULL;
+            break;
+        }
+        default:
+            break;
+    }
+    return 0;
+}
+
+static void run_benchmark(socket_connection_overflow_policy_t policy, const char * policy_name){
+    snprintf(socket_path, sizeof(socket_path), "/tmp/socket_connection_benchmark_%u", (unsigned int) getpid());
+    socket_connection_set_default_high_water_mark(HIGH_WATER_MARK, policy);
+    if (socket_connection_create_unix(socket_path) < 0){
+        fprintf(stderr, "Failed to create %s\n", socket_path);
+        exit(EXIT_FAILURE);
+    }
+
+    uint16_t i;
+    for (i = 0; i < NUM_CLIENTS; i++){
+        start_client(&clients[i]);
+    }
+
+    btstack_run_loop_set_timer_handler(&stream_timer, &stream_handler);
+    btstack_run_loop_set_timer(&stream_timer, 1);
+    btstack_run_loop_add_timer(&stream_timer);
+    btstack_run_loop_execute();
+
+    // collect counters
+    socket_connection_statistics_t sum;
+    memset(&sum, 0, sizeof(sum));
+    for (i = 0; i < NUM_CLIENTS; i++){
+        if (clients[i].connection != NULL){
+            socket_connection_get_statistics(clients[i].connection, &clients[i].statistics);
+        }
+        if (i == STALLED_CLIENT) continue;
+        sum.packets_sent    += clients[i].statistics.packets_sent;
+        sum.packets_queued  += clients[i].statistics.packets_queued;
+        sum.packets_dropped += clients[i].statistics.packets_dropped;
+        sum.write_calls     += clients[i].statistics.write_calls;
+    }
+    const socket_connection_statistics_t * stalled = &clients[STALLED_CLIENT].statistics;
+    double duration = time_stop - time_start;
+
+    fprintf(stderr, "Socket connection, %u clients, %u reports of %u bytes, high-water mark %u, policy %s\n",
+            NUM_CLIENTS, NUM_REPORTS, REPORT_SIZE, HIGH_WATER_MARK, policy_name);
+    fprintf(stderr, "- %10.0f reports/s delivered to each of %u reading clients\n", NUM_REPORTS / duration, NUM_CLIENTS - 1);
+    fprintf(stderr, "- %10.3f write calls per packet, %u of %u packets queued, %u dropped\n",
+            (double) sum.write_calls / sum.packets_sent, sum.packets_queued, sum.packets_sent, sum.packets_dropped);
+    fprintf(stderr, "- stalled client: %u packets sent, %u dropped, max %u bytes pending, %s\n",
+            stalled->packets_sent, stalled->packets_dropped, stalled->output_max,
+            clients[STALLED_CLIENT].closed ? "disconnected" : "connected");
+
+    // close connections
+    for (i = 0; i < NUM_CLIENTS; i++){
+        if (clients[i].connection != NULL){
+            socket_connection_close_tcp(clients[i].connection);
+        }
+    }
+    stop_clients = 1;
+    for (i = 0; i < NUM_CLIENTS; i++){
+        shutdown(clients[i].fd, SHUT_RDWR);
+        pthread_join(clients[i].thread, NULL);
+        close(clients[i].fd);
+    }
+    unlink(socket_path);
+}
+
+int main(int argc, const char * argv[]){
+    socket_connection_overflow_policy_t policy = SOCKET_CONNECTION_OVERFLOW_DROP;
+    const char * policy_name = "DROP";
+    if ((argc > 1) && (strcmp(argv[1], "disconnect") == 0)){
+        policy = SOCKET_CONNECTION_OVERFLOW_DISCONNECT;
+        policy_name = "DISCONNECT";
+    }
+
+    // LE Advertising Report with 31 bytes advertising data
+    report[0] = HCI_EVENT_LE_META;
+    report[1] = REPORT_SIZE - 2;
+    report[2] = HCI_SUBEVENT_LE_ADVERTISING_REPORT;
+    report[3] = 1;
+    report[12] = 31;
+
+    btstack_run_loop_init(btstack_run_loop_posix_get_instance());
+    socket_connection_init();
+    socket_connection_register_packet_callback(&packet_handler);
+
+    run_benchmark(policy, policy_name);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+
+// *****************************************************************************
+//
+// Socket Connection Shared Memory Benchmark
+//
+// Daemon and client run in separate processes connected via unix domain socket, optionally
+// switched to shared memory rings. As in l2cap_throughput.c, the payload are L2CAP packets
+// with 1000 bytes. Reports round trip time for small packets echoed by the daemon,
+// throughput of a credit based L2CAP stream from daemon to client and daemon write calls per packet.
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/wait.h>
+
+#include "btstack_client.h"
+#include "btstack_defines.h"
+#include "btstack_run_loop.h"
+#include "btstack_run_loop_posix.h"
+#include "btstack_util.h"
+#include "daemon_cmds.h"
+#include "socket_connection.h"
+
+#define NUM_ROUND_TRIPS     20000
+#define NUM_STREAM_PACKETS 100000
+#define PACKET_SIZE          1000
+#define WINDOW_SIZE            32
+#define RING_SIZE    (128 * 1024)
+
+// L2CAP channels used by benchmark
+#define CHANNEL_PING         1
+#define CHANNEL_STREAM_START 2
+#define CHANNEL_STREAM       3
+#define CHANNEL_CREDITS      4
+
+static uint8_t  packet[PACKET_SIZE];
+
+// daemon
+static uint32_t stream_remaining;
+static uint32_t stream_credits;
+static uint32_t daemon_packets_sent;
+
+// client
+static connection_t * client_connection;
+static int      use_shared_memory;
+static uint32_t round_trips;
+static uint32_t stream_received;
+static uint32_t stream_credits_pending;
+static uint32_t stream_errors;
+static double   time_start;
+static double   round_trip_us;
+static double   stream_mbytes_per_s;
+static btstack_timer_source_t start_timer;
+static uint32_t start_timer_ticks;
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+static void daemon_stream(connection_t * connection){
+    while ((stream_credits > 0) && (stream_remaining > 0)){
+        big_endian_store_32(packet, 0, stream_remaining);
+        socket_connection_send_packet(connection, L2CAP_DATA_PACKET, CHANNEL_STREAM, packet, PACKET_SIZE);
+        stream_credits--;
+        stream_remaining--;
+        daemon_packets_sent++;
+    }
+}
+
+static int daemon_packet_handler(connection_t * connection, uint16_t packet_type, uint16_t channel, uint8_t * data, uint16_t length){
+    if (packet_type == DAEMON_EVENT_PACKET){
+        if (data[0] == DAEMON_EVENT_CONNECTION_CLOSED){
+            socket_connection_statistics_t statistics;
+            socket_connection_get_statistics(connection, &statistics);
+            fprintf(stderr, "- %10.3f daemon write calls per packet\n", (double) statistics.write_calls / daemon_packets_sent);
+            btstack_run_loop_trigger_exit();
+        }
+        return 0;
+    }
+    if (packet_type != L2CAP_DATA_PACKET) return 0;
+    switch (channel){
+        case CHANNEL_PING:
+            socket_connection_send_packet(connection, L2CAP_DATA_PACKET, CHANNEL_PING, data, length);
+            daemon_packets_sent++;
+            break;
+        case CHANNEL_STREAM_START:
+            stream_remaining = little_endian_read_32(data, 0);
+            stream_credits   = WINDOW_SIZE;
+            daemon_stream(connection);
+            break;
+        case CHANNEL_CREDITS:
+            stream_credits += little_endian_read_16(data, 0);
+            daemon_stream(connection);
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+static void run_daemon(void){
+    btstack_run_loop_init(btstack_run_loop_posix_get_instance());
+    socket_connection_init();
+    socket_connection_register_packet_callback(&daemon_packet_handler);
+    if (socket_connection_create_unix(BTSTACK_UNIX) < 0){
+        fprintf(stderr, "Failed to create %s\n", BTSTACK_UNIX);
+        exit(EXIT_FAILURE);
+    }
+    btstack_run_loop_execute();
+    unlink(BTSTACK_UNIX);
+}
+
+static void client_send_ping(void){
+    uint8_t ping[8];
+    big_endian_store_32(ping, 0, round_trips);
+    big_endian_store_32(ping, 4, 0);
+    socket_connection_send_packet(client_connection, L2CAP_DATA_PACKET, CHANNEL_PING, ping, sizeof(ping));
+}
+
+static int client_packet_handler(connection_t * connection, uint16_t packet_type, uint16_t channel, uint8_t * data, uint16_t length){
+    if (packet_type != L2CAP_DATA_PACKET) return 0;
+    uint8_t buffer[4];
+    switch (channel){
+        case CHANNEL_PING:
+            round_trips++;
+            if (round_trips < NUM_ROUND_TRIPS){
+                client_send_ping();
+                break;
+            }
+            round_trip_us = ((time_now() - time_start) * 1000000.0) / NUM_ROUND_TRIPS;
+            // start stream
+            time_start = time_now();
+            little_endian_store_32(buffer, 0, NUM_STREAM_PACKETS);
+            socket_connection_send_packet(connection, L2CAP_DATA_PACKET, CHANNEL_STREAM_START, buffer, 4);
+            break;
+        case CHANNEL_STREAM:
+            if ((length != PACKET_SIZE) || (big_endian_read_32(data, 0) != (NUM_STREAM_PACKETS - stream_received))
+            ||  (memcmp(&data[4], &packet[4], PACKET_SIZE - 4) != 0)){
+                stream_errors++;
+            }
+            stream_received++;
+            if (stream_received == NUM_STREAM_PACKETS){
+                stream_mbytes_per_s = ((double) NUM_STREAM_PACKETS * PACKET_SIZE) / ((time_now() - time_start) * 1000000.0);
+                btstack_run_loop_trigger_exit();
+                break;
+            }
+            // return credits for half of the window
+            stream_credits_pending++;
+            if (stream_credits_pending == (WINDOW_SIZE / 2)){
+                little_endian_store_16(buffer, 0, stream_credits_pending);
+                socket_connection_send_packet(connection, L2CAP_DATA_PACKET, CHANNEL_CREDITS, buffer, 2);
+                stream_credits_pending = 0;
+            }
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+// wait for shared memory transport to become active
+static void start_timer_handler(btstack_timer_source_t * ts){
+    if (use_shared_memory && (socket_connection_shared_memory_active(client_connection) == 0)){
+        if (++start_timer_ticks > 1000){
+            fprintf(stderr, "Shared memory not available\n");
+            exit(EXIT_FAILURE);
+        }
+        btstack_run_loop_set_timer(ts, 1);
+        btstack_run_loop_add_timer(ts);
+        return;
+    }
+    time_start = time_now();
+    client_send_ping();
+}
+
+static void run_client(void){
+    btstack_run_loop_init(btstack_run_loop_posix_get_instance());
+    socket_connection_init();
+    socket_connection_register_packet_callback(&client_packet_handler);
+
+    // wait for daemon
+    int i;
+    for (i = 0; (i < 200) && (client_connection == NULL); i++){
+        usleep(10000);
+        client_connection = socket_connection_open_unix();
+    }
+    if (client_connection == NULL){
+        fprintf(stderr, "Failed to connect to %s\n", BTSTACK_UNIX);
+        exit(EXIT_FAILURE);
+    }
+    if (use_shared_memory && (socket_connection_request_shared_memory(client_connection, RING_SIZE) != 0)){
+        fprintf(stderr, "Failed to request shared memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    btstack_run_loop_set_timer_handler(&start_timer, &start_timer_handler);
+    btstack_run_loop_set_timer(&start_timer, 1);
+    btstack_run_loop_add_timer(&start_timer);
+    btstack_run_loop_execute();
+
+    fprintf(stderr, "Socket connection, transport %s\n", use_shared_memory ? "shared memory" : "unix socket");
+    fprintf(stderr, "- %10.1f us round trip for %u byte packets\n", round_trip_us, 8);
+    fprintf(stderr, "- %10.1f MB/s L2CAP stream with %u byte packets, window %u\n", stream_mbytes_per_s, PACKET_SIZE, WINDOW_SIZE);
+    fflush(stderr);
+    socket_connection_close_unix(client_connection);
+    if (stream_errors > 0){
+        fprintf(stderr, "%u corrupted packets\n", stream_errors);
+        exit(EXIT_FAILURE);
+    }
+}
+
+int main(int argc, const char * argv[]){
+    use_shared_memory = (argc > 1) && (strcmp(argv[1], "shm") == 0);
+
+    int i;
+    for (i = 4; i < PACKET_SIZE; i++){
+        packet[i] = (uint8_t) (i - 4);
+    }
+
+    unlink(BTSTACK_UNIX);
+    pid_t pid = fork();
+    if (pid < 0){
+        fprintf(stderr, "fork failed\n");
+        return EXIT_FAILURE;
+    }
+    if (pid == 0){
+        run_daemon();
+        return EXIT_SUCCESS;
+    }
+    run_client();
+    int status;
+    waitpid(pid, &status, 0);
+    return EXIT_SUCCESS;
+}
@@ -1,6 +1,7 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "btstack_util.h"
 #include "classic/hfp.h"
 
 int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
@@ -8,12 +9,22 @@ int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
     if (size < 1) return 0;
 
     int is_handsfree = data[0] & 1;
+    int use_buffer_parser = data[0] & 2;
     hfp_connection_t hfp_connection;
     memset(&hfp_connection, 0, sizeof(hfp_connection_t));
 
     uint32_t i;
-    for (i = 1; i < size; i++){
-        hfp_parse(&hfp_connection, data[i], is_handsfree);
+    if (use_buffer_parser){
+        const uint8_t * buffer = &data[1];
+        uint16_t buffer_size = (uint16_t) btstack_min((uint32_t) size - 1, 0xffff);
+        uint16_t pos = 0;
+        while (pos < buffer_size){
+            pos += hfp_parse_buffer(&hfp_connection, &buffer[pos], buffer_size - pos, is_handsfree);
+        }
+    } else {
+        for (i = 1; i < size; i++){
+            hfp_parse(&hfp_connection, data[i], is_handsfree);
+        }
     }
  
     return 0;
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+// *****************************************************************************
+//
+// HCI Event Dispatch Benchmark
+//
+// Replays a mix of LE Advertising Reports, Number Of Completed Packets and vendor specific events
+// through hci.c with an increasing number of registered handlers. Each handler is only interested
+// in a few events and is registered either as a regular HCI event handler that checks the event
+// type itself, or as an HCI event subscription. Reports dispatched events/s and handler calls.
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bluetooth_data_types.h"
+#include "btstack_event.h"
+#include "btstack_run_loop.h"
+#include "gap.h"
+#include "hci.h"
+
+#define NUM_EVENTS 300000
+
+static btstack_packet_callback_registration_t event_callback_registrations[HCI_EVENT_DISPATCH_MAX_HANDLERS];
+static hci_event_subscription_t               event_subscriptions[HCI_EVENT_DISPATCH_MAX_HANDLERS];
+
+static uint32_t handler_calls;
+static uint32_t events_handled;
+
+// hci transport
+static void (*transport_packet_handler)(uint8_t packet_type, uint8_t *packet, uint16_t size);
+static const uint8_t packet_sent_event[] = { HCI_EVENT_TRANSPORT_PACKET_SENT, 0};
+
+static int transport_can_send_now(uint8_t packet_type){
+    (void) packet_type;
+    return 1;
+}
+static int transport_send_packet(uint8_t packet_type, uint8_t * packet, int size){
+    (void) packet_type;
+    (void) packet;
+    (void) size;
+    transport_packet_handler(HCI_EVENT_PACKET, (uint8_t *) &packet_sent_event[0], sizeof(packet_sent_event));
+    return 0;
+}
+static void transport_register_packet_handler(void (*handler)(uint8_t packet_type, uint8_t *packet, uint16_t size)){
+    transport_packet_handler = handler;
+}
+static const hci_transport_t transport = {
+    "BENCHMARK", NULL, NULL, NULL, &transport_register_packet_handler, &transport_can_send_now, &transport_send_packet, NULL, NULL, NULL
+};
+
+// run loop with simulated time
+static uint32_t time_ms;
+static uint32_t run_loop_get_time_ms(void){
+    return time_ms;
+}
+static void run_loop_set_timer(btstack_timer_source_t * timer, uint32_t timeout_in_ms){
+    timer->timeout = time_ms + timeout_in_ms;
+}
+static const btstack_run_loop_t run_loop = {
+    &btstack_run_loop_base_init, NULL, NULL, NULL, NULL, &run_loop_set_timer, &btstack_run_loop_base_add_timer,
+    &btstack_run_loop_base_remove_timer, NULL, NULL, &run_loop_get_time_ms, NULL, NULL, NULL
+};
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+// each handler tracks stack state and disconnects, first handler also scans, second one sends data
+static bool handler_interested(uint16_t handler, uint8_t event_type){
+    switch (event_type){
+        case BTSTACK_EVENT_STATE:
+        case HCI_EVENT_DISCONNECTION_COMPLETE:
+            return true;
+        case GAP_EVENT_ADVERTISING_REPORT:
+            return handler == 0;
+        case HCI_EVENT_NUMBER_OF_COMPLETED_PACKETS:
+            return handler == 1;
+        default:
+            return false;
+    }
+}
+
+static void event_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
+    (void) size;
+    handler_calls++;
+    if (packet_type != HCI_EVENT_PACKET) return;
+    if (handler_interested(channel, hci_event_packet_get_type(packet))){
+        events_handled++;
+    }
+}
+
+static void handler_0(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){ (void) channel; event_handler(packet_type, 0, packet, size); }
+static void handler_1(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){ (void) channel; event_handler(packet_type, 1, packet, size); }
+static void handler_n(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){ (void) channel; event_handler(packet_type, 2, packet, size); }
+
+static btstack_packet_handler_t handler_for_index(uint16_t handler){
+    switch (handler){
+        case 0:
+            return &handler_0;
+        case 1:
+            return &handler_1;
+        default:
+            return &handler_n;
+    }
+}
+
+static void register_handlers(uint16_t num_handlers, bool use_subscriptions){
+    uint16_t i;
+    for (i = 0; i < num_handlers; i++){
+        if (use_subscriptions){
+            hci_event_subscription_t * subscription = &event_subscriptions[i];
+            hci_event_subscription_init(subscription, handler_for_index(i));
+            uint16_t event_type;
+            for (event_type = 0; event_type < 256u; event_type++){
+                if (handler_interested(i, (uint8_t) event_type)){
+                    hci_event_subscription_add_event(subscription, (uint8_t) event_type);
+                }
+            }
+            hci_add_event_subscription(subscription);
+        } else {
+            event_callback_registrations[i].callback = handler_for_index(i);
+            hci_add_event_handler(&event_callback_registrations[i]);
+        }
+    }
+}
+
+static uint16_t setup_advertising_report(uint8_t * event){
+    uint16_t pos = 0;
+    event[pos++] = HCI_EVENT_LE_META;
+    event[pos++] = 0;
+    event[pos++] = HCI_SUBEVENT_LE_ADVERTISING_REPORT;
+    event[pos++] = 1;
+    event[pos++] = 3;   // ADV_NONCONN_IND
+    event[pos++] = BD_ADDR_TYPE_LE_RANDOM;
+    static const bd_addr_t address = { 0xc0, 0x11, 0x22, 0x33, 0x44, 0x55 };
+    reverse_bd_addr(address, &event[pos]);
+    pos += 6;
+    event[pos++] = 3;
+    event[pos++] = 2;
+    event[pos++] = BLUETOOTH_DATA_TYPE_FLAGS;
+    event[pos++] = 0x06;
+    event[pos++] = (uint8_t) -60;
+    event[1] = (uint8_t) (pos - 2);
+    return pos;
+}
+
+// scanning while sending data: 50% advertising reports, 40% number of completed packets, 10% vendor specific events
+static double replay_events(void){
+    uint8_t advertising_report[32];
+    uint16_t advertising_report_len = setup_advertising_report(advertising_report);
+    uint8_t num_completed_packets[] = { HCI_EVENT_NUMBER_OF_COMPLETED_PACKETS, 5, 1, 0x40, 0x00, 0x00, 0x00 };
+    uint8_t vendor_specific[]       = { HCI_EVENT_VENDOR_SPECIFIC, 2, 0x12, 0x34 };
+    double start = time_now();
+    uint32_t i;
+    for (i = 0; i < NUM_EVENTS; i++){
+        switch (i % 10){
+            case 0: case 2: case 4: case 6: case 8:
+                transport_packet_handler(HCI_EVENT_PACKET, advertising_report, advertising_report_len);
+                break;
+            case 1: case 3: case 5: case 7:
+                transport_packet_handler(HCI_EVENT_PACKET, num_completed_packets, sizeof(num_completed_packets));
+                break;
+            default:
+                transport_packet_handler(HCI_EVENT_PACKET, vendor_specific, sizeof(vendor_specific));
+                break;
+        }
+    }
+    return time_now() - start;
+}
+
+static void run_benchmark(uint16_t num_handlers, bool use_subscriptions, double * events_per_second, double * handler_calls_per_event){
+    btstack_run_loop_init(&run_loop);
+    hci_init(&transport, NULL);
+    hci_simulate_working_fuzz();
+    gap_start_scan();
+    register_handlers(num_handlers, use_subscriptions);
+    handler_calls = 0;
+    events_handled = 0;
+    double duration = replay_events();
+    *events_per_second = NUM_EVENTS / duration;
+    *handler_calls_per_event = (double) handler_calls / NUM_EVENTS;
+    hci_deinit();
+    btstack_run_loop_deinit();
+}
+
+int main(int argc, const char * argv[]){
+    (void) argc;
+    (void) argv;
+    static const uint16_t handler_counts[] = { 1, 2, 4, 8, 16, 24, HCI_EVENT_DISPATCH_MAX_HANDLERS };
+    fprintf(stderr, "HCI event dispatch, %u events: event handlers vs. event subscriptions\n", NUM_EVENTS);
+    uint16_t i;
+    for (i = 0; i < (sizeof(handler_counts) / sizeof(handler_counts[0])); i++){
+        double handlers_events_per_second;
+        double handlers_calls_per_event;
+        double subscriptions_events_per_second;
+        double subscriptions_calls_per_event;
+        run_benchmark(handler_counts[i], false, &handlers_events_per_second, &handlers_calls_per_event);
+        run_benchmark(handler_counts[i], true, &subscriptions_events_per_second, &subscriptions_calls_per_event);
+        fprintf(stderr, "- %2u handlers: %10.0f vs %10.0f events/s, %5.2f vs %5.2f handler calls per event\n", handler_counts[i],
+                handlers_events_per_second, subscriptions_events_per_second, handlers_calls_per_event, subscriptions_calls_per_event);
+    }
+    return EXIT_SUCCESS;
+}
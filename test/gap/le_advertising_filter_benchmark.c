@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+// *****************************************************************************
+//
+// LE Advertising Report Filter Benchmark
+//
+// Replays a synthetic dense-scan workload - 400 beacons advertising 10 times per second for 10 seconds
+// of simulated time - through hci.c. Eight consumers are registered either as regular HCI event handlers
+// that parse the advertising data of each report themselves, or as LE Advertising Report Filters
+// with equivalent rules and duplicate suppression. Reports processed reports/s and handler calls.
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ad_parser.h"
+#include "bluetooth_company_id.h"
+#include "bluetooth_data_types.h"
+#include "btstack_event.h"
+#include "btstack_run_loop.h"
+#include "gap.h"
+#include "hci.h"
+
+#define NUM_BEACONS       400
+#define NUM_SLOTS         100
+#define SLOT_DURATION_MS  100
+#define NUM_CONSUMERS       8
+#define DUPLICATE_WINDOW_MS 1000
+#define NUM_DUPLICATE_ENTRIES 256
+
+#define EDDYSTONE_UUID16 0xFEAA
+
+static const uint8_t sensor_uuid128[] = { 0x12, 0x34, 0x56, 0x78, 0x12, 0x34, 0x56, 0x78, 0x12, 0x34, 0x56, 0x78, 0x12, 0x34, 0x56, 0x78 };
+
+typedef struct {
+    uint16_t manufacturer_id;
+    uint16_t uuid16;
+    const uint8_t * uuid128;
+    int8_t   rssi_threshold;
+    bool     address_valid;
+    bd_addr_t address;
+    bool     suppress_duplicates;
+} consumer_t;
+
+static consumer_t consumers[NUM_CONSUMERS];
+
+static gap_le_advertising_filter_t       filters[NUM_CONSUMERS];
+static gap_le_advertising_filter_entry_t filter_entries[NUM_CONSUMERS][NUM_DUPLICATE_ENTRIES];
+static btstack_packet_callback_registration_t event_callback_registrations[NUM_CONSUMERS];
+
+static uint32_t handler_calls;
+static uint32_t reports_accepted;
+
+// hci transport
+static void (*transport_packet_handler)(uint8_t packet_type, uint8_t *packet, uint16_t size);
+static const uint8_t packet_sent_event[] = { HCI_EVENT_TRANSPORT_PACKET_SENT, 0};
+
+static int transport_can_send_now(uint8_t packet_type){
+    (void) packet_type;
+    return 1;
+}
+static int transport_send_packet(uint8_t packet_type, uint8_t * packet, int size){
+    (void) packet_type;
+    (void) packet;
+    (void) size;
+    transport_packet_handler(HCI_EVENT_PACKET, (uint8_t *) &packet_sent_event[0], sizeof(packet_sent_event));
+    return 0;
+}
+static void transport_register_packet_handler(void (*handler)(uint8_t packet_type, uint8_t *packet, uint16_t size)){
+    transport_packet_handler = handler;
+}
+static const hci_transport_t transport = {
+    "BENCHMARK", NULL, NULL, NULL, &transport_register_packet_handler, &transport_can_send_now, &transport_send_packet, NULL, NULL, NULL
+};
+
+// run loop with simulated time
+static uint32_t time_ms;
+static uint32_t run_loop_get_time_ms(void){
+    return time_ms;
+}
+static void run_loop_set_timer(btstack_timer_source_t * timer, uint32_t timeout_in_ms){
+    timer->timeout = time_ms + timeout_in_ms;
+}
+static const btstack_run_loop_t run_loop = {
+    &btstack_run_loop_base_init, NULL, NULL, NULL, NULL, &run_loop_set_timer, &btstack_run_loop_base_add_timer,
+    &btstack_run_loop_base_remove_timer, NULL, NULL, &run_loop_get_time_ms, NULL, NULL, NULL
+};
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+static void setup_consumers(void){
+    memset(consumers, 0, sizeof(consumers));
+    // iBeacon tracker
+    consumers[0].manufacturer_id = BLUETOOTH_COMPANY_ID_APPLE_INC;
+    consumers[0].rssi_threshold = -80;
+    consumers[0].suppress_duplicates = true;
+    // Eddystone telemetry
+    consumers[1].uuid16 = EDDYSTONE_UUID16;
+    consumers[1].suppress_duplicates = true;
+    // sensors with custom service
+    consumers[2].uuid128 = sensor_uuid128;
+    // single known device
+    consumers[3].address_valid = true;
+    bd_addr_t address = { 0xc0, 0x00, 0x00, 0x00, 0x00, 0x07 };
+    bd_addr_copy(consumers[3].address, address);
+    // devices of other vendors that are not around
+    uint16_t i;
+    for (i = 4; i < NUM_CONSUMERS; i++){
+        consumers[i].manufacturer_id = 0x0100 + i;
+    }
+}
+
+// regular event handler: check rules on each report
+static bool consumer_match(const consumer_t * consumer, const uint8_t * packet){
+    if (consumer->address_valid){
+        bd_addr_t address;
+        gap_event_advertising_report_get_address(packet, address);
+        if (bd_addr_cmp(address, consumer->address) != 0) return false;
+    }
+    if (consumer->rssi_threshold != 0){
+        if ((int8_t) gap_event_advertising_report_get_rssi(packet) < consumer->rssi_threshold) return false;
+    }
+    uint8_t data_len = gap_event_advertising_report_get_data_length(packet);
+    const uint8_t * data = gap_event_advertising_report_get_data(packet);
+    if (consumer->uuid16 != 0){
+        if (ad_data_contains_uuid16(data_len, data, consumer->uuid16) == false) return false;
+    }
+    if (consumer->uuid128 != NULL){
+        if (ad_data_contains_uuid128(data_len, data, consumer->uuid128) == false) return false;
+    }
+    if (consumer->manufacturer_id != 0){
+        bool found = false;
+        ad_context_t context;
+        for (ad_iterator_init(&context, data_len, data) ; ad_iterator_has_more(&context) ; ad_iterator_next(&context)){
+            if ((ad_iterator_get_data_type(&context) == BLUETOOTH_DATA_TYPE_MANUFACTURER_SPECIFIC_DATA) &&
+                (little_endian_read_16(ad_iterator_get_data(&context), 0) == consumer->manufacturer_id)){
+                found = true;
+            }
+        }
+        if (found == false) return false;
+    }
+    return true;
+}
+
+static void consumer_event_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
+    (void) packet_type;
+    (void) size;
+    handler_calls++;
+    if (hci_event_packet_get_type(packet) != GAP_EVENT_ADVERTISING_REPORT) return;
+    if (consumer_match(&consumers[channel], packet)){
+        reports_accepted++;
+    }
+}
+
+static void consumer_0_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){ (void) channel; consumer_event_handler(packet_type, 0, packet, size); }
+static void consumer_1_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){ (void) channel; consumer_event_handler(packet_type, 1, packet, size); }
+static void consumer_2_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){ (void) channel; consumer_event_handler(packet_type, 2, packet, size); }
+static void consumer_3_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){ (void) channel; consumer_event_handler(packet_type, 3, packet, size); }
+static void consumer_4_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){ (void) channel; consumer_event_handler(packet_type, 4, packet, size); }
+static void consumer_5_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){ (void) channel; consumer_event_handler(packet_type, 5, packet, size); }
+static void consumer_6_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){ (void) channel; consumer_event_handler(packet_type, 6, packet, size); }
+static void consumer_7_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){ (void) channel; consumer_event_handler(packet_type, 7, packet, size); }
+
+static const btstack_packet_handler_t consumer_handlers[NUM_CONSUMERS] = {
+    &consumer_0_handler, &consumer_1_handler, &consumer_2_handler, &consumer_3_handler,
+    &consumer_4_handler, &consumer_5_handler, &consumer_6_handler, &consumer_7_handler,
+};
+
+// filter callback: report already matches
+static void consumer_filter_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
+    (void) packet_type;
+    (void) channel;
+    (void) packet;
+    (void) size;
+    handler_calls++;
+    reports_accepted++;
+}
+
+static void register_event_handlers(void){
+    uint16_t i;
+    for (i = 0; i < NUM_CONSUMERS; i++){
+        event_callback_registrations[i].callback = consumer_handlers[i];
+        hci_add_event_handler(&event_callback_registrations[i]);
+    }
+}
+
+static void register_filters(void){
+    uint16_t i;
+    for (i = 0; i < NUM_CONSUMERS; i++){
+        const consumer_t * consumer = &consumers[i];
+        gap_le_advertising_filter_t * filter = &filters[i];
+        gap_le_advertising_filter_init(filter, &consumer_filter_handler);
+        if (consumer->address_valid){
+            gap_le_advertising_filter_set_address(filter, BD_ADDR_TYPE_LE_RANDOM, consumer->address);
+        }
+        if (consumer->rssi_threshold != 0){
+            gap_le_advertising_filter_set_rssi_threshold(filter, consumer->rssi_threshold);
+        }
+        if (consumer->uuid16 != 0){
+            gap_le_advertising_filter_set_uuid16(filter, consumer->uuid16);
+        }
+        if (consumer->uuid128 != NULL){
+            gap_le_advertising_filter_set_uuid128(filter, consumer->uuid128);
+        }
+        if (consumer->manufacturer_id != 0){
+            gap_le_advertising_filter_set_manufacturer_id(filter, consumer->manufacturer_id);
+        }
+        if (consumer->suppress_duplicates){
+            gap_le_advertising_filter_set_duplicate_suppression(filter, DUPLICATE_WINDOW_MS, filter_entries[i], NUM_DUPLICATE_ENTRIES);
+        }
+        gap_le_add_advertising_filter(filter);
+    }
+}
+
+// setup advertising data for beacon: 60% iBeacon, 30% Eddystone TLM, 10% sensors. TLM and sensor data change every second
+static uint8_t setup_advertising_data(uint8_t * data, uint16_t beacon, uint16_t slot){
+    uint8_t pos = 0;
+    uint8_t counter = (uint8_t) (slot / (1000 / SLOT_DURATION_MS));
+    data[pos++] = 2;
+    data[pos++] = BLUETOOTH_DATA_TYPE_FLAGS;
+    data[pos++] = 0x06;
+    switch (beacon % 10){
+        case 0: case 1: case 2: case 3: case 4: case 5:
+            data[pos++] = 26;
+            data[pos++] = BLUETOOTH_DATA_TYPE_MANUFACTURER_SPECIFIC_DATA;
+            little_endian_store_16(data, pos, BLUETOOTH_COMPANY_ID_APPLE_INC);
+            pos += 2;
+            data[pos++] = 0x02;
+            data[pos++] = 0x15;
+            memset(&data[pos], 0x42, 16);
+            pos += 16;
+            big_endian_store_16(data, pos, 1);
+            pos += 2;
+            big_endian_store_16(data, pos, beacon);
+            pos += 2;
+            data[pos++] = 0xc5;
+            break;
+        case 6: case 7: case 8:
+            data[pos++] = 3;
+            data[pos++] = BLUETOOTH_DATA_TYPE_COMPLETE_LIST_OF_16_BIT_SERVICE_CLASS_UUIDS;
+            little_endian_store_16(data, pos, EDDYSTONE_UUID16);
+            pos += 2;
+            data[pos++] = 17;
+            data[pos++] = BLUETOOTH_DATA_TYPE_SERVICE_DATA_16_BIT_UUID;
+            little_endian_store_16(data, pos, EDDYSTONE_UUID16);
+            pos += 2;
+            data[pos++] = 0x20;
+            data[pos++] = 0x00;
+            memset(&data[pos], counter, 12);
+            pos += 12;
+            break;
+        default:
+            data[pos++] = 17;
+            data[pos++] = BLUETOOTH_DATA_TYPE_COMPLETE_LIST_OF_128_BIT_SERVICE_CLASS_UUIDS;
+            reverse_128(sensor_uuid128, &data[pos]);
+            pos += 16;
+            data[pos++] = 5;
+            data[pos++] = BLUETOOTH_DATA_TYPE_SERVICE_DATA_16_BIT_UUID;
+            little_endian_store_16(data, pos, 0x181a);
+            pos += 2;
+            data[pos++] = counter;
+            data[pos++] = (uint8_t) beacon;
+            break;
+    }
+    return pos;
+}
+
+static void receive_report(uint16_t beacon, uint16_t slot){
+    uint8_t event[2 + 1 + 1 + 1 + 1 + 6 + 1 + LE_ADVERTISING_DATA_SIZE + 1];
+    uint16_t pos = 0;
+    event[pos++] = HCI_EVENT_LE_META;
+    event[pos++] = 0;
+    event[pos++] = HCI_SUBEVENT_LE_ADVERTISING_REPORT;
+    event[pos++] = 1;
+    event[pos++] = 3;   // ADV_NONCONN_IND
+    event[pos++] = BD_ADDR_TYPE_LE_RANDOM;
+    bd_addr_t address = { 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    big_endian_store_16(address, 4, beacon);
+    reverse_bd_addr(address, &event[pos]);
+    pos += 6;
+    uint8_t data_len = setup_advertising_data(&event[pos + 1], beacon, slot);
+    event[pos++] = data_len;
+    pos += data_len;
+    event[pos++] = (uint8_t) (-40 - (int) (beacon % 60));
+    event[1] = (uint8_t) (pos - 2);
+    transport_packet_handler(HCI_EVENT_PACKET, event, pos);
+}
+
+// each beacon advertises once per slot, order within slot varies
+static double replay_workload(void){
+    uint32_t lcg = 1;
+    double start = time_now();
+    uint16_t slot;
+    for (slot = 0; slot < NUM_SLOTS; slot++){
+        uint16_t offset = (uint16_t) ((lcg >> 16) % NUM_BEACONS);
+        lcg = lcg * 1103515245u + 12345u;
+        uint16_t i;
+        for (i = 0; i < NUM_BEACONS; i++){
+            time_ms = (slot * SLOT_DURATION_MS) + ((i * SLOT_DURATION_MS) / NUM_BEACONS);
+            receive_report((offset + (i * 7u)) % NUM_BEACONS, slot);
+        }
+    }
+    return time_now() - start;
+}
+
+static void run_benchmark(const char * name, bool use_filters){
+    handler_calls = 0;
+    reports_accepted = 0;
+    btstack_run_loop_init(&run_loop);
+    hci_init(&transport, NULL);
+    hci_simulate_working_fuzz();
+    gap_start_scan();
+    if (use_filters){
+        register_filters();
+    } else {
+        register_event_handlers();
+    }
+    double duration = replay_workload();
+    uint32_t num_reports = NUM_BEACONS * NUM_SLOTS;
+    fprintf(stderr, "%s\n", name);
+    fprintf(stderr, "- %10.0f reports/s\n", num_reports / duration);
+    fprintf(stderr, "- %10.2f handler calls per report\n", (double) handler_calls / num_reports);
+    fprintf(stderr, "- %10u reports accepted by consumers\n", reports_accepted);
+    if (use_filters){
+        uint16_t i;
+        for (i = 0; i < NUM_CONSUMERS; i++){
+            const gap_le_advertising_filter_statistics_t * statistics = &filters[i].statistics;
+            fprintf(stderr, "- filter %u: %u received, %u rejected, %u duplicate, %u delivered\n", i,
+                    statistics->reports_received, statistics->reports_rejected, statistics->reports_duplicate, statistics->reports_delivered);
+        }
+    }
+    hci_deinit();
+    btstack_run_loop_deinit();
+}
+
+int main(int argc, const char * argv[]){
+    (void) argc;
+    (void) argv;
+    setup_consumers();
+    fprintf(stderr, "Dense scan, %u beacons, %u reports/s each, %u consumers\n", NUM_BEACONS, 1000 / SLOT_DURATION_MS, NUM_CONSUMERS);
+    run_benchmark("HCI event handlers", false);
+    run_benchmark("LE Advertising Report Filters", true);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,196 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "btstack_event.h"
+#include "btstack_run_loop.h"
+#include "hci.h"
+
+static  void (*packet_handler)(uint8_t packet_type, uint8_t *packet, uint16_t size);
+
+static const uint8_t packet_sent_event[] = { HCI_EVENT_TRANSPORT_PACKET_SENT, 0};
+
+static int hci_transport_test_can_send_now(uint8_t packet_type){
+    return 1;
+}
+
+static int hci_transport_test_send_packet(uint8_t packet_type, uint8_t * packet, int size){
+    // notify upper stack that it can send again
+    packet_handler(HCI_EVENT_PACKET, (uint8_t *) &packet_sent_event[0], sizeof(packet_sent_event));
+    return 0;
+}
+
+static void hci_transport_test_register_packet_handler(void (*handler)(uint8_t packet_type, uint8_t *packet, uint16_t size)){
+    packet_handler = handler;
+}
+
+static const hci_transport_t hci_transport_test = {
+        /* const char * name; */                                        "TEST",
+        /* void   (*init) (const void *transport_config); */            NULL,
+        /* int    (*open)(void); */                                     NULL,
+        /* int    (*close)(void); */                                    NULL,
+        /* void   (*register_packet_handler)(void (*handler)(...); */   &hci_transport_test_register_packet_handler,
+        /* int    (*can_send_packet_now)(uint8_t packet_type); */       &hci_transport_test_can_send_now,
+        /* int    (*send_packet)(...); */                               &hci_transport_test_send_packet,
+        /* int    (*set_baudrate)(uint32_t baudrate); */                NULL,
+        /* void   (*reset_link)(void); */                               NULL,
+        /* void   (*set_sco_config)(uint16_t voice_setting, int num_connections); */ NULL,
+};
+
+// run loop with simulated time
+static uint32_t time_ms;
+
+static uint32_t run_loop_test_get_time_ms(void){
+    return time_ms;
+}
+
+static void run_loop_test_set_timer(btstack_timer_source_t * timer, uint32_t timeout_in_ms){
+    timer->timeout = time_ms + timeout_in_ms;
+}
+
+static const btstack_run_loop_t run_loop_test = {
+    &btstack_run_loop_base_init,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    &run_loop_test_set_timer,
+    &btstack_run_loop_base_add_timer,
+    &btstack_run_loop_base_remove_timer,
+    NULL,
+    NULL,
+    &run_loop_test_get_time_ms,
+    NULL,
+    NULL,
+    NULL,
+};
+
+#define NUM_HANDLERS (HCI_EVENT_DISPATCH_MAX_HANDLERS + 4)
+
+static char    call_log[64];
+static uint8_t call_log_len;
+static btstack_packet_callback_registration_t * registration_to_remove;
+
+static void log_call(char id, uint8_t packet_type, uint8_t * packet){
+    CHECK_EQUAL(HCI_EVENT_PACKET, packet_type);
+    if (hci_event_packet_get_type(packet) == HCI_EVENT_TRANSPORT_PACKET_SENT) return;
+    if (call_log_len < (sizeof(call_log) - 1)){
+        call_log[call_log_len++] = id;
+        call_log[call_log_len] = 0;
+    }
+}
+
+static void handler_a(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
+    log_call('a', packet_type, packet);
+    if (registration_to_remove != NULL){
+        hci_remove_event_handler(registration_to_remove);
+        registration_to_remove = NULL;
+    }
+}
+static void handler_b(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
+    log_call('b', packet_type, packet);
+}
+static void handler_c(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
+    log_call('c', packet_type, packet);
+}
+
+static void receive_event(const uint8_t * event, uint16_t size){
+    call_log_len = 0;
+    call_log[0] = 0;
+    packet_handler(HCI_EVENT_PACKET, (uint8_t *) event, size);
+}
+
+static const uint8_t vendor_specific_event[]  = { HCI_EVENT_VENDOR_SPECIFIC, 2, 0x12, 0x34 };
+static const uint8_t transmit_power_event[]   = { HCI_EVENT_LE_META, 9, HCI_SUBEVENT_LE_TRANSMIT_POWER_REPORTING, 0, 0x40, 0, 0, 1, 0, 0, 0 };
+static const uint8_t subrate_change_event[]   = { HCI_EVENT_LE_META, 12, HCI_SUBEVENT_LE_SUBRATE_CHANGE, 0, 0x40, 0, 1, 0, 0, 0, 0, 0, 0, 0 };
+
+TEST_GROUP(HCI_EVENT_SUBSCRIPTION){
+    btstack_packet_callback_registration_t registration_a;
+    btstack_packet_callback_registration_t registration_c;
+    hci_event_subscription_t subscription_b;
+    void setup(void){
+        registration_to_remove = NULL;
+        btstack_run_loop_init(&run_loop_test);
+        hci_init(&hci_transport_test, NULL);
+        hci_simulate_working_fuzz();
+        registration_a.callback = &handler_a;
+        registration_c.callback = &handler_c;
+        hci_event_subscription_init(&subscription_b, &handler_b);
+    }
+    void teardown(void){
+        hci_deinit();
+        btstack_run_loop_deinit();
+    }
+};
+
+TEST(HCI_EVENT_SUBSCRIPTION, Order){
+    hci_event_subscription_add_event(&subscription_b, HCI_EVENT_VENDOR_SPECIFIC);
+    hci_add_event_handler(&registration_a);
+    hci_add_event_subscription(&subscription_b);
+    hci_add_event_handler(&registration_c);
+    receive_event(vendor_specific_event, sizeof(vendor_specific_event));
+    STRCMP_EQUAL("abc", call_log);
+    receive_event(transmit_power_event, sizeof(transmit_power_event));
+    STRCMP_EQUAL("ac", call_log);
+    hci_remove_event_subscription(&subscription_b);
+    receive_event(vendor_specific_event, sizeof(vendor_specific_event));
+    STRCMP_EQUAL("ac", call_log);
+}
+
+TEST(HCI_EVENT_SUBSCRIPTION, LeMetaSubevent){
+    hci_event_subscription_add_le_meta_subevent(&subscription_b, HCI_SUBEVENT_LE_SUBRATE_CHANGE);
+    hci_add_event_subscription(&subscription_b);
+    receive_event(subrate_change_event, sizeof(subrate_change_event));
+    STRCMP_EQUAL("b", call_log);
+    receive_event(transmit_power_event, sizeof(transmit_power_event));
+    STRCMP_EQUAL("", call_log);
+    receive_event(vendor_specific_event, sizeof(vendor_specific_event));
+    STRCMP_EQUAL("", call_log);
+}
+
+TEST(HCI_EVENT_SUBSCRIPTION, LeMetaEvent){
+    hci_event_subscription_add_event(&subscription_b, HCI_EVENT_LE_META);
+    hci_add_event_subscription(&subscription_b);
+    receive_event(subrate_change_event, sizeof(subrate_change_event));
+    STRCMP_EQUAL("b", call_log);
+    receive_event(transmit_power_event, sizeof(transmit_power_event));
+    STRCMP_EQUAL("b", call_log);
+}
+
+TEST(HCI_EVENT_SUBSCRIPTION, RemoveDuringDispatch){
+    hci_event_subscription_add_event(&subscription_b, HCI_EVENT_VENDOR_SPECIFIC);
+    hci_add_event_handler(&registration_a);
+    hci_add_event_subscription(&subscription_b);
+    hci_add_event_handler(&registration_c);
+    registration_to_remove = &registration_c;
+    receive_event(vendor_specific_event, sizeof(vendor_specific_event));
+    STRCMP_EQUAL("ab", call_log);
+    receive_event(vendor_specific_event, sizeof(vendor_specific_event));
+    STRCMP_EQUAL("ab", call_log);
+}
+
+TEST(HCI_EVENT_SUBSCRIPTION, ManyHandlers){
+    // more handlers than supported by dispatch tables
+    static btstack_packet_callback_registration_t registrations[NUM_HANDLERS];
+    uint16_t i;
+    for (i = 0; i < NUM_HANDLERS; i++){
+        registrations[i].callback = &handler_c;
+        hci_add_event_handler(&registrations[i]);
+    }
+    hci_event_subscription_add_event(&subscription_b, HCI_EVENT_VENDOR_SPECIFIC);
+    hci_add_event_subscription(&subscription_b);
+    receive_event(vendor_specific_event, sizeof(vendor_specific_event));
+    CHECK_EQUAL(NUM_HANDLERS + 1, call_log_len);
+    CHECK_EQUAL('b', call_log[NUM_HANDLERS]);
+    receive_event(transmit_power_event, sizeof(transmit_power_event));
+    CHECK_EQUAL(NUM_HANDLERS, call_log_len);
+    CHECK(strchr(call_log, 'b') == NULL);
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
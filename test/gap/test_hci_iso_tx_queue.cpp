@@ -0,0 +1,407 @@
+//
+// hci ISO TX queue test
+//
+// Simulated controller: HCI Commands for BIG setup are answered by the test, outgoing ISO packets are recorded
+// and completed by Number of Completed Packets events at simulated ISO intervals.
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "btstack_event.h"
+#include "btstack_run_loop.h"
+#include "btstack_util.h"
+#include "hci.h"
+#include "hci_cmd.h"
+
+#define MAX_HCI_PACKETS 64
+#define MAX_SDU_LEN     200
+#define NUM_SDUS        8
+#define BIG_HANDLE      1
+#define BIS_CON_HANDLE  0x0100
+#define SDU_INTERVAL_US 10000
+
+typedef struct {
+    uint8_t  type;
+    uint16_t size;
+    uint8_t  buffer[300];
+} hci_packet_t;
+
+static hci_packet_t transport_packets[MAX_HCI_PACKETS];
+static uint16_t     transport_count_packets;
+static uint16_t     next_command;
+static uint16_t     next_iso_packet;
+
+static  void (*packet_handler)(uint8_t packet_type, uint8_t *packet, uint16_t size);
+
+static const uint8_t packet_sent_event[] = { HCI_EVENT_TRANSPORT_PACKET_SENT, 0};
+
+// asynchronous transport: packet sent is reported after send_packet returned
+static bool transport_packet_sent_pending;
+
+static int hci_transport_test_can_send_now(uint8_t packet_type){
+    return transport_packet_sent_pending ? 0 : 1;
+}
+
+static int hci_transport_test_send_packet(uint8_t packet_type, uint8_t * packet, int size){
+    CHECK(transport_count_packets < MAX_HCI_PACKETS);
+    CHECK_FALSE(transport_packet_sent_pending);
+    memcpy(transport_packets[transport_count_packets].buffer, packet, size);
+    transport_packets[transport_count_packets].type = packet_type;
+    transport_packets[transport_count_packets].size = size;
+    transport_count_packets++;
+    transport_packet_sent_pending = true;
+    return 0;
+}
+
+static void transport_notify_packets_sent(void){
+    while (transport_packet_sent_pending){
+        transport_packet_sent_pending = false;
+        packet_handler(HCI_EVENT_PACKET, (uint8_t *) &packet_sent_event[0], sizeof(packet_sent_event));
+    }
+}
+
+static void hci_transport_test_register_packet_handler(void (*handler)(uint8_t packet_type, uint8_t *packet, uint16_t size)){
+    packet_handler = handler;
+}
+
+static const hci_transport_t hci_transport_test = {
+        /* const char * name; */                                        "TEST",
+        /* void   (*init) (const void *transport_config); */            NULL,
+        /* int    (*open)(void); */                                     NULL,
+        /* int    (*close)(void); */                                    NULL,
+        /* void   (*register_packet_handler)(void (*handler)(...); */   &hci_transport_test_register_packet_handler,
+        /* int    (*can_send_packet_now)(uint8_t packet_type); */       &hci_transport_test_can_send_now,
+        /* int    (*send_packet)(...); */                               &hci_transport_test_send_packet,
+        /* int    (*set_baudrate)(uint32_t baudrate); */                NULL,
+        /* void   (*reset_link)(void); */                               NULL,
+        /* void   (*set_sco_config)(uint16_t voice_setting, int num_connections); */ NULL,
+};
+
+// run loop with simulated time
+static uint32_t time_ms;
+
+static uint32_t run_loop_test_get_time_ms(void){
+    return time_ms;
+}
+
+static void run_loop_test_set_timer(btstack_timer_source_t * timer, uint32_t timeout_in_ms){
+    timer->timeout = time_ms + timeout_in_ms;
+}
+
+static const btstack_run_loop_t run_loop_test = {
+    &btstack_run_loop_base_init,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    &run_loop_test_set_timer,
+    &btstack_run_loop_base_add_timer,
+    &btstack_run_loop_base_remove_timer,
+    NULL,
+    NULL,
+    &run_loop_test_get_time_ms,
+    NULL,
+    NULL,
+    NULL,
+};
+
+// simulated controller
+static void controller_set_buffer_size(uint16_t iso_data_packet_length, uint8_t total_num_iso_data_packets){
+    uint8_t event[] = { HCI_EVENT_COMMAND_COMPLETE, 10, 1, 0, 0, ERROR_CODE_SUCCESS, 27, 0, 4, 0, 0, total_num_iso_data_packets };
+    little_endian_store_16(event, 3, HCI_OPCODE_HCI_LE_READ_BUFFER_SIZE_V2);
+    little_endian_store_16(event, 9, iso_data_packet_length);
+    packet_handler(HCI_EVENT_PACKET, event, sizeof(event));
+}
+
+static void controller_process_commands(void){
+    transport_notify_packets_sent();
+    while (next_command < transport_count_packets){
+        const hci_packet_t * packet = &transport_packets[next_command++];
+        if (packet->type != HCI_COMMAND_DATA_PACKET) continue;
+        uint16_t opcode = little_endian_read_16(packet->buffer, 0);
+        switch (opcode){
+            case HCI_OPCODE_HCI_LE_CREATE_BIG: {
+                uint8_t status_event[] = { HCI_EVENT_COMMAND_STATUS, 4, ERROR_CODE_SUCCESS, 1, 0, 0 };
+                little_endian_store_16(status_event, 4, opcode);
+                packet_handler(HCI_EVENT_PACKET, status_event, sizeof(status_event));
+                uint8_t complete_event[23];
+                memset(complete_event, 0, sizeof(complete_event));
+                complete_event[0] = HCI_EVENT_LE_META;
+                complete_event[1] = sizeof(complete_event) - 2;
+                complete_event[2] = HCI_SUBEVENT_LE_CREATE_BIG_COMPLETE;
+                complete_event[3] = ERROR_CODE_SUCCESS;
+                complete_event[4] = packet->buffer[3];
+                complete_event[20] = 1;
+                little_endian_store_16(complete_event, 21, BIS_CON_HANDLE);
+                packet_handler(HCI_EVENT_PACKET, complete_event, sizeof(complete_event));
+                break;
+            }
+            case HCI_OPCODE_HCI_LE_SETUP_ISO_DATA_PATH: {
+                uint8_t complete_event[] = { HCI_EVENT_COMMAND_COMPLETE, 6, 1, 0, 0, ERROR_CODE_SUCCESS, 0, 0 };
+                little_endian_store_16(complete_event, 3, opcode);
+                little_endian_store_16(complete_event, 6, little_endian_read_16(packet->buffer, 3));
+                packet_handler(HCI_EVENT_PACKET, complete_event, sizeof(complete_event));
+                break;
+            }
+            case HCI_OPCODE_HCI_LE_TERMINATE_BIG: {
+                uint8_t status_event[] = { HCI_EVENT_COMMAND_STATUS, 4, ERROR_CODE_SUCCESS, 1, 0, 0 };
+                little_endian_store_16(status_event, 4, opcode);
+                packet_handler(HCI_EVENT_PACKET, status_event, sizeof(status_event));
+                uint8_t complete_event[] = { HCI_EVENT_LE_META, 3, HCI_SUBEVENT_LE_TERMINATE_BIG_COMPLETE, packet->buffer[3], 0 };
+                packet_handler(HCI_EVENT_PACKET, complete_event, sizeof(complete_event));
+                break;
+            }
+            default:
+                break;
+        }
+        transport_notify_packets_sent();
+    }
+}
+
+// complete outgoing ISO packets after ISO interval
+static void controller_complete_iso_packets(uint32_t delay_ms, uint16_t num_packets){
+    time_ms += delay_ms;
+    uint8_t event[] = { HCI_EVENT_NUMBER_OF_COMPLETED_PACKETS, 5, 1, 0, 0, 0, 0 };
+    little_endian_store_16(event, 3, BIS_CON_HANDLE);
+    little_endian_store_16(event, 5, num_packets);
+    packet_handler(HCI_EVENT_PACKET, event, sizeof(event));
+    transport_notify_packets_sent();
+}
+
+static uint16_t controller_num_iso_packets(void){
+    transport_notify_packets_sent();
+    uint16_t num_packets = 0;
+    uint16_t i;
+    for (i = 0; i < transport_count_packets; i++){
+        if (transport_packets[i].type == HCI_ISO_DATA_PACKET){
+            num_packets++;
+        }
+    }
+    return num_packets;
+}
+
+static const hci_packet_t * controller_next_iso_packet(void){
+    transport_notify_packets_sent();
+    while (next_iso_packet < transport_count_packets){
+        const hci_packet_t * packet = &transport_packets[next_iso_packet++];
+        if (packet->type == HCI_ISO_DATA_PACKET){
+            return packet;
+        }
+    }
+    return NULL;
+}
+
+// verify complete SDU in single ISO packet without time stamp
+static void check_next_sdu(uint16_t packet_sequence_number, uint16_t sdu_len){
+    const hci_packet_t * packet = controller_next_iso_packet();
+    CHECK(packet != NULL);
+    uint16_t handle_and_flags = little_endian_read_16(packet->buffer, 0);
+    CHECK_EQUAL(BIS_CON_HANDLE, handle_and_flags & 0x0fff);
+    CHECK_EQUAL(0x02, (handle_and_flags >> 12) & 0x03);
+    CHECK_EQUAL(0, (handle_and_flags >> 14) & 0x01);
+    CHECK_EQUAL(sdu_len + 4, little_endian_read_16(packet->buffer, 2));
+    CHECK_EQUAL(packet_sequence_number, little_endian_read_16(packet->buffer, 4));
+    CHECK_EQUAL(sdu_len, little_endian_read_16(packet->buffer, 6));
+    CHECK_EQUAL((uint8_t) packet_sequence_number, packet->buffer[8]);
+}
+
+static le_audio_big_t        big_storage;
+static le_audio_big_params_t big_params;
+static hci_iso_tx_queue_t     tx_queue;
+static hci_iso_tx_queue_sdu_t tx_queue_sdus[NUM_SDUS];
+static uint8_t                tx_queue_storage[NUM_SDUS * MAX_SDU_LEN];
+static uint8_t                sdu[MAX_SDU_LEN + 1];
+
+static uint8_t add_sdu(uint16_t packet_sequence_number, uint16_t sdu_len){
+    memset(sdu, (uint8_t) packet_sequence_number, sdu_len);
+    return hci_iso_tx_queue_add_sdu(&tx_queue, packet_sequence_number, sdu, sdu_len);
+}
+
+TEST_GROUP(HCI_ISO_TX_QUEUE){
+    void setup(void){
+        transport_count_packets = 0;
+        transport_packet_sent_pending = false;
+        next_command = 0;
+        next_iso_packet = 0;
+        time_ms = 0;
+        btstack_run_loop_init(&run_loop_test);
+        hci_init(&hci_transport_test, NULL);
+        hci_simulate_working_fuzz();
+        controller_set_buffer_size(251, 8);
+        // create BIG with single BIS
+        memset(&big_params, 0, sizeof(big_params));
+        big_params.big_handle = BIG_HANDLE;
+        big_params.num_bis = 1;
+        big_params.sdu_interval_us = SDU_INTERVAL_US;
+        big_params.max_sdu = MAX_SDU_LEN;
+        CHECK_EQUAL(ERROR_CODE_SUCCESS, gap_big_create(&big_storage, &big_params));
+        controller_process_commands();
+        CHECK_EQUAL(LE_AUDIO_BIG_STATE_ACTIVE, big_storage.state);
+        hci_iso_tx_queue_init(&tx_queue, tx_queue_sdus, tx_queue_storage, NUM_SDUS, MAX_SDU_LEN);
+    }
+    void teardown(void){
+        hci_deinit();
+        btstack_run_loop_deinit();
+    }
+};
+
+TEST(HCI_ISO_TX_QUEUE, Attach){
+    CHECK_EQUAL(ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER, hci_iso_tx_queue_attach(0x0200, &tx_queue));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, hci_iso_tx_queue_attach(BIS_CON_HANDLE, &tx_queue));
+    CHECK_EQUAL(ERROR_CODE_COMMAND_DISALLOWED, hci_iso_tx_queue_attach(BIS_CON_HANDLE, &tx_queue));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, hci_iso_tx_queue_detach(BIS_CON_HANDLE));
+    CHECK_EQUAL(ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER, hci_iso_tx_queue_detach(BIS_CON_HANDLE));
+}
+
+TEST(HCI_ISO_TX_QUEUE, InvalidSdu){
+    CHECK_EQUAL(ERROR_CODE_INVALID_HCI_COMMAND_PARAMETERS, add_sdu(0, MAX_SDU_LEN + 1));
+    CHECK_EQUAL(0, hci_iso_tx_queue_get_statistics(&tx_queue)->sdus_queued);
+}
+
+TEST(HCI_ISO_TX_QUEUE, QueueFull){
+    uint16_t i;
+    for (i = 0; i < NUM_SDUS; i++){
+        CHECK_EQUAL(ERROR_CODE_SUCCESS, add_sdu(i, 40));
+    }
+    CHECK_EQUAL(ERROR_CODE_MEMORY_CAPACITY_EXCEEDED, add_sdu(NUM_SDUS, 40));
+    const hci_iso_tx_queue_statistics_t * statistics = hci_iso_tx_queue_get_statistics(&tx_queue);
+    CHECK_EQUAL(NUM_SDUS, statistics->sdus_queued);
+    CHECK_EQUAL(1, statistics->sdus_dropped);
+    CHECK_EQUAL(NUM_SDUS, statistics->queue_depth);
+    // nothing sent before queue is attached
+    CHECK_EQUAL(0, controller_num_iso_packets());
+}
+
+TEST(HCI_ISO_TX_QUEUE, PrefilledInOrder){
+    hci_set_num_iso_packets_to_queue(2);
+    uint16_t i;
+    for (i = 0; i < 6; i++){
+        CHECK_EQUAL(ERROR_CODE_SUCCESS, add_sdu(i, 40));
+    }
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, hci_iso_tx_queue_attach(BIS_CON_HANDLE, &tx_queue));
+    // controller accepts two SDUs ahead
+    CHECK_EQUAL(2, controller_num_iso_packets());
+    CHECK_EQUAL(4, hci_iso_tx_queue_get_statistics(&tx_queue)->queue_depth);
+    // one SDU per ISO interval
+    for (i = 0; i < 4; i++){
+        controller_complete_iso_packets(10, 1);
+        CHECK_EQUAL(3 + i, controller_num_iso_packets());
+    }
+    // SDU added to empty queue is sent if controller has room
+    controller_complete_iso_packets(10, 1);
+    CHECK_EQUAL(6, controller_num_iso_packets());
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, add_sdu(6, 40));
+    CHECK_EQUAL(7, controller_num_iso_packets());
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, add_sdu(7, 40));
+    CHECK_EQUAL(7, controller_num_iso_packets());
+    controller_complete_iso_packets(10, 1);
+    CHECK_EQUAL(8, controller_num_iso_packets());
+    for (i = 0; i < 8; i++){
+        check_next_sdu(i, 40);
+    }
+    const hci_iso_tx_queue_statistics_t * statistics = hci_iso_tx_queue_get_statistics(&tx_queue);
+    CHECK_EQUAL(8, statistics->sdus_queued);
+    CHECK_EQUAL(8, statistics->sdus_sent);
+    CHECK_EQUAL(0, statistics->sdus_late);
+    CHECK_EQUAL(0, statistics->sdus_dropped);
+    CHECK_EQUAL(0, statistics->queue_depth);
+    CHECK_EQUAL(6, statistics->max_queue_depth);
+}
+
+TEST(HCI_ISO_TX_QUEUE, TimeStamp){
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, hci_iso_tx_queue_attach(BIS_CON_HANDLE, &tx_queue));
+    memset(sdu, 0x55, 20);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, hci_iso_tx_queue_add_sdu_with_time_stamp(&tx_queue, 7, 0x12345678, sdu, 20));
+    const hci_packet_t * packet = controller_next_iso_packet();
+    CHECK(packet != NULL);
+    uint16_t handle_and_flags = little_endian_read_16(packet->buffer, 0);
+    CHECK_EQUAL(BIS_CON_HANDLE, handle_and_flags & 0x0fff);
+    CHECK_EQUAL(0x02, (handle_and_flags >> 12) & 0x03);
+    CHECK_EQUAL(1, (handle_and_flags >> 14) & 0x01);
+    CHECK_EQUAL(4 + 4 + 20, little_endian_read_16(packet->buffer, 2));
+    CHECK_EQUAL(0x12345678, little_endian_read_32(packet->buffer, 4));
+    CHECK_EQUAL(7, little_endian_read_16(packet->buffer, 8));
+    CHECK_EQUAL(20, little_endian_read_16(packet->buffer, 10));
+    CHECK_EQUAL(0x55, packet->buffer[12 + 19]);
+}
+
+TEST(HCI_ISO_TX_QUEUE, Fragmentation){
+    controller_set_buffer_size(64, 8);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, hci_iso_tx_queue_attach(BIS_CON_HANDLE, &tx_queue));
+    uint16_t i;
+    for (i = 0; i < MAX_SDU_LEN; i++){
+        sdu[i] = (uint8_t) i;
+    }
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, hci_iso_tx_queue_add_sdu(&tx_queue, 3, sdu, MAX_SDU_LEN));
+    // 4 bytes ISO data load header + 200 bytes SDU = 64 + 64 + 64 + 12
+    CHECK_EQUAL(4, controller_num_iso_packets());
+    static const uint8_t expected_pb_flags[] = { 0x00, 0x01, 0x01, 0x03 };
+    uint8_t reassembled[4 + MAX_SDU_LEN];
+    uint16_t reassembled_len = 0;
+    for (i = 0; i < 4; i++){
+        const hci_packet_t * packet = controller_next_iso_packet();
+        CHECK(packet != NULL);
+        uint16_t handle_and_flags = little_endian_read_16(packet->buffer, 0);
+        CHECK_EQUAL(BIS_CON_HANDLE, handle_and_flags & 0x0fff);
+        CHECK_EQUAL(expected_pb_flags[i], (handle_and_flags >> 12) & 0x03);
+        uint16_t fragment_len = little_endian_read_16(packet->buffer, 2);
+        CHECK(fragment_len <= 64);
+        CHECK_EQUAL(packet->size, fragment_len + 4);
+        memcpy(&reassembled[reassembled_len], &packet->buffer[4], fragment_len);
+        reassembled_len += fragment_len;
+    }
+    CHECK_EQUAL(4 + MAX_SDU_LEN, reassembled_len);
+    CHECK_EQUAL(3, little_endian_read_16(reassembled, 0));
+    CHECK_EQUAL(MAX_SDU_LEN, little_endian_read_16(reassembled, 2));
+    MEMCMP_EQUAL(sdu, &reassembled[4], MAX_SDU_LEN);
+}
+
+TEST(HCI_ISO_TX_QUEUE, LateSduSkipped){
+    uint16_t i;
+    for (i = 0; i < 6; i++){
+        CHECK_EQUAL(ERROR_CODE_SUCCESS, add_sdu(i, 40));
+    }
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, hci_iso_tx_queue_attach(BIS_CON_HANDLE, &tx_queue));
+    controller_complete_iso_packets(10, 1);
+    controller_complete_iso_packets(10, 1);
+    // missed two ISO intervals, SDU 3 is late and skipped to catch up
+    controller_complete_iso_packets(30, 1);
+    controller_complete_iso_packets(10, 1);
+    check_next_sdu(0, 40);
+    check_next_sdu(1, 40);
+    check_next_sdu(2, 40);
+    check_next_sdu(4, 40);
+    check_next_sdu(5, 40);
+    const hci_iso_tx_queue_statistics_t * statistics = hci_iso_tx_queue_get_statistics(&tx_queue);
+    CHECK_EQUAL(6, statistics->sdus_queued);
+    CHECK_EQUAL(5, statistics->sdus_sent);
+    CHECK_EQUAL(1, statistics->sdus_late);
+    CHECK_EQUAL(0, statistics->sdus_dropped);
+    CHECK_EQUAL(0, statistics->queue_depth);
+    // each SDU is counted once
+    CHECK_EQUAL(statistics->sdus_queued, statistics->sdus_sent + statistics->sdus_late + statistics->sdus_dropped + statistics->queue_depth);
+}
+
+TEST(HCI_ISO_TX_QUEUE, DetachedOnTerminate){
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, add_sdu(0, 40));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, add_sdu(1, 40));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, hci_iso_tx_queue_attach(BIS_CON_HANDLE, &tx_queue));
+    CHECK_EQUAL(1, controller_num_iso_packets());
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, gap_big_terminate(BIG_HANDLE));
+    controller_process_commands();
+    CHECK_EQUAL(HCI_CON_HANDLE_INVALID, tx_queue.con_handle);
+    // queue can be filled, nothing is sent
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, add_sdu(2, 40));
+    CHECK_EQUAL(1, controller_num_iso_packets());
+    CHECK_EQUAL(2, hci_iso_tx_queue_get_statistics(&tx_queue)->queue_depth);
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
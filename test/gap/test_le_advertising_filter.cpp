@@ -0,0 +1,228 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "bluetooth_company_id.h"
+#include "bluetooth_data_types.h"
+#include "bluetooth_gatt.h"
+#include "btstack_event.h"
+#include "btstack_run_loop.h"
+#include "gap.h"
+#include "hci.h"
+#include "hci_dump.h"
+#include "hci_dump_posix_fs.h"
+
+static  void (*packet_handler)(uint8_t packet_type, uint8_t *packet, uint16_t size);
+
+static const uint8_t packet_sent_event[] = { HCI_EVENT_TRANSPORT_PACKET_SENT, 0};
+
+static int hci_transport_test_can_send_now(uint8_t packet_type){
+    return 1;
+}
+
+static int hci_transport_test_send_packet(uint8_t packet_type, uint8_t * packet, int size){
+    // notify upper stack that it can send again
+    packet_handler(HCI_EVENT_PACKET, (uint8_t *) &packet_sent_event[0], sizeof(packet_sent_event));
+    return 0;
+}
+
+static void hci_transport_test_register_packet_handler(void (*handler)(uint8_t packet_type, uint8_t *packet, uint16_t size)){
+    packet_handler = handler;
+}
+
+static const hci_transport_t hci_transport_test = {
+        /* const char * name; */                                        "TEST",
+        /* void   (*init) (const void *transport_config); */            NULL,
+        /* int    (*open)(void); */                                     NULL,
+        /* int    (*close)(void); */                                    NULL,
+        /* void   (*register_packet_handler)(void (*handler)(...); */   &hci_transport_test_register_packet_handler,
+        /* int    (*can_send_packet_now)(uint8_t packet_type); */       &hci_transport_test_can_send_now,
+        /* int    (*send_packet)(...); */                               &hci_transport_test_send_packet,
+        /* int    (*set_baudrate)(uint32_t baudrate); */                NULL,
+        /* void   (*reset_link)(void); */                               NULL,
+        /* void   (*set_sco_config)(uint16_t voice_setting, int num_connections); */ NULL,
+};
+
+// run loop with simulated time
+static uint32_t time_ms;
+
+static uint32_t run_loop_test_get_time_ms(void){
+    return time_ms;
+}
+
+static void run_loop_test_set_timer(btstack_timer_source_t * timer, uint32_t timeout_in_ms){
+    timer->timeout = time_ms + timeout_in_ms;
+}
+
+static const btstack_run_loop_t run_loop_test = {
+    &btstack_run_loop_base_init,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    &run_loop_test_set_timer,
+    &btstack_run_loop_base_add_timer,
+    &btstack_run_loop_base_remove_timer,
+    NULL,
+    NULL,
+    &run_loop_test_get_time_ms,
+    NULL,
+    NULL,
+    NULL,
+};
+
+static const uint8_t address_1[] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+static const uint8_t address_2[] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x77 };
+
+static const uint8_t ibeacon_data[] = {
+    0x02, BLUETOOTH_DATA_TYPE_FLAGS, 0x06,
+    0x05, BLUETOOTH_DATA_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x4c, 0x00, 0x02, 0x15,
+};
+static const uint8_t heart_rate_data[] = {
+    0x02, BLUETOOTH_DATA_TYPE_FLAGS, 0x06,
+    0x03, BLUETOOTH_DATA_TYPE_COMPLETE_LIST_OF_16_BIT_SERVICE_CLASS_UUIDS, 0x0d, 0x18,
+};
+
+static uint16_t reports_received;
+static uint8_t  last_address[6];
+
+static void filter_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
+    CHECK_EQUAL(HCI_EVENT_PACKET, packet_type);
+    CHECK_EQUAL(GAP_EVENT_ADVERTISING_REPORT, hci_event_packet_get_type(packet));
+    gap_event_advertising_report_get_address(packet, last_address);
+    reports_received++;
+}
+
+// send HCI LE Advertising Report with single report
+static void receive_report(uint8_t address_type, const uint8_t * address, int8_t rssi, const uint8_t * data, uint8_t data_len){
+    uint8_t event[2 + 1 + 1 + 1 + 1 + 6 + 1 + 31 + 1];
+    uint16_t pos = 0;
+    event[pos++] = HCI_EVENT_LE_META;
+    event[pos++] = 0;
+    event[pos++] = HCI_SUBEVENT_LE_ADVERTISING_REPORT;
+    event[pos++] = 1;
+    event[pos++] = 0;
+    event[pos++] = address_type;
+    reverse_bd_addr(address, &event[pos]);
+    pos += 6;
+    event[pos++] = data_len;
+    memcpy(&event[pos], data, data_len);
+    pos += data_len;
+    event[pos++] = (uint8_t) rssi;
+    event[1] = pos - 2;
+    packet_handler(HCI_EVENT_PACKET, event, pos);
+}
+
+TEST_GROUP(GAP_LE_ADVERTISING_FILTER){
+    gap_le_advertising_filter_t filter;
+    void setup(void){
+        time_ms = 0;
+        reports_received = 0;
+        btstack_run_loop_init(&run_loop_test);
+        hci_init(&hci_transport_test, NULL);
+        hci_simulate_working_fuzz();
+        gap_start_scan();
+        gap_le_advertising_filter_init(&filter, &filter_handler);
+    }
+    void teardown(void){
+        gap_le_remove_advertising_filter(&filter);
+        hci_deinit();
+        btstack_run_loop_deinit();
+    }
+};
+
+TEST(GAP_LE_ADVERTISING_FILTER, NoRules){
+    gap_le_add_advertising_filter(&filter);
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_1, -50, ibeacon_data, sizeof(ibeacon_data));
+    receive_report(BD_ADDR_TYPE_LE_RANDOM, address_2, -90, heart_rate_data, sizeof(heart_rate_data));
+    CHECK_EQUAL(2, reports_received);
+    CHECK_EQUAL(2, filter.statistics.reports_delivered);
+}
+
+TEST(GAP_LE_ADVERTISING_FILTER, Address){
+    gap_le_advertising_filter_set_address(&filter, BD_ADDR_TYPE_LE_PUBLIC, address_2);
+    gap_le_add_advertising_filter(&filter);
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_1, -50, ibeacon_data, sizeof(ibeacon_data));
+    receive_report(BD_ADDR_TYPE_LE_RANDOM, address_2, -50, ibeacon_data, sizeof(ibeacon_data));
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_2, -50, ibeacon_data, sizeof(ibeacon_data));
+    CHECK_EQUAL(1, reports_received);
+    MEMCMP_EQUAL(address_2, last_address, 6);
+    CHECK_EQUAL(3, filter.statistics.reports_received);
+    CHECK_EQUAL(2, filter.statistics.reports_rejected);
+}
+
+TEST(GAP_LE_ADVERTISING_FILTER, Rssi){
+    gap_le_advertising_filter_set_rssi_threshold(&filter, -70);
+    gap_le_add_advertising_filter(&filter);
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_1, -71, ibeacon_data, sizeof(ibeacon_data));
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_1, -70, ibeacon_data, sizeof(ibeacon_data));
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_1, -40, ibeacon_data, sizeof(ibeacon_data));
+    CHECK_EQUAL(2, reports_received);
+}
+
+TEST(GAP_LE_ADVERTISING_FILTER, AdvertisingData){
+    gap_le_advertising_filter_set_manufacturer_id(&filter, BLUETOOTH_COMPANY_ID_APPLE_INC);
+    gap_le_add_advertising_filter(&filter);
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_1, -50, ibeacon_data, sizeof(ibeacon_data));
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_2, -50, heart_rate_data, sizeof(heart_rate_data));
+    CHECK_EQUAL(1, reports_received);
+    MEMCMP_EQUAL(address_1, last_address, 6);
+
+    gap_le_advertising_filter_init(&filter, &filter_handler);
+    gap_le_advertising_filter_set_uuid16(&filter, ORG_BLUETOOTH_SERVICE_HEART_RATE);
+    gap_le_advertising_filter_set_ad_type(&filter, BLUETOOTH_DATA_TYPE_FLAGS);
+    gap_le_add_advertising_filter(&filter);
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_1, -50, ibeacon_data, sizeof(ibeacon_data));
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_2, -50, heart_rate_data, sizeof(heart_rate_data));
+    CHECK_EQUAL(2, reports_received);
+    MEMCMP_EQUAL(address_2, last_address, 6);
+
+    gap_le_advertising_filter_set_ad_type(&filter, BLUETOOTH_DATA_TYPE_TX_POWER_LEVEL);
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_2, -50, heart_rate_data, sizeof(heart_rate_data));
+    CHECK_EQUAL(2, reports_received);
+}
+
+TEST(GAP_LE_ADVERTISING_FILTER, DuplicateSuppression){
+    gap_le_advertising_filter_entry_t entries[4];
+    gap_le_advertising_filter_set_duplicate_suppression(&filter, 1000, entries, 4);
+    gap_le_add_advertising_filter(&filter);
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_1, -50, ibeacon_data, sizeof(ibeacon_data));
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_2, -50, ibeacon_data, sizeof(ibeacon_data));
+    time_ms = 500;
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_1, -50, ibeacon_data, sizeof(ibeacon_data));
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_2, -50, ibeacon_data, sizeof(ibeacon_data));
+    CHECK_EQUAL(2, reports_received);
+    CHECK_EQUAL(2, filter.statistics.reports_duplicate);
+    // changed data is delivered
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_1, -50, heart_rate_data, sizeof(heart_rate_data));
+    CHECK_EQUAL(3, reports_received);
+    // same data is delivered again after time window
+    time_ms = 1200;
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_2, -50, ibeacon_data, sizeof(ibeacon_data));
+    receive_report(BD_ADDR_TYPE_LE_PUBLIC, address_2, -50, ibeacon_data, sizeof(ibeacon_data));
+    CHECK_EQUAL(4, reports_received);
+    CHECK_EQUAL(3, filter.statistics.reports_duplicate);
+    // more addresses than entries
+    uint8_t address[6];
+    memcpy(address, address_1, 6);
+    uint8_t i;
+    for (i = 0; i < 10; i++){
+        address[0] = i;
+        receive_report(BD_ADDR_TYPE_LE_PUBLIC, address, -50, ibeacon_data, sizeof(ibeacon_data));
+    }
+    CHECK_EQUAL(14, reports_received);
+}
+
+int main (int argc, const char * argv[]){
+    // log into file using HCI_DUMP_PACKETLOGGER format
+    const char * pklg_path = "hci_dump.pklg";
+    hci_dump_posix_fs_open(pklg_path, HCI_DUMP_PACKETLOGGER);
+    hci_dump_init(hci_dump_posix_fs_get_instance());
+    printf("Packet Log: %s\n", pklg_path);
+
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
@@ -0,0 +1,381 @@
+// *****************************************************************************
+//
+// test GATT Client cache validated by Database Hash
+//
+// Full discovery of services, characteristics and descriptors is executed against
+// a GATT Server built with att_db_util. Results of repeated discoveries and the
+// number of ATT requests are compared. Database Hash and the Client Characteristic
+// Configuration of Service Changed are dynamic to track access by the GATT Client.
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "bluetooth_gatt.h"
+#include "btstack_memory.h"
+#include "btstack_event.h"
+#include "btstack_tlv.h"
+#include "btstack_util.h"
+#include "ble/att_db.h"
+#include "ble/att_db_util.h"
+#include "ble/gatt_client.h"
+
+#define MAX_EVENTS          100
+#define MAX_EVENT_LOG_SIZE  3000
+#define MAX_TLV_VALUE_SIZE  2000
+
+extern "C" void hci_setup_le_connection(uint16_t con_handle);
+extern "C" void mock_simulate_disconnection_complete(uint16_t con_handle);
+extern "C" void mock_simulate_att_server_packet(uint16_t con_handle, uint8_t * packet, uint16_t size);
+extern "C" uint32_t mock_get_att_requests_sent(void);
+extern "C" void mock_set_le_device_index(int le_device_index);
+
+static const hci_con_handle_t con_handle = 0x40;
+
+static uint8_t  database_hash[16];
+static uint16_t database_hash_value_handle;
+static uint16_t database_hash_reads;
+static uint16_t num_services_at_database_hash_read;
+static uint16_t service_changed_value_handle;
+static uint16_t service_changed_configuration_handle;
+static uint16_t service_changed_configuration;
+static uint16_t service_changed_configuration_writes;
+
+static bool     query_complete;
+static uint8_t  query_status;
+static uint8_t  event_log[MAX_EVENT_LOG_SIZE];
+static uint16_t event_log_len;
+
+static gatt_client_service_t                   services[MAX_EVENTS];
+static uint16_t                                num_services;
+static gatt_client_characteristic_t            characteristics[MAX_EVENTS];
+static uint16_t                                num_characteristics;
+
+// in-memory TLV with single value
+static uint32_t tlv_tag;
+static uint8_t  tlv_value[MAX_TLV_VALUE_SIZE];
+static uint32_t tlv_value_size;
+static uint32_t tlv_num_stores;
+
+static int tlv_get_tag(void * context, uint32_t tag, uint8_t * buffer, uint32_t buffer_size){
+    if ((tlv_value_size == 0) || (tag != tlv_tag)) return 0;
+    uint32_t size = btstack_min(buffer_size, tlv_value_size);
+    memcpy(buffer, tlv_value, size);
+    return (int) tlv_value_size;
+}
+static int tlv_store_tag(void * context, uint32_t tag, const uint8_t * data, uint32_t data_size){
+    CHECK(data_size <= sizeof(tlv_value));
+    tlv_tag = tag;
+    memcpy(tlv_value, data, data_size);
+    tlv_value_size = data_size;
+    tlv_num_stores++;
+    return 0;
+}
+static void tlv_delete_tag(void * context, uint32_t tag){
+    if (tag == tlv_tag){
+        tlv_value_size = 0;
+    }
+}
+static const btstack_tlv_t tlv_impl = {
+    &tlv_get_tag,
+    &tlv_store_tag,
+    &tlv_delete_tag,
+};
+
+// Database Hash is provided as static value
+extern "C" void btstack_crypto_aes128_cmac_generator(btstack_crypto_aes128_cmac_t * request, const uint8_t * key, uint16_t size,
+                                                     uint8_t (*get_byte_callback)(uint16_t pos), uint8_t * hash, void (* callback)(void * arg), void * callback_arg){
+}
+extern "C" void btstack_aes128_calc(const uint8_t * key, const uint8_t * plaintext, uint8_t * ciphertext){
+}
+extern "C" void btstack_assert_failed(const char * file, uint16_t line_nr){
+    FAIL("assert");
+}
+
+static uint16_t att_read_callback(hci_con_handle_t handle, uint16_t attribute_handle, uint16_t offset, uint8_t * buffer, uint16_t buffer_size){
+    if (attribute_handle == database_hash_value_handle){
+        if (buffer != NULL){
+            database_hash_reads++;
+            num_services_at_database_hash_read = num_services;
+        }
+        return att_read_callback_handle_blob(database_hash, sizeof(database_hash), offset, buffer, buffer_size);
+    }
+    return 0;
+}
+
+static int att_write_callback(hci_con_handle_t handle, uint16_t attribute_handle, uint16_t transaction_mode, uint16_t offset, uint8_t *buffer, uint16_t buffer_size){
+    if ((attribute_handle == service_changed_configuration_handle) && (buffer_size == 2)){
+        service_changed_configuration = little_endian_read_16(buffer, 0);
+        service_changed_configuration_writes++;
+    }
+    return 0;
+}
+
+static void handle_gatt_client_event(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
+    switch (hci_event_packet_get_type(packet)){
+        case GATT_EVENT_SERVICE_QUERY_RESULT:
+            CHECK(num_services < MAX_EVENTS);
+            gatt_event_service_query_result_get_service(packet, &services[num_services++]);
+            break;
+        case GATT_EVENT_CHARACTERISTIC_QUERY_RESULT:
+            CHECK(num_characteristics < MAX_EVENTS);
+            gatt_event_characteristic_query_result_get_characteristic(packet, &characteristics[num_characteristics++]);
+            break;
+        case GATT_EVENT_ALL_CHARACTERISTIC_DESCRIPTORS_QUERY_RESULT:
+            break;
+        case GATT_EVENT_QUERY_COMPLETE:
+            query_complete = true;
+            query_status = gatt_event_query_complete_get_att_status(packet);
+            return;
+        default:
+            return;
+    }
+    CHECK((event_log_len + size) <= sizeof(event_log));
+    memcpy(&event_log[event_log_len], packet, size);
+    event_log_len += size;
+}
+
+static void setup_database(bool with_database_hash, bool with_extra_service){
+    static uint8_t service_changed[4];
+    static uint8_t battery_level = 100;
+    static uint8_t user_description[] = "Custom";
+    static const uint8_t custom_service_uuid128[] = { 0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00, 0x00, 0x80, 0x00, 0x10, 0x00, 0x00, 0x01, 0xF0, 0x00, 0x00 };
+    static const uint8_t custom_characteristic_uuid128[] = { 0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00, 0x00, 0x80, 0x00, 0x10, 0x00, 0x00, 0x02, 0xF0, 0x00, 0x00 };
+
+    att_db_util_init();
+    att_db_util_add_service_uuid16(ORG_BLUETOOTH_SERVICE_GENERIC_ACCESS);
+    att_db_util_add_characteristic_uuid16(ORG_BLUETOOTH_CHARACTERISTIC_GAP_DEVICE_NAME, ATT_PROPERTY_READ, ATT_SECURITY_NONE, ATT_SECURITY_NONE, (uint8_t *) "Test", 4);
+    att_db_util_add_service_uuid16(ORG_BLUETOOTH_SERVICE_GENERIC_ATTRIBUTE);
+    uint16_t value_handle = att_db_util_add_characteristic_uuid16(ORG_BLUETOOTH_CHARACTERISTIC_GATT_SERVICE_CHANGED, ATT_PROPERTY_INDICATE, ATT_SECURITY_NONE, ATT_SECURITY_NONE, service_changed, sizeof(service_changed));
+    service_changed_configuration_handle = value_handle + 1;
+    database_hash_value_handle = 0;
+    if (with_database_hash){
+        database_hash_value_handle = att_db_util_add_characteristic_uuid16(ORG_BLUETOOTH_CHARACTERISTIC_DATABASE_HASH, ATT_PROPERTY_READ | ATT_PROPERTY_DYNAMIC, ATT_SECURITY_NONE, ATT_SECURITY_NONE, NULL, 0);
+    }
+    att_db_util_add_service_uuid16(ORG_BLUETOOTH_SERVICE_BATTERY_SERVICE);
+    att_db_util_add_characteristic_uuid16(ORG_BLUETOOTH_CHARACTERISTIC_BATTERY_LEVEL, ATT_PROPERTY_READ | ATT_PROPERTY_NOTIFY, ATT_SECURITY_NONE, ATT_SECURITY_NONE, &battery_level, 1);
+    att_db_util_add_service_uuid128(custom_service_uuid128);
+    att_db_util_add_characteristic_uuid128(custom_characteristic_uuid128, ATT_PROPERTY_READ | ATT_PROPERTY_WRITE | ATT_PROPERTY_INDICATE, ATT_SECURITY_NONE, ATT_SECURITY_NONE, &battery_level, 1);
+    att_db_util_add_descriptor_uuid16(ORG_BLUETOOTH_DESCRIPTOR_GATT_CHARACTERISTIC_USER_DESCRIPTION, ATT_PROPERTY_READ, ATT_SECURITY_NONE, ATT_SECURITY_NONE, user_description, sizeof(user_description) - 1);
+    if (with_extra_service){
+        att_db_util_add_service_uuid16(ORG_BLUETOOTH_SERVICE_DEVICE_INFORMATION);
+        att_db_util_add_characteristic_uuid16(ORG_BLUETOOTH_CHARACTERISTIC_MANUFACTURER_NAME_STRING, ATT_PROPERTY_READ, ATT_SECURITY_NONE, ATT_SECURITY_NONE, (uint8_t *) "BK", 2);
+    }
+    att_set_db(att_db_util_get_address());
+    att_set_read_callback(&att_read_callback);
+    att_set_write_callback(&att_write_callback);
+}
+
+static void wait_for_query_complete(uint8_t status){
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+    CHECK_TRUE(query_complete);
+    CHECK_EQUAL(ATT_ERROR_SUCCESS, query_status);
+    query_complete = false;
+}
+
+// discover all services, characteristics and descriptors, similar to GATT Service clients
+static void discover_all(void){
+    num_services = 0;
+    num_characteristics = 0;
+    event_log_len = 0;
+    service_changed_value_handle = 0;
+
+    wait_for_query_complete(gatt_client_discover_primary_services(&handle_gatt_client_event, con_handle));
+    uint16_t i;
+    uint16_t num_services_found = num_services;
+    for (i = 0; i < num_services_found; i++){
+        wait_for_query_complete(gatt_client_discover_characteristics_for_service(&handle_gatt_client_event, con_handle, &services[i]));
+    }
+    uint16_t num_characteristics_found = num_characteristics;
+    for (i = 0; i < num_characteristics_found; i++){
+        if (characteristics[i].uuid16 == ORG_BLUETOOTH_CHARACTERISTIC_GATT_SERVICE_CHANGED){
+            service_changed_value_handle = characteristics[i].value_handle;
+        }
+        wait_for_query_complete(gatt_client_discover_characteristic_descriptors(&handle_gatt_client_event, con_handle, &characteristics[i]));
+    }
+}
+
+static uint32_t discover_all_and_count_requests(void){
+    uint32_t requests_before = mock_get_att_requests_sent();
+    discover_all();
+    return mock_get_att_requests_sent() - requests_before;
+}
+
+static void reconnect(void){
+    mock_simulate_disconnection_complete(con_handle);
+    hci_setup_le_connection(con_handle);
+}
+
+TEST_GROUP(GATTClientCache){
+    void setup(void){
+        tlv_value_size = 0;
+        tlv_num_stores = 0;
+        query_complete = false;
+        database_hash_reads = 0;
+        service_changed_configuration = 0;
+        service_changed_configuration_writes = 0;
+        mock_set_le_device_index(0);
+        memset(database_hash, 0x11, sizeof(database_hash));
+        btstack_tlv_set_instance(&tlv_impl, NULL);
+        setup_database(true, false);
+        hci_setup_le_connection(con_handle);
+    }
+
+    void teardown(void){
+        mock_simulate_disconnection_complete(con_handle);
+    }
+};
+
+TEST(GATTClientCache, InitialDiscoveryStoresCache){
+    uint32_t requests = discover_all_and_count_requests();
+    CHECK_EQUAL(4, num_services);
+    CHECK_EQUAL(5, num_characteristics);
+    CHECK(requests > 10);
+    CHECK_EQUAL(0, tlv_num_stores);
+    reconnect();
+    CHECK_EQUAL(1, tlv_num_stores);
+    CHECK(tlv_value_size > 16);
+    MEMCMP_EQUAL(database_hash, tlv_value, 16);
+}
+
+TEST(GATTClientCache, ReconnectUsesCache){
+    discover_all();
+    uint8_t expected_event_log[MAX_EVENT_LOG_SIZE];
+    uint16_t expected_event_log_len = event_log_len;
+    memcpy(expected_event_log, event_log, event_log_len);
+    reconnect();
+
+    // only Database Hash is read
+    uint32_t requests = discover_all_and_count_requests();
+    CHECK_EQUAL(1, requests);
+    CHECK_EQUAL(expected_event_log_len, event_log_len);
+    MEMCMP_EQUAL(expected_event_log, event_log, event_log_len);
+
+    // cache not modified
+    reconnect();
+    CHECK_EQUAL(1, tlv_num_stores);
+}
+
+TEST(GATTClientCache, FilteredQueriesUseCache){
+    discover_all();
+    reconnect();
+
+    uint32_t requests_before = mock_get_att_requests_sent();
+    num_services = 0;
+    wait_for_query_complete(gatt_client_discover_primary_services_by_uuid16(&handle_gatt_client_event, con_handle, ORG_BLUETOOTH_SERVICE_BATTERY_SERVICE));
+    CHECK_EQUAL(1, num_services);
+    CHECK_EQUAL(ORG_BLUETOOTH_SERVICE_BATTERY_SERVICE, services[0].uuid16);
+    num_characteristics = 0;
+    wait_for_query_complete(gatt_client_discover_characteristics_for_service_by_uuid16(&handle_gatt_client_event, con_handle, &services[0], ORG_BLUETOOTH_CHARACTERISTIC_BATTERY_LEVEL));
+    CHECK_EQUAL(1, num_characteristics);
+    CHECK_EQUAL(ORG_BLUETOOTH_CHARACTERISTIC_BATTERY_LEVEL, characteristics[0].uuid16);
+    CHECK_EQUAL(1, mock_get_att_requests_sent() - requests_before);
+}
+
+TEST(GATTClientCache, DatabaseHashChanged){
+    discover_all();
+    reconnect();
+
+    // server adds service and updates hash
+    database_hash[0] = 0x22;
+    setup_database(true, true);
+
+    uint32_t requests = discover_all_and_count_requests();
+    CHECK(requests > 10);
+    CHECK_EQUAL(5, num_services);
+    reconnect();
+    CHECK_EQUAL(2, tlv_num_stores);
+    MEMCMP_EQUAL(database_hash, tlv_value, 16);
+
+    // new database is cached
+    requests = discover_all_and_count_requests();
+    CHECK_EQUAL(1, requests);
+    CHECK_EQUAL(5, num_services);
+}
+
+TEST(GATTClientCache, ServiceChangedIndicationInvalidatesCache){
+    discover_all();
+    CHECK(service_changed_value_handle != 0);
+    reconnect();
+    CHECK(tlv_value_size > 0);
+    CHECK_EQUAL(1, discover_all_and_count_requests());
+
+    // server adds service and indicates Service Changed, Database Hash is not updated on purpose
+    setup_database(true, true);
+    uint8_t indication[7];
+    indication[0] = ATT_HANDLE_VALUE_INDICATION;
+    little_endian_store_16(indication, 1, service_changed_value_handle);
+    little_endian_store_16(indication, 3, 0x0001);
+    little_endian_store_16(indication, 5, 0xffff);
+    mock_simulate_att_server_packet(con_handle, indication, sizeof(indication));
+    CHECK_EQUAL(0, tlv_value_size);
+
+    uint32_t requests = discover_all_and_count_requests();
+    CHECK(requests > 10);
+    CHECK_EQUAL(5, num_services);
+}
+
+TEST(GATTClientCache, DatabaseHashNotSupported){
+    setup_database(false, false);
+    uint32_t requests = discover_all_and_count_requests();
+    CHECK_EQUAL(4, num_services);
+    reconnect();
+    CHECK_EQUAL(0, tlv_num_stores);
+    CHECK_EQUAL(requests, discover_all_and_count_requests());
+}
+
+TEST(GATTClientCache, CacheUsedWithinConnection){
+    uint32_t requests = discover_all_and_count_requests();
+    CHECK(requests > 10);
+    // e.g. second GATT Service client repeats discovery
+    CHECK_EQUAL(0, discover_all_and_count_requests());
+}
+
+TEST(GATTClientCache, ServiceChangedIndicationsEnabled){
+    discover_all();
+    CHECK_EQUAL(GATT_CLIENT_CHARACTERISTICS_CONFIGURATION_INDICATION, service_changed_configuration);
+    CHECK_EQUAL(1, service_changed_configuration_writes);
+
+    // configuration is stored with the cache and not repeated
+    reconnect();
+    discover_all();
+    reconnect();
+    discover_all();
+    CHECK_EQUAL(1, service_changed_configuration_writes);
+}
+
+TEST(GATTClientCache, FirstDiscoveryReadsDatabaseHashAfterQuery){
+    // nothing to validate, Database Hash is only read to store the cache
+    discover_all();
+    CHECK_EQUAL(1, database_hash_reads);
+    CHECK_EQUAL(4, num_services_at_database_hash_read);
+
+    // stored cache is validated before results are reported
+    reconnect();
+    discover_all();
+    CHECK_EQUAL(2, database_hash_reads);
+    CHECK_EQUAL(0, num_services_at_database_hash_read);
+}
+
+TEST(GATTClientCache, NotBondedNotCached){
+    mock_set_le_device_index(-1);
+    uint32_t requests = discover_all_and_count_requests();
+    CHECK_EQUAL(4, num_services);
+    CHECK_EQUAL(0, database_hash_reads);
+    CHECK_EQUAL(0, service_changed_configuration_writes);
+    CHECK_EQUAL(requests, discover_all_and_count_requests());
+    reconnect();
+    CHECK_EQUAL(0, tlv_num_stores);
+}
+
+int main (int argc, const char * argv[]){
+    btstack_memory_init();
+    gatt_client_init();
+    gatt_client_mtu_enable_auto_negotiation(0);
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
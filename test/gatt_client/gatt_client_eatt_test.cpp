@@ -0,0 +1,453 @@
+// *****************************************************************************
+//
+// test GATT Client over multiple EATT bearers
+//
+// EATT is set up against a GATT Server built with att_db_util. Afterwards, ATT
+// requests on the unenhanced bearer and the EATT bearers of the mock stay pending
+// until the test lets the ATT server respond, so that queries are in progress on
+// several bearers at the same time and responses can arrive in any order.
+//
+// For long reads, the number of ATT round trips is measured by processing the
+// pending requests of all bearers in rounds, similar to one connection event.
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "bluetooth_gatt.h"
+#include "btstack_memory.h"
+#include "btstack_event.h"
+#include "btstack_util.h"
+#include "ble/att_db.h"
+#include "ble/att_db_util.h"
+#include "ble/gatt_client.h"
+
+#define NUM_EATT_CHANNELS       2
+#define EATT_LOCAL_MTU          128
+#define NUM_CHARACTERISTICS     4
+#define MAX_LOG_ENTRIES         20
+#define LONG_VALUE_SIZE         512
+#define SHORT_LONG_VALUE_SIZE   70
+
+extern "C" void hci_setup_le_connection(uint16_t con_handle);
+extern "C" void mock_simulate_disconnection_complete(uint16_t con_handle);
+extern "C" void mock_set_att_requests_deferred(bool deferred);
+extern "C" bool mock_att_request_pending(void);
+extern "C" const uint8_t * mock_att_get_request(void);
+extern "C" void mock_att_process_request(void);
+extern "C" uint8_t mock_eatt_get_num_channels(void);
+extern "C" void mock_simulate_eatt_channel_opened(uint8_t index, uint16_t local_mtu, uint16_t remote_mtu);
+extern "C" void mock_simulate_eatt_channels_closed(void);
+extern "C" bool mock_eatt_request_pending(uint8_t index);
+extern "C" const uint8_t * mock_eatt_get_request(uint8_t index);
+extern "C" void mock_eatt_process_request(uint8_t index);
+
+static const hci_con_handle_t con_handle = 0x40;
+
+// different MTU for each EATT bearer, unenhanced bearer uses ATT_DEFAULT_MTU
+static const uint16_t eatt_remote_mtus[NUM_EATT_CHANNELS] = { 64, 100 };
+
+// send and receive buffer for each EATT bearer, supports MTU of 64 and more
+static uint8_t  eatt_storage_buffer[NUM_EATT_CHANNELS * 300];
+static bool     eatt_connected;
+static uint8_t  eatt_connected_status;
+
+// dynamic characteristics of the GATT Server
+static uint16_t value_handles[NUM_CHARACTERISTICS];
+static uint8_t  values[NUM_CHARACTERISTICS];
+static uint16_t client_supported_features_handle;
+static uint8_t  client_supported_features;
+
+// value writes in the order seen by the GATT Server
+static uint16_t write_log_handles[MAX_LOG_ENTRIES];
+static uint8_t  write_log_values[MAX_LOG_ENTRIES];
+static uint16_t write_log_len;
+
+// read results in the order seen by the GATT Client
+static uint16_t read_log_handles[MAX_LOG_ENTRIES];
+static uint8_t  read_log_values[MAX_LOG_ENTRIES];
+static uint16_t read_log_len;
+
+static uint16_t num_query_complete;
+
+// static long values of the GATT Server
+static uint8_t  long_value[LONG_VALUE_SIZE];
+static uint16_t long_value_handle;
+static uint16_t short_long_value_handle;
+
+static uint16_t long_read_num_query_complete;
+static uint8_t  long_read_status;
+
+// Database Hash is not used
+extern "C" void btstack_crypto_aes128_cmac_generator(btstack_crypto_aes128_cmac_t * request, const uint8_t * key, uint16_t size,
+                                                     uint8_t (*get_byte_callback)(uint16_t pos), uint8_t * hash, void (* callback)(void * arg), void * callback_arg){
+}
+extern "C" void btstack_aes128_calc(const uint8_t * key, const uint8_t * plaintext, uint8_t * ciphertext){
+}
+extern "C" void btstack_assert_failed(const char * file, uint16_t line_nr){
+    FAIL("assert");
+}
+
+static int characteristic_index(uint16_t attribute_handle){
+    int i;
+    for (i = 0; i < NUM_CHARACTERISTICS; i++){
+        if (value_handles[i] == attribute_handle) return i;
+    }
+    return -1;
+}
+
+static uint16_t att_read_callback(hci_con_handle_t handle, uint16_t attribute_handle, uint16_t offset, uint8_t * buffer, uint16_t buffer_size){
+    int index = characteristic_index(attribute_handle);
+    if (index < 0) return 0;
+    return att_read_callback_handle_byte(values[index], offset, buffer, buffer_size);
+}
+
+static int att_write_callback(hci_con_handle_t handle, uint16_t attribute_handle, uint16_t transaction_mode, uint16_t offset, uint8_t *buffer, uint16_t buffer_size){
+    if ((attribute_handle == client_supported_features_handle) && (buffer_size == 1)){
+        client_supported_features = buffer[0];
+        return 0;
+    }
+    int index = characteristic_index(attribute_handle);
+    if ((index < 0) || (buffer_size != 1)) return 0;
+    CHECK(write_log_len < MAX_LOG_ENTRIES);
+    values[index] = buffer[0];
+    write_log_handles[write_log_len] = attribute_handle;
+    write_log_values[write_log_len] = buffer[0];
+    write_log_len++;
+    return 0;
+}
+
+static void handle_gatt_client_event(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
+    if (packet_type != HCI_EVENT_PACKET) return;
+    switch (hci_event_packet_get_type(packet)){
+        case GATT_EVENT_CONNECTED:
+            eatt_connected = true;
+            eatt_connected_status = gatt_event_connected_get_status(packet);
+            break;
+        case GATT_EVENT_CHARACTERISTIC_VALUE_QUERY_RESULT:
+            CHECK(read_log_len < MAX_LOG_ENTRIES);
+            CHECK_EQUAL(1, gatt_event_characteristic_value_query_result_get_value_length(packet));
+            read_log_handles[read_log_len] = gatt_event_characteristic_value_query_result_get_value_handle(packet);
+            read_log_values[read_log_len] = gatt_event_characteristic_value_query_result_get_value(packet)[0];
+            read_log_len++;
+            break;
+        case GATT_EVENT_QUERY_COMPLETE:
+            CHECK_EQUAL(ATT_ERROR_SUCCESS, gatt_event_query_complete_get_att_status(packet));
+            num_query_complete++;
+            break;
+        default:
+            break;
+    }
+}
+
+static void handle_long_read_event(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
+    if (packet_type != HCI_EVENT_PACKET) return;
+    // blobs are stored in the application buffer without events
+    CHECK_EQUAL(GATT_EVENT_QUERY_COMPLETE, hci_event_packet_get_type(packet));
+    long_read_status = gatt_event_query_complete_get_att_status(packet);
+    long_read_num_query_complete++;
+}
+
+static void setup_database(void){
+    static uint8_t server_supported_features = 1;  // EATT supported
+    static const uint16_t characteristic_uuids[NUM_CHARACTERISTICS] = { 0xF101, 0xF102, 0xF103, 0xF104 };
+
+    att_db_util_init();
+    att_db_util_add_service_uuid16(ORG_BLUETOOTH_SERVICE_GENERIC_ACCESS);
+    att_db_util_add_characteristic_uuid16(ORG_BLUETOOTH_CHARACTERISTIC_GAP_DEVICE_NAME, ATT_PROPERTY_READ, ATT_SECURITY_NONE, ATT_SECURITY_NONE, (uint8_t *) "Test", 4);
+    att_db_util_add_service_uuid16(ORG_BLUETOOTH_SERVICE_GENERIC_ATTRIBUTE);
+    att_db_util_add_characteristic_uuid16(ORG_BLUETOOTH_CHARACTERISTIC_SERVER_SUPPORTED_FEATURES, ATT_PROPERTY_READ, ATT_SECURITY_NONE, ATT_SECURITY_NONE, &server_supported_features, 1);
+    client_supported_features_handle = att_db_util_add_characteristic_uuid16(ORG_BLUETOOTH_CHARACTERISTIC_CLIENT_SUPPORTED_FEATURES, ATT_PROPERTY_READ | ATT_PROPERTY_WRITE | ATT_PROPERTY_DYNAMIC, ATT_SECURITY_NONE, ATT_SECURITY_NONE, NULL, 0);
+    att_db_util_add_service_uuid16(0xF100);
+    uint8_t i;
+    for (i = 0; i < NUM_CHARACTERISTICS; i++){
+        value_handles[i] = att_db_util_add_characteristic_uuid16(characteristic_uuids[i], ATT_PROPERTY_READ | ATT_PROPERTY_WRITE | ATT_PROPERTY_DYNAMIC, ATT_SECURITY_NONE, ATT_SECURITY_NONE, NULL, 0);
+        values[i] = i;
+    }
+    uint16_t j;
+    for (j = 0; j < LONG_VALUE_SIZE; j++){
+        long_value[j] = (uint8_t) (j * 7);
+    }
+    long_value_handle = att_db_util_add_characteristic_uuid16(0xF105, ATT_PROPERTY_READ, ATT_SECURITY_NONE, ATT_SECURITY_NONE, long_value, LONG_VALUE_SIZE);
+    short_long_value_handle = att_db_util_add_characteristic_uuid16(0xF106, ATT_PROPERTY_READ, ATT_SECURITY_NONE, ATT_SECURITY_NONE, long_value, SHORT_LONG_VALUE_SIZE);
+    att_set_db(att_db_util_get_address());
+    att_set_read_callback(&att_read_callback);
+    att_set_write_callback(&att_write_callback);
+}
+
+typedef struct {
+    gatt_client_attribute_query_request_t request;
+    uint16_t value_handle;
+    bool     write;
+    uint8_t  value;
+} attribute_operation_t;
+
+static void attribute_operation_start(void * context){
+    attribute_operation_t * operation = (attribute_operation_t *) context;
+    uint8_t status;
+    if (operation->write){
+        status = gatt_client_write_value_of_characteristic(&handle_gatt_client_event, con_handle, operation->value_handle, 1, &operation->value);
+    } else {
+        status = gatt_client_read_value_of_characteristic_using_value_handle(&handle_gatt_client_event, con_handle, operation->value_handle);
+    }
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+}
+
+static void attribute_operation_queue(attribute_operation_t * operation, uint16_t value_handle, bool write, uint8_t value){
+    memset(operation, 0, sizeof(attribute_operation_t));
+    operation->value_handle = value_handle;
+    operation->write = write;
+    operation->value = value;
+    operation->request.callback_registration.callback = &attribute_operation_start;
+    operation->request.callback_registration.context = operation;
+    uint8_t status = gatt_client_request_to_send_gatt_query_for_attribute(&operation->request, con_handle, value_handle);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+}
+
+static uint16_t request_get_handle(const uint8_t * request){
+    return little_endian_read_16(request, 1);
+}
+
+static uint16_t request_get_offset(const uint8_t * request){
+    if (request[0] == ATT_READ_REQUEST) return 0;
+    CHECK_EQUAL(ATT_READ_BLOB_REQUEST, request[0]);
+    return little_endian_read_16(request, 3);
+}
+
+// let the ATT server respond to all requests pending at the start of a round
+// @return number of rounds until all bearers are idle
+static uint16_t process_requests_in_rounds(void){
+    uint16_t num_rounds = 0;
+    while (true){
+        bool eatt_pending[NUM_EATT_CHANNELS];
+        bool any_pending = mock_att_request_pending();
+        bool att_pending = any_pending;
+        uint8_t i;
+        for (i = 0; i < NUM_EATT_CHANNELS; i++){
+            eatt_pending[i] = mock_eatt_request_pending(i);
+            any_pending = any_pending || eatt_pending[i];
+        }
+        if (any_pending == false) break;
+        for (i = 0; i < NUM_EATT_CHANNELS; i++){
+            if (eatt_pending[i]){
+                mock_eatt_process_request(i);
+            }
+        }
+        if (att_pending){
+            mock_att_process_request();
+        }
+        num_rounds++;
+    }
+    return num_rounds;
+}
+
+TEST_GROUP(GATTClientEATT){
+    void setup(void){
+        eatt_connected = false;
+        write_log_len = 0;
+        read_log_len = 0;
+        num_query_complete = 0;
+        client_supported_features = 0;
+        long_read_num_query_complete = 0;
+        long_read_status = 0xff;
+        setup_database();
+        hci_setup_le_connection(con_handle);
+
+        // EATT setup runs on the unenhanced bearer
+        uint8_t status = gatt_client_le_enhanced_connect(&handle_gatt_client_event, con_handle, NUM_EATT_CHANNELS, eatt_storage_buffer, sizeof(eatt_storage_buffer));
+        CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+        CHECK_EQUAL(NUM_EATT_CHANNELS, mock_eatt_get_num_channels());
+        CHECK(client_supported_features & 2);  // EATT supported
+        uint8_t i;
+        for (i = 0; i < NUM_EATT_CHANNELS; i++){
+            CHECK_FALSE(eatt_connected);
+            mock_simulate_eatt_channel_opened(i, EATT_LOCAL_MTU, eatt_remote_mtus[i]);
+        }
+        CHECK_TRUE(eatt_connected);
+        CHECK_EQUAL(ERROR_CODE_SUCCESS, eatt_connected_status);
+        mock_set_att_requests_deferred(true);
+    }
+
+    void teardown(void){
+        mock_set_att_requests_deferred(false);
+        mock_simulate_eatt_channels_closed();
+        mock_simulate_disconnection_complete(con_handle);
+    }
+};
+
+TEST(GATTClientEATT, QueriesDispatchedToIdleBearers){
+    attribute_operation_t operations[NUM_CHARACTERISTICS];
+    uint8_t i;
+    for (i = 0; i < NUM_CHARACTERISTICS; i++){
+        attribute_operation_queue(&operations[i], value_handles[i], false, 0);
+    }
+
+    // one query on each EATT bearer and on the unenhanced bearer, last one queued
+    CHECK_TRUE(mock_eatt_request_pending(0));
+    CHECK_TRUE(mock_eatt_request_pending(1));
+    CHECK_TRUE(mock_att_request_pending());
+    CHECK_EQUAL(value_handles[0], request_get_handle(mock_eatt_get_request(0)));
+    CHECK_EQUAL(value_handles[1], request_get_handle(mock_eatt_get_request(1)));
+    CHECK_EQUAL(value_handles[2], request_get_handle(mock_att_get_request()));
+    CHECK_EQUAL(0, num_query_complete);
+
+    // response on second EATT bearer first, bearer continues with queued query
+    mock_eatt_process_request(1);
+    CHECK_EQUAL(1, num_query_complete);
+    CHECK_TRUE(mock_eatt_request_pending(1));
+    CHECK_EQUAL(value_handles[3], request_get_handle(mock_eatt_get_request(1)));
+
+    mock_att_process_request();
+    mock_eatt_process_request(0);
+    mock_eatt_process_request(1);
+    CHECK_EQUAL(NUM_CHARACTERISTICS, num_query_complete);
+    CHECK_FALSE(mock_eatt_request_pending(0));
+    CHECK_FALSE(mock_eatt_request_pending(1));
+    CHECK_FALSE(mock_att_request_pending());
+
+    // results reported in order of responses
+    const uint8_t expected_order[] = { 1, 2, 0, 3 };
+    CHECK_EQUAL(NUM_CHARACTERISTICS, read_log_len);
+    for (i = 0; i < NUM_CHARACTERISTICS; i++){
+        CHECK_EQUAL(value_handles[expected_order[i]], read_log_handles[i]);
+        CHECK_EQUAL(expected_order[i], read_log_values[i]);
+    }
+}
+
+TEST(GATTClientEATT, SameAttributeHandleKeepsOrder){
+    attribute_operation_t operations[4];
+    attribute_operation_queue(&operations[0], value_handles[0], true, 0x11);
+    attribute_operation_queue(&operations[1], value_handles[0], true, 0x22);
+    attribute_operation_queue(&operations[2], value_handles[1], false, 0);
+    attribute_operation_queue(&operations[3], value_handles[0], false, 0);
+
+    // second write and read wait for first write, read of other handle is not blocked
+    CHECK_TRUE(mock_eatt_request_pending(0));
+    CHECK_TRUE(mock_eatt_request_pending(1));
+    CHECK_FALSE(mock_att_request_pending());
+    CHECK_EQUAL(ATT_WRITE_REQUEST, mock_eatt_get_request(0)[0]);
+    CHECK_EQUAL(0x11, mock_eatt_get_request(0)[3]);
+    CHECK_EQUAL(value_handles[1], request_get_handle(mock_eatt_get_request(1)));
+
+    // completion for other handle does not start queued operations
+    mock_eatt_process_request(1);
+    CHECK_EQUAL(1, num_query_complete);
+    CHECK_FALSE(mock_eatt_request_pending(1));
+    CHECK_FALSE(mock_att_request_pending());
+
+    // each completion starts the next operation for the same handle
+    mock_eatt_process_request(0);
+    CHECK_EQUAL(2, num_query_complete);
+    CHECK_TRUE(mock_eatt_request_pending(0));
+    CHECK_FALSE(mock_eatt_request_pending(1));
+    CHECK_FALSE(mock_att_request_pending());
+    CHECK_EQUAL(ATT_WRITE_REQUEST, mock_eatt_get_request(0)[0]);
+    CHECK_EQUAL(0x22, mock_eatt_get_request(0)[3]);
+
+    mock_eatt_process_request(0);
+    CHECK_EQUAL(3, num_query_complete);
+    CHECK_TRUE(mock_eatt_request_pending(0));
+    CHECK_EQUAL(ATT_READ_REQUEST, mock_eatt_get_request(0)[0]);
+
+    mock_eatt_process_request(0);
+    CHECK_EQUAL(4, num_query_complete);
+
+    CHECK_EQUAL(2, write_log_len);
+    CHECK_EQUAL(0x11, write_log_values[0]);
+    CHECK_EQUAL(0x22, write_log_values[1]);
+    CHECK_EQUAL(2, read_log_len);
+    CHECK_EQUAL(value_handles[1], read_log_handles[0]);
+    CHECK_EQUAL(value_handles[0], read_log_handles[1]);
+    CHECK_EQUAL(0x22, read_log_values[1]);
+}
+
+TEST(GATTClientEATT, LongReadSpreadOverBearers){
+    static uint8_t buffer[LONG_VALUE_SIZE + 10];
+    gatt_client_long_read_t long_read;
+    memset(buffer, 0, sizeof(buffer));
+    uint8_t status = gatt_client_read_long_value_of_characteristic_into_buffer(&long_read, &handle_long_read_event, con_handle, long_value_handle, buffer, sizeof(buffer));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+
+    // consecutive offsets with blob length of each bearer's MTU
+    uint16_t offset = 0;
+    uint8_t i;
+    for (i = 0; i < NUM_EATT_CHANNELS; i++){
+        CHECK_TRUE(mock_eatt_request_pending(i));
+        CHECK_EQUAL(long_value_handle, request_get_handle(mock_eatt_get_request(i)));
+        CHECK_EQUAL(offset, request_get_offset(mock_eatt_get_request(i)));
+        offset += eatt_remote_mtus[i] - 1;
+    }
+    CHECK_TRUE(mock_att_request_pending());
+    CHECK_EQUAL(offset, request_get_offset(mock_att_get_request()));
+
+    process_requests_in_rounds();
+    CHECK_EQUAL(1, long_read_num_query_complete);
+    CHECK_EQUAL(ATT_ERROR_SUCCESS, long_read_status);
+    CHECK_EQUAL(LONG_VALUE_SIZE, gatt_client_long_read_get_value_length(&long_read));
+    MEMCMP_EQUAL(long_value, buffer, LONG_VALUE_SIZE);
+}
+
+TEST(GATTClientEATT, LongReadInvalidOffsetEndsRead){
+    static uint8_t buffer[LONG_VALUE_SIZE];
+    gatt_client_long_read_t long_read;
+    uint8_t status = gatt_client_read_long_value_of_characteristic_into_buffer(&long_read, &handle_long_read_event, con_handle, short_long_value_handle, buffer, sizeof(buffer));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+
+    // request on unenhanced bearer is beyond end of value
+    uint16_t att_offset = request_get_offset(mock_att_get_request());
+    CHECK(att_offset > SHORT_LONG_VALUE_SIZE);
+    mock_att_process_request();
+    CHECK_EQUAL(0, long_read_num_query_complete);
+    CHECK_FALSE(mock_att_request_pending());
+
+    // short blob on second bearer, no further requests
+    mock_eatt_process_request(1);
+    CHECK_EQUAL(0, long_read_num_query_complete);
+    CHECK_FALSE(mock_eatt_request_pending(1));
+
+    // last outstanding request completes read
+    mock_eatt_process_request(0);
+    CHECK_FALSE(mock_eatt_request_pending(0));
+    CHECK_EQUAL(1, long_read_num_query_complete);
+    CHECK_EQUAL(ATT_ERROR_SUCCESS, long_read_status);
+    CHECK_EQUAL(SHORT_LONG_VALUE_SIZE, gatt_client_long_read_get_value_length(&long_read));
+    MEMCMP_EQUAL(long_value, buffer, SHORT_LONG_VALUE_SIZE);
+}
+
+TEST(GATTClientEATT, LongReadThroughput){
+    static uint8_t buffer[LONG_VALUE_SIZE];
+    gatt_client_long_read_t long_read;
+
+    // Read Long Characteristic Value on a single bearer
+    uint8_t status = gatt_client_read_long_value_of_characteristic_using_value_handle(&handle_gatt_client_event, con_handle, long_value_handle);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+    uint16_t single_bearer_rounds = process_requests_in_rounds();
+    CHECK_EQUAL(1, num_query_complete);
+
+    // Read Blob requests spread over all bearers
+    status = gatt_client_read_long_value_of_characteristic_into_buffer(&long_read, &handle_long_read_event, con_handle, long_value_handle, buffer, sizeof(buffer));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+    uint16_t all_bearers_rounds = process_requests_in_rounds();
+    CHECK_EQUAL(1, long_read_num_query_complete);
+    MEMCMP_EQUAL(long_value, buffer, LONG_VALUE_SIZE);
+
+    printf("Long read of %u bytes: %u ATT round trips on one bearer, %u on %u bearers, %u vs. %u bytes per round trip\n",
+           LONG_VALUE_SIZE, single_bearer_rounds, all_bearers_rounds, NUM_EATT_CHANNELS + 1,
+           LONG_VALUE_SIZE / single_bearer_rounds, LONG_VALUE_SIZE / all_bearers_rounds);
+
+    // one bearer with MTU 64 needs 9 rounds, all bearers read 63 + 99 + 22 bytes per round
+    CHECK_EQUAL((LONG_VALUE_SIZE / (eatt_remote_mtus[0] - 1)) + 1, single_bearer_rounds);
+    CHECK(all_bearers_rounds <= 3);
+}
+
+int main (int argc, const char * argv[]){
+    btstack_memory_init();
+    gatt_client_init();
+    gatt_client_mtu_enable_auto_negotiation(0);
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
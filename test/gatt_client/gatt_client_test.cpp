@@ -970,6 +970,51 @@ TEST(GATTClient, TestReadLongCharacteristicValue){
 	CHECK_EQUAL(4, result_counter);
 }
 
+static uint8_t long_read_status;
+static void handle_long_read_event(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size){
+	UNUSED(channel);
+	UNUSED(size);
+	if (packet_type != HCI_EVENT_PACKET) return;
+	CHECK_EQUAL(GATT_EVENT_QUERY_COMPLETE, packet[0]);
+	long_read_status = packet[4];
+	gatt_query_complete++;
+}
+
+TEST(GATTClient, TestReadLongCharacteristicValueIntoBuffer){
+	test = READ_LONG_CHARACTERISTIC_VALUE;
+	reset_query_state();
+	status = gatt_client_discover_primary_services_by_uuid16(handle_ble_client_event, gatt_client_handle, service_uuid16);
+	CHECK_EQUAL(0, status);
+	CHECK_EQUAL(1, gatt_query_complete);
+
+	reset_query_state();
+	status = gatt_client_discover_characteristics_for_service_by_uuid16(handle_ble_client_event, gatt_client_handle, &services[0], 0xF100);
+	CHECK_EQUAL(0, status);
+	CHECK_EQUAL(1, gatt_query_complete);
+
+	gatt_client_long_read_t long_read;
+	uint8_t buffer[100];
+	reset_query_state();
+	status = gatt_client_read_long_value_of_characteristic_into_buffer(&long_read, handle_long_read_event, gatt_client_handle, characteristics[0].value_handle, buffer, sizeof(buffer));
+	CHECK_EQUAL(0, status);
+	CHECK_EQUAL(1, gatt_query_complete);
+	CHECK_EQUAL(ATT_ERROR_SUCCESS, long_read_status);
+	CHECK_EQUAL(long_value_length, gatt_client_long_read_get_value_length(&long_read));
+	CHECK_EQUAL_ARRAY((uint8_t *) long_value, buffer, long_value_length);
+
+	// value does not fit into buffer
+	reset_query_state();
+	status = gatt_client_read_long_value_of_characteristic_into_buffer(&long_read, handle_long_read_event, gatt_client_handle, characteristics[0].value_handle, buffer, 20);
+	CHECK_EQUAL(0, status);
+	CHECK_EQUAL(1, gatt_query_complete);
+	CHECK_EQUAL(GATT_CLIENT_VALUE_TOO_LONG, long_read_status);
+	CHECK_EQUAL(20, gatt_client_long_read_get_value_length(&long_read));
+	CHECK_EQUAL_ARRAY((uint8_t *) long_value, buffer, 20);
+
+	status = gatt_client_read_long_value_of_characteristic_into_buffer(&long_read, handle_long_read_event, HCI_CON_HANDLE_INVALID, characteristics[0].value_handle, buffer, sizeof(buffer));
+	CHECK_EQUAL(ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER, status);
+}
+
 TEST(GATTClient, TestReadLongCharacteristicDescriptor){
 	test = READ_LONG_CHARACTERISTIC_DESCRIPTOR;
 	reset_query_state();
@@ -1047,6 +1092,37 @@ TEST(GATTClient, TestWriteLongCharacteristicValue){
 	CHECK_EQUAL(1, gatt_query_complete);
 }
 
+static uint16_t long_write_source_calls;
+static void long_write_source(void * context, uint16_t offset, uint8_t * buffer, uint16_t size){
+	const uint8_t * value = (const uint8_t *) context;
+	memcpy(buffer, &value[offset], size);
+	long_write_source_calls++;
+}
+
+TEST(GATTClient, TestWriteLongCharacteristicValueFromSource){
+	test = WRITE_LONG_CHARACTERISTIC_VALUE;
+	reset_query_state();
+	status = gatt_client_discover_primary_services_by_uuid16(handle_ble_client_event, gatt_client_handle, service_uuid16);
+	CHECK_EQUAL(0, status);
+	CHECK_EQUAL(1, gatt_query_complete);
+
+	reset_query_state();
+	status = gatt_client_discover_characteristics_for_service_by_uuid16(handle_ble_client_event, gatt_client_handle, &services[0], 0xF100);
+	CHECK_EQUAL(0, status);
+	CHECK_EQUAL(1, gatt_query_complete);
+
+	reset_query_state();
+	long_write_source_calls = 0;
+	status = gatt_client_write_long_value_of_characteristic_from_source(handle_ble_client_event, gatt_client_handle, characteristics[0].value_handle, long_value_length, &long_write_source, (void *) long_value);
+	CHECK_EQUAL(0, status);
+	CHECK_EQUAL(1, gatt_query_complete);
+	CHECK_EQUAL(1, result_counter);
+	CHECK(long_write_source_calls > 1);
+
+	status = gatt_client_write_long_value_of_characteristic_from_source(handle_ble_client_event, HCI_CON_HANDLE_INVALID, characteristics[0].value_handle, long_value_length, &long_write_source, (void *) long_value);
+	CHECK_EQUAL(ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER, status);
+}
+
 TEST(GATTClient, TestWriteReliableLongCharacteristicValue){
 	test = WRITE_RELIABLE_LONG_CHARACTERISTIC_VALUE;
 	reset_query_state();
@@ -1309,6 +1385,66 @@ TEST(GATTClient, gatt_client_request_to_send_gatt_query){
     CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
 }
 
+static uint8_t attribute_query_order[3];
+static uint8_t attribute_query_count;
+static uint16_t attribute_query_handle;
+
+static void attribute_query_callback(void * context){
+    attribute_query_order[attribute_query_count++] = (uint8_t)(uintptr_t) context;
+    uint8_t status = gatt_client_read_value_of_characteristic_using_value_handle(handle_ble_client_event, gatt_client_handle, attribute_query_handle);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+}
+
+TEST(GATTClient, gatt_client_request_to_send_gatt_query_for_attribute){
+    gatt_client_attribute_query_request_t requests[3];
+    uint8_t i;
+    for (i=0;i<3;i++){
+        memset(&requests[i], 0, sizeof(gatt_client_attribute_query_request_t));
+        requests[i].callback_registration.callback = &attribute_query_callback;
+        requests[i].callback_registration.context = (void*)(uintptr_t)(i + 1);
+    }
+    attribute_query_count = 0;
+
+    test = READ_CHARACTERISTIC_VALUE;
+    reset_query_state();
+    status = gatt_client_discover_primary_services_by_uuid16(handle_ble_client_event, gatt_client_handle, service_uuid16);
+    CHECK_EQUAL(0, status);
+    reset_query_state();
+    status = gatt_client_discover_characteristics_for_service_by_uuid16(handle_ble_client_event, gatt_client_handle, &services[0], 0xF100);
+    CHECK_EQUAL(0, status);
+    attribute_query_handle = characteristics[0].value_handle;
+
+    status = gatt_client_request_to_send_gatt_query_for_attribute(&requests[0], HCI_CON_HANDLE_INVALID, 0x10);
+    CHECK_EQUAL(ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER, status);
+
+    // queue while busy
+    reset_query_state();
+    set_wrong_gatt_client_state();
+    get_gatt_client(gatt_client_handle)->query_attribute_handle = 0x10;
+    status = gatt_client_request_to_send_gatt_query_for_attribute(&requests[0], gatt_client_handle, 0x10);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+    status = gatt_client_request_to_send_gatt_query_for_attribute(&requests[1], gatt_client_handle, 0x20);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+    status = gatt_client_request_to_send_gatt_query_for_attribute(&requests[2], gatt_client_handle, 0x10);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+    status = gatt_client_request_to_send_gatt_query_for_attribute(&requests[2], gatt_client_handle, 0x10);
+    CHECK_EQUAL(ERROR_CODE_COMMAND_DISALLOWED, status);
+    CHECK_EQUAL(0, attribute_query_count);
+
+    // dispatched in order after ready
+    reset_query_state();
+    btstack_context_callback_registration_t callback_registration = { 0 };
+    callback_registration.callback = &dummy_callback;
+    status = gatt_client_request_to_send_gatt_query(&callback_registration, gatt_client_handle);
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, status);
+    CHECK_EQUAL(1, gatt_query_complete);
+    CHECK_EQUAL(3, attribute_query_count);
+    CHECK_EQUAL(1, attribute_query_order[0]);
+    CHECK_EQUAL(2, attribute_query_order[1]);
+    CHECK_EQUAL(3, attribute_query_order[2]);
+    CHECK_EQUAL(0x10, get_gatt_client(gatt_client_handle)->query_attribute_handle);
+}
+
 TEST(GATTClient, gatt_client_send_mtu_negotiation){
 	gatt_client_send_mtu_negotiation(handle_ble_client_event, HCI_CON_HANDLE_INVALID);
 
@@ -10,6 +10,7 @@
 #include "ble/sm.h"
 #include "gap.h"
 #include "btstack_debug.h"
+#include "bluetooth_psm.h"
 
 #define PREBUFFER_SIZE (HCI_INCOMING_PRE_BUFFER_SIZE + 8)
 #define TEST_MAX_MTU 23
@@ -24,6 +25,10 @@ static hci_connection_t hci_connection;
 
 static uint8_t packet_buffer[256];
 static uint16_t packet_buffer_len;
+static uint32_t att_requests_sent;
+static bool     att_requests_deferred;
+static uint8_t  att_deferred_request[TEST_MAX_MTU];
+static uint16_t att_deferred_request_len;
 
 uint16_t get_gatt_client_handle(void){
 	return gatt_client_handle;
@@ -70,6 +75,19 @@ void mock_simulate_connected(void){
 	registered_hci_event_handler(HCI_EVENT_PACKET, 0, gap_event, sizeof(gap_event));
 }
 
+void mock_simulate_disconnection_complete(uint16_t con_handle){
+	uint8_t packet[] = {HCI_EVENT_DISCONNECTION_COMPLETE, 4, 0, (uint8_t) (con_handle & 0xff), (uint8_t) (con_handle >> 8), 0x13};
+	registered_hci_event_handler(HCI_EVENT_PACKET, 0, (uint8_t *)&packet, sizeof(packet));
+}
+
+void mock_simulate_att_server_packet(uint16_t con_handle, uint8_t * packet, uint16_t size){
+	att_packet_handler(ATT_DATA_PACKET, con_handle, packet, size);
+}
+
+uint32_t mock_get_att_requests_sent(void){
+	return att_requests_sent;
+}
+
 void mock_simulate_scan_response(void){
 	uint8_t packet[] = {GAP_EVENT_ADVERTISING_REPORT, 0x13, 0xE2, 0x01, 0x34, 0xB1, 0xF7, 0xD1, 0x77, 0x9B, 0xCC, 0x09, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
 	registered_hci_event_handler(HCI_EVENT_PACKET, 0, (uint8_t *)&packet, sizeof(packet));
@@ -176,18 +194,159 @@ void l2cap_request_can_send_fix_channel_now_event(uint16_t handle, uint16_t chan
 	att_packet_handler(HCI_EVENT_PACKET, 0, (uint8_t*)event, sizeof(event));
 }
 
-uint8_t l2cap_send_prepared_connectionless(uint16_t handle, uint16_t cid, uint16_t len){
+static void mock_att_handle_request(uint8_t * request, uint16_t len){
 	att_connection_t att_connection;
 	att_init_connection(&att_connection);
 	uint8_t response_buffer[PREBUFFER_SIZE + TEST_MAX_MTU];
 	uint8_t * response = &response_buffer[PREBUFFER_SIZE];
-	uint16_t response_len = att_handle_request(&att_connection, l2cap_get_outgoing_buffer(), len, response);
+	uint16_t response_len = att_handle_request(&att_connection, request, len, response);
 	if (response_len){
 		att_packet_handler(ATT_DATA_PACKET, gatt_client_handle, &response[0], response_len);
 	}
+}
+
+// by default, the ATT server responds before l2cap_send_prepared_connectionless returns
+void mock_set_att_requests_deferred(bool deferred){
+	att_requests_deferred = deferred;
+	att_deferred_request_len = 0;
+}
+
+bool mock_att_request_pending(void){
+	return att_deferred_request_len > 0;
+}
+
+const uint8_t * mock_att_get_request(void){
+	return att_deferred_request;
+}
+
+void mock_att_process_request(void){
+	btstack_assert(att_deferred_request_len > 0);
+	uint16_t len = att_deferred_request_len;
+	att_deferred_request_len = 0;
+	mock_att_handle_request(att_deferred_request, len);
+}
+
+uint8_t l2cap_send_prepared_connectionless(uint16_t handle, uint16_t cid, uint16_t len){
+	att_requests_sent++;
+	if (att_requests_deferred){
+		btstack_assert(att_deferred_request_len == 0);
+		memcpy(att_deferred_request, l2cap_get_outgoing_buffer(), len);
+		att_deferred_request_len = len;
+		return ERROR_CODE_SUCCESS;
+	}
+	mock_att_handle_request(l2cap_get_outgoing_buffer(), len);
 	return ERROR_CODE_SUCCESS;
 }
 
+#ifdef ENABLE_GATT_OVER_EATT
+// EATT bearers: requests are stored until the test lets the ATT server respond via mock_eatt_process_request
+#define MOCK_MAX_EATT_CHANNELS 5
+#define MOCK_EATT_MAX_MTU      256
+
+typedef struct {
+	uint16_t local_cid;
+	uint16_t remote_mtu;
+	uint16_t request_len;
+	uint8_t  request[MOCK_EATT_MAX_MTU];
+} mock_eatt_channel_t;
+
+static btstack_packet_handler_t eatt_packet_handler;
+static mock_eatt_channel_t eatt_channels[MOCK_MAX_EATT_CHANNELS];
+static uint8_t eatt_num_channels;
+
+uint8_t l2cap_ecbm_create_channels(btstack_packet_handler_t packet_handler, hci_con_handle_t con_handle,
+                                       gap_security_level_t security_level,
+                                       uint16_t psm, uint8_t num_channels, uint16_t initial_credits, uint16_t receive_buffer_size,
+                                       uint8_t ** receive_buffers, uint16_t * out_local_cids){
+	btstack_assert(num_channels <= MOCK_MAX_EATT_CHANNELS);
+	eatt_packet_handler = packet_handler;
+	eatt_num_channels = num_channels;
+	uint8_t i;
+	for (i=0;i<num_channels;i++){
+		memset(&eatt_channels[i], 0, sizeof(mock_eatt_channel_t));
+		eatt_channels[i].local_cid = 0x41 + i;
+		out_local_cids[i] = eatt_channels[i].local_cid;
+	}
+	return ERROR_CODE_SUCCESS;
+}
+
+uint8_t mock_eatt_get_num_channels(void){
+	return eatt_num_channels;
+}
+
+void mock_simulate_eatt_channel_opened(uint8_t index, uint16_t local_mtu, uint16_t remote_mtu){
+	mock_eatt_channel_t * channel = &eatt_channels[index];
+	channel->remote_mtu = remote_mtu;
+	uint8_t event[23];
+	memset(event, 0, sizeof(event));
+	event[0] = L2CAP_EVENT_ECBM_CHANNEL_OPENED;
+	event[1] = sizeof(event) - 2;
+	event[2] = ERROR_CODE_SUCCESS;
+	little_endian_store_16(event, 10, gatt_client_handle);
+	little_endian_store_16(event, 13, BLUETOOTH_PSM_EATT);
+	little_endian_store_16(event, 15, channel->local_cid);
+	little_endian_store_16(event, 17, channel->local_cid);
+	little_endian_store_16(event, 19, local_mtu);
+	little_endian_store_16(event, 21, remote_mtu);
+	eatt_packet_handler(HCI_EVENT_PACKET, 0, event, sizeof(event));
+}
+
+uint8_t l2cap_send(uint16_t local_cid, const uint8_t *data, uint16_t len){
+	uint8_t i;
+	for (i=0;i<eatt_num_channels;i++){
+		mock_eatt_channel_t * channel = &eatt_channels[i];
+		if (channel->local_cid != local_cid) continue;
+		// a bearer has at most one outstanding request
+		btstack_assert(channel->request_len == 0);
+		btstack_assert(len <= channel->remote_mtu);
+		memcpy(channel->request, data, len);
+		channel->request_len = len;
+		att_requests_sent++;
+		return ERROR_CODE_SUCCESS;
+	}
+	return L2CAP_LOCAL_CID_DOES_NOT_EXIST;
+}
+
+bool mock_eatt_request_pending(uint8_t index){
+	return eatt_channels[index].request_len > 0;
+}
+
+const uint8_t * mock_eatt_get_request(uint8_t index){
+	return eatt_channels[index].request;
+}
+
+void mock_eatt_process_request(uint8_t index){
+	mock_eatt_channel_t * channel = &eatt_channels[index];
+	btstack_assert(channel->request_len > 0);
+	att_connection_t att_connection;
+	att_init_connection(&att_connection);
+	att_connection.mtu = channel->remote_mtu;
+	att_connection.max_mtu = channel->remote_mtu;
+	uint8_t response[MOCK_EATT_MAX_MTU];
+	uint16_t response_len = att_handle_request(&att_connection, channel->request, channel->request_len, response);
+	channel->request_len = 0;
+	if (response_len){
+		eatt_packet_handler(L2CAP_DATA_PACKET, channel->local_cid, response, response_len);
+	}
+}
+
+void mock_simulate_eatt_channels_closed(void){
+	uint8_t i;
+	for (i=0;i<eatt_num_channels;i++){
+		uint8_t event[4];
+		event[0] = L2CAP_EVENT_CHANNEL_CLOSED;
+		event[1] = sizeof(event) - 2;
+		little_endian_store_16(event, 2, eatt_channels[i].local_cid);
+		eatt_packet_handler(HCI_EVENT_PACKET, 0, event, sizeof(event));
+	}
+	eatt_num_channels = 0;
+}
+
+uint8_t l2cap_disconnect(uint16_t local_cid){
+	return ERROR_CODE_SUCCESS;
+}
+#endif
+
 void sm_add_event_handler(btstack_packet_callback_registration_t * callback_handler){
 }
 
@@ -197,8 +356,12 @@ int  sm_cmac_ready(void){
 void sm_cmac_signed_write_start(const sm_key_t key, uint8_t opcode, uint16_t attribute_handle, uint16_t message_len, const uint8_t * message, uint32_t sign_counter, void (*done_callback)(uint8_t * hash)){
 	//sm_notify_client(SM_EVENT_IDENTITY_RESOLVING_SUCCEEDED, sm_central_device_addr_type, sm_central_device_address, 0, sm_central_device_matched);      
 }
+static int mock_le_device_index;
+void mock_set_le_device_index(int le_device_index){
+	mock_le_device_index = le_device_index;
+}
 int sm_le_device_index(uint16_t handle ){
-	return 0;
+	return mock_le_device_index;
 }
 void sm_send_security_request(hci_con_handle_t con_handle){
 }
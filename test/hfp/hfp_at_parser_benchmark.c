@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+// *****************************************************************************
+//
+// HFP AT Parser Benchmark
+//
+// Replays the captured PTS AT transcripts from test_sequences.c through the
+// byte-wise parser hfp_parse() and the buffer-oriented hfp_parse_buffer()
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "classic/hfp.h"
+#include "test_sequences.h"
+
+#define TRANSCRIPT_MAX_SIZE 200000
+#define RFCOMM_PAYLOAD_SIZE 127
+#define NUM_ITERATIONS      200
+
+typedef struct {
+    uint8_t  data[TRANSCRIPT_MAX_SIZE];
+    uint32_t size;
+    uint32_t num_lines;
+} transcript_t;
+
+static transcript_t transcript_ag;
+static transcript_t transcript_hf;
+static hfp_connection_t hfp_connection;
+
+static hfp_custom_at_command_t custom_ag_command = { NULL, "AT+XAPL=", 1 };
+static hfp_custom_at_command_t custom_hf_command = { NULL, "+XAPL=",   2 };
+
+static void transcript_add_line(transcript_t * transcript, const char * line){
+    uint32_t len = (uint32_t) strlen(line);
+    if ((transcript->size + len + 4) > TRANSCRIPT_MAX_SIZE) return;
+    memcpy(&transcript->data[transcript->size], "\r\n", 2);
+    memcpy(&transcript->data[transcript->size + 2], line, len);
+    memcpy(&transcript->data[transcript->size + 2 + len], "\r\n", 2);
+    transcript->size += len + 4;
+    transcript->num_lines++;
+}
+
+static void transcript_add_tests(hfp_test_item_t * tests, int num_tests){
+    int i;
+    for (i = 0; i < num_tests; i++){
+        int j;
+        for (j = 0; j < tests[i].len; j++){
+            const char * line = tests[i].test[j];
+            // skip user actions
+            if (strncmp(line, "USER:", 5) == 0) continue;
+            // AG receives AT commands, HF receives result codes
+            if (strncmp(line, "AT", 2) == 0){
+                transcript_add_line(&transcript_ag, line);
+            } else {
+                transcript_add_line(&transcript_hf, line);
+            }
+        }
+    }
+}
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+}
+
+static void replay_bytewise(const transcript_t * transcript, int is_handsfree){
+    memset(&hfp_connection, 0, sizeof(hfp_connection_t));
+    uint32_t pos;
+    for (pos = 0; pos < transcript->size; pos++){
+        hfp_parse(&hfp_connection, transcript->data[pos], is_handsfree);
+    }
+}
+
+static void replay_buffer(const transcript_t * transcript, int is_handsfree){
+    memset(&hfp_connection, 0, sizeof(hfp_connection_t));
+    uint32_t offset;
+    for (offset = 0; offset < transcript->size; offset += RFCOMM_PAYLOAD_SIZE){
+        uint16_t size = (uint16_t) btstack_min(RFCOMM_PAYLOAD_SIZE, transcript->size - offset);
+        uint16_t pos = 0;
+        while (pos < size){
+            pos += hfp_parse_buffer(&hfp_connection, &transcript->data[offset + pos], size - pos, is_handsfree);
+        }
+    }
+}
+
+static void benchmark(const char * name, const transcript_t * transcript, int is_handsfree){
+    int i;
+    double start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        replay_bytewise(transcript, is_handsfree);
+    }
+    double bytewise_duration = time_now() - start;
+
+    start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        replay_buffer(transcript, is_handsfree);
+    }
+    double buffer_duration = time_now() - start;
+
+    double num_lines = (double) transcript->num_lines * NUM_ITERATIONS;
+    printf("%s: %u lines, %u bytes\n", name, transcript->num_lines, transcript->size);
+    printf("- hfp_parse:        %10.0f lines/s\n", num_lines / bytewise_duration);
+    printf("- hfp_parse_buffer: %10.0f lines/s\n", num_lines / buffer_duration);
+}
+
+int main(int argc, const char * argv[]){
+    (void) argc;
+    (void) argv;
+
+    hfp_init();
+    hfp_register_custom_ag_command(&custom_ag_command);
+    hfp_register_custom_hf_command(&custom_hf_command);
+
+    transcript_add_tests(hfp_cc_tests(),          hfp_cc_tests_size());
+    transcript_add_tests(hfp_pts_ag_slc_tests(),  hfp_pts_ag_slc_tests_size());
+    transcript_add_tests(hfp_pts_hf_slc_tests(),  hfp_pts_hf_slc_tests_size());
+    transcript_add_tests(hfp_pts_ag_ata_tests(),  hfp_pts_ag_ata_tests_size());
+    transcript_add_tests(hfp_pts_hf_ata_tests(),  hfp_pts_hf_ata_tests_size());
+    transcript_add_tests(hfp_pts_ag_twc_tests(),  hfp_pts_ag_twc_tests_size());
+    transcript_add_tests(hfp_pts_hf_twc_tests(),  hfp_pts_hf_twc_tests_size());
+    transcript_add_tests(hfp_pts_ag_ecs_tests(),  hfp_pts_ag_ecs_tests_size());
+    transcript_add_tests(hfp_pts_hf_ecs_tests(),  hfp_pts_hf_ecs_tests_size());
+    transcript_add_tests(hfp_pts_ag_ecc_tests(),  hfp_pts_ag_ecc_tests_size());
+    transcript_add_tests(hfp_pts_hf_ecc_tests(),  hfp_pts_hf_ecc_tests_size());
+    transcript_add_tests(hfp_pts_ag_rhh_tests(),  hfp_pts_ag_rhh_tests_size());
+    transcript_add_tests(hfp_pts_hf_rhh_tests(),  hfp_pts_hf_rhh_tests_size());
+
+    benchmark("AG", &transcript_ag, 0);
+    benchmark("HF", &transcript_hf, 1);
+
+    hfp_deinit();
+    return 0;
+}
@@ -651,6 +651,47 @@ TEST(HFPParser, custom_command_hf_with_assignment){
     hfp_at_parser_test_dump_line_buffer();
 }
 
+TEST(HFPParser, custom_command_ag_overrides_builtin){
+    hfp_custom_at_command_t custom_ag_command = {
+            .command = "AT+CLCC",
+            .command_id = 4
+    };
+    hfp_register_custom_ag_command(&custom_ag_command);
+    parse_ag("\r\nAT+CLCC\r\n");
+    CHECK_EQUAL(HFP_CMD_CUSTOM_MESSAGE, context.command);
+    CHECK_EQUAL(4, context.custom_at_command_id);
+}
+
+TEST(HFPParser, parse_buffer_stops_at_end_of_line){
+    const char * data = "AT+BRSF=1007\rAT+CIND=?\r";
+    uint16_t size = (uint16_t) strlen(data);
+    uint16_t pos = hfp_parse_buffer(&context, (const uint8_t *) data, size, 0);
+    CHECK_EQUAL(13, pos);
+    CHECK_EQUAL(HFP_CMD_SUPPORTED_FEATURES, context.command);
+    CHECK_EQUAL(1007, context.remote_supported_features);
+    pos += hfp_parse_buffer(&context, (const uint8_t *) &data[pos], size - pos, 0);
+    CHECK_EQUAL(size, pos);
+    CHECK_EQUAL(HFP_CMD_RETRIEVE_AG_INDICATORS, context.command);
+}
+
+TEST(HFPParser, parse_buffer_matches_bytewise_parsing){
+    static hfp_connection_t buffer_context;
+    const char * data = "\r\n+CIND: (\"service\",(0,1)),(\"call\",(0,1)),(\"callsetup\",(0,3)),"
+                        "(\"battchg\",(0,5)),(\"signal\",(0,5)),(\"roam\",(0,1)),(\"callheld\",(0,2))\r\n"
+                        "\r\n+COPS: 1,0,\"sunrise\"\r\n\r\n+CLCC: 1,1,0,0,0,\"+41791234567\",145\r\n\r\nOK\r\n";
+    uint16_t size = (uint16_t) strlen(data);
+
+    context.state = HFP_W4_RETRIEVE_INDICATORS;
+    memcpy(&buffer_context, &context, sizeof(hfp_connection_t));
+
+    parse_hf(data);
+    uint16_t pos = 0;
+    while (pos < size){
+        pos += hfp_parse_buffer(&buffer_context, (const uint8_t *) &data[pos], size - pos, 1);
+    }
+    MEMCMP_EQUAL(&context, &buffer_context, sizeof(hfp_connection_t));
+}
+
 int main (int argc, const char * argv[]){
     return CommandLineTestRunner::RunAllTests(argc, argv);
 }
@@ -584,6 +584,89 @@ TEST(HID, GetReportSize){
     CHECK_EQUAL(8, report_size);
 }
 
+static btstack_hid_layout_report_t layout_reports[HID_REPORT_LAYOUT_MAX_REPORTS];
+static btstack_hid_layout_field_t  layout_fields[HID_REPORT_LAYOUT_MAX_FIELDS];
+
+// fields extracted with compiled layout match fields provided by parser
+static void expect_layout_matches_parser(const uint8_t * descriptor, uint16_t descriptor_len, const uint8_t * report, uint16_t report_len){
+    btstack_hid_layout_t layout;
+    btstack_hid_layout_init(&layout, layout_reports, HID_REPORT_LAYOUT_MAX_REPORTS, layout_fields, HID_REPORT_LAYOUT_MAX_FIELDS);
+    CHECK_EQUAL(true, btstack_hid_layout_compile(&layout, descriptor, descriptor_len, HID_REPORT_TYPE_INPUT));
+    btstack_hid_parser_t parser;
+    btstack_hid_parser_init(&parser, descriptor, descriptor_len, HID_REPORT_TYPE_INPUT, report, report_len);
+    btstack_hid_layout_iterator_t iterator;
+    btstack_hid_layout_iterator_init(&iterator, &layout, report, report_len);
+    while (btstack_hid_parser_has_more(&parser)){
+        uint16_t usage_page;
+        uint16_t usage;
+        int32_t value;
+        btstack_hid_parser_get_field(&parser, &usage_page, &usage, &value);
+        CHECK_EQUAL(true, btstack_hid_layout_iterator_has_more(&iterator));
+        uint16_t layout_usage_page;
+        uint16_t layout_usage;
+        int32_t layout_value;
+        btstack_hid_layout_iterator_get_field(&iterator, &layout_usage_page, &layout_usage, &layout_value);
+        CHECK_EQUAL(usage_page, layout_usage_page);
+        CHECK_EQUAL(usage, layout_usage);
+        CHECK_EQUAL(value, layout_value);
+    }
+    CHECK_EQUAL(false, btstack_hid_layout_iterator_has_more(&iterator));
+}
+
+TEST(HID, LayoutMatchesParser){
+    expect_layout_matches_parser(mouse_descriptor_without_report_id, sizeof(mouse_descriptor_without_report_id), mouse_report_without_id_positive_xy, sizeof(mouse_report_without_id_positive_xy));
+    expect_layout_matches_parser(mouse_descriptor_without_report_id, sizeof(mouse_descriptor_without_report_id), mouse_report_without_id_negative_xy, sizeof(mouse_report_without_id_negative_xy));
+    expect_layout_matches_parser(mouse_descriptor_with_report_id, sizeof(mouse_descriptor_with_report_id), mouse_report_with_id_1, sizeof(mouse_report_with_id_1));
+    expect_layout_matches_parser(hid_descriptor_keyboard_boot_mode, sizeof(hid_descriptor_keyboard_boot_mode), keyboard_report1, sizeof(keyboard_report1));
+    expect_layout_matches_parser(combo_descriptor_with_report_ids, sizeof(combo_descriptor_with_report_ids), combo_report1, sizeof(combo_report1));
+    expect_layout_matches_parser(combo_descriptor_with_report_ids, sizeof(combo_descriptor_with_report_ids), combo_report2, sizeof(combo_report2));
+    expect_layout_matches_parser(tank_mouse_descriptor, sizeof(tank_mouse_descriptor), tank_mouse_report, sizeof(tank_mouse_report));
+    expect_layout_matches_parser(xbox_wireless_descriptor, sizeof(xbox_wireless_descriptor), xbox_wireless_report, sizeof(xbox_wireless_report));
+}
+
+TEST(HID, LayoutReports){
+    btstack_hid_layout_t layout;
+    btstack_hid_layout_init(&layout, layout_reports, HID_REPORT_LAYOUT_MAX_REPORTS, layout_fields, HID_REPORT_LAYOUT_MAX_FIELDS);
+
+    // report size matches btstack_hid_get_report_size_for_id
+    CHECK_EQUAL(true, btstack_hid_layout_compile(&layout, combo_descriptor_with_report_ids, sizeof(combo_descriptor_with_report_ids), HID_REPORT_TYPE_INPUT));
+    CHECK_EQUAL(true, layout.report_id_declared);
+    CHECK_EQUAL(2, layout.num_reports);
+    CHECK_EQUAL(3, btstack_hid_layout_get_report_size(&layout, 1));
+    CHECK_EQUAL(btstack_hid_get_report_size_for_id(2, HID_REPORT_TYPE_INPUT, sizeof(combo_descriptor_with_report_ids), combo_descriptor_with_report_ids),
+                btstack_hid_layout_get_report_size(&layout, 2));
+    CHECK_EQUAL(0, btstack_hid_layout_get_report_size(&layout, 3));
+
+    CHECK_EQUAL(true, btstack_hid_layout_compile(&layout, hid_descriptor_keyboard_boot_mode, sizeof(hid_descriptor_keyboard_boot_mode), HID_REPORT_TYPE_OUTPUT));
+    CHECK_EQUAL(false, layout.report_id_declared);
+    CHECK_EQUAL(1, btstack_hid_layout_get_report_size(&layout, 0));
+
+    // direct access to field
+    CHECK_EQUAL(true, btstack_hid_layout_compile(&layout, tank_mouse_descriptor, sizeof(tank_mouse_descriptor), HID_REPORT_TYPE_INPUT));
+    CHECK_EQUAL(6, btstack_hid_layout_get_report_size(&layout, 3));
+    const btstack_hid_layout_field_t * field_y = btstack_hid_layout_find_field(&layout, 3, 1, 0x31);
+    CHECK(field_y != NULL);
+    CHECK_EQUAL(16, field_y->bit_size);
+    CHECK_EQUAL(-10, btstack_hid_layout_get_value(field_y, tank_mouse_report, sizeof(tank_mouse_report)));
+    POINTERS_EQUAL(NULL, btstack_hid_layout_find_field(&layout, 3, 1, 0x32));
+    POINTERS_EQUAL(NULL, btstack_hid_layout_find_field(&layout, 4, 1, 0x31));
+
+    // unknown report id
+    btstack_hid_layout_iterator_t iterator;
+    const uint8_t unknown_report[] = { 0x05, 0x00 };
+    btstack_hid_layout_iterator_init(&iterator, &layout, unknown_report, sizeof(unknown_report));
+    CHECK_EQUAL(false, btstack_hid_layout_iterator_has_more(&iterator));
+}
+
+TEST(HID, LayoutStorageExceeded){
+    btstack_hid_layout_t layout;
+    btstack_hid_layout_init(&layout, layout_reports, 1, layout_fields, HID_REPORT_LAYOUT_MAX_FIELDS);
+    CHECK_EQUAL(false, btstack_hid_layout_compile(&layout, combo_descriptor_with_report_ids, sizeof(combo_descriptor_with_report_ids), HID_REPORT_TYPE_INPUT));
+    CHECK_EQUAL(0, layout.num_reports);
+    btstack_hid_layout_init(&layout, layout_reports, HID_REPORT_LAYOUT_MAX_REPORTS, layout_fields, 4);
+    CHECK_EQUAL(false, btstack_hid_layout_compile(&layout, mouse_descriptor_without_report_id, sizeof(mouse_descriptor_without_report_id), HID_REPORT_TYPE_INPUT));
+    CHECK_EQUAL(0, layout.num_fields);
+}
 
 int main (int argc, const char * argv[]){
 #if 1
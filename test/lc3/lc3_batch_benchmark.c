@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+// *****************************************************************************
+//
+// LC3 Batch Benchmark
+//
+// Encodes and decodes 48 kHz / 10 ms LC3 frames for 1 to 16 channels, e.g. for a broadcast
+// assistant that handles multiple BIS. Frames of all channels are processed as one batch, either
+// on the calling thread or on the posix worker pool. Reports channel frames/s and the number of
+// channels that can be processed in real time.
+//
+// *****************************************************************************
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "btstack_lc3.h"
+#include "btstack_lc3_google.h"
+#include "btstack_lc3_worker_posix.h"
+#include "btstack_util.h"
+#include "bluetooth.h"
+
+#define MAX_NUM_CHANNELS       16
+#define SAMPLE_RATE         48000
+#define SAMPLES_PER_FRAME     480
+#define OCTETS_PER_FRAME      120
+#define NUM_FRAMES            200
+#define FRAMES_PER_SECOND     100
+
+static btstack_lc3_encoder_google_t encoder_contexts[MAX_NUM_CHANNELS];
+static btstack_lc3_decoder_google_t decoder_contexts[MAX_NUM_CHANNELS];
+static const btstack_lc3_encoder_t * lc3_encoder;
+static const btstack_lc3_decoder_t * lc3_decoder;
+
+static int16_t pcm_in[NUM_FRAMES][SAMPLES_PER_FRAME * MAX_NUM_CHANNELS];
+static int16_t pcm_out[SAMPLES_PER_FRAME * MAX_NUM_CHANNELS];
+static uint8_t lc3_frames[NUM_FRAMES][MAX_NUM_CHANNELS][OCTETS_PER_FRAME];
+
+static btstack_lc3_encoder_frame_t encoder_frames[MAX_NUM_CHANNELS];
+static btstack_lc3_decoder_frame_t decoder_frames[MAX_NUM_CHANNELS];
+
+// checksums of encoded frames and decoded samples per channel count, compared between executors
+static uint32_t checksums[MAX_NUM_CHANNELS + 1];
+static bool     checksums_valid[MAX_NUM_CHANNELS + 1];
+
+static uint32_t checksum(const uint8_t * data, uint32_t len, uint32_t hash){
+    uint32_t i;
+    for (i = 0; i < len; i++){
+        hash = (hash * 31u) + data[i];
+    }
+    return hash;
+}
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+// interleaved sine with different frequency per channel
+static void setup_pcm(void){
+    uint16_t frame;
+    for (frame = 0; frame < NUM_FRAMES; frame++){
+        uint16_t i;
+        for (i = 0; i < SAMPLES_PER_FRAME; i++){
+            uint32_t sample = (frame * SAMPLES_PER_FRAME) + i;
+            uint8_t channel;
+            for (channel = 0; channel < MAX_NUM_CHANNELS; channel++){
+                double frequency = 200.0 + (100.0 * channel);
+                pcm_in[frame][(i * MAX_NUM_CHANNELS) + channel] = (int16_t) (8000.0 * sin(2.0 * M_PI * frequency * sample / SAMPLE_RATE));
+            }
+        }
+    }
+}
+
+static void setup_codecs(void){
+    uint8_t channel;
+    for (channel = 0; channel < MAX_NUM_CHANNELS; channel++){
+        lc3_encoder = btstack_lc3_encoder_google_init_instance(&encoder_contexts[channel]);
+        lc3_encoder->configure(&encoder_contexts[channel], SAMPLE_RATE, BTSTACK_LC3_FRAME_DURATION_10000US, OCTETS_PER_FRAME);
+        lc3_decoder = btstack_lc3_decoder_google_init_instance(&decoder_contexts[channel]);
+        lc3_decoder->configure(&decoder_contexts[channel], SAMPLE_RATE, BTSTACK_LC3_FRAME_DURATION_10000US, OCTETS_PER_FRAME);
+    }
+}
+
+static double encode_frames(uint8_t num_channels){
+    double start = time_now();
+    uint16_t frame;
+    for (frame = 0; frame < NUM_FRAMES; frame++){
+        uint8_t channel;
+        for (channel = 0; channel < num_channels; channel++){
+            btstack_lc3_encoder_frame_t * encoder_frame = &encoder_frames[channel];
+            encoder_frame->context = &encoder_contexts[channel];
+            encoder_frame->pcm_in = &pcm_in[frame][channel];
+            encoder_frame->stride = MAX_NUM_CHANNELS;
+            encoder_frame->bytes = lc3_frames[frame][channel];
+        }
+        if (btstack_lc3_encode_signed_16_batch(lc3_encoder, encoder_frames, num_channels) != ERROR_CODE_SUCCESS){
+            fprintf(stderr, "Encoding failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return time_now() - start;
+}
+
+static double decode_frames(uint8_t num_channels){
+    double start = time_now();
+    uint16_t frame;
+    for (frame = 0; frame < NUM_FRAMES; frame++){
+        uint8_t channel;
+        for (channel = 0; channel < num_channels; channel++){
+            btstack_lc3_decoder_frame_t * decoder_frame = &decoder_frames[channel];
+            decoder_frame->context = &decoder_contexts[channel];
+            decoder_frame->bytes = lc3_frames[frame][channel];
+            decoder_frame->BFI = 0;
+            decoder_frame->pcm_out = &pcm_out[channel];
+            decoder_frame->stride = num_channels;
+        }
+        if (btstack_lc3_decode_signed_16_batch(lc3_decoder, decoder_frames, num_channels) != ERROR_CODE_SUCCESS){
+            fprintf(stderr, "Decoding failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return time_now() - start;
+}
+
+static void run_benchmark(const char * name, const btstack_lc3_executor_t * executor){
+    static const uint8_t channel_counts[] = { 1, 2, 4, 8, 12, 16 };
+    btstack_lc3_set_executor(executor);
+    fprintf(stderr, "%s\n", name);
+    uint16_t i;
+    for (i = 0; i < sizeof(channel_counts); i++){
+        uint8_t num_channels = channel_counts[i];
+        setup_codecs();
+        memset(lc3_frames, 0, sizeof(lc3_frames));
+        memset(pcm_out, 0, sizeof(pcm_out));
+        double encode_duration = encode_frames(num_channels);
+        double decode_duration = decode_frames(num_channels);
+        uint32_t hash = checksum(&lc3_frames[0][0][0], sizeof(lc3_frames), 0);
+        hash = checksum((const uint8_t *) pcm_out, sizeof(pcm_out), hash);
+        if (checksums_valid[num_channels] && (checksums[num_channels] != hash)){
+            fprintf(stderr, "Results differ for %u channels\n", num_channels);
+            exit(EXIT_FAILURE);
+        }
+        checksums[num_channels] = hash;
+        checksums_valid[num_channels] = true;
+        double encode_rate = (NUM_FRAMES * num_channels) / encode_duration;
+        double decode_rate = (NUM_FRAMES * num_channels) / decode_duration;
+        // real time channels if batch of num_channels can be processed in one frame duration
+        fprintf(stderr, "- %2u channels: encode %8.0f frames/s (%5.1f real time channels), decode %8.0f frames/s (%5.1f real time channels)\n",
+                num_channels, encode_rate, encode_rate / FRAMES_PER_SECOND, decode_rate, decode_rate / FRAMES_PER_SECOND);
+    }
+}
+
+int main(int argc, const char * argv[]){
+    (void) argc;
+    (void) argv;
+    setup_pcm();
+    fprintf(stderr, "LC3 48 kHz, 10 ms, %u octets per frame, batches of 1..%u channels\n", OCTETS_PER_FRAME, MAX_NUM_CHANNELS);
+    run_benchmark("Calling thread", NULL);
+    run_benchmark("Worker pool", btstack_lc3_worker_posix_get_instance());
+    return EXIT_SUCCESS;
+}
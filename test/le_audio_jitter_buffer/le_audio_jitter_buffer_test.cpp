@@ -0,0 +1,320 @@
+//
+// le_audio_jitter_buffer test
+//
+// Synthetic ISO streams with one SDU per 10 ms SDU interval are delivered with random jitter, losses and
+// reordering, while the audio callback fetches one SDU per SDU interval.
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "btstack_util.h"
+#include "le-audio/le_audio_jitter_buffer.h"
+
+#define NUM_SLOTS          8
+#define MAX_SDU_LEN      120
+#define LATENCY_SDUS       4
+#define SDU_INTERVAL_MS   10
+#define SDU_LEN          100
+#define NUM_SDUS        1000
+
+static le_audio_jitter_buffer_slot_t slots[NUM_SLOTS];
+static uint8_t                       storage[NUM_SLOTS * MAX_SDU_LEN];
+
+// simulated stream
+typedef struct {
+    uint32_t arrival_time_ms;
+    uint16_t sequence_number;
+    bool     lost;
+} sdu_arrival_t;
+
+static sdu_arrival_t arrivals[NUM_SDUS];
+static uint32_t      lcg_state;
+
+static uint32_t random_value(uint32_t range){
+    lcg_state = lcg_state * 1103515245u + 12345u;
+    return (lcg_state >> 16) % range;
+}
+
+static uint8_t sdu_byte(uint16_t sequence_number, uint16_t pos){
+    return (uint8_t) (sequence_number + pos);
+}
+
+static void setup_sdu(uint16_t sequence_number, uint8_t * sdu){
+    uint16_t i;
+    for (i = 0; i < SDU_LEN; i++){
+        sdu[i] = sdu_byte(sequence_number, i);
+    }
+}
+
+static bool sdu_valid(const le_audio_jitter_buffer_sdu_t * sdu){
+    if (sdu->len != SDU_LEN) return false;
+    uint16_t i;
+    for (i = 0; i < SDU_LEN; i++){
+        if (sdu->data[i] != sdu_byte(sdu->sequence_number, i)) return false;
+    }
+    return true;
+}
+
+// ISO Data packet with time stamp, as received by HCI_ISO_DATA_PACKET handler
+static uint16_t setup_iso_packet(uint8_t * packet, uint16_t sequence_number, uint32_t time_stamp, uint8_t packet_status_flag, uint16_t sdu_len){
+    uint16_t pos = 0;
+    little_endian_store_16(packet, pos, 0x0060 | (2 << 12) | (1 << 14));
+    pos += 2;
+    little_endian_store_16(packet, pos, 4 + 4 + sdu_len);
+    pos += 2;
+    little_endian_store_32(packet, pos, time_stamp);
+    pos += 4;
+    little_endian_store_16(packet, pos, sequence_number);
+    pos += 2;
+    little_endian_store_16(packet, pos, sdu_len | (packet_status_flag << 14));
+    pos += 2;
+    setup_sdu(sequence_number, &packet[pos]);
+    return pos + sdu_len;
+}
+
+static void receive_sdu(le_audio_jitter_buffer_t * jitter_buffer, uint16_t sequence_number){
+    uint8_t packet[12 + SDU_LEN];
+    uint16_t size = setup_iso_packet(packet, sequence_number, sequence_number * SDU_INTERVAL_MS * 1000, 0, SDU_LEN);
+    le_audio_jitter_buffer_store_iso_packet(jitter_buffer, packet, size);
+}
+
+// SDU n is sent at n * interval and arrives after up to max_jitter_ms, 1 in loss_rate is lost
+static void setup_stream(uint16_t first_sequence_number, uint32_t max_jitter_ms, uint32_t loss_rate){
+    uint16_t i;
+    for (i = 0; i < NUM_SDUS; i++){
+        arrivals[i].sequence_number = first_sequence_number + i;
+        arrivals[i].arrival_time_ms = (i * SDU_INTERVAL_MS) + random_value(max_jitter_ms + 1);
+        arrivals[i].lost = (loss_rate != 0) && (random_value(loss_rate) == 0);
+    }
+}
+
+typedef struct {
+    uint16_t played;
+    uint16_t valid;
+    uint16_t bfi;
+    bool     in_order;
+    uint32_t first_playback_ms;
+} playback_result_t;
+
+// deliver SDUs in order of arrival time, fetch SDU every interval with 5 ms phase offset
+static playback_result_t replay_stream(le_audio_jitter_buffer_t * jitter_buffer, uint32_t duration_ms){
+    playback_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.in_order = true;
+    bool first = true;
+    uint16_t expected_sequence_number = 0;
+    uint32_t time_ms;
+    for (time_ms = 0; time_ms < duration_ms; time_ms++){
+        uint16_t i;
+        for (i = 0; i < NUM_SDUS; i++){
+            if ((arrivals[i].arrival_time_ms == time_ms) && (arrivals[i].lost == false)){
+                receive_sdu(jitter_buffer, arrivals[i].sequence_number);
+            }
+        }
+        if ((time_ms % SDU_INTERVAL_MS) != 5) continue;
+        le_audio_jitter_buffer_sdu_t sdu;
+        if (le_audio_jitter_buffer_get_sdu(jitter_buffer, &sdu) == false) continue;
+        if (first){
+            first = false;
+            result.first_playback_ms = time_ms;
+        } else if (sdu.sequence_number != expected_sequence_number){
+            result.in_order = false;
+        }
+        expected_sequence_number = sdu.sequence_number + 1;
+        result.played++;
+        if (sdu.bfi != 0){
+            result.bfi++;
+        } else if (sdu_valid(&sdu)){
+            result.valid++;
+        }
+    }
+    return result;
+}
+
+static uint16_t num_lost(void){
+    uint16_t count = 0;
+    uint16_t i;
+    for (i = 0; i < NUM_SDUS; i++){
+        if (arrivals[i].lost) count++;
+    }
+    return count;
+}
+
+TEST_GROUP(LeAudioJitterBuffer){
+    le_audio_jitter_buffer_t jitter_buffer;
+    void setup(void){
+        lcg_state = 1;
+        le_audio_jitter_buffer_init(&jitter_buffer, slots, storage, NUM_SLOTS, MAX_SDU_LEN, LATENCY_SDUS);
+    }
+};
+
+TEST(LeAudioJitterBuffer, FixedLatency){
+    le_audio_jitter_buffer_sdu_t sdu;
+    uint16_t i;
+    for (i = 0; i < (LATENCY_SDUS - 1); i++){
+        receive_sdu(&jitter_buffer, 100 + i);
+        CHECK_FALSE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+    }
+    receive_sdu(&jitter_buffer, 100 + LATENCY_SDUS - 1);
+    CHECK_EQUAL(LATENCY_SDUS, le_audio_jitter_buffer_get_num_buffered_sdus(&jitter_buffer));
+    CHECK_TRUE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+    CHECK_EQUAL(100, sdu.sequence_number);
+    CHECK_EQUAL(0, sdu.bfi);
+    CHECK_EQUAL(100 * SDU_INTERVAL_MS * 1000, sdu.time_stamp);
+    CHECK_TRUE(sdu_valid(&sdu));
+    // no copy, SDU is returned from slot storage
+    CHECK_TRUE((sdu.data >= storage) && (sdu.data < &storage[sizeof(storage)]));
+}
+
+TEST(LeAudioJitterBuffer, Jitter){
+    // jitter of up to 3 SDU intervals reorders SDUs, 4 SDU intervals latency
+    setup_stream(0, 3 * SDU_INTERVAL_MS, 0);
+    playback_result_t result = replay_stream(&jitter_buffer, (NUM_SDUS + 10) * SDU_INTERVAL_MS);
+    CHECK_TRUE(result.in_order);
+    CHECK_EQUAL(NUM_SDUS, result.valid);
+    CHECK_EQUAL(0, jitter_buffer.statistics.sdus_late);
+    CHECK_EQUAL(0, jitter_buffer.statistics.sdus_overrun);
+    // BFI only after end of stream
+    CHECK_EQUAL(result.played - NUM_SDUS, result.bfi);
+}
+
+TEST(LeAudioJitterBuffer, Loss){
+    setup_stream(0, 3 * SDU_INTERVAL_MS, 20);
+    uint16_t lost = num_lost();
+    CHECK(lost > 0);
+    playback_result_t result = replay_stream(&jitter_buffer, (NUM_SDUS + 10) * SDU_INTERVAL_MS);
+    CHECK_TRUE(result.in_order);
+    CHECK_EQUAL(NUM_SDUS - lost, result.valid);
+    CHECK_EQUAL(result.played - result.valid, result.bfi);
+    CHECK_EQUAL(result.bfi, jitter_buffer.statistics.sdus_missing);
+    CHECK_EQUAL(NUM_SDUS - lost, jitter_buffer.statistics.sdus_received);
+}
+
+TEST(LeAudioJitterBuffer, LateSdus){
+    // jitter exceeds latency, SDUs are either played, late, or dropped if they arrive too early
+    setup_stream(0, 8 * SDU_INTERVAL_MS, 0);
+    playback_result_t result = replay_stream(&jitter_buffer, (NUM_SDUS + 10) * SDU_INTERVAL_MS);
+    CHECK(jitter_buffer.statistics.sdus_late > 0);
+    CHECK_EQUAL(result.played, result.valid + result.bfi);
+    CHECK_EQUAL(result.valid + jitter_buffer.statistics.sdus_late + jitter_buffer.statistics.sdus_overrun, jitter_buffer.statistics.sdus_received);
+}
+
+TEST(LeAudioJitterBuffer, SequenceNumberWrap){
+    setup_stream(0xffff - (NUM_SDUS / 2), 3 * SDU_INTERVAL_MS, 0);
+    playback_result_t result = replay_stream(&jitter_buffer, (NUM_SDUS + 10) * SDU_INTERVAL_MS);
+    CHECK_TRUE(result.in_order);
+    CHECK_EQUAL(NUM_SDUS, result.valid);
+}
+
+TEST(LeAudioJitterBuffer, SequenceNumberWrapOddNumSlots){
+    // number of slots does not divide 65536
+    le_audio_jitter_buffer_init(&jitter_buffer, slots, storage, NUM_SLOTS - 1, MAX_SDU_LEN, LATENCY_SDUS);
+    setup_stream(0xffff - (NUM_SDUS / 2), 0, 0);
+    playback_result_t result = replay_stream(&jitter_buffer, (NUM_SDUS + 10) * SDU_INTERVAL_MS);
+    CHECK_TRUE(result.in_order);
+    CHECK_EQUAL(NUM_SDUS, result.valid);
+    CHECK_EQUAL(0, jitter_buffer.statistics.sdus_duplicate);
+    CHECK_EQUAL(0, jitter_buffer.statistics.sdus_overrun);
+
+    le_audio_jitter_buffer_init(&jitter_buffer, slots, storage, NUM_SLOTS - 1, MAX_SDU_LEN, LATENCY_SDUS);
+    // with jitter, SDUs before the first received SDU are late
+    setup_stream(0xffff - (NUM_SDUS / 2), 2 * SDU_INTERVAL_MS, 0);
+    result = replay_stream(&jitter_buffer, (NUM_SDUS + 10) * SDU_INTERVAL_MS);
+    CHECK_TRUE(result.in_order);
+    CHECK_EQUAL(NUM_SDUS, result.valid + jitter_buffer.statistics.sdus_late);
+    CHECK_EQUAL(0, jitter_buffer.statistics.sdus_duplicate);
+    CHECK_EQUAL(0, jitter_buffer.statistics.sdus_overrun);
+}
+
+TEST(LeAudioJitterBuffer, PacketStatusFlag){
+    uint8_t packet[12 + SDU_LEN];
+    uint16_t size;
+    le_audio_jitter_buffer_sdu_t sdu;
+    // lost data, possibly invalid data, valid data
+    size = setup_iso_packet(packet, 0, 0, 2, 0);
+    le_audio_jitter_buffer_store_iso_packet(&jitter_buffer, packet, size);
+    size = setup_iso_packet(packet, 1, 0, 1, SDU_LEN);
+    le_audio_jitter_buffer_store_iso_packet(&jitter_buffer, packet, size);
+    receive_sdu(&jitter_buffer, 2);
+    receive_sdu(&jitter_buffer, 3);
+    CHECK_TRUE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+    CHECK_EQUAL(1, sdu.bfi);
+    CHECK_TRUE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+    CHECK_EQUAL(1, sdu.bfi);
+    CHECK_TRUE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+    CHECK_EQUAL(0, sdu.bfi);
+    CHECK_EQUAL(2, jitter_buffer.statistics.sdus_missing);
+    // truncated packet is ignored
+    size = setup_iso_packet(packet, 4, 0, 0, SDU_LEN);
+    le_audio_jitter_buffer_store_iso_packet(&jitter_buffer, packet, size - 1);
+    CHECK_EQUAL(4, jitter_buffer.statistics.sdus_received);
+}
+
+TEST(LeAudioJitterBuffer, Duplicate){
+    receive_sdu(&jitter_buffer, 0);
+    receive_sdu(&jitter_buffer, 0);
+    CHECK_EQUAL(1, jitter_buffer.statistics.sdus_duplicate);
+}
+
+TEST(LeAudioJitterBuffer, Overrun){
+    le_audio_jitter_buffer_sdu_t sdu;
+    uint16_t i;
+    for (i = 0; i < LATENCY_SDUS; i++){
+        receive_sdu(&jitter_buffer, i);
+    }
+    CHECK_TRUE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+    // audio callback stalls, oldest SDUs are dropped
+    for (i = LATENCY_SDUS; i < 20; i++){
+        receive_sdu(&jitter_buffer, i);
+    }
+    CHECK_EQUAL(NUM_SLOTS - 1, le_audio_jitter_buffer_get_num_buffered_sdus(&jitter_buffer));
+    CHECK_EQUAL(20 - 1 - (NUM_SLOTS - 1), jitter_buffer.statistics.sdus_overrun);
+    CHECK_TRUE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+    CHECK_EQUAL(20 - (NUM_SLOTS - 1), sdu.sequence_number);
+    CHECK_TRUE(sdu_valid(&sdu));
+}
+
+TEST(LeAudioJitterBuffer, StreamStopped){
+    le_audio_jitter_buffer_sdu_t sdu;
+    uint16_t i;
+    for (i = 0; i < LATENCY_SDUS; i++){
+        receive_sdu(&jitter_buffer, i);
+    }
+    for (i = 0; i < LATENCY_SDUS; i++){
+        CHECK_TRUE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+        CHECK_EQUAL(0, sdu.bfi);
+    }
+    // BFI until stream is considered stopped
+    for (i = 0; i < NUM_SLOTS; i++){
+        CHECK_TRUE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+        CHECK_EQUAL(1, sdu.bfi);
+        CHECK(sdu.data == NULL);
+    }
+    CHECK_FALSE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+    // new stream buffers again
+    for (i = 0; i < LATENCY_SDUS; i++){
+        receive_sdu(&jitter_buffer, 500 + i);
+    }
+    CHECK_TRUE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+    CHECK_EQUAL(500, sdu.sequence_number);
+}
+
+TEST(LeAudioJitterBuffer, GapWhileBuffering){
+    le_audio_jitter_buffer_sdu_t sdu;
+    receive_sdu(&jitter_buffer, 0);
+    // SDU far ahead keeps latency
+    receive_sdu(&jitter_buffer, 6);
+    CHECK_EQUAL(LATENCY_SDUS, le_audio_jitter_buffer_get_num_buffered_sdus(&jitter_buffer));
+    CHECK_TRUE(le_audio_jitter_buffer_get_sdu(&jitter_buffer, &sdu));
+    CHECK_EQUAL(6 - (LATENCY_SDUS - 1), sdu.sequence_number);
+    CHECK_EQUAL(1, sdu.bfi);
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
@@ -0,0 +1,233 @@
+//
+// mesh_lower_transport segmented message reassembly stress test
+//
+// Several senders transmit long segmented access messages to this node at the same time, their segments
+// are received interleaved. Built with fixed size memory pools (config_pool), reports number of dropped
+// messages and peak usage of the Network PDU and Segmented PDU pools.
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "btstack_crypto.h"
+#include "btstack_memory.h"
+#include "btstack_util.h"
+#include "hci.h"
+#include "mesh/adv_bearer.h"
+#include "mesh/gatt_bearer.h"
+#include "mesh/mesh_foundation.h"
+#include "mesh/mesh_keys.h"
+#include "mesh/mesh_lower_transport.h"
+#include "mesh/mesh_network.h"
+#include "mesh/mesh_node.h"
+#include "mesh/mesh_peer.h"
+#include "mock.h"
+
+#define NUM_SENDERS       8
+#define NUM_SEGMENTS     16
+#define SEGMENT_SIZE     12
+#define FIRST_SENDER 0x1000
+
+#define PRIMARY_ELEMENT_ADDRESS 0x0001
+
+static const uint8_t encryption_key[] = { 0x09, 0x53, 0xfa, 0x93, 0xe7, 0xca, 0xac, 0x96, 0x38, 0xf5, 0x88, 0x20, 0x22, 0x0a, 0x39, 0x8e };
+static const uint8_t privacy_key[]    = { 0x8b, 0x84, 0xee, 0xde, 0xc1, 0x00, 0x06, 0x7d, 0x67, 0x09, 0x71, 0xdd, 0x2a, 0xa7, 0x00, 0xcf };
+
+static uint8_t  network_pdus[NUM_SENDERS * NUM_SEGMENTS][29];
+static uint8_t  network_pdus_len[NUM_SENDERS * NUM_SEGMENTS];
+static uint16_t network_pdus_captured;
+static bool     capture;
+
+static uint16_t messages_received;
+static uint16_t messages_valid;
+static uint16_t network_pdus_peak;
+static uint16_t segmented_pdus_peak;
+
+static btstack_packet_handler_t adv_packet_handler;
+extern "C" void adv_bearer_register_for_network_pdu(btstack_packet_handler_t packet_handler){
+    adv_packet_handler = packet_handler;
+}
+extern "C" void adv_bearer_request_can_send_now_for_network_pdu(void){
+    uint8_t event[3];
+    event[0] = HCI_EVENT_MESH_META;
+    event[1] = 1;
+    event[2] = MESH_SUBEVENT_CAN_SEND_NOW;
+    (*adv_packet_handler)(HCI_EVENT_PACKET, 0, &event[0], sizeof(event));
+}
+extern "C" void adv_bearer_send_network_pdu(const uint8_t * network_pdu, uint16_t size, uint8_t count, uint16_t interval){
+    UNUSED(count);
+    UNUSED(interval);
+    // segments to send later, ignore segment acknowledgments from lower transport
+    if (!capture) return;
+    memcpy(network_pdus[network_pdus_captured], network_pdu, size);
+    network_pdus_len[network_pdus_captured] = (uint8_t) size;
+    network_pdus_captured++;
+}
+
+extern "C" void gatt_bearer_register_for_network_pdu(btstack_packet_handler_t packet_handler){
+    UNUSED(packet_handler);
+}
+extern "C" void gatt_bearer_register_for_mesh_proxy_configuration(btstack_packet_handler_t packet_handler){
+    UNUSED(packet_handler);
+}
+extern "C" void gatt_bearer_request_can_send_now_for_network_pdu(void){
+}
+extern "C" void gatt_bearer_send_network_pdu(const uint8_t * network_pdu, uint16_t size){
+    UNUSED(network_pdu);
+    UNUSED(size);
+}
+
+// count used entries by emptying pool
+static uint16_t network_pdus_in_use(void){
+    mesh_network_pdu_t * pdus[MAX_NR_MESH_NETWORK_PDUS];
+    uint16_t num_free = 0;
+    while (num_free < MAX_NR_MESH_NETWORK_PDUS){
+        pdus[num_free] = btstack_memory_mesh_network_pdu_get();
+        if (pdus[num_free] == NULL) break;
+        num_free++;
+    }
+    uint16_t i;
+    for (i = 0; i < num_free; i++){
+        btstack_memory_mesh_network_pdu_free(pdus[i]);
+    }
+    return MAX_NR_MESH_NETWORK_PDUS - num_free;
+}
+
+static uint16_t segmented_pdus_in_use(void){
+    mesh_segmented_pdu_t * pdus[MAX_NR_MESH_SEGMENTED_PDUS];
+    uint16_t num_free = 0;
+    while (num_free < MAX_NR_MESH_SEGMENTED_PDUS){
+        pdus[num_free] = btstack_memory_mesh_segmented_pdu_get();
+        if (pdus[num_free] == NULL) break;
+        num_free++;
+    }
+    uint16_t i;
+    for (i = 0; i < num_free; i++){
+        btstack_memory_mesh_segmented_pdu_free(pdus[i]);
+    }
+    return MAX_NR_MESH_SEGMENTED_PDUS - num_free;
+}
+
+static void update_peak_usage(void){
+    network_pdus_peak   = btstack_max(network_pdus_peak,   network_pdus_in_use());
+    segmented_pdus_peak = btstack_max(segmented_pdus_peak, segmented_pdus_in_use());
+}
+
+static void process_hci_commands(void){
+    while (mock_process_hci_cmd()){
+        update_peak_usage();
+    }
+}
+
+static void capture_handler(mesh_network_callback_type_t callback_type, mesh_network_pdu_t * network_pdu){
+    if (callback_type == MESH_NETWORK_PDU_SENT){
+        mesh_network_pdu_free(network_pdu);
+    }
+}
+
+static uint8_t payload_byte(uint16_t src, uint16_t pos){
+    return (uint8_t) (src + pos);
+}
+
+static void transport_handler(mesh_transport_callback_type_t callback_type, mesh_transport_status_t status, mesh_pdu_t * pdu){
+    UNUSED(status);
+    if (callback_type != MESH_TRANSPORT_PDU_RECEIVED) return;
+    CHECK_EQUAL(MESH_PDU_TYPE_SEGMENTED, pdu->pdu_type);
+    mesh_segmented_pdu_t * segmented_pdu = (mesh_segmented_pdu_t *) pdu;
+    messages_received++;
+    bool valid = segmented_pdu->len == (NUM_SEGMENTS * SEGMENT_SIZE);
+    uint16_t i;
+    for (i = 0; valid && (i < segmented_pdu->len); i++){
+        valid = segmented_pdu->data[i] == payload_byte(segmented_pdu->src, i);
+    }
+    if (valid){
+        messages_valid++;
+    }
+    mesh_lower_transport_message_processed_by_higher_layer(pdu);
+}
+
+// encrypt segments of access messages from all senders, ordered by segment
+static void create_network_pdus(void){
+    mesh_network_set_higher_layer_handler(&capture_handler);
+    network_pdus_captured = 0;
+    capture = true;
+    uint8_t seg_o;
+    for (seg_o = 0; seg_o < NUM_SEGMENTS; seg_o++){
+        uint16_t sender;
+        for (sender = 0; sender < NUM_SENDERS; sender++){
+            uint16_t src = FIRST_SENDER + sender;
+            uint32_t seq_zero = 0x100;
+            uint32_t seq = seq_zero + seg_o;
+            // SEG | AKF=1 | AID, SZMIC=0 | SeqZero | SegO | SegN
+            uint8_t lower_transport_pdu[4 + SEGMENT_SIZE];
+            lower_transport_pdu[0] = 0x80 | 0x40 | 0x26;
+            lower_transport_pdu[1] = (uint8_t) (seq_zero >> 6);
+            lower_transport_pdu[2] = (uint8_t) ((seq_zero << 2) | (seg_o >> 3));
+            lower_transport_pdu[3] = (uint8_t) ((seg_o << 5) | (NUM_SEGMENTS - 1));
+            uint8_t i;
+            for (i = 0; i < SEGMENT_SIZE; i++){
+                lower_transport_pdu[4 + i] = payload_byte(src, (seg_o * SEGMENT_SIZE) + i);
+            }
+            mesh_network_pdu_t * network_pdu = mesh_network_pdu_get();
+            CHECK(network_pdu != NULL);
+            mesh_network_setup_pdu(network_pdu, 0, 0x68, 0, 5, seq, src, PRIMARY_ELEMENT_ADDRESS, lower_transport_pdu, sizeof(lower_transport_pdu));
+            mesh_network_send_pdu(network_pdu);
+            process_hci_commands();
+        }
+    }
+    capture = false;
+    CHECK_EQUAL(NUM_SENDERS * NUM_SEGMENTS, network_pdus_captured);
+}
+
+TEST_GROUP(MeshLowerTransportStress){
+    void setup(void){
+        btstack_memory_init();
+        btstack_crypto_init();
+        mock_init();
+        mock_simulate_hci_state_working();
+        mesh_node_init();
+        mesh_node_primary_element_address_set(PRIMARY_ELEMENT_ADDRESS);
+        mesh_network_init();
+        mesh_network_key_init();
+        mesh_network_key_t * network_key = btstack_memory_mesh_network_key_get();
+        network_key->nid = 0x68;
+        memcpy(network_key->encryption_key, encryption_key, 16);
+        memcpy(network_key->privacy_key, privacy_key, 16);
+        mesh_network_key_add(network_key);
+        mesh_subnet_setup_for_netkey_index(network_key->netkey_index);
+        mesh_foundation_gatt_proxy_set(0);
+        mesh_foundation_relay_set(0);
+        mesh_foundation_network_transmit_set(0);
+        create_network_pdus();
+        mesh_lower_transport_init();
+        mesh_lower_transport_set_higher_layer_handler(&transport_handler);
+        messages_received = 0;
+        messages_valid = 0;
+        network_pdus_peak = 0;
+        segmented_pdus_peak = 0;
+    }
+};
+
+TEST(MeshLowerTransportStress, ConcurrentSenders){
+    uint16_t i;
+    for (i = 0; i < network_pdus_captured; i++){
+        (*adv_packet_handler)(MESH_NETWORK_PACKET, 0, network_pdus[i], network_pdus_len[i]);
+        update_peak_usage();
+        process_hci_commands();
+    }
+    printf("Segmented reassembly, %u senders with %u segments each:\n", NUM_SENDERS, NUM_SEGMENTS);
+    printf("- %u of %u messages received, %u dropped\n", messages_valid, NUM_SENDERS, NUM_SENDERS - messages_valid);
+    printf("- peak usage: %u of %u Network PDUs, %u of %u Segmented PDUs\n",
+           network_pdus_peak, MAX_NR_MESH_NETWORK_PDUS, segmented_pdus_peak, MAX_NR_MESH_SEGMENTED_PDUS);
+    CHECK_EQUAL(NUM_SENDERS, messages_received);
+    CHECK_EQUAL(NUM_SENDERS, messages_valid);
+    CHECK(network_pdus_peak < MAX_NR_MESH_NETWORK_PDUS);
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
@@ -278,7 +278,6 @@ static void test_upper_transport_access_message_handler(mesh_transport_callback_
 
     // process pdu received
     mesh_access_pdu_t    * access_pdu;
-    mesh_network_pdu_t   * network_pdu;
     mesh_segmented_pdu_t   * message_pdu;
 
     switch(pdu->pdu_type){
@@ -292,9 +291,8 @@ static void test_upper_transport_access_message_handler(mesh_transport_callback_
         case MESH_PDU_TYPE_SEGMENTED:
             message_pdu = (mesh_segmented_pdu_t *) pdu;
             printf("test access handler MESH_PDU_TYPE_SEGMENTED received\n");
-            network_pdu = (mesh_network_pdu_t *) btstack_linked_list_get_first_item(&message_pdu->segments);
-            recv_upper_transport_pdu_len = mesh_network_pdu_len(network_pdu)  - 1;
-            memcpy(recv_upper_transport_pdu_data, mesh_network_pdu_data(network_pdu) + 1, recv_upper_transport_pdu_len);
+            recv_upper_transport_pdu_len = message_pdu->len;
+            memcpy(recv_upper_transport_pdu_data, message_pdu->data, recv_upper_transport_pdu_len);
             mesh_upper_transport_message_processed_by_higher_layer(pdu);
             break;
         default:
@@ -1217,6 +1215,31 @@ TEST(MessageTest, ApplicationkeyIDTest){
     mesh_k4(&aes_cmac_request, application_key, &k4_result[0], &handle_k4_result, NULL);
 }
 
+// AppKey with same AID as test AppKey is tried first for first message, second message from same source uses cached key
+TEST(MessageTest, KeyCacheTrialDecryptions){
+    static mesh_transport_key_t same_aid_application_key;
+    same_aid_application_key.internal_index = 1;
+    same_aid_application_key.netkey_index = 0;
+    same_aid_application_key.appkey_index = 1;
+    same_aid_application_key.aid = 0x26;
+    same_aid_application_key.akf = 1;
+    memset(same_aid_application_key.key, 0x55, 16);
+    mesh_transport_key_remove(&test_application_key);
+    mesh_transport_key_add(&same_aid_application_key);
+    mesh_transport_key_add(&test_application_key);
+
+    load_network_key_nid_68();
+    mesh_set_iv_index(0x12345678);
+    test_receive_network_pdus(1, message18_network_pdus, message18_lower_transport_pdus, message18_upper_transport_pdu);
+    CHECK_EQUAL(2, mesh_upper_transport_get_trial_decryptions());
+    recv_upper_transport_pdu_len = 0;
+    test_receive_network_pdus(1, message19_network_pdus, message19_lower_transport_pdus, message19_upper_transport_pdu);
+    CHECK_EQUAL(3, mesh_upper_transport_get_trial_decryptions());
+    CHECK_EQUAL(2, mesh_network_get_trial_decryptions());
+
+    mesh_transport_key_remove(&same_aid_application_key);
+}
+
 int main (int argc, const char * argv[]){
     return CommandLineTestRunner::RunAllTests(argc, argv);
 }
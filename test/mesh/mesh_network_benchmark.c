@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+// *****************************************************************************
+//
+// Mesh Network Relay Benchmark
+//
+// Bursts of Network PDUs are received via a stand-in for the ADV bearer, validated,
+// re-encrypted with decremented TTL and sent via the ADV bearer again. AES128 is
+// provided by the HCI mock. Reports relayed PDUs/s and HCI AES128 operations
+// per received PDU for the configured MESH_NETWORK_PDUS_IN_FLIGHT
+//
+// mesh_network.c logs each Network PDU to stdout, results are reported on stderr
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "btstack_crypto.h"
+#include "btstack_memory.h"
+#include "btstack_util.h"
+#include "hci.h"
+#include "mesh/adv_bearer.h"
+#include "mesh/gatt_bearer.h"
+#include "mesh/mesh_foundation.h"
+#include "mesh/mesh_keys.h"
+#include "mesh/mesh_network.h"
+#include "mesh/mesh_node.h"
+#include "mock.h"
+
+#define NUM_SOURCES       16
+#define NUM_PDUS        2000
+#define BURST_SIZE         8
+#define NUM_ITERATIONS    10
+
+// default from mesh_network.c
+#ifndef MESH_NETWORK_PDUS_IN_FLIGHT
+#define MESH_NETWORK_PDUS_IN_FLIGHT 4
+#endif
+
+#define PRIMARY_ELEMENT_ADDRESS 0x0001
+#define GROUP_ADDRESS           0xc001
+
+static const uint8_t encryption_key[] = { 0x09, 0x53, 0xfa, 0x93, 0xe7, 0xca, 0xac, 0x96, 0x38, 0xf5, 0x88, 0x20, 0x22, 0x0a, 0x39, 0x8e };
+static const uint8_t privacy_key[]    = { 0x8b, 0x84, 0xee, 0xde, 0xc1, 0x00, 0x06, 0x7d, 0x67, 0x09, 0x71, 0xdd, 0x2a, 0xa7, 0x00, 0xcf };
+
+static uint8_t  network_pdus[NUM_PDUS][29];
+static uint8_t  network_pdus_len[NUM_PDUS];
+static uint16_t network_pdus_captured;
+
+static uint32_t pdus_relayed;
+static uint32_t aes128_operations;
+static int      capture;
+
+static btstack_packet_handler_t adv_packet_handler;
+void adv_bearer_register_for_network_pdu(btstack_packet_handler_t packet_handler){
+    adv_packet_handler = packet_handler;
+}
+void adv_bearer_request_can_send_now_for_network_pdu(void){
+    uint8_t event[3];
+    event[0] = HCI_EVENT_MESH_META;
+    event[1] = 1;
+    event[2] = MESH_SUBEVENT_CAN_SEND_NOW;
+    (*adv_packet_handler)(HCI_EVENT_PACKET, 0, &event[0], sizeof(event));
+}
+void adv_bearer_send_network_pdu(const uint8_t * network_pdu, uint16_t size, uint8_t count, uint16_t interval){
+    (void) count;
+    (void) interval;
+    if (capture){
+        memcpy(network_pdus[network_pdus_captured], network_pdu, size);
+        network_pdus_len[network_pdus_captured] = (uint8_t) size;
+        network_pdus_captured++;
+    } else {
+        pdus_relayed++;
+    }
+}
+
+void gatt_bearer_register_for_network_pdu(btstack_packet_handler_t packet_handler){
+    UNUSED(packet_handler);
+}
+void gatt_bearer_register_for_mesh_proxy_configuration(btstack_packet_handler_t packet_handler){
+    UNUSED(packet_handler);
+}
+void gatt_bearer_request_can_send_now_for_network_pdu(void){
+}
+void gatt_bearer_send_network_pdu(const uint8_t * network_pdu, uint16_t size){
+    UNUSED(network_pdu);
+    UNUSED(size);
+}
+
+static void network_handler(mesh_network_callback_type_t callback_type, mesh_network_pdu_t * network_pdu){
+    switch (callback_type){
+        case MESH_NETWORK_PDU_RECEIVED:
+            // not for us, relay
+            mesh_network_message_processed_by_higher_layer(network_pdu);
+            break;
+        case MESH_NETWORK_PDU_SENT:
+            mesh_network_pdu_free(network_pdu);
+            break;
+        default:
+            break;
+    }
+}
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+static void process_hci_commands(void){
+    while (mock_process_hci_cmd()){
+        aes128_operations++;
+    }
+}
+
+static void setup_network_key(void){
+    mesh_network_key_t * network_key = btstack_memory_mesh_network_key_get();
+    network_key->nid = 0x68;
+    memcpy(network_key->encryption_key, encryption_key, 16);
+    memcpy(network_key->privacy_key, privacy_key, 16);
+    mesh_network_key_add(network_key);
+    mesh_subnet_setup_for_netkey_index(network_key->netkey_index);
+}
+
+// encrypt unsegmented access messages from other nodes to a group address
+static void create_network_pdus(void){
+    const uint8_t transport_pdu_data[] = { 0x66, 0x82, 0x02, 0x01, 0x00, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc };
+    capture = 1;
+    uint16_t i;
+    for (i = 0; i < NUM_PDUS; i++){
+        mesh_network_pdu_t * network_pdu = mesh_network_pdu_get();
+        uint16_t src = 0x1000 + (i % NUM_SOURCES);
+        uint32_t seq = 0x100 + (i / NUM_SOURCES);
+        mesh_network_setup_pdu(network_pdu, 0, 0x68, 0, 5, seq, src, GROUP_ADDRESS, transport_pdu_data, sizeof(transport_pdu_data));
+        mesh_network_send_pdu(network_pdu);
+        process_hci_commands();
+    }
+    capture = 0;
+    if (network_pdus_captured != NUM_PDUS){
+        fprintf(stderr, "Failed to create Network PDUs: %u of %u\n", network_pdus_captured, NUM_PDUS);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// receive Network PDUs in bursts as from a busy scanner and process HCI AES128 results in between
+static void relay_network_pdus(void){
+    uint16_t i;
+    for (i = 0; i < NUM_PDUS; i++){
+        (*adv_packet_handler)(MESH_NETWORK_PACKET, 0, network_pdus[i], network_pdus_len[i]);
+        if ((i % BURST_SIZE) == (BURST_SIZE - 1)){
+            process_hci_commands();
+        }
+    }
+    process_hci_commands();
+}
+
+int main(int argc, const char * argv[]){
+    (void) argc;
+    (void) argv;
+
+    btstack_memory_init();
+    btstack_crypto_init();
+    mock_init();
+    mock_simulate_hci_state_working();
+    mesh_node_init();
+    mesh_node_primary_element_address_set(PRIMARY_ELEMENT_ADDRESS);
+    mesh_network_init();
+    mesh_network_key_init();
+    mesh_network_set_higher_layer_handler(&network_handler);
+    setup_network_key();
+    mesh_foundation_gatt_proxy_set(0);
+    mesh_foundation_network_transmit_set(0);
+
+    create_network_pdus();
+
+    mesh_foundation_relay_set(1);
+    aes128_operations = 0;
+    double start = time_now();
+    int iteration;
+    for (iteration = 0; iteration < NUM_ITERATIONS; iteration++){
+        relay_network_pdus();
+    }
+    double duration = time_now() - start;
+
+    fprintf(stderr, "Mesh Network relay, %u PDUs in flight, bursts of %u PDUs from %u sources\n", MESH_NETWORK_PDUS_IN_FLIGHT, BURST_SIZE, NUM_SOURCES);
+    fprintf(stderr, "- relayed %u of %u PDUs\n", pdus_relayed, NUM_PDUS * NUM_ITERATIONS);
+    fprintf(stderr, "- %10.0f relayed PDUs/s\n", pdus_relayed / duration);
+    fprintf(stderr, "- %10.1f HCI AES128 operations per received PDU\n", (double) aes128_operations / (NUM_PDUS * NUM_ITERATIONS));
+    return EXIT_SUCCESS;
+}
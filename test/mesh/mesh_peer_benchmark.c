@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+// *****************************************************************************
+//
+// Mesh Peer Benchmark
+//
+// Looks up peers and validates SEQ for Network PDUs from NUM_SOURCES sources in
+// random order as done by the Lower Transport for each received Network PDU.
+// Reports lookups/s for the hashed peer table, for more sources than fit into the
+// table (LRU replacement) and for a linear scan over the same number of peers
+// as reference
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "btstack_run_loop.h"
+#include "btstack_util.h"
+#include "mesh/mesh_peer.h"
+
+#define NUM_SOURCES      1000
+#define NUM_LOOKUPS  10000000
+#define FIRST_SOURCE   0x0100
+
+// default from mesh_peer.c
+#ifndef MESH_PEER_TABLE_SIZE
+#define MESH_PEER_TABLE_SIZE 16
+#endif
+
+static uint16_t lookup_sources[NUM_LOOKUPS];
+static uint32_t lookup_seq[NUM_SOURCES * 2];
+
+// linear scan for comparison
+static mesh_peer_t linear_peers[NUM_SOURCES];
+
+// storage timer not used
+void btstack_run_loop_set_timer(btstack_timer_source_t * ts, uint32_t timeout){
+    UNUSED(ts);
+    UNUSED(timeout);
+}
+void btstack_run_loop_set_timer_handler(btstack_timer_source_t * ts, void (*fn)(btstack_timer_source_t * ts)){
+    UNUSED(ts);
+    UNUSED(fn);
+}
+void btstack_run_loop_add_timer(btstack_timer_source_t * ts){
+    UNUSED(ts);
+}
+int btstack_run_loop_remove_timer(btstack_timer_source_t * ts){
+    UNUSED(ts);
+    return 1;
+}
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+static mesh_peer_t * linear_peer_for_addr(uint16_t address){
+    int i;
+    for (i = 0; i < NUM_SOURCES; i++){
+        if (linear_peers[i].address == address){
+            return &linear_peers[i];
+        }
+    }
+    for (i = 0; i < NUM_SOURCES; i++){
+        if (linear_peers[i].address == 0){
+            linear_peers[i].address = address;
+            return &linear_peers[i];
+        }
+    }
+    return NULL;
+}
+
+static void setup_lookups(uint16_t num_sources){
+    uint32_t random_state = 0x12345678;
+    uint32_t i;
+    for (i = 0; i < NUM_LOOKUPS; i++){
+        random_state = (random_state * 1103515245u) + 12345u;
+        lookup_sources[i] = FIRST_SOURCE + (uint16_t) ((random_state >> 8) % num_sources);
+    }
+    memset(lookup_seq, 0, sizeof(lookup_seq));
+}
+
+static double run_hashed(uint32_t * accepted){
+    mesh_seq_auth_reset();
+    *accepted = 0;
+    double start = time_now();
+    uint32_t i;
+    for (i = 0; i < NUM_LOOKUPS; i++){
+        uint16_t src = lookup_sources[i];
+        mesh_peer_t * peer = mesh_peer_for_addr(src);
+        if (peer == NULL) continue;
+        uint32_t seq = ++lookup_seq[src - FIRST_SOURCE];
+        if (mesh_peer_replay_protection_check(peer, 0, seq)){
+            (*accepted)++;
+        }
+    }
+    return NUM_LOOKUPS / (time_now() - start);
+}
+
+static double run_linear(uint32_t * accepted){
+    memset(linear_peers, 0, sizeof(linear_peers));
+    *accepted = 0;
+    double start = time_now();
+    uint32_t i;
+    for (i = 0; i < NUM_LOOKUPS; i++){
+        uint16_t src = lookup_sources[i];
+        mesh_peer_t * peer = linear_peer_for_addr(src);
+        if (peer == NULL) continue;
+        uint32_t seq = ++lookup_seq[src - FIRST_SOURCE];
+        if (seq > peer->seq){
+            peer->seq = seq;
+            (*accepted)++;
+        }
+    }
+    return NUM_LOOKUPS / (time_now() - start);
+}
+
+int main(int argc, const char * argv[]){
+    (void) argc;
+    (void) argv;
+
+    uint32_t accepted;
+    double lookups_per_second;
+
+    printf("Mesh Peer lookups, table size %u, %u lookups\n", MESH_PEER_TABLE_SIZE, NUM_LOOKUPS);
+
+    setup_lookups(NUM_SOURCES);
+    lookups_per_second = run_hashed(&accepted);
+    printf("- hashed, %4u sources:               %12.0f lookups/s, %u accepted, %u peers\n", NUM_SOURCES, lookups_per_second, accepted, mesh_peer_count());
+
+    setup_lookups(NUM_SOURCES * 2);
+    lookups_per_second = run_hashed(&accepted);
+    printf("- hashed, %4u sources, LRU replaced: %12.0f lookups/s, %u accepted, %u peers\n", NUM_SOURCES * 2, lookups_per_second, accepted, mesh_peer_count());
+
+    setup_lookups(NUM_SOURCES);
+    lookups_per_second = run_linear(&accepted);
+    printf("- linear scan, %4u sources:          %12.0f lookups/s, %u accepted\n", NUM_SOURCES, lookups_per_second, accepted);
+    return EXIT_SUCCESS;
+}
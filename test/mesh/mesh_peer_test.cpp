@@ -0,0 +1,204 @@
+//
+// mesh_peer replay protection list test
+//
+// Built with MESH_PEER_TABLE_SIZE 1024 to track 1000 distinct sources. Storage timer is fired manually,
+// TLV stores are counted to check that updates are batched.
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "btstack_run_loop.h"
+#include "btstack_tlv.h"
+#include "btstack_util.h"
+#include "mesh/mesh_peer.h"
+#include "mock_btstack_tlv.h"
+
+#define NUM_SOURCES 1000
+#define FIRST_SOURCE 0x0100
+
+// default from mesh_peer.c
+#ifndef MESH_PEER_TABLE_SIZE
+#define MESH_PEER_TABLE_SIZE 16
+#endif
+
+static mock_btstack_tlv_t    tlv_context;
+static const btstack_tlv_t * tlv_mock_impl;
+static uint32_t              tlv_num_stores;
+
+// count stores in mock TLV
+static int tlv_get_tag(void * context, uint32_t tag, uint8_t * buffer, uint32_t buffer_size){
+    return tlv_mock_impl->get_tag(context, tag, buffer, buffer_size);
+}
+static int tlv_store_tag(void * context, uint32_t tag, const uint8_t * data, uint32_t data_size){
+    tlv_num_stores++;
+    return tlv_mock_impl->store_tag(context, tag, data, data_size);
+}
+static void tlv_delete_tag(void * context, uint32_t tag){
+    tlv_mock_impl->delete_tag(context, tag);
+}
+static const btstack_tlv_t tlv_impl = {
+    &tlv_get_tag,
+    &tlv_store_tag,
+    &tlv_delete_tag,
+};
+
+// mock btstack_run_loop.c
+static btstack_timer_source_t * storage_timer;
+static uint32_t                 storage_timer_starts;
+
+extern "C" void btstack_run_loop_set_timer(btstack_timer_source_t * ts, uint32_t timeout){
+    UNUSED(ts);
+    UNUSED(timeout);
+}
+extern "C" void btstack_run_loop_set_timer_handler(btstack_timer_source_t * ts, void (*fn)(btstack_timer_source_t * ts)){
+    ts->process = fn;
+}
+extern "C" void btstack_run_loop_add_timer(btstack_timer_source_t * ts){
+    CHECK(storage_timer == NULL);
+    storage_timer = ts;
+    storage_timer_starts++;
+}
+extern "C" int btstack_run_loop_remove_timer(btstack_timer_source_t * ts){
+    CHECK(storage_timer == ts);
+    storage_timer = NULL;
+    return 1;
+}
+
+static void fire_storage_timer(void){
+    CHECK(storage_timer != NULL);
+    btstack_timer_source_t * ts = storage_timer;
+    storage_timer = NULL;
+    (*ts->process)(ts);
+}
+
+static bool receive(uint16_t src, uint32_t iv_index, uint32_t seq){
+    mesh_peer_t * peer = mesh_peer_for_addr(src);
+    CHECK(peer != NULL);
+    CHECK_EQUAL(src, peer->address);
+    return mesh_peer_replay_protection_check(peer, iv_index, seq);
+}
+
+TEST_GROUP(MeshPeer){
+    void setup(void){
+        tlv_mock_impl = mock_btstack_tlv_init_instance(&tlv_context);
+        btstack_tlv_set_instance(&tlv_impl, &tlv_context);
+        tlv_num_stores = 0;
+        storage_timer = NULL;
+        storage_timer_starts = 0;
+        mesh_seq_auth_reset();
+    }
+    void teardown(void){
+        mesh_peer_delete_all();
+        mock_btstack_tlv_deinit(&tlv_context);
+        btstack_tlv_set_instance(NULL, NULL);
+    }
+};
+
+TEST(MeshPeer, ReplayProtection){
+    CHECK(receive(0x0001, 5, 10));
+    CHECK(receive(0x0001, 5, 11));
+    // replayed or older SEQ
+    CHECK_FALSE(receive(0x0001, 5, 11));
+    CHECK_FALSE(receive(0x0001, 5, 3));
+    // older IV Index
+    CHECK_FALSE(receive(0x0001, 4, 100));
+    // newer IV Index resets SEQ
+    CHECK(receive(0x0001, 6, 0));
+    CHECK_FALSE(receive(0x0001, 5, 200));
+    // SEQ above 16 bit
+    CHECK(receive(0x0001, 6, 0x012345));
+    CHECK_FALSE(receive(0x0001, 6, 0x002345));
+}
+
+TEST(MeshPeer, DistinctSources){
+    uint16_t i;
+    for (i = 0; i < NUM_SOURCES; i++){
+        CHECK(receive(FIRST_SOURCE + i, 0, 1));
+    }
+    CHECK_EQUAL(NUM_SOURCES, mesh_peer_count());
+    // all sources tracked, replays dropped, new SEQ accepted
+    for (i = 0; i < NUM_SOURCES; i++){
+        CHECK_FALSE(receive(FIRST_SOURCE + i, 0, 1));
+        CHECK(receive(FIRST_SOURCE + i, 0, 2));
+    }
+    CHECK_EQUAL(NUM_SOURCES, mesh_peer_count());
+}
+
+TEST(MeshPeer, BatchedStorage){
+    uint16_t i;
+    uint32_t seq;
+    for (seq = 1; seq <= 10; seq++){
+        for (i = 0; i < NUM_SOURCES; i++){
+            CHECK(receive(FIRST_SOURCE + i, 0, seq));
+        }
+    }
+    // nothing stored until storage timer fires, then each updated peer is stored once
+    CHECK_EQUAL(0, tlv_num_stores);
+    CHECK_EQUAL(1, storage_timer_starts);
+    fire_storage_timer();
+    CHECK_EQUAL(NUM_SOURCES, tlv_num_stores);
+
+    // only peers updated since are stored with next batch
+    CHECK(receive(FIRST_SOURCE, 0, 20));
+    CHECK(receive(FIRST_SOURCE + 1, 0, 20));
+    CHECK_EQUAL(2, storage_timer_starts);
+    mesh_peer_store();
+    CHECK(storage_timer == NULL);
+    CHECK_EQUAL(NUM_SOURCES + 2, tlv_num_stores);
+
+    // reload
+    mesh_peer_load();
+    CHECK_EQUAL(NUM_SOURCES, mesh_peer_count());
+    CHECK_FALSE(receive(FIRST_SOURCE, 0, 20));
+    CHECK(receive(FIRST_SOURCE, 0, 21));
+    CHECK_FALSE(receive(FIRST_SOURCE + 2, 0, 10));
+    CHECK(receive(FIRST_SOURCE + 2, 0, 11));
+
+    // delete all
+    mesh_peer_delete_all();
+    mesh_peer_load();
+    CHECK_EQUAL(0, mesh_peer_count());
+}
+
+TEST(MeshPeer, LeastRecentlyUsedReplaced){
+    // fill table
+    uint16_t i;
+    for (i = 0; i < MESH_PEER_TABLE_SIZE; i++){
+        CHECK(receive(FIRST_SOURCE + i, 0, 1));
+    }
+    CHECK_EQUAL(MESH_PEER_TABLE_SIZE, mesh_peer_count());
+    // use first source again, first source with ongoing reassembly
+    CHECK(receive(FIRST_SOURCE, 0, 2));
+    mesh_segmented_pdu_t segmented_pdu;
+    mesh_peer_for_addr(FIRST_SOURCE + 1)->message_pdu = &segmented_pdu;
+    CHECK(receive(FIRST_SOURCE, 0, 3));
+
+    // new source replaces third one
+    CHECK(receive(0x7000, 0, 1));
+    CHECK_EQUAL(MESH_PEER_TABLE_SIZE, mesh_peer_count());
+    CHECK_FALSE(receive(FIRST_SOURCE, 0, 3));
+    CHECK_FALSE(receive(FIRST_SOURCE + 1, 0, 1));
+    CHECK_FALSE(receive(FIRST_SOURCE + 3, 0, 1));
+    // replaced source is unknown again
+    CHECK(receive(FIRST_SOURCE + 2, 0, 1));
+}
+
+TEST(MeshPeer, AllBusy){
+    static mesh_segmented_pdu_t segmented_pdus[MESH_PEER_TABLE_SIZE];
+    uint16_t i;
+    for (i = 0; i < MESH_PEER_TABLE_SIZE; i++){
+        mesh_peer_for_addr(FIRST_SOURCE + i)->message_pdu = &segmented_pdus[i];
+    }
+    POINTERS_EQUAL(NULL, mesh_peer_for_addr(0x7000));
+    // known peer is still found
+    CHECK(mesh_peer_for_addr(FIRST_SOURCE) != NULL);
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
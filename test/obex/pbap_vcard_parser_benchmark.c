@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+// *****************************************************************************
+//
+// PBAP vCard Parser Benchmark
+//
+// Parses a synthetic phone book with 10000 vCards, delivered in chunks of
+// typical OBEX body size
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "btstack_util.h"
+#include "classic/pbap_vcard_parser.h"
+
+#define NUM_VCARDS          10000
+#define OBEX_BODY_SIZE      1000
+#define NUM_ITERATIONS      10
+
+static uint8_t * phonebook;
+static uint32_t  phonebook_size;
+
+static uint32_t num_cards;
+static uint32_t num_properties;
+
+void hci_dump_log(int log_level, const char * format, ...){
+    (void) log_level;
+    (void) format;
+}
+
+void btstack_assert_failed(const char * file, uint16_t line_nr){
+    printf("Assert: file %s, line %u\n", file, line_nr);
+    exit(1);
+}
+
+static void vcard_callback(void * user_data, pbap_vcard_parser_event_t event, const char * name, const char * params,
+                           const uint8_t * value, uint16_t value_len, bool value_complete){
+    (void) user_data;
+    (void) name;
+    (void) params;
+    (void) value;
+    (void) value_len;
+    switch (event){
+        case PBAP_VCARD_PARSER_EVENT_CARD_END:
+            num_cards++;
+            break;
+        case PBAP_VCARD_PARSER_EVENT_PROPERTY:
+            if (value_complete){
+                num_properties++;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void phonebook_create(void){
+    // upper bound for all vCards
+    uint32_t max_size = NUM_VCARDS * 400;
+    phonebook = malloc(max_size);
+    phonebook_size = 0;
+    int i;
+    for (i = 0; i < NUM_VCARDS; i++){
+        int len;
+        if ((i & 1) == 0){
+            len = snprintf((char *) &phonebook[phonebook_size], max_size - phonebook_size,
+                           "BEGIN:VCARD\r\n"
+                           "VERSION:3.0\r\n"
+                           "FN:Contact %05u\r\n"
+                           "N:%05u;Contact;;;\r\n"
+                           "TEL;TYPE=CELL:+49 170 %07u\r\n"
+                           "TEL;TYPE=HOME:+49 30 %07u\r\n"
+                           "EMAIL;TYPE=INTERNET:contact%05u@example.com\r\n"
+                           "NOTE:This is a long note that is folded over\r\n"
+                           "  multiple lines for contact %05u\r\n"
+                           "X-IRMC-CALL-DATETIME;RECEIVED:20240101T1200%02u\r\n"
+                           "END:VCARD\r\n",
+                           i, i, i, i, i, i, i % 60);
+        } else {
+            len = snprintf((char *) &phonebook[phonebook_size], max_size - phonebook_size,
+                           "BEGIN:VCARD\r\n"
+                           "VERSION:2.1\r\n"
+                           "FN;CHARSET=UTF-8;ENCODING=QUOTED-PRINTABLE:M=C3=BC=\r\n"
+                           "ller %05u\r\n"
+                           "N;CHARSET=UTF-8;ENCODING=QUOTED-PRINTABLE:M=C3=BCller;%05u;;;\r\n"
+                           "TEL;CELL:+49 171 %07u\r\n"
+                           "END:VCARD\r\n",
+                           i, i, i);
+        }
+        phonebook_size += (uint32_t) len;
+    }
+}
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+}
+
+int main(int argc, const char * argv[]){
+    (void) argc;
+    (void) argv;
+
+    phonebook_create();
+
+    pbap_vcard_parser_t parser;
+    double start = time_now();
+    int i;
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        num_cards = 0;
+        num_properties = 0;
+        pbap_vcard_parser_init(&parser, &vcard_callback, NULL);
+        uint32_t offset;
+        for (offset = 0; offset < phonebook_size; offset += OBEX_BODY_SIZE){
+            uint16_t chunk_size = (uint16_t) btstack_min(OBEX_BODY_SIZE, phonebook_size - offset);
+            pbap_vcard_parser_process_data(&parser, &phonebook[offset], chunk_size);
+        }
+        pbap_vcard_parser_finalize(&parser);
+    }
+    double duration = time_now() - start;
+
+    if (num_cards != NUM_VCARDS){
+        printf("Error: parsed %u of %u vCards\n", num_cards, NUM_VCARDS);
+        return 1;
+    }
+
+    printf("Phone book: %u vCards, %u properties, %u bytes\n", num_cards, num_properties, phonebook_size);
+    printf("- parser state:  %u bytes\n", (unsigned int) sizeof(pbap_vcard_parser_t));
+    printf("- throughput:    %10.0f vCards/s\n", (double) num_cards * NUM_ITERATIONS / duration);
+    printf("- throughput:    %10.2f MB/s\n", (double) phonebook_size * NUM_ITERATIONS / duration / 1e6);
+
+    free(phonebook);
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "btstack_debug.h"
+#include "classic/pbap_vcard_parser.h"
+
+#define MAX_PROPERTIES 20
+
+typedef struct {
+    char    name[PBAP_VCARD_PARSER_MAX_NAME_LEN + 1];
+    char    params[PBAP_VCARD_PARSER_MAX_PARAMS_LEN + 1];
+    char    value[1000];
+    uint16_t value_len;
+    int     num_fragments;
+} test_property_t;
+
+static int test_num_cards_begin;
+static int test_num_cards_end;
+static int test_num_properties;
+static test_property_t test_properties[MAX_PROPERTIES];
+static bool test_fragment_pending;
+
+// mock hci_dump.c
+extern "C" void hci_dump_log(int log_level, const char * format, ...){}
+extern "C" void btstack_assert_failed(const char * file, uint16_t line_nr){
+    FAIL("assert");
+}
+
+static void vcard_callback(void * user_data, pbap_vcard_parser_event_t event, const char * name, const char * params,
+                           const uint8_t * value, uint16_t value_len, bool value_complete){
+    test_property_t * property;
+    switch (event){
+        case PBAP_VCARD_PARSER_EVENT_CARD_BEGIN:
+            test_num_cards_begin++;
+            break;
+        case PBAP_VCARD_PARSER_EVENT_CARD_END:
+            test_num_cards_end++;
+            break;
+        case PBAP_VCARD_PARSER_EVENT_PROPERTY:
+            CHECK(test_num_properties < MAX_PROPERTIES);
+            property = &test_properties[test_num_properties];
+            if (!test_fragment_pending){
+                strcpy(property->name, name);
+                strcpy(property->params, params);
+            } else {
+                STRCMP_EQUAL(property->name, name);
+            }
+            CHECK((property->value_len + value_len) < sizeof(property->value));
+            memcpy(&property->value[property->value_len], value, value_len);
+            property->value_len += value_len;
+            property->num_fragments++;
+            test_fragment_pending = !value_complete;
+            if (value_complete){
+                test_num_properties++;
+            }
+            break;
+        default:
+            FAIL("unknown event");
+            break;
+    }
+}
+
+TEST_GROUP(PBAP_VCARD_PARSER){
+    pbap_vcard_parser_t parser;
+
+    void setup(void){
+        test_num_cards_begin = 0;
+        test_num_cards_end = 0;
+        test_num_properties = 0;
+        test_fragment_pending = false;
+        memset(test_properties, 0, sizeof(test_properties));
+        pbap_vcard_parser_init(&parser, &vcard_callback, NULL);
+    }
+
+    void parse_bytewise(const char * vcard){
+        uint16_t len = (uint16_t) strlen(vcard);
+        for (uint16_t i = 0; i < len; i++){
+            pbap_vcard_parser_process_data(&parser, (const uint8_t *) &vcard[i], 1);
+        }
+        pbap_vcard_parser_finalize(&parser);
+    }
+
+    void parse(const char * vcard){
+        pbap_vcard_parser_process_data(&parser, (const uint8_t *) vcard, (uint16_t) strlen(vcard));
+        pbap_vcard_parser_finalize(&parser);
+    }
+
+    void check_property(int index, const char * name, const char * params, const char * value){
+        test_property_t * property = &test_properties[index];
+        property->value[property->value_len] = 0;
+        STRCMP_EQUAL(name, property->name);
+        STRCMP_EQUAL(params, property->params);
+        STRCMP_EQUAL(value, property->value);
+    }
+};
+
+static const char * vcard_30 =
+    "BEGIN:VCARD\r\n"
+    "VERSION:3.0\r\n"
+    "FN:Jane Doe\r\n"
+    "N:Doe;Jane;;;\r\n"
+    "TEL;TYPE=CELL:+49 123 456\r\n"
+    "END:VCARD\r\n";
+
+TEST(PBAP_VCARD_PARSER, SingleCard){
+    parse(vcard_30);
+    CHECK_EQUAL(1, test_num_cards_begin);
+    CHECK_EQUAL(1, test_num_cards_end);
+    CHECK_EQUAL(4, test_num_properties);
+    check_property(0, "VERSION", "", "3.0");
+    check_property(1, "FN", "", "Jane Doe");
+    check_property(2, "N", "", "Doe;Jane;;;");
+    check_property(3, "TEL", "TYPE=CELL", "+49 123 456");
+}
+
+TEST(PBAP_VCARD_PARSER, SingleCardBytewise){
+    parse_bytewise(vcard_30);
+    CHECK_EQUAL(1, test_num_cards_begin);
+    CHECK_EQUAL(1, test_num_cards_end);
+    CHECK_EQUAL(4, test_num_properties);
+    check_property(3, "TEL", "TYPE=CELL", "+49 123 456");
+}
+
+TEST(PBAP_VCARD_PARSER, EndReportedWithoutLookahead){
+    pbap_vcard_parser_process_data(&parser, (const uint8_t *) vcard_30, (uint16_t) strlen(vcard_30));
+    CHECK_EQUAL(1, test_num_cards_end);
+    CHECK_EQUAL(4, test_num_properties);
+}
+
+TEST(PBAP_VCARD_PARSER, MultipleCards){
+    parse("BEGIN:VCARD\nVERSION:2.1\nN:A\nEND:VCARD\nBEGIN:VCARD\nVERSION:2.1\nN:B\nEND:VCARD\n");
+    CHECK_EQUAL(2, test_num_cards_begin);
+    CHECK_EQUAL(2, test_num_cards_end);
+    CHECK_EQUAL(4, test_num_properties);
+    check_property(1, "N", "", "A");
+    check_property(3, "N", "", "B");
+}
+
+TEST(PBAP_VCARD_PARSER, CaseInsensitiveDelimiter){
+    parse("begin:vcard\r\nFN:x\r\nend:vCard\r\n");
+    CHECK_EQUAL(1, test_num_cards_begin);
+    CHECK_EQUAL(1, test_num_cards_end);
+    CHECK_EQUAL(1, test_num_properties);
+}
+
+TEST(PBAP_VCARD_PARSER, FoldedLine){
+    parse_bytewise("BEGIN:VCARD\r\nNOTE:This is a long\r\n  note\r\n\tcontinued\r\nEND:VCARD\r\n");
+    CHECK_EQUAL(1, test_num_properties);
+    check_property(0, "NOTE", "", "This is a long notecontinued");
+}
+
+TEST(PBAP_VCARD_PARSER, QuotedPrintableSoftLineBreak){
+    parse_bytewise("BEGIN:VCARD\r\n"
+                   "N;CHARSET=UTF-8;ENCODING=QUOTED-PRINTABLE:M=C3=BC=\r\n"
+                   "ller\r\n"
+                   "END:VCARD\r\n");
+    CHECK_EQUAL(1, test_num_properties);
+    check_property(0, "N", "CHARSET=UTF-8;ENCODING=QUOTED-PRINTABLE", "M=C3=BCller");
+}
+
+TEST(PBAP_VCARD_PARSER, QuotedParams){
+    parse("BEGIN:VCARD\r\nX-TEST;LABEL=\"a:b\":value\r\nEND:VCARD\r\n");
+    CHECK_EQUAL(1, test_num_properties);
+    check_property(0, "X-TEST", "LABEL=\"a:b\"", "value");
+}
+
+TEST(PBAP_VCARD_PARSER, GroupedProperty){
+    parse("BEGIN:VCARD\r\nitem1.TEL:123\r\nEND:VCARD\r\n");
+    check_property(0, "item1.TEL", "", "123");
+}
+
+TEST(PBAP_VCARD_PARSER, LongValueFragmented){
+    char vcard[800];
+    char photo[500];
+    memset(photo, 'A', sizeof(photo) - 1);
+    photo[sizeof(photo) - 1] = 0;
+    snprintf(vcard, sizeof(vcard), "BEGIN:VCARD\r\nPHOTO;ENCODING=b:%s\r\nEND:VCARD\r\n", photo);
+    parse_bytewise(vcard);
+    CHECK_EQUAL(1, test_num_properties);
+    CHECK_EQUAL(sizeof(photo) - 1, test_properties[0].value_len);
+    CHECK_EQUAL(((sizeof(photo) - 1) + PBAP_VCARD_PARSER_MAX_VALUE_LEN - 1) / PBAP_VCARD_PARSER_MAX_VALUE_LEN, test_properties[0].num_fragments);
+    check_property(0, "PHOTO", "ENCODING=b", photo);
+}
+
+TEST(PBAP_VCARD_PARSER, NestedCard){
+    parse("BEGIN:VCARD\r\nN:A\r\nAGENT:\r\nBEGIN:VCARD\r\nN:B\r\nEND:VCARD\r\nEND:VCARD\r\n");
+    CHECK_EQUAL(1, test_num_cards_begin);
+    CHECK_EQUAL(1, test_num_cards_end);
+    CHECK_EQUAL(3, test_num_properties);
+    check_property(2, "N", "", "B");
+}
+
+TEST(PBAP_VCARD_PARSER, PropertiesOutsideCardIgnored){
+    parse("N:outside\r\nBEGIN:VCARD\r\nN:inside\r\nEND:VCARD\r\nN:outside\r\n");
+    CHECK_EQUAL(1, test_num_properties);
+    check_property(0, "N", "", "inside");
+}
+
+TEST(PBAP_VCARD_PARSER, MissingFinalLineBreak){
+    parse("BEGIN:VCARD\r\nN:A\r\nEND:VCARD");
+    CHECK_EQUAL(1, test_num_cards_end);
+    CHECK_EQUAL(1, test_num_properties);
+}
+
+TEST(PBAP_VCARD_PARSER, ResetDiscardsPartialCard){
+    const char * partial = "BEGIN:VCARD\r\nN:A\r\nNOTE:abort";
+    pbap_vcard_parser_process_data(&parser, (const uint8_t *) partial, (uint16_t) strlen(partial));
+    pbap_vcard_parser_reset(&parser);
+    parse("N:outside\r\nBEGIN:VCARD\r\nN:B\r\nEND:VCARD\r\n");
+    CHECK_EQUAL(2, test_num_cards_begin);
+    CHECK_EQUAL(1, test_num_cards_end);
+    CHECK_EQUAL(2, test_num_properties);
+    check_property(0, "N", "", "A");
+    check_property(1, "N", "", "B");
+}
+
+TEST(PBAP_VCARD_PARSER, LongParams){
+    // PBAP_VCARD_PARSER_MAX_PARAMS_LEN > 255 set in Makefile
+    char vcard[800];
+    char params[PBAP_VCARD_PARSER_MAX_PARAMS_LEN + 20];
+    memset(params, 'P', sizeof(params) - 1);
+    params[sizeof(params) - 1] = 0;
+    snprintf(vcard, sizeof(vcard), "BEGIN:VCARD\r\nX-TEST;%s:value\r\nEND:VCARD\r\n", params);
+    parse(vcard);
+    CHECK_EQUAL(1, test_num_properties);
+    params[PBAP_VCARD_PARSER_MAX_PARAMS_LEN] = 0;
+    check_property(0, "X-TEST", params, "value");
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
@@ -93,6 +93,150 @@ TEST(RingBuffer, ReadWriteChunks){
     }
 }
 
+TEST(RingBuffer, WriteSpan){
+    uint8_t * span;
+    // empty: span up to end of storage
+    CHECK_EQUAL(storage_size, btstack_ring_buffer_get_write_span(&ring_buffer, &span));
+    POINTERS_EQUAL(storage, span);
+    memset(span, 0x11, 7);
+    btstack_ring_buffer_commit_write(&ring_buffer, 7);
+    CHECK_EQUAL(7, btstack_ring_buffer_bytes_available(&ring_buffer));
+
+    uint8_t test_read_data[5];
+    uint32_t number_of_bytes_read = 0;
+    btstack_ring_buffer_read(&ring_buffer, test_read_data, 5, &number_of_bytes_read);
+    CHECK_EQUAL(0x11, test_read_data[4]);
+
+    // span up to end of storage, then up to read position
+    CHECK_EQUAL(3, btstack_ring_buffer_get_write_span(&ring_buffer, &span));
+    POINTERS_EQUAL(&storage[7], span);
+    memset(span, 0x22, 3);
+    btstack_ring_buffer_commit_write(&ring_buffer, 3);
+    CHECK_EQUAL(5, btstack_ring_buffer_get_write_span(&ring_buffer, &span));
+    POINTERS_EQUAL(storage, span);
+    memset(span, 0x33, 5);
+    btstack_ring_buffer_commit_write(&ring_buffer, 5);
+
+    // full
+    CHECK_EQUAL(0, btstack_ring_buffer_bytes_free(&ring_buffer));
+    CHECK_EQUAL(0, btstack_ring_buffer_get_write_span(&ring_buffer, &span));
+}
+
+TEST(RingBuffer, ReadSpan){
+    const uint8_t * span;
+    CHECK_EQUAL(0, btstack_ring_buffer_get_read_span(&ring_buffer, &span));
+
+    uint8_t test_write_data[] = {1,2,3,4,5,6,7,8};
+    btstack_ring_buffer_write(&ring_buffer, test_write_data, sizeof(test_write_data));
+    CHECK_EQUAL(8, btstack_ring_buffer_get_read_span(&ring_buffer, &span));
+    POINTERS_EQUAL(storage, span);
+    btstack_ring_buffer_commit_read(&ring_buffer, 6);
+
+    // wrapped data: span up to end of storage, then from start
+    btstack_ring_buffer_write(&ring_buffer, test_write_data, sizeof(test_write_data));
+    CHECK_EQUAL(10, btstack_ring_buffer_bytes_available(&ring_buffer));
+    CHECK_EQUAL(4, btstack_ring_buffer_get_read_span(&ring_buffer, &span));
+    CHECK_EQUAL(7, span[0]);
+    CHECK_EQUAL(2, span[3]);
+    btstack_ring_buffer_commit_read(&ring_buffer, 4);
+    CHECK_EQUAL(6, btstack_ring_buffer_get_read_span(&ring_buffer, &span));
+    POINTERS_EQUAL(storage, span);
+    CHECK_EQUAL(3, span[0]);
+    CHECK_EQUAL(8, span[5]);
+    btstack_ring_buffer_commit_read(&ring_buffer, 6);
+    CHECK_TRUE(btstack_ring_buffer_empty(&ring_buffer));
+    CHECK_EQUAL(0, btstack_ring_buffer_get_read_span(&ring_buffer, &span));
+}
+
+TEST(RingBuffer, ReadSpanFull){
+    uint8_t test_write_data[] = {1,2,3,4,5,6,7,8,9,10};
+    const uint8_t * span;
+    btstack_ring_buffer_commit_write(&ring_buffer, 4);
+    btstack_ring_buffer_commit_read(&ring_buffer, 4);
+    btstack_ring_buffer_write(&ring_buffer, test_write_data, sizeof(test_write_data));
+    // full with read position == write position
+    CHECK_EQUAL(6, btstack_ring_buffer_get_read_span(&ring_buffer, &span));
+    CHECK_EQUAL(1, span[0]);
+    btstack_ring_buffer_commit_read(&ring_buffer, 6);
+    CHECK_EQUAL(4, btstack_ring_buffer_get_read_span(&ring_buffer, &span));
+    CHECK_EQUAL(7, span[0]);
+}
+
+TEST_GROUP(RingBufferPow2){
+    btstack_ring_buffer_pow2_t ring_buffer;
+    uint8_t pow2_storage[8];
+
+    void setup(void){
+        memset(pow2_storage, 0, sizeof(pow2_storage));
+        btstack_ring_buffer_pow2_init(&ring_buffer, pow2_storage, sizeof(pow2_storage));
+    }
+};
+
+TEST(RingBufferPow2, EmptyBuffer){
+    CHECK_TRUE(btstack_ring_buffer_pow2_empty(&ring_buffer));
+    CHECK_EQUAL(0, btstack_ring_buffer_pow2_bytes_available(&ring_buffer));
+    CHECK_EQUAL(8, btstack_ring_buffer_pow2_bytes_free(&ring_buffer));
+    uint8_t test_read_data[4];
+    uint32_t number_of_bytes_read = 1;
+    btstack_ring_buffer_pow2_read(&ring_buffer, test_read_data, sizeof(test_read_data), &number_of_bytes_read);
+    CHECK_EQUAL(0, number_of_bytes_read);
+}
+
+TEST(RingBufferPow2, WriteFullBuffer){
+    uint8_t test_write_data[] = {1,2,3,4,5,6,7,8,9};
+    CHECK_EQUAL(ERROR_CODE_MEMORY_CAPACITY_EXCEEDED, btstack_ring_buffer_pow2_write(&ring_buffer, test_write_data, 9));
+    CHECK_EQUAL(ERROR_CODE_SUCCESS, btstack_ring_buffer_pow2_write(&ring_buffer, test_write_data, 8));
+    CHECK_EQUAL(0, btstack_ring_buffer_pow2_bytes_free(&ring_buffer));
+    CHECK_EQUAL(ERROR_CODE_MEMORY_CAPACITY_EXCEEDED, btstack_ring_buffer_pow2_write(&ring_buffer, test_write_data, 1));
+    uint8_t test_read_data[8];
+    uint32_t number_of_bytes_read = 0;
+    btstack_ring_buffer_pow2_read(&ring_buffer, test_read_data, sizeof(test_read_data), &number_of_bytes_read);
+    CHECK_EQUAL(8, number_of_bytes_read);
+    CHECK_EQUAL(0, memcmp(test_write_data, test_read_data, 8));
+}
+
+TEST(RingBufferPow2, ReadWrite){
+    uint8_t test_write_data[] = {1,2,3};
+    uint8_t test_read_data[3];
+    int i;
+    // indices wrap in storage several times
+    for (i=0;i<30;i++){
+        CHECK_EQUAL(ERROR_CODE_SUCCESS, btstack_ring_buffer_pow2_write(&ring_buffer, test_write_data, sizeof(test_write_data)));
+        CHECK_EQUAL(3, btstack_ring_buffer_pow2_bytes_available(&ring_buffer));
+        memset(test_read_data, 0, sizeof(test_read_data));
+        uint32_t number_of_bytes_read = 0;
+        btstack_ring_buffer_pow2_read(&ring_buffer, test_read_data, sizeof(test_read_data), &number_of_bytes_read);
+        CHECK_EQUAL(3, number_of_bytes_read);
+        CHECK_EQUAL(0, memcmp(test_write_data, test_read_data, sizeof(test_write_data)));
+    }
+}
+
+TEST(RingBufferPow2, Spans){
+    uint8_t * write_span;
+    const uint8_t * read_span;
+    btstack_ring_buffer_pow2_commit_write(&ring_buffer, 6);
+    btstack_ring_buffer_pow2_commit_read(&ring_buffer, 6);
+    CHECK_EQUAL(0, btstack_ring_buffer_pow2_get_read_span(&ring_buffer, &read_span));
+
+    CHECK_EQUAL(2, btstack_ring_buffer_pow2_get_write_span(&ring_buffer, &write_span));
+    POINTERS_EQUAL(&pow2_storage[6], write_span);
+    write_span[0] = 0x11;
+    write_span[1] = 0x22;
+    btstack_ring_buffer_pow2_commit_write(&ring_buffer, 2);
+    CHECK_EQUAL(6, btstack_ring_buffer_pow2_get_write_span(&ring_buffer, &write_span));
+    POINTERS_EQUAL(pow2_storage, write_span);
+    write_span[0] = 0x33;
+    btstack_ring_buffer_pow2_commit_write(&ring_buffer, 1);
+
+    CHECK_EQUAL(2, btstack_ring_buffer_pow2_get_read_span(&ring_buffer, &read_span));
+    CHECK_EQUAL(0x22, read_span[1]);
+    btstack_ring_buffer_pow2_commit_read(&ring_buffer, 2);
+    CHECK_EQUAL(1, btstack_ring_buffer_pow2_get_read_span(&ring_buffer, &read_span));
+    CHECK_EQUAL(0x33, read_span[0]);
+    btstack_ring_buffer_pow2_commit_read(&ring_buffer, 1);
+    CHECK_TRUE(btstack_ring_buffer_pow2_empty(&ring_buffer));
+}
+
 int main (int argc, const char * argv[]){
     return CommandLineTestRunner::RunAllTests(argc, argv);
 }
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include <pthread.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+#include "btstack_spsc_ring_buffer.h"
+#include "btstack_util.h"
+
+#define STORAGE_SIZE 16
+
+static uint8_t storage[STORAGE_SIZE];
+
+static int read_watermark_calls;
+static int write_watermark_calls;
+
+uint32_t btstack_min(uint32_t a, uint32_t b){
+    return a < b ? a : b;
+}
+
+static void read_watermark_handler(btstack_spsc_ring_buffer_t * ring_buffer){
+    UNUSED(ring_buffer);
+    read_watermark_calls++;
+}
+
+static void write_watermark_handler(btstack_spsc_ring_buffer_t * ring_buffer){
+    UNUSED(ring_buffer);
+    write_watermark_calls++;
+}
+
+TEST_GROUP(SPSCRingBuffer){
+    btstack_spsc_ring_buffer_t ring_buffer;
+
+    void setup(void){
+        memset(storage, 0, sizeof(storage));
+        btstack_spsc_ring_buffer_init(&ring_buffer, storage, sizeof(storage));
+        read_watermark_calls = 0;
+        write_watermark_calls = 0;
+    }
+};
+
+TEST(SPSCRingBuffer, EmptyBuffer){
+    CHECK_EQUAL(0, btstack_spsc_ring_buffer_bytes_available(&ring_buffer));
+    CHECK_EQUAL(STORAGE_SIZE, btstack_spsc_ring_buffer_bytes_free(&ring_buffer));
+    const uint8_t * span;
+    CHECK_EQUAL(0, btstack_spsc_ring_buffer_get_read_span(&ring_buffer, &span));
+    uint8_t buffer[4];
+    CHECK_EQUAL(0, btstack_spsc_ring_buffer_read(&ring_buffer, buffer, sizeof(buffer)));
+}
+
+TEST(SPSCRingBuffer, WriteRead){
+    uint8_t test_write_data[] = {1, 2, 3, 4, 5};
+    uint8_t test_read_data[5];
+    CHECK_EQUAL(5, btstack_spsc_ring_buffer_write(&ring_buffer, test_write_data, sizeof(test_write_data)));
+    CHECK_EQUAL(5, btstack_spsc_ring_buffer_bytes_available(&ring_buffer));
+    CHECK_EQUAL(STORAGE_SIZE - 5, btstack_spsc_ring_buffer_bytes_free(&ring_buffer));
+    CHECK_EQUAL(5, btstack_spsc_ring_buffer_read(&ring_buffer, test_read_data, sizeof(test_read_data)));
+    MEMCMP_EQUAL(test_write_data, test_read_data, sizeof(test_write_data));
+    CHECK_EQUAL(0, btstack_spsc_ring_buffer_bytes_available(&ring_buffer));
+}
+
+TEST(SPSCRingBuffer, WriteFull){
+    uint8_t test_write_data[STORAGE_SIZE + 4];
+    uint8_t i;
+    for (i = 0; i < sizeof(test_write_data); i++){
+        test_write_data[i] = i;
+    }
+    // partial write if not enough space
+    CHECK_EQUAL(STORAGE_SIZE, btstack_spsc_ring_buffer_write(&ring_buffer, test_write_data, sizeof(test_write_data)));
+    CHECK_EQUAL(0, btstack_spsc_ring_buffer_bytes_free(&ring_buffer));
+    CHECK_EQUAL(0, btstack_spsc_ring_buffer_write(&ring_buffer, test_write_data, 1));
+    uint8_t * span;
+    CHECK_EQUAL(0, btstack_spsc_ring_buffer_get_write_span(&ring_buffer, &span));
+    uint8_t test_read_data[STORAGE_SIZE];
+    CHECK_EQUAL(STORAGE_SIZE, btstack_spsc_ring_buffer_read(&ring_buffer, test_read_data, sizeof(test_read_data)));
+    MEMCMP_EQUAL(test_write_data, test_read_data, STORAGE_SIZE);
+}
+
+TEST(SPSCRingBuffer, WrapAround){
+    uint8_t test_write_data[12];
+    uint8_t test_read_data[12];
+    uint8_t i;
+    for (i = 0; i < sizeof(test_write_data); i++){
+        test_write_data[i] = 0x80u + i;
+    }
+    uint8_t round;
+    // free running positions wrap in storage several times
+    for (round = 0; round < 10; round++){
+        CHECK_EQUAL(12, btstack_spsc_ring_buffer_write(&ring_buffer, test_write_data, sizeof(test_write_data)));
+        memset(test_read_data, 0, sizeof(test_read_data));
+        CHECK_EQUAL(12, btstack_spsc_ring_buffer_read(&ring_buffer, test_read_data, sizeof(test_read_data)));
+        MEMCMP_EQUAL(test_write_data, test_read_data, sizeof(test_write_data));
+    }
+}
+
+TEST(SPSCRingBuffer, Spans){
+    uint8_t * write_span;
+    const uint8_t * read_span;
+    // move positions to 12
+    CHECK_EQUAL(STORAGE_SIZE, btstack_spsc_ring_buffer_get_write_span(&ring_buffer, &write_span));
+    POINTERS_EQUAL(storage, write_span);
+    btstack_spsc_ring_buffer_commit_write(&ring_buffer, 12);
+    CHECK_EQUAL(12, btstack_spsc_ring_buffer_get_read_span(&ring_buffer, &read_span));
+    btstack_spsc_ring_buffer_commit_read(&ring_buffer, 12);
+
+    // write span ends at end of storage
+    CHECK_EQUAL(4, btstack_spsc_ring_buffer_get_write_span(&ring_buffer, &write_span));
+    POINTERS_EQUAL(&storage[12], write_span);
+    memset(write_span, 0x11, 4);
+    btstack_spsc_ring_buffer_commit_write(&ring_buffer, 4);
+    CHECK_EQUAL(STORAGE_SIZE - 4, btstack_spsc_ring_buffer_get_write_span(&ring_buffer, &write_span));
+    POINTERS_EQUAL(storage, write_span);
+    memset(write_span, 0x22, 6);
+    btstack_spsc_ring_buffer_commit_write(&ring_buffer, 6);
+    CHECK_EQUAL(10, btstack_spsc_ring_buffer_bytes_available(&ring_buffer));
+
+    // read span ends at end of storage
+    CHECK_EQUAL(4, btstack_spsc_ring_buffer_get_read_span(&ring_buffer, &read_span));
+    POINTERS_EQUAL(&storage[12], read_span);
+    CHECK_EQUAL(0x11, read_span[3]);
+    btstack_spsc_ring_buffer_commit_read(&ring_buffer, 4);
+    CHECK_EQUAL(6, btstack_spsc_ring_buffer_get_read_span(&ring_buffer, &read_span));
+    POINTERS_EQUAL(storage, read_span);
+    CHECK_EQUAL(0x22, read_span[5]);
+    btstack_spsc_ring_buffer_commit_read(&ring_buffer, 6);
+    CHECK_EQUAL(0, btstack_spsc_ring_buffer_bytes_available(&ring_buffer));
+}
+
+TEST(SPSCRingBuffer, Reset){
+    uint8_t test_write_data[] = {1, 2, 3};
+    btstack_spsc_ring_buffer_write(&ring_buffer, test_write_data, sizeof(test_write_data));
+    btstack_spsc_ring_buffer_reset(&ring_buffer);
+    CHECK_EQUAL(0, btstack_spsc_ring_buffer_bytes_available(&ring_buffer));
+    uint8_t * write_span;
+    CHECK_EQUAL(STORAGE_SIZE, btstack_spsc_ring_buffer_get_write_span(&ring_buffer, &write_span));
+}
+
+TEST(SPSCRingBuffer, ReadWatermark){
+    uint8_t data[4] = { 0 };
+    btstack_spsc_ring_buffer_set_read_watermark(&ring_buffer, 8, &read_watermark_handler);
+    btstack_spsc_ring_buffer_write(&ring_buffer, data, 4);
+    CHECK_EQUAL(0, read_watermark_calls);
+    btstack_spsc_ring_buffer_write(&ring_buffer, data, 4);
+    CHECK_EQUAL(1, read_watermark_calls);
+    // level triggered, called again if consumer did not read yet
+    btstack_spsc_ring_buffer_write(&ring_buffer, data, 4);
+    CHECK_EQUAL(2, read_watermark_calls);
+    // no call on failed write
+    btstack_spsc_ring_buffer_write(&ring_buffer, data, 4);
+    btstack_spsc_ring_buffer_write(&ring_buffer, data, 4);
+    CHECK_EQUAL(3, read_watermark_calls);
+    CHECK_EQUAL(0, write_watermark_calls);
+}
+
+TEST(SPSCRingBuffer, WriteWatermark){
+    uint8_t data[STORAGE_SIZE] = { 0 };
+    btstack_spsc_ring_buffer_set_write_watermark(&ring_buffer, 8, &write_watermark_handler);
+    btstack_spsc_ring_buffer_write(&ring_buffer, data, STORAGE_SIZE);
+    btstack_spsc_ring_buffer_read(&ring_buffer, data, 4);
+    CHECK_EQUAL(0, write_watermark_calls);
+    btstack_spsc_ring_buffer_read(&ring_buffer, data, 4);
+    CHECK_EQUAL(1, write_watermark_calls);
+    btstack_spsc_ring_buffer_read(&ring_buffer, data, 4);
+    CHECK_EQUAL(2, write_watermark_calls);
+    CHECK_EQUAL(0, read_watermark_calls);
+}
+
+// producer and consumer thread with odd chunk sizes, consumer checks byte sequence
+
+#define STRESS_NUM_BYTES 1000000
+
+static btstack_spsc_ring_buffer_t stress_ring_buffer;
+static uint8_t                    stress_storage[64];
+
+static void * stress_producer(void * context){
+    UNUSED(context);
+    uint32_t pos = 0;
+    uint8_t chunk[7];
+    while (pos < STRESS_NUM_BYTES){
+        uint32_t chunk_len = btstack_min(1u + (pos % sizeof(chunk)), STRESS_NUM_BYTES - pos);
+        uint32_t i;
+        for (i = 0; i < chunk_len; i++){
+            chunk[i] = (uint8_t) ((pos + i) * 13u);
+        }
+        uint32_t written = btstack_spsc_ring_buffer_write(&stress_ring_buffer, chunk, chunk_len);
+        pos += written;
+        if (written == 0){
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+TEST(SPSCRingBuffer, ProducerConsumerThreads){
+    btstack_spsc_ring_buffer_init(&stress_ring_buffer, stress_storage, sizeof(stress_storage));
+    pthread_t producer;
+    pthread_create(&producer, NULL, &stress_producer, NULL);
+    uint32_t pos = 0;
+    uint32_t errors = 0;
+    while (pos < STRESS_NUM_BYTES){
+        const uint8_t * span;
+        uint32_t span_len = btstack_spsc_ring_buffer_get_read_span(&stress_ring_buffer, &span);
+        if (span_len == 0){
+            sched_yield();
+            continue;
+        }
+        span_len = btstack_min(span_len, 5);
+        uint32_t i;
+        for (i = 0; i < span_len; i++){
+            if (span[i] != (uint8_t) ((pos + i) * 13u)){
+                errors++;
+            }
+        }
+        btstack_spsc_ring_buffer_commit_read(&stress_ring_buffer, span_len);
+        pos += span_len;
+    }
+    pthread_join(producer, NULL);
+    CHECK_EQUAL(0, errors);
+    CHECK_EQUAL(0, btstack_spsc_ring_buffer_bytes_available(&stress_ring_buffer));
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+// *****************************************************************************
+//
+// Ring Buffer Benchmark
+//
+// Writes and reads small (1-4 bytes, e.g. HID reports or queued pointers) and bulk (1 KB, e.g. PCM) transfers
+// through btstack_ring_buffer with arbitrary and power-of-two capacity, using copy and span API.
+// Reports transfers/s and MB/s.
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "btstack_ring_buffer.h"
+#include "btstack_util.h"
+
+#define STORAGE_SIZE          4096
+#define SMALL_NUM_BYTES   (64 * 1024 * 1024)
+#define BULK_NUM_BYTES  (1024 * 1024 * 1024)
+#define BULK_CHUNK_SIZE       1024
+
+// from btstack_util.c, not linked
+uint32_t btstack_min(uint32_t a, uint32_t b){
+    return a < b ? a : b;
+}
+
+static uint8_t storage[STORAGE_SIZE];
+static uint8_t chunk_in[BULK_CHUNK_SIZE];
+static uint8_t chunk_out[BULK_CHUNK_SIZE];
+
+static btstack_ring_buffer_t      ring_buffer;
+static btstack_ring_buffer_pow2_t ring_buffer_pow2;
+
+static volatile uint32_t checksum;
+
+typedef enum {
+    MODE_COPY,
+    MODE_POW2_COPY,
+    MODE_SPAN,
+    MODE_POW2_SPAN,
+} benchmark_mode_t;
+
+static const char * mode_names[] = {
+    "btstack_ring_buffer, write/read",
+    "btstack_ring_buffer_pow2, write/read",
+    "btstack_ring_buffer, spans",
+    "btstack_ring_buffer_pow2, spans",
+};
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+// producer/consumer with spans handle contiguous part first, then the rest after wrap
+static void transfer_spans(uint32_t len){
+    uint32_t pos = 0;
+    while (pos < len){
+        uint8_t * span;
+        uint32_t span_len = btstack_min(btstack_ring_buffer_get_write_span(&ring_buffer, &span), len - pos);
+        memcpy(span, &chunk_in[pos], span_len);
+        btstack_ring_buffer_commit_write(&ring_buffer, span_len);
+        pos += span_len;
+    }
+    pos = 0;
+    while (pos < len){
+        const uint8_t * span;
+        uint32_t span_len = btstack_min(btstack_ring_buffer_get_read_span(&ring_buffer, &span), len - pos);
+        memcpy(&chunk_out[pos], span, span_len);
+        btstack_ring_buffer_commit_read(&ring_buffer, span_len);
+        pos += span_len;
+    }
+}
+
+static void transfer_pow2_spans(uint32_t len){
+    uint32_t pos = 0;
+    while (pos < len){
+        uint8_t * span;
+        uint32_t span_len = btstack_min(btstack_ring_buffer_pow2_get_write_span(&ring_buffer_pow2, &span), len - pos);
+        memcpy(span, &chunk_in[pos], span_len);
+        btstack_ring_buffer_pow2_commit_write(&ring_buffer_pow2, span_len);
+        pos += span_len;
+    }
+    pos = 0;
+    while (pos < len){
+        const uint8_t * span;
+        uint32_t span_len = btstack_min(btstack_ring_buffer_pow2_get_read_span(&ring_buffer_pow2, &span), len - pos);
+        memcpy(&chunk_out[pos], span, span_len);
+        btstack_ring_buffer_pow2_commit_read(&ring_buffer_pow2, span_len);
+        pos += span_len;
+    }
+}
+
+static void transfer(benchmark_mode_t mode, uint32_t len){
+    uint32_t bytes_read;
+    switch (mode){
+        case MODE_COPY:
+            btstack_ring_buffer_write(&ring_buffer, chunk_in, len);
+            btstack_ring_buffer_read(&ring_buffer, chunk_out, len, &bytes_read);
+            break;
+        case MODE_POW2_COPY:
+            btstack_ring_buffer_pow2_write(&ring_buffer_pow2, chunk_in, len);
+            btstack_ring_buffer_pow2_read(&ring_buffer_pow2, chunk_out, len, &bytes_read);
+            break;
+        case MODE_SPAN:
+            transfer_spans(len);
+            break;
+        case MODE_POW2_SPAN:
+            transfer_pow2_spans(len);
+            break;
+        default:
+            break;
+    }
+    checksum += chunk_out[0];
+}
+
+// small transfers cycle through 1-4 bytes, transfers wrap in storage regularly
+static void benchmark(benchmark_mode_t mode, int small){
+    btstack_ring_buffer_init(&ring_buffer, storage, STORAGE_SIZE);
+    btstack_ring_buffer_pow2_init(&ring_buffer_pow2, storage, STORAGE_SIZE);
+    uint32_t num_bytes = small ? SMALL_NUM_BYTES : BULK_NUM_BYTES;
+    uint32_t num_transfers = 0;
+    uint32_t pos = 0;
+    double start = time_now();
+    while (pos < num_bytes){
+        uint32_t len = small ? (1u + (num_transfers & 3u)) : BULK_CHUNK_SIZE;
+        transfer(mode, len);
+        pos += len;
+        num_transfers++;
+    }
+    double duration = time_now() - start;
+    fprintf(stderr, "%s\n", mode_names[mode]);
+    fprintf(stderr, "- %10.1f M transfers/s\n", (num_transfers / duration) / 1000000.0);
+    fprintf(stderr, "- %10.0f MB/s\n", (num_bytes / (1024.0 * 1024.0)) / duration);
+}
+
+int main(void){
+    uint32_t i;
+    for (i = 0; i < BULK_CHUNK_SIZE; i++){
+        chunk_in[i] = (uint8_t) i;
+    }
+    benchmark_mode_t mode;
+    fprintf(stderr, "Small transfers, 1-4 bytes, %u byte buffer\n", STORAGE_SIZE);
+    for (mode = MODE_COPY; mode <= MODE_POW2_SPAN; mode++){
+        benchmark(mode, 1);
+    }
+    fprintf(stderr, "Bulk transfers, %u bytes, %u byte buffer\n", BULK_CHUNK_SIZE, STORAGE_SIZE);
+    for (mode = MODE_COPY; mode <= MODE_POW2_SPAN; mode++){
+        benchmark(mode, 0);
+    }
+    return 0;
+}
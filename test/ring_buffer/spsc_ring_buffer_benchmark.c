@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL BLUEKITCHEN
+ * GMBH OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+// *****************************************************************************
+//
+// SPSC Ring Buffer Benchmark
+//
+// An audio thread records one PCM buffer every PERIOD_US and hands it over to a consumer thread that
+// plays the role of the BTstack run loop. Previously, the audio driver used a shared buffer polled by
+// the run loop every DRIVER_POLL_INTERVAL_MS; with btstack_spsc_ring_buffer, the read watermark handler
+// wakes the run loop via a pipe, as btstack_run_loop_poll_data_sources_from_irq() does in the POSIX
+// run loop. Reports latency between buffer recorded and buffer processed, and its jitter.
+// Also reports the copy throughput of btstack_ring_buffer and btstack_spsc_ring_buffer.
+//
+// *****************************************************************************
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "btstack_ring_buffer.h"
+#include "btstack_spsc_ring_buffer.h"
+#include "btstack_util.h"
+
+#define PERIOD_US                 4000
+#define NUM_PERIODS                500
+#define DRIVER_POLL_INTERVAL_MS      5
+#define BUFFER_SIZE               1024
+#define RING_BUFFER_SIZE          8192
+
+#define COPY_NUM_BYTES  (256 * 1024 * 1024)
+
+// from btstack_util.c, not linked
+uint32_t btstack_min(uint32_t a, uint32_t b){
+    return a < b ? a : b;
+}
+
+static uint8_t storage[RING_BUFFER_SIZE];
+
+// polled: btstack_ring_buffer protected by mutex
+static btstack_ring_buffer_t polled_ring_buffer;
+static pthread_mutex_t       polled_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// woken: btstack_spsc_ring_buffer with read watermark
+static btstack_spsc_ring_buffer_t spsc_ring_buffer;
+static int wakeup_pipe[2];
+
+static int use_spsc;
+static double latencies_us[NUM_PERIODS];
+
+static uint64_t time_now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000u) + (uint64_t) ts.tv_nsec;
+}
+
+static void sleep_until_ns(uint64_t deadline_ns){
+    struct timespec ts;
+    ts.tv_sec  = (time_t) (deadline_ns / 1000000000u);
+    ts.tv_nsec = (long) (deadline_ns % 1000000000u);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+static void read_watermark_handler(btstack_spsc_ring_buffer_t * ring_buffer){
+    UNUSED(ring_buffer);
+    const uint8_t x = (uint8_t) 'x';
+    ssize_t bytes_written = write(wakeup_pipe[1], &x, 1);
+    UNUSED(bytes_written);
+}
+
+// audio thread: store time stamp of recording in buffer
+static void * audio_thread(void * context){
+    UNUSED(context);
+    uint8_t buffer[BUFFER_SIZE];
+    memset(buffer, 0, sizeof(buffer));
+    uint64_t deadline_ns = time_now_ns();
+    int i;
+    for (i = 0; i < NUM_PERIODS; i++){
+        deadline_ns += PERIOD_US * 1000u;
+        sleep_until_ns(deadline_ns);
+        uint64_t now_ns = time_now_ns();
+        memcpy(buffer, &now_ns, sizeof(now_ns));
+        if (use_spsc){
+            btstack_spsc_ring_buffer_write(&spsc_ring_buffer, buffer, BUFFER_SIZE);
+        } else {
+            pthread_mutex_lock(&polled_mutex);
+            btstack_ring_buffer_write(&polled_ring_buffer, buffer, BUFFER_SIZE);
+            pthread_mutex_unlock(&polled_mutex);
+        }
+    }
+    return NULL;
+}
+
+static void process_buffer(const uint8_t * buffer, int * num_processed){
+    uint64_t recorded_ns;
+    memcpy(&recorded_ns, buffer, sizeof(recorded_ns));
+    latencies_us[*num_processed] = (double) (time_now_ns() - recorded_ns) / 1000.0;
+    (*num_processed)++;
+}
+
+static void consume_polled(void){
+    uint8_t buffer[BUFFER_SIZE];
+    int num_processed = 0;
+    while (num_processed < NUM_PERIODS){
+        usleep(DRIVER_POLL_INTERVAL_MS * 1000);
+        while (1){
+            uint32_t bytes_read = 0;
+            pthread_mutex_lock(&polled_mutex);
+            if (btstack_ring_buffer_bytes_available(&polled_ring_buffer) >= BUFFER_SIZE){
+                btstack_ring_buffer_read(&polled_ring_buffer, buffer, BUFFER_SIZE, &bytes_read);
+            }
+            pthread_mutex_unlock(&polled_mutex);
+            if (bytes_read == 0) break;
+            process_buffer(buffer, &num_processed);
+        }
+    }
+}
+
+static void consume_woken(void){
+    int num_processed = 0;
+    while (num_processed < NUM_PERIODS){
+        uint8_t x;
+        ssize_t bytes_read = read(wakeup_pipe[0], &x, 1);
+        UNUSED(bytes_read);
+        // buffers never wrap as ring buffer size is a multiple of buffer size
+        while (btstack_spsc_ring_buffer_bytes_available(&spsc_ring_buffer) >= BUFFER_SIZE){
+            const uint8_t * span;
+            btstack_spsc_ring_buffer_get_read_span(&spsc_ring_buffer, &span);
+            process_buffer(span, &num_processed);
+            btstack_spsc_ring_buffer_commit_read(&spsc_ring_buffer, BUFFER_SIZE);
+        }
+    }
+}
+
+static void report_latency(const char * name){
+    double sum = 0.0;
+    double max = 0.0;
+    int i;
+    for (i = 0; i < NUM_PERIODS; i++){
+        sum += latencies_us[i];
+        if (latencies_us[i] > max){
+            max = latencies_us[i];
+        }
+    }
+    double mean = sum / NUM_PERIODS;
+    double variance = 0.0;
+    for (i = 0; i < NUM_PERIODS; i++){
+        variance += (latencies_us[i] - mean) * (latencies_us[i] - mean);
+    }
+    fprintf(stderr, "%s\n", name);
+    fprintf(stderr, "- %10.1f us mean latency\n", mean);
+    fprintf(stderr, "- %10.1f us max latency\n", max);
+    fprintf(stderr, "- %10.1f us jitter (standard deviation)\n", sqrt(variance / NUM_PERIODS));
+}
+
+static void benchmark_latency(int spsc){
+    use_spsc = spsc;
+    btstack_ring_buffer_init(&polled_ring_buffer, storage, sizeof(storage));
+    btstack_spsc_ring_buffer_init(&spsc_ring_buffer, storage, sizeof(storage));
+    btstack_spsc_ring_buffer_set_read_watermark(&spsc_ring_buffer, BUFFER_SIZE, &read_watermark_handler);
+    pthread_t thread;
+    pthread_create(&thread, NULL, &audio_thread, NULL);
+    if (spsc){
+        consume_woken();
+    } else {
+        consume_polled();
+    }
+    pthread_join(thread, NULL);
+    report_latency(spsc ? "btstack_spsc_ring_buffer, run loop woken by read watermark" :
+                          "btstack_ring_buffer with mutex, run loop polls every 5 ms");
+}
+
+static void benchmark_copy(int spsc, uint32_t chunk_size){
+    static uint8_t chunk[BUFFER_SIZE * 3];
+    btstack_ring_buffer_init(&polled_ring_buffer, storage, sizeof(storage));
+    btstack_spsc_ring_buffer_init(&spsc_ring_buffer, storage, sizeof(storage));
+    uint64_t start_ns = time_now_ns();
+    uint32_t pos;
+    for (pos = 0; pos < COPY_NUM_BYTES; pos += chunk_size){
+        if (spsc){
+            btstack_spsc_ring_buffer_write(&spsc_ring_buffer, chunk, chunk_size);
+            btstack_spsc_ring_buffer_read(&spsc_ring_buffer, chunk, chunk_size);
+        } else {
+            uint32_t bytes_read;
+            btstack_ring_buffer_write(&polled_ring_buffer, chunk, chunk_size);
+            btstack_ring_buffer_read(&polled_ring_buffer, chunk, chunk_size, &bytes_read);
+        }
+    }
+    double duration = (double) (time_now_ns() - start_ns) / 1000000000.0;
+    fprintf(stderr, "%s, %u byte chunks\n", spsc ? "btstack_spsc_ring_buffer" : "btstack_ring_buffer", chunk_size);
+    fprintf(stderr, "- %10.0f MB/s\n", (COPY_NUM_BYTES / (1024.0 * 1024.0)) / duration);
+}
+
+int main(void){
+    if (pipe(wakeup_pipe) != 0) return 1;
+
+    fprintf(stderr, "Audio buffer hand-over, %u bytes every %u us, %u buffers\n", BUFFER_SIZE, PERIOD_US, NUM_PERIODS);
+    benchmark_latency(0);
+    benchmark_latency(1);
+
+    fprintf(stderr, "Write and read through %u byte ring buffer\n", RING_BUFFER_SIZE);
+    benchmark_copy(0, BUFFER_SIZE);
+    benchmark_copy(1, BUFFER_SIZE);
+    benchmark_copy(0, BUFFER_SIZE * 3);
+    benchmark_copy(1, BUFFER_SIZE * 3);
+    return 0;
+}
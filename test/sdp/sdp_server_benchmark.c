@@ -0,0 +1,344 @@
+/*
+ * Copyright (C) 2024 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+// *****************************************************************************
+//
+// SDP Server Benchmark
+//
+// Registers 50 service records and measures complete ServiceSearch and
+// ServiceSearchAttribute transactions including continuation. The reassembled
+// responses are verified against the data element based functions of sdp_util
+//
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bluetooth_sdp.h"
+#include "btstack_memory.h"
+#include "btstack_util.h"
+#include "classic/sdp_server.h"
+#include "classic/sdp_util.h"
+#include "l2cap.h"
+
+#define NUM_RECORDS     50
+#define RECORD_SIZE     200
+#define REMOTE_MTU      672
+#define NUM_ITERATIONS  2000
+#define SDP_CID         0x40
+
+static uint8_t  records[NUM_RECORDS][RECORD_SIZE];
+static uint8_t  request[200];
+static uint8_t  attribute_lists[10000];
+static uint16_t attribute_lists_len;
+static uint8_t  reference[10000];
+static uint16_t reference_len;
+static uint8_t  response[REMOTE_MTU];
+static uint16_t response_len;
+
+static btstack_packet_handler_t sdp_server_packet_handler;
+static bool can_send_now_requested;
+
+static const uint8_t vendor_uuid128[] = { 0x00, 0x00, 0x00, 0x00, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0, 0x12, 0x34, 0x56, 0x78 };
+
+// stubs
+void hci_dump_log(int log_level, const char * format, ...){
+    (void) log_level;
+    (void) format;
+}
+uint8_t l2cap_register_service(btstack_packet_handler_t packet_handler, uint16_t psm, uint16_t mtu, gap_security_level_t security_level){
+    sdp_server_packet_handler = packet_handler;
+    (void) psm;
+    (void) mtu;
+    (void) security_level;
+    return ERROR_CODE_SUCCESS;
+}
+uint8_t l2cap_send(uint16_t local_cid, const uint8_t * data, uint16_t len){
+    (void) local_cid;
+    (void)memcpy(response, data, len);
+    response_len = len;
+    return ERROR_CODE_SUCCESS;
+}
+uint8_t l2cap_request_can_send_now_event(uint16_t local_cid){
+    (void) local_cid;
+    can_send_now_requested = true;
+    return ERROR_CODE_SUCCESS;
+}
+void l2cap_accept_connection(uint16_t local_cid){
+    (void) local_cid;
+}
+void l2cap_decline_connection(uint16_t local_cid){
+    (void) local_cid;
+}
+uint16_t l2cap_get_remote_mtu_for_local_cid(uint16_t local_cid){
+    (void) local_cid;
+    return REMOTE_MTU;
+}
+
+// service class UUID16 0x2000 + index, every fifth record uses a 128-bit UUID
+static void create_record(uint8_t * service, uint16_t index){
+    de_create_sequence(service);
+    de_add_number(service, DE_UINT, DE_SIZE_16, BLUETOOTH_ATTRIBUTE_SERVICE_RECORD_HANDLE);
+    de_add_number(service, DE_UINT, DE_SIZE_32, 0x10001 + index);
+
+    de_add_number(service, DE_UINT, DE_SIZE_16, BLUETOOTH_ATTRIBUTE_SERVICE_CLASS_ID_LIST);
+    uint8_t * attribute = de_push_sequence(service);
+    if ((index % 5) == 4){
+        uint8_t uuid128[16];
+        (void)memcpy(uuid128, vendor_uuid128, 16);
+        big_endian_store_16(uuid128, 2, 0x2000 + index);
+        de_add_uuid128(attribute, uuid128);
+    } else {
+        de_add_number(attribute, DE_UUID, DE_SIZE_16, 0x2000 + index);
+    }
+    de_pop_sequence(service, attribute);
+
+    de_add_number(service, DE_UINT, DE_SIZE_16, BLUETOOTH_ATTRIBUTE_PROTOCOL_DESCRIPTOR_LIST);
+    attribute = de_push_sequence(service);
+    {
+        uint8_t * l2cap = de_push_sequence(attribute);
+        de_add_number(l2cap, DE_UUID, DE_SIZE_16, BLUETOOTH_PROTOCOL_L2CAP);
+        de_pop_sequence(attribute, l2cap);
+        uint8_t * rfcomm = de_push_sequence(attribute);
+        de_add_number(rfcomm, DE_UUID, DE_SIZE_16, BLUETOOTH_PROTOCOL_RFCOMM);
+        de_add_number(rfcomm, DE_UINT, DE_SIZE_8, 1 + (index % 30));
+        de_pop_sequence(attribute, rfcomm);
+    }
+    de_pop_sequence(service, attribute);
+
+    de_add_number(service, DE_UINT, DE_SIZE_16, BLUETOOTH_ATTRIBUTE_BROWSE_GROUP_LIST);
+    attribute = de_push_sequence(service);
+    de_add_number(attribute, DE_UUID, DE_SIZE_16, BLUETOOTH_ATTRIBUTE_PUBLIC_BROWSE_ROOT);
+    de_pop_sequence(service, attribute);
+
+    de_add_number(service, DE_UINT, DE_SIZE_16, BLUETOOTH_ATTRIBUTE_BLUETOOTH_PROFILE_DESCRIPTOR_LIST);
+    attribute = de_push_sequence(service);
+    {
+        uint8_t * profile = de_push_sequence(attribute);
+        de_add_number(profile, DE_UUID, DE_SIZE_16, 0x2000 + index);
+        de_add_number(profile, DE_UINT, DE_SIZE_16, 0x0102);
+        de_pop_sequence(attribute, profile);
+    }
+    de_pop_sequence(service, attribute);
+
+    char name[32];
+    snprintf(name, sizeof(name), "Benchmark Service %02u", index);
+    de_add_number(service, DE_UINT, DE_SIZE_16, 0x0100);
+    de_add_data(service, DE_STRING, (uint16_t) strlen(name), (uint8_t *) name);
+
+    uint16_t i;
+    for (i = 0; i < 8; i++){
+        de_add_number(service, DE_UINT, DE_SIZE_16, 0x0200 + i);
+        de_add_number(service, DE_UINT, DE_SIZE_32, (uint32_t) index * i);
+    }
+}
+
+static void sdp_server_emit_event(uint8_t event_type){
+    uint8_t event[4];
+    event[0] = event_type;
+    event[1] = 2;
+    little_endian_store_16(event, 2, SDP_CID);
+    (*sdp_server_packet_handler)(HCI_EVENT_PACKET, SDP_CID, event, sizeof(event));
+}
+
+// send request and get response
+static void sdp_server_execute(uint16_t request_len){
+    response_len = 0;
+    can_send_now_requested = false;
+    (*sdp_server_packet_handler)(L2CAP_DATA_PACKET, SDP_CID, request, request_len);
+    if (can_send_now_requested){
+        sdp_server_emit_event(L2CAP_EVENT_CAN_SEND_NOW);
+    }
+}
+
+static uint16_t create_service_search_attribute_request(const uint8_t * pattern, const uint8_t * attribute_id_list, const uint8_t * continuation_state){
+    uint16_t pos = 5;
+    uint16_t len = de_get_len(pattern);
+    (void)memcpy(&request[pos], pattern, len);
+    pos += len;
+    big_endian_store_16(request, pos, 0xffff);
+    pos += 2;
+    len = de_get_len(attribute_id_list);
+    (void)memcpy(&request[pos], attribute_id_list, len);
+    pos += len;
+    (void)memcpy(&request[pos], continuation_state, 1 + continuation_state[0]);
+    pos += 1 + continuation_state[0];
+    request[0] = SDP_ServiceSearchAttributeRequest;
+    big_endian_store_16(request, 1, 1);
+    big_endian_store_16(request, 3, pos - 5);
+    return pos;
+}
+
+// execute complete transaction, collect AttributeLists
+static int service_search_attribute_transaction(const uint8_t * pattern, const uint8_t * attribute_id_list){
+    uint8_t continuation_state[17];
+    continuation_state[0] = 0;
+    attribute_lists_len = 0;
+    int num_requests = 0;
+    while (true){
+        sdp_server_execute(create_service_search_attribute_request(pattern, attribute_id_list, continuation_state));
+        num_requests++;
+        if ((response_len == 0) || (response[0] != SDP_ServiceSearchAttributeResponse)) return -1;
+        uint16_t byte_count = big_endian_read_16(response, 5);
+        if ((attribute_lists_len + byte_count) > sizeof(attribute_lists)) return -1;
+        (void)memcpy(&attribute_lists[attribute_lists_len], &response[7], byte_count);
+        attribute_lists_len += byte_count;
+        const uint8_t * state = &response[7 + byte_count];
+        if (state[0] == 0) break;
+        (void)memcpy(continuation_state, state, 1 + state[0]);
+    }
+    return num_requests;
+}
+
+static int service_search_transaction(const uint8_t * pattern){
+    uint16_t pos = 5;
+    uint16_t len = de_get_len(pattern);
+    (void)memcpy(&request[pos], pattern, len);
+    pos += len;
+    big_endian_store_16(request, pos, 0xffff);
+    pos += 2;
+    request[pos++] = 0;
+    request[0] = SDP_ServiceSearchRequest;
+    big_endian_store_16(request, 1, 1);
+    big_endian_store_16(request, 3, pos - 5);
+    sdp_server_execute(pos);
+    return big_endian_read_16(response, 5);
+}
+
+// unindexed reference using data element traversal for all records
+static void reference_transaction(const uint8_t * pattern, const uint8_t * attribute_id_list){
+    uint16_t total_size = 0;
+    uint16_t i;
+    for (i = 0; i < NUM_RECORDS; i++){
+        if (!sdp_record_matches_service_search_pattern(records[i], (uint8_t *) pattern)) continue;
+        total_size += 3 + sdp_get_filtered_size(records[i], (uint8_t *) attribute_id_list);
+    }
+    de_store_descriptor_with_len(reference, DE_DES, DE_SIZE_VAR_16, total_size);
+    reference_len = 3;
+    // records are returned in reverse order of registration
+    for (i = NUM_RECORDS; i > 0; i--){
+        uint8_t * record = records[i - 1];
+        if (!sdp_record_matches_service_search_pattern(record, (uint8_t *) pattern)) continue;
+        uint16_t size = sdp_get_filtered_size(record, (uint8_t *) attribute_id_list);
+        de_store_descriptor_with_len(&reference[reference_len], DE_DES, DE_SIZE_VAR_16, size);
+        reference_len += 3;
+        uint16_t bytes_used;
+        sdp_filter_attributes_in_attributeIDList(record, (uint8_t *) attribute_id_list, 0, size, &bytes_used, &reference[reference_len]);
+        reference_len += bytes_used;
+    }
+}
+
+static double time_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+}
+
+static int benchmark(const char * name, const uint8_t * pattern, const uint8_t * attribute_id_list){
+    // verify
+    int num_requests = service_search_attribute_transaction(pattern, attribute_id_list);
+    reference_transaction(pattern, attribute_id_list);
+    if ((num_requests < 0) || (reference_len != attribute_lists_len) || (memcmp(reference, attribute_lists, reference_len) != 0)){
+        printf("%s: response does not match reference\n", name);
+        return 1;
+    }
+
+    int i;
+    double start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        service_search_attribute_transaction(pattern, attribute_id_list);
+    }
+    double indexed_duration = time_now() - start;
+
+    start = time_now();
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        reference_transaction(pattern, attribute_id_list);
+    }
+    double reference_duration = time_now() - start;
+
+    start = time_now();
+    int num_matches = 0;
+    for (i = 0; i < NUM_ITERATIONS; i++){
+        num_matches = service_search_transaction(pattern);
+    }
+    double search_duration = time_now() - start;
+
+    printf("%s: %u matching records, %u bytes, %u requests\n", name, num_matches, attribute_lists_len, num_requests);
+    printf("- ServiceSearch:                     %10.0f transactions/s\n", NUM_ITERATIONS / search_duration);
+    printf("- ServiceSearchAttribute:            %10.0f transactions/s\n", NUM_ITERATIONS / indexed_duration);
+    printf("- DE traversal reference:            %10.0f transactions/s\n", NUM_ITERATIONS / reference_duration);
+    return 0;
+}
+
+int main(int argc, const char * argv[]){
+    (void) argc;
+    (void) argv;
+
+    btstack_memory_init();
+    sdp_init();
+    sdp_server_emit_event(L2CAP_EVENT_INCOMING_CONNECTION);
+
+    uint16_t i;
+    for (i = 0; i < NUM_RECORDS; i++){
+        create_record(records[i], i);
+        if (sdp_register_service(records[i]) != ERROR_CODE_SUCCESS){
+            printf("Failed to register record %u\n", i);
+            return 1;
+        }
+    }
+
+    uint8_t all_attributes[] = { 0x35, 0x05, 0x0a, 0x00, 0x00, 0xff, 0xff };
+    uint8_t some_attributes[] = { 0x35, 0x09, 0x09, 0x00, 0x01, 0x09, 0x00, 0x04, 0x09, 0x01, 0x00 };
+
+    uint8_t pattern_single[] = { 0x35, 0x03, 0x19, 0x20, 0x11 };
+    uint8_t pattern_rfcomm[] = { 0x35, 0x03, 0x19, 0x00, 0x03 };
+    uint8_t pattern_none[]   = { 0x35, 0x06, 0x19, 0x00, 0x03, 0x19, 0x11, 0x0b };
+    uint8_t pattern_uuid128[19] = { 0x35, 0x11, 0x1c };
+    (void)memcpy(&pattern_uuid128[3], vendor_uuid128, 16);
+    big_endian_store_16(pattern_uuid128, 5, 0x2000 + 14);
+
+    int status = 0;
+    status |= benchmark("Single record, all attributes", pattern_single, all_attributes);
+    status |= benchmark("Single record, 128-bit UUID", pattern_uuid128, all_attributes);
+    status |= benchmark("No match", pattern_none, all_attributes);
+    status |= benchmark("All records, some attributes", pattern_rfcomm, some_attributes);
+    status |= benchmark("All records, all attributes", pattern_rfcomm, all_attributes);
+    return status;
+}
@@ -0,0 +1,275 @@
+//
+// SDP Server test with multiple simultaneous clients
+//
+// L2CAP is simulated in rounds: in each round, all channels that requested to send can send and each
+// client that received a response sends its next request. Total completion time is measured in rounds.
+//
+
+#include <stdio.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "bluetooth_sdp.h"
+#include "btstack_memory.h"
+#include "btstack_util.h"
+#include "classic/sdp_server.h"
+#include "classic/sdp_util.h"
+#include "l2cap.h"
+
+#define NUM_CLIENTS      20
+#define MAX_CLIENTS      (SDP_RESPONSE_BUFFER_COUNT + SDP_WAITING_LIST_MAX_COUNT + 1)
+#define NUM_RECORDS      5
+#define REMOTE_MTU       100
+#define CID_BASE         0x40
+
+typedef enum {
+    CLIENT_IDLE,
+    CLIENT_W4_ACCEPT,
+    CLIENT_W4_RESPONSE,
+    CLIENT_W2_SEND_REQUEST,
+    CLIENT_DONE,
+    CLIENT_DECLINED,
+} client_state_t;
+
+typedef struct {
+    uint16_t        cid;
+    client_state_t  state;
+    bool            can_send_now_requested;
+    uint8_t         continuation_state[17];
+    uint8_t         attribute_lists[2000];
+    uint16_t        attribute_lists_len;
+    uint16_t        num_requests;
+    uint16_t        completion_round;
+} client_t;
+
+static client_t clients[MAX_CLIENTS];
+static uint8_t  records[NUM_RECORDS][100];
+static btstack_packet_handler_t sdp_server_packet_handler;
+static uint16_t max_concurrent_clients;
+
+static const uint8_t search_pattern_l2cap[] = { 0x35, 0x03, 0x19, 0x01, 0x00 };
+static const uint8_t all_attributes[]       = { 0x35, 0x05, 0x0a, 0x00, 0x00, 0xff, 0xff };
+
+static client_t * client_for_cid(uint16_t cid){
+    CHECK(cid >= CID_BASE);
+    CHECK(cid < (CID_BASE + MAX_CLIENTS));
+    return &clients[cid - CID_BASE];
+}
+
+static uint16_t num_active_clients(void){
+    uint16_t count = 0;
+    uint16_t i;
+    for (i = 0; i < MAX_CLIENTS; i++){
+        if ((clients[i].state == CLIENT_W2_SEND_REQUEST) || (clients[i].state == CLIENT_W4_RESPONSE)){
+            count++;
+        }
+    }
+    return count;
+}
+
+// mock hci_dump.c
+extern "C" void hci_dump_log(int log_level, const char * format, ...){}
+extern "C" void btstack_assert_failed(const char * file, uint16_t line_nr){
+    FAIL("assert");
+}
+
+// mock l2cap.c
+extern "C" uint8_t l2cap_register_service(btstack_packet_handler_t packet_handler, uint16_t psm, uint16_t mtu, gap_security_level_t security_level){
+    sdp_server_packet_handler = packet_handler;
+    return ERROR_CODE_SUCCESS;
+}
+extern "C" void l2cap_accept_connection(uint16_t local_cid){
+    client_t * client = client_for_cid(local_cid);
+    CHECK(client->state == CLIENT_W4_ACCEPT);
+    client->state = CLIENT_W2_SEND_REQUEST;
+    max_concurrent_clients = btstack_max(max_concurrent_clients, num_active_clients());
+}
+extern "C" void l2cap_decline_connection(uint16_t local_cid){
+    client_for_cid(local_cid)->state = CLIENT_DECLINED;
+}
+extern "C" uint16_t l2cap_get_remote_mtu_for_local_cid(uint16_t local_cid){
+    return REMOTE_MTU;
+}
+extern "C" uint8_t l2cap_request_can_send_now_event(uint16_t local_cid){
+    client_for_cid(local_cid)->can_send_now_requested = true;
+    return ERROR_CODE_SUCCESS;
+}
+extern "C" uint8_t l2cap_send(uint16_t local_cid, const uint8_t * data, uint16_t len){
+    client_t * client = client_for_cid(local_cid);
+    CHECK(client->state == CLIENT_W4_RESPONSE);
+    CHECK(len <= REMOTE_MTU);
+    CHECK_EQUAL(SDP_ServiceSearchAttributeResponse, data[0]);
+    // collect AttributeLists
+    uint16_t byte_count = big_endian_read_16(data, 5);
+    CHECK((client->attribute_lists_len + byte_count) <= sizeof(client->attribute_lists));
+    memcpy(&client->attribute_lists[client->attribute_lists_len], &data[7], byte_count);
+    client->attribute_lists_len += byte_count;
+    const uint8_t * continuation_state = &data[7 + byte_count];
+    memcpy(client->continuation_state, continuation_state, 1 + continuation_state[0]);
+    client->state = CLIENT_W2_SEND_REQUEST;
+    return ERROR_CODE_SUCCESS;
+}
+
+static void emit_event(uint8_t event_type, uint16_t cid){
+    uint8_t event[4];
+    event[0] = event_type;
+    event[1] = 2;
+    little_endian_store_16(event, 2, cid);
+    (*sdp_server_packet_handler)(HCI_EVENT_PACKET, cid, event, sizeof(event));
+}
+
+static void client_send_request(client_t * client){
+    uint8_t request[100];
+    uint16_t pos = 5;
+    memcpy(&request[pos], search_pattern_l2cap, sizeof(search_pattern_l2cap));
+    pos += sizeof(search_pattern_l2cap);
+    big_endian_store_16(request, pos, 0xffff);
+    pos += 2;
+    memcpy(&request[pos], all_attributes, sizeof(all_attributes));
+    pos += sizeof(all_attributes);
+    memcpy(&request[pos], client->continuation_state, 1 + client->continuation_state[0]);
+    pos += 1 + client->continuation_state[0];
+    request[0] = SDP_ServiceSearchAttributeRequest;
+    big_endian_store_16(request, 1, client->num_requests);
+    big_endian_store_16(request, 3, pos - 5);
+    client->state = CLIENT_W4_RESPONSE;
+    client->num_requests++;
+    (*sdp_server_packet_handler)(L2CAP_DATA_PACKET, client->cid, request, pos);
+}
+
+static void create_record(uint8_t * service, uint16_t index){
+    de_create_sequence(service);
+    de_add_number(service, DE_UINT, DE_SIZE_16, BLUETOOTH_ATTRIBUTE_SERVICE_RECORD_HANDLE);
+    de_add_number(service, DE_UINT, DE_SIZE_32, 0x10001 + index);
+    de_add_number(service, DE_UINT, DE_SIZE_16, BLUETOOTH_ATTRIBUTE_SERVICE_CLASS_ID_LIST);
+    uint8_t * attribute = de_push_sequence(service);
+    de_add_number(attribute, DE_UUID, DE_SIZE_16, 0x2000 + index);
+    de_pop_sequence(service, attribute);
+    de_add_number(service, DE_UINT, DE_SIZE_16, BLUETOOTH_ATTRIBUTE_PROTOCOL_DESCRIPTOR_LIST);
+    attribute = de_push_sequence(service);
+    uint8_t * l2cap = de_push_sequence(attribute);
+    de_add_number(l2cap, DE_UUID, DE_SIZE_16, BLUETOOTH_PROTOCOL_L2CAP);
+    de_add_number(l2cap, DE_UINT, DE_SIZE_16, 0x1001 + (2 * index));
+    de_pop_sequence(attribute, l2cap);
+    de_pop_sequence(service, attribute);
+    const char * name = "Test Service";
+    de_add_number(service, DE_UINT, DE_SIZE_16, 0x0100);
+    de_add_data(service, DE_STRING, (uint16_t) strlen(name), (uint8_t *) name);
+}
+
+TEST_GROUP(SDP_SERVER){
+    void setup(void){
+        memset(clients, 0, sizeof(clients));
+        max_concurrent_clients = 0;
+        btstack_memory_init();
+        sdp_init();
+        uint16_t i;
+        for (i = 0; i < NUM_RECORDS; i++){
+            create_record(records[i], i);
+            CHECK_EQUAL(ERROR_CODE_SUCCESS, sdp_register_service(records[i]));
+        }
+        for (i = 0; i < MAX_CLIENTS; i++){
+            clients[i].cid = CID_BASE + i;
+        }
+    }
+
+    void teardown(void){
+        sdp_deinit();
+        btstack_memory_deinit();
+    }
+
+    // @returns number of rounds until all clients are done
+    uint16_t run(uint16_t num_clients){
+        uint16_t i;
+        for (i = 0; i < num_clients; i++){
+            clients[i].state = CLIENT_W4_ACCEPT;
+            emit_event(L2CAP_EVENT_INCOMING_CONNECTION, clients[i].cid);
+        }
+        uint16_t round;
+        for (round = 1; round < 1000; round++){
+            bool done = true;
+            // independent links: all pending responses are sent
+            for (i = 0; i < num_clients; i++){
+                if (!clients[i].can_send_now_requested) continue;
+                clients[i].can_send_now_requested = false;
+                emit_event(L2CAP_EVENT_CAN_SEND_NOW, clients[i].cid);
+            }
+            // clients with a response send next request or disconnect
+            for (i = 0; i < num_clients; i++){
+                client_t * client = &clients[i];
+                if (client->state != CLIENT_W2_SEND_REQUEST) {
+                    if ((client->state == CLIENT_W4_ACCEPT) || (client->state == CLIENT_W4_RESPONSE)){
+                        done = false;
+                    }
+                    continue;
+                }
+                done = false;
+                if ((client->num_requests > 0) && (client->continuation_state[0] == 0)){
+                    client->state = CLIENT_DONE;
+                    client->completion_round = round;
+                    emit_event(L2CAP_EVENT_CHANNEL_CLOSED, client->cid);
+                } else {
+                    client_send_request(client);
+                }
+            }
+            if (done) break;
+        }
+        return round;
+    }
+};
+
+TEST(SDP_SERVER, SingleClient){
+    uint16_t rounds = run(1);
+    CHECK_EQUAL(CLIENT_DONE, clients[0].state);
+    CHECK(clients[0].num_requests > 1);
+    CHECK(rounds > 0);
+}
+
+TEST(SDP_SERVER, SimultaneousClients){
+    uint16_t single_client_rounds = run(1);
+    client_t reference = clients[0];
+    teardown();
+    setup();
+
+    uint16_t rounds = run(NUM_CLIENTS);
+    uint16_t i;
+    for (i = 0; i < NUM_CLIENTS; i++){
+        CHECK_EQUAL(CLIENT_DONE, clients[i].state);
+        CHECK_EQUAL(reference.num_requests, clients[i].num_requests);
+        CHECK_EQUAL(reference.attribute_lists_len, clients[i].attribute_lists_len);
+        MEMCMP_EQUAL(reference.attribute_lists, clients[i].attribute_lists, reference.attribute_lists_len);
+    }
+
+    // clients are served in batches of SDP_RESPONSE_BUFFER_COUNT
+    CHECK_EQUAL(SDP_RESPONSE_BUFFER_COUNT, max_concurrent_clients);
+    uint16_t num_batches = (NUM_CLIENTS + SDP_RESPONSE_BUFFER_COUNT - 1) / SDP_RESPONSE_BUFFER_COUNT;
+    CHECK(rounds <= (num_batches * single_client_rounds));
+    printf("SDP Server: %u clients completed after %u rounds, %u rounds for single client, %u concurrent\n",
+           NUM_CLIENTS, rounds, single_client_rounds, max_concurrent_clients);
+}
+
+TEST(SDP_SERVER, WaitingListFull){
+    uint16_t num_clients = SDP_RESPONSE_BUFFER_COUNT + SDP_WAITING_LIST_MAX_COUNT;
+    uint16_t i;
+    for (i = 0; i <= num_clients; i++){
+        clients[i].state = CLIENT_W4_ACCEPT;
+        emit_event(L2CAP_EVENT_INCOMING_CONNECTION, clients[i].cid);
+    }
+    CHECK_EQUAL(CLIENT_DECLINED, clients[num_clients].state);
+    CHECK_EQUAL(CLIENT_W4_ACCEPT, clients[num_clients-1].state);
+    CHECK_EQUAL(CLIENT_W2_SEND_REQUEST, clients[0].state);
+}
+
+TEST(SDP_SERVER, DirectRequest){
+    // handle request without l2cap channel: 5 records, 4 bytes each
+    uint8_t request[] = { SDP_ServiceSearchRequest, 0x00, 0x01, 0x00, 0x08,
+                          0x35, 0x03, 0x19, 0x01, 0x00, 0x00, 0x10, 0x00 };
+    int response_size = sdp_handle_service_search_request(request, REMOTE_MTU);
+    CHECK_EQUAL(10 + (NUM_RECORDS * 4), response_size);
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
@@ -95,6 +95,22 @@ extern "C" {
 #include "mesh/mesh_virtual_addresses.h"
 #endif
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+typedef struct {
+    const char * name;
+    // number of buffers in static pool, 0 for malloc
+    uint16_t pool_size;
+    // buffers in use and max buffers in use since init or last reset
+    uint16_t current;
+    uint16_t peak;
+    uint32_t allocations;
+    uint32_t failed;
+    // time spent in malloc, only if time source is set
+    uint32_t alloc_time_us_total;
+    uint32_t alloc_time_us_max;
+} btstack_memory_statistics_t;
+#endif
+
 /* API_START */
 
 /**
@@ -108,6 +124,38 @@ void btstack_memory_init(void);
  */
 void btstack_memory_deinit(void);
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+/**
+ * @brief Get number of buffer types with statistics
+ * @return num types
+ */
+uint16_t btstack_memory_statistics_num_types(void);
+
+/**
+ * @brief Get usage statistics for buffer type
+ * @param index < btstack_memory_statistics_num_types()
+ * @return statistics or NULL if index invalid
+ */
+const btstack_memory_statistics_t * btstack_memory_statistics_get(uint16_t index);
+
+/**
+ * @brief Reset peak usage to current usage and clear allocation counters
+ */
+void btstack_memory_statistics_reset(void);
+
+/**
+ * @brief Log statistics for all buffer types that have been used or are configured via log_info, which ends up
+ *        in the HCI dump / packet log
+ */
+void btstack_memory_statistics_dump(void);
+
+/**
+ * @brief Set microsecond time source to measure time spent in malloc
+ * @param get_time_us or NULL to disable measurement
+ */
+void btstack_memory_statistics_set_time_source(uint32_t (*get_time_us)(void));
+#endif
+
 /* API_END */
 """
 
@@ -187,6 +235,67 @@ static void btstack_memory_tracking_remove(btstack_memory_buffer_t * buffer){
 }
 #endif
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static uint32_t (*btstack_memory_statistics_get_time_us)(void);
+static void btstack_memory_statistics_clear(void);
+
+static void btstack_memory_statistics_track_get(btstack_memory_statistics_t * statistics, const void * buffer){
+    if (buffer == NULL){
+        statistics->failed++;
+        log_error("%s: no buffer available, %u of %u in use", statistics->name, statistics->current, statistics->pool_size);
+        return;
+    }
+    statistics->allocations++;
+    statistics->current++;
+    if (statistics->current > statistics->peak){
+        statistics->peak = statistics->current;
+    }
+}
+
+static void btstack_memory_statistics_track_free(btstack_memory_statistics_t * statistics){
+    if (statistics->current > 0u){
+        statistics->current--;
+    }
+}
+
+#ifdef HAVE_MALLOC
+static uint32_t btstack_memory_statistics_time_us(void){
+    if (btstack_memory_statistics_get_time_us == NULL){
+        return 0;
+    }
+    return (*btstack_memory_statistics_get_time_us)();
+}
+
+static void btstack_memory_statistics_track_time(btstack_memory_statistics_t * statistics, uint32_t start_us){
+    if (btstack_memory_statistics_get_time_us == NULL){
+        return;
+    }
+    uint32_t duration_us = btstack_memory_statistics_time_us() - start_us;
+    statistics->alloc_time_us_total += duration_us;
+    if (duration_us > statistics->alloc_time_us_max){
+        statistics->alloc_time_us_max = duration_us;
+    }
+}
+#endif
+
+#define BTSTACK_MEMORY_STATISTICS_GET(name, buffer)   btstack_memory_statistics_track_get(&name##_statistics, buffer)
+#define BTSTACK_MEMORY_STATISTICS_FREE(name)          btstack_memory_statistics_track_free(&name##_statistics)
+#define BTSTACK_MEMORY_STATISTICS_TIME_START()        btstack_memory_statistics_time_us()
+#define BTSTACK_MEMORY_STATISTICS_TIME_STOP(name, start_us) btstack_memory_statistics_track_time(&name##_statistics, start_us)
+#else
+#define BTSTACK_MEMORY_STATISTICS_GET(name, buffer)   (void)(buffer)
+#define BTSTACK_MEMORY_STATISTICS_FREE(name)
+#define BTSTACK_MEMORY_STATISTICS_TIME_START()        0
+#define BTSTACK_MEMORY_STATISTICS_TIME_STOP(name, start_us) (void)(start_us)
+#endif
+
+#ifdef ENABLE_BTSTACK_MEMORY_SLAB
+// storage for all pools is provided by a single contiguous arena, see below
+#define BTSTACK_MEMORY_STORAGE(name) btstack_memory_arena.name
+#else
+#define BTSTACK_MEMORY_STORAGE(name) name##_storage
+#endif
+
 void btstack_memory_deinit(void){
 #ifdef HAVE_MALLOC
     while (btstack_memory_malloc_buffers != NULL){
@@ -197,6 +306,9 @@ void btstack_memory_deinit(void){
     }
     btstack_assert(btstack_memory_malloc_counter == 0);
 #endif
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+    btstack_memory_statistics_clear();
+#endif
 }
 """
 
@@ -215,20 +327,31 @@ code_template = """
 
 #ifdef POOL_COUNT
 #if POOL_COUNT > 0
+#ifndef ENABLE_BTSTACK_MEMORY_SLAB
 static STRUCT_TYPE STRUCT_NAME_storage[POOL_COUNT];
+#endif
 static btstack_memory_pool_t STRUCT_NAME_pool;
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t STRUCT_NAME_statistics = { "STRUCT_NAME", POOL_COUNT, 0, 0, 0, 0, 0, 0 };
+#endif
 STRUCT_NAME_t * btstack_memory_STRUCT_NAME_get(void){
     void * buffer = btstack_memory_pool_get(&STRUCT_NAME_pool);
     if (buffer){
         memset(buffer, 0, sizeof(STRUCT_TYPE));
     }
+    BTSTACK_MEMORY_STATISTICS_GET(STRUCT_NAME, buffer);
     return (STRUCT_NAME_t *) buffer;
 }
 void btstack_memory_STRUCT_NAME_free(STRUCT_NAME_t *STRUCT_NAME){
+    BTSTACK_MEMORY_STATISTICS_FREE(STRUCT_NAME);
     btstack_memory_pool_free(&STRUCT_NAME_pool, STRUCT_NAME);
 }
 #else
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t STRUCT_NAME_statistics = { "STRUCT_NAME", 0, 0, 0, 0, 0, 0, 0 };
+#endif
 STRUCT_NAME_t * btstack_memory_STRUCT_NAME_get(void){
+    BTSTACK_MEMORY_STATISTICS_GET(STRUCT_NAME, NULL);
     return NULL;
 }
 void btstack_memory_STRUCT_NAME_free(STRUCT_NAME_t *STRUCT_NAME){
@@ -242,8 +365,15 @@ typedef struct {
     STRUCT_NAME_t data;
 } btstack_memory_STRUCT_NAME_t;
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t STRUCT_NAME_statistics = { "STRUCT_NAME", 0, 0, 0, 0, 0, 0, 0 };
+#endif
+
 STRUCT_NAME_t * btstack_memory_STRUCT_NAME_get(void){
+    uint32_t start_us = BTSTACK_MEMORY_STATISTICS_TIME_START();
     btstack_memory_STRUCT_NAME_t * buffer = (btstack_memory_STRUCT_NAME_t *) malloc(sizeof(btstack_memory_STRUCT_NAME_t));
+    BTSTACK_MEMORY_STATISTICS_TIME_STOP(STRUCT_NAME, start_us);
+    BTSTACK_MEMORY_STATISTICS_GET(STRUCT_NAME, buffer);
     if (buffer){
         memset(buffer, 0, sizeof(btstack_memory_STRUCT_NAME_t));
         btstack_memory_tracking_add(&buffer->tracking);
@@ -253,6 +383,7 @@ STRUCT_NAME_t * btstack_memory_STRUCT_NAME_get(void){
     }
 }
 void btstack_memory_STRUCT_NAME_free(STRUCT_NAME_t *STRUCT_NAME){
+    BTSTACK_MEMORY_STATISTICS_FREE(STRUCT_NAME);
     // reconstruct buffer start
     btstack_memory_buffer_t * buffer = &((btstack_memory_buffer_t *) STRUCT_NAME)[-1];
     btstack_memory_tracking_remove(buffer);
@@ -260,6 +391,92 @@ void btstack_memory_STRUCT_NAME_free(STRUCT_NAME_t *STRUCT_NAME){
 }
 #endif
 """
+
+arena_template = """#ifdef POOL_COUNT
+#if POOL_COUNT > 0
+    STRUCT_TYPE STRUCT_NAME[POOL_COUNT];
+#endif
+#endif"""
+
+statistics_table_template = """    &STRUCT_NAME_statistics,"""
+
+arena_header = """
+#ifdef ENABLE_BTSTACK_MEMORY_SLAB
+// single arena for all pools, keeps buffers close to each other instead of scattering them over individual arrays
+static struct {
+"""
+
+arena_footer = """    // ensure arena is not empty
+    uint8_t end;
+} btstack_memory_arena;
+#endif
+"""
+
+statistics_header = """
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static btstack_memory_statistics_t * const btstack_memory_statistics_table[] = {
+"""
+
+statistics_footer = """};
+
+static void btstack_memory_statistics_clear(void){
+    uint16_t i;
+    for (i = 0; i < btstack_memory_statistics_num_types(); i++){
+        btstack_memory_statistics_t * statistics = btstack_memory_statistics_table[i];
+        statistics->current = 0;
+        statistics->peak = 0;
+        statistics->allocations = 0;
+        statistics->failed = 0;
+        statistics->alloc_time_us_total = 0;
+        statistics->alloc_time_us_max = 0;
+    }
+}
+
+uint16_t btstack_memory_statistics_num_types(void){
+    return (uint16_t) (sizeof(btstack_memory_statistics_table) / sizeof(btstack_memory_statistics_t *));
+}
+
+const btstack_memory_statistics_t * btstack_memory_statistics_get(uint16_t index){
+    if (index >= btstack_memory_statistics_num_types()){
+        return NULL;
+    }
+    return btstack_memory_statistics_table[index];
+}
+
+void btstack_memory_statistics_reset(void){
+    uint16_t i;
+    for (i = 0; i < btstack_memory_statistics_num_types(); i++){
+        btstack_memory_statistics_t * statistics = btstack_memory_statistics_table[i];
+        statistics->peak = statistics->current;
+        statistics->allocations = 0;
+        statistics->failed = 0;
+        statistics->alloc_time_us_total = 0;
+        statistics->alloc_time_us_max = 0;
+    }
+}
+
+void btstack_memory_statistics_dump(void){
+#ifdef ENABLE_BTSTACK_MEMORY_SLAB
+    log_info("btstack_memory: arena %u bytes", (unsigned int) sizeof(btstack_memory_arena));
+#endif
+    uint16_t i;
+    for (i = 0; i < btstack_memory_statistics_num_types(); i++){
+        const btstack_memory_statistics_t * statistics = btstack_memory_statistics_table[i];
+        if ((statistics->pool_size == 0u) && (statistics->allocations == 0u) && (statistics->failed == 0u)){
+            continue;
+        }
+        log_info("%s: %u of %u in use, peak %u, %u allocations, %u failed, malloc max %u us, total %u us",
+                 statistics->name, statistics->current, statistics->pool_size, statistics->peak,
+                 (unsigned int) statistics->allocations, (unsigned int) statistics->failed,
+                 (unsigned int) statistics->alloc_time_us_max, (unsigned int) statistics->alloc_time_us_total);
+    }
+}
+
+void btstack_memory_statistics_set_time_source(uint32_t (*get_time_us)(void)){
+    btstack_memory_statistics_get_time_us = get_time_us;
+}
+#endif
+"""
 init_header = '''
 // init
 void btstack_memory_init(void){
@@ -267,11 +484,14 @@ void btstack_memory_init(void){
     // assert that there is no unexpected padding for combined buffer
     btstack_assert(sizeof(test_buffer_t) == sizeof(btstack_memory_buffer_t) + sizeof(void *));
 #endif
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+    btstack_memory_statistics_clear();
+#endif
   
 '''
 
 init_template = """#if POOL_COUNT > 0
-    btstack_memory_pool_create(&STRUCT_NAME_pool, STRUCT_NAME_storage, POOL_COUNT, sizeof(STRUCT_TYPE));
+    btstack_memory_pool_create(&STRUCT_NAME_pool, BTSTACK_MEMORY_STORAGE(STRUCT_NAME), POOL_COUNT, sizeof(STRUCT_TYPE));
 #endif"""
 
 list_of_structs = [
@@ -294,6 +514,9 @@ list_of_classic_structs = [
 list_of_le_structs = [
     ["battery_service_client", "gatt_client", "hids_client", "scan_parameters_service_client", "sm_lookup_entry", "whitelist_entry", "periodic_advertiser_list_entry"],
 ]
+list_of_gatt_client_cache_structs = [
+    ["gatt_client_cache"],
+]
 list_of_mesh_structs = [
     ['mesh_network_pdu', 'mesh_segmented_pdu', 'mesh_upper_transport_pdu', 'mesh_network_key', 'mesh_transport_key', 'mesh_virtual_address', 'mesh_subnet']
 ]
@@ -329,6 +552,7 @@ def add_structs(f, template):
     add_struct(f, "",                               template, list_of_structs)
     add_struct(f, "ENABLE_CLASSIC",                 template, list_of_classic_structs)
     add_struct(f, "ENABLE_BLE",                     template, list_of_le_structs)
+    add_struct(f, "ENABLE_GATT_CLIENT_CACHE",       template, list_of_gatt_client_cache_structs)
     add_struct(f, "ENABLE_MESH",                    template, list_of_mesh_structs)
     add_struct(f, "ENABLE_LE_ISOCHRONOUS_STREAMS",  template, list_of_iso_structs)
 
@@ -349,6 +573,14 @@ writeln(f, copyright)
 writeln(f, cfile_header_begin)
 add_structs(f, code_template)
 
+f.write(arena_header)
+add_structs(f, arena_template)
+f.write(arena_footer)
+
+f.write(statistics_header)
+add_structs(f, statistics_table_template)
+f.write(statistics_footer)
+
 f.write(init_header)
 add_structs(f, init_template)
 writeln(f, "}")
@@ -402,6 +634,73 @@ TEST(btstack_memory, deinit){
 }
 #endif
 
+#ifdef ENABLE_BTSTACK_MEMORY_STATISTICS
+static const btstack_memory_statistics_t * statistics_for_name(const char * name){
+    uint16_t i;
+    for (i = 0; i < btstack_memory_statistics_num_types(); i++){
+        const btstack_memory_statistics_t * statistics = btstack_memory_statistics_get(i);
+        if (strcmp(statistics->name, name) == 0){
+            return statistics;
+        }
+    }
+    return NULL;
+}
+
+static uint32_t time_us;
+static uint32_t get_time_us(void){
+    time_us += 5;
+    return time_us;
+}
+
+TEST(btstack_memory, statistics){
+    const btstack_memory_statistics_t * statistics = statistics_for_name("hci_connection");
+    CHECK(statistics != NULL);
+    POINTERS_EQUAL(NULL, btstack_memory_statistics_get(btstack_memory_statistics_num_types()));
+    btstack_memory_statistics_set_time_source(&get_time_us);
+
+    hci_connection_t * buffer = btstack_memory_hci_connection_get();
+    CHECK(buffer != NULL);
+    CHECK_EQUAL(1, statistics->current);
+    CHECK_EQUAL(1, statistics->peak);
+    CHECK_EQUAL(1, statistics->allocations);
+#ifdef HAVE_MALLOC
+    CHECK_EQUAL(0, statistics->pool_size);
+    CHECK_EQUAL(5, statistics->alloc_time_us_max);
+    simulate_no_memory = 1;
+#else
+    CHECK_EQUAL(MAX_NR_HCI_CONNECTIONS, statistics->pool_size);
+    CHECK_EQUAL(0, statistics->alloc_time_us_max);
+#endif
+    // pool exhausted
+    CHECK(btstack_memory_hci_connection_get() == NULL);
+    CHECK_EQUAL(1, statistics->failed);
+    btstack_memory_hci_connection_free(buffer);
+    CHECK_EQUAL(0, statistics->current);
+    CHECK_EQUAL(1, statistics->peak);
+    btstack_memory_statistics_dump();
+
+    // reset keeps current usage
+    btstack_memory_statistics_reset();
+    CHECK_EQUAL(0, statistics->peak);
+    CHECK_EQUAL(0, statistics->allocations);
+    CHECK_EQUAL(0, statistics->failed);
+    btstack_memory_statistics_set_time_source(NULL);
+}
+#endif
+
+#ifdef ENABLE_BTSTACK_MEMORY_SLAB
+TEST(btstack_memory, slab){
+    // pools are placed next to each other in a single arena
+    hci_connection_t * connection = btstack_memory_hci_connection_get();
+    l2cap_channel_t * channel = btstack_memory_l2cap_channel_get();
+    CHECK(connection != NULL);
+    CHECK(channel != NULL);
+    uintptr_t distance = (uintptr_t) channel - (uintptr_t) connection;
+    CHECK(distance >= sizeof(hci_connection_t));
+    CHECK(distance < (sizeof(hci_connection_t) + sizeof(l2cap_service_t) + 16));
+}
+#endif
+
 """
 
 test_template = """